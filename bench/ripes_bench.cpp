@@ -0,0 +1,407 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <iostream>
+#include <random>
+
+#include "assembler.h"
+#include "cachesim/cachesim.h"
+#include "headless.h"
+#include "parser.h"
+#include "processorhandler.h"
+#include "processorregistry.h"
+#include "version/version.h"
+
+/** Simulator throughput benchmarks
+ *
+ * Measures the throughput of the simulation hot paths: simulated cycles per second of each processor model on a fixed
+ * set of kernels, cache accesses per second of a set of cache configurations, and assembled lines and disassembled
+ * instructions per second. Results are emitted as JSON in the layout of Google Benchmark reports, such that reports of
+ * separate releases can be diffed with its tooling (ie. compare.py).
+ */
+
+using namespace Ripes;
+
+namespace {
+
+// Upper bound on the cycles of a single kernel simulation, bounding the duration of each iteration
+static constexpr unsigned long long s_maxKernelCycles = 200000;
+
+// Number of accesses of the synthetic memory access trace replayed through each cache configuration
+static constexpr unsigned s_cacheTraceLength = 1 << 16;
+
+// Number of repetitions of the synthetic program block which is assembled and disassembled
+static constexpr unsigned s_programRepetitions = 2000;
+
+struct Kernel {
+    QString name;
+    QString source;
+};
+
+// clang-format off
+const std::vector<Kernel> s_kernels = {
+    {"alu",
+     "main:\n"
+     "    li t0, 20000\n"
+     "    li t1, 1\n"
+     "    li t2, 0\n"
+     "loop:\n"
+     "    add t2, t2, t1\n"
+     "    xor t3, t2, t0\n"
+     "    slli t4, t3, 3\n"
+     "    srai t4, t4, 1\n"
+     "    sub t1, t4, t2\n"
+     "    andi t1, t1, 255\n"
+     "    addi t0, t0, -1\n"
+     "    bnez t0, loop\n"
+     "    li a7, 10\n"
+     "    ecall\n"},
+    {"memory",
+     ".data\n"
+     "array: .zero 1024\n"
+     ".text\n"
+     "main:\n"
+     "    li s0, 64\n"
+     "outer:\n"
+     "    la t0, array\n"
+     "    li t1, 256\n"
+     "fill:\n"
+     "    sw t1, 0(t0)\n"
+     "    addi t0, t0, 4\n"
+     "    addi t1, t1, -1\n"
+     "    bnez t1, fill\n"
+     "    la t0, array\n"
+     "    li t1, 256\n"
+     "    li t2, 0\n"
+     "sum:\n"
+     "    lw t3, 0(t0)\n"
+     "    add t2, t2, t3\n"
+     "    addi t0, t0, 4\n"
+     "    addi t1, t1, -1\n"
+     "    bnez t1, sum\n"
+     "    addi s0, s0, -1\n"
+     "    bnez s0, outer\n"
+     "    li a7, 10\n"
+     "    ecall\n"},
+    {"calls",
+     "main:\n"
+     "    li a0, 18\n"
+     "    jal ra, fib\n"
+     "    li a7, 10\n"
+     "    ecall\n"
+     "fib:\n"
+     "    li t0, 2\n"
+     "    blt a0, t0, base\n"
+     "    addi sp, sp, -12\n"
+     "    sw ra, 8(sp)\n"
+     "    sw a0, 4(sp)\n"
+     "    addi a0, a0, -1\n"
+     "    jal ra, fib\n"
+     "    sw a0, 0(sp)\n"
+     "    lw a0, 4(sp)\n"
+     "    addi a0, a0, -2\n"
+     "    jal ra, fib\n"
+     "    lw t0, 0(sp)\n"
+     "    add a0, a0, t0\n"
+     "    lw ra, 8(sp)\n"
+     "    addi sp, sp, 12\n"
+     "base:\n"
+     "    ret\n"},
+};
+// clang-format on
+
+struct CacheConfig {
+    QString name;
+    CacheSim::CachePreset preset;
+};
+
+const std::vector<CacheConfig> s_cacheConfigs = {
+    {"direct_mapped_1KiB",
+     {2, 6, 0, CacheSim::WritePolicy::WriteBack, CacheSim::WriteAllocPolicy::WriteAllocate, CacheSim::ReplPolicy::LRU}},
+    {"4way_lru_8KiB",
+     {3, 6, 2, CacheSim::WritePolicy::WriteBack, CacheSim::WriteAllocPolicy::WriteAllocate, CacheSim::ReplPolicy::LRU}},
+    {"8way_plru_32KiB",
+     {3, 7, 3, CacheSim::WritePolicy::WriteBack, CacheSim::WriteAllocPolicy::WriteAllocate, CacheSim::ReplPolicy::PLRU}},
+    {"2way_random_wt_2KiB",
+     {2, 6, 1, CacheSim::WritePolicy::WriteThrough, CacheSim::WriteAllocPolicy::NoWriteAllocate,
+      CacheSim::ReplPolicy::Random}},
+};
+
+struct Measurement {
+    QString name;
+    long long iterations = 0;
+    // Wall-clock time per iteration, in nanoseconds
+    double realTime = 0;
+    double itemsPerSecond = 0;
+    QString error;
+};
+
+/**
+ * @brief measure
+ * Repeats @p iteration, which returns the number of items it processed, until at least @p minTimeMs milliseconds have
+ * passed, and at least once.
+ */
+template <typename F>
+Measurement measure(const QString& name, qint64 minTimeMs, F&& iteration) {
+    Measurement m;
+    m.name = name;
+    long long items = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        items += iteration(m.error);
+        m.iterations++;
+    } while (m.error.isEmpty() && timer.elapsed() < minTimeMs);
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    m.realTime = static_cast<double>(elapsedNs) / m.iterations;
+    m.itemsPerSecond = elapsedNs == 0 ? 0 : items * 1e9 / elapsedNs;
+    return m;
+}
+
+QString syntheticProgram() {
+    QString source = ".data\nbuffer: .zero 64\n.text\n";
+    for (unsigned i = 0; i < s_programRepetitions; i++) {
+        const QString label = "block" + QString::number(i);
+        source += label + ":\n";
+        source += "    la t0, buffer\n";
+        source += "    lw t1, 0(t0)\n";
+        source += "    addi t1, t1, " + QString::number(i % 2048) + "\n";
+        source += "    sw t1, 4(t0)\n";
+        source += "    slli t2, t1, 2\n";
+        source += "    mul t3, t2, t1\n";
+        source += "    xor t3, t3, t2\n";
+        source += "    lui t4, " + QString::number(i % 1024) + "\n";
+        source += "    beq t3, t4, " + label + "\n";
+        source += "    jal ra, " + label + "_end\n";
+        source += label + "_end:\n";
+        source += "    sh t3, 8(t0)\n";
+        source += "    lbu t5, 1(t0)\n";
+    }
+    return source;
+}
+
+std::vector<CacheSim::Access> syntheticCacheTrace() {
+    // A mix of sequential streams, a hot working set and scattered accesses, from a fixed seed such that each run
+    // replays the same trace
+    std::mt19937 rng(0x5eed);
+    std::vector<CacheSim::Access> trace(s_cacheTraceLength);
+    uint32_t stream = 0x10000000;
+    for (auto& access : trace) {
+        switch (rng() % 4) {
+            case 0:
+            case 1:
+                access.address = stream;
+                stream += 4;
+                break;
+            case 2:
+                access.address = 0x10000000 + (rng() % 1024) * 4;
+                break;
+            default:
+                access.address = 0x10000000 + (rng() % (1 << 20)) * 4;
+                break;
+        }
+        access.type = rng() % 4 == 0 ? CacheSim::AccessType::Write : CacheSim::AccessType::Read;
+    }
+    return trace;
+}
+
+std::vector<Measurement> benchmarkProcessors(const QRegularExpression& filter, qint64 minTimeMs) {
+    std::vector<Measurement> measurements;
+    QTemporaryDir dir;
+    for (const auto& kernel : s_kernels) {
+        const QString path = dir.filePath(kernel.name + ".s");
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            continue;
+        }
+        file.write(kernel.source.toUtf8());
+        file.close();
+
+        for (const auto& it : ProcessorRegistry::getAvailableProcessors()) {
+            const QString name = "simulate/" + processorName(it.first) + "/" + kernel.name;
+            if (!filter.match(name).hasMatch()) {
+                continue;
+            }
+            HeadlessOptions options;
+            options.filepath = path;
+            options.type = FileType::Assembly;
+            options.processor = it.first;
+            options.maxCycles = s_maxKernelCycles;
+            options.ioDirectory = dir.path();
+            measurements.push_back(measure(name, minTimeMs, [&](QString& error) -> long long {
+                const auto result = simulate(options, [](const QString&) {});
+                error = result.error;
+                return result.cycles;
+            }));
+        }
+    }
+    return measurements;
+}
+
+std::vector<Measurement> benchmarkCaches(const QRegularExpression& filter, qint64 minTimeMs) {
+    std::vector<Measurement> measurements;
+    const auto trace = syntheticCacheTrace();
+    for (const auto& config : s_cacheConfigs) {
+        const QString name = "cache_access/" + config.name;
+        if (!filter.match(name).hasMatch()) {
+            continue;
+        }
+        // Caches are bound to a simulation context of their own, whose processor is never clocked
+        ProcessorHandler context;
+        CacheSim cache(&context, nullptr);
+        cache.setType(CacheSim::CacheType::DataCache);
+        cache.setPreset(config.preset);
+        measurements.push_back(measure(name, minTimeMs, [&](QString&) -> long long {
+            for (const auto& access : trace) {
+                cache.access(access.address, access.type, access.pc);
+            }
+            return trace.size();
+        }));
+    }
+    return measurements;
+}
+
+std::vector<Measurement> benchmarkAssembler(const QRegularExpression& filter, qint64 minTimeMs) {
+    std::vector<Measurement> measurements;
+    const QStringList lines = syntheticProgram().split('\n');
+
+    if (filter.match("assemble").hasMatch()) {
+        // A fresh assembler per iteration, such that no lexed lines are reused from the previous iteration
+        measurements.push_back(measure("assemble", minTimeMs, [&](QString& error) -> long long {
+            Assembler assembler;
+            assembler.assemble(lines);
+            if (assembler.hasError()) {
+                error = "Synthetic program failed to assemble";
+            }
+            return lines.size();
+        }));
+    }
+
+    if (filter.match("disassemble").hasMatch()) {
+        Assembler assembler;
+        assembler.assemble(lines);
+        const Program program = assembler.getProgram();
+        const ProgramSection* text = program.getSection(".text");
+        if (assembler.hasError() || !text) {
+            measurements.push_back({"disassemble", 0, 0, 0, "Synthetic program failed to assemble"});
+            return measurements;
+        }
+        const auto* words = reinterpret_cast<const uint32_t*>(text->data.constData());
+        const unsigned count = text->data.size() / sizeof(uint32_t);
+        measurements.push_back(measure("disassemble", minTimeMs, [&](QString&) -> long long {
+            for (unsigned i = 0; i < count; i++) {
+                Parser::getParser()->disassemble(program, words[i], text->address + i * sizeof(uint32_t));
+            }
+            return count;
+        }));
+    }
+    return measurements;
+}
+
+QJsonDocument report(const std::vector<Measurement>& measurements) {
+    QJsonObject context;
+    context["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    context["host_name"] = QSysInfo::machineHostName();
+    context["executable"] = QCoreApplication::applicationFilePath();
+    context["num_cpus"] = QThread::idealThreadCount();
+    context["ripes_version"] = getRipesVersion();
+#ifdef NDEBUG
+    context["library_build_type"] = "release";
+#else
+    context["library_build_type"] = "debug";
+#endif
+
+    QJsonArray benchmarks;
+    for (const auto& m : measurements) {
+        QJsonObject benchmark;
+        benchmark["name"] = m.name;
+        benchmark["run_name"] = m.name;
+        benchmark["run_type"] = "iteration";
+        benchmark["iterations"] = m.iterations;
+        benchmark["real_time"] = m.realTime;
+        benchmark["cpu_time"] = m.realTime;
+        benchmark["time_unit"] = "ns";
+        benchmark["items_per_second"] = m.itemsPerSecond;
+        if (!m.error.isEmpty()) {
+            benchmark["error_occurred"] = true;
+            benchmark["error_message"] = m.error;
+        }
+        benchmarks.append(benchmark);
+    }
+
+    QJsonObject root;
+    root["context"] = context;
+    root["benchmarks"] = benchmarks;
+    return QJsonDocument(root);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    // Benchmarks never show any graphical interface, and may run on machines without a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Ripes simulator throughput benchmarks");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"out", "Write the JSON report to this file rather than stdout.", "file"},
+        {"min-time", "Minimum wall-clock time spent repeating each benchmark.", "ms", "500"},
+        {"filter", "Only run benchmarks whose name matches this regular expression.", "regex", "."},
+    });
+    parser.process(app);
+
+    bool ok;
+    const qint64 minTimeMs = parser.value("min-time").toLongLong(&ok);
+    if (!ok || minTimeMs < 0) {
+        std::cerr << "Error: Invalid minimum time '" << parser.value("min-time").toStdString() << "'" << std::endl;
+        return 1;
+    }
+    const QRegularExpression filter(parser.value("filter"));
+    if (!filter.isValid()) {
+        std::cerr << "Error: Invalid filter '" << parser.value("filter").toStdString() << "'" << std::endl;
+        return 1;
+    }
+
+    std::vector<Measurement> measurements;
+    for (auto&& group : {benchmarkProcessors(filter, minTimeMs), benchmarkCaches(filter, minTimeMs),
+                         benchmarkAssembler(filter, minTimeMs)}) {
+        measurements.insert(measurements.end(), group.begin(), group.end());
+    }
+    for (const auto& m : measurements) {
+        std::cerr << m.name.toStdString() << ": "
+                  << (m.error.isEmpty() ? QString::number(m.itemsPerSecond, 'f', 0).toStdString() + " items/s"
+                                        : "error: " + m.error.toStdString())
+                  << std::endl;
+    }
+
+    const QByteArray json = report(measurements).toJson();
+    if (parser.isSet("out")) {
+        QFile file(parser.value("out"));
+        if (!file.open(QIODevice::WriteOnly)) {
+            std::cerr << "Error: Could not write report to " << parser.value("out").toStdString() << std::endl;
+            return 1;
+        }
+        file.write(json);
+    } else {
+        std::cout << json.toStdString();
+    }
+
+    bool failed = false;
+    for (const auto& m : measurements) {
+        failed |= !m.error.isEmpty();
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Builds the bundled benchmarks as RV32IM executables into examples/ELF.
+#
+# Usage: bash build.sh
+#
+# The CRC32, MatMult and Qsort kernels are built from the sources in this directory. CoreMark and Dhrystone are built
+# from source checkouts given through the environment, against the Ripes ports in coremark/ and dhrystone/:
+#   COREMARK_DIR:   Checkout of https://github.com/eembc/coremark
+#   DHRYSTONE_DIR:  Directory containing the Dhrystone 2.1 C sources; dhry.h, dhry_1.c and dhry_2.c
+# Benchmarks whose sources are not provided are skipped.
+#
+# Further configuration:
+#   CC:                 RISC-V C compiler (default riscv64-unknown-elf-gcc)
+#   RIPES_CLOCK_HZ:     Nominal clock frequency which simulated cycles are converted to seconds at (default 100000)
+#   COREMARK_ITERATIONS (default 10), DHRYSTONE_RUNS (default 2000)
+
+set -e
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+OUT="$HERE/../ELF"
+
+CC="${CC:-riscv64-unknown-elf-gcc}"
+RIPES_CLOCK_HZ="${RIPES_CLOCK_HZ:-100000}"
+COREMARK_ITERATIONS="${COREMARK_ITERATIONS:-10}"
+DHRYSTONE_RUNS="${DHRYSTONE_RUNS:-2000}"
+
+# Fixed flags, such that the executables are reproducible from the same compiler
+CFLAGS="-march=rv32im -mabi=ilp32 -O2 -g0 -ffile-prefix-map=$HERE=. -DRIPES_CLOCK_HZ=$RIPES_CLOCK_HZ"
+
+build() {
+    local name="$1"
+    shift
+    echo "Building '$name'"
+    "$CC" $CFLAGS "$@" "$HERE/ripes.c" -o "$OUT/$name"
+}
+
+build "CRC32" "$HERE/crc32.c"
+build "MatMult" "$HERE/matmult.c"
+build "Qsort" "$HERE/qsort.c"
+
+if [ -n "$COREMARK_DIR" ]; then
+    build "CoreMark" -I"$HERE/coremark" -I"$COREMARK_DIR" \
+        -DITERATIONS="$COREMARK_ITERATIONS" -DPERFORMANCE_RUN=1 -DFLAGS_STR="\"$CFLAGS\"" \
+        "$COREMARK_DIR"/core_list_join.c "$COREMARK_DIR"/core_main.c "$COREMARK_DIR"/core_matrix.c \
+        "$COREMARK_DIR"/core_state.c "$COREMARK_DIR"/core_util.c "$HERE/coremark/core_portme.c"
+else
+    echo "COREMARK_DIR not set; skipping 'CoreMark'"
+fi
+
+if [ -n "$DHRYSTONE_DIR" ]; then
+    # The Dhrystone sources predate ANSI C
+    build "Dhrystone" -std=gnu89 -w -I"$DHRYSTONE_DIR" -include "$HERE/dhrystone/dhry_ripes.h" \
+        -DTIME -DDHRYSTONE_RUNS="$DHRYSTONE_RUNS" \
+        "$DHRYSTONE_DIR"/dhry_1.c "$DHRYSTONE_DIR"/dhry_2.c "$HERE/dhrystone/dhry_ripes.c"
+else
+    echo "DHRYSTONE_DIR not set; skipping 'Dhrystone'"
+fi
+
+echo "Built benchmarks are bundled once listed in examples/examples.qrc"
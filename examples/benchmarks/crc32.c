@@ -0,0 +1,44 @@
+/** CRC-32
+ *
+ * Bitwise (table-less) CRC-32 of a pseudo-random buffer, after the CRC32 kernel of MiBench. Dominated by short,
+ * data-dependent branches.
+ */
+
+#include <stdint.h>
+
+#include "ripes.h"
+
+#define BUFFER_SIZE 4096
+#define ITERATIONS 4
+#define EXPECTED 0x55a9abc3u
+
+static uint8_t buffer[BUFFER_SIZE];
+
+static uint32_t crc32(const uint8_t* data, unsigned size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (unsigned i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (unsigned bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+        }
+    }
+    return ~crc;
+}
+
+int main(void) {
+    uint32_t seed = 12345;
+    for (unsigned i = 0; i < BUFFER_SIZE; i++) {
+        seed = seed * 1103515245u + 12345u;
+        buffer[i] = (uint8_t)(seed >> 16);
+    }
+
+    const unsigned cycles = ripes_cycles();
+    const unsigned instructions = ripes_instret();
+    uint32_t checksum = 0;
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        buffer[i] ^= (uint8_t)checksum;
+        checksum = crc32(buffer, BUFFER_SIZE);
+    }
+    ripes_report("crc32", checksum, EXPECTED, ripes_cycles() - cycles, ripes_instret() - instructions);
+    return 0;
+}
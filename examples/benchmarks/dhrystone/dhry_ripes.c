@@ -0,0 +1,27 @@
+/** Dhrystone port of the Ripes simulator; see dhry_ripes.h */
+
+#include "../ripes.h"
+
+#ifndef RIPES_CLOCK_HZ
+#define RIPES_CLOCK_HZ 100000
+#endif
+
+long ripes_dhry_time(long* t) {
+    static unsigned begin;
+    static int started;
+    const unsigned now = ripes_cycles();
+    if (!started) {
+        // Dhrystone reads the time at the beginning and end of the measured runs
+        begin = now;
+        started = 1;
+    } else {
+        ripes_print_string("Simulated cycles: ");
+        ripes_print_int((int)(now - begin));
+        ripes_print_string("\n");
+    }
+    const long seconds = (long)(now / RIPES_CLOCK_HZ);
+    if (t) {
+        *t = seconds;
+    }
+    return seconds;
+}
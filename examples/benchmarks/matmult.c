@@ -0,0 +1,56 @@
+/** Integer matrix multiplication
+ *
+ * Multiplication of pseudo-random integer matrices, after the matmult-int kernel of Embench. Dominated by loads and
+ * multiplications in a tight loop nest.
+ */
+
+#include <stdint.h>
+
+#include "ripes.h"
+
+#define N 20
+#define ITERATIONS 4
+#define EXPECTED 0x47cfd700u
+
+static int32_t a[N][N];
+static int32_t b[N][N];
+static int32_t c[N][N];
+
+static void multiply(void) {
+    for (unsigned i = 0; i < N; i++) {
+        for (unsigned j = 0; j < N; j++) {
+            int32_t sum = 0;
+            for (unsigned k = 0; k < N; k++) {
+                sum += a[i][k] * b[k][j];
+            }
+            c[i][j] = sum;
+        }
+    }
+}
+
+int main(void) {
+    uint32_t seed = 1;
+    for (unsigned i = 0; i < N; i++) {
+        for (unsigned j = 0; j < N; j++) {
+            seed = seed * 1103515245u + 12345u;
+            a[i][j] = (int32_t)((seed >> 16) & 0xFF) - 128;
+            seed = seed * 1103515245u + 12345u;
+            b[i][j] = (int32_t)((seed >> 16) & 0xFF) - 128;
+        }
+    }
+
+    const unsigned cycles = ripes_cycles();
+    const unsigned instructions = ripes_instret();
+    uint32_t checksum = 0;
+    for (unsigned it = 0; it < ITERATIONS; it++) {
+        a[it][it] += (int32_t)(checksum & 0xF);
+        multiply();
+        for (unsigned i = 0; i < N; i++) {
+            for (unsigned j = 0; j < N; j++) {
+                checksum = checksum * 31u + (uint32_t)c[i][j];
+            }
+        }
+    }
+    ripes_report("matmult", checksum, EXPECTED, ripes_cycles() - cycles, ripes_instret() - instructions);
+    return 0;
+}
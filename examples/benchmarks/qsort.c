@@ -0,0 +1,66 @@
+/** Quicksort
+ *
+ * Recursive quicksort of pseudo-random integers, after the qsort kernel of MiBench. Exercises calls, returns and
+ * unpredictable branches. The sort is implemented here rather than taken from the C library, such that the workload
+ * does not depend on the library it is built against.
+ */
+
+#include <stdint.h>
+
+#include "ripes.h"
+
+#define COUNT 1000
+#define ITERATIONS 2
+#define EXPECTED 0xba45ff7au
+
+static uint32_t values[COUNT];
+
+static void quicksort(uint32_t* data, int lo, int hi) {
+    while (lo < hi) {
+        const uint32_t pivot = data[lo + (hi - lo) / 2];
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (data[i] < pivot) {
+                i++;
+            }
+            while (data[j] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                const uint32_t tmp = data[i];
+                data[i] = data[j];
+                data[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        // Recurse into the smaller partition, bounding the stack depth
+        if (j - lo < hi - i) {
+            quicksort(data, lo, j);
+            lo = i;
+        } else {
+            quicksort(data, i, hi);
+            hi = j;
+        }
+    }
+}
+
+int main(void) {
+    const unsigned cycles = ripes_cycles();
+    const unsigned instructions = ripes_instret();
+    uint32_t checksum = 0;
+    uint32_t seed = 42;
+    for (unsigned it = 0; it < ITERATIONS; it++) {
+        for (unsigned i = 0; i < COUNT; i++) {
+            seed = seed * 1103515245u + 12345u;
+            values[i] = seed >> 8;
+        }
+        quicksort(values, 0, COUNT - 1);
+        for (unsigned i = 0; i < COUNT; i++) {
+            checksum = checksum * 31u + values[i] * (i + 1);
+        }
+    }
+    ripes_report("qsort", checksum, EXPECTED, ripes_cycles() - cycles, ripes_instret() - instructions);
+    return 0;
+}
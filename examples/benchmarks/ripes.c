@@ -0,0 +1,23 @@
+/** Ripes runtime support of the bundled benchmarks
+ *
+ * The C library allocates its buffers through _sbrk, which newlib implements through the brk system call. Ripes does
+ * not model a program break, such that the heap is instead served from the memory following the program image.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+
+extern char _end[];
+
+void* _sbrk(ptrdiff_t increment) {
+    static char* brk = _end;
+    char* const previous = brk;
+    // The heap grows towards the stack; leave it a generous margin
+    char* const sp = __builtin_frame_address(0);
+    if (brk + increment > sp - 64 * 1024) {
+        errno = ENOMEM;
+        return (void*)-1;
+    }
+    brk += increment;
+    return previous;
+}
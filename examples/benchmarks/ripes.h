@@ -0,0 +1,65 @@
+/** Ripes port layer of the bundled benchmarks
+ *
+ * Performance counters, console output and program exit through the environment calls of the Ripes simulator. The
+ * benchmarks are built as bare RV32IM executables against newlib; see build.sh.
+ */
+
+#ifndef RIPES_H
+#define RIPES_H
+
+static inline unsigned ripes_cycles(void) {
+    unsigned value;
+    asm volatile("rdcycle %0" : "=r"(value));
+    return value;
+}
+
+static inline unsigned ripes_instret(void) {
+    unsigned value;
+    asm volatile("rdinstret %0" : "=r"(value));
+    return value;
+}
+
+static inline void ripes_print_int(int value) {
+    register int a0 asm("a0") = value;
+    register int a7 asm("a7") = 1;
+    asm volatile("ecall" : : "r"(a0), "r"(a7));
+}
+
+static inline void ripes_print_hex(unsigned value) {
+    register unsigned a0 asm("a0") = value;
+    register int a7 asm("a7") = 34;
+    asm volatile("ecall" : : "r"(a0), "r"(a7));
+}
+
+static inline void ripes_print_string(const char* str) {
+    register const char* a0 asm("a0") = str;
+    register int a7 asm("a7") = 4;
+    asm volatile("ecall" : : "r"(a0), "r"(a7) : "memory");
+}
+
+static inline void ripes_exit(int code) {
+    register int a0 asm("a0") = code;
+    register int a7 asm("a7") = 93;
+    asm volatile("ecall" : : "r"(a0), "r"(a7));
+    for (;;) {
+    }
+}
+
+/**
+ * Reports the result of a benchmark as "<name>: <checksum> OK (<cycles> cycles, <instructions> instructions)", and exits
+ * with status 0 if @p checksum matches @p expected.
+ */
+static inline void ripes_report(const char* name, unsigned checksum, unsigned expected, unsigned cycles,
+                                unsigned instructions) {
+    ripes_print_string(name);
+    ripes_print_string(": ");
+    ripes_print_hex(checksum);
+    ripes_print_string(checksum == expected ? " OK (" : " FAILED (");
+    ripes_print_int((int)cycles);
+    ripes_print_string(" cycles, ");
+    ripes_print_int((int)instructions);
+    ripes_print_string(" instructions)\n");
+    ripes_exit(checksum == expected ? 0 : 1);
+}
+
+#endif  // RIPES_H
@@ -1,22 +1,386 @@
 #include <QApplication>
-#include <QFileInfo>
+#include <QCommandLineParser>
 #include <QMessageBox>
 #include <QResource>
 #include <QTimer>
 #include <iostream>
 
+#include "src/batchrunner.h"
+#include "src/headless.h"
+#include "src/hostprofiler.h"
 #include "src/mainwindow.h"
 #include "src/parser.h"
+#include "src/processorhandler.h"
+#include "src/simulationserver.h"
 
 using namespace std;
 
+namespace {
+
+/// Parses the value of the numeric option @p name into @p value. Reports an error if the value is not a number.
+bool parseNumber(const QCommandLineParser& parser, const QString& name, unsigned long long& value, int base = 10) {
+    bool ok = false;
+    value = parser.value(name).toULongLong(&ok, base);
+    if (!ok) {
+        cerr << "Error: --" << name.toStdString() << " must be a number, got '" << parser.value(name).toStdString()
+             << "'" << endl;
+    }
+    return ok;
+}
+
+int runHeadless(const QApplication& app) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Ripes headless simulation mode");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file",
+                                 "Program to simulate. Bundled examples are given by their resource path, ie. "
+                                 "':/examples/ELF/RanPi'.");
+    parser.addOptions({
+        {"headless", "Run a simulation without the graphical interface."},
+        {"type",
+         "Type of the input file: 'asm', 'bin', 'elf', 'ihex' (Intel HEX) or 'srec' (Motorola S-record). Inferred from "
+         "the file extension if not provided.",
+         "type"},
+        {"entry", "Entry point of a flat binary file.", "address", "0"},
+        {"load-at", "Load address of a flat binary file.", "address", "0"},
+        {"proc",
+         "Processor model to simulate: RVSS, RV5S, RV5S_BTFN, RV5S_BIMODAL, RV5S_GSHARE, RV5S_BTB, RV5S_NO_HZ, "
+         "RV5S_NO_FW_HZ or RV5S_DUAL.",
+         "processor", "RV5S"},
+        {"unit-latencies",
+         "Latencies of the pipelined multiplier and iterative divider of the 5-stage processors with hazard "
+         "detection, in cycles, as <mul>,<div>.",
+         "latencies", "1,1"},
+        {"functional", "Simulate using the functional interpreter. Disables cache simulation."},
+        {"harts",
+         "Execute the program on this number of functional harts sharing its memory, each on a host thread of its own. "
+         "Harts read their id from mhartid.",
+         "harts", "1"},
+        {"quantum", "Instructions executed by each hart between synchronizations of the harts.", "instructions",
+         "1000"},
+        {"max-cycles", "Stop the simulation after this number of cycles (0 = unlimited).", "cycles", "0"},
+        {"time-limit", "Stop the simulation after this number of milliseconds (0 = unlimited).", "ms", "0"},
+        {"sample-interval",
+         "Sampled simulation: fast-forward this number of instructions functionally between detailed windows "
+         "(0 = disabled).",
+         "instructions", "0"},
+        {"sample-window", "Length of each detailed window in sampled simulation.", "cycles", "10000"},
+        {"io-dir", "Directory which the file system calls of the simulated program are confined to.", "directory"},
+        {"trace", "Record an execution trace of all retired instructions to this file.", "file"},
+        {"pipeline-trace",
+         "Stream the stage PCs and stall/flush states of every simulated cycle to this file; CSV if the extension is "
+         ".csv, binary otherwise.",
+         "file"},
+        {"stats",
+         "Write a JSON report of the run statistics (cycles, CPI, stalls, branch and cache statistics, host time) to "
+         "this file.",
+         "file"},
+        {"flame-graph",
+         "Write the call stacks of the simulated program to this file in the folded stack format of flame graph tools.",
+         "file"},
+        {"flame-graph-metric", "Weight of the call stacks of --flame-graph: 'cycles' or 'misses' (first level cache).",
+         "metric", "cycles"},
+        {"host-profile",
+         "Profile the host time spent within the simulator itself, and write it to this file as a Chrome trace event "
+         "file. Requires a build with RIPES_HOST_PROFILER.",
+         "file"},
+        {"restore-snapshot",
+         "Resume the simulation from this snapshot file, saved with the same processor, program and caches.", "file"},
+        {"save-snapshot", "Save a snapshot of the simulation to this file once it stops, from which it may be resumed.",
+         "file"},
+        {"dump-memory",
+         "Write an image of memory to this file once the simulation stops; all populated pages unless --dump-range is "
+         "given.",
+         "file"},
+        {"dump-format", "Format of --dump-memory: 'bin' (raw), 'ihex' (Intel HEX) or 'verilog' ($readmemh).", "format",
+         "bin"},
+        {"dump-range", "Inclusive range of hex addresses written by --dump-memory, as <first>-<last>.", "range"},
+        {"replay",
+         "Replay the input file as a memory access trace of this format (ripes, din or lackey) through the simulated "
+         "caches, without simulating a processor.",
+         "format"},
+        {"sweep",
+         "Replay the trace through a grid of cache configurations, as ';'-separated <parameter>=<values> pairs of "
+         "lines, ways, blocks (log2; lists or ranges, ie. 2-8), repl (lru, random, plru, fifo, lfu, srrip), write "
+         "(wb, wt) and alloc (wa, nwa). Requires --replay.",
+         "grid"},
+        {"dcache", "Simulate a data cache."},
+        {"icache", "Simulate an instruction cache."},
+        {"cache-config", "Cache configuration as log2 of <lines>,<ways>,<words per block>.", "config", "5,0,2"},
+        {"l2-config", "Back the simulated caches by a unified L2 cache, configured as per --cache-config.", "config"},
+        {"l3-config", "Back the L2 cache by a unified L3 cache, configured as per --cache-config.", "config"},
+        {"cache-latencies",
+         "Hit latencies of the L1, L2 and L3 caches and the memory latency, in cycles, from which average memory "
+         "access times are reported, as <l1>,<l2>,<l3>,<memory>.",
+         "latencies", "1,10,30,100"},
+        {"cache-warmup",
+         "Exclude the accesses of a warm-up from the reported cache statistics, ending after a number of cycles or "
+         "accesses, or at the first access by the instruction at an address, as cycles:<n>, accesses:<n> or "
+         "pc:<address>.",
+         "warmup", "none"},
+        {"cache-window", "Report the cache statistics of the accesses of the cycles <first> to <last>.", "first,last"},
+        {"dram", "Back the last level caches by a DRAM of banks and row buffers, rather than a flat memory latency."},
+        {"dram-config",
+         "DRAM configuration as log2 of <banks>,<row size in bytes>, the page policy (open, closed) and the timings in "
+         "cycles, as <banks>,<row size>,<policy>,<tRCD>,<tCAS>,<tRP>.",
+         "config", "3,11,open,15,15,15"},
+        {"itlb", "Simulate an Sv32 instruction TLB, stalling the processor for the page walks of its misses."},
+        {"dtlb", "Simulate an Sv32 data TLB, stalling the processor for the page walks of its misses."},
+        {"tlb-config",
+         "TLB configuration as log2 of <sets>,<ways>, the replacement policy (lru, random, plru, fifo, lfu, srrip) "
+         "and the page walk latency in cycles, as <sets>,<ways>,<repl>,<walk latency>.",
+         "config", "4,2,lru,20"},
+        {"batch", "Simulate all jobs of a JSON job file. The options above apply as defaults to each job.", "jobs"},
+        {"report", "Write the batch report to this file; CSV if the extension is .csv, JSON otherwise.", "file"},
+        {"lockstep",
+         "Simulate functional batch jobs which only differ in their register and data inputs in lockstep, up to this "
+         "many jobs at a time (0 = disabled).",
+         "lanes", "0"},
+        {"server",
+         "Serve JSON-RPC simulation requests on the local socket of this name, keeping loaded programs and constructed "
+         "processors warm across requests. The options above apply as defaults to each connection.",
+         "name"},
+        {"jobs",
+         "Number of batch jobs, swept cache configurations or server requests simulated concurrently (0 = one per "
+         "core).",
+         "threads", "0"},
+    });
+    parser.process(app);
+
+    const bool batch = parser.isSet("batch");
+    const bool server = parser.isSet("server");
+    const auto positional = parser.positionalArguments();
+    if (batch && server) {
+        cerr << "Error: --batch and --server cannot be combined" << endl;
+        return 1;
+    }
+    if (!batch && !server && positional.size() != 1) {
+        cerr << "Error: Exactly one program file must be provided" << endl;
+        return 1;
+    }
+
+    Ripes::HeadlessOptions options;
+    if (!batch && !server) {
+        options.filepath = positional.at(0);
+        options.replayTrace = parser.isSet("replay");
+        if (options.replayTrace) {
+            if (!Ripes::CacheTraceReader::parseFormat(parser.value("replay"), options.traceFormat)) {
+                cerr << "Error: Unknown trace format '" << parser.value("replay").toStdString() << "'" << endl;
+                return 1;
+            }
+        } else if (!Ripes::parseFileType(parser.value("type"), options.filepath, options.type)) {
+            cerr << "Error: Unknown file type '" << parser.value("type").toStdString() << "'" << endl;
+            return 1;
+        }
+    }
+
+    unsigned long long entry = 0;
+    unsigned long long loadAt = 0;
+    unsigned long long jobThreads = 0;
+    unsigned long long lockstepLanes = 0;
+    if (!parseNumber(parser, "entry", entry, 0) || !parseNumber(parser, "load-at", loadAt, 0) ||
+        !parseNumber(parser, "max-cycles", options.maxCycles) ||
+        !parseNumber(parser, "time-limit", options.timeLimitMs) || !parseNumber(parser, "jobs", jobThreads) ||
+        !parseNumber(parser, "lockstep", lockstepLanes)) {
+        return 1;
+    }
+    options.binaryEntryPoint = entry;
+    options.binaryLoadAt = loadAt;
+    bool ok = true;
+    if (!parseNumber(parser, "sample-interval", options.sampleInterval) ||
+        !parseNumber(parser, "sample-window", options.sampleWindow)) {
+        return 1;
+    }
+    if (options.sampleInterval != 0 && options.sampleWindow == 0) {
+        cerr << "Error: The sample window must be at least 1 cycle" << endl;
+        return 1;
+    }
+    options.ioDirectory = parser.value("io-dir");
+    options.tracePath = parser.value("trace");
+    options.pipelineTracePath = parser.value("pipeline-trace");
+    options.statisticsPath = parser.value("stats");
+    options.flameGraphPath = parser.value("flame-graph");
+    const QString flameGraphMetric = parser.value("flame-graph-metric").toLower();
+    if (flameGraphMetric != "cycles" && flameGraphMetric != "misses") {
+        cerr << "Error: Unknown flame graph metric '" << flameGraphMetric.toStdString() << "'" << endl;
+        return 1;
+    }
+    options.flameGraphMetric = flameGraphMetric == "misses" ? Ripes::CallGraphProfiler::Metric::Misses
+                                                            : Ripes::CallGraphProfiler::Metric::Cycles;
+    options.hostProfilePath = parser.value("host-profile");
+    if (!options.hostProfilePath.isEmpty() && !Ripes::HostProfiler::available()) {
+        cerr << "Error: --host-profile requires Ripes to be built with RIPES_HOST_PROFILER" << endl;
+        return 1;
+    }
+    options.restoreSnapshotPath = parser.value("restore-snapshot");
+    options.saveSnapshotPath = parser.value("save-snapshot");
+    options.memoryDumpPath = parser.value("dump-memory");
+    if (!Ripes::MemoryDump::parseFormat(parser.value("dump-format").toLower(), options.memoryDumpFormat)) {
+        cerr << "Error: Unknown memory image format '" << parser.value("dump-format").toStdString() << "'" << endl;
+        return 1;
+    }
+    if (parser.isSet("dump-range")) {
+        Ripes::MemoryDump::Range range;
+        if (!Ripes::MemoryDump::parseRange(parser.value("dump-range"), range)) {
+            cerr << "Error: Memory ranges must be given as <first>-<last> hex addresses" << endl;
+            return 1;
+        }
+        options.memoryDumpRange = range;
+    }
+    options.cacheSweep = parser.value("sweep");
+    options.sweepThreads = static_cast<int>(jobThreads);
+    if (!options.cacheSweep.isEmpty() && !options.replayTrace) {
+        cerr << "Error: --sweep requires --replay" << endl;
+        return 1;
+    }
+
+    if (!Ripes::parseProcessorID(parser.value("proc"), options.processor)) {
+        cerr << "Error: Unknown processor '" << parser.value("proc").toStdString() << "'" << endl;
+        return 1;
+    }
+    if (!Ripes::parseUnitLatencies(parser.value("unit-latencies"), options)) {
+        cerr << "Error: Functional unit latencies must be given as <mul>,<div> of at least 1 cycle" << endl;
+        return 1;
+    }
+
+    options.functional = parser.isSet("functional");
+    options.harts = parser.value("harts").toUInt(&ok);
+    if (!ok || options.harts == 0) {
+        cerr << "Error: The number of harts must be at least 1" << endl;
+        return 1;
+    }
+    options.quantum = parser.value("quantum").toULongLong(&ok);
+    if (!ok || options.quantum == 0) {
+        cerr << "Error: The quantum must be at least 1 instruction" << endl;
+        return 1;
+    }
+    options.dataCache = parser.isSet("dcache");
+    options.instrCache = parser.isSet("icache");
+
+    if (!Ripes::parseCacheConfig(parser.value("cache-config"), options)) {
+        cerr << "Error: Cache configuration must be given as <lines>,<ways>,<blocks>" << endl;
+        return 1;
+    }
+    if ((parser.isSet("l2-config") && !Ripes::parseCacheConfig(parser.value("l2-config"), options.l2Cache)) ||
+        (parser.isSet("l3-config") && !Ripes::parseCacheConfig(parser.value("l3-config"), options.l3Cache))) {
+        cerr << "Error: Lower level cache configurations must be given as <lines>,<ways>,<blocks>" << endl;
+        return 1;
+    }
+    if (!Ripes::parseCacheLatencies(parser.value("cache-latencies"), options)) {
+        cerr << "Error: Cache latencies must be given as <l1>,<l2>,<l3>,<memory>" << endl;
+        return 1;
+    }
+    if (!Ripes::parseCacheWarmup(parser.value("cache-warmup"), options)) {
+        cerr << "Error: Cache warm-up must be given as none, cycles:<n>, accesses:<n> or pc:<address>" << endl;
+        return 1;
+    }
+    if (parser.isSet("cache-window") && !Ripes::parseCacheWindow(parser.value("cache-window"), options)) {
+        cerr << "Error: Cache statistics window must be given as <first>,<last>" << endl;
+        return 1;
+    }
+    options.dram = parser.isSet("dram");
+    if (!Ripes::parseDRAMConfig(parser.value("dram-config"), options)) {
+        cerr << "Error: DRAM configuration must be given as <banks>,<row size>,<policy>,<tRCD>,<tCAS>,<tRP>" << endl;
+        return 1;
+    }
+    options.instrTLB = parser.isSet("itlb");
+    options.dataTLB = parser.isSet("dtlb");
+    if (!Ripes::parseTLBConfig(parser.value("tlb-config"), options)) {
+        cerr << "Error: TLB configuration must be given as <sets>,<ways>,<repl>,<walk latency>" << endl;
+        return 1;
+    }
+
+    if (server) {
+        if (!options.tracePath.isEmpty() || !options.statisticsPath.isEmpty() || !options.hostProfilePath.isEmpty() ||
+            !options.flameGraphPath.isEmpty() || !options.restoreSnapshotPath.isEmpty() ||
+            !options.saveSnapshotPath.isEmpty() || !options.memoryDumpPath.isEmpty()) {
+            cerr << "Error: Traces, reports, profiles, snapshots and memory images cannot be used in server mode"
+                 << endl;
+            return 1;
+        }
+        Ripes::SimulationServer simulationServer(options, static_cast<int>(jobThreads));
+        QString error;
+        if (!simulationServer.listen(parser.value("server"), error)) {
+            cerr << "Error: " << error.toStdString() << endl;
+            return 1;
+        }
+        cout << "Listening on " << simulationServer.fullServerName().toStdString() << endl;
+        return app.exec();
+    }
+
+    if (batch) {
+        if (!options.tracePath.isEmpty()) {
+            cerr << "Error: Execution traces cannot be recorded in batch mode" << endl;
+            return 1;
+        }
+        if (!options.pipelineTracePath.isEmpty()) {
+            cerr << "Error: Pipeline traces are given per job in batch mode" << endl;
+            return 1;
+        }
+        if (!options.statisticsPath.isEmpty()) {
+            cerr << "Error: Statistics of batch jobs are written to the batch report (--report)" << endl;
+            return 1;
+        }
+        if (!options.hostProfilePath.isEmpty()) {
+            cerr << "Error: The host profiler cannot be used in batch mode" << endl;
+            return 1;
+        }
+        if (!options.flameGraphPath.isEmpty()) {
+            cerr << "Error: Flame graphs cannot be written in batch mode" << endl;
+            return 1;
+        }
+        if (!options.restoreSnapshotPath.isEmpty() || !options.saveSnapshotPath.isEmpty()) {
+            cerr << "Error: Snapshots cannot be used in batch mode" << endl;
+            return 1;
+        }
+        if (!options.memoryDumpPath.isEmpty()) {
+            cerr << "Error: Memory images cannot be written in batch mode" << endl;
+            return 1;
+        }
+        std::vector<Ripes::HeadlessOptions> jobs;
+        QString error;
+        if (!Ripes::parseBatchJobs(parser.value("batch"), options, jobs, error)) {
+            cerr << "Error: " << error.toStdString() << endl;
+            return 1;
+        }
+        const auto results = Ripes::runBatch(jobs, static_cast<int>(jobThreads), static_cast<unsigned>(lockstepLanes));
+        if (!Ripes::writeBatchReport(parser.value("report"), jobs, results, error)) {
+            cerr << "Error: " << error.toStdString() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    return Ripes::runHeadless(options);
+}
+
+}  // namespace
+
 int main(int argc, char** argv) {
     Q_INIT_RESOURCE(icons);
     Q_INIT_RESOURCE(examples);
     Q_INIT_RESOURCE(layouts);
     Q_INIT_RESOURCE(fonts);
 
+    // Headless mode must be determined before the application is constructed, given that no display may be available.
+    bool headless = false;
+    for (int i = 1; i < argc; i++) {
+        headless |= QString(argv[i]) == "--headless" || QString(argv[i]) == "--batch" || QString(argv[i]) == "--server";
+    }
+    if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    // The default processor is constructed while the application and main window are set up
+    if (!headless) {
+        Ripes::ProcessorHandler::prepareProcessor(Ripes::ProcessorHandler::s_defaultProcessor);
+    }
+
     QApplication app(argc, argv);
+    if (headless) {
+        return runHeadless(app);
+    }
+
     Ripes::MainWindow m;
 
     // The following sequence of events manages to successfully start the application as maximized, with the processor
@@ -0,0 +1,100 @@
+#include "accesspatterns.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "defines.h"
+
+namespace Ripes {
+
+void AccessPatternAnalyzer::setProgram(const Program* program) {
+    std::vector<Pattern> instructions;
+    if (const auto* text = program ? program->getSection(TEXT_SECTION_NAME) : nullptr) {
+        const auto* data = reinterpret_cast<const uint8_t*>(text->data.constData());
+        const size_t count = static_cast<size_t>(text->data.size()) / 4;
+        for (size_t i = 0; i < count; i++) {
+            const uint32_t instr = data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16) |
+                                   (static_cast<uint32_t>(data[i * 4 + 3]) << 24);
+            const uint32_t opcode = instr & 0b1111111;
+            if (opcode != instrType::LOAD && opcode != instrType::STORE) {
+                continue;
+            }
+            Pattern pattern;
+            pattern.pc = static_cast<uint32_t>(text->address + i * 4);
+            pattern.store = opcode == instrType::STORE;
+            pattern.base = (instr >> 15) & 0b11111;
+            const uint32_t storeOffset =
+                static_cast<uint32_t>(static_cast<int32_t>(instr & 0xFE000000) >> 20) | ((instr >> 7) & 0b11111);
+            pattern.offset = pattern.store ? static_cast<int32_t>(storeOffset) : static_cast<int32_t>(instr) >> 20;
+            instructions.push_back(pattern);
+        }
+    }
+
+    // The table is kept at most half full, such that probe sequences stay short
+    m_table.clear();
+    m_shift = 32;
+    if (!instructions.empty()) {
+        size_t size = 2;
+        m_shift = 31;
+        while (size < instructions.size() * 2) {
+            size *= 2;
+            m_shift--;
+        }
+        m_table.assign(size, Pattern());
+        for (const auto& pattern : instructions) {
+            uint32_t slot = hash(pattern.pc);
+            while (m_table[slot].pc != s_empty) {
+                slot = (slot + 1) & (size - 1);
+            }
+            m_table[slot] = pattern;
+        }
+    }
+    clear();
+}
+
+void AccessPatternAnalyzer::clear() {
+    for (auto& pattern : m_table) {
+        Pattern cleared;
+        cleared.pc = pattern.pc;
+        cleared.store = pattern.store;
+        cleared.base = pattern.base;
+        cleared.offset = pattern.offset;
+        pattern = cleared;
+    }
+    m_blocks = ReuseDistanceAnalyzer::SetStack();
+    m_generation++;
+}
+
+void AccessPatternAnalyzer::record(Pattern& pattern, uint32_t address) {
+    if (pattern.accesses != 0) {
+        const auto stride = static_cast<int32_t>(address - pattern.lastAddress);
+        if (pattern.votes != 0 && stride == pattern.stride) {
+            pattern.strideHits++;
+        }
+        if (pattern.votes == 0) {
+            pattern.stride = stride;
+            pattern.votes = 1;
+        } else {
+            pattern.votes += stride == pattern.stride ? 1 : -1;
+        }
+    }
+    pattern.lastAddress = address;
+    pattern.accesses++;
+
+    const long long distance = m_blocks.access(address >> s_blockBits);
+    if (distance >= 0) {
+        pattern.reuses++;
+        pattern.reuseDistances += distance;
+    }
+    m_generation++;
+}
+
+std::vector<AccessPatternAnalyzer::Pattern> AccessPatternAnalyzer::patterns() const {
+    std::vector<Pattern> patterns;
+    std::copy_if(m_table.begin(), m_table.end(), std::back_inserter(patterns),
+                 [](const Pattern& pattern) { return pattern.accesses != 0; });
+    std::sort(patterns.begin(), patterns.end(), [](const Pattern& a, const Pattern& b) { return a.pc < b.pc; });
+    return patterns;
+}
+
+}  // namespace Ripes
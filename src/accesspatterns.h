@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "cachesim/reusedistance.h"
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * @brief The AccessPatternAnalyzer class
+ * Characterizes the data memory accesses of each load and store instruction of the loaded program; the dominant stride
+ * between its consecutive addresses, how often its next address follows that stride, and the reuse distance of its
+ * accesses. The dominant stride is elected by a majority vote over the strides, such that it is the stride of more than
+ * half of the accesses whenever such a stride exists. The reuse distance of an access is the number of distinct blocks
+ * of s_blockSize bytes accessed by any instruction since its block was last accessed; the LRU stack distance in a fully
+ * associative cache.
+ * The memory instructions are decoded once per program into a small open addressing hash table keyed by their address,
+ * sized to the number of memory instructions of the text section, such that each access costs a single probe.
+ */
+class AccessPatternAnalyzer {
+public:
+    static constexpr unsigned s_blockBits = 4;
+    static constexpr unsigned s_blockSize = 1 << s_blockBits;
+    /// Instructions are word aligned, such that an unaligned address marks an empty slot of the table
+    static constexpr uint32_t s_empty = 1;
+
+    struct Pattern {
+        uint32_t pc = s_empty;
+        bool store = false;
+        /// Base register and offset of the address of the instruction
+        uint8_t base = 0;
+        int32_t offset = 0;
+
+        long long accesses = 0;
+        uint32_t lastAddress = 0;
+        /// Dominant stride, and its lead over the other strides in the majority vote
+        int32_t stride = 0;
+        long long votes = 0;
+        /// Accesses whose stride matched the dominant stride at the time; the accesses a stride prefetcher predicts
+        long long strideHits = 0;
+        /// Accesses to blocks which had been accessed before, and the sum of their reuse distances
+        long long reuses = 0;
+        long long reuseDistances = 0;
+
+        double strideConfidence() const {
+            return accesses > 1 ? static_cast<double>(strideHits) / (accesses - 1) : 0;
+        }
+        double meanReuseDistance() const { return reuses > 0 ? static_cast<double>(reuseDistances) / reuses : 0; }
+    };
+
+    /**
+     * @brief setProgram
+     * Analyzes the memory instructions of the text section of @p program, or no instructions if nullptr, discarding all
+     * counts.
+     */
+    void setProgram(const Program* program);
+    void clear();
+
+    /// @returns true if the text section holds no memory instructions
+    bool empty() const { return m_table.empty(); }
+
+    /// @returns the memory instruction at @p pc, or nullptr if @p pc is not a memory instruction of the text section
+    Pattern* lookup(uint32_t pc) {
+        if (m_table.empty()) {
+            return nullptr;
+        }
+        for (uint32_t slot = hash(pc);; slot = (slot + 1) & (m_table.size() - 1)) {
+            if (m_table[slot].pc == pc) {
+                return &m_table[slot];
+            } else if (m_table[slot].pc == s_empty) {
+                return nullptr;
+            }
+        }
+    }
+    const Pattern* at(uint32_t pc) const { return const_cast<AccessPatternAnalyzer*>(this)->lookup(pc); }
+
+    /// Records an access of the memory instruction @p pattern to @p address
+    void record(Pattern& pattern, uint32_t address);
+
+    /// @returns the memory instructions which have accessed memory, by address
+    std::vector<Pattern> patterns() const;
+
+    /// @returns a counter which is incremented whenever the counts change, for views to detect updates
+    unsigned long long generation() const { return m_generation; }
+
+private:
+    uint32_t hash(uint32_t pc) const { return ((pc >> 2) * 0x9E3779B1u) >> m_shift; }
+
+    std::vector<Pattern> m_table;
+    unsigned m_shift = 0;
+    ReuseDistanceAnalyzer::SetStack m_blocks;
+    unsigned long long m_generation = 0;
+};
+
+}  // namespace Ripes
@@ -3,116 +3,72 @@
 #include "defines.h"
 #include "lexerutilities.h"
 #include "processorhandler.h"
+#include "processors/RISC-V/rv_compressed.h"
 
-#include <QRegularExpression>
+#include <QHash>
 #include <QTextBlock>
 
+#include <algorithm>
+#include <vector>
+
 #define DATA_START 0x10000000
 
 namespace Ripes {
 
 namespace {
-// Instruction groupings needed for various identification operations
-const QStringList pseudoOps = QStringList() << "nop"
-                                            << "la"
-                                            << "nop"
-                                            << "li"
-                                            << "mv"
-                                            << "not"
-                                            << "neg"
-                                            << "seqz"
-                                            << "snez"
-                                            << "sltz"
-                                            << "sgtz"
-                                            << "beqz"
-                                            << "bgez"
-                                            << "bnez"
-                                            << "blez"
-                                            << "bltz"
-                                            << "bgtz"
-                                            << "bgt"
-                                            << "ble"
-                                            << "bgtu"
-                                            << "bleu"
-                                            << "j"
-                                            << "jal"
-                                            << "jr"
-                                            << "jalr"
-                                            << "ret"
-                                            << "call"
-                                            << "tail"
-                                            << "lb"
-                                            << "lh"
-                                            << "lw"
-                                            << "sb"
-                                            << "sh"
-                                            << "sw";
-
-const QStringList opsWithOffsets = QStringList() << "beq"
-                                                 << "bne"
-                                                 << "bge"
-                                                 << "blt"
-                                                 << "bltu"
-                                                 << "bgeu"
-                                                 << "jal"
-                                                 << "auipc"
-                                                 << "jalr";
-
-// Grouping of instructions that require the same format
-const QStringList opImmInstructions = QStringList() << "addi"
-                                                    << "slli"
-                                                    << "slti"
-                                                    << "xori"
-                                                    << "sltiu"
-                                                    << "srli"
-                                                    << "srai"
-                                                    << "ori"
-                                                    << "andi";
-
-const QStringList opInstructions = QStringList() << "add"
-                                                 << "sub"
-                                                 << "mul"
-                                                 << "mulh"
-                                                 << "sll"
-                                                 << "mulhsu"
-                                                 << "slt"
-                                                 << "mulhu"
-                                                 << "sltu"
-                                                 << "div"
-                                                 << "xor"
-                                                 << "srl"
-                                                 << "sra"
-                                                 << "divu"
-                                                 << "rem"
-                                                 << "or"
-                                                 << "remu"
-                                                 << "and";
-
-const QStringList storeInstructions = QStringList() << "sb"
-                                                    << "sh"
-                                                    << "sw";
-
-const QStringList loadInstructions = QStringList() << "lb"
-                                                   << "lh"
-                                                   << "lw"
-                                                   << "lbu"
-                                                   << "lhu";
-
-const QStringList branchInstructions = QStringList() << "beq"
-                                                     << "bne"
-                                                     << "blt"
-                                                     << "bge"
-                                                     << "bltu"
-                                                     << "bgeu";
-const QStringList DataAssemblerDirectives = QStringList() << ".word"
-                                                          << ".half"
-                                                          << ".short"
-                                                          << ".byte"
-                                                          << ".2byte"
-                                                          << ".4byte"
-                                                          << ".long";
-const static QMap<QString, size_t> DataAssemblerSizes{{".word", 4},  {".half", 2},  {".short", 2}, {".byte", 1},
-                                                      {".2byte", 2}, {".4byte", 4}, {".long", 4}};
+// Instruction groupings needed for various identification operations. Mnemonics may belong to several groups.
+enum MnemonicGroup : unsigned {
+    PseudoOp = 1 << 0,
+    OpWithOffset = 1 << 1,
+    // Groupings of instructions that require the same format
+    OpImmInstruction = 1 << 2,
+    OpInstruction = 1 << 3,
+    StoreInstruction = 1 << 4,
+    LoadInstruction = 1 << 5,
+    BranchInstruction = 1 << 6,
+    CSRInstruction = 1 << 7,
+    CompressedInstruction = 1 << 8,
+};
+
+QHash<QString, unsigned> initMnemonicGroups() {
+    const std::vector<std::pair<unsigned, QStringList>> groups = {
+        {PseudoOp, {"nop",      "la",       "li",      "mv",       "not",       "neg",        "seqz",
+                    "snez",     "sltz",     "sgtz",    "beqz",     "bgez",      "bnez",       "blez",
+                    "bltz",     "bgtz",     "bgt",     "ble",      "bgtu",      "bleu",       "j",
+                    "jal",      "jr",       "jalr",    "ret",      "call",      "tail",       "lb",
+                    "lh",       "lw",       "sb",      "sh",       "sw",        "rdcycle",    "rdcycleh",
+                    "rdtime",   "rdtimeh",  "rdinstret", "rdinstreth", "csrr"}},
+        {OpWithOffset, {"beq", "bne", "bge", "blt", "bltu", "bgeu", "jal", "auipc", "jalr", "c.j", "c.jal", "c.beqz",
+                        "c.bnez"}},
+        {OpImmInstruction, {"addi", "slli", "slti", "xori", "sltiu", "srli", "srai", "ori", "andi"}},
+        {OpInstruction, {"add", "sub", "mul", "mulh", "sll", "mulhsu", "slt", "mulhu", "sltu", "div", "xor", "srl",
+                         "sra", "divu", "rem", "or", "remu", "and"}},
+        {StoreInstruction, {"sb", "sh", "sw"}},
+        {LoadInstruction, {"lb", "lh", "lw", "lbu", "lhu"}},
+        {BranchInstruction, {"beq", "bne", "blt", "bge", "bltu", "bgeu"}},
+        {CSRInstruction, {"csrrw", "csrrs", "csrrc", "csrrwi", "csrrsi", "csrrci"}},
+        {CompressedInstruction, {"c.nop", "c.addi", "c.li",  "c.lui",  "c.addi16sp", "c.addi4spn", "c.slli",
+                                 "c.srli", "c.srai", "c.andi", "c.mv",  "c.add",  "c.sub",      "c.xor",
+                                 "c.or",  "c.and",  "c.lw",   "c.sw",   "c.lwsp", "c.swsp",     "c.j",
+                                 "c.jal", "c.jr",   "c.jalr", "c.beqz", "c.bnez"}}};
+    QHash<QString, unsigned> mnemonics;
+    for (const auto& group : groups) {
+        for (const auto& mnemonic : group.second) {
+            mnemonics[mnemonic] |= group.first;
+        }
+    }
+    return mnemonics;
+}
+
+/// Groups of each known mnemonic, such that identifying an operation costs a single hash lookup
+const static QHash<QString, unsigned> s_mnemonicGroups = initMnemonicGroups();
+
+unsigned mnemonicGroups(const QString& mnemonic) {
+    return s_mnemonicGroups.value(mnemonic, 0);
+}
+
+const static QHash<QString, size_t> DataAssemblerSizes{{".word", 4},  {".half", 2},  {".short", 2}, {".byte", 1},
+                                                       {".2byte", 2}, {".4byte", 4}, {".long", 4}};
 }  // namespace
 
 Assembler::Assembler() {}
@@ -129,6 +85,15 @@ uint32_t Assembler::getRegisterNumber(const QString& reg) {
     }
 }
 
+uint32_t Assembler::getCSRNumber(const QString& csr, bool& canConvert) {
+    // Converts a CSR name or number to its numeric value
+    if (CSRNames.contains(csr)) {
+        canConvert = true;
+        return CSRNames[csr];
+    }
+    return static_cast<uint32_t>(getImmediate(csr, canConvert));
+}
+
 int Assembler::getImmediate(QString string, bool& canConvert) {
     // Extracts an immediate number from a string, being base 10, 16 or 2
     canConvert = false;
@@ -167,7 +132,7 @@ QByteArray Assembler::assembleOpImmInstruction(const QStringList& fields, int ro
             // An offset value has been provided ( unfolded pseudo-op)
             m_error |= !m_labelPosMap.contains(fields[3]);
             // calculate offset 31:12 bits - we -1 to get the row of the previois auipc op
-            imm = m_labelPosMap[fields[3]] - (row - 1) * 4;
+            imm = m_labelPosMap[fields[3]] - textOffset(row - 1);
         }
         funct3 = 0b000;
     } else if (fields[0] == "slli") {
@@ -281,7 +246,7 @@ QByteArray Assembler::assembleStoreInstruction(const QStringList& fields, int ro
         // A label was provided
         m_error |= !m_labelPosMap.contains(fields[2]);
         // calculate offset 31:12 bits - we -1 to get the row of the previois auipc op
-        imm = m_labelPosMap[fields[2]] - (row - 1) * 4;
+        imm = m_labelPosMap[fields[2]] - textOffset(row - 1);
     }
 
     return uintToByteArr(instrType::STORE | getRegisterNumber(fields[3]) << 15 | getRegisterNumber(fields[1]) << 20 |
@@ -311,7 +276,7 @@ QByteArray Assembler::assembleLoadInstruction(const QStringList& fields, int row
     } else {
         m_error |= !m_labelPosMap.contains(fields[2]);
         // calculate offset 31:12 bits - we -1 to get the row of the previois auipc op
-        imm = (m_labelPosMap[fields[2]] & 0xfff) - (row - 1) * 4;
+        imm = (m_labelPosMap[fields[2]] & 0xfff) - textOffset(row - 1);
     }
 
     return uintToByteArr(instrType::LOAD | funct3 << 12 | getRegisterNumber(fields[1]) << 7 | imm << 20 |
@@ -322,7 +287,7 @@ QByteArray Assembler::assembleBranchInstruction(const QStringList& fields, int r
     // calculate offset
     Q_ASSERT(m_labelPosMap.contains(fields[3]));
     int offset = m_labelPosMap[fields[3]];
-    offset = offset - row * 4;  // byte-wize addressing
+    offset = offset - textOffset(row);  // byte-wize addressing
     uint32_t funct3 = 0;
     if (fields[0] == "beq") {
         funct3 = 0b000;
@@ -375,26 +340,156 @@ QByteArray Assembler::assembleJalrInstruction(const QStringList& fields, int row
         // An offset value has been provided ( unfolded pseudo-op)
         m_error |= !m_labelPosMap.contains(fields[3]);
         // calculate offset 31:12 bits - we -1 to get the row of the previois auipc op
-        imm = m_labelPosMap[fields[3]] - (row - 1) * 4;
+        imm = m_labelPosMap[fields[3]] - textOffset(row - 1);
     }
 
     return uintToByteArr(instrType::JALR | getRegisterNumber(fields[1]) << 7 | getRegisterNumber(fields[2]) << 15 |
                          (imm & 0xfff) << 20);
 }
 
+QByteArray Assembler::assembleCSRInstruction(const QStringList& fields, int row) {
+    Q_UNUSED(row);
+    uint32_t funct3 = 0;
+    bool canConvert;
+    const uint32_t csr = getCSRNumber(fields[2], canConvert);
+    m_error |= !canConvert;
+    // The immediate forms encode a 5-bit unsigned immediate in place of rs1
+    uint32_t rs1 = 0;
+    if (fields[0].endsWith('i')) {
+        rs1 = static_cast<uint32_t>(getImmediate(fields[3], canConvert)) & 0b11111;
+        m_error |= !canConvert;
+    } else {
+        rs1 = getRegisterNumber(fields[3]);
+    }
+    if (fields[0] == "csrrw") {
+        funct3 = 0b001;
+    } else if (fields[0] == "csrrs") {
+        funct3 = 0b010;
+    } else if (fields[0] == "csrrc") {
+        funct3 = 0b011;
+    } else if (fields[0] == "csrrwi") {
+        funct3 = 0b101;
+    } else if (fields[0] == "csrrsi") {
+        funct3 = 0b110;
+    } else if (fields[0] == "csrrci") {
+        funct3 = 0b111;
+    } else {
+        m_error = true;
+        Q_ASSERT(false);
+    }
+    return uintToByteArr(instrType::ECALL | funct3 << 12 | getRegisterNumber(fields[1]) << 7 | rs1 << 15 |
+                         (csr & 0xfff) << 20);
+}
+
+QByteArray Assembler::assembleCompressedInstruction(const QStringList& fields, int row) {
+    // Immediates are given in bytes. Immediates which are not a multiple of the scale of their field, stack pointer
+    // relative instructions of another base register and reserved encodings are assembly errors.
+    using namespace rvc;
+    const QString& mnemonic = fields[0];
+    bool canConvert = true;
+    const auto reg = [&](int i) { return getRegisterNumber(fields[i]); };
+    // Registers of the CIW, CL, CS, CA and CB formats, which only address x8-x15
+    const auto creg = [&](int i) {
+        const unsigned r = reg(i);
+        m_error |= r < 8 || r > 15;
+        return r;
+    };
+    const auto imm = [&](int i, int scale) {
+        const int value = getImmediate(fields[i], canConvert);
+        m_error |= value % scale != 0;
+        return static_cast<uint32_t>(value);
+    };
+    const auto offset = [&](int i, unsigned bits) {
+        m_error |= !m_labelPosMap.contains(fields[i]);
+        const int value = m_labelPosMap[fields[i]] - textOffset(row);
+        m_error |= value < -(1 << (bits - 1)) || value >= (1 << (bits - 1));
+        return static_cast<uint32_t>(value);
+    };
+
+    uint32_t c = 0;
+    if (mnemonic == "c.nop") {
+        c = encodeCI(0b01, 0b000, 0, 0);
+    } else if (mnemonic == "c.addi") {
+        c = encodeCI(0b01, 0b000, reg(1), imm(2, 1));
+    } else if (mnemonic == "c.li") {
+        c = encodeCI(0b01, 0b010, reg(1), imm(2, 1));
+    } else if (mnemonic == "c.lui") {
+        // The immediate is that of lui, which must be the sign extension of its 6 least significant bits
+        const uint32_t value = imm(2, 1);
+        m_error |= reg(1) == 2 || (signExtend(value, 6) & 0xfffff) != value;
+        c = encodeCI(0b01, 0b011, reg(1), value);
+    } else if (mnemonic == "c.addi16sp") {
+        m_error |= reg(1) != 2;
+        c = encodeAddi16sp(imm(2, 16));
+    } else if (mnemonic == "c.addi4spn") {
+        m_error |= reg(2) != 2;
+        c = encodeAddi4spn(creg(1), imm(3, 4));
+    } else if (mnemonic == "c.slli") {
+        c = encodeCI(0b10, 0b000, reg(1), imm(2, 1));
+    } else if (mnemonic == "c.srli") {
+        c = encodeCBImm(0b00, creg(1), imm(2, 1));
+    } else if (mnemonic == "c.srai") {
+        c = encodeCBImm(0b01, creg(1), imm(2, 1));
+    } else if (mnemonic == "c.andi") {
+        c = encodeCBImm(0b10, creg(1), imm(2, 1));
+    } else if (mnemonic == "c.mv" || mnemonic == "c.add") {
+        // rs2 = x0 encodes c.jr and c.jalr
+        m_error |= reg(2) == 0;
+        c = encodeCR(0b10, mnemonic == "c.mv" ? 0b1000 : 0b1001, reg(1), reg(2));
+    } else if (mnemonic == "c.jr" || mnemonic == "c.jalr") {
+        c = encodeCR(0b10, mnemonic == "c.jr" ? 0b1000 : 0b1001, reg(1), 0);
+    } else if (mnemonic == "c.sub") {
+        c = encodeCA(0b100011, creg(1), 0b00, creg(2));
+    } else if (mnemonic == "c.xor") {
+        c = encodeCA(0b100011, creg(1), 0b01, creg(2));
+    } else if (mnemonic == "c.or") {
+        c = encodeCA(0b100011, creg(1), 0b10, creg(2));
+    } else if (mnemonic == "c.and") {
+        c = encodeCA(0b100011, creg(1), 0b11, creg(2));
+    } else if (mnemonic == "c.lw") {
+        c = encodeCLW(0b010, creg(3), creg(1), imm(2, 4));
+    } else if (mnemonic == "c.sw") {
+        c = encodeCLW(0b110, creg(3), creg(1), imm(2, 4));
+    } else if (mnemonic == "c.lwsp") {
+        m_error |= reg(3) != 2;
+        c = encodeLwsp(reg(1), imm(2, 4));
+    } else if (mnemonic == "c.swsp") {
+        m_error |= reg(3) != 2;
+        c = encodeSwsp(reg(1), imm(2, 4));
+    } else if (mnemonic == "c.j") {
+        c = encodeCJ(0b101, offset(1, 12));
+    } else if (mnemonic == "c.jal") {
+        c = encodeCJ(0b001, offset(1, 12));
+    } else if (mnemonic == "c.beqz") {
+        c = encodeCB(0b110, creg(1), offset(2, 9));
+    } else if (mnemonic == "c.bnez") {
+        c = encodeCB(0b111, creg(1), offset(2, 9));
+    } else {
+        m_error = true;
+        Q_ASSERT(false);
+    }
+    m_error |= !canConvert || expandCompressed(c) == 0;
+    return uintToByteArr(c).left(2);
+}
+
 void Assembler::assembleInstruction(const QStringList& fields, int row) {
     // Translates a single assembly instruction into binary
-    QString instruction = fields[0];
-    if (opImmInstructions.contains(instruction)) {
+    const QString& instruction = fields[0];
+    const unsigned groups = mnemonicGroups(instruction);
+    if (groups & OpImmInstruction) {
         m_textSegment.append(assembleOpImmInstruction(fields, row));
-    } else if (opInstructions.contains(instruction)) {
+    } else if (groups & OpInstruction) {
         m_textSegment.append(assembleOpInstruction(fields, row));
-    } else if (storeInstructions.contains(instruction)) {
+    } else if (groups & StoreInstruction) {
         m_textSegment.append(assembleStoreInstruction(fields, row));
-    } else if (loadInstructions.contains(instruction)) {
+    } else if (groups & LoadInstruction) {
         m_textSegment.append(assembleLoadInstruction(fields, row));
-    } else if (branchInstructions.contains(instruction)) {
+    } else if (groups & BranchInstruction) {
         m_textSegment.append(assembleBranchInstruction(fields, row));
+    } else if (groups & CSRInstruction) {
+        m_textSegment.append(assembleCSRInstruction(fields, row));
+    } else if (groups & CompressedInstruction) {
+        m_textSegment.append(assembleCompressedInstruction(fields, row));
     } else if (instruction == "jalr") {
         m_textSegment.append(assembleJalrInstruction(fields, row));
     } else if (instruction == "lui") {
@@ -407,7 +502,7 @@ void Assembler::assembleInstruction(const QStringList& fields, int row) {
     } else if (instruction == "jal") {
         Q_ASSERT(m_labelPosMap.contains(fields[2]));
         int32_t imm = m_labelPosMap[fields[2]];
-        imm = imm - row * 4;
+        imm = imm - textOffset(row);
         imm = (imm & 0x7fe) << 20 | (imm & 0x800) << 9 | (imm & 0xff000) | (imm & 0x100000) << 11;
         m_textSegment.append(uintToByteArr(instrType::JAL | getRegisterNumber(fields[1]) << 7 | imm));
     } else if (instruction == "ecall") {
@@ -421,12 +516,12 @@ void Assembler::assembleInstruction(const QStringList& fields, int row) {
 
 void Assembler::unpackPseudoOp(const QStringList& fields, int& pos) {
     if (fields.first() == "la") {
-        m_instructionsMap[pos] = QStringList() << "auipc" << fields[1] << fields[2];
-        m_instructionsMap[pos + 1] = QStringList() << "addi" << fields[1] << fields[1] << fields[2];
+        instruction(pos) = QStringList() << "auipc" << fields[1] << fields[2];
+        instruction(pos + 1) = QStringList() << "addi" << fields[1] << fields[1] << fields[2];
         m_lineLabelUsageMap[pos] = fields[2];
         pos += 2;
     } else if (fields.first() == "nop") {
-        m_instructionsMap[pos] = QStringList() << "addi"
+        instruction(pos) = QStringList() << "addi"
                                                << "x0"
                                                << "x0"
                                                << "0";
@@ -441,125 +536,125 @@ void Assembler::unpackPseudoOp(const QStringList& fields, int& pos) {
 
         if (isInt<12>(immediate)) {
             // immediate can be represented by 12 bits, ADDI is sufficient
-            m_instructionsMap[pos] = QStringList() << "addi" << fields[1] << "x0" << QString::number(immediate);
+            instruction(pos) = QStringList() << "addi" << fields[1] << "x0" << QString::number(immediate);
             pos++;
         } else {
             const int lower12Signed = signextend<int32_t, 12>(immediate & 0xFFF);
             int signOffset = lower12Signed < 0 ? 1 : 0;
 
-            m_instructionsMap[pos] = QStringList()
+            instruction(pos) = QStringList()
                                      << "lui" << fields[1]
                                      << QString::number((static_cast<uint32_t>(immediate) >> 12) + signOffset);
             pos++;
             if ((immediate & 0xFFF) != 0) {
-                m_instructionsMap[pos] = QStringList()
+                instruction(pos) = QStringList()
                                          << "addi" << fields[1] << fields[1] << QString::number(lower12Signed);
                 pos++;
             }
         }
     } else if (fields.first() == "mv") {
-        m_instructionsMap[pos] = QStringList() << "addi" << fields[1] << fields[2] << "0";
+        instruction(pos) = QStringList() << "addi" << fields[1] << fields[2] << "0";
         pos++;
     } else if (fields.first() == "not") {
-        m_instructionsMap[pos] = QStringList() << "xori" << fields[1] << fields[2] << "-1";
+        instruction(pos) = QStringList() << "xori" << fields[1] << fields[2] << "-1";
         pos++;
     } else if (fields.first() == "neg") {
-        m_instructionsMap[pos] = QStringList() << "sub" << fields[1] << "x0" << fields[2];
+        instruction(pos) = QStringList() << "sub" << fields[1] << "x0" << fields[2];
         pos++;
     } else if (fields.first() == "seqz") {
-        m_instructionsMap[pos] = QStringList() << "sltiu" << fields[1] << fields[2] << "1";
+        instruction(pos) = QStringList() << "sltiu" << fields[1] << fields[2] << "1";
         pos++;
     } else if (fields.first() == "snez") {
-        m_instructionsMap[pos] = QStringList() << "sltu" << fields[1] << "x0" << fields[2];
+        instruction(pos) = QStringList() << "sltu" << fields[1] << "x0" << fields[2];
         pos++;
     } else if (fields.first() == "sltz") {
-        m_instructionsMap[pos] = QStringList() << "slt" << fields[1] << fields[2] << "x0";
+        instruction(pos) = QStringList() << "slt" << fields[1] << fields[2] << "x0";
         pos++;
     } else if (fields.first() == "sgtz") {
-        m_instructionsMap[pos] = QStringList() << "slt" << fields[1] << "x0" << fields[2];
+        instruction(pos) = QStringList() << "slt" << fields[1] << "x0" << fields[2];
         pos++;
     } else if (fields.first() == "beqz") {
-        m_instructionsMap[pos] = QStringList() << "beq" << fields[1] << "x0" << fields[2];
+        instruction(pos) = QStringList() << "beq" << fields[1] << "x0" << fields[2];
         pos++;
     } else if (fields.first() == "bnez") {
-        m_instructionsMap[pos] = QStringList() << "bne" << fields[1] << "x0" << fields[2];
+        instruction(pos) = QStringList() << "bne" << fields[1] << "x0" << fields[2];
         pos++;
     } else if (fields.first() == "blez") {
-        m_instructionsMap[pos] = QStringList() << "bge"
+        instruction(pos) = QStringList() << "bge"
                                                << "x0" << fields[1] << fields[2];
         pos++;
     } else if (fields.first() == "bgez") {
-        m_instructionsMap[pos] = QStringList() << "bge" << fields[1] << "x0" << fields[2];
+        instruction(pos) = QStringList() << "bge" << fields[1] << "x0" << fields[2];
         pos++;
     } else if (fields.first() == "bltz") {
-        m_instructionsMap[pos] = QStringList() << "blt" << fields[1] << "x0" << fields[2];
+        instruction(pos) = QStringList() << "blt" << fields[1] << "x0" << fields[2];
         pos++;
     } else if (fields.first() == "bgtz") {
-        m_instructionsMap[pos] = QStringList() << "blt"
+        instruction(pos) = QStringList() << "blt"
                                                << "x0" << fields[1] << fields[2];
         pos++;
     } else if (fields.first() == "bgt") {
-        m_instructionsMap[pos] = QStringList() << "blt" << fields[2] << fields[1] << fields[3];
+        instruction(pos) = QStringList() << "blt" << fields[2] << fields[1] << fields[3];
         pos++;
     } else if (fields.first() == "ble") {
-        m_instructionsMap[pos] = QStringList() << "bge" << fields[2] << fields[1] << fields[3];
+        instruction(pos) = QStringList() << "bge" << fields[2] << fields[1] << fields[3];
         pos++;
     } else if (fields.first() == "bgtu") {
-        m_instructionsMap[pos] = QStringList() << "bltu" << fields[2] << fields[1] << fields[3];
+        instruction(pos) = QStringList() << "bltu" << fields[2] << fields[1] << fields[3];
         pos++;
     } else if (fields.first() == "bleu") {
-        m_instructionsMap[pos] = QStringList() << "bgeu" << fields[2] << fields[1] << fields[3];
+        instruction(pos) = QStringList() << "bgeu" << fields[2] << fields[1] << fields[3];
         pos++;
     } else if (fields.first() == "j") {
-        m_instructionsMap[pos] = QStringList() << "jal"
+        instruction(pos) = QStringList() << "jal"
                                                << "x0" << fields[1];
         m_lineLabelUsageMap[pos] = fields[1];
         pos++;
     } else if (fields.first() == "jal") {
         if (fields.length() == 3) {
             // Non-pseudo op JAL
-            m_instructionsMap[pos] = fields;
+            instruction(pos) = fields;
             m_lineLabelUsageMap[pos] = fields[2];
         } else {
             // Pseudo op JAL
-            m_instructionsMap[pos] = QStringList() << "jal"
+            instruction(pos) = QStringList() << "jal"
                                                    << "x1" << fields[1];
             m_lineLabelUsageMap[pos] = fields[1];
         }
         pos++;
     } else if (fields.first() == "jr") {
-        m_instructionsMap[pos] = QStringList() << "jalr"
+        instruction(pos) = QStringList() << "jalr"
                                                << "x0" << fields[1] << "0";
         pos++;
     } else if (fields.first() == "jalr") {
         if (fields.length() == 4) {
             // Non-pseudo op JALR
-            m_instructionsMap[pos] = fields;
+            instruction(pos) = fields;
         } else {
             // Pseudo op JALR
-            m_instructionsMap[pos] = QStringList() << "jalr"
+            instruction(pos) = QStringList() << "jalr"
                                                    << "x1" << fields[1] << "0";
         }
         pos++;
     } else if (fields.first() == "ret") {
-        m_instructionsMap[pos] = QStringList() << "jalr"
+        instruction(pos) = QStringList() << "jalr"
                                                << "x0"
                                                << "x1"
                                                << "0";
         pos++;
     } else if (fields.first() == "call") {
-        m_instructionsMap[pos] = QStringList() << "auipc"
+        instruction(pos) = QStringList() << "auipc"
                                                << "x6" << fields[1];
-        m_instructionsMap[pos + 1] = QStringList() << "jalr"
+        instruction(pos + 1) = QStringList() << "jalr"
                                                    << "x1"
                                                    << "x6" << fields[1];
         m_lineLabelUsageMap[pos] = fields[1];
         m_lineLabelUsageMap[pos + 1] = fields[1];
         pos += 2;
     } else if (fields.first() == "tail") {
-        m_instructionsMap[pos] = QStringList() << "auipc"
+        instruction(pos) = QStringList() << "auipc"
                                                << "x6" << fields[1];
-        m_instructionsMap[pos + 1] = QStringList() << "jalr"
+        instruction(pos + 1) = QStringList() << "jalr"
                                                    << "x0"
                                                    << "x6" << fields[1];
         m_lineLabelUsageMap[pos] = fields[1];
@@ -567,8 +662,8 @@ void Assembler::unpackPseudoOp(const QStringList& fields, int& pos) {
 
         pos += 2;
     } else if (fields.first() == "la") {
-        m_instructionsMap[pos] = QStringList() << "auipc" << fields[1] << fields[2];
-        m_instructionsMap[pos + 1] = QStringList() << "addi" << fields[1] << fields[1] << fields[2];
+        instruction(pos) = QStringList() << "auipc" << fields[1] << fields[2];
+        instruction(pos + 1) = QStringList() << "addi" << fields[1] << fields[1] << fields[2];
         m_lineLabelUsageMap[pos] = fields[1];
         m_lineLabelUsageMap[pos + 1] = fields[1];
 
@@ -579,12 +674,12 @@ void Assembler::unpackPseudoOp(const QStringList& fields, int& pos) {
             // convert immediate value
             bool canConvert;
             int imm = getImmediate(fields[2], canConvert);
-            m_instructionsMap[pos] = QStringList() << fields[0] << fields[1] << QString::number(imm) << fields[3];
+            instruction(pos) = QStringList() << fields[0] << fields[1] << QString::number(imm) << fields[3];
             pos++;
         } else {
             // Pseudo op load
-            m_instructionsMap[pos] = QStringList() << "auipc" << fields[1] << fields[2];
-            m_instructionsMap[pos + 1] = QStringList() << fields.first() << fields[1] << fields[2] << fields[1];
+            instruction(pos) = QStringList() << "auipc" << fields[1] << fields[2];
+            instruction(pos + 1) = QStringList() << fields.first() << fields[1] << fields[2] << fields[1];
             m_lineLabelUsageMap[pos] = fields[1];
             m_lineLabelUsageMap[pos + 1] = fields[1];
             pos += 2;
@@ -595,17 +690,24 @@ void Assembler::unpackPseudoOp(const QStringList& fields, int& pos) {
         int imm = getImmediate(fields[2], canConvert);
         if (canConvert) {
             // Non-pseudo op store
-            m_instructionsMap[pos] = fields;
+            instruction(pos) = fields;
             pos++;
         } else {
             // Pseudo op store
-            m_instructionsMap[pos] = QStringList() << "auipc" << fields[3] << fields[2];
-            m_instructionsMap[pos + 1] = QStringList()
+            instruction(pos) = QStringList() << "auipc" << fields[3] << fields[2];
+            instruction(pos + 1) = QStringList()
                                          << fields.first() << fields[1] << QString::number(imm) << fields[3];
             m_lineLabelUsageMap[pos] = fields[1];
             m_lineLabelUsageMap[pos + 1] = fields[1];
             pos += 2;
         }
+    } else if (fields.first().startsWith("rd")) {
+        // Counter reads; rdcycle, rdtime and rdinstret, and their upper halves
+        instruction(pos) = QStringList() << "csrrs" << fields[1] << fields.first().mid(2) << "x0";
+        pos++;
+    } else if (fields.first() == "csrr") {
+        instruction(pos) = QStringList() << "csrrs" << fields[1] << fields[2] << "x0";
+        pos++;
     } else {
         // Unknown pseudo op
         m_error = true;
@@ -625,12 +727,12 @@ void Assembler::assembleWords(const QStringList& fields, QByteArray& byteArray,
     }
 }
 
-// Allocates $size bytes in the static data segment
-void Assembler::assembleZeroArray(QByteArray& byteArray, size_t size) {
+// Allocates $size zero bytes in the static data segment. The bytes are materialized only once data follows them; bytes
+// trailing the data segment are left as the zero-filled bytes of the .data section.
+void Assembler::assembleZeroArray(size_t size) {
     Q_ASSERT(size >= 1);
-    for (unsigned i = 0; i < size; i++) {
-        byteArray.append(static_cast<char>(0x0));
-    }
+    // Pad to word-sized indexes, as per the other directives
+    m_dataZeroFill += (size + 3) & ~static_cast<size_t>(3);
 }
 
 void Assembler::assembleAssemblerDirective(const QStringList& fields) {
@@ -646,12 +748,17 @@ void Assembler::assembleAssemblerDirective(const QStringList& fields) {
         string.remove('\"');
         string.append('\0');
         byteArray = string.toUtf8();
-    } else if (DataAssemblerDirectives.contains(fields[0])) {
+    } else if (DataAssemblerSizes.contains(fields[0])) {
         assembleWords(fields, byteArray, DataAssemblerSizes.value(fields[0]));
-    } else if (fields[0] == QString(".zero")) {
+    } else if (fields[0] == QString(".zero") || fields[0] == QString(".space")) {
         bool canConvert;
-        assembleZeroArray(byteArray, static_cast<size_t>(getImmediate(fields[1], canConvert)));
-        m_error |= !canConvert;
+        const int size = getImmediate(fields[1], canConvert);
+        m_error |= !canConvert || size < 1;
+        if (!m_error) {
+            assembleZeroArray(static_cast<size_t>(size));
+            m_hasData = true;
+        }
+        return;
     } else if (fields[0] == QString(".data")) {
         // Following instructions will be assembled into the data segment
         m_inDataSegment = true;
@@ -668,6 +775,10 @@ void Assembler::assembleAssemblerDirective(const QStringList& fields) {
         for (int i = 0; i < padding; i++)
             byteArray.append('\0');
     }
+    if (m_dataZeroFill != 0) {
+        m_dataSegment.append(QByteArray(static_cast<int>(m_dataZeroFill), '\0'));
+        m_dataZeroFill = 0;
+    }
     m_dataSegment.append(byteArray);
 
     // Set hasData flag to trigger data segment insertion into simulator memory
@@ -699,10 +810,11 @@ void Assembler::unpackOp(const QStringList& _fields, int& pos) {
         if (m_inDataSegment) {
             m_labelPosMap[string] =
                 // Offset label by data segment position and length of the data segment
-                m_dataSegment.length() + DATA_START;
+                m_dataSegment.length() + static_cast<int>(m_dataZeroFill) + DATA_START;
         } else {
-            // The label is in the text segment. Label is defined without an offset
-            m_labelPosMap[string] = pos * 4;
+            // The label is in the text segment. Label is defined without an offset; each preceding compressed
+            // instruction is two bytes shorter than its row
+            m_labelPosMap[string] = pos * 4 - 2 * m_compressedInstructions;
         }
         if (fields.isEmpty()) {
             return;
@@ -710,7 +822,8 @@ void Assembler::unpackOp(const QStringList& _fields, int& pos) {
     }
 
     // Unpack operations
-    if (pseudoOps.contains(fields[0])) {
+    const unsigned groups = mnemonicGroups(fields[0]);
+    if (groups & PseudoOp) {
         // A pseudo-operation is detected - unpack using unpackPseudoOp
         unpackPseudoOp(fields, pos);
     } else {
@@ -718,13 +831,16 @@ void Assembler::unpackOp(const QStringList& _fields, int& pos) {
             // Assembler directive detected - handle directive (ie. setting data segment) POS is NOT incremented
             assembleAssemblerDirective(fields);
             return;
-        } else if (opsWithOffsets.contains(fields[0])) {
+        } else if (groups & OpWithOffset) {
             m_lineLabelUsageMap[pos] =
                 fields.last();  // All offset using instructions have their offset as the last field value
         }
-        // Add instruction to map and increment line counter by 1
-        m_instructionsMap[pos] = fields;
+        // Add instruction and increment line counter by 1
+        instruction(pos) = fields;
         pos++;
+        if (groups & CompressedInstruction) {
+            m_compressedInstructions++;
+        }
     }
 }
 
@@ -739,12 +855,16 @@ inline QByteArray Assembler::uintToByteArr(uint32_t in) {
 
 void Assembler::restart() {
     m_error = false;
+    m_cancelled = false;
     m_hasData = false;
-    m_instructionsMap.clear();
+    m_instructions.clear();
+    m_compressedInstructions = 0;
+    m_textOffsets.clear();
     m_lineLabelUsageMap.clear();
     m_labelPosMap.clear();
     m_textSegment.clear();
     m_dataSegment.clear();
+    m_dataZeroFill = 0;
 }
 
 namespace {
@@ -758,55 +878,125 @@ inline QStringList splitColon(const QString& string) {
 }
 }  // namespace
 
+QStringList& Assembler::instruction(int pos) {
+    if (m_instructions.size() <= static_cast<size_t>(pos)) {
+        m_instructions.resize(pos + 1);
+    }
+    return m_instructions[pos];
+}
+
+QStringList Assembler::lexLine(const QString& text) {
+    // Split input into fields
+    QStringList fields = tokenize(text);
+    if (fields.isEmpty()) {
+        return fields;
+    }
+
+    // Split label fields, and keep separator ':'
+    if (fields[0].contains(':')) {
+        auto firstFields = splitColon(fields.takeAt(0));
+        fields = firstFields + fields;
+    }
+
+    // Remove comments from syntax evaluation
+    for (int i = 0; i < fields.length(); i++) {
+        if (fields[i].startsWith('#')) {
+            fields.erase(fields.begin() + i, fields.end());
+            break;
+        }
+    }
+    return fields;
+}
+
+QStringList Assembler::documentLines(const QTextDocument& doc) {
+    QStringList lines;
+    lines.reserve(doc.blockCount());
+    for (QTextBlock block = doc.begin(); block != doc.end(); block = block.next()) {
+        lines << block.text();
+    }
+    return lines;
+}
+
+QStringList Assembler::sourceLines(std::string_view source) {
+    QStringList lines;
+    lines.reserve(static_cast<int>(std::count(source.begin(), source.end(), '\n')) + 1);
+    size_t begin = 0;
+    while (true) {
+        const size_t end = source.find('\n', begin);
+        std::string_view line = source.substr(begin, end == std::string_view::npos ? end : end - begin);
+        // Line breaks of documents include carriage returns
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        lines << QString::fromUtf8(line.data(), static_cast<int>(line.size()));
+        if (end == std::string_view::npos) {
+            return lines;
+        }
+        begin = end + 1;
+    }
+}
+
+const QByteArray& Assembler::assemble(std::string_view source, const std::atomic<bool>* cancel) {
+    return assemble(sourceLines(source), cancel);
+}
+
 const QByteArray& Assembler::assemble(const QTextDocument& doc) {
+    return assemble(documentLines(doc));
+}
+
+const QByteArray& Assembler::assemble(const QStringList& lines, const std::atomic<bool>* cancel) {
     // Called by codeEditor when syntax has been accepted, and the document should be assembled into binary
     // Because of the previously accepted syntax, !no! error handling will be done, to ensure a fast execution
     int line = 0;
     restart();
 
-    QStringList fields;
-    for (QTextBlock block = doc.begin(); block != doc.end(); block = block.next()) {
-        if (!block.text().isEmpty()) {
-            // Split input into fields
-            fields = block.text().split(splitter);
-            fields.removeAll("");
-            fields = splitQuotes(fields);
-            if (!fields.isEmpty()) {
-                // Split label fields, and keep separator ':'
-                if (fields[0].contains(':')) {
-                    auto firstFields = splitColon(fields.takeAt(0));
-                    fields = firstFields + fields;
-                }
-
-                // Remove comments from syntax evaluation
-                const static auto commentRegEx = QRegularExpression("[#](.*)");
-                int commentIndex = fields.indexOf(commentRegEx);
-                if (commentIndex != -1) {
-                    int index = fields.length();
-                    while (index >= commentIndex) {
-                        fields.removeAt(index);
-                        index--;
-                    }
-                }
-
-                /* UnpackOp will:
-                 *  -unpack & convert pseudo operations into its required number of operations
-                 * - Record label positioning
-                 * - Reord position of instructions which use labels
-                 * - add instructions to m_instructionsMap
-                 */
-                if (fields.length() > 0) {
-                    unpackOp(fields, line);
-                }
-            }
+    // Lines are only lexed if their text was not present in the previously assembled document. The cache is rebuilt
+    // from the lines of this document, such that lines which were removed do not linger.
+    QHash<QString, QStringList> lexCache;
+    lexCache.reserve(lines.size());
+    for (const QString& text : lines) {
+        if (cancel && *cancel) {
+            // The previous cache is kept, given that it still reflects the last fully assembled document
+            m_error = true;
+            m_cancelled = true;
+            return m_textSegment;
+        }
+        if (text.isEmpty()) {
+            continue;
+        }
+        auto cached = lexCache.constFind(text);
+        if (cached == lexCache.constEnd()) {
+            auto previous = m_lexCache.constFind(text);
+            cached = lexCache.insert(text, previous != m_lexCache.constEnd() ? previous.value() : lexLine(text));
+        }
+
+        /* UnpackOp will:
+         *  -unpack & convert pseudo operations into its required number of operations
+         * - Record label positioning
+         * - Reord position of instructions which use labels
+         * - add instructions to m_instructions
+         */
+        if (!cached.value().isEmpty()) {
+            unpackOp(cached.value(), line);
         }
     }
+    m_lexCache.swap(lexCache);
+
+    // Compressed instructions are two bytes, such that the offsets of the instructions are not implied by their rows
+    m_textOffsets.assign(m_instructions.size() + 1, 0);
+    for (size_t i = 0; i < m_instructions.size(); i++) {
+        const bool compressed =
+            !m_instructions[i].isEmpty() && (mnemonicGroups(m_instructions[i][0]) & CompressedInstruction);
+        m_textOffsets[i + 1] = m_textOffsets[i] + (compressed ? 2 : 4);
+    }
 
     // Assemble instruction(s)
-    // Since the keys (line numbers) are sorted, we iterate straight over the map when inserting into the output
-    // bytearray
-    for (auto item : m_instructionsMap.toStdMap()) {
-        assembleInstruction(item.second, item.first);
+    // Instructions are indexed by their line number, so they are inserted into the output bytearray in order
+    m_textSegment.reserve(m_textOffsets.back());
+    for (size_t i = 0; i < m_instructions.size(); i++) {
+        if (!m_instructions[i].isEmpty()) {
+            assembleInstruction(m_instructions[i], static_cast<int>(i));
+        }
     }
 
     return m_textSegment;
@@ -815,11 +1005,18 @@ const QByteArray& Assembler::assemble(const QTextDocument& doc) {
 const Program Assembler::getProgram() {
     Program p;
     p.sections.push_back({TEXT_SECTION_NAME, 0, m_textSegment});
-    p.sections.push_back({".data", DATA_START, m_dataSegment});
+    p.sections.push_back({".data", DATA_START, m_dataSegment, m_dataZeroFill});
 
-    for (const auto& kv : m_labelPosMap.toStdMap()) {
-        p.symbols[kv.second] = kv.first;
+    for (auto it = m_labelPosMap.constBegin(); it != m_labelPosMap.constEnd(); it++) {
+        // Of several labels at the same address, the greatest name is kept regardless of the order of the hash
+        auto symbol = p.symbols.find(it.value());
+        if (symbol == p.symbols.end()) {
+            p.symbols[it.value()] = it.key();
+        } else if (symbol->second < it.key()) {
+            symbol->second = it.key();
+        }
     }
+    p.buildIndex();
 
     return p;
 }
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <QByteArray>
+#include <QHash>
 #include <QTextDocument>
 
+#include <atomic>
+#include <string_view>
+#include <vector>
+
 #include "program.h"
 
 namespace Ripes {
@@ -11,34 +16,68 @@ class Assembler {
 public:
     Assembler();
     const QByteArray& assemble(const QTextDocument& doc);
+    /**
+     * @brief assemble
+     * Assembles a snapshot of the lines of a document. This does not touch the document, and may thus be run outside of
+     * the GUI thread. Assembly is abandoned, with an error, if @p cancel is set while assembling.
+     */
+    const QByteArray& assemble(const QStringList& lines, const std::atomic<bool>* cancel = nullptr);
     bool hasError() { return m_error; }
+    /**
+     * @brief assemble
+     * Assembles the UTF-8 assembly source text @p source, such as a memory mapped file, without constructing a
+     * document. Produces the same program as assembling a document of the same text.
+     */
+    const QByteArray& assemble(std::string_view source, const std::atomic<bool>* cancel = nullptr);
+    /// @returns the text of each block of @p doc
+    static QStringList documentLines(const QTextDocument& doc);
+    /// @returns the lines of the UTF-8 source text @p source, split as per the blocks of a document of the text
+    static QStringList sourceLines(std::string_view source);
+    bool wasCancelled() { return m_cancelled; }
     bool hasData() { return m_hasData; }
     const QByteArray& getTextSegment() { return m_textSegment; }
     const QByteArray& getDataSegment() { return m_dataSegment; }
-    void clear() { m_textSegment.clear(); }
+    void clear() {
+        m_textSegment.clear();
+        m_lexCache.clear();
+    }
 
     const Program getProgram();
 
 private:
     uint32_t getRegisterNumber(const QString& reg);
+    uint32_t getCSRNumber(const QString& csr, bool& canConvert);
     void unpackPseudoOp(const QStringList& fields, int& pos);
     void unpackOp(const QStringList& fields, int& pos);
     void assembleAssemblerDirective(const QStringList& fields);
     void assembleWords(const QStringList& fields, QByteArray& byteArr, size_t size);
-    void assembleZeroArray(QByteArray& byteArray, size_t size);
+    void assembleZeroArray(size_t size);
     void restart();
+    /// @returns the fields of a line of assembly, with labels split from the following operation and comments removed
+    QStringList lexLine(const QString& text);
     int getImmediate(QString string, bool& canConvert);
     QByteArray uintToByteArr(uint32_t);
 
-    QMap<QString, int> m_labelPosMap;  // Map storing unpacked label
+    QHash<QString, int> m_labelPosMap;  // Symbol table of unpacked labels
+    QHash<QString, QStringList>
+        m_lexCache;  // Fields of each line of the previously assembled document, keyed by the line's text
 
     QMap<int, QString>
         m_lineLabelUsageMap;  // Lines that need to be updated with label values (offsets) after unpacking is finished
-    QMap<int, QStringList> m_instructionsMap;  // Map containing unpacked and offset-modified instruction
+    std::vector<QStringList> m_instructions;  // Unpacked and offset-modified instructions, indexed by line number
+    /// @returns the unpacked instruction at line @param pos, extending the instructions as needed
+    QStringList& instruction(int pos);
+    /// Number of compressed instructions unpacked so far, each taking up two bytes rather than four
+    int m_compressedInstructions = 0;
+    /// Byte offset of each unpacked instruction within the text segment, indexed by line number
+    std::vector<int> m_textOffsets;
+    int textOffset(int row) const { return m_textOffsets[row]; }
 
     QByteArray m_textSegment;
     QByteArray m_dataSegment;
+    size_t m_dataZeroFill = 0;  // Zero bytes allocated at the end of the data segment, which are not yet materialized
     bool m_error = false;
+    bool m_cancelled = false;
     bool m_hasData = false;
     bool m_inDataSegment = false;  // Set when stating .data directive. Following instructions will be added to the data
                                    // segment of the program
@@ -52,5 +91,7 @@ private:
     QByteArray assembleBranchInstruction(const QStringList& fields, int row);
     QByteArray assembleAuipcInstruction(const QStringList& fields, int row);
     QByteArray assembleJalrInstruction(const QStringList& fields, int row);
+    QByteArray assembleCSRInstruction(const QStringList& fields, int row);
+    QByteArray assembleCompressedInstruction(const QStringList& fields, int row);
 };
 }  // namespace Ripes
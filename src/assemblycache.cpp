@@ -0,0 +1,56 @@
+#include "assemblycache.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QMutex>
+
+namespace Ripes {
+
+namespace {
+// Bump if a change to the assembler alters the programs assembled from identical source text
+constexpr char s_assemblerVersion = 2;
+// Total size of the cached programs, in KiB
+constexpr int s_maxCost = 16 * 1024;
+
+QMutex s_mutex;
+QCache<QByteArray, Program> s_cache(s_maxCost);
+
+int cost(const Program& program) {
+    int bytes = 0;
+    for (const auto& section : program.sections) {
+        bytes += section.data.size();
+    }
+    return bytes / 1024 + 1;
+}
+}  // namespace
+
+namespace AssemblyCache {
+
+QByteArray key(const QStringList& lines) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&s_assemblerVersion, 1);
+    for (const QString& line : lines) {
+        hash.addData(reinterpret_cast<const char*>(line.constData()), line.size() * static_cast<int>(sizeof(QChar)));
+        hash.addData("\n", 1);
+    }
+    return hash.result();
+}
+
+bool find(const QByteArray& key, Program& program) {
+    QMutexLocker lock(&s_mutex);
+    const Program* cached = s_cache.object(key);
+    if (cached == nullptr) {
+        return false;
+    }
+    program = *cached;
+    return true;
+}
+
+void insert(const QByteArray& key, const Program& program) {
+    QMutexLocker lock(&s_mutex);
+    s_cache.insert(key, new Program(program), cost(program));
+}
+
+}  // namespace AssemblyCache
+
+}  // namespace Ripes
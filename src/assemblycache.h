@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QByteArray>
+#include <QStringList>
+
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * Process-wide cache of assembled programs, keyed by a hash of their source text. Reassembling identical source text,
+ * such as when reopening an example or reloading a file, is thereby reduced to a lookup. The cache is bounded by the
+ * total size of the cached sections, evicting the least recently used programs first, and may be accessed from any
+ * thread.
+ */
+namespace AssemblyCache {
+
+/// @returns the cache key of the source text consisting of @p lines
+QByteArray key(const QStringList& lines);
+
+/**
+ * @brief find
+ * Copies the program cached for @p key into @p program.
+ * @returns false if no program is cached for @p key.
+ */
+bool find(const QByteArray& key, Program& program);
+
+/// Caches @p program as the result of assembling the source text of @p key
+void insert(const QByteArray& key, const Program& program);
+
+}  // namespace AssemblyCache
+
+}  // namespace Ripes
@@ -0,0 +1,547 @@
+#include "batchrunner.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QThreadStorage>
+#include <QtConcurrent/QtConcurrent>
+
+#include <limits>
+#include <tuple>
+
+#include "defines.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+namespace {
+
+const std::vector<ProcessorID> s_allProcessors = {ProcessorID::RVSS,        ProcessorID::RV5S,
+                                                  ProcessorID::RV5S_BTFN,   ProcessorID::RV5S_BIMODAL,
+                                                  ProcessorID::RV5S_GSHARE, ProcessorID::RV5S_BTB,
+                                                  ProcessorID::RV5S_NO_HZ,  ProcessorID::RV5S_NO_FW_HZ,
+                                                  ProcessorID::RV5S_DUAL};
+
+/**
+ * @brief toUnsigned
+ * Accepts both JSON numbers and strings, such that addresses may be given in hexadecimal notation (ie. "0x1000").
+ */
+bool toUnsigned(const QJsonValue& value, unsigned long long& result) {
+    if (value.isDouble()) {
+        const double v = value.toDouble();
+        if (v < 0) {
+            return false;
+        }
+        result = static_cast<unsigned long long>(v);
+        return true;
+    }
+    if (value.isString()) {
+        bool ok;
+        result = value.toString().toULongLong(&ok, 0);
+        return ok;
+    }
+    return false;
+}
+
+/**
+ * @brief toWord
+ * As toUnsigned, additionally accepting negative numbers, which are stored in two's complement.
+ */
+bool toWord(const QJsonValue& value, uint32_t& result) {
+    if (value.isDouble() && value.toDouble() < 0) {
+        const double v = value.toDouble();
+        if (v < std::numeric_limits<int32_t>::min()) {
+            return false;
+        }
+        result = static_cast<uint32_t>(static_cast<int32_t>(v));
+        return true;
+    }
+    unsigned long long v;
+    if (!toUnsigned(value, v) || v > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    result = static_cast<uint32_t>(v);
+    return true;
+}
+
+/// Accepts register names as xN and as ABI names. x0 is rejected, given that it is hardwired to zero.
+bool parseRegister(const QString& name, unsigned& reg) {
+    bool ok = false;
+    if (name.startsWith('x')) {
+        reg = name.mid(1).toUInt(&ok);
+        ok &= reg < 32;
+    } else if (ABInames.contains(name)) {
+        reg = ABInames.value(name);
+        ok = true;
+    }
+    return ok && reg != 0;
+}
+
+/**
+ * @brief parseDataInput
+ * Data inputs are given as either a string, which is stored as UTF-8 followed by a null terminator, or an array of
+ * words, which are stored in little endian.
+ */
+bool parseDataInput(const QJsonValue& value, QByteArray& bytes) {
+    if (value.isString()) {
+        bytes = value.toString().toUtf8();
+        bytes.append('\0');
+        return true;
+    }
+    if (!value.isArray() || value.toArray().isEmpty()) {
+        return false;
+    }
+    bytes.clear();
+    for (const auto& element : value.toArray()) {
+        uint32_t word;
+        if (!toWord(element, word)) {
+            return false;
+        }
+        for (unsigned i = 0; i < sizeof(word); i++) {
+            bytes.append(static_cast<char>(word >> (i * 8)));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief qualifiesForLockstep
+ * Jobs may only be simulated in lockstep if they are functional single-hart simulations which produce no more than the
+ * results of LockstepSystem.
+ */
+bool qualifiesForLockstep(const HeadlessOptions& job) {
+    return job.functional && job.harts == 1 && !job.replayTrace && job.cacheSweep.isEmpty() && !job.dataCache &&
+           !job.instrCache && !job.instrTLB && !job.dataTLB && job.sampleInterval == 0 && job.tracePath.isEmpty() &&
+           job.pipelineTracePath.isEmpty() && job.statisticsPath.isEmpty() && job.flameGraphPath.isEmpty() &&
+           job.hostProfilePath.isEmpty() && job.restoreSnapshotPath.isEmpty() && job.saveSnapshotPath.isEmpty() &&
+           job.memoryDumpPath.isEmpty();
+}
+
+/// Jobs of equal keys execute the same program under the same limits, and only differ in their inputs.
+using LockstepKey = std::tuple<QString, int, unsigned long, unsigned long, int, unsigned long long, unsigned long long,
+                               const Program*>;
+LockstepKey lockstepKey(const HeadlessOptions& job) {
+    return {job.filepath,
+            static_cast<int>(job.type),
+            job.binaryEntryPoint,
+            job.binaryLoadAt,
+            static_cast<int>(job.processor),
+            job.maxCycles,
+            job.timeLimitMs,
+            job.program.get()};
+}
+
+bool parseJob(const QJsonObject& obj, const QDir& dir, const HeadlessOptions& defaults,
+              std::vector<HeadlessOptions>& jobs, QString& error) {
+    HeadlessOptions options = defaults;
+
+    if (!obj.value("file").isString()) {
+        error = "Job does not specify a file";
+        return false;
+    }
+    options.filepath = QDir::cleanPath(dir.absoluteFilePath(obj.value("file").toString()));
+
+    if (!parseFileType(obj.value("type").toString(), options.filepath, options.type)) {
+        error = "Unknown file type '" + obj.value("type").toString() + "'";
+        return false;
+    }
+    if (!parseJobOptions(obj, dir, options, error)) {
+        return false;
+    }
+
+    std::vector<ProcessorID> processors;
+    const QJsonValue proc = obj.value("proc");
+    if (proc.isUndefined()) {
+        processors.push_back(defaults.processor);
+    } else if (proc.toString().toLower() == "all") {
+        processors = s_allProcessors;
+    } else {
+        const QJsonArray names = proc.isArray() ? proc.toArray() : QJsonArray({proc});
+        for (const auto& name : names) {
+            ProcessorID id;
+            if (!parseProcessorID(name.toString(), id)) {
+                error = "Unknown processor '" + name.toString() + "'";
+                return false;
+            }
+            processors.push_back(id);
+        }
+    }
+
+    if (!options.pipelineTracePath.isEmpty() && processors.size() > 1) {
+        error = "A job recording a pipeline trace must specify a single processor";
+        return false;
+    }
+
+    for (const auto& id : processors) {
+        options.processor = id;
+        jobs.push_back(options);
+    }
+    return true;
+}
+
+QString cacheConfigString(const HeadlessOptions& options) {
+    return QString("%1,%2,%3").arg(options.cacheLines).arg(options.cacheWays).arg(options.cacheBlocks);
+}
+
+QString cacheConfigString(const HeadlessOptions::LowerCacheLevel& level) {
+    return QString("%1,%2,%3").arg(level.lines).arg(level.ways).arg(level.blocks);
+}
+
+QString status(const HeadlessResult& result) {
+    if (!result.error.isEmpty()) {
+        return "error";
+    } else if (result.finished) {
+        return "finished";
+    } else if (result.timeLimitReached) {
+        return "time-limit";
+    } else if (result.cycleLimitReached) {
+        return "cycle-limit";
+    }
+    return "stopped";
+}
+
+double cpi(const HeadlessResult& result) {
+    return result.instructionsRetired != 0
+               ? static_cast<double>(result.cycles) / static_cast<double>(result.instructionsRetired)
+               : 0;
+}
+
+QJsonObject toJson(const CacheStatistics& stats) {
+    QJsonObject obj;
+    obj["hits"] = static_cast<qint64>(stats.hits);
+    obj["misses"] = static_cast<qint64>(stats.misses);
+    obj["writebacks"] = static_cast<qint64>(stats.writebacks);
+    obj["hit-rate"] = stats.hitRate;
+    obj["amat"] = stats.averageAccessTime;
+    return obj;
+}
+
+QByteArray jsonReport(const std::vector<HeadlessOptions>& jobs, const std::vector<HeadlessResult>& results) {
+    QJsonArray report;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        report.append(jobReport(jobs.at(i), results.at(i)));
+    }
+    return QJsonDocument(report).toJson();
+}
+
+QString csvEscape(const QString& field) {
+    if (!field.contains(',') && !field.contains('"') && !field.contains('\n')) {
+        return field;
+    }
+    return '"' + QString(field).replace('"', "\"\"") + '"';
+}
+
+QByteArray csvReport(const std::vector<HeadlessOptions>& jobs, const std::vector<HeadlessResult>& results) {
+    QString report;
+    QTextStream out(&report);
+    out << "file,proc,functional,cache-config,status,cycles,instructions-retired,cpi,wall-time-ms,"
+           "dcache-hits,dcache-misses,dcache-writebacks,dcache-hit-rate,"
+           "icache-hits,icache-misses,icache-writebacks,icache-hit-rate,"
+           "l2cache-hits,l2cache-misses,l2cache-writebacks,l2cache-hit-rate,"
+           "l3cache-hits,l3cache-misses,l3cache-writebacks,l3cache-hit-rate\n";
+    const auto cacheColumns = [&out](const CacheStatistics& stats) {
+        if (stats.enabled) {
+            out << "," << stats.hits << "," << stats.misses << "," << stats.writebacks << "," << stats.hitRate;
+        } else {
+            out << ",,,,";
+        }
+    };
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const auto& job = jobs.at(i);
+        const auto& result = results.at(i);
+        out << csvEscape(job.filepath) << "," << processorName(job.processor) << "," << (job.functional ? 1 : 0)
+            << "," << csvEscape(cacheConfigString(job)) << "," << status(result) << "," << result.cycles << ","
+            << result.instructionsRetired << "," << cpi(result) << "," << result.wallTimeMs;
+        cacheColumns(result.dataCache);
+        cacheColumns(result.instrCache);
+        cacheColumns(result.l2Cache);
+        cacheColumns(result.l3Cache);
+        out << "\n";
+    }
+    out.flush();
+    return report.toUtf8();
+}
+
+}  // namespace
+
+bool parseJobOptions(const QJsonObject& obj, const QDir& dir, HeadlessOptions& options, QString& error) {
+    unsigned long long value;
+    const std::pair<const char*, unsigned long long*> numericKeys[] = {{"max-cycles", &options.maxCycles},
+                                                                        {"time-limit", &options.timeLimitMs},
+                                                                        {"sample-interval", &options.sampleInterval},
+                                                                        {"sample-window", &options.sampleWindow}};
+    for (const auto& key : numericKeys) {
+        if (obj.contains(key.first)) {
+            if (!toUnsigned(obj.value(key.first), value)) {
+                error = QString("Invalid value for '%1'").arg(key.first);
+                return false;
+            }
+            *key.second = value;
+        }
+    }
+    const std::pair<const char*, unsigned long*> addressKeys[] = {{"entry", &options.binaryEntryPoint},
+                                                                   {"load-at", &options.binaryLoadAt}};
+    for (const auto& key : addressKeys) {
+        if (obj.contains(key.first)) {
+            if (!toUnsigned(obj.value(key.first), value)) {
+                error = QString("Invalid value for '%1'").arg(key.first);
+                return false;
+            }
+            *key.second = static_cast<unsigned long>(value);
+        }
+    }
+
+    if (obj.contains("io-dir")) {
+        options.ioDirectory = QDir::cleanPath(dir.absoluteFilePath(obj.value("io-dir").toString()));
+    }
+    if (obj.contains("pipeline-trace")) {
+        options.pipelineTracePath = QDir::cleanPath(dir.absoluteFilePath(obj.value("pipeline-trace").toString()));
+    }
+    options.functional = obj.value("functional").toBool(options.functional);
+    options.dataCache = obj.value("dcache").toBool(options.dataCache);
+    options.instrCache = obj.value("icache").toBool(options.instrCache);
+    if (obj.contains("cache-config") && !parseCacheConfig(obj.value("cache-config").toString(), options)) {
+        error = "Cache configuration must be given as <lines>,<ways>,<blocks>";
+        return false;
+    }
+    if ((obj.contains("l2-config") && !parseCacheConfig(obj.value("l2-config").toString(), options.l2Cache)) ||
+        (obj.contains("l3-config") && !parseCacheConfig(obj.value("l3-config").toString(), options.l3Cache))) {
+        error = "Lower level cache configurations must be given as <lines>,<ways>,<blocks>";
+        return false;
+    }
+    if (obj.contains("cache-latencies") && !parseCacheLatencies(obj.value("cache-latencies").toString(), options)) {
+        error = "Cache latencies must be given as <l1>,<l2>,<l3>,<memory>";
+        return false;
+    }
+    if (obj.contains("cache-warmup") && !parseCacheWarmup(obj.value("cache-warmup").toString(), options)) {
+        error = "Cache warm-up must be given as none, cycles:<n>, accesses:<n> or pc:<address>";
+        return false;
+    }
+    if (obj.contains("cache-window") && !parseCacheWindow(obj.value("cache-window").toString(), options)) {
+        error = "Cache statistics window must be given as <first>,<last>";
+        return false;
+    }
+    if (obj.contains("unit-latencies") && !parseUnitLatencies(obj.value("unit-latencies").toString(), options)) {
+        error = "Functional unit latencies must be given as <mul>,<div>";
+        return false;
+    }
+    if (obj.contains("registers")) {
+        if (!obj.value("registers").isObject()) {
+            error = "Register inputs must be given as an object of register names and values";
+            return false;
+        }
+        const auto registers = obj.value("registers").toObject();
+        for (auto it = registers.begin(); it != registers.end(); ++it) {
+            unsigned reg;
+            uint32_t regValue;
+            if (!parseRegister(it.key(), reg)) {
+                error = "Invalid register '" + it.key() + "'";
+                return false;
+            }
+            if (!toWord(it.value(), regValue)) {
+                error = "Invalid value for register '" + it.key() + "'";
+                return false;
+            }
+            options.registers[reg] = regValue;
+        }
+    }
+    if (obj.contains("data")) {
+        if (!obj.value("data").isObject()) {
+            error = "Data inputs must be given as an object of addresses and data";
+            return false;
+        }
+        const auto data = obj.value("data").toObject();
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            bool ok;
+            const unsigned long long address = it.key().toULongLong(&ok, 0);
+            if (!ok || address > std::numeric_limits<uint32_t>::max()) {
+                error = "Invalid data input address '" + it.key() + "'";
+                return false;
+            }
+            if (!parseDataInput(it.value(), options.data[static_cast<uint32_t>(address)])) {
+                error = "Invalid data input at '" + it.key() + "'";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QJsonObject jobReport(const HeadlessOptions& job, const HeadlessResult& result) {
+    QJsonObject obj;
+    obj["file"] = job.filepath;
+    obj["proc"] = processorName(job.processor);
+    obj["functional"] = job.functional;
+    obj["status"] = status(result);
+    if (!result.error.isEmpty()) {
+        obj["error"] = result.error;
+    }
+    obj["cycles"] = result.cycles;
+    obj["instructions-retired"] = result.instructionsRetired;
+    obj["cpi"] = cpi(result);
+    obj["wall-time-ms"] = result.wallTimeMs;
+    if (result.lockstepLanes != 0) {
+        obj["lockstep-lanes"] = static_cast<qint64>(result.lockstepLanes);
+    }
+    if (result.sampled) {
+        obj["windows"] = static_cast<qint64>(result.windows);
+        obj["detailed-cycles"] = result.detailedCycles;
+        obj["detailed-instructions"] = result.detailedInstructions;
+    }
+    if (result.branchPrediction) {
+        QJsonObject bp;
+        bp["predictions"] = result.branchPrediction->predictions;
+        bp["mispredictions"] = result.branchPrediction->mispredictions;
+        bp["flush-cycles-saved"] = result.branchPrediction->flushCyclesSaved;
+        obj["branch-prediction"] = bp;
+    }
+    if (result.functionalUnits) {
+        QJsonObject units;
+        units["dependency-stall-cycles"] = result.functionalUnits->dependencyStallCycles;
+        units["structural-stall-cycles"] = result.functionalUnits->structuralStallCycles;
+        obj["functional-units"] = units;
+    }
+    if (result.hazards) {
+        QJsonObject hazards;
+        hazards["load-use-stall-cycles"] = result.hazards->loadUseStallCycles;
+        hazards["ecall-stall-cycles"] = result.hazards->ecallStallCycles;
+        hazards["control-flow-flushes"] = result.hazards->controlFlowFlushes;
+        hazards["forwarded-operands"] = result.hazards->forwardedOperands;
+        hazards["empty-fetch-cycles"] = result.hazards->emptyFetchCycles;
+        obj["hazards"] = hazards;
+    }
+    if (result.dataCache.enabled || result.instrCache.enabled) {
+        obj["cache-config"] = cacheConfigString(job);
+    }
+    if (result.dataCache.enabled) {
+        obj["dcache"] = toJson(result.dataCache);
+    }
+    if (result.instrCache.enabled) {
+        obj["icache"] = toJson(result.instrCache);
+    }
+    if (result.l2Cache.enabled) {
+        obj["l2-config"] = cacheConfigString(job.l2Cache);
+        obj["l2cache"] = toJson(result.l2Cache);
+    }
+    if (result.l3Cache.enabled) {
+        obj["l3-config"] = cacheConfigString(job.l3Cache);
+        obj["l3cache"] = toJson(result.l3Cache);
+    }
+    obj["output"] = result.output;
+    return obj;
+}
+
+bool parseBatchJobs(const QString& path, const HeadlessOptions& defaults, std::vector<HeadlessOptions>& jobs,
+                    QString& error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "Could not open job file " + path;
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const auto doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = "Could not parse job file: " + parseError.errorString();
+        return false;
+    }
+    if (!doc.isArray()) {
+        error = "Job file must contain an array of jobs";
+        return false;
+    }
+
+    const QDir dir = QFileInfo(path).absoluteDir();
+    const auto array = doc.array();
+    for (int i = 0; i < array.size(); i++) {
+        if (!array.at(i).isObject()) {
+            error = QString("Job %1 is not an object").arg(i);
+            return false;
+        }
+        if (!parseJob(array.at(i).toObject(), dir, defaults, jobs, error)) {
+            error = QString("Job %1: %2").arg(i).arg(error);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<HeadlessResult> runBatch(const std::vector<HeadlessOptions>& jobs, int threads, unsigned lockstepLanes) {
+    std::vector<HeadlessResult> results(jobs.size());
+
+    // Qualifying jobs are grouped by program and limits, and the groups are split into chunks of lockstepLanes jobs
+    std::vector<std::vector<size_t>> chunks;
+    std::map<LockstepKey, size_t> openChunks;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (lockstepLanes < 2 || !qualifiesForLockstep(jobs.at(i))) {
+            chunks.push_back({i});
+            continue;
+        }
+        const auto key = lockstepKey(jobs.at(i));
+        auto it = openChunks.find(key);
+        if (it == openChunks.end() || chunks.at(it->second).size() >= lockstepLanes) {
+            it = openChunks.insert_or_assign(key, chunks.size()).first;
+            chunks.emplace_back();
+        }
+        chunks.at(it->second).push_back(i);
+    }
+
+    // Each worker keeps a simulation context of its own for the duration of the batch, such that the processors which
+    // it constructs are reset and reused by its later jobs rather than constructed and verified anew for each job. The
+    // contexts are destroyed as the threads of the pool exit, which the storage is declared to outlive.
+    QThreadStorage<ProcessorHandler*> contexts;
+    // A pool of our own is used, given that functional simulations execute their run loop on the global thread pool.
+    // Occupying all of the global pool's threads with jobs waiting on their run loops would otherwise deadlock.
+    QThreadPool pool;
+    pool.setExpiryTimeout(-1);
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+    for (const auto& chunk : chunks) {
+        if (chunk.size() == 1) {
+            const size_t i = chunk.front();
+            QtConcurrent::run(&pool, [&jobs, &results, &contexts, i] {
+                if (!contexts.hasLocalData()) {
+                    contexts.setLocalData(new ProcessorHandler);
+                }
+                results[i] = simulate(*contexts.localData(), jobs.at(i));
+            });
+            continue;
+        }
+        QtConcurrent::run(&pool, [&jobs, &results, &chunk] {
+            std::vector<HeadlessOptions> chunkJobs;
+            for (const size_t i : chunk) {
+                chunkJobs.push_back(jobs.at(i));
+            }
+            const auto chunkResults = simulateLockstep(chunkJobs);
+            for (size_t j = 0; j < chunk.size(); j++) {
+                results[chunk.at(j)] = chunkResults.at(j);
+            }
+        });
+    }
+    pool.waitForDone();
+
+    return results;
+}
+
+bool writeBatchReport(const QString& path, const std::vector<HeadlessOptions>& jobs,
+                      const std::vector<HeadlessResult>& results, QString& error) {
+    if (path.isEmpty()) {
+        QTextStream(stdout) << jsonReport(jobs, results);
+        return true;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = "Could not open report file " + path;
+        return false;
+    }
+    const bool csv = QFileInfo(path).suffix().toLower() == "csv";
+    file.write(csv ? csvReport(jobs, results) : jsonReport(jobs, results));
+    return true;
+}
+
+}  // namespace Ripes
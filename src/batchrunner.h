@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QDir>
+#include <QJsonObject>
+#include <QString>
+
+#include <vector>
+
+#include "headless.h"
+
+namespace Ripes {
+
+/**
+ * @brief parseBatchJobs
+ * Parses the job file at @p path into @p jobs. The job file is a JSON array of job objects, each accepting the keys
+ * "file", "type", "proc", "entry", "load-at", "functional", "max-cycles", "time-limit", "sample-interval",
+ * "sample-window", "io-dir", "pipeline-trace", "dcache", "icache", "cache-config", "l2-config", "l3-config",
+ * "cache-latencies", "cache-warmup", "cache-window" and "unit-latencies", with the same meaning as the corresponding
+ * headless command line options. The inputs of a job are given by "registers", an object of register names (xN or ABI
+ * names) and their initial values, and "data", an object of addresses and data to write over the program; either a
+ * string, stored null terminated, or an array of words. "proc" may be a single processor name, an array of names or
+ * "all", expanding the job into one job per processor; a job with a "pipeline-trace" must name a single processor.
+ * Relative file paths are resolved against the directory of the job file. Keys not present in a job object are taken
+ * from @p defaults.
+ * @returns false and sets @p error if the job file is malformed.
+ */
+bool parseBatchJobs(const QString& path, const HeadlessOptions& defaults, std::vector<HeadlessOptions>& jobs,
+                    QString& error);
+
+/**
+ * @brief parseJobOptions
+ * Parses the keys of the job object @p obj which configure a simulation into @p options; all keys accepted by
+ * parseBatchJobs except "file", "type" and "proc". Relative file paths are resolved against @p dir. Keys not present in
+ * @p obj are left unchanged.
+ * @returns false and sets @p error if a key has a malformed value.
+ */
+bool parseJobOptions(const QJsonObject& obj, const QDir& dir, HeadlessOptions& options, QString& error);
+
+/**
+ * @brief jobReport
+ * @returns the entry of the JSON batch report of the job @p job, which produced @p result.
+ */
+QJsonObject jobReport(const HeadlessOptions& job, const HeadlessResult& result);
+
+/**
+ * @brief runBatch
+ * Simulates each of @p jobs using up to @p threads concurrent simulations (0 = one per core). If @p lockstepLanes is
+ * at least 2, functional jobs which only differ in their inputs are simulated in lockstep, up to @p lockstepLanes jobs
+ * at a time (see simulateLockstep).
+ * @returns the results of the jobs, in the order of @p jobs.
+ */
+std::vector<HeadlessResult> runBatch(const std::vector<HeadlessOptions>& jobs, int threads,
+                                     unsigned lockstepLanes = 0);
+
+/**
+ * @brief writeBatchReport
+ * Writes a report of @p results to @p path. The report is written as CSV if @p path has a .csv extension and as JSON
+ * otherwise. If @p path is empty, a JSON report is written to stdout.
+ * @returns false and sets @p error if the report could not be written.
+ */
+bool writeBatchReport(const QString& path, const std::vector<HeadlessOptions>& jobs,
+                      const std::vector<HeadlessResult>& results, QString& error);
+
+}  // namespace Ripes
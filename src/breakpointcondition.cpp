@@ -0,0 +1,233 @@
+#include "breakpointcondition.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace Ripes {
+
+/**
+ * @brief The BreakpointConditionParser class
+ * Recursive descent parser emitting the bytecode of a BreakpointCondition in postfix order, whilst tracking the depth
+ * of the evaluation stack.
+ */
+class BreakpointConditionParser {
+public:
+    BreakpointConditionParser(const QString& expression, const ISAInfoBase* isa) : m_text(expression), m_isa(isa) {}
+
+    bool parse(std::vector<BreakpointCondition::Instr>& code, unsigned& maxDepth, QString& error) {
+        m_code = &code;
+        if (!parseBinary(0)) {
+            error = m_error;
+            return false;
+        }
+        skipSpace();
+        if (m_pos < m_text.size()) {
+            error = QString("Unexpected '%1' at position %2").arg(m_text.mid(m_pos, 1)).arg(m_pos + 1);
+            return false;
+        }
+        maxDepth = m_maxDepth;
+        return true;
+    }
+
+private:
+    using Op = BreakpointCondition::Op;
+
+    struct BinaryOp {
+        QString token;
+        Op op;
+        int precedence;
+    };
+
+    // Binary operators by descending token length, such that ie. "<=" is matched before "<"
+    const std::vector<BinaryOp>& binaryOps() const {
+        static const std::vector<BinaryOp> ops = {
+            {"||", Op::Or, 1},     {"&&", Op::And, 2},    {"==", Op::Eq, 6},     {"!=", Op::Ne, 6},
+            {"<=", Op::Le, 7},     {">=", Op::Ge, 7},     {"<<", Op::Shl, 8},    {">>", Op::Shr, 8},
+            {"|", Op::BitOr, 3},   {"^", Op::BitXor, 4},  {"&", Op::BitAnd, 5}, {"<", Op::Lt, 7},
+            {">", Op::Gt, 7},      {"+", Op::Add, 9},     {"-", Op::Sub, 9},     {"*", Op::Mul, 10},
+            {"/", Op::Div, 10},    {"%", Op::Rem, 10}};
+        return ops;
+    }
+
+    void skipSpace() {
+        while (m_pos < m_text.size() && m_text.at(m_pos).isSpace()) {
+            m_pos++;
+        }
+    }
+
+    void emitOp(Op op, long long operand = 0) {
+        m_code->push_back({op, operand});
+        // Operands push a value, unary operators leave the depth unchanged and binary operators pop a value
+        if (op == Op::Imm || op == Op::Reg || op == Op::Hits) {
+            m_depth++;
+            m_maxDepth = std::max(m_maxDepth, m_depth);
+        } else if (op != Op::Neg && op != Op::Not && op != Op::BitNot) {
+            m_depth--;
+        }
+    }
+
+    bool fail(const QString& error) {
+        m_error = error;
+        return false;
+    }
+
+    /// Parses binary operations of at least @p minPrecedence through precedence climbing
+    bool parseBinary(int minPrecedence) {
+        if (!parseUnary()) {
+            return false;
+        }
+        while (true) {
+            skipSpace();
+            const BinaryOp* match = nullptr;
+            for (const auto& op : binaryOps()) {
+                if (m_text.midRef(m_pos, op.token.size()) == op.token) {
+                    match = &op;
+                    break;
+                }
+            }
+            if (!match || match->precedence < minPrecedence) {
+                return true;
+            }
+            m_pos += match->token.size();
+            if (!parseBinary(match->precedence + 1)) {
+                return false;
+            }
+            emitOp(match->op);
+        }
+    }
+
+    bool parseUnary() {
+        skipSpace();
+        if (m_pos >= m_text.size()) {
+            return fail("Unexpected end of expression");
+        }
+        const QChar c = m_text.at(m_pos);
+        if (c == '-' || c == '!' || c == '~') {
+            m_pos++;
+            if (!parseUnary()) {
+                return false;
+            }
+            emitOp(c == '-' ? Op::Neg : c == '!' ? Op::Not : Op::BitNot);
+            return true;
+        }
+        return parsePrimary();
+    }
+
+    bool parsePrimary() {
+        const int start = m_pos;
+        const QChar c = m_text.at(m_pos);
+        if (c == '(') {
+            m_pos++;
+            if (!parseBinary(0)) {
+                return false;
+            }
+            skipSpace();
+            if (m_pos >= m_text.size() || m_text.at(m_pos) != ')') {
+                return fail(QString("Expected ')' at position %1").arg(m_pos + 1));
+            }
+            m_pos++;
+            return true;
+        }
+
+        while (m_pos < m_text.size() && (m_text.at(m_pos).isLetterOrNumber() || m_text.at(m_pos) == '_')) {
+            m_pos++;
+        }
+        const QString token = m_text.mid(start, m_pos - start);
+        if (token.isEmpty()) {
+            return fail(QString("Unexpected '%1' at position %2").arg(c).arg(start + 1));
+        }
+
+        if (token.at(0).isDigit()) {
+            bool ok = false;
+            long long value = 0;
+            if (token.startsWith("0x", Qt::CaseInsensitive)) {
+                value = token.mid(2).toLongLong(&ok, 16);
+            } else if (token.startsWith("0b", Qt::CaseInsensitive)) {
+                value = token.mid(2).toLongLong(&ok, 2);
+            } else {
+                value = token.toLongLong(&ok, 10);
+            }
+            if (!ok) {
+                return fail(QString("Invalid number '%1'").arg(token));
+            }
+            emitOp(Op::Imm, value);
+            return true;
+        }
+        if (token == "hits") {
+            emitOp(Op::Hits);
+            return true;
+        }
+        for (unsigned i = 0; i < m_isa->regCnt(); i++) {
+            if (token == m_isa->regName(i) || token == m_isa->regAlias(i)) {
+                emitOp(Op::Reg, i);
+                return true;
+            }
+        }
+        return fail(QString("Unknown register '%1'").arg(token));
+    }
+
+    const QString m_text;
+    const ISAInfoBase* m_isa;
+    int m_pos = 0;
+    QString m_error;
+    std::vector<BreakpointCondition::Instr>* m_code = nullptr;
+    unsigned m_depth = 0;
+    unsigned m_maxDepth = 0;
+};
+
+bool BreakpointCondition::compile(const QString& expression, const ISAInfoBase* isa, QString& error) {
+    std::vector<Instr> code;
+    unsigned maxDepth = 0;
+    if (!BreakpointConditionParser(expression, isa).parse(code, maxDepth, error)) {
+        return false;
+    }
+    m_expression = expression.trimmed();
+    m_code = std::move(code);
+    m_stack.assign(maxDepth, 0);
+    return true;
+}
+
+long long BreakpointCondition::binary(Op op, long long lhs, long long rhs) {
+    switch (op) {
+        case Op::Mul:
+            return static_cast<long long>(static_cast<unsigned long long>(lhs) * static_cast<unsigned long long>(rhs));
+        case Op::Div:
+            return rhs == 0 || (rhs == -1 && lhs == LLONG_MIN) ? 0 : lhs / rhs;
+        case Op::Rem:
+            return rhs == 0 || rhs == -1 ? 0 : lhs % rhs;
+        case Op::Add:
+            return static_cast<long long>(static_cast<unsigned long long>(lhs) + static_cast<unsigned long long>(rhs));
+        case Op::Sub:
+            return static_cast<long long>(static_cast<unsigned long long>(lhs) - static_cast<unsigned long long>(rhs));
+        case Op::Shl:
+            return static_cast<long long>(static_cast<unsigned long long>(lhs) << (rhs & 63));
+        case Op::Shr:
+            return lhs >> (rhs & 63);
+        case Op::Lt:
+            return lhs < rhs;
+        case Op::Le:
+            return lhs <= rhs;
+        case Op::Gt:
+            return lhs > rhs;
+        case Op::Ge:
+            return lhs >= rhs;
+        case Op::Eq:
+            return lhs == rhs;
+        case Op::Ne:
+            return lhs != rhs;
+        case Op::BitAnd:
+            return lhs & rhs;
+        case Op::BitXor:
+            return lhs ^ rhs;
+        case Op::BitOr:
+            return lhs | rhs;
+        case Op::And:
+            return lhs && rhs;
+        case Op::Or:
+            return lhs || rhs;
+        default:
+            return 0;
+    }
+}
+
+}  // namespace Ripes
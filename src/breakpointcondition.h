@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+#include "isainfo.h"
+
+namespace Ripes {
+
+/**
+ * @brief The BreakpointCondition class
+ * A condition of a breakpoint, compiled once from a C-like expression into a small stack bytecode, such that
+ * evaluating it upon the breakpoint address being fetched requires no parsing.
+ *
+ * Expressions consist of integer literals (decimal, or hexadecimal/binary prefixed by 0x/0b), register names and
+ * aliases of the ISA (ie. x5 or a0), and the hit count 'hits'; the number of times which the breakpoint address has
+ * been reached, including the current. These are combined through parentheses and the C operators
+ *   ! ~ - (unary)   * / %   + -   << >>   < <= > >=   == !=   &   ^   |   &&   ||
+ * with C precedence. Arithmetic is 64-bit signed, registers are read as signed values, and division by zero yields
+ * zero. The breakpoint triggers if the expression evaluates to non-zero.
+ */
+class BreakpointCondition {
+public:
+    /**
+     * @brief compile
+     * Compiles @p expression with register names of @p isa.
+     * @returns false, with a description of the error in @p error, if the expression is invalid.
+     */
+    bool compile(const QString& expression, const ISAInfoBase* isa, QString& error);
+
+    const QString& expression() const { return m_expression; }
+    bool isValid() const { return !m_code.empty(); }
+
+    /**
+     * @brief evaluate
+     * Evaluates the condition with registers read through @p reg (a callable taking the register index) and the hit
+     * count @p hits.
+     */
+    template <typename RegisterReader>
+    long long evaluate(const RegisterReader& reg, long long hits) const {
+        long long* sp = m_stack.data();
+        for (const auto& instr : m_code) {
+            // clang-format off
+            switch (instr.op) {
+                case Op::Imm: *sp++ = instr.operand; break;
+                case Op::Reg: *sp++ = static_cast<int32_t>(reg(static_cast<unsigned>(instr.operand))); break;
+                case Op::Hits: *sp++ = hits; break;
+                case Op::Neg: sp[-1] = static_cast<long long>(0ull - static_cast<unsigned long long>(sp[-1])); break;
+                case Op::Not: sp[-1] = !sp[-1]; break;
+                case Op::BitNot: sp[-1] = ~sp[-1]; break;
+                default: {
+                    const long long rhs = *--sp;
+                    sp[-1] = binary(instr.op, sp[-1], rhs);
+                    break;
+                }
+            }
+            // clang-format on
+        }
+        return m_stack[0];
+    }
+
+private:
+    // clang-format off
+    enum class Op : uint8_t {
+        Imm, Reg, Hits,
+        Neg, Not, BitNot,
+        Mul, Div, Rem, Add, Sub, Shl, Shr, Lt, Le, Gt, Ge, Eq, Ne, BitAnd, BitXor, BitOr, And, Or
+    };
+    // clang-format on
+    struct Instr {
+        Op op;
+        long long operand;
+    };
+    static long long binary(Op op, long long lhs, long long rhs);
+
+    QString m_expression;
+    std::vector<Instr> m_code;
+    // Evaluation stack, sized to the maximum depth of the compiled code
+    mutable std::vector<long long> m_stack;
+
+    friend class BreakpointConditionParser;
+};
+
+}  // namespace Ripes
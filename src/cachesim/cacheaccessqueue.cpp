@@ -0,0 +1,85 @@
+#include "cacheaccessqueue.h"
+#include "cachesim.h"
+
+namespace Ripes {
+
+static_assert((CacheAccessQueue::s_capacity & (CacheAccessQueue::s_capacity - 1)) == 0,
+              "Capacity must be a power of 2");
+
+namespace {
+thread_local bool t_isConsumer = false;
+thread_local long long t_currentCycle = 0;
+}  // namespace
+
+CacheAccessQueue::CacheAccessQueue() : m_records(s_capacity) {}
+
+CacheAccessQueue::~CacheAccessQueue() {
+    stop();
+}
+
+void CacheAccessQueue::start() {
+    if (isRunning()) {
+        return;
+    }
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+}
+
+void CacheAccessQueue::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    if (m_worker.joinable()) {
+        // The consumer drains the buffer before observing the stop request
+        m_stopping.store(true, std::memory_order_release);
+        m_worker.join();
+    }
+    m_running.store(false, std::memory_order_release);
+}
+
+void CacheAccessQueue::push(const Record& record) {
+    if (!m_worker.joinable()) {
+        // The consumer is started upon the first record, such that runs without caches do not occupy a core
+        m_worker = std::thread([this] { consume(); });
+    }
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    while (tail - m_head.load(std::memory_order_acquire) == s_capacity) {
+        std::this_thread::yield();
+    }
+    m_records[tail & (s_capacity - 1)] = record;
+    m_tail.store(tail + 1, std::memory_order_release);
+}
+
+bool CacheAccessQueue::isConsumerThread() {
+    return t_isConsumer;
+}
+
+long long CacheAccessQueue::currentCycle() {
+    return t_currentCycle;
+}
+
+void CacheAccessQueue::consume() {
+    t_isConsumer = true;
+    size_t head = m_head.load(std::memory_order_relaxed);
+    while (true) {
+        // The stop request is read before the tail, such that records pushed before the request are never missed
+        const bool stopping = m_stopping.load(std::memory_order_acquire);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head == tail) {
+            if (stopping) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        for (; head != tail; head++) {
+            const Record& record = m_records[head & (s_capacity - 1)];
+            t_currentCycle = record.cycle;
+            record.cache->simulateQueued(record);
+            // Releasing records one at a time lets a waiting producer proceed as soon as possible
+            m_head.store(head + 1, std::memory_order_release);
+        }
+    }
+}
+
+}  // namespace Ripes
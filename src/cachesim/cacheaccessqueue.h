@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Ripes {
+
+class CacheSim;
+
+/**
+ * @brief The CacheAccessQueue class
+ * Decouples the cache simulators from the processor whilst the processor is run asynchronously. The simulating thread
+ * (the producer) pushes the memory accesses of each cycle into a lock-free single-producer/single-consumer ring
+ * buffer, which a worker thread (the consumer) drains into the caches on a second core. The producer waits whilst the
+ * buffer is full, such that the caches lag the processor by at most s_capacity records.
+ */
+class CacheAccessQueue {
+public:
+    /**
+     * @brief The Record struct
+     * The memory access of a cache in a cycle, if any, and whether the cache is checkpointed in the cycle.
+     */
+    struct Record {
+        CacheSim* cache = nullptr;
+        long long cycle = 0;
+        uint32_t address = 0;
+        uint32_t pc = 0;
+        // Checkpoint interval of the processor handler if the cache is checkpointed in the cycle, otherwise 0
+        unsigned checkpointInterval = 0;
+        bool access = false;
+        bool write = false;
+    };
+
+    CacheAccessQueue();
+    ~CacheAccessQueue();
+
+    /**
+     * @brief start
+     * Starts accepting records, which may be pushed from a single thread until stop(). The consumer is started upon
+     * the first push.
+     */
+    void start();
+    /**
+     * @brief stop
+     * Synchronization barrier; blocks until all pushed records have been simulated, and stops the consumer, such that
+     * the caches are consistent with the processor. Does nothing if the consumer is not running.
+     */
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    /// Pushes @p record, waiting for the consumer whilst the buffer is full
+    void push(const Record& record);
+
+    /**
+     * @brief isConsumerThread/currentCycle
+     * @returns whether the calling thread is the consumer, and if so, the cycle of the record being simulated.
+     */
+    static bool isConsumerThread();
+    static long long currentCycle();
+
+    static constexpr size_t s_capacity = 1 << 14;
+
+private:
+    void consume();
+
+    std::vector<Record> m_records;
+    // Free-running indices of the next record to pop (written by the consumer) and to push (written by the producer),
+    // on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopping{false};
+    std::thread m_worker;
+};
+
+}  // namespace Ripes
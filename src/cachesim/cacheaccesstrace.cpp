@@ -0,0 +1,158 @@
+#include "cacheaccesstrace.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Ripes {
+
+void CacheAccessTraceBuffer::clear() {
+    m_chunks.clear();
+    m_size = 0;
+    m_backCycle = 0;
+    m_back = CacheAccessTrace();
+}
+
+void CacheAccessTraceBuffer::append(uint64_t cycle, const CacheAccessTrace& trace) {
+    static_assert(std::size(s_counters) < 16, "Counter events must not overlap the Escaped event");
+    if (!empty() && m_backCycle == cycle) {
+        popBack();
+    }
+
+    if (m_chunks.empty() || m_chunks.back()->events.size() == s_chunkEntries) {
+        auto chunk = std::make_shared<Chunk>();
+        chunk->baseCycle = m_backCycle;
+        chunk->base = m_back;
+        chunk->firstCycle = cycle;
+        m_chunks.push_back(std::move(chunk));
+    }
+    Chunk& chunk = backChunk();
+
+    Delta delta;
+    delta.cycle = cycle - m_backCycle;
+    delta.trace = difference(trace, m_back);
+
+    uint16_t events = 0;
+    bool unitDeltas = delta.cycle < s_escapedCycleDelta;
+    for (size_t i = 0; i < std::size(s_counters) && unitDeltas; i++) {
+        const uint64_t counterDelta = delta.trace.*s_counters[i];
+        unitDeltas = counterDelta <= 1;
+        events |= static_cast<uint16_t>(counterDelta << i);
+    }
+    if (unitDeltas) {
+        chunk.cycleDeltas.push_back(static_cast<uint8_t>(delta.cycle));
+        chunk.events.push_back(events);
+    } else {
+        chunk.cycleDeltas.push_back(s_escapedCycleDelta);
+        chunk.events.push_back(Escaped);
+        chunk.escapes.push_back(delta);
+    }
+
+    m_size++;
+    m_backCycle = cycle;
+    m_back = trace;
+}
+
+void CacheAccessTraceBuffer::popBack() {
+    if (empty()) {
+        return;
+    }
+
+    Chunk& chunk = backChunk();
+    Delta delta;
+    const uint16_t events = chunk.events.back();
+    if (events & Escaped) {
+        delta = chunk.escapes.back();
+        chunk.escapes.pop_back();
+    } else {
+        delta.cycle = chunk.cycleDeltas.back();
+        for (size_t i = 0; i < std::size(s_counters); i++) {
+            delta.trace.*s_counters[i] = (events >> i) & 1;
+        }
+    }
+    chunk.cycleDeltas.pop_back();
+    chunk.events.pop_back();
+    if (chunk.events.empty()) {
+        m_chunks.pop_back();
+    }
+
+    m_size--;
+    m_backCycle -= delta.cycle;
+    m_back = difference(m_back, delta.trace);
+}
+
+void CacheAccessTraceBuffer::truncate(uint64_t cycle) {
+    // Drop whole chunks first, such that truncating far back does not decode each dropped entry
+    while (!m_chunks.empty() && m_chunks.back()->firstCycle > cycle) {
+        const Chunk& chunk = *m_chunks.back();
+        m_size -= chunk.events.size();
+        m_backCycle = chunk.baseCycle;
+        m_back = chunk.base;
+        m_chunks.pop_back();
+    }
+    while (!empty() && m_backCycle > cycle) {
+        popBack();
+    }
+}
+
+void CacheAccessTraceBuffer::advance(const Chunk& chunk, size_t i, size_t& escape, uint64_t& cycle,
+                                     CacheAccessTrace& trace) {
+    const uint16_t events = chunk.events[i];
+    if (events & Escaped) {
+        const Delta& delta = chunk.escapes[escape++];
+        cycle += delta.cycle;
+        for (const auto counter : s_counters) {
+            trace.*counter += delta.trace.*counter;
+        }
+    } else {
+        cycle += chunk.cycleDeltas[i];
+        for (size_t c = 0; c < std::size(s_counters); c++) {
+            trace.*s_counters[c] += (events >> c) & 1;
+        }
+    }
+}
+
+CacheAccessTrace CacheAccessTraceBuffer::difference(const CacheAccessTrace& lhs, const CacheAccessTrace& rhs) {
+    CacheAccessTrace trace;
+    for (const auto counter : s_counters) {
+        trace.*counter = lhs.*counter - rhs.*counter;
+    }
+    return trace;
+}
+
+CacheAccessTrace CacheAccessTraceBuffer::lookup(uint64_t cycle) const {
+    if (m_chunks.empty() || m_chunks.front()->firstCycle > cycle) {
+        return CacheAccessTrace();
+    }
+    const Chunk& chunk = *m_chunks[findChunk(cycle)];
+    uint64_t entryCycle = chunk.baseCycle;
+    CacheAccessTrace trace = chunk.base;
+    size_t escape = 0;
+    for (size_t i = 0; i < chunk.events.size(); i++) {
+        uint64_t nextCycle = entryCycle;
+        CacheAccessTrace next = trace;
+        advance(chunk, i, escape, nextCycle, next);
+        if (nextCycle > cycle) {
+            break;
+        }
+        entryCycle = nextCycle;
+        trace = next;
+    }
+    return trace;
+}
+
+size_t CacheAccessTraceBuffer::findChunk(uint64_t cycle) const {
+    const auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), cycle,
+                                     [](uint64_t c, const auto& chunk) { return c < chunk->firstCycle; });
+    return it == m_chunks.begin() ? 0 : static_cast<size_t>(it - m_chunks.begin()) - 1;
+}
+
+CacheAccessTraceBuffer::Chunk& CacheAccessTraceBuffer::backChunk() {
+    auto& chunk = m_chunks.back();
+    if (chunk.use_count() > 1) {
+        // The chunk is read through a copy of the buffer, which keeps the unmodified chunk
+        chunk = std::make_shared<Chunk>(*chunk);
+    }
+    return *chunk;
+}
+
+}  // namespace Ripes
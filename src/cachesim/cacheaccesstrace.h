@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The CacheAccessTrace struct
+ * Access statistics of a cache, accumulated over all accesses up to and including some cycle.
+ */
+struct CacheAccessTrace {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t writebacks = 0;
+    // Prefetches which filled a block, and the subsets of these which were demanded (useful), demanded before the fill
+    // could have completed (late), or evicted unused after having displaced a valid block (polluting)
+    uint64_t prefetches = 0;
+    uint64_t usefulPrefetches = 0;
+    uint64_t latePrefetches = 0;
+    uint64_t pollutingPrefetches = 0;
+    // Demand misses, as classified by their cause (see MissClassifier)
+    uint64_t compulsoryMisses = 0;
+    uint64_t capacityMisses = 0;
+    uint64_t conflictMisses = 0;
+    // Misses served by the victim cache, and written-through writes which were coalesced into, or stalled on a full,
+    // write buffer
+    uint64_t victimHits = 0;
+    uint64_t coalescedWrites = 0;
+    uint64_t writeBufferStalls = 0;
+};
+
+/**
+ * @brief The CacheAccessTraceBuffer class
+ * Compact storage of the access statistics of each cycle in which a cache was accessed. Entries are stored as deltas
+ * to their preceding entry, in chunks of columns for the cycle delta and the counters incremented by the entry. A
+ * single access advances each of its counters by at most one, such that the common entry takes three bytes; entries
+ * of larger deltas (ie. accumulated statistics of a replayed trace) are escaped into a column of full deltas.
+ * The statistics of the most recent entry are kept at hand, such that appending and popping entries are O(1).
+ * Copies of a buffer share its chunks, which are copied on write. A copy thus serves as an immutable snapshot of the
+ * trace, which may be read from another thread whilst the original is modified, and copying is O(chunks).
+ */
+class CacheAccessTraceBuffer {
+public:
+    bool empty() const { return m_size == 0; }
+    uint64_t size() const { return m_size; }
+    void clear();
+
+    /**
+     * @brief append
+     * Records @p trace as the statistics of @p cycle. Replaces the most recent entry if it is of @p cycle, which must
+     * not precede the cycle of the most recent entry.
+     */
+    void append(uint64_t cycle, const CacheAccessTrace& trace);
+    void popBack();
+    /// Removes all entries of cycles after @p cycle
+    void truncate(uint64_t cycle);
+
+    /// @returns the statistics of the most recent entry, or zero statistics if there is none
+    const CacheAccessTrace& back() const { return m_back; }
+    uint64_t backCycle() const { return m_backCycle; }
+
+    /**
+     * @brief lookup
+     * @returns the statistics of the last entry of a cycle at or before @p cycle, or zero statistics if there is none.
+     * Only the chunk of the entry is decoded.
+     */
+    CacheAccessTrace lookup(uint64_t cycle) const;
+
+    /**
+     * @brief window
+     * @returns the statistics accumulated by the entries of cycles in [@p first; @p last]. Only the chunks of the
+     * entries bounding the window are decoded.
+     */
+    CacheAccessTrace window(uint64_t first, uint64_t last) const {
+        return difference(lookup(last), first == 0 ? CacheAccessTrace() : lookup(first - 1));
+    }
+
+    /// @returns @p lhs - @p rhs, counter by counter
+    static CacheAccessTrace difference(const CacheAccessTrace& lhs, const CacheAccessTrace& rhs);
+
+    /**
+     * @brief forEach
+     * Calls @p f(cycle, trace) for each entry of a cycle in [@p first; @p last], in order of cycles.
+     */
+    template <typename F>
+    void forEach(uint64_t first, uint64_t last, F&& f) const {
+        for (size_t c = findChunk(first); c < m_chunks.size(); c++) {
+            const Chunk& chunk = *m_chunks[c];
+            uint64_t cycle = chunk.baseCycle;
+            CacheAccessTrace trace = chunk.base;
+            size_t escape = 0;
+            for (size_t i = 0; i < chunk.events.size(); i++) {
+                advance(chunk, i, escape, cycle, trace);
+                if (cycle > last) {
+                    return;
+                }
+                if (cycle >= first) {
+                    f(cycle, trace);
+                }
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief The Event enum
+     * Bits of the event column of an entry; bit i indicates that the entry incremented counter i (see s_counters) by
+     * one, and the Escaped bit that the full delta of the entry is found in the escape column.
+     */
+    enum Event : uint16_t { Escaped = 0x8000 };
+    static constexpr uint8_t s_escapedCycleDelta = 0xFF;
+    /// The counters of the statistics; counter i is incremented by an entry of event bit 1 << i
+    static constexpr uint64_t CacheAccessTrace::*s_counters[] = {&CacheAccessTrace::hits,
+                                                                  &CacheAccessTrace::misses,
+                                                                  &CacheAccessTrace::reads,
+                                                                  &CacheAccessTrace::writes,
+                                                                  &CacheAccessTrace::writebacks,
+                                                                  &CacheAccessTrace::prefetches,
+                                                                  &CacheAccessTrace::usefulPrefetches,
+                                                                  &CacheAccessTrace::latePrefetches,
+                                                                  &CacheAccessTrace::pollutingPrefetches,
+                                                                  &CacheAccessTrace::compulsoryMisses,
+                                                                  &CacheAccessTrace::capacityMisses,
+                                                                  &CacheAccessTrace::conflictMisses,
+                                                                  &CacheAccessTrace::victimHits,
+                                                                  &CacheAccessTrace::coalescedWrites,
+                                                                  &CacheAccessTrace::writeBufferStalls};
+    static constexpr size_t s_chunkEntries = 1 << 16;
+
+    struct Delta {
+        uint64_t cycle = 0;
+        CacheAccessTrace trace;
+    };
+
+    struct Chunk {
+        // Cycle and statistics of the entry preceding the chunk
+        uint64_t baseCycle = 0;
+        CacheAccessTrace base;
+        // Cycle of the first entry of the chunk
+        uint64_t firstCycle = 0;
+        std::vector<uint8_t> cycleDeltas;
+        std::vector<uint16_t> events;
+        // Full deltas of the escaped entries of the chunk, in order
+        std::vector<Delta> escapes;
+    };
+
+    /// Advances @p cycle and @p trace past entry @p i of @p chunk; @p escape is the index of the next escaped delta
+    static void advance(const Chunk& chunk, size_t i, size_t& escape, uint64_t& cycle, CacheAccessTrace& trace);
+    /// @returns the index of the last chunk whose first entry is at or before @p cycle, or 0 if there is none
+    size_t findChunk(uint64_t cycle) const;
+    /// @returns the most recent chunk for modification, copying it first if it is shared with a copy of the buffer
+    Chunk& backChunk();
+
+    std::vector<std::shared_ptr<Chunk>> m_chunks;
+    uint64_t m_size = 0;
+    uint64_t m_backCycle = 0;
+    CacheAccessTrace m_back;
+};
+
+}  // namespace Ripes
@@ -1,14 +1,22 @@
 #include "cacheconfigwidget.h"
 #include "ui_cacheconfigwidget.h"
 
+#include <QCheckBox>
+#include <QHeaderView>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QSpinBox>
+#include <QTableWidget>
+#include <QTimer>
 #include <QToolButton>
 #include <QtCharts/QChartView>
 
 #include "cacheplotwidget.h"
+#include "cachesweepwidget.h"
 #include "enumcombobox.h"
+#include "instructionmixwidget.h"
+#include "processorhandler.h"
+#include "shadowcache.h"
 
 namespace Ripes {
 
@@ -16,8 +24,10 @@ CacheConfigWidget::CacheConfigWidget(QWidget* parent) : QWidget(parent), m_ui(ne
     m_ui->setupUi(this);
 
     // Gather a list of all items in this widget which will trigger a modification to the current configuration
-    m_configItems = {m_ui->presets,           m_ui->ways,   m_ui->lines, m_ui->blocks,
-                     m_ui->replacementPolicy, m_ui->wrMiss, m_ui->wrHit};
+    m_configItems = {m_ui->presets,           m_ui->ways,           m_ui->lines,            m_ui->blocks,
+                     m_ui->replacementPolicy, m_ui->wrMiss,         m_ui->wrHit,            m_ui->reuseDistances,
+                     m_ui->prefetcher,        m_ui->prefetchDegree, m_ui->prefetchDistance, m_ui->writeBuffer,
+                     m_ui->victimCache,       m_ui->stallOnMiss};
 }
 
 void CacheConfigWidget::setCache(CacheSim* cache) {
@@ -30,9 +40,28 @@ void CacheConfigWidget::setCache(CacheSim* cache) {
     m_ui->cachePlot->setIcon(plotIcon);
     connect(m_ui->cachePlot, &QPushButton::clicked, this, &CacheConfigWidget::showCachePlot);
 
+    // The instruction mix must not be accessed while running
+    m_ui->instructionMix->setIcon(QIcon(":/icons/cpu.svg"));
+    connect(m_ui->instructionMix, &QToolButton::clicked, this, &CacheConfigWidget::showInstructionMix);
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, m_ui->instructionMix,
+            [=] { m_ui->instructionMix->setEnabled(false); });
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, m_ui->instructionMix,
+            [=] { m_ui->instructionMix->setEnabled(true); });
+
+    // The statistics must not be restarted while running
+    connect(m_ui->resetStatistics, &QToolButton::clicked, m_cache, &CacheSim::resetStatistics);
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, m_ui->resetStatistics,
+            [=] { m_ui->resetStatistics->setEnabled(false); });
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, m_ui->resetStatistics,
+            [=] { m_ui->resetStatistics->setEnabled(true); });
+
+    m_ui->sweepButton->setIcon(QIcon(":/icons/graph.svg"));
+    connect(m_ui->sweepButton, &QToolButton::clicked, this, &CacheConfigWidget::showCacheSweep);
+
     setupEnumCombobox(m_ui->replacementPolicy, s_cacheReplPolicyStrings);
     setupEnumCombobox(m_ui->wrHit, s_cacheWritePolicyStrings);
     setupEnumCombobox(m_ui->wrMiss, s_cacheWriteAllocateStrings);
+    setupEnumCombobox(m_ui->prefetcher, s_prefetcherStrings);
 
     m_ui->ways->setValue(m_cache->getWaysBits());
     m_ui->lines->setValue(m_cache->getLineBits());
@@ -46,6 +75,12 @@ void CacheConfigWidget::setCache(CacheSim* cache) {
     connect(m_ui->blocks, QOverload<int>::of(&QSpinBox::valueChanged), m_cache, &CacheSim::setBlocks);
     connect(m_ui->lines, QOverload<int>::of(&QSpinBox::valueChanged), m_cache, &CacheSim::setLines);
     connect(m_ui->sizeBreakdownButton, &QPushButton::clicked, this, &CacheConfigWidget::showSizeBreakdown);
+    connect(m_ui->reuseDistances, &QCheckBox::toggled, m_cache, &CacheSim::setReuseDistanceAnalysis);
+    connect(m_ui->hitLatency, QOverload<int>::of(&QSpinBox::valueChanged), m_cache, &CacheSim::setHitLatency);
+    connect(m_ui->memoryLatency, QOverload<int>::of(&QSpinBox::valueChanged), m_cache, &CacheSim::setMemoryLatency);
+    connect(m_ui->writeBuffer, QOverload<int>::of(&QSpinBox::valueChanged), m_cache, &CacheSim::setWriteBuffer);
+    connect(m_ui->victimCache, QOverload<int>::of(&QSpinBox::valueChanged), m_cache, &CacheSim::setVictimCache);
+    connect(m_ui->stallOnMiss, &QCheckBox::toggled, m_cache, &CacheSim::setStallOnMiss);
 
     connect(m_ui->replacementPolicy, QOverload<int>::of(&QComboBox::currentIndexChanged), [=](int index) {
         m_cache->setReplacementPolicy(qvariant_cast<CacheSim::ReplPolicy>(m_ui->replacementPolicy->itemData(index)));
@@ -56,10 +91,51 @@ void CacheConfigWidget::setCache(CacheSim* cache) {
     connect(m_ui->wrMiss, QOverload<int>::of(&QComboBox::currentIndexChanged), [=](int index) {
         m_cache->setWriteAllocatePolicy(qvariant_cast<CacheSim::WriteAllocPolicy>(m_ui->wrMiss->itemData(index)));
     });
+    connect(m_ui->prefetcher, QOverload<int>::of(&QComboBox::currentIndexChanged), [=](int index) {
+        auto config = m_cache->getPrefetcher();
+        config.type = qvariant_cast<Prefetcher::Type>(m_ui->prefetcher->itemData(index));
+        m_cache->setPrefetcher(config);
+    });
+    connect(m_ui->prefetchDegree, QOverload<int>::of(&QSpinBox::valueChanged), [=](int degree) {
+        auto config = m_cache->getPrefetcher();
+        config.degree = degree;
+        m_cache->setPrefetcher(config);
+    });
+    connect(m_ui->prefetchDistance, QOverload<int>::of(&QSpinBox::valueChanged), [=](int distance) {
+        auto config = m_cache->getPrefetcher();
+        config.distance = distance;
+        m_cache->setPrefetcher(config);
+    });
 
     connect(m_cache, &CacheSim::configurationChanged, this, &CacheConfigWidget::handleConfigurationChanged);
     connect(m_cache, &CacheSim::configurationChanged, [=] { emit configurationChanged(); });
     connect(m_cache, &CacheSim::hitrateChanged, this, &CacheConfigWidget::updateHitrate);
+    connect(m_cache, &CacheSim::latencyChanged, this, &CacheConfigWidget::handleLatencyChanged);
+
+    // The cache does not signal hit rate changes while the processor is running; poll its live statistics instead
+    auto* liveUpdateTimer = new QTimer(this);
+    liveUpdateTimer->setInterval(100);
+    connect(liveUpdateTimer, &QTimer::timeout, this, &CacheConfigWidget::updateHitrate);
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, liveUpdateTimer, qOverload<>(&QTimer::start));
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, liveUpdateTimer, &QTimer::stop);
+
+    // Shadow caches are accessed by the simulation thread while running, and are thus only attached or removed whilst
+    // the processor is not running
+    m_ui->addShadowCache->setIcon(QIcon(":/icons/plus.svg"));
+    m_ui->removeShadowCache->setIcon(QIcon(":/icons/delete.svg"));
+    m_ui->shadowCaches->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    connect(m_ui->addShadowCache, &QToolButton::clicked, this, &CacheConfigWidget::addShadowCache);
+    connect(m_ui->removeShadowCache, &QToolButton::clicked, this, &CacheConfigWidget::removeShadowCache);
+    connect(m_cache, &CacheSim::shadowCachesChanged, this, &CacheConfigWidget::updateShadowCaches);
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, this, [=] {
+        m_ui->addShadowCache->setEnabled(false);
+        m_ui->removeShadowCache->setEnabled(false);
+    });
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, this, [=] {
+        m_ui->addShadowCache->setEnabled(m_cache->getShadowCaches().size() < CacheSim::s_maxShadowCaches);
+        m_ui->removeShadowCache->setEnabled(!m_cache->getShadowCaches().empty());
+    });
+    updateShadowCaches();
 
     setupPresets();
     handleConfigurationChanged();
@@ -70,6 +146,16 @@ void CacheConfigWidget::showCachePlot() {
     plotWidget.exec();
 }
 
+void CacheConfigWidget::showInstructionMix() {
+    InstructionMixWidget mixWidget(this);
+    mixWidget.exec();
+}
+
+void CacheConfigWidget::showCacheSweep() {
+    CacheSweepWidget sweepWidget(*m_cache, this);
+    sweepWidget.exec();
+}
+
 void CacheConfigWidget::setupPresets() {
     std::vector<std::pair<QString, CacheSim::CachePreset>> presets;
 
@@ -115,6 +201,20 @@ void CacheConfigWidget::handleConfigurationChanged() {
     setEnumIndex(m_ui->wrHit, m_cache->getWritePolicy());
     setEnumIndex(m_ui->wrMiss, m_cache->getWriteAllocPolicy());
     setEnumIndex(m_ui->replacementPolicy, m_cache->getReplacementPolicy());
+    m_ui->reuseDistances->setChecked(m_cache->isReuseDistanceAnalysisEnabled());
+    const auto& prefetcher = m_cache->getPrefetcher();
+    setEnumIndex(m_ui->prefetcher, prefetcher.type);
+    m_ui->prefetchDegree->setValue(prefetcher.degree);
+    m_ui->prefetchDistance->setValue(prefetcher.distance);
+    m_ui->prefetchDegree->setEnabled(prefetcher.type != Prefetcher::Type::None);
+    m_ui->prefetchDistance->setEnabled(prefetcher.type != Prefetcher::Type::None);
+    m_ui->writeBuffer->setValue(m_cache->getWriteBufferEntries());
+    // The write buffer only buffers written-through writes
+    m_ui->writeBuffer->setEnabled(m_cache->getWritePolicy() == CacheSim::WritePolicy::WriteThrough);
+    m_ui->victimCache->setValue(m_cache->getVictimCacheEntries());
+    m_ui->stallOnMiss->setChecked(m_cache->isStallOnMissEnabled());
+    // Unified caches are only accessed through the first level caches, which determine the stalls of the processor
+    m_ui->stallOnMiss->setEnabled(m_cache->getType() != CacheSim::CacheType::UnifiedCache);
 
     if (!m_justSetPreset) {
         m_ui->presets->setCurrentIndex(-1);
@@ -125,14 +225,77 @@ void CacheConfigWidget::handleConfigurationChanged() {
 
     updateIndexingText();
     m_ui->size->setText(QString::number(m_cache->getCacheSize().bits));
+    handleLatencyChanged();
+}
+
+void CacheConfigWidget::handleLatencyChanged() {
+    for (auto* spinBox : {m_ui->hitLatency, m_ui->memoryLatency}) {
+        spinBox->blockSignals(true);
+    }
+    m_ui->hitLatency->setValue(m_cache->getHitLatency());
+    m_ui->memoryLatency->setValue(m_cache->getMemoryLatency());
+    // The memory latency only applies to the last level of the hierarchy
+    m_ui->memoryLatency->setEnabled(m_cache->getNextLevel() == nullptr);
+    for (auto* spinBox : {m_ui->hitLatency, m_ui->memoryLatency}) {
+        spinBox->blockSignals(false);
+    }
     updateHitrate();
 }
 
 void CacheConfigWidget::updateHitrate() {
-    m_ui->hitrate->setText(QString::number(m_cache->getHitRate(), 'G', 4));
-    m_ui->hits->setText(QString::number(m_cache->getHits()));
-    m_ui->misses->setText(QString::number(m_cache->getMisses()));
-    m_ui->writebacks->setText(QString::number(m_cache->getWritebacks()));
+    const auto stats = m_cache->getStatistics();
+    const uint64_t accesses = stats.hits + stats.misses;
+    const double hitrate = accesses == 0 ? 0 : static_cast<double>(stats.hits) / accesses;
+    m_ui->hitrate->setText(QString::number(hitrate, 'G', 4));
+    m_ui->hits->setText(QString::number(stats.hits));
+    m_ui->misses->setText(QString::number(stats.misses));
+    m_ui->writebacks->setText(QString::number(stats.writebacks));
+    m_ui->amat->setText(QString::number(m_cache->getAverageAccessTime(), 'G', 4));
+
+    const auto& shadows = m_cache->getShadowCaches();
+    for (unsigned i = 0; i < shadows.size() && static_cast<int>(i) < m_ui->shadowCaches->rowCount(); i++) {
+        const auto shadowStats = shadows[i]->getLiveStatistics();
+        const uint64_t shadowAccesses = shadowStats.hits + shadowStats.misses;
+        const double shadowHitrate = shadowAccesses == 0 ? 0 : static_cast<double>(shadowStats.hits) / shadowAccesses;
+        m_ui->shadowCaches->item(i, 1)->setText(QString::number(shadowHitrate, 'G', 4));
+        m_ui->shadowCaches->item(i, 2)->setText(QString::number(shadowStats.misses));
+        m_ui->shadowCaches->item(i, 3)->setText(QString::number(shadowStats.writebacks));
+    }
+}
+
+void CacheConfigWidget::addShadowCache() {
+    m_cache->addShadowCache(CacheSim::CachePreset{m_cache->getBlockBits(), m_cache->getLineBits(),
+                                                  m_cache->getWaysBits(), m_cache->getWritePolicy(),
+                                                  m_cache->getWriteAllocPolicy(), m_cache->getReplacementPolicy(),
+                                                  m_cache->getSeed()});
+}
+
+void CacheConfigWidget::removeShadowCache() {
+    const int row = m_ui->shadowCaches->currentRow();
+    if (row >= 0 && row < static_cast<int>(m_cache->getShadowCaches().size())) {
+        m_cache->removeShadowCache(row);
+    }
+}
+
+void CacheConfigWidget::updateShadowCaches() {
+    const auto& shadows = m_cache->getShadowCaches();
+    m_ui->shadowCaches->setRowCount(static_cast<int>(shadows.size()));
+    for (unsigned i = 0; i < shadows.size(); i++) {
+        const auto& preset = shadows[i]->getPreset();
+        const QString configuration = QString::number(1u << preset.lines) + " lines, " +
+                                      QString::number(1u << preset.ways) + " ways, " +
+                                      QString::number(1u << preset.blocks) + " words, " +
+                                      s_cacheReplPolicyStrings.at(preset.replPolicy) + ", " +
+                                      s_cacheWritePolicyStrings.at(preset.wrPolicy) + ", " +
+                                      s_cacheWriteAllocateStrings.at(preset.wrAllocPolicy);
+        m_ui->shadowCaches->setItem(i, 0, new QTableWidgetItem(configuration));
+        for (int column = 1; column < m_ui->shadowCaches->columnCount(); column++) {
+            m_ui->shadowCaches->setItem(i, column, new QTableWidgetItem());
+        }
+    }
+    m_ui->addShadowCache->setEnabled(shadows.size() < CacheSim::s_maxShadowCaches);
+    m_ui->removeShadowCache->setEnabled(!shadows.empty());
+    updateHitrate();
 }
 
 void CacheConfigWidget::showSizeBreakdown() {
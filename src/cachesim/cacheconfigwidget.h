@@ -24,7 +24,14 @@ signals:
 public slots:
     void updateHitrate();
     void handleConfigurationChanged();
+    void handleLatencyChanged();
     void showCachePlot();
+    void showInstructionMix();
+    void showCacheSweep();
+    void addShadowCache();
+    void removeShadowCache();
+    /// Lists the shadow caches of the cache, with their live statistics
+    void updateShadowCaches();
 
 private:
     void updateCacheSize();
@@ -50,4 +57,5 @@ private:
 Q_DECLARE_METATYPE(Ripes::CacheSim::WritePolicy);
 Q_DECLARE_METATYPE(Ripes::CacheSim::WriteAllocPolicy);
 Q_DECLARE_METATYPE(Ripes::CacheSim::ReplPolicy);
+Q_DECLARE_METATYPE(Ripes::Prefetcher::Type);
 Q_DECLARE_METATYPE(Ripes::CacheSim::CachePreset);
@@ -4,8 +4,13 @@
 #include <QGraphicsRectItem>
 #include <QGraphicsScene>
 #include <QGraphicsSimpleTextItem>
+#include <QPainter>
 #include <QPen>
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
 #include "processorhandler.h"
 #include "radix.h"
 
@@ -20,6 +25,13 @@ std::set<TK> keys(std::map<TK, TV> const& input_map) {
     }
     return keyset;
 }
+
+// Sets the text of @p item, unless unchanged; setting the text of an item always invalidates its geometry
+void setTextIfChanged(QGraphicsSimpleTextItem* item, const QString& text) {
+    if (item->text() != text) {
+        item->setText(text);
+    }
+}
 }  // namespace
 
 namespace Ripes {
@@ -30,31 +42,38 @@ CacheGraphic::CacheGraphic(CacheSim& cache) : QGraphicsObject(nullptr), m_cache(
     connect(&cache, &CacheSim::wayInvalidated, this, &CacheGraphic::wayInvalidated);
     connect(&cache, &CacheSim::cacheInvalidated, this, &CacheGraphic::cacheInvalidated);
 
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(s_flushInterval);
+    connect(&m_flushTimer, &QTimer::timeout, this, &CacheGraphic::flush);
+
     cacheParametersChanged();
 }
 
 void CacheGraphic::updateLineReplFields(unsigned lineIdx) {
-    auto* cacheLine = m_cache.getLine(lineIdx);
-
-    if (cacheLine == nullptr) {
-        // Nothing to do
+    const auto lineIt = m_cacheTextItems.find(lineIdx);
+    if (lineIt == m_cacheTextItems.end()) {
+        // The line is not materialized
         return;
     }
 
-    if (m_cacheTextItems.at(0).at(0).lru == nullptr) {
+    if (lineIt->second.ways.at(0).lru == nullptr) {
         // The current cache configuration does not have any replacement field
         return;
     }
 
-    for (const auto& way : m_cacheTextItems[lineIdx]) {
+    const auto cacheLine = m_cache.getLine(lineIdx);
+    for (const auto& way : lineIt->second.ways) {
         // If LRU was just initialized, the actual (software) LRU value may be very large. Mask to the
         // number of actual LRU bits.
-        unsigned lruVal = cacheLine->at(way.first).lru;
+        unsigned lruVal = cacheLine.repl(way.first);
         lruVal &= generateBitmask(m_cache.getWaysBits());
         const QString lruText = QString::number(lruVal);
+        if (way.second.lru->text() == lruText) {
+            continue;
+        }
         way.second.lru->setText(lruText);
 
-        // LRU text might have changed; update LRU field position to center in column
+        // LRU text changed; update LRU field position to center in column
         const qreal y = lineIdx * m_lineHeight + way.first * m_setHeight;
         const qreal x = m_widthBeforeLRU + m_lruWidth / 2 - m_fm.width(lruText) / 2;
 
@@ -63,11 +82,17 @@ void CacheGraphic::updateLineReplFields(unsigned lineIdx) {
 }
 
 void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
-    CacheWay& way = m_cacheTextItems.at(lineIdx).at(wayIdx);
-    const CacheSim::CacheWay& simWay = m_cache.getLine(lineIdx)->at(wayIdx);
+    const auto lineIt = m_cacheTextItems.find(lineIdx);
+    if (lineIt == m_cacheTextItems.end()) {
+        // The line is not materialized; it is brought up to date if it is scrolled into view
+        return;
+    }
+    CacheWay& way = lineIt->second.ways.at(wayIdx);
+    const auto simLine = m_cache.getLine(lineIdx);
+    const bool simValid = simLine.valid(wayIdx);
 
     // ======================== Update block text fields ======================
-    if (simWay.valid) {
+    if (simValid) {
         for (int i = 0; i < m_cache.getBlocks(); i++) {
             QGraphicsSimpleTextItem* blockTextItem = nullptr;
             if (way.blocks.count(i) == 0) {
@@ -83,14 +108,17 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
             }
 
             // Update block text
-            const uint32_t addressForBlock = m_cache.buildAddress(simWay.tag, lineIdx, i);
+            const uint32_t addressForBlock = m_cache.buildAddress(simLine.tag(wayIdx), lineIdx, i);
             const auto data = ProcessorHandler::get()->getMemory().readMemConst(addressForBlock);
             const QString text = encodeRadixValue(data, Radix::Hex);
-            blockTextItem->setText(text);
-            blockTextItem->setToolTip("Address: " + encodeRadixValue(addressForBlock, Radix::Hex));
-            // Store the address within the userrole of the block text. Doing this, we are able to easily retrieve the
-            // address for the block if the block is clicked.
-            blockTextItem->setData(Qt::UserRole, addressForBlock);
+            setTextIfChanged(blockTextItem, text);
+            const QVariant addressData = blockTextItem->data(Qt::UserRole);
+            if (!addressData.isValid() || addressData.toUInt() != addressForBlock) {
+                blockTextItem->setToolTip("Address: " + encodeRadixValue(addressForBlock, Radix::Hex));
+                // Store the address within the userrole of the block text. Doing this, we are able to easily retrieve
+                // the address for the block if the block is clicked.
+                blockTextItem->setData(Qt::UserRole, addressForBlock);
+            }
         }
     } else {
         // The way is invalid so no block text should be present
@@ -99,16 +127,16 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
 
     // =========================== Update dirty field =========================
     if (way.dirty) {
-        way.dirty->setText(QString::number(simWay.dirty));
+        setTextIfChanged(way.dirty.get(), QString::number(simLine.dirty(wayIdx)));
     }
 
     // =========================== Update valid field =========================
     if (way.valid) {
-        way.valid->setText(QString::number(simWay.valid));
+        setTextIfChanged(way.valid.get(), QString::number(simValid));
     }
 
     // ============================ Update tag field ==========================
-    if (simWay.valid) {
+    if (simValid) {
         QGraphicsSimpleTextItem* tagTextItem = way.tag.get();
         if (tagTextItem == nullptr) {
             const qreal x = m_widthBeforeTag + (m_tagWidth / 2 - m_fm.width("0x00000000") / 2);
@@ -116,8 +144,8 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
             way.tag = createGraphicsTextItemSP(x, y);
             tagTextItem = way.tag.get();
         }
-        const QString tagText = encodeRadixValue(simWay.tag, Radix::Hex);
-        tagTextItem->setText(tagText);
+        const QString tagText = encodeRadixValue(simLine.tag(wayIdx), Radix::Hex);
+        setTextIfChanged(tagTextItem, tagText);
     } else {
         // The way is invalid so no tag text should be present
         if (way.tag) {
@@ -127,11 +155,19 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
 
     // ==================== Update dirty blocks highlighting ==================
     const std::set<unsigned> graphicDirtyBlocks = keys(way.dirtyBlocks);
+    std::set<unsigned> simDirtyBlocks;
+    if (simLine.dirty(wayIdx)) {
+        for (int i = 0; i < m_cache.getBlocks(); i++) {
+            if (simLine.isDirtyBlock(wayIdx, i)) {
+                simDirtyBlocks.insert(i);
+            }
+        }
+    }
     std::set<unsigned> newDirtyBlocks;
     std::set<unsigned> dirtyBlocksToDelete;
-    std::set_difference(graphicDirtyBlocks.begin(), graphicDirtyBlocks.end(), simWay.dirtyBlocks.begin(),
-                        simWay.dirtyBlocks.end(), std::inserter(dirtyBlocksToDelete, dirtyBlocksToDelete.begin()));
-    std::set_difference(simWay.dirtyBlocks.begin(), simWay.dirtyBlocks.end(), graphicDirtyBlocks.begin(),
+    std::set_difference(graphicDirtyBlocks.begin(), graphicDirtyBlocks.end(), simDirtyBlocks.begin(),
+                        simDirtyBlocks.end(), std::inserter(dirtyBlocksToDelete, dirtyBlocksToDelete.begin()));
+    std::set_difference(simDirtyBlocks.begin(), simDirtyBlocks.end(), graphicDirtyBlocks.begin(),
                         graphicDirtyBlocks.end(), std::inserter(newDirtyBlocks, newDirtyBlocks.begin()));
 
     // Delete blocks which are not in sync with the current dirty status of the way
@@ -170,28 +206,82 @@ std::unique_ptr<QGraphicsSimpleTextItem> CacheGraphic::createGraphicsTextItemSP(
 }
 
 void CacheGraphic::cacheInvalidated() {
-    for (int lineIdx = 0; lineIdx < m_cache.getLines(); lineIdx++) {
-        if (const auto* line = m_cache.getLine(lineIdx)) {
-            for (const auto& way : *line) {
-                updateWay(lineIdx, way.first);
+    m_cacheDirty = true;
+    m_dirtyWays.clear();
+    scheduleFlush();
+}
+
+void CacheGraphic::wayInvalidated(unsigned lineIdx, unsigned wayIdx) {
+    if (m_suspended) {
+        // Rather than tracking every way changed while suspended, all materialized lines are refreshed once resumed
+        m_cacheDirty = true;
+        m_dirtyWays.clear();
+    } else if (!m_cacheDirty) {
+        m_dirtyWays.insert({lineIdx, wayIdx});
+    }
+    scheduleFlush();
+}
+
+void CacheGraphic::scheduleFlush() {
+    if (!m_suspended && !m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void CacheGraphic::setSuspended(bool suspended) {
+    m_suspended = suspended;
+    if (suspended) {
+        m_flushTimer.stop();
+    } else {
+        flush();
+    }
+}
+
+void CacheGraphic::flush() {
+    if (m_cacheDirty) {
+        for (const auto& line : m_cacheTextItems) {
+            for (int wayIdx = 0; wayIdx < m_cache.getWays(); wayIdx++) {
+                updateWay(line.first, wayIdx);
+            }
+            updateLineReplFields(line.first);
+        }
+        invalidateHeatmap();
+    } else if (!m_dirtyWays.empty()) {
+        // The set is ordered by line, such that the replacement fields of each line are updated once
+        for (auto it = m_dirtyWays.begin(); it != m_dirtyWays.end(); ++it) {
+            updateWay(it->first, it->second);
+            if (std::next(it) == m_dirtyWays.end() || std::next(it)->first != it->first) {
+                updateLineReplFields(it->first);
             }
-            updateLineReplFields(lineIdx);
         }
+        invalidateHeatmap();
+    }
+    m_cacheDirty = false;
+    m_dirtyWays.clear();
+
+    if (m_highlightDirty) {
+        updateHighlighting(m_highlightedTransaction.has_value(),
+                           m_highlightedTransaction ? &*m_highlightedTransaction : nullptr);
+        m_highlightDirty = false;
     }
 }
 
-void CacheGraphic::wayInvalidated(unsigned lineIdx, unsigned wayIdx) {
-    updateWay(lineIdx, wayIdx);
-    updateLineReplFields(lineIdx);
+void CacheGraphic::invalidateHeatmap() {
+    m_heatmapDirty = true;
+    if (m_heatmap) {
+        update();
+    }
 }
 
 void CacheGraphic::dataChanged(const CacheSim::CacheTransaction* transaction) {
     if (transaction != nullptr) {
         wayInvalidated(transaction->index.line, transaction->index.way);
-        updateHighlighting(true, transaction);
+        m_highlightedTransaction = *transaction;
     } else {
-        updateHighlighting(false, nullptr);
+        m_highlightedTransaction.reset();
     }
+    m_highlightDirty = true;
+    scheduleFlush();
 }
 
 QGraphicsSimpleTextItem* CacheGraphic::drawText(const QString& text, qreal x, qreal y) {
@@ -243,43 +333,178 @@ void CacheGraphic::updateHighlighting(bool active, const CacheSim::CacheTransact
     }
 }
 
-void CacheGraphic::initializeControlBits() {
-    for (int lineIdx = 0; lineIdx < m_cache.getLines(); lineIdx++) {
-        auto& line = m_cacheTextItems[lineIdx];
-        for (int setIdx = 0; setIdx < m_cache.getWays(); setIdx++) {
-            const qreal y = lineIdx * m_lineHeight + setIdx * m_setHeight;
-            qreal x;
-
-            // Create valid field
-            x = m_bitWidth / 2 - m_fm.width("0") / 2;
-            line[setIdx].valid = drawText("0", x, y);
-
-            if (m_cache.getWritePolicy() == CacheSim::WritePolicy::WriteBack) {
-                // Create dirty bit field
-                x = m_widthBeforeDirty + m_bitWidth / 2 - m_fm.width("0") / 2;
-                line[setIdx].dirty = drawText("0", x, y);
+void CacheGraphic::initializeControlBits(unsigned lineIdx) {
+    auto& line = m_cacheTextItems[lineIdx].ways;
+    for (int setIdx = 0; setIdx < m_cache.getWays(); setIdx++) {
+        const qreal y = lineIdx * m_lineHeight + setIdx * m_setHeight;
+        qreal x;
+
+        // Create valid field
+        x = m_bitWidth / 2 - m_fm.width("0") / 2;
+        line[setIdx].valid = createGraphicsTextItemSP(x, y);
+        line[setIdx].valid->setText("0");
+
+        if (m_cache.getWritePolicy() == CacheSim::WritePolicy::WriteBack) {
+            // Create dirty bit field
+            x = m_widthBeforeDirty + m_bitWidth / 2 - m_fm.width("0") / 2;
+            line[setIdx].dirty = createGraphicsTextItemSP(x, y);
+            line[setIdx].dirty->setText("0");
+        }
+
+        if (m_cache.getReplacementPolicy() == CacheSim::ReplPolicy::LRU && m_cache.getWays() > 1) {
+            // Create LRU field
+            const QString lruText = QString::number(m_cache.getWays() - 1);
+            x = m_widthBeforeLRU + m_lruWidth / 2 - m_fm.width(lruText) / 2;
+            line[setIdx].lru = createGraphicsTextItemSP(x, y);
+            line[setIdx].lru->setText(lruText);
+        }
+    }
+}
+
+void CacheGraphic::materializeLine(unsigned lineIdx) {
+    auto& decorations = m_cacheTextItems[lineIdx].decorations;
+
+    // Draw the top border of the line, and the rows between its sets
+    qreal verticalAdvance = lineIdx * m_lineHeight;
+    decorations.emplace_back(
+        std::make_unique<QGraphicsLineItem>(0, verticalAdvance, m_cacheWidth, verticalAdvance, this));
+    for (int j = 1; j < m_cache.getWays(); j++) {
+        verticalAdvance += m_setHeight;
+        auto setLine = std::make_unique<QGraphicsLineItem>(0, verticalAdvance, m_cacheWidth, verticalAdvance, this);
+        auto pen = setLine->pen();
+        pen.setStyle(Qt::DashLine);
+        setLine->setPen(pen);
+        decorations.emplace_back(std::move(setLine));
+    }
+
+    // Draw line index number
+    const QString text = QString::number(lineIdx);
+    const qreal y = lineIdx * m_lineHeight + m_lineHeight / 2 - m_setHeight / 2;
+    const qreal x = -m_fm.width(text) * 1.2;
+    decorations.emplace_back(createGraphicsTextItemSP(x, y));
+    static_cast<QGraphicsSimpleTextItem*>(decorations.back().get())->setText(text);
+
+    initializeControlBits(lineIdx);
+    for (int wayIdx = 0; wayIdx < m_cache.getWays(); wayIdx++) {
+        updateWay(lineIdx, wayIdx);
+    }
+    updateLineReplFields(lineIdx);
+}
+
+void CacheGraphic::setVisibleRect(const QRectF& rect) {
+    m_visibleRect = rect;
+    updateMaterializedLines();
+}
+
+void CacheGraphic::updateMaterializedLines() {
+    const unsigned lines = m_cache.getLines();
+    const unsigned ways = m_cache.getWays();
+    unsigned firstLine = 0;
+    unsigned endLine = lines;
+    bool heatmap = false;
+
+    if (lines * ways > s_maxVisibleRows) {
+        if (m_visibleRect.isEmpty()) {
+            // The view has not yet reported what is visible; materialize the top of the cache
+            endLine = std::min(lines, std::max(1u, s_maxVisibleRows / ways));
+        } else {
+            heatmap = m_visibleRect.height() / m_setHeight > s_maxVisibleRows;
+            const qreal top = std::clamp(m_visibleRect.top(), qreal(0), m_cacheHeight);
+            const qreal bottom = std::clamp(m_visibleRect.bottom(), qreal(0), m_cacheHeight);
+            const unsigned firstVisible = std::min(lines, static_cast<unsigned>(std::floor(top / m_lineHeight)));
+            const unsigned endVisible = std::min(lines, static_cast<unsigned>(std::ceil(bottom / m_lineHeight)));
+            if (heatmap) {
+                firstLine = endLine = 0;
+            } else if (!m_heatmap && m_firstLine < m_endLine && m_firstLine <= firstVisible &&
+                       endVisible <= m_endLine) {
+                // The visible lines are still materialized; avoid churning items on every scroll step
+                return;
+            } else {
+                // Materialize a screenful of lines on either side of the visible lines
+                const unsigned margin = endVisible - firstVisible + 1;
+                firstLine = firstVisible > margin ? firstVisible - margin : 0;
+                endLine = std::min(lines, endVisible + margin);
             }
+        }
+    }
 
-            if (m_cache.getReplacementPolicy() == CacheSim::ReplPolicy::LRU && m_cache.getWays() > 1) {
-                // Create LRU field
-                const QString lruText = QString::number(m_cache.getWays() - 1);
-                x = m_widthBeforeLRU + m_lruWidth / 2 - m_fm.width(lruText) / 2;
-                line[setIdx].lru = drawText(lruText, x, y);
+    if (heatmap != m_heatmap) {
+        m_heatmap = heatmap;
+        m_heatmapDirty = true;
+        update();
+    }
+
+    for (auto it = m_cacheTextItems.begin(); it != m_cacheTextItems.end();) {
+        if (it->first < firstLine || it->first >= endLine) {
+            it = m_cacheTextItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (unsigned lineIdx = firstLine; lineIdx < endLine; lineIdx++) {
+        if (m_cacheTextItems.count(lineIdx) == 0) {
+            materializeLine(lineIdx);
+        }
+    }
+    m_firstLine = firstLine;
+    m_endLine = endLine;
+}
+
+void CacheGraphic::updateHeatmap() {
+    const unsigned lines = m_cache.getLines();
+    const unsigned ways = m_cache.getWays();
+    m_occupancyImage = QImage(1, lines * ways, QImage::Format_RGB32);
+    m_hitImage = QImage(1, lines, QImage::Format_RGB32);
+
+    for (unsigned lineIdx = 0; lineIdx < lines; lineIdx++) {
+        const auto simLine = m_cache.getLine(lineIdx);
+        for (unsigned wayIdx = 0; wayIdx < ways; wayIdx++) {
+            QRgb color = QColor(Qt::white).rgb();
+            if (simLine.dirty(wayIdx)) {
+                color = QColor(Qt::darkCyan).rgb();
+            } else if (simLine.valid(wayIdx)) {
+                color = QColor(Qt::lightGray).rgb();
             }
+            m_occupancyImage.setPixel(0, lineIdx * ways + wayIdx, color);
         }
+
+        // Hue from red (all misses) to green (all hits); lines which were never accessed are left blank
+        const uint64_t hits = m_cache.getLineHits(lineIdx);
+        const uint64_t accesses = hits + m_cache.getLineMisses(lineIdx);
+        const QColor hitColor = accesses == 0 ? QColor(Qt::white)
+                                              : QColor::fromHsvF(static_cast<double>(hits) / accesses / 3, 0.8, 0.9);
+        m_hitImage.setPixel(0, lineIdx, hitColor.rgb());
+    }
+    m_heatmapDirty = false;
+}
+
+void CacheGraphic::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) {
+    // Text items are painted by themselves; only the heatmap is painted by the graphic
+    if (!m_heatmap) {
+        return;
+    }
+    if (m_heatmapDirty) {
+        updateHeatmap();
     }
+    painter->drawImage(QRectF(0, 0, m_widthBeforeTag, m_cacheHeight), m_hitImage);
+    painter->drawImage(QRectF(m_widthBeforeTag, 0, m_cacheWidth - m_widthBeforeTag, m_cacheHeight), m_occupancyImage);
 }
 
 QRectF CacheGraphic::boundingRect() const {
-    // We do not paint anything in Cachegraphic; only instantiate other QGraphicsItem-derived objects. So just return
-    // the bounding rect of child items
-    return childrenBoundingRect();
+    return m_boundingRect;
 }
 
 void CacheGraphic::cacheParametersChanged() {
     // Remove all items
     m_highlightingItems.clear();
     m_cacheTextItems.clear();
+    m_firstLine = m_endLine = 0;
+    // The graphic is rebuilt from the current state of the cache
+    m_flushTimer.stop();
+    m_cacheDirty = false;
+    m_dirtyWays.clear();
+    m_highlightDirty = false;
+    m_highlightedTransaction.reset();
     for (const auto& item : childItems())
         delete item;
 
@@ -345,38 +570,23 @@ void CacheGraphic::cacheParametersChanged() {
 
     m_cacheWidth = width;
 
-    // Draw cache line rows
-    for (int i = 0; i <= m_cache.getLines(); i++) {
-        qreal verticalAdvance = i * m_lineHeight;
-        new QGraphicsLineItem(0, verticalAdvance, m_cacheWidth, verticalAdvance, this);
-
-        if (i < m_cache.getLines()) {
-            // Draw cache set rows
-            for (int j = 1; j < m_cache.getWays(); j++) {
-                verticalAdvance += m_setHeight;
-                auto* setLine = new QGraphicsLineItem(0, verticalAdvance, m_cacheWidth, verticalAdvance, this);
-                auto pen = setLine->pen();
-                pen.setStyle(Qt::DashLine);
-                setLine->setPen(pen);
-            }
-        }
-    }
-
-    // Draw line index numbers
-    for (int i = 0; i < m_cache.getLines(); i++) {
-        const QString text = QString::number(i);
-
-        const qreal y = i * m_lineHeight + m_lineHeight / 2 - m_setHeight / 2;
-        const qreal x = -m_fm.width(text) * 1.2;
-        drawText(text, x, y);
-    }
+    // Draw the bottom border of the cache. The rows of each line are drawn when the line is materialized.
+    new QGraphicsLineItem(0, m_cacheHeight, m_cacheWidth, m_cacheHeight, this);
 
     // Draw index column text
     const QString indexText = "Index";
     const qreal x = -m_fm.width(indexText) * 1.2;
     drawText(indexText, x, -m_fm.height());
 
-    initializeControlBits();
+    // The extent of the graphic is independent of which lines are materialized, such that the scene (and the scroll
+    // range of the view) covers the entire cache
+    prepareGeometryChange();
+    const qreal indexWidth = m_fm.width(QString::number(m_cache.getLines() - 1)) * 1.2;
+    m_boundingRect = childrenBoundingRect().united(QRectF(-indexWidth, 0, m_cacheWidth + indexWidth, m_cacheHeight));
+
+    m_heatmap = false;
+    m_heatmapDirty = true;
+    updateMaterializedLines();
 }
 
 }  // namespace Ripes
@@ -3,19 +3,36 @@
 #include <QFont>
 #include <QFontMetrics>
 #include <QGraphicsItem>
+#include <QImage>
 #include <QObject>
+#include <QTimer>
 #include <memory>
+#include <optional>
+#include <set>
 #include "cachesim.h"
 
 namespace Ripes {
 
+/**
+ * @brief The CacheGraphic class
+ * Graphical view of the contents of a cache. Text items are only materialized for the lines around the visible part
+ * of the view (see setVisibleRect), such that the number of items is bounded regardless of the size of the cache.
+ * When more than s_maxVisibleRows ways are visible, the text is too small to be read, and the cache is instead painted
+ * as a heatmap of the occupancy of each way, next to the hit ratio of each line.
+ * Changes signalled by the cache simulator are coalesced, and applied to the graphic at most once per
+ * s_flushInterval.
+ */
 class CacheGraphic : public QGraphicsObject {
 public:
     CacheGraphic(CacheSim& cache);
 
     QRectF boundingRect() const override;
 
-    void paint(QPainter*, const QStyleOptionGraphicsItem*, QWidget* = nullptr) override {}
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget* = nullptr) override;
+
+    static constexpr unsigned s_maxVisibleRows = 256;
+    // Interval in milliseconds at which changes to the cache are applied to the graphic; about one frame
+    static constexpr int s_flushInterval = 16;
 
 public slots:
     /**
@@ -46,6 +63,20 @@ public slots:
 
     void reset();
 
+    /**
+     * @brief setVisibleRect
+     * Sets the part of the graphic which is visible in the view, in item coordinates, and materializes the text items
+     * of the lines around it.
+     */
+    void setVisibleRect(const QRectF& rect);
+
+    /**
+     * @brief setSuspended
+     * While suspended, such as while the view of the graphic is hidden, changes to the cache are not applied to the
+     * graphic; the graphic is instead refreshed once it is resumed.
+     */
+    void setSuspended(bool suspended);
+
 private:
     // Data structure modelling the cache; keeping graphics text items for each entry
     // All text items which are not always present are stored as unqiue_ptr's to facilitate easy deletion when undoing
@@ -53,19 +84,42 @@ private:
     struct CacheWay {
         std::map<unsigned, std::unique_ptr<QGraphicsSimpleTextItem>> blocks;
         std::unique_ptr<QGraphicsSimpleTextItem> tag = nullptr;
-        QGraphicsSimpleTextItem* lru = nullptr;
-        QGraphicsSimpleTextItem* valid = nullptr;
-        QGraphicsSimpleTextItem* dirty = nullptr;
+        std::unique_ptr<QGraphicsSimpleTextItem> lru = nullptr;
+        std::unique_ptr<QGraphicsSimpleTextItem> valid = nullptr;
+        std::unique_ptr<QGraphicsSimpleTextItem> dirty = nullptr;
         std::map<unsigned, std::unique_ptr<QGraphicsRectItem>> dirtyBlocks;
     };
 
-    using CacheLine = std::map<unsigned, CacheWay>;
+    struct CacheLine {
+        std::map<unsigned, CacheWay> ways;
+        // Row separators and index number of the line
+        std::vector<std::unique_ptr<QGraphicsItem>> decorations;
+    };
 
     /**
      * @brief initializeControlBits
-     * Constructs all of the "Valid" and "LRU" text items within the cache
+     * Constructs all of the "Valid" and "LRU" text items within line @p lineIdx
+     */
+    void initializeControlBits(unsigned lineIdx);
+    /// Constructs all text items and row separators of line @p lineIdx, reflecting the current state of the cache
+    void materializeLine(unsigned lineIdx);
+    /**
+     * @brief updateMaterializedLines
+     * Materializes the lines around the visible rect, and destroys the items of all other lines. Switches to heatmap
+     * rendering if too many ways are visible.
+     */
+    void updateMaterializedLines();
+    /// Redraws the heatmap images from the current state of the cache
+    void updateHeatmap();
+    /// Marks the heatmap as out of sync with the cache, repainting it if currently shown
+    void invalidateHeatmap();
+    /// Starts the flush timer, if not already pending
+    void scheduleFlush();
+    /**
+     * @brief flush
+     * Applies all changes to the cache which were signalled since the last flush to the graphic.
      */
-    void initializeControlBits();
+    void flush();
     void updateHighlighting(bool active, const CacheSim::CacheTransaction* transaction);
     QGraphicsSimpleTextItem* drawText(const QString& text, qreal x, qreal y);
     QGraphicsSimpleTextItem* tryCreateGraphicsTextItem(QGraphicsSimpleTextItem** item, qreal x, qreal y);
@@ -95,6 +149,27 @@ private:
     qreal m_widthBeforeLRU = 0;
     qreal m_widthBeforeDirty = 0;
     qreal m_lruWidth = 0;
+    QRectF m_boundingRect;
+
+    // Visible part of the graphic, and the range of lines [m_firstLine; m_endLine) currently materialized
+    QRectF m_visibleRect;
+    unsigned m_firstLine = 0;
+    unsigned m_endLine = 0;
+
+    // Heatmap rendering; one pixel per way of the occupancy of the ways, and one pixel per line of its hit ratio
+    bool m_heatmap = false;
+    bool m_heatmapDirty = true;
+    QImage m_occupancyImage;
+    QImage m_hitImage;
+
+    // Changes to the cache pending the next flush; either the entire cache, or a set of (line, way) pairs, and the
+    // transaction (if any) to highlight
+    QTimer m_flushTimer;
+    bool m_cacheDirty = false;
+    std::set<std::pair<unsigned, unsigned>> m_dirtyWays;
+    bool m_highlightDirty = false;
+    std::optional<CacheSim::CacheTransaction> m_highlightedTransaction;
+    bool m_suspended = false;
 
     /**
      * @brief m_cacheTextItems
@@ -102,8 +177,8 @@ private:
      * This object models the hierarchy of the cache, and stores all currently initialized text items for the cache.
      * The object is indexed similarly to how the cache simulator is indexed. As such, a cache transaction is used to
      * traverse the object.
-     * All items are lazily initialized in calls to dataChanged(). This prevents initializing a ton of items if a user
-     * has created a very large cache.
+     * All items are lazily initialized in calls to dataChanged(), and only exist for the lines in
+     * [m_firstLine; m_endLine). This prevents initializing a ton of items if a user has created a very large cache.
      */
     std::map<unsigned, CacheLine> m_cacheTextItems;
 };
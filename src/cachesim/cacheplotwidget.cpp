@@ -2,13 +2,19 @@
 #include "ui_cacheplotwidget.h"
 
 #include <QClipboard>
+#include <QFile>
 #include <QFileDialog>
+#include <QMessageBox>
+#include <QTimer>
 #include <QToolBar>
+#include <QtConcurrent/QtConcurrent>
 #include <QtCharts/QAreaSeries>
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
+#include <algorithm>
 
+#include "cachestatisticsexport.h"
 #include "enumcombobox.h"
 #include "processorhandler.h"
 
@@ -18,42 +24,94 @@ namespace {
 
 /**
  * @brief stepifySeries
- * Adds additional points to a QLineSeries, effectively transforming it into a step plot to avoid the default point
+ * Adds additional points to @p series, effectively transforming it into a step plot to avoid the default point
  * interpolation of a QLineSeries.
- * We create a new pointsVector, preallocate the known final size and finally exchange the points. This is a lot faster
- * than individually inseting points into the series, which each will trigger events within the QLineSeries.
+ * The points are prepared ahead of the QLineSeries and exchanged into it at once, which is a lot faster than
+ * individually inserting points into the series, which each will trigger events within the QLineSeries.
  */
-void stepifySeries(QLineSeries& series) {
-    if (series.count() == 0)
-        return;
+QVector<QPointF> stepifySeries(const QVector<QPointF>& series) {
+    if (series.isEmpty())
+        return series;
 
     QVector<QPointF> points;
-    points.reserve(series.count() * 2);
+    points.reserve(series.size() * 2);
 
     points << series.at(0);  // No stepping is done for the first point
-    for (int i = 1; i < series.count(); i++) {
+    for (int i = 1; i < series.size(); i++) {
         const QPointF& stepFrom = series.at(i - 1);
         const QPointF& stepTo = series.at(i);
         QPointF interPoint = stepFrom;
         interPoint.setX(stepTo.x());
         points << interPoint << stepTo;
     }
+    return points;
+}
 
-    series.replace(points);
+/**
+ * @brief downsampleSeries
+ * Level-of-detail reduction of @p points, in order of x, to the first, minimum, maximum and last point of each of
+ * @p buckets equally wide buckets over [@p first; @p last], in order of x. This retains the envelope of the series at
+ * the resolution of the buckets, whilst bounding the number of points regardless of the length of the access trace.
+ */
+QVector<QPointF> downsampleSeries(const QVector<QPointF>& points, qreal first, qreal last, unsigned buckets) {
+    if (points.size() <= static_cast<int>(buckets) * 4) {
+        return points;
+    }
+
+    const qreal width = last > first ? (last - first) / buckets : 1;
+    const auto bucketOf = [&](const QPointF& point) {
+        const qreal bucket = (point.x() - first) / width;
+        return bucket < 0 ? 0 : std::min(static_cast<unsigned>(bucket), buckets - 1);
+    };
+
+    QVector<QPointF> downsampled;
+    downsampled.reserve(buckets * 4);
+    int begin = 0;
+    while (begin < points.size()) {
+        const unsigned bucket = bucketOf(points[begin]);
+        int end = begin + 1;
+        int minIdx = begin;
+        int maxIdx = begin;
+        for (; end < points.size() && bucketOf(points[end]) == bucket; end++) {
+            minIdx = points[end].y() < points[minIdx].y() ? end : minIdx;
+            maxIdx = points[end].y() > points[maxIdx].y() ? end : maxIdx;
+        }
+        // Emit the retained points of the bucket in order of x, without duplicates
+        int indices[] = {begin, std::min(minIdx, maxIdx), std::max(minIdx, maxIdx), end - 1};
+        int previous = -1;
+        for (const int idx : indices) {
+            if (idx != previous) {
+                downsampled << points[idx];
+                previous = idx;
+            }
+        }
+        begin = end;
+    }
+    return downsampled;
+}
+
+/**
+ * @brief currentCycles
+ * @returns the number of cycles executed by the processor. Whilst running, these are read from the published run
+ * statistics of the processor handler.
+ */
+uint64_t currentCycles() {
+    auto* handler = Ripes::ProcessorHandler::get();
+    return handler->isRunning() ? handler->getRunStatistics().cycles : handler->getProcessor()->getCycleCount();
 }
 
 /**
  * @brief finishSeries
  * Adds an additional point at x value @p max with an equal value of the last value in the series.
  */
-void finishSeries(QLineSeries& series, const unsigned max) {
-    if (series.count() == 0) {
+void finishSeries(QVector<QPointF>& series, const unsigned max) {
+    if (series.isEmpty()) {
         return;
     }
 
-    const QPointF lastPoint = series.at(series.count() - 1);
+    const QPointF lastPoint = series.last();
     if (lastPoint.toPoint().x() != max) {
-        series.append(max, lastPoint.y());
+        series.append(QPointF(max, lastPoint.y()));
     }
 }
 
@@ -84,9 +142,8 @@ CachePlotWidget::CachePlotWidget(const CacheSim& sim, QWidget* parent)
     connect(m_ui->den, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CachePlotWidget::variablesChanged);
     connect(m_ui->stackedVariables, &QListWidget::itemChanged, this, &CachePlotWidget::variablesChanged);
 
-    const auto& accessTrace = m_cache.getAccessTrace();
     m_ui->rangeMin->setValue(0);
-    m_ui->rangeMax->setValue(ProcessorHandler::get()->getProcessor()->getCycleCount());
+    m_ui->rangeMax->setValue(currentCycles());
 
     connect(m_ui->rangeMin, QOverload<int>::of(&QSpinBox::valueChanged), this, &CachePlotWidget::rangeChanged);
     connect(m_ui->rangeMax, QOverload<int>::of(&QSpinBox::valueChanged), this, &CachePlotWidget::rangeChanged);
@@ -94,10 +151,20 @@ CachePlotWidget::CachePlotWidget(const CacheSim& sim, QWidget* parent)
     connect(m_ui->plotType, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
             &CachePlotWidget::plotTypeChanged);
 
+    // The cache does not signal changes while the processor is running; its live statistics are polled instead
+    m_liveUpdateTimer = new QTimer(this);
+    m_liveUpdateTimer->setInterval(s_liveUpdateInterval);
+    connect(m_liveUpdateTimer, &QTimer::timeout, this, &CachePlotWidget::appendLiveData);
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, this, &CachePlotWidget::runStarted);
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, this, &CachePlotWidget::runFinished);
+    connect(&m_plotWatcher, &QFutureWatcher<PlotData>::finished, this, &CachePlotWidget::plotDataPrepared);
+
     // Synchronize widget state
+    updateRangeLimits();
     plotTypeChanged();
-    variablesChanged();
-    rangeChanged();
+    if (ProcessorHandler::get()->isRunning()) {
+        runStarted();
+    }
 }
 
 CachePlotWidget::~CachePlotWidget() {
@@ -130,6 +197,12 @@ void CachePlotWidget::setupToolbar() {
     m_toolbar->addAction(m_copyDataAction);
     connect(m_copyDataAction, &QAction::triggered, this, &CachePlotWidget::copyPlotDataToClipboard);
 
+    const QIcon exportIcon = QIcon(":/icons/spreadsheet.svg");
+    m_exportDataAction = new QAction("Export statistics to file", this);
+    m_exportDataAction->setIcon(exportIcon);
+    m_toolbar->addAction(m_exportDataAction);
+    connect(m_exportDataAction, &QAction::triggered, this, &CachePlotWidget::exportStatistics);
+
     const QIcon saveIcon = QIcon(":/icons/saveas.svg");
     m_savePlotAction = new QAction("Save plot to file", this);
     m_savePlotAction->setIcon(saveIcon);
@@ -144,6 +217,8 @@ void CachePlotWidget::plotTypeChanged() {
         m_ui->configWidget->setCurrentWidget(m_ui->ratioConfigPage);
     } else if (m_plotType == PlotType::Stacked) {
         m_ui->configWidget->setCurrentWidget(m_ui->stackedConfigPage);
+    } else if (m_plotType == PlotType::MissRatioCurves) {
+        m_ui->configWidget->setCurrentWidget(m_ui->missRatioConfigPage);
     } else {
         Q_ASSERT(false);
     }
@@ -164,22 +239,26 @@ void CachePlotWidget::copyPlotDataToClipboard() const {
     for (int i = 0; i < N_Variables; i++) {
         allVariables.push_back(static_cast<Variable>(i));
     }
-    const auto& allData = gatherData(allVariables);
+    // Copied data is not downsampled
+    const auto& allData =
+        gatherData(plotRequest(allVariables, 0, ProcessorHandler::get()->getProcessor()->getCycleCount()));
 
-    std::map<unsigned /*cycle*/, QStringList> dataStrings;
+    std::map<qulonglong /*cycle*/, QStringList> dataStrings;
     QStringList header;
 
     // Write cycles
     header << "cycle";
     for (const auto& dataPoint : allData.begin()->second) {
-        dataStrings[dataPoint.x()] << QString::number(dataPoint.x());
+        const auto cycle = static_cast<qulonglong>(dataPoint.x());
+        dataStrings[cycle] << QString::number(cycle);
     }
 
     // Write variables
     for (const auto& variableData : allData) {
         header << s_cacheVariableStrings.at(variableData.first);
         for (const auto& dataPoint : variableData.second) {
-            dataStrings[dataPoint.x()] << QString::number(dataPoint.y());
+            const auto cycle = static_cast<qulonglong>(dataPoint.x());
+            dataStrings[cycle] << QString::number(static_cast<qulonglong>(dataPoint.y()));
         }
     }
 
@@ -194,14 +273,150 @@ void CachePlotWidget::copyPlotDataToClipboard() const {
     QApplication::clipboard()->setText(outString);
 }
 
+void CachePlotWidget::exportStatistics() {
+    const QString csvFilter = "CSV files (*.csv)";
+    const QString columnarFilter = "Columnar binary files (*.bin)";
+    QString selectedFilter;
+    const QString filename =
+        QFileDialog::getSaveFileName(this, "Export statistics", "", csvFilter + ";;" + columnarFilter, &selectedFilter);
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    QFile file(filename);
+    const auto format =
+        selectedFilter == columnarFilter ? CacheStatisticsFormat::Columnar : CacheStatisticsFormat::CSV;
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        !exportCacheStatistics(m_cache.getAccessTrace(), 0, currentCycles(), format, file)) {
+        QMessageBox::warning(this, "Export statistics", "Could not write to " + filename);
+    }
+}
+
 void CachePlotWidget::rangeChanged() {
-    if (m_currentPlot) {
-        m_currentPlot->axes(Qt::Horizontal).first()->setRange(m_ui->rangeMin->value(), m_ui->rangeMax->value());
+    updateRangeLimits();
+    // Plots are downsampled as per the visible range, and are thus replotted. The cycle range does not apply to miss
+    // ratio curves, which are plotted against the associativity.
+    if (m_plotType != PlotType::MissRatioCurves) {
+        variablesChanged();
+    }
+}
+
+void CachePlotWidget::runStarted() {
+    m_liveUpdateTimer->start();
+    // The access trace is modified whilst running
+    m_exportDataAction->setEnabled(false);
+}
+
+void CachePlotWidget::runFinished() {
+    m_liveUpdateTimer->stop();
+    m_exportDataAction->setEnabled(true);
+    // Replot the run from the access trace, following the end of the run if the range did so
+    const bool following = m_ui->rangeMax->value() == m_ui->rangeMax->maximum();
+    updateRangeLimits();
+    if (following) {
+        const QSignalBlocker blocker(m_ui->rangeMax);
+        m_ui->rangeMax->setValue(m_ui->rangeMax->maximum());
+        m_ui->rangeMin->setMaximum(m_ui->rangeMax->value());
+    }
+    variablesChanged();
+}
+
+std::vector<qreal> CachePlotWidget::liveValues(const CacheSim::CacheAccessTrace& stats) const {
+    const auto vars = gatherVariables();
+    std::vector<qreal> values;
+    if (m_plotType == PlotType::Ratio) {
+        const qreal den = variableValue(vars[1], stats);
+        values.push_back(den == 0 ? 0 : variableValue(vars[0], stats) / den * 100);
+    } else if (m_plotType == PlotType::Stacked) {
+        // Series are stacked in order of variables, as per preparePlotData
+        qreal y = 0;
+        for (const auto& variable : std::set<Variable>(vars.begin(), vars.end())) {
+            y += variableValue(variable, stats);
+            values.push_back(y);
+        }
     }
+    return values;
+}
 
-    // Update allowed ranges
-    const auto& accessTrace = m_cache.getAccessTrace();
-    const unsigned cycles = ProcessorHandler::get()->getProcessor()->getCycleCount();
+void CachePlotWidget::appendLiveData() {
+    const std::vector<qreal> values = liveValues(m_cache.getLiveStatistics());
+    if (!m_currentPlot || values.empty() || values.size() != m_liveSeries.size()) {
+        // No plot of the current variables
+        return;
+    }
+
+    const qreal x = currentCycles();
+    auto* axisX = qobject_cast<QValueAxis*>(m_currentPlot->axes(Qt::Horizontal).first());
+    auto* axisY = qobject_cast<QValueAxis*>(m_currentPlot->axes(Qt::Vertical).first());
+    for (unsigned i = 0; i < values.size(); i++) {
+        QLineSeries* series = m_liveSeries[i];
+        if (series->count() != 0) {
+            const QPointF last = series->at(series->count() - 1);
+            if (x <= last.x()) {
+                continue;
+            }
+            // Step from the previous value
+            series->append(x, last.y());
+        }
+        series->append(x, values[i]);
+        if (values[i] > axisY->max()) {
+            axisY->setMax(values[i] * 1.1);
+        }
+    }
+
+    if (m_ui->rangeMax->value() == m_ui->rangeMax->maximum()) {
+        // The plotted range follows the end of the run
+        const QSignalBlocker blocker(m_ui->rangeMax);
+        m_ui->rangeMax->setMaximum(static_cast<int>(x));
+        m_ui->rangeMax->setValue(static_cast<int>(x));
+        m_ui->rangeMin->setMaximum(static_cast<int>(x));
+        axisX->setMax(x);
+    }
+}
+
+qreal CachePlotWidget::variableValue(Variable variable, const CacheSim::CacheAccessTrace& entry) {
+    switch (variable) {
+        case Variable::Writes:
+            return entry.writes;
+        case Variable::Reads:
+            return entry.reads;
+        case Variable::Hits:
+            return entry.hits;
+        case Variable::Misses:
+            return entry.misses;
+        case Variable::Writebacks:
+            return entry.writebacks;
+        case Variable::Accesses:
+            return entry.hits + entry.misses;
+        case Variable::Prefetches:
+            return entry.prefetches;
+        case Variable::UsefulPrefetches:
+            return entry.usefulPrefetches;
+        case Variable::LatePrefetches:
+            return entry.latePrefetches;
+        case Variable::PollutingPrefetches:
+            return entry.pollutingPrefetches;
+        case Variable::CompulsoryMisses:
+            return entry.compulsoryMisses;
+        case Variable::CapacityMisses:
+            return entry.capacityMisses;
+        case Variable::ConflictMisses:
+            return entry.conflictMisses;
+        case Variable::VictimHits:
+            return entry.victimHits;
+        case Variable::CoalescedWrites:
+            return entry.coalescedWrites;
+        case Variable::WriteBufferStalls:
+            return entry.writeBufferStalls;
+        case Variable::N_Variables:
+            break;
+    }
+    Q_ASSERT(false);
+    return 0;
+}
+
+void CachePlotWidget::updateRangeLimits() {
+    const unsigned cycles = currentCycles();
     m_ui->rangeMin->setMinimum(0);
     m_ui->rangeMin->setMaximum(m_ui->rangeMax->value());
     m_ui->rangeMax->setMinimum(m_ui->rangeMin->value());
@@ -221,75 +436,172 @@ std::vector<CachePlotWidget::Variable> CachePlotWidget::gatherVariables() const
                 variables.push_back(qvariant_cast<Variable>(item->data(Qt::UserRole)));
             }
         }
-    } else {
+    } else if (m_plotType != PlotType::MissRatioCurves) {
         Q_ASSERT(false);
     }
     return variables;
 }
 
 void CachePlotWidget::variablesChanged() {
+    // Live data is not appended until the plot of the new variables is in place
+    m_liveSeries.clear();
+    if (m_plotType == PlotType::MissRatioCurves) {
+        // Superseding any plot which is being prepared
+        m_plotWatcher.setFuture(QFuture<PlotData>());
+        setPlot(createMissRatioCurvesPlot());
+        return;
+    }
+
+    // The series are prepared on a worker thread, such that long traces do not stall the GUI
     const auto vars = gatherVariables();
-    if (m_plotType == PlotType::Ratio) {
-        Q_ASSERT(vars.size() == 2);
-        setPlot(createRatioPlot(vars[0], vars[1]));
-    } else if (m_plotType == PlotType::Stacked) {
-        setPlot(createStackedPlot(vars));
-    } else {
-        Q_ASSERT(false);
+    Q_ASSERT(m_plotType != PlotType::Ratio || vars.size() == 2);
+    const PlotRequest request = plotRequest(vars, m_ui->rangeMin->value(), m_ui->rangeMax->value());
+    m_plotWatcher.setFuture(QtConcurrent::run(&CachePlotWidget::preparePlotData, request));
+}
+
+void CachePlotWidget::plotDataPrepared() {
+    const QFuture<PlotData> future = m_plotWatcher.future();
+    if (future.resultCount() == 0) {
+        return;
+    }
+    const PlotData data = future.result();
+    if (data.type != m_plotType) {
+        return;
     }
+    setPlot(data.type == PlotType::Ratio ? createRatioPlot(data) : createStackedPlot(data));
+    updateLiveSeries();
 }
 
-std::map<CachePlotWidget::Variable, QList<QPoint>>
-CachePlotWidget::gatherData(const std::vector<Variable>& types) const {
-    const auto& trace = m_cache.getAccessTrace();
+void CachePlotWidget::updateLiveSeries() {
+    // Series which live data is appended to whilst running, in order of the values of liveValues()
+    m_liveSeries.clear();
+    if (m_currentPlot && m_plotType != PlotType::MissRatioCurves) {
+        for (auto* series : m_currentPlot->series()) {
+            if (auto* area = qobject_cast<QAreaSeries*>(series)) {
+                m_liveSeries.push_back(area->upperSeries());
+            } else if (auto* line = qobject_cast<QLineSeries*>(series)) {
+                m_liveSeries.push_back(line);
+            }
+        }
+    }
+}
 
-    std::map<Variable, QList<QPoint>> data;
+CachePlotWidget::PlotRequest CachePlotWidget::plotRequest(const std::vector<Variable>& variables, uint64_t first,
+                                                          uint64_t last) const {
+    PlotRequest request;
+    request.type = m_plotType;
+    request.variables = variables;
+    request.first = first;
+    request.last = last;
+    if (ProcessorHandler::get()->isRunning()) {
+        // The access trace is modified whilst running; only the published statistics of the cache may be read
+        request.live = true;
+        request.liveStatistics = m_cache.getLiveStatistics();
+        request.liveCycle = currentCycles();
+    } else {
+        // A snapshot of the trace shares its chunks, and is not modified as the processor is clocked or reversed
+        request.trace = m_cache.getAccessTrace();
+    }
+    return request;
+}
+
+std::map<CachePlotWidget::Variable, QList<QPointF>> CachePlotWidget::gatherData(const PlotRequest& request) {
+    std::map<Variable, QList<QPointF>> data;
 
     // Transform variable vector to set (avoid duplicates)
     std::set<Variable> varSet;
-    for (const auto& type : types) {
+    for (const auto& type : request.variables) {
         varSet.insert(type);
     }
 
-    for (const auto& type : types) {
+    for (const auto& type : request.variables) {
         // Initialize all data types
         data[type];
     }
 
-    // Gather data
-    for (const auto& entry : trace) {
-        if (varSet.count(Variable::Writes)) {
-            data[Variable::Writes].append(QPoint(entry.first, entry.second.writes));
-        }
-        if (varSet.count(Variable::Reads)) {
-            data[Variable::Reads].append(QPoint(entry.first, entry.second.reads));
-        }
-        if (varSet.count(Variable::Hits)) {
-            data[Variable::Hits].append(QPoint(entry.first, entry.second.hits));
-        }
-        if (varSet.count(Variable::Misses)) {
-            data[Variable::Misses].append(QPoint(entry.first, entry.second.misses));
-        }
-        if (varSet.count(Variable::Writebacks)) {
-            data[Variable::Writebacks].append(QPoint(entry.first, entry.second.writebacks));
-        }
-        if (varSet.count(Variable::Accesses)) {
-            data[Variable::Accesses].append(QPoint(entry.first, entry.second.hits + entry.second.misses));
+    const auto appendEntry = [&](uint64_t cycle, const CacheSim::CacheAccessTrace& entry) {
+        for (const auto& type : varSet) {
+            data[type].append(QPointF(cycle, variableValue(type, entry)));
         }
+    };
+
+    if (request.live) {
+        appendEntry(request.liveCycle, request.liveStatistics);
+        return data;
     }
+    if (request.first > 0) {
+        // The statistics of the last access before the range hold at its start
+        appendEntry(request.first, request.trace.lookup(request.first - 1));
+    }
+    request.trace.forEach(request.first, request.last, appendEntry);
 
     return data;
 }
 
-QChart* CachePlotWidget::createRatioPlot(const Variable num, const Variable den) const {
-    const auto data = gatherData({num, den});
+CachePlotWidget::PlotData CachePlotWidget::preparePlotData(const PlotRequest& request) {
+    PlotData plot;
+    plot.type = request.type;
+    plot.variables = request.variables;
+    plot.first = request.first;
+    plot.last = request.last;
+    if (request.variables.empty()) {
+        return plot;
+    }
 
-    const QList<QPoint>& numerator = data.at(num);
-    const QList<QPoint>& denominator = data.at(den);
+    const auto data = gatherData(request);
+    const qreal minX = request.first;
+    const qreal maxX = request.last;
+    const auto finish = [&](Variable variable, const QVector<QPointF>& points) {
+        QVector<QPointF> series = stepifySeries(downsampleSeries(points, minX, maxX, s_plotBuckets));
+        finishSeries(series, request.last);
+        plot.series.push_back({variable, std::move(series)});
+    };
+
+    if (request.type == PlotType::Ratio) {
+        const QList<QPointF>& numerator = data.at(request.variables[0]);
+        const QList<QPointF>& denominator = data.at(request.variables[1]);
+        Q_ASSERT(numerator.size() == denominator.size());
+
+        QVector<QPointF> ratios;
+        ratios.reserve(numerator.size());
+        for (int i = 0; i < numerator.size(); i++) {
+            const auto& p1 = numerator[i];
+            const auto& p2 = denominator[i];
+            Q_ASSERT(p1.x() == p2.x() && "Data inconsistency");
+            double ratio = 0;
+            if (p2.y() != 0) {
+                ratio = p1.y() / p2.y();
+                ratio *= 100;
+            }
+            ratios << QPointF(p1.x(), ratio);
+            plot.maxY = ratio > plot.maxY ? ratio : plot.maxY;
+        }
+        finish(request.variables[0], ratios);
+        return plot;
+    }
 
-    Q_ASSERT(numerator.size() == denominator.size());
+    // We create a stacked chart by repeatedly creating line series with y values equal to the variable set's y value +
+    // the preceding linesets envelope values.
+    const int len = data.at(request.variables.front()).size();
+    // Envelope of the preceding linesets, at full resolution
+    QVector<QPointF> envelope(len, QPointF());
+    for (const auto& variableData : data) {
+        Q_ASSERT(len == variableData.second.size());
+        for (int i = 0; i < len; i++) {
+            const auto& dataPoint = variableData.second.at(i);
+            // Stack on top of the preceding line
+            const qreal y = envelope[i].y() + dataPoint.y();
+            plot.maxY = y > plot.maxY ? y : plot.maxY;
+            envelope[i] = QPointF(dataPoint.x(), y);
+        }
+        finish(variableData.first, envelope);
+    }
+    return plot;
+}
 
-    const unsigned points = numerator.size();
+QChart* CachePlotWidget::createRatioPlot(const PlotData& data) const {
+    const Variable num = data.variables[0];
+    const Variable den = data.variables[1];
 
     QChart* chart = new QChart();
     chart->setTitle(s_cacheVariableStrings.at(num) + "/" + s_cacheVariableStrings.at(den));
@@ -298,29 +610,13 @@ QChart* CachePlotWidget::createRatioPlot(const Variable num, const Variable den)
     chart->setTitleFont(font);
 
     QLineSeries* series = new QLineSeries(chart);
-    double maxY = 0;
-    for (int i = 0; i < points; i++) {
-        const auto& p1 = numerator[i];
-        const auto& p2 = denominator[i];
-        Q_ASSERT(p1.x() == p2.x() && "Data inconsistency");
-        double ratio = 0;
-        if (p2.y() != 0) {
-            ratio = static_cast<double>(p1.y()) / p2.y();
-            ratio *= 100;
-        }
-        series->append(p1.x(), ratio);
-        maxY = ratio > maxY ? ratio : maxY;
-    }
-    const unsigned maxX = ProcessorHandler::get()->getProcessor()->getCycleCount();
-
-    stepifySeries(*series);
-    finishSeries(*series, maxX);
+    series->replace(data.series.front().second);
 
     chart->addSeries(series);
 
     chart->createDefaultAxes();
-    chart->axes(Qt::Horizontal).first()->setRange(0, maxX);
-    chart->axes(Qt::Vertical).first()->setRange(0, maxY * 1.1);
+    chart->axes(Qt::Horizontal).first()->setRange(data.first, data.last);
+    chart->axes(Qt::Vertical).first()->setRange(0, data.maxY * 1.1);
 
     chart->legend()->hide();
 
@@ -334,72 +630,27 @@ QChart* CachePlotWidget::createRatioPlot(const Variable num, const Variable den)
     axisX->setLabelFormat("%d  ");
     axisX->setTitleText("Cycle");
 
-    //![4]
-
     return chart;
 }
 
-QChart* CachePlotWidget::createStackedPlot(const std::vector<Variable>& variables) const {
-    if (variables.size() == 0) {
+QChart* CachePlotWidget::createStackedPlot(const PlotData& data) const {
+    if (data.series.empty()) {
         return nullptr;
     }
 
-    const auto data = gatherData(variables);
-    const unsigned len = data.at(*variables.begin()).size();
-    for (const auto& iter : data) {
-        Q_ASSERT(len == iter.second.size());
-    }
-
     QChart* chart = new QChart();
     chart->setTitle("Access type count");
     QFont font;
     font.setPointSize(16);
     chart->setTitleFont(font);
 
-    // The lower series initialized to zero values
-
-    // We create a stacked chart by repeatedly creating line series with y values equal to the variable set's y value +
-    // the preceding linesets envelope values.
-    std::vector<std::pair<Variable, QLineSeries*>> lineSeries;
+    // Create area series between each prepared line and the line below it; the lowest line is stacked on zero
     QLineSeries* lowerSeries = nullptr;
-    QLineSeries* upperSeries = nullptr;
-    const unsigned maxX = ProcessorHandler::get()->getProcessor()->getCycleCount();
-    unsigned maxY = 0;
-    for (const auto& variableData : data) {
-        upperSeries = new QLineSeries(chart);
-        for (unsigned i = 0; i < len; i++) {
-            const auto& dataPoint = variableData.second.at(i);
-            unsigned x = dataPoint.x();
-            unsigned y = dataPoint.y();
-            if (lowerSeries) {
-                // Stack on top of the preceding line
-                const auto& lowerPoints = lowerSeries->pointsVector();
-                y = lowerPoints[i].y() + dataPoint.y();
-            }
-            maxY = y > maxY ? y : maxY;
-            upperSeries->append(QPoint(x, y));
-        }
-        lineSeries.push_back({variableData.first, upperSeries});
-        lowerSeries = upperSeries;
-    }
-
-    // Stepify created lineseries
-    std::map<Variable, QVector<QPointF>> debug;
-    for (const auto& line : lineSeries) {
-        debug[line.first] = line.second->pointsVector();
-    }
-    for (const auto& line : lineSeries) {
-        stepifySeries(*line.second);
-        finishSeries(*line.second, maxX);
-        debug[line.first] = line.second->pointsVector();
-    }
-
-    // Create area series
-    lowerSeries = nullptr;
-    for (int i = 0; i < lineSeries.size(); i++) {
-        upperSeries = lineSeries[i].second;
+    for (const auto& line : data.series) {
+        QLineSeries* upperSeries = new QLineSeries(chart);
+        upperSeries->replace(line.second);
         QAreaSeries* area = new QAreaSeries(upperSeries, lowerSeries);
-        area->setName(s_cacheVariableStrings.at(lineSeries[i].first));
+        area->setName(s_cacheVariableStrings.at(line.first));
         chart->addSeries(area);
         lowerSeries = upperSeries;
     }
@@ -409,7 +660,7 @@ QChart* CachePlotWidget::createStackedPlot(const std::vector<Variable>& variable
     // Add space to label to add space between labels and axis
     QValueAxis* axisY = qobject_cast<QValueAxis*>(chart->axes(Qt::Vertical).first());
     QValueAxis* axisX = qobject_cast<QValueAxis*>(chart->axes(Qt::Horizontal).first());
-    axisX->setRange(0, maxX);
+    axisX->setRange(data.first, data.last);
     axisY->setRange(0, axisY->max());
 
     Q_ASSERT(axisY);
@@ -420,6 +671,49 @@ QChart* CachePlotWidget::createStackedPlot(const std::vector<Variable>& variable
     return chart;
 }
 
+QChart* CachePlotWidget::createMissRatioCurvesPlot() const {
+    const auto* reuseDistances = m_cache.getReuseDistances();
+    if (!reuseDistances) {
+        return nullptr;
+    }
+
+    QChart* chart = new QChart();
+    chart->setTitle("Miss ratio curves");
+    QFont font;
+    font.setPointSize(16);
+    chart->setTitleFont(font);
+
+    const uint64_t accesses = reuseDistances->accesses();
+    int maxWayBits = 0;
+    while ((2u << maxWayBits) <= reuseDistances->getMaxWays()) {
+        maxWayBits++;
+    }
+    for (int lineBits = 0; lineBits <= reuseDistances->getMaxLineBits(); lineBits++) {
+        QLineSeries* series = new QLineSeries(chart);
+        series->setName(QString::number(1 << lineBits) + (lineBits == 0 ? " line" : " lines"));
+        for (int wayBits = 0; wayBits <= maxWayBits; wayBits++) {
+            const uint64_t hits = reuseDistances->hits(lineBits, 1u << wayBits);
+            const double missRatio = accesses == 0 ? 0 : 100.0 * (accesses - hits) / accesses;
+            series->append(wayBits, missRatio);
+        }
+        chart->addSeries(series);
+    }
+
+    chart->createDefaultAxes();
+    QValueAxis* axisY = qobject_cast<QValueAxis*>(chart->axes(Qt::Vertical).first());
+    QValueAxis* axisX = qobject_cast<QValueAxis*>(chart->axes(Qt::Horizontal).first());
+    Q_ASSERT(axisY && axisX);
+    axisY->setRange(0, 100);
+    axisY->setLabelFormat("%.1f  ");
+    axisY->setTitleText("Miss ratio (%)");
+    axisX->setRange(0, maxWayBits);
+    axisX->setTickCount(maxWayBits + 1);
+    axisX->setLabelFormat("%d  ");
+    axisX->setTitleText("Ways (log2)");
+
+    return chart;
+}
+
 void CachePlotWidget::setPlot(QChart* plot) {
     if (plot == nullptr)
         return;
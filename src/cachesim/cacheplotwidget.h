@@ -1,17 +1,23 @@
 #pragma once
 
 #include <QDialog>
+#include <QFutureWatcher>
 #include <QMetaType>
+#include <QPointF>
+#include <QVector>
+#include <vector>
 #include <QtCharts/QChartGlobal>
 
 #include "cachesim.h"
 
 QT_FORWARD_DECLARE_CLASS(QToolBar);
 QT_FORWARD_DECLARE_CLASS(QAction);
+QT_FORWARD_DECLARE_CLASS(QTimer);
 
 QT_CHARTS_BEGIN_NAMESPACE
 class QChartView;
 class QChart;
+class QLineSeries;
 QT_CHARTS_END_NAMESPACE
 
 QT_CHARTS_USE_NAMESPACE
@@ -26,8 +32,26 @@ class CachePlotWidget : public QDialog {
     Q_OBJECT
 
 public:
-    enum Variable { Writes = 0, Reads, Hits, Misses, Writebacks, Accesses, N_Variables };
-    enum class PlotType { Ratio, Stacked };
+    enum Variable {
+        Writes = 0,
+        Reads,
+        Hits,
+        Misses,
+        Writebacks,
+        Accesses,
+        Prefetches,
+        UsefulPrefetches,
+        LatePrefetches,
+        PollutingPrefetches,
+        CompulsoryMisses,
+        CapacityMisses,
+        ConflictMisses,
+        VictimHits,
+        CoalescedWrites,
+        WriteBufferStalls,
+        N_Variables
+    };
+    enum class PlotType { Ratio, Stacked, MissRatioCurves };
     explicit CachePlotWidget(const CacheSim& sim, QWidget* parent = nullptr);
     ~CachePlotWidget();
 
@@ -35,24 +59,94 @@ public slots:
 
 private slots:
     void variablesChanged();
+    /// Updates the allowed cycle ranges, and replots the data within the selected range
     void rangeChanged();
     void plotTypeChanged();
+    /**
+     * @brief runStarted/runFinished/appendLiveData
+     * Whilst the processor is running, the current plot is extended from the live statistics of the cache, once per
+     * s_liveUpdateInterval. Once running finishes, the plot is rebuilt from the access trace.
+     */
+    void runStarted();
+    void runFinished();
+    void appendLiveData();
+    /// Swaps the plot prepared by the worker thread into the chart
+    void plotDataPrepared();
 
 private:
+    /**
+     * @brief The PlotRequest struct
+     * Everything which a ratio or stacked plot is prepared from. The request holds a snapshot of the access trace,
+     * such that plots are prepared on a worker thread, independently of the cache.
+     */
+    struct PlotRequest {
+        PlotType type = PlotType::Ratio;
+        std::vector<Variable> variables;
+        uint64_t first = 0;
+        uint64_t last = 0;
+        CacheAccessTraceBuffer trace;
+        /// Set whilst the processor is running, in which case liveStatistics at liveCycle are plotted instead
+        bool live = false;
+        CacheAccessTrace liveStatistics;
+        uint64_t liveCycle = 0;
+    };
+
+    /// The downsampled and stepped points of the series of a plot, bottom-up for stacked plots
+    struct PlotData {
+        PlotType type = PlotType::Ratio;
+        std::vector<Variable> variables;
+        uint64_t first = 0;
+        uint64_t last = 0;
+        std::vector<std::pair<Variable, QVector<QPointF>>> series;
+        qreal maxY = 0;
+    };
+
+    /// @returns a request for plotting @p variables over [@p first; @p last] as per the current plot type
+    PlotRequest plotRequest(const std::vector<Variable>& variables, uint64_t first, uint64_t last) const;
     /**
      * @brief gatherData
-     * @returns a list of QPoints containing plotable data gathered from the cache simulator, as per the specified
+     * @returns a list of QPointFs containing plotable data gathered from the trace of @p request, as per its
+     * variables, for all cycles in [first; last]. If first is not the first cycle, the data is preceded by a point at
+     * first of the statistics holding at the start of the range.
      */
-    std::map<Variable, QList<QPoint>> gatherData(const std::vector<Variable>& variables) const;
+    static std::map<Variable, QList<QPointF>> gatherData(const PlotRequest& request);
+    /// Prepares the series of the plot of @p request. Called from a worker thread.
+    static PlotData preparePlotData(const PlotRequest& request);
+    void updateRangeLimits();
+    static qreal variableValue(Variable variable, const CacheSim::CacheAccessTrace& entry);
+    /// @returns the values of the series of the current plot for statistics @p stats
+    std::vector<qreal> liveValues(const CacheSim::CacheAccessTrace& stats) const;
     void setupToolbar();
     void setupStackedVariablesList();
     void setPlot(QChart* plot);
+    /// Collects the series of the current plot which live data is appended to
+    void updateLiveSeries();
     void copyPlotDataToClipboard() const;
+    /**
+     * @brief exportStatistics
+     * Exports the statistics of all cycles to a file chosen by the user, as CSV or columnar binary data (see
+     * exportCacheStatistics).
+     */
+    void exportStatistics();
     void savePlot();
     std::vector<CachePlotWidget::Variable> gatherVariables() const;
 
-    QChart* createRatioPlot(const Variable num, const Variable den) const;
-    QChart* createStackedPlot(const std::vector<Variable>& variables) const;
+    QChart* createRatioPlot(const PlotData& data) const;
+    QChart* createStackedPlot(const PlotData& data) const;
+    /**
+     * @brief createMissRatioCurvesPlot
+     * Plots the miss ratio against the associativity of LRU caches, one curve per line count, as derived from the
+     * reuse distance analysis of the cache. Returns nullptr if the analysis is not enabled.
+     */
+    QChart* createMissRatioCurvesPlot() const;
+
+    /**
+     * @brief s_plotBuckets
+     * Number of buckets over the plotted cycle range which plots are downsampled to, exceeding the pixel width of the
+     * plot on common displays.
+     */
+    static constexpr unsigned s_plotBuckets = 2048;
+    static constexpr int s_liveUpdateInterval = 250;  // ms
 
     PlotType m_plotType = PlotType::Ratio;
     QChart* m_currentPlot = nullptr;
@@ -62,8 +156,14 @@ private:
 
     QToolBar* m_toolbar = nullptr;
     QAction* m_copyDataAction = nullptr;
+    QAction* m_exportDataAction = nullptr;
     QAction* m_savePlotAction = nullptr;
     QAction* m_crosshairAction = nullptr;
+
+    QTimer* m_liveUpdateTimer = nullptr;
+    std::vector<QLineSeries*> m_liveSeries;
+    /// Watches the preparation of the latest requested plot; results of superseded requests are discarded
+    QFutureWatcher<PlotData> m_plotWatcher;
 };
 
 const static std::map<CachePlotWidget::Variable, QString> s_cacheVariableStrings{
@@ -72,11 +172,22 @@ const static std::map<CachePlotWidget::Variable, QString> s_cacheVariableStrings
     {CachePlotWidget::Variable::Hits, "Hits"},
     {CachePlotWidget::Variable::Misses, "Misses"},
     {CachePlotWidget::Variable::Writebacks, "Writebacks"},
-    {CachePlotWidget::Variable::Accesses, "Total accesses"}};
+    {CachePlotWidget::Variable::Accesses, "Total accesses"},
+    {CachePlotWidget::Variable::Prefetches, "Prefetches"},
+    {CachePlotWidget::Variable::UsefulPrefetches, "Useful prefetches"},
+    {CachePlotWidget::Variable::LatePrefetches, "Late prefetches"},
+    {CachePlotWidget::Variable::PollutingPrefetches, "Polluting prefetches"},
+    {CachePlotWidget::Variable::CompulsoryMisses, "Compulsory misses"},
+    {CachePlotWidget::Variable::CapacityMisses, "Capacity misses"},
+    {CachePlotWidget::Variable::ConflictMisses, "Conflict misses"},
+    {CachePlotWidget::Variable::VictimHits, "Victim cache hits"},
+    {CachePlotWidget::Variable::CoalescedWrites, "Coalesced writes"},
+    {CachePlotWidget::Variable::WriteBufferStalls, "Write buffer stalls"}};
 
 const static std::map<CachePlotWidget::PlotType, QString> s_cachePlotTypeStrings{
     {CachePlotWidget::PlotType::Ratio, "Ratio"},
-    {CachePlotWidget::PlotType::Stacked, "Stacked"}};
+    {CachePlotWidget::PlotType::Stacked, "Stacked"},
+    {CachePlotWidget::PlotType::MissRatioCurves, "Miss ratio curves"}};
 
 }  // namespace Ripes
 
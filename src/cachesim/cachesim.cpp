@@ -1,72 +1,338 @@
 #include "cachesim.h"
 #include "binutils.h"
+#include "cachetrace.h"
+#include "hostprofiler.h"
 
 #include "processorhandler.h"
+#include "shadowcache.h"
+#include "simulationsnapshot.h"
+#include "waysearch.h"
 
 #include <QApplication>
 #include <QThread>
-#include <random>
+#include <algorithm>
 #include <utility>
 
 namespace Ripes {
 
-CacheSim::CacheSim(QObject* parent) : QObject(parent) {
-    connect(ProcessorHandler::get(), &ProcessorHandler::reqProcessorReset, this, &CacheSim::processorReset);
+CacheSim::CacheSim(ProcessorHandler* context, QObject* parent) : QObject(parent), m_context(context) {
+    connect(m_context, &ProcessorHandler::reqProcessorReset, this, &CacheSim::processorReset);
 
-    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, this, [=] {
+    connect(m_context, &ProcessorHandler::runFinished, this, [=] {
         // Given that we are not updating the graphical state of the cache simulator whilst the processor is running,
         // once running is finished, the entirety of the cache view should be reloaded in the graphical view.
         emit hitrateChanged();
         emit cacheInvalidated();
     });
 
+    connect(m_context, &ProcessorHandler::checkpointRestored, this, &CacheSim::checkpointRestored,
+            Qt::DirectConnection);
+
     updateConfiguration();
 }
 
+CacheSim::~CacheSim() {
+    if (m_stallOnMiss) {
+        m_context->setMissStallCache(this, false);
+    }
+    m_context->setDetailedObserver(this, false);
+    // The processors of a context outlive caches which are created per simulation (see simulate())
+    for (auto* proc : m_context->getConstructedProcessors()) {
+        proc->designWasClocked.Disconnect(this, &CacheSim::processorWasClocked);
+        proc->designWasReversed.Disconnect(this, &CacheSim::processorWasReversed);
+        proc->designWasReset.Disconnect(this, &CacheSim::processorReset);
+    }
+    m_context->getFastEngine()->accessesTraced.Disconnect(this, &CacheSim::accessesTraced);
+    // Detach from the hierarchy, such that no other level refers to this cache once destroyed
+    if (m_nextLevel) {
+        auto& upperLevels = m_nextLevel->m_upperLevels;
+        upperLevels.erase(std::remove(upperLevels.begin(), upperLevels.end(), this), upperLevels.end());
+        m_nextLevel->m_resetUpperLevels.erase(this);
+    }
+    for (auto* upper : m_upperLevels) {
+        upper->m_nextLevel = nullptr;
+    }
+}
+
 void CacheSim::setType(CacheSim::CacheType type) {
+    if (m_stallOnMiss) {
+        m_context->setMissStallCache(this, false);
+    }
     m_type = type;
     reassociateMemory();
+    if (m_stallOnMiss) {
+        setStallOnMiss(true);
+    }
+}
+
+void CacheSim::setNextLevel(CacheSim* next) {
+    Q_ASSERT(next != this);
+    Q_ASSERT((next == nullptr || next->getType() == CacheType::UnifiedCache) && "Lower levels must be unified caches");
+    if (m_nextLevel) {
+        auto& upperLevels = m_nextLevel->m_upperLevels;
+        upperLevels.erase(std::remove(upperLevels.begin(), upperLevels.end(), this), upperLevels.end());
+        m_nextLevel->m_resetUpperLevels.erase(this);
+    }
+    m_nextLevel = next;
+    if (m_nextLevel) {
+        m_nextLevel->m_upperLevels.push_back(this);
+    }
+    reconfigure();
+}
+
+void CacheSim::setHitLatency(unsigned cycles) {
+    m_hitLatency = cycles;
+    emit latencyChanged();
+    if (stallsProcessor()) {
+        // The processor must be re-simulated with the changed miss penalties
+        reconfigure();
+    }
+}
+
+void CacheSim::setMemoryLatency(unsigned cycles) {
+    m_memoryLatency = cycles;
+    emit latencyChanged();
+    if (stallsProcessor()) {
+        reconfigure();
+    }
+}
+
+void CacheSim::setStallOnMiss(bool enabled) {
+    // Unified caches are only accessed through their upper levels
+    m_stallOnMiss = enabled && m_type != CacheType::UnifiedCache;
+    if (m_type != CacheType::UnifiedCache) {
+        m_context->setMissStallCache(this, m_stallOnMiss);
+    }
+    reconfigure();
+}
+
+bool CacheSim::stallsProcessor() const {
+    return m_stallOnMiss || std::any_of(m_upperLevels.begin(), m_upperLevels.end(),
+                                        [](const CacheSim* upper) { return upper->stallsProcessor(); });
+}
+
+unsigned CacheSim::getMissPenalty(uint32_t address, AccessType type) const {
+    CacheTransaction transaction;
+    transaction.address = address & ~0b11;
+    analyzeCacheAccess(transaction);
+    if (transaction.isHit) {
+        return 0;
+    }
+    if (type == AccessType::Write && getWriteAllocPolicy() == WriteAllocPolicy::NoWriteAllocate) {
+        return 0;
+    }
+    if (m_victimCache.contains(transaction.address)) {
+        return 0;
+    }
+    if (!m_nextLevel) {
+        return m_dram ? m_dram->latency(transaction.address) : m_memoryLatency;
+    }
+    // The block is filled from the next level, which may itself miss
+    return m_nextLevel->getHitLatency() + m_nextLevel->getMissPenalty(transaction.address, AccessType::Read);
+}
+
+unsigned CacheSim::getStallCycles(uint32_t address, AccessType type) const {
+    address &= ~0b11;
+    if (m_lastStall.cycle == currentCycle() && m_lastStall.address == address) {
+        return m_lastStall.cycles;
+    }
+    return getMissPenalty(address, type);
+}
+
+double CacheSim::getAverageAccessTime() const {
+    const double memoryLatency = m_dram ? m_dram->getAverageReadLatency() : m_memoryLatency;
+    return averageAccessTime(getStatistics(), m_nextLevel ? m_nextLevel->getAverageAccessTime() : memoryLatency);
+}
+
+double CacheSim::getAverageAccessTime(uint64_t first, uint64_t last) const {
+    const double memoryLatency = m_dram ? m_dram->getAverageReadLatency() : m_memoryLatency;
+    return averageAccessTime(getStatistics(first, last),
+                             m_nextLevel ? m_nextLevel->getAverageAccessTime(first, last) : memoryLatency);
+}
+
+double CacheSim::averageAccessTime(const CacheAccessTrace& stats, double missPenalty) const {
+    const uint64_t accesses = stats.hits + stats.misses;
+    // Misses served by the victim cache take a second hit latency, rather than the miss penalty
+    const uint64_t victimHits = std::min(stats.victimHits, stats.misses);
+    const double missRate = accesses == 0 ? 0 : static_cast<double>(stats.misses - victimHits) / accesses;
+    const double victimRate = accesses == 0 ? 0 : static_cast<double>(victimHits) / accesses;
+    return m_hitLatency + victimRate * m_hitLatency + missRate * missPenalty;
 }
 
 void CacheSim::reassociateMemory() {
     if (m_type == CacheType::DataCache) {
-        m_memory.rw = ProcessorHandler::get()->getDataMemory();
+        m_memory.rw = m_context->getDataMemory();
     } else if (m_type == CacheType::InstrCache) {
-        m_memory.rom = ProcessorHandler::get()->getInstrMemory();
+        m_memory.rom = m_context->getInstrMemory();
     } else {
-        Q_ASSERT(false);
+        // Unified caches are only accessed through their upper levels
+        m_memory.rw = nullptr;
+        return;
     }
     Q_ASSERT(m_memory.rw != nullptr);
 }
 
-void CacheSim::updateCacheLineReplFields(CacheLine& line, unsigned wayIdx) {
-    if (getReplacementPolicy() == ReplPolicy::LRU) {
-        // Find previous LRU value for the updated index
-        const unsigned preLRU = line[wayIdx].lru;
+void CacheSim::TagStore::reset(unsigned lines, unsigned ways, unsigned blocks) {
+    const unsigned entries = lines * ways;
+    tags.assign(entries, -1);
+    repl.assign(entries, -1);
+    valid.assign(entries, false);
+    dirty.assign(entries, false);
+    dirtyWords = (blocks + 63) / 64;
+    dirtyBlocks.assign(entries * dirtyWords, 0);
+    prefetched.assign(entries, 0);
+    prefetchTime.assign(entries, 0);
+    plruTree.assign(entries, 0);
+    fifoNext.assign(lines, 0);
+    randomDraws = 0;
+    lineHits.assign(lines, 0);
+    lineMisses.assign(lines, 0);
+}
 
-        // All indicies which are curently more recent than preLRU shall be incremented
-        for (auto& set : line) {
-            if (set.second.valid && set.second.lru < preLRU) {
-                set.second.lru++;
-            }
-        }
+void CacheSim::resetTagStore() {
+    m_store.reset(getLines(), getWays(), getBlocks());
+}
+
+CacheSim::CacheWay CacheSim::readWay(unsigned entry, bool withDirtyBlocks) const {
+    CacheWay way;
+    way.tag = m_store.tags[entry];
+    way.valid = m_store.valid[entry];
+    way.dirty = m_store.dirty[entry];
+    way.repl = m_store.repl[entry];
+    way.prefetched = m_store.prefetched[entry];
+    way.prefetchTime = m_store.prefetchTime[entry];
+    if (withDirtyBlocks && way.dirty) {
+        const auto words = m_store.dirtyBlocks.begin() + entry * m_store.dirtyWords;
+        way.dirtyBlocks.assign(words, words + m_store.dirtyWords);
+    }
+    return way;
+}
 
-        // Upgrade @p lruIdx to the most recently used
-        line[wayIdx].lru = 0;
+void CacheSim::writeWay(unsigned entry, const CacheWay& way) {
+    m_store.tags[entry] = way.tag;
+    m_store.valid[entry] = way.valid;
+    m_store.dirty[entry] = way.dirty;
+    m_store.repl[entry] = way.repl;
+    m_store.prefetched[entry] = way.prefetched;
+    m_store.prefetchTime[entry] = way.prefetchTime;
+    const auto words = m_store.dirtyBlocks.begin() + entry * m_store.dirtyWords;
+    if (way.dirtyBlocks.empty()) {
+        std::fill(words, words + m_store.dirtyWords, 0);
+    } else {
+        std::copy(way.dirtyBlocks.begin(), way.dirtyBlocks.end(), words);
     }
 }
 
-void CacheSim::revertCacheLineReplFields(CacheLine& line, const CacheWay& oldWay, unsigned wayIdx) {
-    if (getReplacementPolicy() == ReplPolicy::LRU) {
-        // All indicies which are curently less than or equal to the old LRU shall be decremented
-        for (auto& set : line) {
-            if (set.second.valid && set.second.lru <= oldWay.lru) {
-                set.second.lru--;
+void CacheSim::updateCacheLineReplFields(unsigned lineIdx, unsigned wayIdx, CacheTrace& trace) {
+    const unsigned base = entryIdx(lineIdx, 0);
+    const unsigned entry = base + wayIdx;
+
+    switch (getReplacementPolicy()) {
+        case ReplPolicy::LRU: {
+            const unsigned end = entryIdx(lineIdx + 1, 0);
+
+            // Find previous LRU value for the updated index
+            const unsigned preLRU = m_store.repl[entry];
+
+            // All indicies which are curently more recent than preLRU shall be incremented
+            for (unsigned i = base; i < end; i++) {
+                if (m_store.valid[i] && m_store.repl[i] < preLRU) {
+                    m_store.repl[i]++;
+                }
             }
+
+            // Upgrade @p lruIdx to the most recently used
+            m_store.repl[entry] = 0;
+            break;
+        }
+        case ReplPolicy::PLRU: {
+            // Point all nodes along the path to the accessed way towards the other half of their subtree
+            uint32_t pathBits = 0;
+            unsigned node = 1;
+            for (int level = 0; level < m_ways; level++) {
+                const unsigned half = (wayIdx >> (m_ways - 1 - level)) & 1;
+                pathBits |= static_cast<uint32_t>(m_store.plruTree[base + node]) << level;
+                m_store.plruTree[base + node] = !half;
+                node = 2 * node + half;
+            }
+            trace.oldReplState = pathBits;
+            break;
         }
+        case ReplPolicy::LFU: {
+            // Newly allocated ways start out with a single use
+            const uint32_t maxCount = generateBitmask(s_lfuCounterBits);
+            uint32_t& count = m_store.repl[entry];
+            count = count == static_cast<uint32_t>(-1) ? 1 : std::min(count + 1, maxCount);
+            break;
+        }
+        case ReplPolicy::SRRIP: {
+            // Hits are predicted to be re-referenced in the near future, and new ways in the long (but not distant)
+            // future
+            const uint32_t maxRRPV = generateBitmask(s_rrpvBits);
+            uint32_t& rrpv = m_store.repl[entry];
+            rrpv = rrpv == static_cast<uint32_t>(-1) ? maxRRPV - 1 : 0;
+            break;
+        }
+        case ReplPolicy::Random:
+        case ReplPolicy::FIFO:
+            // Accesses do not affect the replacement state
+            break;
+    }
+}
+
+void CacheSim::revertCacheLineReplFields(const CacheTrace& trace) {
+    const auto& transaction = trace.transaction;
+    const auto& oldWay = trace.oldWay;
+    const unsigned lineIdx = transaction.index.line;
+    const unsigned wayIdx = transaction.index.way;
+    const unsigned base = entryIdx(lineIdx, 0);
+    const unsigned end = entryIdx(lineIdx + 1, 0);
+
+    switch (getReplacementPolicy()) {
+        case ReplPolicy::LRU: {
+            // All indicies which are curently less than or equal to the old LRU shall be decremented
+            for (unsigned i = base; i < end; i++) {
+                if (m_store.valid[i] && m_store.repl[i] <= oldWay.repl) {
+                    m_store.repl[i]--;
+                }
+            }
 
-        // Revert the oldWay LRU
-        line[wayIdx].lru = oldWay.lru;
+            // Revert the oldWay LRU
+            m_store.repl[base + wayIdx] = oldWay.repl;
+            break;
+        }
+        case ReplPolicy::PLRU: {
+            unsigned node = 1;
+            for (int level = 0; level < m_ways; level++) {
+                const unsigned half = (wayIdx >> (m_ways - 1 - level)) & 1;
+                m_store.plruTree[base + node] = (trace.oldReplState >> level) & 1;
+                node = 2 * node + half;
+            }
+            break;
+        }
+        case ReplPolicy::FIFO: {
+            if (!transaction.isHit && !transaction.transToValid) {
+                // The pointer only advances when evicting from a full line
+                m_store.fifoNext[lineIdx] = trace.oldReplState;
+            }
+            break;
+        }
+        case ReplPolicy::LFU: {
+            m_store.repl[base + wayIdx] = oldWay.repl;
+            break;
+        }
+        case ReplPolicy::SRRIP: {
+            // Revert the way, and then the aging of the line performed when locating the way
+            m_store.repl[base + wayIdx] = oldWay.repl;
+            for (unsigned i = base; i < end; i++) {
+                if (m_store.valid[i]) {
+                    m_store.repl[i] -= trace.oldReplState;
+                }
+            }
+            break;
+        }
+        case ReplPolicy::Random:
+            break;
     }
 }
 
@@ -87,11 +353,40 @@ CacheSim::CacheSize CacheSim::getCacheSize() const {
         size.bits += componentBits;
     }
 
-    if (m_replPolicy == ReplPolicy::LRU) {
-        // LRU bits
-        componentBits = getWaysBits() * entries;
-        size.components.push_back("LRU bits: " + QString::number(componentBits));
-        size.bits += componentBits;
+    if (getWays() > 1) {
+        // Replacement policy bits
+        QString replBitsName;
+        switch (m_replPolicy) {
+            case ReplPolicy::LRU:
+                componentBits = getWaysBits() * entries;
+                replBitsName = "LRU bits";
+                break;
+            case ReplPolicy::PLRU:
+                // A tree of ways - 1 nodes per line
+                componentBits = (getWays() - 1) * getLines();
+                replBitsName = "PLRU bits";
+                break;
+            case ReplPolicy::FIFO:
+                // A pointer per line
+                componentBits = getWaysBits() * getLines();
+                replBitsName = "FIFO bits";
+                break;
+            case ReplPolicy::LFU:
+                componentBits = s_lfuCounterBits * entries;
+                replBitsName = "LFU bits";
+                break;
+            case ReplPolicy::SRRIP:
+                componentBits = s_rrpvBits * entries;
+                replBitsName = "RRPV bits";
+                break;
+            case ReplPolicy::Random:
+                componentBits = 0;
+                break;
+        }
+        if (componentBits != 0) {
+            size.components.push_back(replBitsName + ": " + QString::number(componentBits));
+            size.bits += componentBits;
+        }
     }
 
     // Tag bits
@@ -104,123 +399,244 @@ CacheSim::CacheSize CacheSim::getCacheSize() const {
     size.components.push_back("Data bits: " + QString::number(componentBits));
     size.bits += componentBits;
 
+    if (m_victimCache.enabled()) {
+        // Valid bit, block address and data of each victim block
+        const unsigned blockAddressBits = 32 - 2 /*byte offset*/ - getBlockBits();
+        componentBits = m_victimCache.capacity() * (1 + blockAddressBits + 32 * getBlocks());
+        size.components.push_back("Victim cache bits: " + QString::number(componentBits));
+        size.bits += componentBits;
+    }
+
+    if (m_writeBuffer.enabled()) {
+        // Valid bit, block address, and data and valid mask of the words of each buffered block
+        const unsigned blockAddressBits = 32 - 2 /*byte offset*/ - getBlockBits();
+        componentBits = m_writeBuffer.capacity() * (1 + blockAddressBits + 33 * getBlocks());
+        size.components.push_back("Write buffer bits: " + QString::number(componentBits));
+        size.bits += componentBits;
+    }
+
     return size;
 }
 
-std::pair<unsigned, CacheSim::CacheWay*> CacheSim::locateEvictionWay(const CacheTransaction& transaction) {
-    auto& cacheLine = m_cacheLines[transaction.index.line];
+unsigned CacheSim::randomWay() {
+    // splitmix64, evaluated at the number of preceding draws. Every eviction decision thus draws a new way, including
+    // those of several accesses within the same cycle.
+    const uint64_t counter = ++m_store.randomDraws;
+    uint64_t z = m_seed + counter * 0x9E3779B97F4A7C15;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    z ^= z >> 31;
+    return static_cast<unsigned>(z % getWays());
+}
 
-    std::pair<unsigned, CacheSim::CacheWay*> ew;
-    ew.first = s_invalidIndex;
-    ew.second = nullptr;
+unsigned CacheSim::locateEvictionWay(const CacheTransaction& transaction, CacheTrace& trace) {
+    const unsigned ways = getWays();
+    const unsigned base = entryIdx(transaction.index.line, 0);
+    unsigned wayIdx = s_invalidIndex;
 
     // Locate a new way based on replacement policy
     if (m_replPolicy == ReplPolicy::Random) {
         // Select a random way
-        ew.first = std::rand() % getWays();
-        ew.second = &cacheLine[ew.first];
-    } else if (m_replPolicy == ReplPolicy::LRU) {
-        if (getWays() == 1) {
-            // Nothing to do if we are in LRU and only have 1 set
-            ew.first = 0;
-            ew.second = &cacheLine[ew.first];
-        } else {
-            // Lazily all ways in the cacheline before starting to iterate
-            for (int i = 0; i < getWays(); i++) {
-                cacheLine[i];
-            }
+        wayIdx = randomWay();
+        trace.drewRandomWay = true;
+    } else if (ways == 1) {
+        // Nothing to do if we only have 1 set
+        wayIdx = 0;
+    } else {
+        // If there is an invalid cache line, select that
+        wayIdx = findEqual(&m_store.valid[base], ways, uint8_t(false));
+        if (wayIdx == ways) {
+            // Else, let the replacement policy select a victim
+            wayIdx = locateReplacementVictim(transaction.index.line, trace);
+        }
+    }
 
-            // If there is an invalid cache line, select that
-            for (auto& way : cacheLine) {
-                if (!way.second.valid) {
-                    ew.first = way.first;
-                    ew.second = &way.second;
-                    break;
-                }
+    Q_ASSERT(wayIdx < ways && "Unable to locate way for eviction");
+    return wayIdx;
+}
+
+unsigned CacheSim::locateReplacementVictim(unsigned lineIdx, CacheTrace& trace) {
+    const unsigned ways = getWays();
+    const unsigned base = entryIdx(lineIdx, 0);
+    const uint32_t* repl = &m_store.repl[base];
+
+    switch (m_replPolicy) {
+        case ReplPolicy::LRU:
+            // The ages of the valid ways of a full line are a permutation of 0 to ways - 1, so the oldest way is the
+            // one of the maximum age.
+            return findEqual(repl, ways, ways - 1);
+        case ReplPolicy::PLRU: {
+            // Follow the tree nodes towards the pseudo least recently used way
+            unsigned node = 1;
+            while (node < ways) {
+                node = 2 * node + m_store.plruTree[base + node];
             }
-            if (ew.second == nullptr) {
-                // Else, Find LRU way
-                for (auto& way : cacheLine) {
-                    if (way.second.lru == getWays() - 1) {
-                        ew.first = way.first;
-                        ew.second = &way.second;
-                        break;
-                    }
+            return node - ways;
+        }
+        case ReplPolicy::FIFO: {
+            const unsigned wayIdx = m_store.fifoNext[lineIdx];
+            trace.oldReplState = wayIdx;
+            m_store.fifoNext[lineIdx] = (wayIdx + 1) % ways;
+            return wayIdx;
+        }
+        case ReplPolicy::LFU:
+            // Evict the least frequently used way
+            return static_cast<unsigned>(std::min_element(repl, repl + ways) - repl);
+        case ReplPolicy::SRRIP: {
+            // Evict a way predicted to be re-referenced in the distant future. If there is none, age all ways of the
+            // line until there is.
+            const uint32_t maxRRPV = generateBitmask(s_rrpvBits);
+            const uint32_t aging = maxRRPV - *std::max_element(repl, repl + ways);
+            if (aging != 0) {
+                for (unsigned i = base; i < base + ways; i++) {
+                    m_store.repl[i] += aging;
                 }
             }
+            trace.oldReplState = aging;
+            return findEqual(repl, ways, maxRRPV);
         }
+        case ReplPolicy::Random:
+            break;
     }
-
-    Q_ASSERT(ew.first != s_invalidIndex && "Unable to locate way for eviction");
-    Q_ASSERT(ew.second != nullptr && "Unable to locate way for eviction");
-    return ew;
+    Q_ASSERT(false && "Unable to locate way for eviction");
+    return s_invalidIndex;
 }
 
-CacheSim::CacheWay CacheSim::evictAndUpdate(CacheTransaction& transaction) {
-    const auto [wayIdx, wayPtr] = locateEvictionWay(transaction);
-
-    CacheWay eviction;
+void CacheSim::evictAndUpdate(CacheTrace& trace) {
+    CacheTransaction& transaction = trace.transaction;
+    const unsigned wayIdx = locateEvictionWay(transaction, trace);
+    const unsigned entry = entryIdx(transaction.index.line, wayIdx);
 
-    if (!wayPtr->valid) {
+    if (!m_store.valid[entry]) {
         // Record that this was an invalid->valid transition
         transaction.transToValid = true;
     } else {
         // Store the old way info in our eviction trace, in case of rollbacks
-        eviction = *wayPtr;
+        trace.oldWay = readWay(entry, true);
 
-        if (eviction.dirty) {
+        if (trace.oldWay.dirty) {
             // The eviction will result in a writeback
             transaction.isWriteback = true;
         }
+        const uint8_t polluting = PrefetchUnused | PrefetchDisplaced;
+        transaction.pollutingPrefetch = (trace.oldWay.prefetched & polluting) == polluting;
     }
 
-    // Invalidate the target way
-    *wayPtr = CacheWay();
-
-    // Set required values in way, reflecting the newly loaded address
-    wayPtr->valid = true;
-    wayPtr->dirty = false;
-    wayPtr->tag = getTag(transaction.address);
+    // Invalidate the target way, and set required values in way, reflecting the newly loaded address
+    CacheWay way;
+    way.valid = true;
+    way.dirty = false;
+    way.tag = getTag(transaction.address);
+    if (transaction.type == AccessType::Prefetch) {
+        way.prefetched = PrefetchUnused | (transaction.transToValid ? 0 : PrefetchDisplaced);
+        way.prefetchTime = trace.cycle;
+    }
+    writeWay(entry, way);
     transaction.tagChanged = true;
     transaction.index.way = wayIdx;
+}
 
-    return eviction;
+uint64_t CacheSim::getHits() const {
+    return reportedStatistics().hits;
 }
 
-unsigned CacheSim::getHits() const {
-    if (m_accessTrace.size() == 0) {
-        return 0;
-    } else {
-        auto& trace = m_accessTrace.rbegin()->second;
-        return trace.hits;
+uint64_t CacheSim::getMisses() const {
+    return reportedStatistics().misses;
+}
+
+uint64_t CacheSim::getWritebacks() const {
+    return reportedStatistics().writebacks;
+}
+
+double CacheSim::getHitRate() const {
+    const auto stats = reportedStatistics();
+    const uint64_t accesses = stats.hits + stats.misses;
+    return accesses == 0 ? 0 : static_cast<double>(stats.hits) / accesses;
+}
+
+CacheSim::CacheAccessTrace CacheSim::reportedStatistics() const {
+    if (m_warmingUp) {
+        return CacheAccessTrace();
     }
+    return CacheAccessTraceBuffer::difference(m_accessTrace.back(), m_statisticsBase);
 }
 
-unsigned CacheSim::getMisses() const {
-    if (m_accessTrace.size() == 0) {
-        return 0;
-    } else {
-        auto& trace = m_accessTrace.rbegin()->second;
-        return trace.misses;
+void CacheSim::setWarmup(const Warmup& warmup) {
+    m_warmup = warmup;
+    if (m_accessTrace.empty()) {
+        restartStatistics();
+        publishStatistics();
     }
 }
 
-unsigned CacheSim::getWritebacks() const {
-    if (m_accessTrace.size() == 0) {
-        return 0;
-    } else {
-        auto& trace = m_accessTrace.rbegin()->second;
-        return trace.writebacks;
+void CacheSim::resetStatistics() {
+    m_warmingUp = false;
+    m_statisticsStart = m_accessTrace.empty() ? 0 : m_accessTrace.backCycle() + 1;
+    m_statisticsBase = m_accessTrace.back();
+    publishStatistics();
+    emit hitrateChanged();
+}
+
+void CacheSim::restartStatistics() {
+    m_warmingUp = m_warmup.mode != Warmup::Mode::None;
+    m_statisticsStart = 0;
+    m_statisticsBase = CacheAccessTrace();
+}
+
+void CacheSim::revertStatisticsStart() {
+    if (m_statisticsStart != 0 && (m_accessTrace.empty() || m_accessTrace.backCycle() < m_statisticsStart)) {
+        restartStatistics();
     }
 }
 
-double CacheSim::getHitRate() const {
-    if (m_accessTrace.size() == 0) {
-        return 0;
-    } else {
-        auto& trace = m_accessTrace.rbegin()->second;
-        return static_cast<double>(trace.hits) / (trace.hits + trace.misses);
+void CacheSim::updateWarmup(uint64_t cycle, AccessType type, uint32_t pc, const CacheAccessTrace& pre) {
+    if (!m_warmingUp) {
+        return;
     }
+    const bool demand = type != AccessType::Prefetch;
+    bool ended = false;
+    switch (m_warmup.mode) {
+        case Warmup::Mode::None:
+            ended = true;
+            break;
+        case Warmup::Mode::Cycles:
+            ended = cycle >= m_warmup.count;
+            break;
+        case Warmup::Mode::Accesses:
+            ended = pre.hits + pre.misses >= m_warmup.count;
+            break;
+        case Warmup::Mode::MarkerPC:
+            ended = demand && pc == m_warmup.pc;
+            break;
+    }
+    if (ended) {
+        m_warmingUp = false;
+        m_statisticsStart = cycle;
+        m_statisticsBase = pre;
+    }
+}
+
+CacheSim::CacheAccessTrace CacheSim::accumulate(const CacheAccessTrace& pre, const CacheTransaction& transaction) {
+    CacheAccessTrace trace;
+    // Prefetches are not demand accesses, and do not count as hits or misses
+    const bool demand = transaction.type != AccessType::Prefetch;
+    trace.reads = pre.reads + (transaction.type == AccessType::Read ? 1 : 0);
+    trace.writes = pre.writes + (transaction.type == AccessType::Write ? 1 : 0);
+    trace.writebacks = pre.writebacks + (transaction.isWriteback ? 1 : 0);
+    trace.hits = pre.hits + (demand && transaction.isHit ? 1 : 0);
+    trace.misses = pre.misses + (demand && !transaction.isHit ? 1 : 0);
+    trace.prefetches = pre.prefetches + (demand ? 0 : 1);
+    trace.usefulPrefetches = pre.usefulPrefetches + (transaction.usefulPrefetch ? 1 : 0);
+    trace.latePrefetches = pre.latePrefetches + (transaction.latePrefetch ? 1 : 0);
+    trace.pollutingPrefetches = pre.pollutingPrefetches + (transaction.pollutingPrefetch ? 1 : 0);
+    using MissType = MissClassifier::MissType;
+    trace.compulsoryMisses = pre.compulsoryMisses + (transaction.missType == MissType::Compulsory ? 1 : 0);
+    trace.capacityMisses = pre.capacityMisses + (transaction.missType == MissType::Capacity ? 1 : 0);
+    trace.conflictMisses = pre.conflictMisses + (transaction.missType == MissType::Conflict ? 1 : 0);
+    trace.victimHits = pre.victimHits + (transaction.victimHit ? 1 : 0);
+    trace.coalescedWrites = pre.coalescedWrites + (transaction.coalescedWrite ? 1 : 0);
+    trace.writeBufferStalls = pre.writeBufferStalls + (transaction.writeBufferStall ? 1 : 0);
+    return trace;
 }
 
 void CacheSim::analyzeCacheAccess(CacheTransaction& transaction) const {
@@ -228,26 +644,37 @@ void CacheSim::analyzeCacheAccess(CacheTransaction& transaction) const {
     transaction.index.block = getBlockIdx(transaction.address);
 
     transaction.isHit = false;
-    if (m_cacheLines.count(transaction.index.line) != 0) {
-        for (const auto& way : m_cacheLines.at(transaction.index.line)) {
-            if ((way.second.tag == getTag(transaction.address)) && way.second.valid) {
-                transaction.index.way = way.first;
-                transaction.isHit = true;
-                break;
-            }
+    const unsigned tag = getTag(transaction.address);
+    const unsigned base = entryIdx(transaction.index.line, 0);
+    const unsigned ways = getWays();
+    const uint32_t* tags = &m_store.tags[base];
+    for (unsigned i = findEqual(tags, ways, tag); i < ways; i = findEqual(tags, ways, tag, i + 1)) {
+        if (m_store.valid[base + i]) {
+            transaction.index.way = i;
+            transaction.isHit = true;
+            break;
         }
     }
 }
 
-void CacheSim::pushAccessTrace(const CacheTransaction& transaction) {
-    // Access traces are pushed in sorted order into the access trace map; indexed by a key corresponding to the cycle
-    // of the acces.
-    const unsigned currentCycle = ProcessorHandler::get()->getProcessor()->getCycleCount();
-
-    const CacheAccessTrace& mostRecentTrace =
-        m_accessTrace.size() == 0 ? CacheAccessTrace() : m_accessTrace.rbegin()->second;
-
-    m_accessTrace[currentCycle] = CacheAccessTrace(mostRecentTrace, transaction);
+void CacheSim::pushAccessTrace(const CacheTransaction& transaction, uint32_t pc) {
+    if (transaction.type != AccessType::Prefetch && m_type != CacheType::UnifiedCache) {
+        if (!transaction.isHit) {
+            m_context->recordCacheMiss();
+        }
+        if (m_type == CacheType::DataCache) {
+            m_context->recordDataCacheAccess(!transaction.isHit);
+        }
+    }
+    updateWarmup(currentCycle(), transaction.type, pc, m_batchDepth != 0 ? m_batchStatistics : m_accessTrace.back());
+    if (m_batchDepth != 0) {
+        m_batchStatistics = accumulate(m_batchStatistics, transaction);
+        m_batchAccessed = true;
+        return;
+    }
+    // Access traces are pushed in sorted order into the access trace buffer; keyed by the cycle of the access.
+    m_accessTrace.append(currentCycle(), accumulate(m_accessTrace.back(), transaction));
+    publishStatistics();
 
     if (!isAsynchronouslyAccessed()) {
         emit hitrateChanged();
@@ -255,29 +682,65 @@ void CacheSim::pushAccessTrace(const CacheTransaction& transaction) {
 }
 
 void CacheSim::popAccessTrace() {
-    Q_ASSERT(m_accessTrace.size() > 0);
+    Q_ASSERT(!m_accessTrace.empty());
     // The access trace should have an entry
-    m_accessTrace.erase(m_accessTrace.rbegin()->first);
+    m_accessTrace.popBack();
+    revertStatisticsStart();
+    publishStatistics();
     emit hitrateChanged();
 }
 
-void CacheSim::access(uint32_t address, AccessType type) {
+void CacheSim::publishStatistics() {
+    m_liveStatistics.publish(m_accessTrace.back());
+    m_reportedStatistics.publish(reportedStatistics());
+}
+
+void CacheSim::updateCache(uint32_t address, AccessType type, CacheTrace& trace) {
     address = address & ~0b11;  // Disregard unaligned accesses
-    CacheTrace trace;
-    CacheWay oldWay;
-    CacheTransaction transaction;
+    if (m_analyzeReuseDistances && type != AccessType::Prefetch) {
+        m_reuseDistances.access(address);
+    }
+    CacheTransaction& transaction = trace.transaction;
+    transaction = CacheTransaction();
     transaction.address = address;
     transaction.type = type;
 
     analyzeCacheAccess(transaction);
+    if (type != AccessType::Prefetch) {
+        (transaction.isHit ? m_store.lineHits : m_store.lineMisses)[transaction.index.line]++;
+        const auto missType = m_missClassifier.access(address, trace.classifierUndo);
+        if (!transaction.isHit) {
+            transaction.missType = missType;
+        }
+    }
 
     if (!transaction.isHit) {
-        if (type == AccessType::Read ||
-            (type == AccessType::Write && getWriteAllocPolicy() == WriteAllocPolicy::WriteAllocate)) {
-            oldWay = evictAndUpdate(transaction);
+        if (type != AccessType::Write || getWriteAllocPolicy() == WriteAllocPolicy::WriteAllocate) {
+            evictAndUpdate(trace);
+            if (m_victimCache.enabled()) {
+                // The missed block is swapped with the evicted block, if held by the victim cache
+                transaction.victimHit = m_victimCache.take(address, trace.victimUndo);
+                if (!transaction.transToValid) {
+                    m_victimCache.insert(buildAddress(trace.oldWay.tag, transaction.index.line, 0), trace.victimUndo);
+                }
+            }
         }
     } else {
-        oldWay = m_cacheLines[transaction.index.line][transaction.index.way];
+        if (type == AccessType::Prefetch) {
+            // The prefetched block is already present; the prefetch is dropped without affecting the cache
+            return;
+        }
+        // Undoing a hit only reverts the replacement fields and prefetch flags of the way, so its dirty blocks need
+        // not be recorded
+        const unsigned entry = entryIdx(transaction.index.line, transaction.index.way);
+        trace.oldWay = readWay(entry, false);
+        if (trace.oldWay.prefetched & PrefetchUnused) {
+            transaction.usefulPrefetch = true;
+            const uint64_t prefetchTime = trace.oldWay.prefetchTime;
+            transaction.latePrefetch =
+                trace.cycle >= prefetchTime && trace.cycle - prefetchTime < getNextLevelLatency();
+            m_store.prefetched[entry] = 0;
+        }
     }
 
     // === Update dirty and LRU bits ===
@@ -288,16 +751,14 @@ void CacheSim::access(uint32_t address, AccessType type) {
         !transaction.isHit && type == AccessType::Write && getWriteAllocPolicy() == WriteAllocPolicy::NoWriteAllocate;
 
     if (!writeMissNoAlloc) {
-        // Lazily ensure that the located way has been initialized
-        m_cacheLines[transaction.index.line][transaction.index.way];
-
         if (type == AccessType::Write && getWritePolicy() == WritePolicy::WriteBack) {
-            CacheWay& way = m_cacheLines[transaction.index.line][transaction.index.way];
-            way.dirty = true;
-            way.dirtyBlocks.insert(transaction.index.block);
+            const unsigned entry = entryIdx(transaction.index.line, transaction.index.way);
+            const unsigned block = transaction.index.block;
+            m_store.dirty[entry] = true;
+            m_store.dirtyBlocks[entry * m_store.dirtyWords + block / 64] |= uint64_t(1) << (block % 64);
         }
 
-        updateCacheLineReplFields(m_cacheLines[transaction.index.line], transaction.index.way);
+        updateCacheLineReplFields(transaction.index.line, transaction.index.way, trace);
     } else {
         // In case of a write miss with no write allocate, the value is always written through to memory (a writeback)
         transaction.isWriteback = true;
@@ -306,16 +767,192 @@ void CacheSim::access(uint32_t address, AccessType type) {
     // If our WritePolicy is WriteThrough and this access is a write, the transaction will always result in a WriteBack
     if (type == AccessType::Write && getWritePolicy() == WritePolicy::WriteThrough) {
         transaction.isWriteback = true;
+        if (m_writeBuffer.enabled()) {
+            // Writes are drained at the latency of the next level. A write coalesced into a buffered block is written
+            // along with it, and thus not written to the next level by itself.
+            const auto result =
+                m_writeBuffer.write(address, trace.cycle, getNextLevelLatency(), trace.writeBufferUndo);
+            transaction.coalescedWrite = result == WriteBuffer::Result::Coalesced;
+            transaction.writeBufferStall = result == WriteBuffer::Result::Stalled;
+            transaction.isWriteback = !transaction.coalescedWrite;
+        }
     }
 
     // ===========================
+}
+
+void CacheSim::propagate(const CacheTrace& trace, AccessMode mode) {
+    if (!m_nextLevel && !m_dram) {
+        return;
+    }
+
+    const CacheTransaction& transaction = trace.transaction;
+    const bool allocated = !transaction.isHit && transaction.index.way != s_invalidIndex;
+    if (allocated && !transaction.victimHit) {
+        // The missed (or prefetched) block is filled from the next level
+        accessNextLevel(transaction.address, AccessType::Read, mode, trace.pc);
+    }
+    if (transaction.isWriteback) {
+        // Either a dirty block was evicted, or the written word is written through to the next level
+        const bool evictedDirty = allocated && !transaction.transToValid && trace.oldWay.dirty;
+        const uint32_t address =
+            evictedDirty ? buildAddress(trace.oldWay.tag, transaction.index.line, 0) : transaction.address;
+        accessNextLevel(address, AccessType::Write, mode, trace.pc);
+    }
+}
+
+void CacheSim::accessNextLevel(uint32_t address, AccessType type, AccessMode mode, uint32_t pc) {
+    if (m_nextLevel) {
+        m_nextLevel->accessAs(address, type, mode, pc);
+    } else if (mode == AccessMode::Warmup) {
+        m_dram->warmup(address);
+    } else {
+        m_dram->access(address, type == AccessType::Write);
+    }
+}
+
+void CacheSim::setDRAM(DRAMModel* dram) {
+    m_dram = dram;
+    reconfigure();
+}
+
+void CacheSim::accessAs(uint32_t address, AccessType type, AccessMode mode, uint32_t pc) {
+    switch (mode) {
+        case AccessMode::Simulated:
+            access(address, type, pc);
+            break;
+        case AccessMode::Warmup:
+            warmup(address, type, pc);
+            break;
+        case AccessMode::Replayed:
+            replayAccess(address, type, pc);
+            break;
+    }
+}
 
+void CacheSim::trainPrefetcher(CacheTrace& trace) {
+    if (!m_prefetcher.enabled()) {
+        m_prefetchRequests.clear();
+        return;
+    }
+    // Prefetchers are triggered by misses, and by the first hits on prefetched blocks
+    const CacheTransaction& transaction = trace.transaction;
+    const bool trigger = !transaction.isHit || transaction.usefulPrefetch;
+    trace.prefetcherUndo = m_prefetcher.observe(trace.pc, transaction.address, trigger, m_prefetchRequests);
+}
+
+void CacheSim::issuePrefetches(AccessMode mode, uint32_t pc) {
+    // Prefetches do not train the prefetcher, and thus leave the requests untouched while these are issued
+    for (const uint32_t address : m_prefetchRequests) {
+        accessAs(address, AccessType::Prefetch, mode, pc);
+    }
+}
+
+void CacheSim::accessBatch(const Access* accesses, size_t count) {
+    accessBatch(accesses, count, AccessMode::Simulated);
+}
+
+void CacheSim::accessBatch(const Access* accesses, size_t count, AccessMode mode) {
+    const Access* end = accesses + count;
+    switch (mode) {
+        case AccessMode::Simulated:
+            beginBatch();
+            for (const Access* a = accesses; a != end; a++) {
+                access(a->address, a->type, a->pc);
+            }
+            finishBatch();
+            break;
+        case AccessMode::Warmup:
+            for (const Access* a = accesses; a != end; a++) {
+                warmup(a->address, a->type, a->pc);
+            }
+            break;
+        case AccessMode::Replayed:
+            for (const Access* a = accesses; a != end; a++) {
+                replayAccess(a->address, a->type, a->pc);
+            }
+            break;
+    }
+}
+
+void CacheSim::beginBatch() {
+    if (m_batchDepth++ == 0) {
+        m_batchStatistics = m_accessTrace.back();
+        m_batchAccessed = false;
+    }
+    if (m_nextLevel) {
+        m_nextLevel->beginBatch();
+    }
+}
+
+void CacheSim::finishBatch() {
+    // As for single accesses, the next level is finished first, such that the statistics of the entire hierarchy are
+    // up to date once this level signals a change of its hit rate
+    if (m_nextLevel) {
+        m_nextLevel->finishBatch();
+    }
+    Q_ASSERT(m_batchDepth > 0);
+    if (--m_batchDepth != 0) {
+        return;
+    }
+
+    for (const auto& trace : m_batchTraces) {
+        pushTrace(trace);
+    }
+    m_batchTraces.clear();
+    if (!m_batchAccessed) {
+        return;
+    }
+    m_accessTrace.append(currentCycle(), m_batchStatistics);
+    publishStatistics();
+    if (!isAsynchronouslyAccessed()) {
+        // Several ways may have changed; the entire view is redrawn
+        emit hitrateChanged();
+        emit cacheInvalidated();
+    }
+}
+
+unsigned CacheSim::getNextLevelLatency() const {
+    return m_nextLevel ? m_nextLevel->getHitLatency() : m_memoryLatency;
+}
+
+void CacheSim::access(uint32_t address, AccessType type, uint32_t pc) {
+    RIPES_PROFILE_SCOPE("CacheSim::access");
     // At this point, no further changes shall be made to the transaction.
     // We record the transaction as well as a possible eviction
-    trace.oldWay = oldWay;
-    trace.transaction = transaction;
-    pushTrace(trace);
-    pushAccessTrace(transaction);
+    CacheTrace trace;
+    trace.cycle = currentCycle();
+    trace.pc = pc;
+    if (m_stallOnMiss && type != AccessType::Prefetch) {
+        // The processor determines its stall cycles from the state of the cache before the access
+        m_lastStall = {trace.cycle, address & ~0b11u, getMissPenalty(address, type)};
+    }
+    updateCache(address, type, trace);
+    const CacheTransaction& transaction = trace.transaction;
+    const bool prefetch = type == AccessType::Prefetch;
+    if (prefetch && transaction.isHit) {
+        // Dropped prefetch
+        return;
+    }
+    if (!prefetch) {
+        trainPrefetcher(trace);
+        accessShadowCaches(address, type, true);
+    }
+    if (m_context->hasView()) {
+        // Undo traces are only consumed when a view reverses the processor
+        if (m_batchDepth != 0) {
+            m_batchTraces.push_back(trace);
+        } else {
+            pushTrace(trace);
+        }
+    }
+    // The next level is accessed before the statistics of this level are updated, such that the statistics of the
+    // entire hierarchy are up to date once this level signals a change of its hit rate
+    propagate(trace, AccessMode::Simulated);
+    pushAccessTrace(transaction, pc);
+    if (!prefetch) {
+        issuePrefetches(AccessMode::Simulated, pc);
+    }
 
     // === Some sanity checking ===
     // It should never be possible that a read returns an invalid way index
@@ -329,17 +966,25 @@ void CacheSim::access(uint32_t address, AccessType type) {
     }
 
     // ===========================
+    const bool writeMissNoAlloc =
+        !transaction.isHit && type == AccessType::Write && getWriteAllocPolicy() == WriteAllocPolicy::NoWriteAllocate;
     if (writeMissNoAlloc) {
         // There are no graphical changes to perform since nothing is pulled into the cache upon a missed write without
         // write allocation
         return;
     }
 
-    if (isAsynchronouslyAccessed()) {
+    if (isAsynchronouslyAccessed() || m_batchDepth != 0) {
         return;
     }
 
-    emit dataChanged(&transaction);
+    if (prefetch) {
+        // Prefetch fills are redrawn without being highlighted, such that the demand access which triggered them,
+        // signalled after its prefetches, remains the highlighted transaction of the cycle
+        emit wayInvalidated(transaction.index.line, transaction.index.way);
+    } else {
+        emit dataChanged(&transaction);
+    }
 }
 
 bool CacheSim::isAsynchronouslyAccessed() const {
@@ -350,42 +995,67 @@ void CacheSim::undo() {
     if (m_traceStack.size() == 0)
         return;
 
-    const auto trace = popTrace();
+    // Undo all accesses of the most recent cycle, in reverse order
+    const uint64_t cycle = m_traceStack.front().cycle;
+    while (m_traceStack.size() > 0 && m_traceStack.front().cycle == cycle) {
+        undoTrace(popTrace());
+    }
     popAccessTrace();
 
+    // Finally, re-emit the transaction which occurred in the previous demand access to update the cache
+    // highlighting state
+    const auto previous = std::find_if(m_traceStack.begin(), m_traceStack.end(), [](const CacheTrace& trace) {
+        return trace.transaction.type != AccessType::Prefetch;
+    });
+    if (previous != m_traceStack.end()) {
+        emit dataChanged(&previous->transaction);
+    } else {
+        emit dataChanged(nullptr);
+    }
+}
+
+void CacheSim::undoTrace(const CacheTrace& trace) {
     const auto& oldWay = trace.oldWay;
     const auto& transaction = trace.transaction;
     const unsigned& lineIdx = trace.transaction.index.line;
     const unsigned& blockIdx = trace.transaction.index.block;
     const unsigned& wayIdx = trace.transaction.index.way;
-    auto& line = m_cacheLines.at(lineIdx);
-    auto& way = line.at(wayIdx);
+
+    m_prefetcher.undo(trace.prefetcherUndo);
+    m_missClassifier.undo(trace.classifierUndo);
+    m_writeBuffer.undo(trace.writeBufferUndo);
+    m_victimCache.undo(trace.victimUndo);
+    if (trace.drewRandomWay) {
+        m_store.randomDraws--;
+    }
+    if (transaction.type != AccessType::Prefetch) {
+        (transaction.isHit ? m_store.lineHits : m_store.lineMisses)[lineIdx]--;
+    }
+
+    if (wayIdx == s_invalidIndex) {
+        // Case 0: A write miss without write allocation, which did not modify the cache
+        return;
+    }
 
     // Case 1: A cache way was transitioned to valid. In this case, we simply invalidate the cache way
     if (trace.transaction.transToValid) {
         // Invalidate the way
-        Q_ASSERT(m_cacheLines.at(lineIdx).count(wayIdx) != 0);
-        way = CacheWay();
+        writeWay(entryIdx(lineIdx, wayIdx), CacheWay());
     }
     // Case 2: A miss occured on a valid entry. In this case, we have to restore the old way, which was evicted
     // - Restore the old entry which was evicted
     else if (!trace.transaction.isHit) {
-        way = oldWay;
+        writeWay(entryIdx(lineIdx, wayIdx), oldWay);
+    }
+    // Case 3: Else, it was a cache hit, and only the replacement fields and prefetch flags needs to be updated
+    else if (transaction.usefulPrefetch) {
+        m_store.prefetched[entryIdx(lineIdx, wayIdx)] = oldWay.prefetched;
     }
-    // Case 3: Else, it was a cache hit, and only the replacement fields needs to be updated
 
-    revertCacheLineReplFields(line, oldWay, wayIdx);
+    revertCacheLineReplFields(trace);
 
     // Notify that changes to the way has been performed
     emit wayInvalidated(lineIdx, wayIdx);
-
-    // Finally, re-emit the transaction which occurred in the previous cache access to update the cache
-    // highlighting state
-    if (m_traceStack.size() > 0) {
-        emit dataChanged(&m_traceStack.begin()->transaction);
-    } else {
-        emit dataChanged(nullptr);
-    }
 }
 
 CacheSim::CacheTrace CacheSim::popTrace() {
@@ -397,7 +1067,9 @@ CacheSim::CacheTrace CacheSim::popTrace() {
 
 void CacheSim::pushTrace(const CacheTrace& eviction) {
     m_traceStack.push_front(eviction);
-    if (m_traceStack.size() > vsrtl::core::ClockedComponent::reverseStackSize()) {
+    // Only the accesses of the cycles which the processor can be reversed through are retained
+    const uint64_t reversible = vsrtl::core::ClockedComponent::reverseStackSize();
+    while (!m_traceStack.empty() && m_traceStack.back().cycle + reversible <= eviction.cycle) {
         m_traceStack.pop_back();
     }
 }
@@ -428,17 +1100,394 @@ unsigned CacheSim::getBlockIdx(const uint32_t address) const {
     return maskedAddress;
 }
 
-const CacheSim::CacheLine* CacheSim::getLine(unsigned idx) const {
-    if (m_cacheLines.count(idx)) {
-        return &m_cacheLines.at(idx);
-    } else {
-        return nullptr;
+void CacheSim::warmup(uint32_t address, AccessType type, uint32_t pc) {
+    m_warmupAccesses++;
+    CacheTrace trace;
+    trace.cycle = m_warmupAccesses;
+    trace.pc = pc;
+    updateCache(address, type, trace);
+    const bool prefetch = type == AccessType::Prefetch;
+    if (prefetch && trace.transaction.isHit) {
+        return;
+    }
+    if (!prefetch) {
+        trainPrefetcher(trace);
+        accessShadowCaches(address, type, false);
+    }
+    propagate(trace, AccessMode::Warmup);
+    if (!prefetch) {
+        issuePrefetches(AccessMode::Warmup, pc);
     }
 }
 
+void CacheSim::beginReplay() {
+    clearState();
+    m_replayStatistics = CacheAccessTrace();
+    if (m_nextLevel) {
+        m_nextLevel->beginReplay();
+    }
+}
+
+void CacheSim::replayAccess(uint32_t address, AccessType type, uint32_t pc) {
+    // As for warmup accesses, replayed accesses are distinguished and timed by their count
+    m_warmupAccesses++;
+    CacheTrace trace;
+    trace.cycle = m_warmupAccesses;
+    trace.pc = pc;
+    updateCache(address, type, trace);
+    const bool prefetch = type == AccessType::Prefetch;
+    if (prefetch && trace.transaction.isHit) {
+        return;
+    }
+    if (!prefetch) {
+        trainPrefetcher(trace);
+        accessShadowCaches(address, type, true);
+    }
+    updateWarmup(m_warmupAccesses, type, pc, m_replayStatistics);
+    m_replayStatistics = accumulate(m_replayStatistics, trace.transaction);
+    propagate(trace, AccessMode::Replayed);
+    if (!prefetch) {
+        issuePrefetches(AccessMode::Replayed, pc);
+    }
+}
+
+void CacheSim::finishReplay() {
+    const uint64_t cycle = m_context->getProcessor()->getCycleCount();
+    m_accessTrace.append(cycle, m_replayStatistics);
+    if (!m_warmingUp) {
+        // Replayed accesses are timed by their count, whereas the trace entry is of the current cycle
+        m_statisticsStart = std::min(m_statisticsStart, cycle);
+    }
+    publishStatistics();
+    if (!isAsynchronouslyAccessed()) {
+        emit hitrateChanged();
+        emit cacheInvalidated();
+    }
+    if (m_nextLevel) {
+        m_nextLevel->finishReplay();
+    }
+}
+
+template <typename NextAccess>
+unsigned long long CacheSim::replayHierarchy(CacheSim* instrCache, CacheSim* dataCache, NextAccess&& next) {
+    // Levels shared by both caches are reset and finished twice, which is harmless as nothing is replayed in between
+    for (auto* cache : {instrCache, dataCache}) {
+        if (cache) {
+            cache->beginReplay();
+        }
+    }
+    // Runs of accesses to the same cache are replayed as batches, preserving the order of all accesses
+    constexpr size_t batchSize = 1024;
+    std::vector<Access> batch;
+    batch.reserve(batchSize);
+    CacheSim* batchCache = nullptr;
+    const auto flush = [&] {
+        if (batchCache) {
+            batchCache->accessBatch(batch.data(), batch.size(), AccessMode::Replayed);
+        }
+        batch.clear();
+    };
+
+    unsigned long long replayed = 0;
+    CacheTraceReader::Access access;
+    while (next(access)) {
+        CacheSim* cache = access.instruction ? instrCache : dataCache;
+        if (!cache) {
+            continue;
+        }
+        if (cache != batchCache || batch.size() == batchSize) {
+            flush();
+            batchCache = cache;
+        }
+        Access batched;
+        batched.address = access.address;
+        batched.type = access.write ? AccessType::Write : AccessType::Read;
+        batched.pc = access.pc;
+        batch.push_back(batched);
+        replayed++;
+    }
+    flush();
+    for (auto* cache : {instrCache, dataCache}) {
+        if (cache) {
+            cache->finishReplay();
+        }
+    }
+    return replayed;
+}
+
+unsigned long long CacheSim::replay(CacheTraceReader& trace, CacheSim* instrCache, CacheSim* dataCache) {
+    return replayHierarchy(instrCache, dataCache, [&trace](CacheTraceReader::Access& access) {
+        return trace.next(access);
+    });
+}
+
+unsigned long long CacheSim::replay(const std::vector<CacheTraceReader::Access>& accesses, CacheSim* instrCache,
+                                    CacheSim* dataCache) {
+    auto it = accesses.begin();
+    return replayHierarchy(instrCache, dataCache, [&](CacheTraceReader::Access& access) {
+        if (it == accesses.end()) {
+            return false;
+        }
+        access = *it++;
+        return true;
+    });
+}
+
+unsigned long long CacheSim::replay(CacheTraceReader& trace) {
+    return replay(trace, m_type != CacheType::DataCache ? this : nullptr,
+                  m_type != CacheType::InstrCache ? this : nullptr);
+}
+
+unsigned long long CacheSim::replay(const std::vector<CacheTraceReader::Access>& accesses) {
+    return replay(accesses, m_type != CacheType::DataCache ? this : nullptr,
+                  m_type != CacheType::InstrCache ? this : nullptr);
+}
+
+void CacheSim::accessesTraced(const std::vector<vsrtl::core::TracedMemoryAccess>& accesses) {
+    using vsrtl::core::TracedMemoryAccess;
+    m_tracedBatch.clear();
+    for (const auto& traced : accesses) {
+        const bool fetch = traced.kind == TracedMemoryAccess::Fetch;
+        if (fetch != (m_type == CacheType::InstrCache)) {
+            continue;
+        }
+        Access access;
+        access.address = traced.address;
+        access.type = traced.kind == TracedMemoryAccess::Store ? AccessType::Write : AccessType::Read;
+        access.pc = traced.pc;
+        m_tracedBatch.push_back(access);
+    }
+    accessBatch(m_tracedBatch.data(), m_tracedBatch.size(), AccessMode::Warmup);
+}
+
+CacheSim::CacheLineView CacheSim::getLine(unsigned idx) const {
+    const unsigned base = entryIdx(idx, 0);
+    CacheLineView line;
+    line.m_tags = &m_store.tags[base];
+    line.m_repl = &m_store.repl[base];
+    line.m_valid = &m_store.valid[base];
+    line.m_dirty = &m_store.dirty[base];
+    line.m_dirtyBlocks = &m_store.dirtyBlocks[base * m_store.dirtyWords];
+    line.m_dirtyWords = m_store.dirtyWords;
+    return line;
+}
+
 void CacheSim::processorWasClocked() {
+    const long long cycle = m_context->getProcessor()->getCycleCount();
+    auto& queue = m_context->getCacheAccessQueue();
+    if (!queue.isRunning()) {
+        accessCurrentCycle();
+        recordCheckpoint(cycle);
+        return;
+    }
+
+    // The processor signals are sampled now, whereas the cache is simulated by the consumer of the queue
+    CacheAccessQueue::Record record;
+    record.cache = this;
+    record.cycle = cycle;
+    AccessType type = AccessType::Read;
+    record.access = currentCycleAccess(record.address, type, record.pc);
+    record.write = type == AccessType::Write;
+    if (m_context->isCheckpointCycle(cycle)) {
+        record.checkpointInterval = m_context->getCheckpointInterval();
+    }
+    if (record.access || record.checkpointInterval != 0) {
+        queue.push(record);
+    }
+}
+
+template <typename IsCheckpointCycle>
+void CacheSim::recordCheckpoint(long long cycle, const IsCheckpointCycle& isCheckpointCycle) {
+    if (isCheckpointCycle(cycle)) {
+        // Drop checkpoints which have been discarded by the processor handler
+        for (auto it = m_checkpoints.begin(); it != m_checkpoints.end();) {
+            it = isCheckpointCycle(it->first) ? std::next(it) : m_checkpoints.erase(it);
+        }
+        m_checkpoints[cycle] = {m_store, m_prefetcher, m_missClassifier, m_writeBuffer, m_victimCache};
+    }
+    if (m_nextLevel) {
+        // Lower levels are not clocked themselves, and are checkpointed once their upper levels have accessed them in
+        // the cycle. A shared level is thus checkpointed once per upper level, the last of which is retained.
+        m_nextLevel->recordCheckpoint(cycle, isCheckpointCycle);
+    }
+}
+
+void CacheSim::recordCheckpoint(long long cycle) {
+    recordCheckpoint(cycle,
+                     [this](long long checkpointCycle) { return m_context->isCheckpointCycle(checkpointCycle); });
+}
+
+void CacheSim::simulateQueued(const CacheAccessQueue::Record& record) {
+    if (record.access) {
+        access(record.address, record.write ? AccessType::Write : AccessType::Read, record.pc);
+    }
+    if (record.checkpointInterval != 0) {
+        // The checkpoints of the processor handler are modified by the producer, and are thus not consulted here.
+        // Whilst running, the handler only retains the checkpoints at multiples of its interval.
+        const long long interval = record.checkpointInterval;
+        recordCheckpoint(record.cycle, [&record, interval](long long checkpointCycle) {
+            return checkpointCycle == record.cycle || checkpointCycle % interval == 0;
+        });
+    }
+}
+
+uint64_t CacheSim::currentCycle() const {
+    if (CacheAccessQueue::isConsumerThread()) {
+        // The processor runs ahead of the decoupled cache
+        return CacheAccessQueue::currentCycle();
+    }
+    return m_context->getProcessor()->getCycleCount();
+}
+
+void CacheSim::checkpointRestored(long long cycle) {
+    if (m_type == CacheType::UnifiedCache && !isLowerLevel()) {
+        // Not part of any hierarchy, and thus never accessed
+        return;
+    }
+    Q_ASSERT(m_checkpoints.count(cycle) != 0);
+    const Checkpoint& checkpoint = m_checkpoints.at(cycle);
+    m_store = checkpoint.store;
+    m_prefetcher = checkpoint.prefetcher;
+    m_missClassifier = checkpoint.missClassifier;
+    m_writeBuffer = checkpoint.writeBuffer;
+    m_victimCache = checkpoint.victimCache;
+    m_checkpoints.erase(m_checkpoints.upper_bound(cycle), m_checkpoints.end());
+    m_accessTrace.truncate(cycle);
+    revertStatisticsStart();
+    publishStatistics();
+    // Trace entries are pushed anew while the processor re-simulates forward from the checkpoint
+    m_traceStack.clear();
+
+    emit hitrateChanged();
+    emit cacheInvalidated();
+}
+
+namespace {
+// Fields of the access statistics, in the order in which they are written to snapshots
+constexpr uint64_t CacheAccessTrace::*s_snapshotStatistics[] = {&CacheAccessTrace::hits,
+                                                                &CacheAccessTrace::misses,
+                                                                &CacheAccessTrace::reads,
+                                                                &CacheAccessTrace::writes,
+                                                                &CacheAccessTrace::writebacks,
+                                                                &CacheAccessTrace::prefetches,
+                                                                &CacheAccessTrace::usefulPrefetches,
+                                                                &CacheAccessTrace::latePrefetches,
+                                                                &CacheAccessTrace::pollutingPrefetches,
+                                                                &CacheAccessTrace::compulsoryMisses,
+                                                                &CacheAccessTrace::capacityMisses,
+                                                                &CacheAccessTrace::conflictMisses,
+                                                                &CacheAccessTrace::victimHits,
+                                                                &CacheAccessTrace::coalescedWrites,
+                                                                &CacheAccessTrace::writeBufferStalls};
+}  // namespace
+
+void CacheSim::writeSnapshot(SnapshotWriter& out) const {
+    out.put(static_cast<uint32_t>(getLines()));
+    out.put(static_cast<uint32_t>(getWays()));
+    out.put(static_cast<uint32_t>(getBlocks()));
+    out.put(static_cast<uint32_t>(m_replPolicy));
+
+    out.putVector(m_store.tags);
+    out.putVector(m_store.repl);
+    out.putVector(m_store.valid);
+    out.putVector(m_store.dirty);
+    out.putVector(m_store.dirtyBlocks);
+    out.putVector(m_store.prefetched);
+    out.putVector(m_store.prefetchTime);
+    out.putVector(m_store.plruTree);
+    out.putVector(m_store.fifoNext);
+    out.putVector(m_store.lineHits);
+    out.putVector(m_store.lineMisses);
+
+    const CacheAccessTrace& statistics = m_accessTrace.back();
+    for (const auto field : s_snapshotStatistics) {
+        out.put(statistics.*field);
+    }
+}
+
+bool CacheSim::readSnapshot(SnapshotReader& in, SnapshotState& state, QString& error) const {
+    const uint32_t lines = in.get<uint32_t>();
+    const uint32_t ways = in.get<uint32_t>();
+    const uint32_t blocks = in.get<uint32_t>();
+    const uint32_t replPolicy = in.get<uint32_t>();
+    if (!in.ok()) {
+        error = "Truncated cache state";
+        return false;
+    }
+    if (lines != static_cast<uint32_t>(getLines()) || ways != static_cast<uint32_t>(getWays()) ||
+        blocks != static_cast<uint32_t>(getBlocks()) || replPolicy != static_cast<uint32_t>(m_replPolicy)) {
+        error = QString("The snapshot was taken with a cache of %1 lines, %2 ways and %3 words per block, or another "
+                        "replacement policy")
+                    .arg(lines)
+                    .arg(ways)
+                    .arg(blocks);
+        return false;
+    }
+
+    TagStore& store = state.store;
+    in.getVector(store.tags);
+    in.getVector(store.repl);
+    in.getVector(store.valid);
+    in.getVector(store.dirty);
+    in.getVector(store.dirtyBlocks);
+    in.getVector(store.prefetched);
+    in.getVector(store.prefetchTime);
+    in.getVector(store.plruTree);
+    in.getVector(store.fifoNext);
+    in.getVector(store.lineHits);
+    in.getVector(store.lineMisses);
+    for (const auto field : s_snapshotStatistics) {
+        state.statistics.*field = in.get<uint64_t>();
+    }
+
+    // The arrays must be sized as per the geometry of the cache
+    TagStore expected;
+    expected.reset(getLines(), getWays(), getBlocks());
+    store.dirtyWords = expected.dirtyWords;
+    if (!in.ok() || store.tags.size() != expected.tags.size() || store.repl.size() != expected.repl.size() ||
+        store.valid.size() != expected.valid.size() || store.dirty.size() != expected.dirty.size() ||
+        store.dirtyBlocks.size() != expected.dirtyBlocks.size() ||
+        store.prefetched.size() != expected.prefetched.size() ||
+        store.prefetchTime.size() != expected.prefetchTime.size() ||
+        store.plruTree.size() != expected.plruTree.size() || store.fifoNext.size() != expected.fifoNext.size() ||
+        store.lineHits.size() != expected.lineHits.size() || store.lineMisses.size() != expected.lineMisses.size()) {
+        error = "Malformed cache state";
+        return false;
+    }
+    return true;
+}
+
+void CacheSim::restoreSnapshot(SnapshotState&& state, long long cycle) {
+    m_store = std::move(state.store);
+    m_accessTrace.clear();
+    m_accessTrace.append(cycle, state.statistics);
+    restartStatistics();
+    publishStatistics();
+    m_traceStack.clear();
+    m_checkpoints.clear();
+    if (m_context->isCheckpointCycle(cycle)) {
+        m_checkpoints[cycle] = {m_store, m_prefetcher, m_missClassifier, m_writeBuffer, m_victimCache};
+    }
+
+    emit hitrateChanged();
+    emit cacheInvalidated();
+}
+
+void CacheSim::accessCurrentCycle() {
+    uint32_t address, pc;
+    AccessType type;
+    if (currentCycleAccess(address, type, pc)) {
+        access(address, type, pc);
+    }
+}
+
+bool CacheSim::currentCycleAccess(uint32_t& address, AccessType& type, uint32_t& pc) const {
+    if (m_type != CacheType::UnifiedCache &&
+        m_context->getProcessor()->isRepeatedMemoryAccess(m_type == CacheType::InstrCache)) {
+        // The processor is stalled on an access which was simulated in the cycle it was issued
+        return false;
+    }
     if (m_type == CacheType::DataCache) {
-        AccessType type;
         // Determine whether the memory is being accessed in the current cycle, and if so, the access type.
         switch (m_memory.rw->op.uValue()) {
             case MemOp::SB:
@@ -449,7 +1498,7 @@ void CacheSim::processorWasClocked() {
                     break;
                 } else {
                     // Nothing to do
-                    return;
+                    return false;
                 }
             case MemOp::LB:
             case MemOp::LBU:
@@ -461,24 +1510,31 @@ void CacheSim::processorWasClocked() {
             case MemOp::NOP:
             default:
                 // Nothing to do
-                return;
+                return false;
         }
 
-        access(m_memory.rw->addr.uValue(), type);
-    } else {
+        const auto* proc = m_context->getProcessor();
+        address = m_memory.rw->addr.uValue();
+        pc = proc->getPcForStage(proc->dataAccessStage());
+        return true;
+    } else if (m_type == CacheType::InstrCache) {
         // ROM; read in every cycle
-        access(m_memory.rom->addr.uValue(), AccessType::Read);
+        address = m_memory.rom->addr.uValue();
+        type = AccessType::Read;
+        pc = address;
+        return true;
     }
+    return false;
 }
 
 void CacheSim::processorWasReversed() {
-    if (m_accessTrace.size() == 0) {
+    if (m_accessTrace.empty()) {
         // Nothing to reverse
         return;
     }
 
-    const unsigned cycleToUndo = ProcessorHandler::get()->getProcessor()->getCycleCount() + 1;
-    if (m_accessTrace.rbegin()->first != cycleToUndo) {
+    const uint64_t cycleToUndo = m_context->getProcessor()->getCycleCount() + 1;
+    if (m_accessTrace.backCycle() != cycleToUndo) {
         // No cache access in this cycle
         return;
     }
@@ -487,11 +1543,41 @@ void CacheSim::processorWasReversed() {
     undo();
 }
 
-void CacheSim::updateConfiguration() {
-    // Cache configuration changed. Reset all state
-    m_cacheLines.clear();
+void CacheSim::clearState() {
+    resetTagStore();
     m_accessTrace.clear();
+    restartStatistics();
+    publishStatistics();
     m_traceStack.clear();
+    m_checkpoints.clear();
+    m_warmupAccesses = 0;
+    m_reuseDistances.reset();
+    m_prefetcher.reset();
+    m_missClassifier.reset();
+    m_writeBuffer.reset();
+    m_victimCache.reset();
+    m_lastStall = StallRecord();
+    if (m_dram) {
+        m_dram->reset();
+    }
+    for (auto& shadow : m_shadowCaches) {
+        shadow->reset();
+    }
+}
+
+void CacheSim::updateConfiguration() {
+    // Cache configuration changed. Reset all state
+    clearState();
+    m_resetUpperLevels.clear();
+    if (m_analyzeReuseDistances) {
+        m_reuseDistances.configure(m_blocks, s_maxReuseLineBits, 1u << s_maxReuseWayBits);
+    } else {
+        m_reuseDistances.configure(m_blocks, -1, 0);
+    }
+    m_prefetcher.configure(m_prefetcherConfig, m_blocks);
+    m_missClassifier.configure(m_blocks, getLines() * getWays());
+    m_writeBuffer.configure(m_wrPolicy == WritePolicy::WriteThrough ? m_writeBufferEntries : 0, m_blocks);
+    m_victimCache.configure(m_victimCacheEntries, m_blocks);
 
     // Recalculate masks
     int bitoffset = 2;  // 2^2 = 4-byte offset (32-bit words in cache)
@@ -507,58 +1593,145 @@ void CacheSim::updateConfiguration() {
     // Reset the graphical view & processor
     emit configurationChanged();
 
+    if (m_nextLevel) {
+        m_nextLevel->resetFromUpperLevel(this);
+    }
+
     if (m_memory.rw || m_memory.rom) {
         // Reload the initial (cycle 0) state of the processor. This is necessary to reflect ie. the instruction which
         // is loaded from the instruction memory in cycle 0.
-        processorWasClocked();
+        accessCurrentCycle();
+        if (m_stallOnMiss) {
+            // The processor was reset before the cache, and thus stalled on the cache in its state prior to the reset
+            m_context->getProcessorNonConst()->memoryLatenciesChanged();
+        }
     }
 }
 
-void CacheSim::processorReset() {
-    /** see comment of m_isResetting */
-    if (m_isResetting) {
-        return;
+void CacheSim::resetFromUpperLevel(const CacheSim* upper) {
+    if (m_resetUpperLevels.empty() || m_resetUpperLevels.count(upper) != 0) {
+        m_resetUpperLevels.clear();
+        connectProcessor();
+        clearState();
+        emit hitrateChanged();
+        emit cacheInvalidated();
+        if (m_nextLevel) {
+            m_nextLevel->resetFromUpperLevel(this);
+        }
     }
+    m_resetUpperLevels.insert(upper);
+}
 
-    m_isResetting = true;
+void CacheSim::connectProcessor() {
     // The processor might have changed. Since our signals/slot library cannot check for existing connection, we do the
     // safe, slightly redundant, thing of disconnecting and reconnecting the VSRTL design update signals.
     reassociateMemory();
-    auto* proc = ProcessorHandler::get()->getProcessorNonConst();
-    proc->designWasClocked.Connect(this, &CacheSim::processorWasClocked);
+    auto* proc = m_context->getProcessorNonConst();
+    if (m_type != CacheType::UnifiedCache) {
+        // Lower levels are accessed and checkpointed by their upper levels
+        proc->designWasClocked.Connect(this, &CacheSim::processorWasClocked);
+    }
     proc->designWasReversed.Connect(this, &CacheSim::processorWasReversed);
     proc->designWasReset.Connect(this, &CacheSim::processorReset);
+    auto* fastEngine = m_context->getFastEngine();
+    fastEngine->accessesTraced.Disconnect(this, &CacheSim::accessesTraced);
+    if (m_type != CacheType::UnifiedCache) {
+        fastEngine->accessesTraced.Connect(this, &CacheSim::accessesTraced);
+    }
+    // The interpreter only warms up the cache, without recording statistics nor modelling its latencies, such that the
+    // accesses of a cache must be simulated by the current processor. Lower levels are accessed by their upper levels.
+    m_context->setDetailedObserver(this, m_type != CacheType::UnifiedCache);
+}
 
+void CacheSim::reconfigure() {
+    /** see comment of m_isResetting */
+    if (m_isResetting) {
+        return;
+    }
+
+    m_isResetting = true;
+    connectProcessor();
     updateConfiguration();
     m_isResetting = false;
 }
 
+void CacheSim::processorReset() {
+    if (isLowerLevel()) {
+        // Shared levels are reset by their upper levels, once these are reset (see resetFromUpperLevel)
+        return;
+    }
+    reconfigure();
+}
+
 void CacheSim::setBlocks(unsigned blocks) {
     m_blocks = blocks;
-    processorReset();
+    reconfigure();
 }
 void CacheSim::setLines(unsigned lines) {
     m_lines = lines;
-    processorReset();
+    reconfigure();
 }
 void CacheSim::setWays(unsigned ways) {
     m_ways = ways;
-    processorReset();
+    reconfigure();
+}
+
+void CacheSim::addShadowCache(const CachePreset& preset) {
+    Q_ASSERT(m_shadowCaches.size() < s_maxShadowCaches);
+    m_shadowCaches.push_back(std::make_unique<ShadowCache>(preset));
+    emit shadowCachesChanged();
+}
+
+void CacheSim::removeShadowCache(unsigned idx) {
+    Q_ASSERT(idx < m_shadowCaches.size());
+    m_shadowCaches.erase(m_shadowCaches.begin() + idx);
+    emit shadowCachesChanged();
+}
+
+void CacheSim::accessShadowCaches(uint32_t address, AccessType type, bool record) {
+    for (auto& shadow : m_shadowCaches) {
+        shadow->access(address, type, record);
+    }
 }
 
 void CacheSim::setWritePolicy(WritePolicy policy) {
     m_wrPolicy = policy;
-    processorReset();
+    reconfigure();
 }
 
 void CacheSim::setWriteAllocatePolicy(WriteAllocPolicy policy) {
     m_wrAllocPolicy = policy;
-    processorReset();
+    reconfigure();
 }
 
 void CacheSim::setReplacementPolicy(ReplPolicy policy) {
     m_replPolicy = policy;
-    processorReset();
+    reconfigure();
+}
+
+void CacheSim::setReuseDistanceAnalysis(bool enabled) {
+    m_analyzeReuseDistances = enabled;
+    reconfigure();
+}
+
+void CacheSim::setPrefetcher(const Prefetcher::Config& config) {
+    m_prefetcherConfig = config;
+    reconfigure();
+}
+
+void CacheSim::setWriteBuffer(unsigned entries) {
+    m_writeBufferEntries = std::min(entries, s_maxBufferEntries);
+    reconfigure();
+}
+
+void CacheSim::setVictimCache(unsigned entries) {
+    m_victimCacheEntries = std::min(entries, s_maxBufferEntries);
+    reconfigure();
+}
+
+void CacheSim::setSeed(uint32_t seed) {
+    m_seed = seed;
+    reconfigure();
 }
 
 void CacheSim::setPreset(const CachePreset& preset) {
@@ -568,8 +1741,9 @@ void CacheSim::setPreset(const CachePreset& preset) {
     m_wrPolicy = preset.wrPolicy;
     m_wrAllocPolicy = preset.wrAllocPolicy;
     m_replPolicy = preset.replPolicy;
+    m_seed = preset.seed;
 
-    processorReset();
+    reconfigure();
 }
 
 }  // namespace Ripes
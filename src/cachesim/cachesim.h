@@ -2,18 +2,41 @@
 
 #include <math.h>
 #include <map>
+#include <memory>
+#include <set>
 #include <vector>
 
 #include <QObject>
 
 #include "../external/VSRTL/core/vsrtl_register.h"
+#include "cacheaccessqueue.h"
+#include "cacheaccesstrace.h"
+#include "cachetrace.h"
+#include "dram.h"
+#include "missclassifier.h"
+#include "prefetcher.h"
 #include "processors/RISC-V/rv_memory.h"
+#include "reusedistance.h"
+#include "snapshot.h"
+#include "victimcache.h"
+#include "writebuffer.h"
+
+namespace vsrtl {
+namespace core {
+struct TracedMemoryAccess;
+}
+}  // namespace vsrtl
 
 using RWMemory = vsrtl::core::RVMemory<32, 32>;
 using ROMMemory = vsrtl::core::ROM<32, 32>;
 
 namespace Ripes {
 
+class ProcessorHandler;
+class ShadowCache;
+class SnapshotReader;
+class SnapshotWriter;
+
 class CacheSim : public QObject {
     Q_OBJECT
 public:
@@ -21,9 +44,19 @@ public:
 
     enum class WriteAllocPolicy { WriteAllocate, NoWriteAllocate };
     enum class WritePolicy { WriteThrough, WriteBack };
-    enum class ReplPolicy { Random, LRU };
-    enum class AccessType { Read, Write };
-    enum class CacheType { DataCache, InstrCache };
+    enum class ReplPolicy { Random, LRU, PLRU, FIFO, LFU, SRRIP };
+    /**
+     * @brief The AccessType enum
+     * Prefetches are issued by the prefetcher of the cache (see setPrefetcher). A prefetch of a block which is already
+     * present is dropped; otherwise, the block is filled as for a read miss, without counting as a demand miss.
+     */
+    enum class AccessType { Read, Write, Prefetch };
+    /**
+     * @brief The CacheType enum
+     * Data and instruction caches are bound to the data and instruction memories of the processor. Unified caches are
+     * not bound to any memory, and are only accessed as the next level of other caches (see setNextLevel).
+     */
+    enum class CacheType { DataCache, InstrCache, UnifiedCache };
 
     struct CacheSize {
         unsigned bits = 0;
@@ -38,17 +71,34 @@ public:
         WritePolicy wrPolicy;
         WriteAllocPolicy wrAllocPolicy;
         ReplPolicy replPolicy;
+
+        /**
+         * @brief seed
+         * Seed of the random replacement policy. Caches sharing a configuration and seed make identical replacement
+         * decisions.
+         */
+        uint32_t seed = 0;
     };
 
+    /**
+     * @brief The CacheWay struct
+     * Copy of the state of a single way of the cache, as recorded for undoing accesses to the way.
+     */
     struct CacheWay {
         uint32_t tag = -1;
-        std::set<unsigned> dirtyBlocks;
+        // Dirty bitmask of the blocks of the way, in the layout of the tag store. Empty when no block is dirty.
+        std::vector<uint64_t> dirtyBlocks;
         bool dirty = false;
         bool valid = false;
 
-        // LRU algorithm relies on invalid cache ways to have an initial high value. -1 ensures maximum value for all
-        // way sizes.
-        unsigned lru = -1;
+        // Replacement state of the way; the LRU age, LFU use count or SRRIP re-reference prediction value. LRU
+        // algorithm relies on invalid cache ways to have an initial high value. -1 ensures maximum value for all way
+        // sizes, and marks newly allocated ways for the LFU and SRRIP policies.
+        unsigned repl = -1;
+
+        // PrefetchFlags of a way filled by a prefetch, and the time of the prefetch
+        uint8_t prefetched = 0;
+        uint64_t prefetchTime = 0;
     };
 
     struct CacheIndex {
@@ -71,47 +121,283 @@ public:
         AccessType type;
         bool transToValid = false;  // True if the cacheline just transitioned from invalid to valid
         bool tagChanged = false;    // True if transToValid or the previous entry was evicted
+        bool usefulPrefetch = false;     // True if a demand access hit a prefetched block for the first time
+        bool latePrefetch = false;       // True if usefulPrefetch, before the prefetch could have completed
+        bool pollutingPrefetch = false;  // True if an unused prefetched block which displaced a valid block was evicted
+        // Cause of a demand miss. None for hits and prefetches.
+        MissClassifier::MissType missType = MissClassifier::MissType::None;
+        bool victimHit = false;         // True if a miss was served by the victim cache rather than the next level
+        bool coalescedWrite = false;    // True if a written-through write was coalesced into the write buffer
+        bool writeBufferStall = false;  // True if a written-through write stalled on a full write buffer
     };
 
-    struct CacheAccessTrace {
-        int hits = 0;
-        int misses = 0;
-        int reads = 0;
-        int writes = 0;
-        int writebacks = 0;
-        CacheAccessTrace() {}
-        CacheAccessTrace(const CacheTransaction& transaction) : CacheAccessTrace(CacheAccessTrace(), transaction) {}
-        CacheAccessTrace(const CacheAccessTrace& pre, const CacheTransaction& transaction) {
-            reads = pre.reads + (transaction.type == AccessType::Read ? 1 : 0);
-            writes = pre.writes + (transaction.type == AccessType::Write ? 1 : 0);
-            writebacks = pre.writebacks + (transaction.isWriteback ? 1 : 0);
-            hits = pre.hits + (transaction.isHit ? 1 : 0);
-            misses = pre.misses + (transaction.isHit ? 0 : 1);
-        }
+    using CacheAccessTrace = Ripes::CacheAccessTrace;
+
+    /// An access to the cache, as performed by accessBatch
+    struct Access {
+        uint32_t address = 0;
+        AccessType type = AccessType::Read;
+        uint32_t pc = 0;
     };
 
-    using CacheLine = std::map<unsigned, CacheWay>;
+    /// @returns the statistics @p pre, accumulated with @p transaction
+    static CacheAccessTrace accumulate(const CacheAccessTrace& pre, const CacheTransaction& transaction);
+
+    /**
+     * @brief The CacheLineView class
+     * Lightweight, read-only view of the ways of a single line in the tag store of a cache. A view is invalidated
+     * whenever the cache configuration changes.
+     */
+    class CacheLineView {
+    public:
+        bool valid(unsigned way) const { return m_valid[way]; }
+        bool dirty(unsigned way) const { return m_dirty[way]; }
+        uint32_t tag(unsigned way) const { return m_tags[way]; }
+        unsigned repl(unsigned way) const { return m_repl[way]; }
+        bool isDirtyBlock(unsigned way, unsigned block) const {
+            return (m_dirtyBlocks[way * m_dirtyWords + block / 64] >> (block % 64)) & 1;
+        }
+
+    private:
+        friend class CacheSim;
+        CacheLineView() {}
+        const uint32_t* m_tags = nullptr;
+        const uint32_t* m_repl = nullptr;
+        const uint8_t* m_valid = nullptr;
+        const uint8_t* m_dirty = nullptr;
+        const uint64_t* m_dirtyBlocks = nullptr;
+        unsigned m_dirtyWords = 0;
+    };
 
-    CacheSim(QObject* parent);
+    /**
+     * @brief CacheSim
+     * Constructs a cache simulator which simulates accesses to the memories of the processor of @p context.
+     */
+    CacheSim(ProcessorHandler* context, QObject* parent);
+    ~CacheSim() override;
     void setType(CacheType type);
+    CacheType getType() const { return m_type; }
+
+    /**
+     * @brief setNextLevel
+     * Backs this cache by the unified cache @p next, or by the memory if nullptr. Blocks which miss in this cache are
+     * read from the next level, and writebacks and written-through writes are written to it. Several caches may share
+     * the same next level, which is then reset alongside its upper levels, and whose traces and checkpoints follow
+     * the cycles in which its upper levels are accessed.
+     */
+    void setNextLevel(CacheSim* next);
+    CacheSim* getNextLevel() const { return m_nextLevel; }
+
+    /**
+     * @brief setDRAM
+     * Backs this cache, if it is the last level of its hierarchy, by the DRAM timing model @p dram rather than a memory
+     * of flat latency, or by the flat memory latency if nullptr. Block fills and writebacks of the cache access the
+     * DRAM, whose latencies then make up the miss penalties and average access time of the cache. Several last levels
+     * may share the same DRAM, which is reset alongside them.
+     */
+    void setDRAM(DRAMModel* dram);
+    DRAMModel* getDRAM() const { return m_dram; }
+
+    /**
+     * @brief setHitLatency/setMemoryLatency
+     * Access latencies, in cycles, of a hit in this cache, and of the memory behind the cache if it is the last level
+     * of its hierarchy. The latencies do not affect the simulation, and are used for getAverageAccessTime() and the
+     * stall cycles of the processor (see setStallOnMiss).
+     */
+    void setHitLatency(unsigned cycles);
+    void setMemoryLatency(unsigned cycles);
+    unsigned getHitLatency() const { return m_hitLatency; }
+    unsigned getMemoryLatency() const { return m_memoryLatency; }
+
+    /**
+     * @brief getAverageAccessTime
+     * @returns the average memory access time in cycles of the accesses to this cache so far, as reported (see
+     * getStatistics); the hit latency plus the miss rate times the average access time of the next level, or the
+     * memory latency for the last level.
+     */
+    double getAverageAccessTime() const;
+    /// As above, over the accesses of the cycles in [@p first; @p last], as are the next levels
+    double getAverageAccessTime(uint64_t first, uint64_t last) const;
+
+    /**
+     * @brief setStallOnMiss
+     * If enabled, the processor is stalled for the miss penalty of each access to this instruction or data cache (see
+     * getMissPenalty), such that its cycle count reflects the behaviour of the cache hierarchy. Only applies to
+     * processors which model memory stalls (see ProcessorHandler::setMissStallCache).
+     */
+    void setStallOnMiss(bool enabled);
+    bool isStallOnMissEnabled() const { return m_stallOnMiss; }
+
+    /**
+     * @brief getMissPenalty
+     * @returns the cycles which an access of @p type to @p address adds to the hit latency, in the current state of
+     * the cache; the hit latency and miss penalty of the next level, or the memory latency for the last level, upon a
+     * miss which is filled from the next level. Hits, victim cache hits, and writes which are not allocated are not
+     * penalized; writes are written through or back without stalling for the next level.
+     */
+    unsigned getMissPenalty(uint32_t address, AccessType type) const;
+
+    /**
+     * @brief getStallCycles
+     * @returns the cycles which the processor is stalled for upon an access of @p type to @p address in the current
+     * cycle. Once the access has been simulated, this is the miss penalty recorded right before the access, such that
+     * the processor may be re-evaluated within the cycle; otherwise the miss penalty in the current state of the cache.
+     */
+    unsigned getStallCycles(uint32_t address, AccessType type) const;
+
     void setWritePolicy(WritePolicy policy);
     void setWriteAllocatePolicy(WriteAllocPolicy policy);
     void setReplacementPolicy(ReplPolicy policy);
 
-    void access(uint32_t address, AccessType type);
+    /**
+     * @brief setPrefetcher
+     * Configures the prefetcher in front of the cache. Demand accesses train the prefetcher, and the prefetches it
+     * predicts are performed right after the access which triggered them.
+     */
+    void setPrefetcher(const Prefetcher::Config& config);
+    const Prefetcher::Config& getPrefetcher() const { return m_prefetcherConfig; }
+
+    /**
+     * @brief setWriteBuffer
+     * Places a write buffer of @p entries blocks (see WriteBuffer) between the cache and its next level, which buffers
+     * the writes written through by the WriteThrough policy. Writes coalesced into the buffer are not written to the
+     * next level. A buffer of 0 entries, or any buffer of a WriteBack cache, is disabled.
+     */
+    void setWriteBuffer(unsigned entries);
+    unsigned getWriteBufferEntries() const { return m_writeBufferEntries; }
+
+    /**
+     * @brief setVictimCache
+     * Places a fully associative victim cache of @p entries blocks (see VictimCache) next to the cache, which holds the
+     * blocks most recently evicted from the cache. Misses which hit in the victim cache are not filled from the next
+     * level. A victim cache of 0 entries is disabled.
+     */
+    void setVictimCache(unsigned entries);
+    unsigned getVictimCacheEntries() const { return m_victimCacheEntries; }
+    static constexpr unsigned s_maxBufferEntries = 64;
+
+    /**
+     * @brief addShadowCache/removeShadowCache
+     * Attaches a shadow cache of @p preset (see ShadowCache), which observes the demand accesses of this cache from the
+     * moment it is attached, and is cleared along with this cache. Shadow caches are not reverted when the processor is
+     * reversed or restored to a checkpoint. Shadow caches must not be attached or removed whilst the processor runs.
+     */
+    void addShadowCache(const CachePreset& preset);
+    void removeShadowCache(unsigned idx);
+    const std::vector<std::unique_ptr<ShadowCache>>& getShadowCaches() const { return m_shadowCaches; }
+    static constexpr unsigned s_maxShadowCaches = 8;
+
+    /**
+     * @brief access
+     * Performs an access to @p address by the instruction at @p pc, as observed by the prefetcher.
+     */
+    void access(uint32_t address, AccessType type, uint32_t pc = 0);
+
+    /**
+     * @brief accessBatch
+     * Performs the @p count accesses at @p accesses in order, as per access(), within the current cycle. The undo
+     * traces of the batch are pushed, its statistics recorded as a single access trace entry, and the graphical view
+     * signalled once, when the batch is finished. The same applies to the accesses propagated to the next levels.
+     */
+    void accessBatch(const Access* accesses, size_t count);
+
+    /**
+     * @brief simulateQueued
+     * Simulates @p record, as sampled from the processor by processorWasClocked() whilst the cache is decoupled from
+     * the processor through the cache access queue of the processor handler.
+     */
+    void simulateQueued(const CacheAccessQueue::Record& record);
+
+    /**
+     * @brief warmup
+     * Updates the cache state to reflect an access to @p address, without recording the access in any traces or
+     * statistics, and without signalling the graphical view. Used for warming up the cache with accesses performed by
+     * the functional interpreter.
+     */
+    void warmup(uint32_t address, AccessType type, uint32_t pc = 0);
+
+    /**
+     * @brief replay
+     * Resets the cache and its next levels, and replays the accesses of @p trace which target the memory of this cache
+     * type (instruction fetches for instruction caches, data accesses for data caches, and all accesses for unified
+     * caches), without involving the processor. The accesses are accumulated into a single access trace entry, and
+     * the graphical view is signalled once replaying finishes.
+     * @returns the number of accesses replayed.
+     */
+    unsigned long long replay(CacheTraceReader& trace);
+    /// Replays @p accesses, as read from a trace, as per replay(CacheTraceReader&)
+    unsigned long long replay(const std::vector<CacheTraceReader::Access>& accesses);
+    /**
+     * @brief replay
+     * Replays @p trace through the hierarchies below @p instrCache and @p dataCache (either of which may be nullptr,
+     * or both the same unified cache), dispatching each access in trace order to the first level cache of its type.
+     * The levels shared by both caches thus observe the interleaved misses of both.
+     * @returns the number of accesses replayed.
+     */
+    static unsigned long long replay(CacheTraceReader& trace, CacheSim* instrCache, CacheSim* dataCache);
+    static unsigned long long replay(const std::vector<CacheTraceReader::Access>& accesses, CacheSim* instrCache,
+                                     CacheSim* dataCache);
     void undo();
     void processorReset();
 
     WriteAllocPolicy getWriteAllocPolicy() const { return m_wrAllocPolicy; }
     ReplPolicy getReplacementPolicy() const { return m_replPolicy; }
+    uint32_t getSeed() const { return m_seed; }
     WritePolicy getWritePolicy() const { return m_wrPolicy; }
 
-    const std::map<unsigned, CacheAccessTrace>& getAccessTrace() const { return m_accessTrace; }
+    const CacheAccessTraceBuffer& getAccessTrace() const { return m_accessTrace; }
 
+    /// Hit rate, hits, misses and writebacks of the cache, as reported (see getStatistics)
     double getHitRate() const;
-    unsigned getHits() const;
-    unsigned getMisses() const;
-    unsigned getWritebacks() const;
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+    uint64_t getWritebacks() const;
+
+    /**
+     * @brief getLiveStatistics
+     * @returns the accumulated access statistics of the most recent cache access, since the cache was last reset.
+     * Contrary to the access trace, this may be read from any thread while the processor is running.
+     */
+    CacheAccessTrace getLiveStatistics() const { return m_liveStatistics.read(); }
+
+    /**
+     * @brief The Warmup struct
+     * Condition ending the warm-up of the cache, which begins whenever the cache is reset. Accesses during the warm-up
+     * update the contents of the cache, but are not counted in its reported statistics (see getStatistics). The
+     * warm-up ends with the first access in cycle count or later (Cycles), the first access once count demand accesses
+     * were performed (Accesses), or the first demand access by the instruction at pc (MarkerPC); the marker of a data
+     * cache must thus be a load or store.
+     */
+    struct Warmup {
+        enum class Mode { None, Cycles, Accesses, MarkerPC };
+        Mode mode = Mode::None;
+        uint64_t count = 0;
+        uint32_t pc = 0;
+    };
+    /// Sets the warm-up of the cache, which applies from its next reset, or right away if it has yet to be accessed
+    void setWarmup(const Warmup& warmup);
+    const Warmup& getWarmup() const { return m_warmup; }
+    bool isWarmingUp() const { return m_warmingUp; }
+
+    /**
+     * @brief resetStatistics
+     * Restarts the reported statistics from the next access, ending any warm-up, without flushing the contents of the
+     * cache. The access trace is kept intact. Reversing the processor to before the restart restarts the reported
+     * statistics as of the last reset of the cache.
+     */
+    void resetStatistics();
+
+    /**
+     * @brief getStatistics
+     * @returns the accumulated access statistics which are reported for the cache; those of the accesses since its
+     * warm-up ended or its statistics were restarted, or since it was last reset. Zero whilst warming up. May be read
+     * from any thread while the processor is running.
+     */
+    CacheAccessTrace getStatistics() const { return m_reportedStatistics.read(); }
+    /// @returns the statistics of the accesses in the cycles [@p first; @p last], from the access trace
+    CacheAccessTrace getStatistics(uint64_t first, uint64_t last) const { return m_accessTrace.window(first, last); }
+    /// Cycle of the first access counted in the reported statistics
+    uint64_t getStatisticsStart() const { return m_statisticsStart; }
     CacheSize getCacheSize() const;
 
     uint32_t buildAddress(unsigned tag, unsigned lineIdx, unsigned blockIdx) const;
@@ -132,13 +418,43 @@ public:
     unsigned getBlockIdx(const uint32_t address) const;
     unsigned getTag(const uint32_t address) const;
 
-    const CacheLine* getLine(unsigned idx) const;
+    CacheLineView getLine(unsigned idx) const;
+    /**
+     * @brief getLineHits/getLineMisses
+     * @returns the number of demand hits and misses in line @p idx since the cache was last reset.
+     */
+    uint64_t getLineHits(unsigned idx) const { return m_store.lineHits[idx]; }
+    uint64_t getLineMisses(unsigned idx) const { return m_store.lineMisses[idx]; }
+
+    /**
+     * @brief setReuseDistanceAnalysis
+     * Enables analysis of the reuse distances of all accesses to the cache, yielding the hit rates of all LRU caches
+     * of 2^0 to 2^s_maxReuseLineBits lines and up to 2^s_maxReuseWayBits ways at the current block size. The analysis
+     * restarts whenever the cache is reset, and is not reverted when the processor is reversed.
+     */
+    void setReuseDistanceAnalysis(bool enabled);
+    bool isReuseDistanceAnalysisEnabled() const { return m_analyzeReuseDistances; }
+    /// @returns the reuse distance analysis of the cache, or nullptr if not enabled
+    const ReuseDistanceAnalyzer* getReuseDistances() const {
+        return m_analyzeReuseDistances ? &m_reuseDistances : nullptr;
+    }
+    static constexpr int s_maxReuseLineBits = 10;
+    static constexpr int s_maxReuseWayBits = 10;
+
+    /**
+     * @brief s_lfuCounterBits/s_rrpvBits
+     * Widths of the saturating use counters of the LFU policy and of the re-reference prediction values of the SRRIP
+     * policy.
+     */
+    static constexpr int s_lfuCounterBits = 8;
+    static constexpr int s_rrpvBits = 2;
 
 public slots:
     void setBlocks(unsigned blocks);
     void setLines(unsigned lines);
     void setWays(unsigned ways);
     void setPreset(const CachePreset& preset);
+    void setSeed(uint32_t seed);
 
     /**
      * @brief processorWasClocked/processorWasReversed
@@ -147,6 +463,27 @@ public slots:
     void processorWasClocked();
     void processorWasReversed();
 
+    /**
+     * @brief checkpointRestored
+     * Slot function for the processor handler having restored the processor to the checkpoint of @p cycle. Restores
+     * the cache to its state in that same cycle.
+     */
+    void checkpointRestored(long long cycle);
+
+    /**
+     * @brief writeSnapshot/readSnapshot/restoreSnapshot
+     * Serialization of the tag store and access statistics of the cache within a simulation snapshot (see
+     * ProcessorHandler::saveSnapshot). readSnapshot decodes the state written by writeSnapshot into @p state, and
+     * returns false, with a description of the error in @p error, if the state is malformed or was written by a cache
+     * of another geometry or replacement policy. restoreSnapshot installs @p state as the state of the cache in
+     * @p cycle, once the processor has been reset. The prefetcher, miss classifier, write buffer and victim cache are
+     * not part of snapshots, and are left in their reset state.
+     */
+    struct SnapshotState;
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in, SnapshotState& state, QString& error) const;
+    void restoreSnapshot(SnapshotState&& state, long long cycle);
+
 signals:
     void configurationChanged();
     void dataChanged(const CacheTransaction* transaction);
@@ -166,18 +503,173 @@ signals:
      */
     void cacheInvalidated();
 
+    /// Signals that the hit or memory latency of the cache changed
+    void latencyChanged();
+    /// Signals that a shadow cache was attached or removed
+    void shadowCachesChanged();
+
 private:
     struct CacheTrace {
+        // Cycle of the access. Lower levels may be accessed several times within a single cycle. Warmup and replayed
+        // accesses, which are not performed in any cycle, are timed by their count instead.
+        uint64_t cycle = 0;
         CacheTransaction transaction;
+        // Address of the instruction performing the access
+        uint32_t pc = 0;
         CacheWay oldWay;
+        // Replacement state of the line required for undoing the access; the FIFO pointer before an eviction, the
+        // PLRU tree bits along the path to the accessed way, or the amount by which SRRIP aged the line.
+        uint32_t oldReplState = 0;
+        // Prefetcher state required for undoing the training of the prefetcher by a demand access
+        Prefetcher::Undo prefetcherUndo;
+        // Miss classifier state required for undoing the classification of a demand access
+        MissClassifier::Undo classifierUndo;
+        // Write buffer and victim cache state required for undoing the access
+        WriteBuffer::Undo writeBufferUndo;
+        VictimCache::Undo victimUndo;
+        // Whether a random way was drawn to evict upon the access
+        bool drewRandomWay = false;
     };
 
-    std::pair<unsigned, CacheSim::CacheWay*> locateEvictionWay(const CacheTransaction& transaction);
-    CacheWay evictAndUpdate(CacheTransaction& transaction);
+    /**
+     * @brief The PrefetchFlags enum
+     * State of a way filled by a prefetch; whether the block has yet to be demanded, and whether the fill evicted a
+     * valid block.
+     */
+    enum PrefetchFlags : uint8_t { PrefetchUnused = 1, PrefetchDisplaced = 2 };
+
+    /**
+     * @brief locateEvictionWay
+     * @returns the way to replace upon a miss in the line of @p transaction. Replacement state which is updated when
+     * selecting the way is recorded in @p trace.
+     */
+    unsigned locateEvictionWay(const CacheTransaction& transaction, CacheTrace& trace);
+    /// @returns the way of a full line @p lineIdx to evict, and updates the line's replacement state as per @p trace
+    unsigned locateReplacementVictim(unsigned lineIdx, CacheTrace& trace);
+    void evictAndUpdate(CacheTrace& trace);
     void analyzeCacheAccess(CacheTransaction& transaction) const;
+    /**
+     * @brief updateCache
+     * Performs an access to @p address on the cache lines, recording the resulting transaction and the state required
+     * for undoing it in @p trace. trace.oldWay is set to the way which was replaced or updated.
+     */
+    void updateCache(uint32_t address, AccessType type, CacheTrace& trace);
+    /**
+     * @brief accessesTraced
+     * Callback for batches of memory accesses traced by the functional interpreter of the processor handler. The
+     * accesses of the memory of this cache are warmed up with, as a batch. Shared lower levels thus observe the
+     * instruction fetches and data accesses of a batch in two runs rather than interleaved, which only perturbs their
+     * replacement order within the batch.
+     */
+    void accessesTraced(const std::vector<vsrtl::core::TracedMemoryAccess>& accesses);
+    /**
+     * @brief beginBatch/finishBatch
+     * Defers the undo traces, statistics and signals of simulated accesses until the outermost batch of the cache is
+     * finished. Each applies to the next levels of the cache as well.
+     */
+    void beginBatch();
+    void finishBatch();
     void updateConfiguration();
-    void pushAccessTrace(const CacheTransaction& transaction);
+    /**
+     * @brief beginReplay/replayAccess/finishReplay
+     * Replays the accesses of a trace; resets the cache, accumulates the statistics of each access into
+     * m_replayStatistics, and finally records these as the single access trace entry. Each applies to the next levels
+     * of the cache as well.
+     */
+    void beginReplay();
+    void replayAccess(uint32_t address, AccessType type, uint32_t pc);
+    void finishReplay();
+    template <typename NextAccess>
+    static unsigned long long replayHierarchy(CacheSim* instrCache, CacheSim* dataCache, NextAccess&& next);
+    /// Records the statistics of the access of @p transaction by the instruction at @p pc
+    void pushAccessTrace(const CacheTransaction& transaction, uint32_t pc);
     void popAccessTrace();
+    /**
+     * @brief updateWarmup
+     * Ends the warm-up if an access of @p type in @p cycle by the instruction at @p pc, following the accumulated
+     * statistics @p pre, meets its condition.
+     */
+    void updateWarmup(uint64_t cycle, AccessType type, uint32_t pc, const CacheAccessTrace& pre);
+    /// Starts the reported statistics over as of a reset of the cache; warming up anew, if configured to
+    void restartStatistics();
+    /// Restarts the statistics if the processor was reversed to before the cycle in which they started
+    void revertStatisticsStart();
+    /// @returns the average access time of the accesses of @p stats, given the @p missPenalty of the next level
+    double averageAccessTime(const CacheAccessTrace& stats, double missPenalty) const;
+    void accessCurrentCycle();
+    /**
+     * @brief currentCycleAccess
+     * @returns true if the processor accesses the memory of this cache in the current cycle, writing the address,
+     * type and the address of the accessing instruction to @p address, @p type and @p pc.
+     */
+    bool currentCycleAccess(uint32_t& address, AccessType& type, uint32_t& pc) const;
+    /**
+     * @brief currentCycle
+     * @returns the cycle of the access being simulated; the current cycle of the processor, or whilst the cache is
+     * decoupled from the processor, the cycle of the queued record being simulated.
+     */
+    uint64_t currentCycle() const;
+
+    /**
+     * @brief The AccessMode enum
+     * The ways in which a cache may be accessed; accesses are propagated to the next level in the same way.
+     */
+    enum class AccessMode { Simulated, Warmup, Replayed };
+    /**
+     * @brief propagate
+     * Performs the accesses to the next level which follow from the access of @p trace; the fill of an allocated
+     * block, and the write of an evicted dirty block or of a written-through or non-allocated write.
+     */
+    void propagate(const CacheTrace& trace, AccessMode mode);
+    /// Accesses the next level, or the DRAM behind the last level
+    void accessNextLevel(uint32_t address, AccessType type, AccessMode mode, uint32_t pc);
+    void accessAs(uint32_t address, AccessType type, AccessMode mode, uint32_t pc);
+    void accessBatch(const Access* accesses, size_t count, AccessMode mode);
+    /**
+     * @brief trainPrefetcher/issuePrefetches
+     * Trains the prefetcher with the demand access of @p trace, collecting its predictions into m_prefetchRequests,
+     * and performs these predictions as prefetches of the instruction at @p pc.
+     */
+    void trainPrefetcher(CacheTrace& trace);
+    void issuePrefetches(AccessMode mode, uint32_t pc);
+    /**
+     * @brief getNextLevelLatency
+     * @returns the latency of an access to the next level; the hit latency of the next level, or the memory latency.
+     * Prefetched blocks are filled immediately, but blocks demanded within this latency of their prefetch are counted
+     * as late. Likewise, the write buffer drains one entry per this latency.
+     */
+    unsigned getNextLevelLatency() const;
+    /**
+     * @brief recordCheckpoint
+     * Records a checkpoint of the tag store in @p cycle, if the processor handler checkpoints the processor then, as
+     * determined by @p isCheckpointCycle. Checkpoints of cycles which are no longer checkpoints are dropped.
+     */
+    void recordCheckpoint(long long cycle);
+    template <typename IsCheckpointCycle>
+    void recordCheckpoint(long long cycle, const IsCheckpointCycle& isCheckpointCycle);
+    /**
+     * @brief resetFromUpperLevel
+     * Called by upper level @p upper when it is reset. The state of a shared level is cleared upon the first reset of
+     * its upper levels following a processor reset, before any of them access it anew; that is, when @p upper has
+     * already been reset since the state was last cleared.
+     */
+    void resetFromUpperLevel(const CacheSim* upper);
+    /// @returns true if this is a shared lower level of other caches, whose resets are driven by these
+    bool isLowerLevel() const { return !m_upperLevels.empty(); }
+    /// @returns true if this cache, or any of its upper levels, stalls the processor on misses
+    bool stallsProcessor() const;
+    void clearState();
+    /**
+     * @brief connectProcessor
+     * Binds to the memory and connects to the signals of the current processor and functional interpreter of the
+     * processor handler, as per the cache type.
+     */
+    void connectProcessor();
+    /**
+     * @brief reconfigure
+     * Resets the cache to its current configuration, reconnecting it to the current processor.
+     */
+    void reconfigure();
     /**
      * @brief isAsynchronouslyAccessed
      * If the processor is in its 'running' state, it is currently being executed in a separate thread. In this case,
@@ -193,9 +685,60 @@ private:
      */
     void reassociateMemory();
 
+    /**
+     * @brief randomWay
+     * @returns the way to evict under the random replacement policy, advancing the count of random draws of the tag
+     * store. The value is a function of the seed and that count only, such that undoing the draws or restoring the
+     * cache to a previous cycle reproduces the replacement decisions made the first time around.
+     */
+    unsigned randomWay();
+
+    ProcessorHandler* m_context = nullptr;
+
+    CacheSim* m_nextLevel = nullptr;
+    std::vector<CacheSim*> m_upperLevels;
+    // Upper levels which have been reset since the state of this cache was last cleared
+    std::set<const CacheSim*> m_resetUpperLevels;
+    unsigned m_hitLatency = 1;
+    unsigned m_memoryLatency = 100;
+    CacheAccessTrace m_replayStatistics;
+    Prefetcher::Config m_prefetcherConfig;
+    Prefetcher m_prefetcher;
+    // Predictions of the most recent training of the prefetcher
+    std::vector<uint32_t> m_prefetchRequests;
+    // Nesting depth of the current batch, the undo traces and statistics deferred by it, and whether any access was
+    // performed in it
+    unsigned m_batchDepth = 0;
+    std::vector<CacheTrace> m_batchTraces;
+    CacheAccessTrace m_batchStatistics;
+    bool m_batchAccessed = false;
+    // Accesses of the most recent batch of traced accesses
+    std::vector<Access> m_tracedBatch;
+    MissClassifier m_missClassifier;
+    unsigned m_writeBufferEntries = 0;
+    WriteBuffer m_writeBuffer;
+    unsigned m_victimCacheEntries = 0;
+    VictimCache m_victimCache;
+    std::vector<std::unique_ptr<ShadowCache>> m_shadowCaches;
+    /// Performs a demand access to all shadow caches, recorded in their statistics unless @p record is false
+    void accessShadowCaches(uint32_t address, AccessType type, bool record);
+    bool m_stallOnMiss = false;
+    // Miss penalty of the most recent access which the processor is stalled on, recorded before it was simulated
+    struct StallRecord {
+        uint64_t cycle = ~uint64_t(0);
+        uint32_t address = 0;
+        unsigned cycles = 0;
+    };
+    StallRecord m_lastStall;
+    DRAMModel* m_dram = nullptr;
+
     ReplPolicy m_replPolicy = ReplPolicy::LRU;
     WritePolicy m_wrPolicy = WritePolicy::WriteBack;
     WriteAllocPolicy m_wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
+    uint32_t m_seed = 0;
+    uint64_t m_warmupAccesses = 0;
+    bool m_analyzeReuseDistances = false;
+    ReuseDistanceAnalyzer m_reuseDistances;
 
     unsigned m_blockMask = -1;
     unsigned m_lineMask = -1;
@@ -210,7 +753,7 @@ private:
      * The cache simulator may be attached to either a ROM or a Read/Write memory element. Accessing the underlying
      * VSRTL component signals are dependent on the given type of the memory.
      */
-    CacheType m_type;
+    CacheType m_type = CacheType::DataCache;
     union {
         RWMemory const* rw = nullptr;
         ROMMemory const* rom;
@@ -218,34 +761,107 @@ private:
     } m_memory;
 
     /**
-     * @brief m_cacheLines
-     * The datastructure for storing our cache hierachy, as per the current cache configuration.
+     * @brief The TagStore struct
+     * Structure-of-arrays storage of the state of all ways of the cache, as per the current cache configuration. The
+     * state of way w of line l is found at index l * ways + w of each array, such that the ways of a line are
+     * contiguous. Dirty blocks are stored as bitmasks of dirtyWords 64-bit words per way.
+     */
+    struct TagStore {
+        std::vector<uint32_t> tags;
+        // Per-way replacement state, as per CacheWay::repl
+        std::vector<uint32_t> repl;
+        std::vector<uint8_t> valid;
+        std::vector<uint8_t> dirty;
+        std::vector<uint64_t> dirtyBlocks;
+        unsigned dirtyWords = 0;
+        // Per-way PrefetchFlags and prefetch times, as per CacheWay
+        std::vector<uint8_t> prefetched;
+        std::vector<uint64_t> prefetchTime;
+
+        // PLRU tree bits; node n (1 to ways - 1, heap ordered) of line l is found at index l * ways + n. A node points
+        // towards the half of its subtree holding the pseudo least recently used way; 0 for the lower half.
+        std::vector<uint8_t> plruTree;
+        // Per-line FIFO pointer, indexing the next way to evict from a full line
+        std::vector<uint32_t> fifoNext;
+        // Per-line demand hit and miss counts
+        std::vector<uint64_t> lineHits;
+        std::vector<uint64_t> lineMisses;
+        // Number of ways drawn by the random replacement policy, which seeds the next draw
+        uint64_t randomDraws = 0;
+
+        void reset(unsigned lines, unsigned ways, unsigned blocks);
+    };
+    TagStore m_store;
+
+    /// @returns the index of way @p wayIdx of line @p lineIdx within the tag store
+    unsigned entryIdx(unsigned lineIdx, unsigned wayIdx) const { return (lineIdx << m_ways) + wayIdx; }
+    /**
+     * @brief readWay/writeWay
+     * Copies the state of the way at @p entry of the tag store out of and into the tag store. The dirty blocks of the
+     * way are only copied out if @p withDirtyBlocks.
      */
-    std::map<unsigned, CacheLine> m_cacheLines;
+    CacheWay readWay(unsigned entry, bool withDirtyBlocks) const;
+    void writeWay(unsigned entry, const CacheWay& way);
+    void resetTagStore();
 
-    void updateCacheLineReplFields(CacheLine& line, unsigned wayIdx);
+    /**
+     * @brief updateCacheLineReplFields
+     * Updates the replacement fields of line @p lineIdx upon an access to way @p wayIdx, recording the state required
+     * for reverting the update in @p trace.
+     */
+    void updateCacheLineReplFields(unsigned lineIdx, unsigned wayIdx, CacheTrace& trace);
     /**
      * @brief revertCacheLineReplFields
      * Called whenever undoing a transaction to the cache. Reverts a cacheline's replacement fields according to the
      * configured replacement policy.
      */
-    void revertCacheLineReplFields(CacheLine& line, const CacheWay& oldWay, unsigned wayIdx);
+    void revertCacheLineReplFields(const CacheTrace& trace);
 
     /**
      * @brief m_accessTrace
      * The access trace stack contains cache access statistics for each simulation cycle. Contrary to the TraceStack
      * (m_traceStack).
      */
-    std::map<unsigned, CacheAccessTrace> m_accessTrace;
+    CacheAccessTraceBuffer m_accessTrace;
+
+    /**
+     * @brief m_liveStatistics
+     * Most recent entry of m_accessTrace, republished by publishStatistics() whenever the access trace is modified.
+     */
+    Snapshot<CacheAccessTrace> m_liveStatistics;
+    void publishStatistics();
+
+    Warmup m_warmup;
+    bool m_warmingUp = false;
+    // Cycle of the first counted access, and the accumulated statistics preceding it, of the reported statistics
+    uint64_t m_statisticsStart = 0;
+    CacheAccessTrace m_statisticsBase;
+    /// Reported statistics, republished alongside m_liveStatistics
+    Snapshot<CacheAccessTrace> m_reportedStatistics;
+    CacheAccessTrace reportedStatistics() const;
 
     /**
      * @brief m_traceStack
-     * The following information is used to track all most-recent modifications made to the stack. The stack is of a
-     * fixed sized which is equal to the undo stack of VSRTL memory elements. Storing all modifications allows us to
+     * The following information is used to track all most-recent modifications made to the stack. The stack holds the
+     * traces of as many cycles as the undo stack of VSRTL memory elements holds. Storing all modifications allows us to
      * rollback any changes performed to the cache, when clock cycles are undone.
      */
     std::deque<CacheTrace> m_traceStack;
 
+    struct Checkpoint {
+        TagStore store;
+        Prefetcher prefetcher;
+        MissClassifier missClassifier;
+        WriteBuffer writeBuffer;
+        VictimCache victimCache;
+    };
+    /**
+     * @brief m_checkpoints
+     * Copies of the tag store, prefetcher, miss classifier, write buffer and victim cache, recorded in the cycles where
+     * the processor handler checkpoints the processor.
+     */
+    std::map<long long, Checkpoint> m_checkpoints;
+
     /**
      * @brief m_isResetting
      * The cacheSim can be reset by either internally modyfing cache configuration parameters or externally through a
@@ -257,10 +873,18 @@ private:
 
     CacheTrace popTrace();
     void pushTrace(const CacheTrace& trace);
+    void undoTrace(const CacheTrace& trace);
+};
+
+struct CacheSim::SnapshotState {
+    TagStore store;
+    CacheAccessTrace statistics;
 };
 
-const static std::map<CacheSim::ReplPolicy, QString> s_cacheReplPolicyStrings{{CacheSim::ReplPolicy::Random, "Random"},
-                                                                              {CacheSim::ReplPolicy::LRU, "LRU"}};
+const static std::map<CacheSim::ReplPolicy, QString> s_cacheReplPolicyStrings{
+    {CacheSim::ReplPolicy::Random, "Random"}, {CacheSim::ReplPolicy::LRU, "LRU"},
+    {CacheSim::ReplPolicy::PLRU, "Tree PLRU"}, {CacheSim::ReplPolicy::FIFO, "FIFO"},
+    {CacheSim::ReplPolicy::LFU, "LFU"},       {CacheSim::ReplPolicy::SRRIP, "SRRIP"}};
 const static std::map<CacheSim::WriteAllocPolicy, QString> s_cacheWriteAllocateStrings{
     {CacheSim::WriteAllocPolicy::WriteAllocate, "Write allocate"},
     {CacheSim::WriteAllocPolicy::NoWriteAllocate, "No write allocate"}};
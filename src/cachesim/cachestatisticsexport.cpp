@@ -0,0 +1,167 @@
+#include "cachestatisticsexport.h"
+
+#include <QByteArray>
+#include <QtEndian>
+
+#include <iterator>
+#include <vector>
+
+namespace Ripes {
+
+namespace {
+
+struct Column {
+    const char* name;
+    uint64_t CacheAccessTrace::*counter;
+};
+
+constexpr Column s_columns[] = {{"hits", &CacheAccessTrace::hits},
+                                {"misses", &CacheAccessTrace::misses},
+                                {"reads", &CacheAccessTrace::reads},
+                                {"writes", &CacheAccessTrace::writes},
+                                {"writebacks", &CacheAccessTrace::writebacks},
+                                {"prefetches", &CacheAccessTrace::prefetches},
+                                {"useful_prefetches", &CacheAccessTrace::usefulPrefetches},
+                                {"late_prefetches", &CacheAccessTrace::latePrefetches},
+                                {"polluting_prefetches", &CacheAccessTrace::pollutingPrefetches},
+                                {"compulsory_misses", &CacheAccessTrace::compulsoryMisses},
+                                {"capacity_misses", &CacheAccessTrace::capacityMisses},
+                                {"conflict_misses", &CacheAccessTrace::conflictMisses},
+                                {"victim_hits", &CacheAccessTrace::victimHits},
+                                {"coalesced_writes", &CacheAccessTrace::coalescedWrites},
+                                {"write_buffer_stalls", &CacheAccessTrace::writeBufferStalls}};
+static_assert(sizeof(CacheAccessTrace) == std::size(s_columns) * sizeof(uint64_t),
+              "All counters of CacheAccessTrace must be exported");
+
+constexpr int s_csvChunkBytes = 1 << 20;
+constexpr uint32_t s_columnarBlockRows = 1 << 16;
+constexpr uint32_t s_columnarVersion = 1;
+
+template <typename T>
+void appendLittleEndian(QByteArray& bytes, T value) {
+    const T le = qToLittleEndian(value);
+    bytes.append(reinterpret_cast<const char*>(&le), sizeof(T));
+}
+
+/**
+ * @brief The ChunkedWriter class
+ * Accumulates output in a buffer, which is written to the device whenever it exceeds its chunk size. Write errors are
+ * latched, after which further output is discarded.
+ */
+class ChunkedWriter {
+public:
+    ChunkedWriter(QIODevice& device, int chunkBytes) : m_device(device), m_chunkBytes(chunkBytes) {
+        m_buffer.reserve(chunkBytes);
+    }
+    QByteArray& buffer() { return m_buffer; }
+    void flushIfFull() {
+        if (m_buffer.size() >= m_chunkBytes) {
+            flush();
+        }
+    }
+    bool flush() {
+        if (m_ok && !m_buffer.isEmpty()) {
+            m_ok = m_device.write(m_buffer) == m_buffer.size();
+        }
+        m_buffer.clear();
+        return m_ok;
+    }
+    bool ok() const { return m_ok; }
+
+private:
+    QIODevice& m_device;
+    const int m_chunkBytes;
+    QByteArray m_buffer;
+    bool m_ok = true;
+};
+
+bool exportCSV(const CacheAccessTraceBuffer& trace, uint64_t first, uint64_t last, QIODevice& device) {
+    ChunkedWriter writer(device, s_csvChunkBytes);
+    QByteArray& row = writer.buffer();
+    row += "cycle";
+    for (const auto& column : s_columns) {
+        row += ',';
+        row += column.name;
+    }
+    row += '\n';
+
+    trace.forEach(first, last, [&](uint64_t cycle, const CacheAccessTrace& entry) {
+        if (!writer.ok()) {
+            return;
+        }
+        row += QByteArray::number(static_cast<qulonglong>(cycle));
+        for (const auto& column : s_columns) {
+            row += ',';
+            row += QByteArray::number(static_cast<qulonglong>(entry.*column.counter));
+        }
+        row += '\n';
+        writer.flushIfFull();
+    });
+    return writer.flush();
+}
+
+bool exportColumnar(const CacheAccessTraceBuffer& trace, uint64_t first, uint64_t last, QIODevice& device) {
+    constexpr size_t columnCount = std::size(s_columns) + 1;
+    ChunkedWriter writer(device, 0);
+    QByteArray& bytes = writer.buffer();
+    bytes += "RIPESCST";
+    appendLittleEndian<uint32_t>(bytes, s_columnarVersion);
+    appendLittleEndian<uint32_t>(bytes, columnCount);
+    const auto appendName = [&](const QByteArray& name) {
+        appendLittleEndian<uint32_t>(bytes, name.size());
+        bytes += name;
+    };
+    appendName("cycle");
+    for (const auto& column : s_columns) {
+        appendName(column.name);
+    }
+
+    // Rows of the current block, column by column
+    std::vector<std::vector<uint64_t>> block(columnCount);
+    uint32_t rows = 0;
+    const auto flushBlock = [&] {
+        appendLittleEndian<uint32_t>(bytes, rows);
+        for (auto& values : block) {
+            for (const uint64_t value : values) {
+                appendLittleEndian<uint64_t>(bytes, value);
+            }
+            values.clear();
+        }
+        rows = 0;
+        writer.flush();
+    };
+
+    trace.forEach(first, last, [&](uint64_t cycle, const CacheAccessTrace& entry) {
+        if (!writer.ok()) {
+            return;
+        }
+        block[0].push_back(cycle);
+        for (size_t i = 0; i < std::size(s_columns); i++) {
+            block[i + 1].push_back(entry.*s_columns[i].counter);
+        }
+        if (++rows == s_columnarBlockRows) {
+            flushBlock();
+        }
+    });
+    if (rows != 0) {
+        flushBlock();
+    }
+    // Terminating block
+    flushBlock();
+    return writer.ok();
+}
+
+}  // namespace
+
+bool exportCacheStatistics(const CacheAccessTraceBuffer& trace, uint64_t first, uint64_t last,
+                           CacheStatisticsFormat format, QIODevice& device) {
+    switch (format) {
+        case CacheStatisticsFormat::CSV:
+            return exportCSV(trace, first, last, device);
+        case CacheStatisticsFormat::Columnar:
+            return exportColumnar(trace, first, last, device);
+    }
+    return false;
+}
+
+}  // namespace Ripes
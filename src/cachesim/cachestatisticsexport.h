@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QIODevice>
+
+#include "cacheaccesstrace.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CacheStatisticsFormat enum
+ * File formats which the access statistics of a cache may be exported in. Each row holds the cycle of an access trace
+ * entry, followed by the statistics accumulated up to and including it (see CacheAccessTrace):
+ *  - CSV:      a header row of the column names, followed by one comma-separated row per entry.
+ *  - Columnar: little-endian binary; the magic "RIPESCST", a uint32 version (1) and column count, and each column name
+ *              as a uint32 length followed by its UTF-8 bytes. The rows follow in blocks of a uint32 row count and,
+ *              per column, the uint64 values of the rows of the block. A block of zero rows terminates the file.
+ *              Each column of a block may thus be loaded directly as an array (ie. numpy.frombuffer).
+ */
+enum class CacheStatisticsFormat { CSV, Columnar };
+
+/**
+ * @brief exportCacheStatistics
+ * Writes the statistics of each entry of @p trace of a cycle in [@p first; @p last] to @p device, in @p format. Rows
+ * are formatted and written in chunks as the trace is decoded, such that the exported data is never fully held in
+ * memory.
+ * @returns false if writing to @p device failed.
+ */
+bool exportCacheStatistics(const CacheAccessTraceBuffer& trace, uint64_t first, uint64_t last,
+                           CacheStatisticsFormat format, QIODevice& device);
+
+}  // namespace Ripes
@@ -0,0 +1,155 @@
+#include "cachesweep.h"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include "processorhandler.h"
+
+namespace Ripes {
+
+namespace {
+/**
+ * @brief parseDimension
+ * Parses ','-separated values and '-'-separated inclusive ranges of cache dimensions into @p values.
+ */
+bool parseDimension(const QString& text, std::vector<int>& values) {
+    values.clear();
+    for (const auto& field : text.split(',')) {
+        const auto bounds = field.split('-');
+        bool ok[2] = {true, true};
+        const int first = bounds.at(0).toInt(&ok[0]);
+        const int last = bounds.size() == 2 ? bounds.at(1).toInt(&ok[1]) : first;
+        if (bounds.size() > 2 || !ok[0] || !ok[1] || first < 0 || last < first || last > 31) {
+            return false;
+        }
+        for (int v = first; v <= last; v++) {
+            values.push_back(v);
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool parsePolicy(const QString& text, const std::map<QString, T>& names, std::vector<T>& values) {
+    values.clear();
+    for (const auto& field : text.split(',')) {
+        const auto it = names.find(field.trimmed().toLower());
+        if (it == names.end()) {
+            return false;
+        }
+        values.push_back(it->second);
+    }
+    return true;
+}
+}  // namespace
+
+bool parseCacheSweep(const QString& grid, const CacheSim::CachePreset& defaults,
+                     std::vector<CacheSim::CachePreset>& presets, QString& error) {
+    std::vector<int> lines = {defaults.lines}, ways = {defaults.ways}, blocks = {defaults.blocks};
+    std::vector<CacheSim::ReplPolicy> replPolicies = {defaults.replPolicy};
+    std::vector<CacheSim::WritePolicy> wrPolicies = {defaults.wrPolicy};
+    std::vector<CacheSim::WriteAllocPolicy> wrAllocPolicies = {defaults.wrAllocPolicy};
+
+    for (const auto& parameter : grid.split(';', QString::SkipEmptyParts)) {
+        const int separator = parameter.indexOf('=');
+        const QString key = parameter.left(separator).trimmed().toLower();
+        const QString value = parameter.mid(separator + 1).trimmed();
+        bool ok = separator > 0;
+        if (ok && key == "lines") {
+            ok = parseDimension(value, lines);
+        } else if (ok && key == "ways") {
+            ok = parseDimension(value, ways);
+        } else if (ok && key == "blocks") {
+            ok = parseDimension(value, blocks);
+        } else if (ok && key == "repl") {
+            ok = parsePolicy<CacheSim::ReplPolicy>(value,
+                                                   {{"lru", CacheSim::ReplPolicy::LRU},
+                                                    {"random", CacheSim::ReplPolicy::Random},
+                                                    {"plru", CacheSim::ReplPolicy::PLRU},
+                                                    {"fifo", CacheSim::ReplPolicy::FIFO},
+                                                    {"lfu", CacheSim::ReplPolicy::LFU},
+                                                    {"srrip", CacheSim::ReplPolicy::SRRIP}},
+                                                   replPolicies);
+        } else if (ok && key == "write") {
+            ok = parsePolicy<CacheSim::WritePolicy>(
+                value, {{"wb", CacheSim::WritePolicy::WriteBack}, {"wt", CacheSim::WritePolicy::WriteThrough}},
+                wrPolicies);
+        } else if (ok && key == "alloc") {
+            ok = parsePolicy<CacheSim::WriteAllocPolicy>(value,
+                                                         {{"wa", CacheSim::WriteAllocPolicy::WriteAllocate},
+                                                          {"nwa", CacheSim::WriteAllocPolicy::NoWriteAllocate}},
+                                                         wrAllocPolicies);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            error = QString("Invalid sweep parameter '%1'").arg(parameter.trimmed());
+            return false;
+        }
+    }
+
+    presets.clear();
+    for (int l : lines) {
+        for (int w : ways) {
+            for (int b : blocks) {
+                if (l + b > 30) {
+                    // The line and block indices must leave room for the byte offset within the address
+                    continue;
+                }
+                if (l + w > 24) {
+                    // The tag store of every configuration is allocated up front; skip unreasonably large caches
+                    continue;
+                }
+                for (auto repl : replPolicies) {
+                    for (auto wr : wrPolicies) {
+                        for (auto wrAlloc : wrAllocPolicies) {
+                            CacheSim::CachePreset preset = defaults;
+                            preset.lines = l;
+                            preset.ways = w;
+                            preset.blocks = b;
+                            preset.replPolicy = repl;
+                            preset.wrPolicy = wr;
+                            preset.wrAllocPolicy = wrAlloc;
+                            presets.push_back(preset);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<CacheSweepResult> sweepCaches(const std::vector<CacheTraceReader::Access>& trace,
+                                          const std::vector<CacheSweepConfig>& configs, int threads) {
+    std::vector<CacheSweepResult> results(configs.size());
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+    for (size_t i = 0; i < configs.size(); i++) {
+        QtConcurrent::run(&pool, [&trace, &configs, &results, i] {
+            // Caches are bound to a simulation context of their own, whose processor is never clocked
+            ProcessorHandler context;
+            CacheSim cache(&context, nullptr);
+            cache.setType(configs.at(i).type);
+            cache.setPreset(configs.at(i).preset);
+            cache.setHitLatency(configs.at(i).hitLatency);
+            cache.setMemoryLatency(configs.at(i).memoryLatency);
+            cache.replay(trace);
+
+            auto& result = results[i];
+            result.config = configs.at(i);
+            result.sizeBits = cache.getCacheSize().bits;
+            result.hits = cache.getHits();
+            result.misses = cache.getMisses();
+            result.writebacks = cache.getWritebacks();
+            result.hitRate = cache.getHitRate();
+            result.averageAccessTime = cache.getAverageAccessTime();
+        });
+    }
+    pool.waitForDone();
+
+    return results;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+#include "cachesim.h"
+#include "cachetrace.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CacheSweepConfig struct
+ * A single cache configuration of a sweep. The latencies only affect the average access time of the result.
+ */
+struct CacheSweepConfig {
+    CacheSim::CacheType type = CacheSim::CacheType::DataCache;
+    CacheSim::CachePreset preset;
+    unsigned hitLatency = 1;
+    unsigned memoryLatency = 100;
+};
+
+/**
+ * @brief The CacheSweepResult struct
+ * Size and statistics of a cache configuration, from replaying the trace of a sweep through it.
+ */
+struct CacheSweepResult {
+    CacheSweepConfig config;
+    unsigned sizeBits = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t writebacks = 0;
+    double hitRate = 0;
+    /// Average memory access time in cycles (see CacheSim::getAverageAccessTime)
+    double averageAccessTime = 0;
+};
+
+/**
+ * @brief parseCacheSweep
+ * Parses a grid of cache configurations, given as ';'-separated "<parameter>=<values>" pairs, into the cartesian
+ * product of all given parameter values. Parameters are "lines", "ways" and "blocks" (base-2 logarithms, given as
+ * ','-separated values or '-'-separated inclusive ranges), "repl" ("lru", "random", "plru", "fifo", "lfu", "srrip"),
+ * "write" ("wb", "wt") and "alloc" ("wa", "nwa"). Parameters not given keep their value in @p defaults. Example:
+ * "lines=2-8;ways=0,1,2;repl=lru,random".
+ * Configurations of more than 2^24 ways in total are omitted.
+ * @returns false and sets @p error if @p grid is malformed.
+ */
+bool parseCacheSweep(const QString& grid, const CacheSim::CachePreset& defaults,
+                     std::vector<CacheSim::CachePreset>& presets, QString& error);
+
+/**
+ * @brief sweepCaches
+ * Replays @p trace through each of @p configs, simulating up to @p threads configurations concurrently (0 = one per
+ * core). All configurations read the same trace, which must not be modified while sweeping.
+ * @returns the results of the configurations, in the order of @p configs.
+ */
+std::vector<CacheSweepResult> sweepCaches(const std::vector<CacheTraceReader::Access>& trace,
+                                          const std::vector<CacheSweepConfig>& configs, int threads);
+
+}  // namespace Ripes
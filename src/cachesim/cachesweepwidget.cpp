@@ -0,0 +1,310 @@
+#include "cachesweepwidget.h"
+#include "ui_cachesweepwidget.h"
+
+#include <QComboBox>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableWidget>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <set>
+
+#include "enumcombobox.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+namespace {
+const std::map<CacheSweepWidget::Parameter, QString> s_parameterStrings{
+    {CacheSweepWidget::Parameter::Lines, "Lines"},
+    {CacheSweepWidget::Parameter::Ways, "Ways"},
+    {CacheSweepWidget::Parameter::Blocks, "Blocks"},
+    {CacheSweepWidget::Parameter::Replacement, "Replacement"},
+    {CacheSweepWidget::Parameter::WritePolicy, "Write policy"},
+    {CacheSweepWidget::Parameter::WriteAllocation, "Write allocation"}};
+
+const std::map<CacheSweepWidget::Metric, QString> s_metricStrings{
+    {CacheSweepWidget::Metric::HitRate, "Hit rate"},
+    {CacheSweepWidget::Metric::AccessTime, "Avg. access time"},
+    {CacheSweepWidget::Metric::AccessTimeSize, "Avg. access time × size (KiB)"}};
+
+const std::map<CacheTraceReader::Format, QString> s_traceFormatStrings{{CacheTraceReader::Format::Ripes, "Ripes"},
+                                                                        {CacheTraceReader::Format::Dinero, "Dinero"},
+                                                                        {CacheTraceReader::Format::Lackey, "Lackey"}};
+
+/// Value of @p parameter in @p preset; policies are given by their enumerator value
+int parameterValue(const CacheSim::CachePreset& preset, CacheSweepWidget::Parameter parameter) {
+    switch (parameter) {
+        case CacheSweepWidget::Parameter::Lines:
+            return preset.lines;
+        case CacheSweepWidget::Parameter::Ways:
+            return preset.ways;
+        case CacheSweepWidget::Parameter::Blocks:
+            return preset.blocks;
+        case CacheSweepWidget::Parameter::Replacement:
+            return static_cast<int>(preset.replPolicy);
+        case CacheSweepWidget::Parameter::WritePolicy:
+            return static_cast<int>(preset.wrPolicy);
+        case CacheSweepWidget::Parameter::WriteAllocation:
+            return static_cast<int>(preset.wrAllocPolicy);
+    }
+    Q_UNREACHABLE();
+}
+
+QString parameterText(CacheSweepWidget::Parameter parameter, int value) {
+    switch (parameter) {
+        case CacheSweepWidget::Parameter::Lines:
+        case CacheSweepWidget::Parameter::Ways:
+        case CacheSweepWidget::Parameter::Blocks:
+            return QString::number(1u << value);
+        case CacheSweepWidget::Parameter::Replacement:
+            return s_cacheReplPolicyStrings.at(static_cast<CacheSim::ReplPolicy>(value));
+        case CacheSweepWidget::Parameter::WritePolicy:
+            return s_cacheWritePolicyStrings.at(static_cast<CacheSim::WritePolicy>(value));
+        case CacheSweepWidget::Parameter::WriteAllocation:
+            return s_cacheWriteAllocateStrings.at(static_cast<CacheSim::WriteAllocPolicy>(value));
+    }
+    Q_UNREACHABLE();
+}
+}  // namespace
+
+CacheSweepWidget::CacheSweepWidget(CacheSim& cache, QWidget* parent)
+    : QDialog(parent), m_ui(new Ui::CacheSweepWidget), m_cache(cache) {
+    m_ui->setupUi(this);
+    setWindowTitle("Cache Design Space");
+
+    setupEnumCombobox(m_ui->traceFormat, s_traceFormatStrings);
+    setupEnumCombobox(m_ui->metric, s_metricStrings);
+    setupEnumCombobox(m_ui->xAxis, s_parameterStrings);
+    setupEnumCombobox(m_ui->yAxis, s_parameterStrings);
+    setEnumIndex(m_ui->xAxis, Parameter::Ways);
+    setEnumIndex(m_ui->yAxis, Parameter::Lines);
+
+    m_ui->heatmap->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_ui->heatmap->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_ui->heatmap->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_ui->heatmap->verticalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    connect(m_ui->openTrace, &QToolButton::clicked, this, &CacheSweepWidget::openTrace);
+    connect(m_ui->sweep, &QPushButton::clicked, this, &CacheSweepWidget::startSweep);
+    connect(&m_sweepWatcher, &QFutureWatcher<SweepOutput>::finished, this, &CacheSweepWidget::sweepFinished);
+    connect(m_ui->metric, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            &CacheSweepWidget::updateHeatmap);
+    connect(m_ui->xAxis, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CacheSweepWidget::axesChanged);
+    connect(m_ui->yAxis, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CacheSweepWidget::axesChanged);
+    connect(m_ui->heatmap, &QTableWidget::cellDoubleClicked, this, &CacheSweepWidget::applyConfiguration);
+
+    m_ui->summary->setText("Double-click a configuration to apply it to the cache.");
+}
+
+CacheSweepWidget::~CacheSweepWidget() {
+    delete m_ui;
+}
+
+void CacheSweepWidget::openTrace() {
+    const QString path = QFileDialog::getOpenFileName(this, "Open Trace", QString(), "All files (*)");
+    if (!path.isEmpty()) {
+        m_ui->tracePath->setText(path);
+    }
+}
+
+CacheSweepWidget::SweepOutput CacheSweepWidget::runSweep(const QString& path, CacheTraceReader::Format format,
+                                                         const std::vector<CacheSweepConfig>& configs) {
+    SweepOutput output;
+    std::vector<CacheTraceReader::Access> accesses;
+    CacheTraceReader trace;
+    if (!trace.open(path, format)) {
+        output.error = "Could not load trace file " + path;
+        return output;
+    }
+    if (!trace.readAll(accesses)) {
+        output.error = "Malformed trace file " + path;
+        return output;
+    }
+    output.results = sweepCaches(accesses, configs, 0);
+    return output;
+}
+
+void CacheSweepWidget::startSweep() {
+    // Parameters not given in the grid keep the current configuration of the cache
+    const CacheSim::CachePreset defaults{m_cache.getBlockBits(),         m_cache.getLineBits(),
+                                         m_cache.getWaysBits(),          m_cache.getWritePolicy(),
+                                         m_cache.getWriteAllocPolicy(), m_cache.getReplacementPolicy(),
+                                         m_cache.getSeed()};
+    std::vector<CacheSim::CachePreset> presets;
+    QString error;
+    if (!parseCacheSweep(m_ui->grid->text(), defaults, presets, error)) {
+        m_ui->summary->setText(error);
+        return;
+    }
+
+    std::vector<CacheSweepConfig> configs;
+    for (const auto& preset : presets) {
+        configs.push_back({m_cache.getType(), preset, m_cache.getHitLatency(), m_cache.getMemoryLatency()});
+    }
+    m_ui->sweep->setEnabled(false);
+    m_ui->summary->setText("Sweeping " + QString::number(configs.size()) + " configurations...");
+    m_sweepWatcher.setFuture(QtConcurrent::run(&CacheSweepWidget::runSweep, m_ui->tracePath->text(),
+                                               getEnumValue<CacheTraceReader::Format>(m_ui->traceFormat), configs));
+}
+
+void CacheSweepWidget::sweepFinished() {
+    m_ui->sweep->setEnabled(true);
+    SweepOutput output = m_sweepWatcher.result();
+    if (!output.error.isEmpty()) {
+        m_ui->summary->setText(output.error);
+        return;
+    }
+    m_results = std::move(output.results);
+    axesChanged();
+    m_ui->summary->setText("Swept " + QString::number(m_results.size()) +
+                           " configurations. Double-click a configuration to apply it to the cache.");
+}
+
+std::vector<int> CacheSweepWidget::sweptValues(Parameter parameter) const {
+    std::set<int> values;
+    for (const auto& result : m_results) {
+        values.insert(parameterValue(result.config.preset, parameter));
+    }
+    return std::vector<int>(values.begin(), values.end());
+}
+
+void CacheSweepWidget::axesChanged() {
+    m_fixed.clear();
+    while (auto* item = m_ui->fixedLayout->takeAt(0)) {
+        delete item->widget();
+        delete item;
+    }
+
+    // Parameters which are not on an axis, and which were swept over more than a single value, must be fixed
+    const auto xParameter = getEnumValue<Parameter>(m_ui->xAxis);
+    const auto yParameter = getEnumValue<Parameter>(m_ui->yAxis);
+    for (const auto& parameter : s_parameterStrings) {
+        const std::vector<int> values = sweptValues(parameter.first);
+        if (parameter.first == xParameter || parameter.first == yParameter || values.size() < 2) {
+            continue;
+        }
+        auto* selector = new QComboBox(this);
+        for (const int value : values) {
+            selector->addItem(parameterText(parameter.first, value), value);
+        }
+        m_ui->fixedLayout->addWidget(new QLabel(parameter.second + ":", this));
+        m_ui->fixedLayout->addWidget(selector);
+        connect(selector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CacheSweepWidget::updateHeatmap);
+        m_fixed[parameter.first] = selector;
+    }
+    m_ui->fixedLayout->addStretch();
+    updateHeatmap();
+}
+
+double CacheSweepWidget::metricValue(const CacheSweepResult& result, Metric metric) const {
+    switch (metric) {
+        case Metric::HitRate:
+            return result.hitRate;
+        case Metric::AccessTime:
+            return result.averageAccessTime;
+        case Metric::AccessTimeSize:
+            return result.averageAccessTime * result.sizeBits / (8.0 * 1024);
+    }
+    Q_UNREACHABLE();
+}
+
+QString CacheSweepWidget::cellToolTip(const CacheSweepResult& result) const {
+    const auto& preset = result.config.preset;
+    QString tooltip;
+    for (const auto& parameter : s_parameterStrings) {
+        tooltip += parameter.second + ": " + parameterText(parameter.first, parameterValue(preset, parameter.first)) +
+                   "\n";
+    }
+    tooltip += "Size: " + QString::number(result.sizeBits) + " bits\n";
+    tooltip += "Hits: " + QString::number(result.hits) + "\nMisses: " + QString::number(result.misses) + "\n";
+    tooltip += "Writebacks: " + QString::number(result.writebacks) + "\n";
+    tooltip += "Hit rate: " + QString::number(result.hitRate, 'f', 4) + "\n";
+    tooltip += "Avg. access time: " + QString::number(result.averageAccessTime, 'f', 2) + " cycles";
+    return tooltip;
+}
+
+void CacheSweepWidget::updateHeatmap() {
+    const auto metric = getEnumValue<Metric>(m_ui->metric);
+    const auto xParameter = getEnumValue<Parameter>(m_ui->xAxis);
+    const auto yParameter = getEnumValue<Parameter>(m_ui->yAxis);
+    const std::vector<int> xValues = sweptValues(xParameter);
+    const std::vector<int> yValues = xParameter == yParameter ? std::vector<int>{0} : sweptValues(yParameter);
+
+    m_ui->heatmap->clear();
+    m_ui->heatmap->setColumnCount(static_cast<int>(xValues.size()));
+    m_ui->heatmap->setRowCount(static_cast<int>(yValues.size()));
+    QStringList xLabels, yLabels;
+    for (const int value : xValues) {
+        xLabels << parameterText(xParameter, value);
+    }
+    for (const int value : yValues) {
+        yLabels << (xParameter == yParameter ? QString() : parameterText(yParameter, value));
+    }
+    m_ui->heatmap->setHorizontalHeaderLabels(xLabels);
+    m_ui->heatmap->setVerticalHeaderLabels(yLabels);
+
+    // Locate the result of each cell, within the slice of the results selected by the fixed parameters
+    std::map<std::pair<int, int>, size_t> cells;
+    for (size_t i = 0; i < m_results.size(); i++) {
+        const auto& preset = m_results[i].config.preset;
+        const bool selected = std::all_of(m_fixed.begin(), m_fixed.end(), [&](const auto& fixed) {
+            return parameterValue(preset, fixed.first) == fixed.second->currentData().toInt();
+        });
+        if (!selected) {
+            continue;
+        }
+        const int x = parameterValue(preset, xParameter);
+        const int y = xParameter == yParameter ? 0 : parameterValue(preset, yParameter);
+        const int column = static_cast<int>(std::lower_bound(xValues.begin(), xValues.end(), x) - xValues.begin());
+        const int row = static_cast<int>(std::lower_bound(yValues.begin(), yValues.end(), y) - yValues.begin());
+        cells.emplace(std::make_pair(row, column), i);
+    }
+    if (cells.empty()) {
+        return;
+    }
+
+    double best = metricValue(m_results[cells.begin()->second], metric);
+    double worst = best;
+    for (const auto& cell : cells) {
+        const double value = metricValue(m_results[cell.second], metric);
+        // A higher hit rate is better, whereas the access time metrics are better when lower
+        if (metric == Metric::HitRate) {
+            best = std::max(best, value);
+            worst = std::min(worst, value);
+        } else {
+            best = std::min(best, value);
+            worst = std::max(worst, value);
+        }
+    }
+
+    for (const auto& cell : cells) {
+        const auto& result = m_results[cell.second];
+        const double value = metricValue(result, metric);
+        // Cells are shaded from green (best) to red (worst)
+        const double quality = best == worst ? 1.0 : (value - worst) / (best - worst);
+        auto* item = new QTableWidgetItem(QString::number(value, 'f', metric == Metric::HitRate ? 4 : 2));
+        item->setTextAlignment(Qt::AlignCenter);
+        item->setBackground(QColor::fromHsvF(quality / 3.0, 0.6, 0.95));
+        item->setToolTip(cellToolTip(result));
+        item->setData(Qt::UserRole, static_cast<qulonglong>(cell.second));
+        m_ui->heatmap->setItem(cell.first.first, cell.first.second, item);
+    }
+}
+
+void CacheSweepWidget::applyConfiguration(int row, int column) {
+    const QTableWidgetItem* item = m_ui->heatmap->item(row, column);
+    if (item == nullptr) {
+        return;
+    }
+    if (ProcessorHandler::get()->isRunning()) {
+        m_ui->summary->setText("The cache cannot be reconfigured while the processor is running.");
+        return;
+    }
+    const auto& result = m_results.at(item->data(Qt::UserRole).toULongLong());
+    m_cache.setPreset(result.config.preset);
+    m_ui->summary->setText("Applied configuration: " + QString(cellToolTip(result)).replace('\n', ", "));
+}
+
+}  // namespace Ripes
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <map>
+#include <vector>
+
+#include "cachesweep.h"
+
+QT_FORWARD_DECLARE_CLASS(QComboBox);
+
+namespace Ripes {
+
+namespace Ui {
+class CacheSweepWidget;
+}
+
+/**
+ * @brief The CacheSweepWidget class
+ * Sweeps a grid of cache configurations over a memory access trace, and renders a metric of the results as a heatmap
+ * over two of the swept parameters, with the remaining parameters fixed to one of their swept values. Double-clicking
+ * a cell applies its configuration to the cache.
+ */
+class CacheSweepWidget : public QDialog {
+    Q_OBJECT
+
+public:
+    enum class Parameter { Lines, Ways, Blocks, Replacement, WritePolicy, WriteAllocation };
+    enum class Metric { HitRate, AccessTime, AccessTimeSize };
+
+    CacheSweepWidget(CacheSim& cache, QWidget* parent = nullptr);
+    ~CacheSweepWidget() override;
+
+private slots:
+    void openTrace();
+    void startSweep();
+    void sweepFinished();
+    /// Rebuilds the selectors of the parameters which are not on an axis, and replots the heatmap
+    void axesChanged();
+    void updateHeatmap();
+    void applyConfiguration(int row, int column);
+
+private:
+    /// Result of a sweep, as produced on a worker thread
+    struct SweepOutput {
+        std::vector<CacheSweepResult> results;
+        QString error;
+    };
+    static SweepOutput runSweep(const QString& path, CacheTraceReader::Format format,
+                                const std::vector<CacheSweepConfig>& configs);
+
+    /// Distinct values of @p parameter within the current results, in ascending order
+    std::vector<int> sweptValues(Parameter parameter) const;
+    double metricValue(const CacheSweepResult& result, Metric metric) const;
+    QString cellToolTip(const CacheSweepResult& result) const;
+
+    Ui::CacheSweepWidget* m_ui = nullptr;
+    CacheSim& m_cache;
+
+    std::vector<CacheSweepResult> m_results;
+    QFutureWatcher<SweepOutput> m_sweepWatcher;
+    /// Selectors of the swept values of the parameters which are not on an axis
+    std::map<Parameter, QComboBox*> m_fixed;
+};
+
+}  // namespace Ripes
+
+// Qt Metatypes for enum combo boxes
+Q_DECLARE_METATYPE(Ripes::CacheSweepWidget::Parameter);
+Q_DECLARE_METATYPE(Ripes::CacheSweepWidget::Metric);
+Q_DECLARE_METATYPE(Ripes::CacheTraceReader::Format);
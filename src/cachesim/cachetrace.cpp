@@ -0,0 +1,140 @@
+#include "cachetrace.h"
+
+#include "defines.h"
+
+#include <cctype>
+#include <cstdlib>
+
+namespace Ripes {
+
+bool CacheTraceReader::parseFormat(const QString& name, Format& format) {
+    const QString n = name.toLower();
+    if (n == "ripes") {
+        format = Format::Ripes;
+    } else if (n == "din") {
+        format = Format::Dinero;
+    } else if (n == "lackey") {
+        format = Format::Lackey;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool CacheTraceReader::open(const QString& path, Format format) {
+    m_format = format;
+    m_error = false;
+    m_hasPending = false;
+    m_lastPc = 0;
+    if (m_format == Format::Ripes) {
+        return m_executionTrace.open(path);
+    }
+    m_file.setFileName(path);
+    return m_file.open(QIODevice::ReadOnly);
+}
+
+bool CacheTraceReader::next(Access& access) {
+    if (m_hasPending) {
+        m_hasPending = false;
+        access = m_pending;
+        return true;
+    }
+    return m_format == Format::Ripes ? nextRipes(access) : nextText(access);
+}
+
+bool CacheTraceReader::readAll(std::vector<Access>& accesses) {
+    Access access;
+    while (next(access)) {
+        accesses.push_back(access);
+    }
+    return !m_error;
+}
+
+bool CacheTraceReader::nextRipes(Access& access) {
+    TraceRecord record;
+    if (!m_executionTrace.next(record)) {
+        m_error = m_executionTrace.hasError();
+        return false;
+    }
+
+    access = Access();
+    access.address = record.pc;
+    access.instruction = true;
+    access.pc = record.pc;
+    if (record.hasMemAccess) {
+        m_hasPending = true;
+        m_pending = Access();
+        m_pending.address = record.memAddress;
+        m_pending.pc = record.pc;
+        m_pending.write = (record.instr & 0b1111111) == instrType::STORE;
+    }
+    return true;
+}
+
+bool CacheTraceReader::nextText(Access& access) {
+    char line[256];
+    while (true) {
+        const qint64 length = m_file.readLine(line, sizeof(line));
+        if (length <= 0) {
+            return false;
+        }
+        if (line[length - 1] != '\n' && !m_file.atEnd()) {
+            // Overlong lines never describe an access; skip the remainder of the line
+            m_file.readLine();
+            continue;
+        }
+
+        const char* c = line;
+        while (*c == ' ' || *c == '\t') {
+            c++;
+        }
+
+        char* end;
+        access = Access();
+        if (m_format == Format::Dinero) {
+            const long label = std::strtol(c, &end, 10);
+            if (end == c) {
+                // Blank line
+                continue;
+            }
+            if (label < 0 || label > 2) {
+                // Miscellaneous and cache flush records do not access memory
+                continue;
+            }
+            access.write = label == 1;
+            access.instruction = label == 2;
+        } else {
+            // Lackey; access lines are given as "<kind> <address>,<size>", and all other (ie. valgrind) output skipped
+            const char kind = *c++;
+            if ((kind != 'I' && kind != 'L' && kind != 'S' && kind != 'M') || (*c != ' ' && *c != '\t')) {
+                continue;
+            }
+            access.write = kind == 'S';
+            access.instruction = kind == 'I';
+            if (kind == 'M') {
+                m_hasPending = true;
+                m_pending = Access();
+                m_pending.write = true;
+            }
+            end = const_cast<char*>(c);
+        }
+
+        const char* addressStart = end;
+        const unsigned long long address = std::strtoull(addressStart, &end, 16);
+        if (end == addressStart) {
+            m_error = true;
+            m_hasPending = false;
+            return false;
+        }
+        access.address = static_cast<uint32_t>(address);
+        if (access.instruction) {
+            m_lastPc = access.address;
+        }
+        access.pc = m_lastPc;
+        m_pending.address = access.address;
+        m_pending.pc = m_lastPc;
+        return true;
+    }
+}
+
+}  // namespace Ripes
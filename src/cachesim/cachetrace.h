@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+
+#include <vector>
+
+#include "executiontrace.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CacheTraceReader class
+ * Reads the memory accesses of a recorded trace, for replaying them through cache simulators without simulating a
+ * processor. Supported formats are:
+ *  - Ripes:  execution traces recorded by ProcessorHandler (see executiontrace.h). Each record yields the fetch of its
+ *            instruction followed by its data access, if any.
+ *  - Dinero: the Dinero "din" format; one "<label> <hex address>" pair per line, where labels 0, 1 and 2 denote a
+ *            data read, data write and instruction fetch. Other labels are skipped.
+ *  - Lackey: the output of valgrind --tool=lackey --trace-mem=yes; "I", "L", "S" and "M" lines, where a modify (M)
+ *            yields a read followed by a write. Lines not describing an access are skipped.
+ * Addresses are truncated to 32 bits. Data accesses are attributed to the most recently fetched instruction, as the
+ * text formats do not record the instruction performing a data access.
+ */
+class CacheTraceReader {
+public:
+    enum class Format { Ripes, Dinero, Lackey };
+
+    struct Access {
+        uint32_t address = 0;
+        bool write = false;
+        bool instruction = false;
+        // Address of the instruction performing the access; the address itself for instruction fetches
+        uint32_t pc = 0;
+    };
+
+    /**
+     * @brief parseFormat
+     * Parses a format name as given on the command line ('ripes', 'din' or 'lackey').
+     * @returns false if @p name does not identify a format.
+     */
+    static bool parseFormat(const QString& name, Format& format);
+
+    /**
+     * @brief open
+     * Opens the trace file at @p path, of format @p format.
+     * @returns false if the file could not be opened.
+     */
+    bool open(const QString& path, Format format);
+
+    /**
+     * @brief next
+     * Reads the next access of the trace into @p access.
+     * @returns false when the end of the trace is reached, or if the trace is malformed (see hasError()).
+     */
+    bool next(Access& access);
+    bool hasError() const { return m_error; }
+
+    /**
+     * @brief readAll
+     * Reads all remaining accesses of the trace into @p accesses.
+     * @returns false if the trace is malformed.
+     */
+    bool readAll(std::vector<Access>& accesses);
+
+private:
+    bool nextRipes(Access& access);
+    bool nextText(Access& access);
+
+    Format m_format = Format::Ripes;
+    bool m_error = false;
+    ExecutionTraceReader m_executionTrace;
+    QFile m_file;
+
+    /// Access yielded after the current one; the data access of a Ripes trace record, or the write of a Lackey modify
+    bool m_hasPending = false;
+    Access m_pending;
+    // Address of the most recently fetched instruction of a text trace
+    uint32_t m_lastPc = 0;
+};
+
+}  // namespace Ripes
@@ -30,6 +30,20 @@ void CacheView::mousePressEvent(QMouseEvent* event) {
     QGraphicsView::mousePressEvent(event);
 }
 
+void CacheView::resizeEvent(QResizeEvent* event) {
+    QGraphicsView::resizeEvent(event);
+    emitVisibleRect();
+}
+
+void CacheView::scrollContentsBy(int dx, int dy) {
+    QGraphicsView::scrollContentsBy(dx, dy);
+    emitVisibleRect();
+}
+
+void CacheView::emitVisibleRect() {
+    emit visibleRectChanged(mapToScene(viewport()->rect()).boundingRect());
+}
+
 void CacheView::wheelEvent(QWheelEvent* e) {
     if (e->modifiers() & Qt::ControlModifier) {
         if (e->delta() > 0)
@@ -59,6 +73,7 @@ void CacheView::setupMatrix() {
     matrix.scale(scale, scale);
 
     setMatrix(matrix);
+    emitVisibleRect();
 }
 
 }  // namespace Ripes
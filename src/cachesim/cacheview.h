@@ -8,13 +8,19 @@ class CacheView : public QGraphicsView {
     Q_OBJECT
 public:
     CacheView(QWidget* parent);
+    /// Emits visibleRectChanged with the part of the scene which is currently visible
+    void emitVisibleRect();
 
 protected:
     void wheelEvent(QWheelEvent*) override;
     void mousePressEvent(QMouseEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
 
 signals:
     void cacheAddressSelected(uint32_t);
+    /// Emitted with the part of the scene which is visible in the view, whenever it changes
+    void visibleRectChanged(const QRectF& rect);
 
 private slots:
     void setupMatrix();
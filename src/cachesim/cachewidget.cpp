@@ -5,26 +5,49 @@
 #include <QGraphicsView>
 
 #include "cachegraphic.h"
+#include "processorhandler.h"
 
 namespace Ripes {
 
 CacheWidget::CacheWidget(QWidget* parent) : QWidget(parent), m_ui(new Ui::CacheWidget) {
     m_ui->setupUi(this);
 
-    auto* scene = new QGraphicsScene(this);
-    m_cacheSim = new CacheSim(this);
+    m_cacheSim = new CacheSim(ProcessorHandler::get(), this);
     m_ui->cacheConfig->setCache(m_cacheSim);
 
-    auto* cacheGraphic = new CacheGraphic(*m_cacheSim);
-    m_ui->cacheView->setScene(scene);
-    scene->addItem(cacheGraphic);
-
     connect(m_ui->cacheView, &CacheView::cacheAddressSelected,
             [=](uint32_t address) { emit cacheAddressSelected(address); });
 
     connect(m_cacheSim, &CacheSim::configurationChanged, [=] { emit configurationChanged(); });
 }
 
+void CacheWidget::showEvent(QShowEvent* event) {
+    // The graphic of the cache is constructed once the widget is first shown, such that hidden cache widgets do not
+    // slow down application startup, nor track the cache contents while they are never viewed
+    if (m_cacheGraphic == nullptr) {
+        auto* scene = new QGraphicsScene(this);
+        m_cacheGraphic = new CacheGraphic(*m_cacheSim);
+        m_ui->cacheView->setScene(scene);
+        scene->addItem(m_cacheGraphic);
+        connect(m_ui->cacheView, &CacheView::visibleRectChanged, [=](const QRectF& rect) {
+            m_cacheGraphic->setVisibleRect(m_cacheGraphic->mapRectFromScene(rect));
+        });
+        // The view may have been resized before the graphic was constructed
+        m_ui->cacheView->emitVisibleRect();
+    } else {
+        m_cacheGraphic->setSuspended(false);
+    }
+    QWidget::showEvent(event);
+}
+
+void CacheWidget::hideEvent(QHideEvent* event) {
+    // Changes to the cache are not drawn while hidden
+    if (m_cacheGraphic != nullptr) {
+        m_cacheGraphic->setSuspended(true);
+    }
+    QWidget::hideEvent(event);
+}
+
 void CacheWidget::setType(CacheSim::CacheType type) {
     m_cacheSim->setType(type);
 }
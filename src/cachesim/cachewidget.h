@@ -9,6 +9,7 @@ using RVMemory = vsrtl::core::RVMemory<32, 32>;
 namespace Ripes {
 
 class CacheSim;
+class CacheGraphic;
 
 namespace Ui {
 class CacheWidget;
@@ -22,14 +23,20 @@ public:
     ~CacheWidget();
 
     void setType(CacheSim::CacheType type);
+    CacheSim* getCache() const { return m_cacheSim; }
 
 signals:
     void cacheAddressSelected(uint32_t);
     void configurationChanged();
 
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
 private:
     Ui::CacheWidget* m_ui;
     CacheSim* m_cacheSim = nullptr;
+    CacheGraphic* m_cacheGraphic = nullptr;
 };
 
 }  // namespace Ripes
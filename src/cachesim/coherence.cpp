@@ -0,0 +1,162 @@
+#include "coherence.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+CoherenceModel::CoherenceModel(unsigned harts, int lines, int ways, int blocks)
+    : m_lineBits(lines), m_wayBits(ways), m_blockBits(blocks), m_caches(harts) {
+    for (auto& cache : m_caches) {
+        cache.ways.resize(static_cast<size_t>(1) << (m_lineBits + m_wayBits));
+    }
+}
+
+CoherenceModel::Way* CoherenceModel::find(Cache& cache, uint32_t block) {
+    return const_cast<Way*>(find(static_cast<const Cache&>(cache), block));
+}
+
+const CoherenceModel::Way* CoherenceModel::find(const Cache& cache, uint32_t block) const {
+    const size_t set = (block & ((1u << m_lineBits) - 1)) << m_wayBits;
+    for (size_t i = set; i < set + (static_cast<size_t>(1) << m_wayBits); i++) {
+        if (cache.ways[i].state != State::Invalid && cache.ways[i].block == block) {
+            return &cache.ways[i];
+        }
+    }
+    return nullptr;
+}
+
+CoherenceModel::Way& CoherenceModel::allocate(Cache& cache, uint32_t block) {
+    const size_t set = (block & ((1u << m_lineBits) - 1)) << m_wayBits;
+    Way* victim = &cache.ways[set];
+    for (size_t i = set; i < set + (static_cast<size_t>(1) << m_wayBits); i++) {
+        Way& way = cache.ways[i];
+        if (way.state == State::Invalid) {
+            victim = &way;
+            break;
+        }
+        if (way.lastUse < victim->lastUse) {
+            victim = &way;
+        }
+    }
+    if (victim->state == State::Modified) {
+        cache.statistics.writebacks++;
+    }
+    victim->block = block;
+    return *victim;
+}
+
+void CoherenceModel::invalidateOthers(unsigned hart, uint32_t block) {
+    for (unsigned other = 0; other < m_caches.size(); other++) {
+        if (other == hart) {
+            continue;
+        }
+        Cache& cache = m_caches[other];
+        Way* way = find(cache, block);
+        if (!way) {
+            continue;
+        }
+        if (way->state == State::Modified) {
+            cache.statistics.writebacks++;
+        }
+        way->state = State::Invalid;
+        cache.statistics.invalidations++;
+        cache.invalidated[block] = 0;
+        LineStatistics& line = m_lines[block];
+        line.address = block << (2 /*byte offset*/ + m_blockBits);
+        line.invalidations++;
+    }
+}
+
+void CoherenceModel::access(unsigned hart, uint32_t address, bool write) {
+    Cache& cache = m_caches[hart];
+    HartStatistics& statistics = cache.statistics;
+    const uint32_t block = address >> (2 /*byte offset*/ + m_blockBits);
+    // Words beyond the 64th of a block share the bits of the written word masks
+    const unsigned word = (address >> 2) & ((1u << m_blockBits) - 1) & 63;
+    write ? statistics.writes++ : statistics.reads++;
+    m_time++;
+
+    Way* way = find(cache, block);
+    if (way) {
+        if (write && way->state == State::Shared) {
+            statistics.upgrades++;
+            invalidateOthers(hart, block);
+        }
+    } else {
+        statistics.misses++;
+        const auto lost = cache.invalidated.find(block);
+        if (lost != cache.invalidated.end()) {
+            LineStatistics& line = m_lines[block];
+            line.address = block << (2 /*byte offset*/ + m_blockBits);
+            statistics.coherenceMisses++;
+            line.coherenceMisses++;
+            if (((lost->second >> word) & 1) == 0) {
+                statistics.falseSharingMisses++;
+                line.falseSharingMisses++;
+            }
+            cache.invalidated.erase(lost);
+        }
+
+        // Snoop the other caches
+        bool shared = false;
+        for (unsigned other = 0; other < m_caches.size(); other++) {
+            const Way* copy = other != hart ? find(m_caches[other], block) : nullptr;
+            if (copy) {
+                shared = true;
+                if (copy->state == State::Exclusive || copy->state == State::Modified) {
+                    statistics.cacheToCacheTransfers++;
+                }
+            }
+        }
+        if (write) {
+            invalidateOthers(hart, block);
+        } else if (shared) {
+            for (unsigned other = 0; other < m_caches.size(); other++) {
+                Way* copy = other != hart ? find(m_caches[other], block) : nullptr;
+                if (copy) {
+                    if (copy->state == State::Modified) {
+                        m_caches[other].statistics.writebacks++;
+                    }
+                    copy->state = State::Shared;
+                }
+            }
+        }
+        way = &allocate(cache, block);
+        way->state = write ? State::Modified : shared ? State::Shared : State::Exclusive;
+    }
+    if (write) {
+        way->state = State::Modified;
+        // Record the write within the blocks which other caches have lost, for classifying their next miss
+        for (unsigned other = 0; other < m_caches.size(); other++) {
+            if (other != hart) {
+                const auto lost = m_caches[other].invalidated.find(block);
+                if (lost != m_caches[other].invalidated.end()) {
+                    lost->second |= uint64_t(1) << word;
+                }
+            }
+        }
+    }
+    way->lastUse = m_time;
+}
+
+CoherenceModel::State CoherenceModel::state(unsigned hart, uint32_t address) const {
+    const Way* way = find(m_caches[hart], address >> (2 /*byte offset*/ + m_blockBits));
+    return way ? way->state : State::Invalid;
+}
+
+std::vector<CoherenceModel::LineStatistics> CoherenceModel::lines() const {
+    std::vector<LineStatistics> lines;
+    lines.reserve(m_lines.size());
+    for (const auto& line : m_lines) {
+        lines.push_back(line.second);
+    }
+    std::sort(lines.begin(), lines.end(), [](const LineStatistics& a, const LineStatistics& b) {
+        if (a.coherenceMisses != b.coherenceMisses) {
+            return a.coherenceMisses > b.coherenceMisses;
+        }
+        return a.address < b.address;
+    });
+    return lines;
+}
+
+}  // namespace Ripes
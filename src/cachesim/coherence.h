@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The CoherenceModel class
+ * Private L1 data caches of the harts of a multi-hart system, kept coherent by a MESI snooping protocol upon a shared
+ * bus. Each cache is a set associative LRU tag store of 2^lines sets of 2^ways ways of 2^blocks words, as configured
+ * for CacheSim. The model only tracks tags and coherence states; data is held by the memory of the system.
+ * - A read miss fills the block as Exclusive if no other cache holds it, and as Shared otherwise, downgrading any
+ *   Exclusive or Modified copy to Shared. A Modified copy is written back in doing so.
+ * - A write miss fills the block as Modified, invalidating all other copies. A write hit upon a Shared block upgrades
+ *   it to Modified, invalidating all other copies, whereas Exclusive blocks are upgraded silently.
+ * A miss upon a block which the cache lost through an invalidation is a coherence miss. A coherence miss is false
+ * sharing if no other hart has written the accessed word since the invalidation, such that the miss was only caused
+ * by the word sharing its block with words written by other harts.
+ */
+class CoherenceModel {
+public:
+    enum class State : uint8_t { Invalid, Shared, Exclusive, Modified };
+
+    struct HartStatistics {
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t misses = 0;
+        uint64_t coherenceMisses = 0;
+        uint64_t falseSharingMisses = 0;
+        /// Writes upon Shared blocks, requiring the other copies to be invalidated
+        uint64_t upgrades = 0;
+        /// Blocks of this cache invalidated by writes of other harts
+        uint64_t invalidations = 0;
+        uint64_t writebacks = 0;
+        /// Misses served by another cache holding the block as Exclusive or Modified
+        uint64_t cacheToCacheTransfers = 0;
+
+        uint64_t accesses() const { return reads + writes; }
+        double missRate() const { return accesses() != 0 ? static_cast<double>(misses) / accesses() : 0; }
+    };
+
+    /// Coherence traffic caused by a single block, identified by its address
+    struct LineStatistics {
+        uint32_t address = 0;
+        uint64_t invalidations = 0;
+        uint64_t coherenceMisses = 0;
+        uint64_t falseSharingMisses = 0;
+    };
+
+    CoherenceModel(unsigned harts, int lines, int ways, int blocks);
+
+    /// Performs a read or write of the word at @p address by @p hart
+    void access(unsigned hart, uint32_t address, bool write);
+
+    unsigned harts() const { return static_cast<unsigned>(m_caches.size()); }
+    const HartStatistics& statistics(unsigned hart) const { return m_caches[hart].statistics; }
+    /// @returns the state of the block at @p address in the cache of @p hart
+    State state(unsigned hart, uint32_t address) const;
+
+    /// @returns the blocks which have been invalidated or coherence missed upon, by decreasing coherence misses
+    std::vector<LineStatistics> lines() const;
+
+private:
+    struct Way {
+        uint32_t block = 0;
+        State state = State::Invalid;
+        uint64_t lastUse = 0;
+    };
+
+    struct Cache {
+        std::vector<Way> ways;
+        /**
+         * Blocks which this cache lost through invalidations and has not missed upon since, with a mask of the words
+         * written by other harts since the invalidation
+         */
+        std::unordered_map<uint32_t, uint64_t> invalidated;
+        HartStatistics statistics;
+    };
+
+    /// @returns the way of @p cache holding @p block, or nullptr
+    Way* find(Cache& cache, uint32_t block);
+    const Way* find(const Cache& cache, uint32_t block) const;
+    /// Allocates a way for @p block in @p cache, evicting the least recently used way of its set
+    Way& allocate(Cache& cache, uint32_t block);
+    /// Invalidates the copies of @p block held by all caches but that of @p hart
+    void invalidateOthers(unsigned hart, uint32_t block);
+
+    int m_lineBits = 0;
+    int m_wayBits = 0;
+    int m_blockBits = 0;
+    uint64_t m_time = 0;
+    std::vector<Cache> m_caches;
+    std::unordered_map<uint32_t, LineStatistics> m_lines;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,79 @@
+#include "dram.h"
+
+namespace Ripes {
+
+DRAMModel::DRAMModel(const Config& config) {
+    setConfig(config);
+}
+
+void DRAMModel::setConfig(const Config& config) {
+    m_config = config;
+    reset();
+}
+
+void DRAMModel::reset() {
+    m_openRows.assign(1u << m_config.bankBits, s_noRow);
+    m_statistics = Statistics();
+}
+
+DRAMModel::RowState DRAMModel::rowState(uint32_t address) const {
+    const uint32_t open = m_openRows[bank(address)];
+    if (open == s_noRow) {
+        return RowState::Empty;
+    }
+    return open == row(address) ? RowState::Hit : RowState::Conflict;
+}
+
+unsigned DRAMModel::latency(RowState state) const {
+    switch (state) {
+        case RowState::Hit:
+            return m_config.tCAS;
+        case RowState::Empty:
+            return m_config.tRCD + m_config.tCAS;
+        case RowState::Conflict:
+            return m_config.tRP + m_config.tRCD + m_config.tCAS;
+    }
+    return 0;
+}
+
+unsigned DRAMModel::latency(uint32_t address) const {
+    return latency(rowState(address));
+}
+
+void DRAMModel::activate(uint32_t address) {
+    m_openRows[bank(address)] = m_config.policy == PagePolicy::Open ? row(address) : s_noRow;
+}
+
+unsigned DRAMModel::access(uint32_t address, bool write) {
+    const RowState state = rowState(address);
+    const unsigned cycles = latency(state);
+    switch (state) {
+        case RowState::Hit:
+            m_statistics.rowHits++;
+            break;
+        case RowState::Empty:
+            m_statistics.rowEmpty++;
+            break;
+        case RowState::Conflict:
+            m_statistics.rowConflicts++;
+            break;
+    }
+    if (write) {
+        m_statistics.writes++;
+    } else {
+        m_statistics.reads++;
+        m_statistics.readLatency += cycles;
+    }
+    activate(address);
+    return cycles;
+}
+
+void DRAMModel::warmup(uint32_t address) {
+    activate(address);
+}
+
+double DRAMModel::getAverageReadLatency() const {
+    return m_statistics.reads != 0 ? m_statistics.averageReadLatency() : latency(RowState::Empty);
+}
+
+}  // namespace Ripes
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The DRAMModel class
+ * Timing model of the DRAM behind the last level of a cache hierarchy. The memory consists of 2^bankBits banks, each
+ * with a row buffer of 2^rowBits bytes. Consecutive rows of the address space are interleaved across the banks, such
+ * that sequential accesses stream through the row buffers of all banks in turn.
+ * With the open-page policy, a row stays open in its row buffer once activated. An access to the open row is a row hit
+ * costing tCAS, an access to a bank without an open row costs tRCD + tCAS, and an access to another row of a bank (a
+ * row conflict) additionally precharges the bank, costing tRP + tRCD + tCAS. With the closed-page policy, banks are
+ * precharged right after each access, such that all accesses cost tRCD + tCAS.
+ * Accesses are served one at a time, without modelling the concurrency of the banks or the refresh of rows. The model
+ * is not reverted when the processor is reversed.
+ */
+class DRAMModel {
+public:
+    enum class PagePolicy { Open, Closed };
+
+    struct Config {
+        int bankBits = 3;
+        int rowBits = 11;
+        PagePolicy policy = PagePolicy::Open;
+        unsigned tRCD = 15;
+        unsigned tCAS = 15;
+        unsigned tRP = 15;
+    };
+
+    struct Statistics {
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t rowHits = 0;
+        /// Accesses to banks without an open row
+        uint64_t rowEmpty = 0;
+        uint64_t rowConflicts = 0;
+        /// Summed latencies of all reads, being the fills of the cache misses
+        uint64_t readLatency = 0;
+
+        uint64_t accesses() const { return reads + writes; }
+        double rowHitRate() const { return accesses() != 0 ? static_cast<double>(rowHits) / accesses() : 0; }
+        double averageReadLatency() const { return reads != 0 ? static_cast<double>(readLatency) / reads : 0; }
+    };
+
+    explicit DRAMModel(const Config& config);
+
+    const Config& getConfig() const { return m_config; }
+    void setConfig(const Config& config);
+    /// Closes all rows and clears the statistics
+    void reset();
+
+    /**
+     * @brief access
+     * Performs a read or write of the block at @p address.
+     * @returns the latency of the access.
+     */
+    unsigned access(uint32_t address, bool write);
+    /// Updates the row buffers as per an access to @p address, without counting the access
+    void warmup(uint32_t address);
+    /// @returns the latency of an access to @p address in the current state of the row buffers
+    unsigned latency(uint32_t address) const;
+
+    const Statistics& getStatistics() const { return m_statistics; }
+    /// @returns the average read latency so far, or the latency of an access to an empty bank if nothing was read
+    double getAverageReadLatency() const;
+
+private:
+    static constexpr uint32_t s_noRow = UINT32_MAX;
+
+    enum class RowState { Hit, Empty, Conflict };
+    RowState rowState(uint32_t address) const;
+    unsigned latency(RowState state) const;
+    /// Opens the row of @p address in its bank, or leaves the bank precharged under the closed-page policy
+    void activate(uint32_t address);
+
+    unsigned bank(uint32_t address) const { return (address >> m_config.rowBits) & ((1u << m_config.bankBits) - 1); }
+    uint32_t row(uint32_t address) const { return address >> (m_config.rowBits + m_config.bankBits); }
+
+    Config m_config;
+    /// Open row of each bank
+    std::vector<uint32_t> m_openRows;
+    Statistics m_statistics;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,113 @@
+#include "missclassifier.h"
+
+namespace Ripes {
+
+void MissClassifier::configure(int blockBits, unsigned capacity) {
+    m_blockShift = 2 /*byte offset*/ + blockBits;
+    m_capacity = capacity;
+    reset();
+}
+
+void MissClassifier::reset() {
+    m_touched.clear();
+    m_nodes.clear();
+    m_index.clear();
+    m_head = s_nil;
+    m_tail = s_nil;
+}
+
+MissClassifier::MissType MissClassifier::access(uint32_t address, Undo& undo) {
+    undo = Undo();
+    undo.valid = true;
+    const uint32_t block = address >> m_blockShift;
+    undo.block = block;
+
+    auto& page = m_touched[block >> s_pageBits];
+    if (page.empty()) {
+        page.assign((1u << s_pageBits) / 64, 0);
+    }
+    const uint32_t bit = block & ((1u << s_pageBits) - 1);
+    uint64_t& word = page[bit / 64];
+    const uint64_t mask = uint64_t(1) << (bit % 64);
+    undo.firstTouch = (word & mask) == 0;
+    word |= mask;
+
+    const auto it = m_index.find(block);
+    undo.shadowHit = it != m_index.end();
+    if (undo.shadowHit) {
+        // Promote the block to the most recently used
+        const unsigned node = it->second;
+        const unsigned successor = m_nodes[node].next;
+        undo.hasSuccessor = successor != s_nil;
+        undo.successor = undo.hasSuccessor ? m_nodes[successor].block : 0;
+        unlink(node);
+        linkBefore(node, m_head);
+    } else {
+        unsigned node;
+        if (m_nodes.size() < m_capacity) {
+            node = static_cast<unsigned>(m_nodes.size());
+            m_nodes.push_back(Node());
+        } else {
+            // Evict the least recently used block, reusing its node
+            node = m_tail;
+            undo.hasEvicted = true;
+            undo.evicted = m_nodes[node].block;
+            m_index.erase(undo.evicted);
+            unlink(node);
+        }
+        m_nodes[node].block = block;
+        m_index[block] = node;
+        linkBefore(node, m_head);
+    }
+
+    if (undo.firstTouch) {
+        return MissType::Compulsory;
+    }
+    return undo.shadowHit ? MissType::Conflict : MissType::Capacity;
+}
+
+void MissClassifier::undo(const Undo& undo) {
+    if (!undo.valid) {
+        return;
+    }
+
+    if (undo.firstTouch) {
+        const uint32_t bit = undo.block & ((1u << s_pageBits) - 1);
+        m_touched[undo.block >> s_pageBits][bit / 64] &= ~(uint64_t(1) << (bit % 64));
+    }
+
+    // Accesses are undone in reverse order, so the block is the most recently used block of the shadow cache
+    const unsigned node = m_index.at(undo.block);
+    unlink(node);
+    if (undo.shadowHit) {
+        linkBefore(node, undo.hasSuccessor ? m_index.at(undo.successor) : s_nil);
+    } else {
+        m_index.erase(undo.block);
+        if (undo.hasEvicted) {
+            m_nodes[node].block = undo.evicted;
+            m_index[undo.evicted] = node;
+            linkBefore(node, s_nil);
+        } else {
+            // The node was the most recently allocated one
+            m_nodes.pop_back();
+        }
+    }
+}
+
+void MissClassifier::unlink(unsigned node) {
+    Node& n = m_nodes[node];
+    (n.prev != s_nil ? m_nodes[n.prev].next : m_head) = n.next;
+    (n.next != s_nil ? m_nodes[n.next].prev : m_tail) = n.prev;
+    n.prev = s_nil;
+    n.next = s_nil;
+}
+
+void MissClassifier::linkBefore(unsigned node, unsigned successor) {
+    Node& n = m_nodes[node];
+    n.next = successor;
+    n.prev = successor != s_nil ? m_nodes[successor].prev : m_tail;
+    (n.prev != s_nil ? m_nodes[n.prev].next : m_head) = node;
+    (successor != s_nil ? m_nodes[successor].prev : m_tail) = node;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The MissClassifier class
+ * Classifies the misses of a cache as compulsory, capacity or conflict misses (the "three Cs"). A miss is compulsory
+ * if its block has never been accessed before, as tracked by a first-touch bitmap over all blocks. Otherwise, it is a
+ * capacity miss if it also misses in a shadow fully associative LRU cache of the same capacity, and a conflict miss if
+ * it hits in the shadow cache.
+ * All accesses may be undone in reverse order, and the classifier is copyable, such that it follows the cache when
+ * the processor is reversed or restored to a checkpoint.
+ */
+class MissClassifier {
+public:
+    enum class MissType { None, Compulsory, Capacity, Conflict };
+
+    /**
+     * @brief The Undo struct
+     * The state required for undoing an access; whether it touched its block for the first time, and the effect of the
+     * access on the shadow cache.
+     */
+    struct Undo {
+        bool valid = false;
+        uint32_t block = 0;
+        bool firstTouch = false;
+        bool shadowHit = false;
+        // Block following the accessed block in the LRU order of a shadow hit, if any
+        bool hasSuccessor = false;
+        uint32_t successor = 0;
+        // Block evicted from a full shadow cache by a shadow miss, if any
+        bool hasEvicted = false;
+        uint32_t evicted = 0;
+    };
+
+    /**
+     * @brief configure
+     * Resets the classifier, and configures it for a cache of @p capacity blocks of 2^@p blockBits words.
+     */
+    void configure(int blockBits, unsigned capacity);
+    void reset();
+
+    /**
+     * @brief access
+     * Observes an access to @p address, recording the state required for undoing it in @p undo.
+     * @returns the type of miss the access would be, if it missed in the cache.
+     */
+    MissType access(uint32_t address, Undo& undo);
+    void undo(const Undo& undo);
+
+private:
+    static constexpr unsigned s_nil = static_cast<unsigned>(-1);
+    static constexpr unsigned s_pageBits = 16;
+
+    struct Node {
+        uint32_t block = 0;
+        unsigned prev = s_nil;
+        unsigned next = s_nil;
+    };
+
+    void unlink(unsigned node);
+    /// Links @p node before @p successor, or as the least recently used node if @p successor is nil
+    void linkBefore(unsigned node, unsigned successor);
+
+    int m_blockShift = 2;
+    unsigned m_capacity = 0;
+
+    // First-touch bitmap, in pages of 2^s_pageBits blocks
+    std::unordered_map<uint32_t, std::vector<uint64_t>> m_touched;
+
+    // Shadow cache; a doubly linked list of its blocks from the most (m_head) to the least (m_tail) recently used,
+    // indexed by block
+    std::vector<Node> m_nodes;
+    std::unordered_map<uint32_t, unsigned> m_index;
+    unsigned m_head = s_nil;
+    unsigned m_tail = s_nil;
+};
+
+}  // namespace Ripes
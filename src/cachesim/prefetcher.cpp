@@ -0,0 +1,151 @@
+#include "prefetcher.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+void Prefetcher::configure(const Config& config, int blockBits) {
+    m_config = config;
+    m_blockShift = 2 /*byte offset*/ + blockBits;
+    reset();
+}
+
+void Prefetcher::reset() {
+    m_time = 0;
+    switch (m_config.type) {
+        case Type::Stride:
+            m_table.assign(s_strideEntries, Entry());
+            break;
+        case Type::Stream:
+            m_table.assign(s_streamEntries, Entry());
+            break;
+        case Type::None:
+        case Type::NextLine:
+            m_table.clear();
+            break;
+    }
+}
+
+Prefetcher::Undo Prefetcher::observe(uint32_t pc, uint32_t address, bool trigger, std::vector<uint32_t>& prefetches) {
+    prefetches.clear();
+    Undo undo;
+    switch (m_config.type) {
+        case Type::NextLine:
+            if (trigger) {
+                issue(address, int64_t(1) << m_blockShift, prefetches);
+            }
+            break;
+        case Type::Stride:
+            // The reference prediction table is trained by all accesses of an instruction, not only by triggers
+            observeStride(pc, address, undo, prefetches);
+            break;
+        case Type::Stream:
+            if (trigger) {
+                observeStream(address >> m_blockShift, undo, prefetches);
+            }
+            break;
+        case Type::None:
+            break;
+    }
+    return undo;
+}
+
+void Prefetcher::undo(const Undo& undo) {
+    if (undo.index < m_table.size()) {
+        m_table[undo.index] = undo.entry;
+    }
+}
+
+void Prefetcher::observeStride(uint32_t pc, uint32_t address, Undo& undo, std::vector<uint32_t>& prefetches) {
+    // Instructions are word aligned
+    undo.index = (pc >> 2) % s_strideEntries;
+    Entry& entry = m_table[undo.index];
+    undo.entry = entry;
+
+    if (!entry.valid || entry.tag != pc) {
+        entry = Entry();
+        entry.valid = true;
+        entry.tag = pc;
+        entry.lastAddress = address;
+        return;
+    }
+
+    // A differing stride lowers the confidence of the entry, and replaces the stride once no confidence is left
+    const int32_t stride = static_cast<int32_t>(address - entry.lastAddress);
+    if (stride == entry.stride) {
+        entry.confidence = std::min(entry.confidence + 1, s_maxConfidence);
+    } else if (entry.confidence > 0) {
+        entry.confidence--;
+    } else {
+        entry.stride = stride;
+    }
+    entry.lastAddress = address;
+
+    if (entry.stride != 0 && entry.confidence >= s_confidenceThreshold) {
+        issue(address, entry.stride, prefetches);
+    }
+}
+
+void Prefetcher::observeStream(uint32_t block, Undo& undo, std::vector<uint32_t>& prefetches) {
+    m_time++;
+    const auto inWindow = [block](const Entry& entry) {
+        const uint32_t distance = block > entry.lastAddress ? block - entry.lastAddress : entry.lastAddress - block;
+        return entry.valid && distance <= s_streamWindow;
+    };
+    auto it = std::find_if(m_table.begin(), m_table.end(), inWindow);
+    if (it == m_table.end()) {
+        // Start a new stream in place of an invalid or the least recently triggered one. Times start at 1, such that
+        // invalid entries are considered the least recently triggered.
+        const auto lastUse = [](const Entry& entry) { return entry.valid ? entry.lastUse : 0; };
+        it = std::min_element(m_table.begin(), m_table.end(),
+                              [&](const Entry& lhs, const Entry& rhs) { return lastUse(lhs) < lastUse(rhs); });
+        undo.index = static_cast<unsigned>(it - m_table.begin());
+        undo.entry = *it;
+        *it = Entry();
+        it->valid = true;
+        it->lastAddress = block;
+        it->lastUse = m_time;
+        return;
+    }
+
+    undo.index = static_cast<unsigned>(it - m_table.begin());
+    undo.entry = *it;
+    Entry& entry = *it;
+    entry.lastUse = m_time;
+    if (block == entry.lastAddress) {
+        // Repeated triggers of a block do not indicate a direction
+        return;
+    }
+
+    const int32_t direction = block > entry.lastAddress ? 1 : -1;
+    if (direction == entry.stride) {
+        entry.confidence = std::min(entry.confidence + 1, s_maxConfidence);
+    } else {
+        entry.stride = direction;
+        entry.confidence = 1;
+    }
+    entry.lastAddress = block;
+
+    if (entry.confidence >= s_confidenceThreshold) {
+        issue(int64_t(block) << m_blockShift, int64_t(direction) << m_blockShift, prefetches);
+    }
+}
+
+void Prefetcher::issue(int64_t address, int64_t stride, std::vector<uint32_t>& prefetches) const {
+    const int64_t block = address >> m_blockShift;
+    int64_t previous = block;
+    for (unsigned i = 0; i < m_config.degree; i++) {
+        const int64_t target = address + stride * (m_config.distance + i);
+        if (target < 0 || target > int64_t(UINT32_MAX)) {
+            break;
+        }
+        // Strides below the block size yield several prefetches of the same block
+        const int64_t targetBlock = target >> m_blockShift;
+        if (targetBlock != previous && targetBlock != block) {
+            prefetches.push_back(static_cast<uint32_t>(targetBlock << m_blockShift));
+            previous = targetBlock;
+        }
+    }
+}
+
+}  // namespace Ripes
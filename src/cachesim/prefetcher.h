@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <QString>
+
+namespace Ripes {
+
+/**
+ * @brief The Prefetcher class
+ * Hardware prefetcher which sits in front of a cache, observing its demand accesses and predicting the blocks to be
+ * accessed next. Supported prefetchers are:
+ *  - Next-line: upon a trigger, prefetches the blocks following the accessed block.
+ *  - Stride:    a reference prediction table indexed by the PC of the accessing instruction, which prefetches along the
+ *               stride between successive accesses of an instruction once the stride has been confirmed.
+ *  - Stream:    a table of streams of triggers to neighbouring blocks, which prefetches in the direction of a stream
+ *               once its direction has been confirmed.
+ * Triggers are demand misses and first demand hits on prefetched blocks, such that a successful prefetcher keeps
+ * running ahead of the access stream. The prefetcher issues @p degree prefetches per prediction, starting @p distance
+ * blocks (or strides) ahead of the access.
+ */
+class Prefetcher {
+public:
+    enum class Type { None, NextLine, Stride, Stream };
+
+    struct Config {
+        Type type = Type::None;
+        unsigned degree = 1;
+        unsigned distance = 1;
+    };
+
+    /**
+     * @brief The Entry struct
+     * An entry of the stride or stream table. Stride entries are tagged by the PC of their instruction and track byte
+     * addresses; stream entries track block indices, with a stride of the direction of the stream.
+     */
+    struct Entry {
+        uint32_t tag = 0;
+        uint32_t lastAddress = 0;
+        int32_t stride = 0;
+        unsigned confidence = 0;
+        uint64_t lastUse = 0;
+        bool valid = false;
+    };
+
+    /**
+     * @brief The Undo struct
+     * The table entry modified by an observed access, and its state before the access.
+     */
+    struct Undo {
+        unsigned index = static_cast<unsigned>(-1);
+        Entry entry;
+    };
+
+    /**
+     * @brief configure
+     * Resets the prefetcher, and configures it as per @p config for blocks of 2^@p blockBits words.
+     */
+    void configure(const Config& config, int blockBits);
+    void reset();
+    const Config& getConfig() const { return m_config; }
+    bool enabled() const { return m_config.type != Type::None; }
+
+    /**
+     * @brief observe
+     * Observes a demand access to @p address by the instruction at @p pc, which is a trigger if @p trigger. The byte
+     * addresses of the blocks to prefetch are written to @p prefetches.
+     * @returns the state required for undoing the access through undo().
+     */
+    Undo observe(uint32_t pc, uint32_t address, bool trigger, std::vector<uint32_t>& prefetches);
+    void undo(const Undo& undo);
+
+    static constexpr unsigned s_strideEntries = 64;
+    static constexpr unsigned s_streamEntries = 16;
+    /// Maximum distance in blocks between successive triggers of a stream
+    static constexpr unsigned s_streamWindow = 16;
+    /// Saturation value of entry confidences, and the confidence at which entries start to prefetch
+    static constexpr unsigned s_maxConfidence = 3;
+    static constexpr unsigned s_confidenceThreshold = 2;
+
+private:
+    void observeStride(uint32_t pc, uint32_t address, Undo& undo, std::vector<uint32_t>& prefetches);
+    void observeStream(uint32_t block, Undo& undo, std::vector<uint32_t>& prefetches);
+    /**
+     * @brief issue
+     * Prefetches the blocks of byte addresses @p address + @p stride * (distance + i) for i in [0; degree), skipping
+     * the block of @p address and addresses outside of the address space.
+     */
+    void issue(int64_t address, int64_t stride, std::vector<uint32_t>& prefetches) const;
+
+    Config m_config;
+    int m_blockShift = 2;
+    uint64_t m_time = 0;
+    std::vector<Entry> m_table;
+};
+
+const static std::map<Prefetcher::Type, QString> s_prefetcherStrings{{Prefetcher::Type::None, "None"},
+                                                                    {Prefetcher::Type::NextLine, "Next-line"},
+                                                                    {Prefetcher::Type::Stride, "Stride"},
+                                                                    {Prefetcher::Type::Stream, "Stream"}};
+
+}  // namespace Ripes
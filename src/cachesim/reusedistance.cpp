@@ -0,0 +1,107 @@
+#include "reusedistance.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+namespace {
+inline uint32_t lowbit(uint32_t i) {
+    return i & (~i + 1);
+}
+}  // namespace
+
+void ReuseDistanceAnalyzer::configure(int blockBits, int maxLineBits, unsigned maxWays) {
+    m_blockBits = blockBits;
+    m_maxWays = maxWays;
+    m_partitions.assign(maxLineBits + 1, Partition());
+    reset();
+}
+
+void ReuseDistanceAnalyzer::reset() {
+    m_accesses = 0;
+    for (unsigned lineBits = 0; lineBits < m_partitions.size(); lineBits++) {
+        auto& partition = m_partitions[lineBits];
+        partition.sets.assign(1u << lineBits, SetStack());
+        partition.histogram.assign(m_maxWays, 0);
+    }
+}
+
+void ReuseDistanceAnalyzer::access(uint32_t address) {
+    m_accesses++;
+    const uint32_t block = address >> (2 + m_blockBits);
+    for (unsigned lineBits = 0; lineBits < m_partitions.size(); lineBits++) {
+        auto& partition = m_partitions[lineBits];
+        const long long distance = partition.sets[block & ((1u << lineBits) - 1)].access(block);
+        if (distance >= 0 && distance < static_cast<long long>(m_maxWays)) {
+            partition.histogram[distance]++;
+        }
+    }
+}
+
+uint64_t ReuseDistanceAnalyzer::hits(int lineBits, unsigned ways) const {
+    if (lineBits < 0 || lineBits > getMaxLineBits()) {
+        return 0;
+    }
+    const auto& histogram = m_partitions[lineBits].histogram;
+    uint64_t hits = 0;
+    for (unsigned distance = 0; distance < std::min(ways, m_maxWays); distance++) {
+        hits += histogram[distance];
+    }
+    return hits;
+}
+
+long long ReuseDistanceAnalyzer::SetStack::access(uint32_t block) {
+    if (m_tree.size() >= 2 * m_lastAccess.size() + 64) {
+        compact();
+    }
+
+    long long distance = -1;
+    const uint32_t now = static_cast<uint32_t>(m_tree.size()) + 1;
+    auto it = m_lastAccess.find(block);
+    if (it != m_lastAccess.end()) {
+        // Blocks marked after the previous access to this block are the distinct blocks accessed since
+        distance = prefix(now - 1) - prefix(it->second);
+        add(it->second, -1);
+        it->second = now;
+    } else {
+        m_lastAccess[block] = now;
+    }
+    append(1);
+    return distance;
+}
+
+long long ReuseDistanceAnalyzer::SetStack::prefix(uint32_t time) const {
+    long long sum = 0;
+    for (; time > 0; time -= lowbit(time)) {
+        sum += m_tree[time - 1];
+    }
+    return sum;
+}
+
+void ReuseDistanceAnalyzer::SetStack::add(uint32_t time, int value) {
+    for (; time <= m_tree.size(); time += lowbit(time)) {
+        m_tree[time - 1] += value;
+    }
+}
+
+void ReuseDistanceAnalyzer::SetStack::append(int value) {
+    // The new node covers the times ]time - lowbit(time); time], of which all but itself are already in the tree
+    const uint32_t time = static_cast<uint32_t>(m_tree.size()) + 1;
+    const long long covered = prefix(time - 1) - prefix(time - lowbit(time));
+    m_tree.push_back(value + static_cast<int>(covered));
+}
+
+void ReuseDistanceAnalyzer::SetStack::compact() {
+    // Renumber the most recent access of each block to consecutive times, retaining their order
+    std::vector<std::pair<uint32_t, uint32_t>> accesses(m_lastAccess.begin(), m_lastAccess.end());
+    std::sort(accesses.begin(), accesses.end(),
+              [](const auto& a, const auto& b) { return a.second < b.second; });
+    m_tree.clear();
+    for (uint32_t i = 0; i < accesses.size(); i++) {
+        m_lastAccess[accesses[i].first] = i + 1;
+        // All times are marked; a node covers lowbit(time) marked times
+        m_tree.push_back(static_cast<int>(lowbit(i + 1)));
+    }
+}
+
+}  // namespace Ripes
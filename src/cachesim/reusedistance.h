@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The ReuseDistanceAnalyzer class
+ * Computes the LRU stack distance of each access of an access stream, for all cache line (set) counts 2^0 to
+ * 2^maxLineBits at a fixed block size. An access to a set-associative LRU cache hits iff fewer than <ways> distinct
+ * blocks of its set have been accessed since the previous access to its block; a histogram of these distances per line
+ * count thus yields the hit rate of every associativity in a single pass over the stream. All write misses are assumed
+ * to allocate.
+ * Stack distances are computed in O(log n) per access through a Fenwick tree per set over the access times of the set,
+ * in which only the most recent access to each block is marked.
+ */
+class ReuseDistanceAnalyzer {
+public:
+    /**
+     * @brief configure
+     * Resets the analyzer, and analyzes caches of 2^@p blockBits words per block, 2^0 to 2^@p maxLineBits lines and
+     * up to @p maxWays ways.
+     */
+    void configure(int blockBits, int maxLineBits, unsigned maxWays);
+    void reset();
+    void access(uint32_t address);
+
+    /**
+     * @brief hits
+     * @returns the number of accesses which hit in an LRU cache of 2^@p lineBits lines and @p ways ways.
+     */
+    uint64_t hits(int lineBits, unsigned ways) const;
+    uint64_t accesses() const { return m_accesses; }
+    int getMaxLineBits() const { return static_cast<int>(m_partitions.size()) - 1; }
+    unsigned getMaxWays() const { return m_maxWays; }
+
+    /**
+     * @brief The SetStack class
+     * LRU stack of a single cache set. Times are 1-based indices into a Fenwick tree which is extended by each access
+     * and compacted once it holds twice as many access times as there are distinct blocks in the set. On its own, the
+     * LRU stack of a fully associative cache.
+     */
+    class SetStack {
+    public:
+        /**
+         * @returns the number of distinct blocks accessed since the previous access to @p block, or -1 if @p block has
+         * not been accessed before.
+         */
+        long long access(uint32_t block);
+
+    private:
+        long long prefix(uint32_t time) const;
+        void add(uint32_t time, int value);
+        void append(int value);
+        void compact();
+
+        std::vector<int> m_tree;
+        std::unordered_map<uint32_t, uint32_t> m_lastAccess;
+    };
+
+private:
+    struct Partition {
+        std::vector<SetStack> sets;
+        std::vector<uint64_t> histogram;
+    };
+
+    int m_blockBits = 0;
+    unsigned m_maxWays = 0;
+    uint64_t m_accesses = 0;
+    std::vector<Partition> m_partitions;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,149 @@
+#include "shadowcache.h"
+
+#include <algorithm>
+
+#include "binutils.h"
+#include "waysearch.h"
+
+namespace Ripes {
+
+ShadowCache::ShadowCache(const CacheSim::CachePreset& preset) : m_preset(preset), m_ways(1u << preset.ways) {
+    m_lineMask = generateBitmask(preset.lines);
+    reset();
+}
+
+void ShadowCache::reset() {
+    const unsigned entries = (1u << m_preset.lines) * m_ways;
+    m_tags.assign(entries, -1);
+    m_repl.assign(entries, -1);
+    m_valid.assign(entries, false);
+    m_dirty.assign(entries, false);
+    m_plruTree.assign(entries, 0);
+    m_fifoNext.assign(1u << m_preset.lines, 0);
+    m_accesses = 0;
+    m_statistics = Statistics();
+    m_liveStatistics.publish(m_statistics);
+}
+
+void ShadowCache::access(uint32_t address, CacheSim::AccessType type, bool record) {
+    m_accesses++;
+    const unsigned offsetBits = 2 + m_preset.blocks;
+    const unsigned line = (address >> offsetBits) & m_lineMask;
+    const uint32_t tag = static_cast<uint32_t>(static_cast<uint64_t>(address) >> (offsetBits + m_preset.lines));
+    const unsigned base = line * m_ways;
+    const bool write = type == CacheSim::AccessType::Write;
+    const bool writeBack = m_preset.wrPolicy == CacheSim::WritePolicy::WriteBack;
+
+    // Ways are never invalidated once filled, and the tags of invalid ways are -1, which no tag of an address equals
+    unsigned way = findEqual(&m_tags[base], m_ways, tag);
+    const bool hit = way != m_ways;
+    if (hit) {
+        m_dirty[base + way] |= write && writeBack;
+        touch(line, way, false);
+    } else if (!write || m_preset.wrAllocPolicy == CacheSim::WriteAllocPolicy::WriteAllocate) {
+        way = locateVictim(line);
+        const unsigned entry = base + way;
+        if (record && m_valid[entry] && m_dirty[entry]) {
+            m_statistics.writebacks++;
+        }
+        m_tags[entry] = tag;
+        m_valid[entry] = true;
+        m_dirty[entry] = write && writeBack;
+        m_repl[entry] = -1;
+        touch(line, way, true);
+    }
+
+    if (record) {
+        (hit ? m_statistics.hits : m_statistics.misses)++;
+        m_liveStatistics.publish(m_statistics);
+    }
+}
+
+unsigned ShadowCache::locateVictim(unsigned line) {
+    const unsigned base = line * m_ways;
+    if (m_preset.replPolicy == CacheSim::ReplPolicy::Random) {
+        // splitmix64 of the access count
+        uint64_t z = m_preset.seed + m_accesses * 0x9E3779B97F4A7C15;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        z ^= z >> 31;
+        return static_cast<unsigned>(z % m_ways);
+    }
+    const unsigned invalid = findEqual(&m_valid[base], m_ways, uint8_t(false));
+    if (invalid != m_ways) {
+        return invalid;
+    }
+
+    // As for CacheSim::locateReplacementVictim
+    const uint32_t* repl = &m_repl[base];
+    switch (m_preset.replPolicy) {
+        case CacheSim::ReplPolicy::LRU:
+            return findEqual(repl, m_ways, m_ways - 1);
+        case CacheSim::ReplPolicy::PLRU: {
+            unsigned node = 1;
+            while (node < m_ways) {
+                node = 2 * node + m_plruTree[base + node];
+            }
+            return node - m_ways;
+        }
+        case CacheSim::ReplPolicy::FIFO: {
+            const unsigned way = m_fifoNext[line];
+            m_fifoNext[line] = (way + 1) % m_ways;
+            return way;
+        }
+        case CacheSim::ReplPolicy::LFU:
+            return static_cast<unsigned>(std::min_element(repl, repl + m_ways) - repl);
+        case CacheSim::ReplPolicy::SRRIP: {
+            const uint32_t maxRRPV = generateBitmask(CacheSim::s_rrpvBits);
+            const uint32_t aging = maxRRPV - *std::max_element(repl, repl + m_ways);
+            for (unsigned i = base; i < base + m_ways; i++) {
+                m_repl[i] += aging;
+            }
+            return findEqual(repl, m_ways, maxRRPV);
+        }
+        case CacheSim::ReplPolicy::Random:
+            break;
+    }
+    Q_UNREACHABLE();
+}
+
+void ShadowCache::touch(unsigned line, unsigned way, bool fill) {
+    const unsigned base = line * m_ways;
+    const unsigned entry = base + way;
+
+    // As for CacheSim::updateCacheLineReplFields
+    switch (m_preset.replPolicy) {
+        case CacheSim::ReplPolicy::LRU: {
+            const uint32_t preLRU = m_repl[entry];
+            for (unsigned i = base; i < base + m_ways; i++) {
+                if (m_valid[i] && m_repl[i] < preLRU) {
+                    m_repl[i]++;
+                }
+            }
+            m_repl[entry] = 0;
+            break;
+        }
+        case CacheSim::ReplPolicy::PLRU: {
+            unsigned node = 1;
+            for (int level = 0; level < m_preset.ways; level++) {
+                const unsigned half = (way >> (m_preset.ways - 1 - level)) & 1;
+                m_plruTree[base + node] = !half;
+                node = 2 * node + half;
+            }
+            break;
+        }
+        case CacheSim::ReplPolicy::LFU: {
+            const uint32_t maxCount = generateBitmask(CacheSim::s_lfuCounterBits);
+            m_repl[entry] = fill ? 1 : std::min(m_repl[entry] + 1, maxCount);
+            break;
+        }
+        case CacheSim::ReplPolicy::SRRIP:
+            m_repl[entry] = fill ? generateBitmask(CacheSim::s_rrpvBits) - 1 : 0;
+            break;
+        case CacheSim::ReplPolicy::Random:
+        case CacheSim::ReplPolicy::FIFO:
+            break;
+    }
+}
+
+}  // namespace Ripes
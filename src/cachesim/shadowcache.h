@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+#include "cachesim.h"
+#include "snapshot.h"
+
+namespace Ripes {
+
+/**
+ * @brief The ShadowCache class
+ * A lightweight "what-if" cache, which observes the same demand accesses as the CacheSim it is attached to. Shadow
+ * caches model the tag store, replacement and write policies of a cache preset in flat arrays, and only accumulate hit,
+ * miss and writeback counts; they have no graphical view, prefetcher or next levels, and record no undo traces.
+ * Random replacement is seeded by the preset, but advances per access rather than per cycle, and thus does not make
+ * the same decisions as a CacheSim of the same configuration.
+ */
+class ShadowCache {
+public:
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t writebacks = 0;
+    };
+
+    explicit ShadowCache(const CacheSim::CachePreset& preset);
+
+    /**
+     * @brief access
+     * Performs a demand access to @p address. If @p record is false, the access only updates the tag store (see
+     * CacheSim::warmup).
+     */
+    void access(uint32_t address, CacheSim::AccessType type, bool record = true);
+    /// Invalidates all ways and clears the statistics
+    void reset();
+
+    const CacheSim::CachePreset& getPreset() const { return m_preset; }
+    /// @returns the statistics of the most recent access. May be read from any thread while the processor is running.
+    Statistics getLiveStatistics() const { return m_liveStatistics.read(); }
+
+private:
+    unsigned locateVictim(unsigned line);
+    void touch(unsigned line, unsigned way, bool fill);
+
+    CacheSim::CachePreset m_preset;
+    unsigned m_ways = 0;
+    uint32_t m_lineMask = 0;
+
+    // Flat tag store, indexed by line * ways + way; the PLRU tree nodes of a line are indexed from 1 within the line
+    std::vector<uint32_t> m_tags;
+    std::vector<uint32_t> m_repl;
+    std::vector<uint8_t> m_valid;
+    std::vector<uint8_t> m_dirty;
+    std::vector<uint8_t> m_plruTree;
+    std::vector<uint32_t> m_fifoNext;
+    uint64_t m_accesses = 0;
+
+    Statistics m_statistics;
+    Snapshot<Statistics> m_liveStatistics;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,159 @@
+#include "tlbsim.h"
+
+#include "processorhandler.h"
+
+namespace Ripes {
+
+TLBSim::TLBSim(ProcessorHandler* context, TLBType type, QObject* parent)
+    : QObject(parent), m_context(context), m_type(type), m_entries(context, nullptr) {
+    connect(m_context, &ProcessorHandler::reqProcessorReset, this, &TLBSim::processorReset);
+    m_entries.setType(CacheSim::CacheType::UnifiedCache);
+    setConfig(Config());
+}
+
+TLBSim::~TLBSim() {
+    if (m_stallOnMiss) {
+        m_context->setMissStallTLB(this, false);
+    }
+    for (auto* proc : m_context->getConstructedProcessors()) {
+        proc->designWasClocked.Disconnect(this, &TLBSim::processorWasClocked);
+        proc->designWasReversed.Disconnect(this, &TLBSim::processorWasReversed);
+        proc->designWasReset.Disconnect(this, &TLBSim::processorReset);
+    }
+    m_context->getFastEngine()->accessesTraced.Disconnect(this, &TLBSim::accessesTraced);
+}
+
+void TLBSim::setConfig(const Config& config) {
+    m_config = config;
+    CacheSim::CachePreset preset;
+    // Each entry holds the translation of a single page
+    preset.blocks = 0;
+    preset.lines = config.sets;
+    preset.ways = config.ways;
+    preset.wrPolicy = CacheSim::WritePolicy::WriteBack;
+    preset.wrAllocPolicy = CacheSim::WriteAllocPolicy::WriteAllocate;
+    preset.replPolicy = config.replPolicy;
+    m_entries.setPreset(preset);
+    m_entries.setHitLatency(0);
+    m_entries.setMemoryLatency(config.walkLatency);
+    processorReset();
+}
+
+void TLBSim::setStallOnMiss(bool enabled) {
+    m_stallOnMiss = enabled;
+    m_context->setMissStallTLB(this, enabled);
+}
+
+double TLBSim::getHitRate() const {
+    const uint64_t accesses = getAccesses();
+    return accesses != 0 ? static_cast<double>(getHits()) / accesses : 0;
+}
+
+unsigned TLBSim::getStallCycles(uint32_t address) const {
+    const uint32_t page = address >> s_pageBits;
+    if (m_lastStall.cycle == m_context->getProcessor()->getCycleCount() && m_lastStall.page == page) {
+        return m_lastStall.cycles;
+    }
+    if (m_micro[page % s_microEntries] == page) {
+        return 0;
+    }
+    return m_entries.getMissPenalty(entryAddress(page), CacheSim::AccessType::Read);
+}
+
+void TLBSim::translate(uint32_t address) {
+    const uint32_t page = address >> s_pageBits;
+    uint32_t& micro = m_micro[page % s_microEntries];
+    if (micro == page) {
+        m_microHits++;
+        return;
+    }
+    if (m_stallOnMiss) {
+        // The processor determines its stall cycles from the state of the TLB before the access
+        m_lastStall = {m_context->getProcessor()->getCycleCount(), page,
+                       m_entries.getMissPenalty(entryAddress(page), CacheSim::AccessType::Read)};
+    }
+    const uint64_t misses = m_entries.getMisses();
+    m_entries.access(entryAddress(page), CacheSim::AccessType::Read);
+    if (m_entries.getMisses() != misses) {
+        // The refill may have evicted any page held by the micro-TLB
+        flushMicroTLB();
+    }
+    micro = page;
+}
+
+void TLBSim::processorWasClocked() {
+    const auto* proc = m_context->getProcessor();
+    const bool instr = m_type == TLBType::InstrTLB;
+    if (proc->isRepeatedMemoryAccess(instr)) {
+        // The processor is stalled on an access which was translated in the cycle it was issued
+        return;
+    }
+    if (instr) {
+        translate(static_cast<uint32_t>(m_instrMemory->addr.uValue()));
+        return;
+    }
+    switch (m_dataMemory->op.uValue()) {
+        case MemOp::SB:
+        case MemOp::SH:
+        case MemOp::SW:
+            if (m_dataMemory->wr_en.uValue() == 0) {
+                return;
+            }
+            break;
+        case MemOp::LB:
+        case MemOp::LBU:
+        case MemOp::LH:
+        case MemOp::LHU:
+        case MemOp::LW:
+            break;
+        default:
+            return;
+    }
+    translate(static_cast<uint32_t>(m_dataMemory->addr.uValue()));
+}
+
+void TLBSim::processorWasReversed() {
+    // The entry cache reverses itself, and may no longer hold the pages of the micro-TLB
+    flushMicroTLB();
+}
+
+void TLBSim::processorReset() {
+    connectProcessor();
+    flushMicroTLB();
+    m_microHits = 0;
+    m_lastStall = StallRecord();
+}
+
+void TLBSim::connectProcessor() {
+    // As per CacheSim, the processor might have changed, and connections are thus made anew
+    auto* proc = m_context->getProcessorNonConst();
+    proc->designWasClocked.Disconnect(this, &TLBSim::processorWasClocked);
+    proc->designWasReversed.Disconnect(this, &TLBSim::processorWasReversed);
+    proc->designWasReset.Disconnect(this, &TLBSim::processorReset);
+    proc->designWasClocked.Connect(this, &TLBSim::processorWasClocked);
+    proc->designWasReversed.Connect(this, &TLBSim::processorWasReversed);
+    proc->designWasReset.Connect(this, &TLBSim::processorReset);
+    auto* fastEngine = m_context->getFastEngine();
+    fastEngine->accessesTraced.Disconnect(this, &TLBSim::accessesTraced);
+    fastEngine->accessesTraced.Connect(this, &TLBSim::accessesTraced);
+    m_dataMemory = m_context->getDataMemory();
+    m_instrMemory = m_context->getInstrMemory();
+}
+
+void TLBSim::accessesTraced(const std::vector<vsrtl::core::TracedMemoryAccess>& accesses) {
+    // Accesses of the functional interpreter warm up the TLB, without being counted
+    for (const auto& access : accesses) {
+        if ((access.kind == vsrtl::core::TracedMemoryAccess::Fetch) != (m_type == TLBType::InstrTLB)) {
+            continue;
+        }
+        const uint32_t page = access.address >> s_pageBits;
+        uint32_t& micro = m_micro[page % s_microEntries];
+        if (micro != page) {
+            m_entries.warmup(entryAddress(page), CacheSim::AccessType::Read);
+            flushMicroTLB();
+            micro = page;
+        }
+    }
+}
+
+}  // namespace Ripes
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <QObject>
+
+#include "cachesim.h"
+
+namespace Ripes {
+
+class ProcessorHandler;
+
+/**
+ * @brief The TLBSim class
+ * Performance model of an Sv32 instruction or data TLB in front of the instruction or data memory of the processor.
+ * The processors of Ripes execute in machine mode without address translation, such that addresses are translated
+ * through an identity mapping of 4 KiB pages; the model determines which accesses would hit or miss in the TLB, and
+ * the cycles spent walking the two-level page table upon misses, but not the walks' memory accesses themselves.
+ * Translations are looked up in a direct-mapped micro-TLB of s_microEntries pages first, which holds a subset of the
+ * TLB, and which is flushed whenever the TLB is refilled. Only micro-TLB misses access the TLB itself, which is
+ * simulated as a cache of one page number per entry (see CacheSim), and thus supports all replacement policies of
+ * CacheSim. Misses cost walkLatency cycles; if stalling on misses, the processor is stalled for them, as per the
+ * caches (see ProcessorHandler::setMissStallTLB).
+ * The TLB follows the processor when it is reversed. Micro-TLB hits are counted as TLB hits, and are not uncounted
+ * when the processor is reversed.
+ */
+class TLBSim : public QObject {
+    Q_OBJECT
+public:
+    static constexpr unsigned s_pageBits = 12;
+    static constexpr unsigned s_microEntries = 8;
+
+    enum class TLBType { InstrTLB, DataTLB };
+
+    struct Config {
+        /// Sets and ways of the TLB, as the base-2 logarithm of each
+        int sets = 4;
+        int ways = 2;
+        CacheSim::ReplPolicy replPolicy = CacheSim::ReplPolicy::LRU;
+        unsigned walkLatency = 20;
+    };
+
+    TLBSim(ProcessorHandler* context, TLBType type, QObject* parent = nullptr);
+    ~TLBSim() override;
+
+    TLBType getType() const { return m_type; }
+    void setConfig(const Config& config);
+    const Config& getConfig() const { return m_config; }
+
+    /**
+     * @brief setStallOnMiss
+     * If enabled, the processor is stalled for the page walk of each TLB miss, if it models memory stalls.
+     */
+    void setStallOnMiss(bool enabled);
+    bool isStallOnMissEnabled() const { return m_stallOnMiss; }
+
+    /**
+     * @brief getStallCycles
+     * @returns the cycles which the processor is stalled for upon an access to @p address in the current cycle; the
+     * page walk latency recorded right before the access once it has been simulated, and the walk latency of the
+     * current state of the TLB otherwise.
+     */
+    unsigned getStallCycles(uint32_t address) const;
+
+    /// Translates @p address, looking it up in the micro-TLB and TLB and refilling them upon misses
+    void translate(uint32_t address);
+
+    uint64_t getAccesses() const { return getHits() + getMisses(); }
+    uint64_t getMicroHits() const { return m_microHits; }
+    uint64_t getHits() const { return m_microHits + m_entries.getHits(); }
+    uint64_t getMisses() const { return m_entries.getMisses(); }
+    double getHitRate() const;
+    /// Cycles spent walking page tables upon misses
+    uint64_t getWalkCycles() const { return getMisses() * m_config.walkLatency; }
+    unsigned getEntries() const { return 1u << (m_config.sets + m_config.ways); }
+    /// Bytes of memory mapped by a full TLB
+    uint64_t getReach() const { return static_cast<uint64_t>(getEntries()) << s_pageBits; }
+
+public slots:
+    void processorWasClocked();
+    void processorWasReversed();
+    void processorReset();
+
+private:
+    static constexpr uint32_t s_invalidPage = UINT32_MAX;
+
+    void connectProcessor();
+    void accessesTraced(const std::vector<vsrtl::core::TracedMemoryAccess>& accesses);
+    /// @returns the address of the TLB entry of page @p page, as accessed upon the entry cache
+    static uint32_t entryAddress(uint32_t page) { return page << 2 /*byte offset*/; }
+    void flushMicroTLB() { m_micro.fill(s_invalidPage); }
+
+    ProcessorHandler* m_context;
+    TLBType m_type;
+    Config m_config;
+    CacheSim m_entries;
+    std::array<uint32_t, s_microEntries> m_micro;
+    uint64_t m_microHits = 0;
+
+    bool m_stallOnMiss = false;
+    // Walk latency of the most recent access which the processor is stalled on, recorded before it was simulated
+    struct StallRecord {
+        long long cycle = -1;
+        uint32_t page = 0;
+        unsigned cycles = 0;
+    };
+    StallRecord m_lastStall;
+
+    const RWMemory* m_dataMemory = nullptr;
+    const ROMMemory* m_instrMemory = nullptr;
+};
+
+}  // namespace Ripes
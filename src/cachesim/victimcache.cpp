@@ -0,0 +1,55 @@
+#include "victimcache.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+void VictimCache::configure(unsigned entries, int blockBits) {
+    m_blockShift = 2 /*byte offset*/ + blockBits;
+    m_capacity = entries;
+    reset();
+}
+
+void VictimCache::reset() {
+    m_blocks.clear();
+}
+
+bool VictimCache::take(uint32_t address, Undo& undo) {
+    const auto it = std::find(m_blocks.begin(), m_blocks.end(), address >> m_blockShift);
+    if (it == m_blocks.end()) {
+        return false;
+    }
+    undo.hit = true;
+    undo.hitBlock = *it;
+    undo.hitPosition = static_cast<unsigned>(it - m_blocks.begin());
+    m_blocks.erase(it);
+    return true;
+}
+
+bool VictimCache::contains(uint32_t address) const {
+    return std::find(m_blocks.begin(), m_blocks.end(), address >> m_blockShift) != m_blocks.end();
+}
+
+void VictimCache::insert(uint32_t address, Undo& undo) {
+    if (m_blocks.size() == m_capacity) {
+        undo.hasDisplaced = true;
+        undo.displaced = m_blocks.back();
+        m_blocks.pop_back();
+    }
+    m_blocks.insert(m_blocks.begin(), address >> m_blockShift);
+    undo.inserted = true;
+}
+
+void VictimCache::undo(const Undo& undo) {
+    if (undo.inserted) {
+        m_blocks.erase(m_blocks.begin());
+        if (undo.hasDisplaced) {
+            m_blocks.push_back(undo.displaced);
+        }
+    }
+    if (undo.hit) {
+        m_blocks.insert(m_blocks.begin() + undo.hitPosition, undo.hitBlock);
+    }
+}
+
+}  // namespace Ripes
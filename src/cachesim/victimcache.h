@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The VictimCache class
+ * Small fully associative LRU cache of the blocks most recently evicted from a cache. A miss in the cache which hits in
+ * the victim cache is served from it, rather than from the next level, and the victim block moves back into the cache.
+ * Dirty blocks are written back when evicted from the cache, such that the victim cache only holds clean blocks, and
+ * only tracks block addresses.
+ * All accesses may be undone in reverse order, and the victim cache is copyable, such that it follows the cache when
+ * the processor is reversed or restored to a checkpoint.
+ */
+class VictimCache {
+public:
+    /**
+     * @brief The Undo struct
+     * The state required for undoing an access; the position of the block taken by a victim hit, and the block
+     * inserted by an eviction, along with the block it displaced from a full victim cache.
+     */
+    struct Undo {
+        bool hit = false;
+        uint32_t hitBlock = 0;
+        unsigned hitPosition = 0;
+        bool inserted = false;
+        bool hasDisplaced = false;
+        uint32_t displaced = 0;
+    };
+
+    /**
+     * @brief configure
+     * Resets the victim cache, and configures it for @p entries blocks of 2^@p blockBits words. A victim cache of 0
+     * entries is disabled.
+     */
+    void configure(unsigned entries, int blockBits);
+    void reset();
+    bool enabled() const { return m_capacity != 0; }
+    unsigned capacity() const { return m_capacity; }
+
+    /**
+     * @brief take
+     * Looks up the block of @p address upon a miss in the cache, removing it from the victim cache if present.
+     * @returns true if the block was present (a victim hit).
+     */
+    bool take(uint32_t address, Undo& undo);
+    /// @returns true if the block of @p address is held by the victim cache
+    bool contains(uint32_t address) const;
+    /// Inserts the block of @p address, evicted from the cache, as the most recently used block
+    void insert(uint32_t address, Undo& undo);
+    void undo(const Undo& undo);
+
+private:
+    int m_blockShift = 2;
+    unsigned m_capacity = 0;
+    // Blocks of the victim cache, from the most to the least recently used
+    std::vector<uint32_t> m_blocks;
+};
+
+}  // namespace Ripes
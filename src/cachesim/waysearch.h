@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QtAlgorithms>
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RIPES_WAYSEARCH_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define RIPES_WAYSEARCH_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RIPES_WAYSEARCH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Ripes {
+
+/**
+ * Vectorized searches over the per-way arrays of a line in the cache tag store. Ways are compared 4-32 at a time
+ * with SSE2, AVX2 or NEON compare-and-movemask sequences where the compiler targets these, with a scalar loop for the
+ * remaining ways and for other targets.
+ */
+
+/**
+ * @brief findEqual
+ * @returns the index of the first of the @p n values at @p values, at or after @p begin, which is equal to @p value,
+ * or @p n if there is none.
+ */
+inline unsigned findEqual(const uint32_t* values, unsigned n, uint32_t value, unsigned begin = 0) {
+    unsigned i = begin;
+#ifdef RIPES_WAYSEARCH_AVX2
+    const __m256i needle8 = _mm256_set1_epi32(static_cast<int>(value));
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        const __m256i eq = _mm256_cmpeq_epi32(v, needle8);
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+        if (mask != 0) {
+            return i + qCountTrailingZeroBits(mask);
+        }
+    }
+#endif
+#if defined(RIPES_WAYSEARCH_SSE2)
+    const __m128i needle4 = _mm_set1_epi32(static_cast<int>(value));
+    for (; i + 4 <= n; i += 4) {
+        const __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), needle4);
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+        if (mask != 0) {
+            return i + qCountTrailingZeroBits(mask);
+        }
+    }
+#elif defined(RIPES_WAYSEARCH_NEON)
+    const uint32x4_t needle4 = vdupq_n_u32(value);
+    for (; i + 4 <= n; i += 4) {
+        // Narrow the lane masks to 16 bits each, packing them into a single 64-bit word
+        const uint32x4_t eq = vceqq_u32(vld1q_u32(values + i), needle4);
+        const uint64_t mask = vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(eq)), 0);
+        if (mask != 0) {
+            return i + qCountTrailingZeroBits(mask) / 16;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (values[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+/// @returns the index of the first of the @p n values at @p values which is equal to @p value, or @p n if there is none
+inline unsigned findEqual(const uint8_t* values, unsigned n, uint8_t value) {
+    unsigned i = 0;
+#ifdef RIPES_WAYSEARCH_AVX2
+    const __m256i needle32 = _mm256_set1_epi8(static_cast<char>(value));
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        const __m256i eq = _mm256_cmpeq_epi8(v, needle32);
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+        if (mask != 0) {
+            return i + qCountTrailingZeroBits(mask);
+        }
+    }
+#endif
+#if defined(RIPES_WAYSEARCH_SSE2)
+    const __m128i needle16 = _mm_set1_epi8(static_cast<char>(value));
+    for (; i + 16 <= n; i += 16) {
+        const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), needle16);
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+        if (mask != 0) {
+            return i + qCountTrailingZeroBits(mask);
+        }
+    }
+#elif defined(RIPES_WAYSEARCH_NEON)
+    const uint8x16_t needle16 = vdupq_n_u8(value);
+    for (; i + 16 <= n; i += 16) {
+        // Shift-narrow the byte masks to 4 bits each, packing them into a single 64-bit word
+        const uint8x16_t eq = vceqq_u8(vld1q_u8(values + i), needle16);
+        const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (mask != 0) {
+            return i + qCountTrailingZeroBits(mask) / 4;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (values[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,55 @@
+#include "writebuffer.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+void WriteBuffer::configure(unsigned entries, int blockBits) {
+    m_blockShift = 2 /*byte offset*/ + blockBits;
+    m_capacity = entries;
+    reset();
+}
+
+void WriteBuffer::reset() {
+    m_entries.clear();
+}
+
+WriteBuffer::Result WriteBuffer::write(uint32_t address, uint64_t time, unsigned drainLatency, Undo& undo) {
+    undo = Undo();
+    // Drain times are increasing along the buffer, such that the drained entries are found at its front
+    while (!m_entries.empty() && m_entries.front().drainTime <= time) {
+        undo.retired.push_back(m_entries.front());
+        m_entries.pop_front();
+    }
+
+    const uint32_t block = address >> m_blockShift;
+    const bool buffered = std::any_of(m_entries.begin(), m_entries.end(),
+                                      [block](const Entry& entry) { return entry.block == block; });
+    if (buffered) {
+        return Result::Coalesced;
+    }
+
+    Result result = Result::Buffered;
+    if (m_entries.size() == m_capacity) {
+        // The write is issued once the oldest entry has drained
+        result = Result::Stalled;
+        time = m_entries.front().drainTime;
+        undo.retired.push_back(m_entries.front());
+        m_entries.pop_front();
+    }
+    const uint64_t start = m_entries.empty() ? time : std::max(time, m_entries.back().drainTime);
+    m_entries.push_back({block, start + drainLatency});
+    undo.allocated = true;
+    return result;
+}
+
+void WriteBuffer::undo(const Undo& undo) {
+    if (undo.allocated) {
+        m_entries.pop_back();
+    }
+    for (auto it = undo.retired.rbegin(); it != undo.retired.rend(); ++it) {
+        m_entries.push_front(*it);
+    }
+}
+
+}  // namespace Ripes
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The WriteBuffer class
+ * Timing model of an N-entry write buffer between a write-through cache and its next level. Written-through words are
+ * buffered by block, and drained to the next level in order, one entry per drain latency. A write to a block which is
+ * still buffered is coalesced into its entry, and is not written to the next level. A write to a full buffer stalls
+ * until the oldest entry has drained.
+ * Entries are retired lazily as time advances past their drain time. All writes may be undone in reverse order, and
+ * the buffer is copyable, such that it follows the cache when the processor is reversed or restored to a checkpoint.
+ */
+class WriteBuffer {
+public:
+    enum class Result { Buffered, Coalesced, Stalled };
+
+    /// A buffered block, and the time at which it has drained to the next level
+    struct Entry {
+        uint32_t block = 0;
+        uint64_t drainTime = 0;
+    };
+
+    /**
+     * @brief The Undo struct
+     * The state required for undoing a write; the entries retired by it, and whether it allocated a new entry.
+     */
+    struct Undo {
+        bool allocated = false;
+        std::vector<Entry> retired;
+    };
+
+    /**
+     * @brief configure
+     * Resets the buffer, and configures it for @p entries entries of blocks of 2^@p blockBits words. A buffer of 0
+     * entries is disabled.
+     */
+    void configure(unsigned entries, int blockBits);
+    void reset();
+    bool enabled() const { return m_capacity != 0; }
+    unsigned capacity() const { return m_capacity; }
+
+    /**
+     * @brief write
+     * Buffers a write of @p address at @p time, which is drained to the next level @p drainLatency after the previous
+     * entry. Records the state required for undoing it in @p undo.
+     */
+    Result write(uint32_t address, uint64_t time, unsigned drainLatency, Undo& undo);
+    void undo(const Undo& undo);
+
+private:
+    int m_blockShift = 2;
+    unsigned m_capacity = 0;
+    // Buffered entries, in order of draining
+    std::deque<Entry> m_entries;
+};
+
+}  // namespace Ripes
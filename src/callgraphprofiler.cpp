@@ -0,0 +1,189 @@
+#include "callgraphprofiler.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "defines.h"
+
+namespace Ripes {
+
+void CallGraphProfiler::setProgram(const Program* program) {
+    m_kinds.clear();
+    m_functionAt.clear();
+    m_symbols.clear();
+    m_textStart = 0;
+    if (const auto* text = program ? program->getSection(TEXT_SECTION_NAME) : nullptr) {
+        m_textStart = static_cast<uint32_t>(text->address);
+        m_symbols = program->symbols;
+        const auto* data = reinterpret_cast<const uint8_t*>(text->data.constData());
+        const size_t count = static_cast<size_t>(text->data.size()) / 4;
+        m_kinds.assign(count, Kind::Other);
+        m_functionAt.assign(count, s_noNode);
+        for (size_t i = 0; i < count; i++) {
+            const uint32_t instr = data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16) |
+                                   (static_cast<uint32_t>(data[i * 4 + 3]) << 24);
+            const uint32_t opcode = instr & 0b1111111;
+            const uint32_t rd = (instr >> 7) & 0b11111;
+            const uint32_t rs1 = (instr >> 15) & 0b11111;
+            if ((opcode == instrType::JAL || opcode == instrType::JALR) && rd == 1) {
+                m_kinds[i] = Kind::Call;
+            } else if (opcode == instrType::JALR && rd == 0 && rs1 == 1 && (instr >> 20) == 0) {
+                m_kinds[i] = Kind::Return;
+            }
+        }
+    }
+    m_functions.clear();
+    m_functionsByName.clear();
+    clear();
+}
+
+void CallGraphProfiler::clear() {
+    m_nodes.clear();
+    m_children.clear();
+    m_depth = 0;
+    m_overflow = 0;
+    m_pendingCall = false;
+    m_last = m_sampler ? m_sampler() : Sample();
+}
+
+uint32_t CallGraphProfiler::functionAt(uint32_t pc) {
+    const uint32_t offset = pc - m_textStart;
+    const bool inText = (offset & 0b11) == 0 && (offset >> 2) < m_functionAt.size();
+    if (inText && m_functionAt[offset >> 2] != s_noNode) {
+        return m_functionAt[offset >> 2];
+    }
+
+    QString name;
+    uint32_t address = pc;
+    auto symbol = m_symbols.upper_bound(pc);
+    if (inText && symbol != m_symbols.begin() && std::prev(symbol)->first >= m_textStart) {
+        name = std::prev(symbol)->second;
+        address = static_cast<uint32_t>(std::prev(symbol)->first);
+    } else {
+        name = inText ? QString(TEXT_SECTION_NAME) : "0x" + QString::number(pc, 16);
+        address = inText ? m_textStart : pc;
+    }
+    auto it = m_functionsByName.find(name);
+    if (it == m_functionsByName.end()) {
+        it = m_functionsByName.emplace(name, static_cast<uint32_t>(m_functions.size())).first;
+        m_functions.emplace_back(name, address);
+    }
+    if (inText) {
+        m_functionAt[offset >> 2] = it->second;
+    }
+    return it->second;
+}
+
+void CallGraphProfiler::account() {
+    if (!m_sampler) {
+        return;
+    }
+    const Sample sample = m_sampler();
+    if (m_depth != 0) {
+        m_nodes[m_stack[m_depth - 1]].exclusive += sample - m_last;
+    }
+    m_last = sample;
+}
+
+void CallGraphProfiler::enter(uint32_t pc) {
+    m_pendingCall = false;
+    if (m_depth == s_maxDepth) {
+        m_overflow++;
+        return;
+    }
+    account();
+    const uint32_t parent = m_depth == 0 ? s_noNode : m_stack[m_depth - 1];
+    const uint32_t function = functionAt(pc);
+    const uint64_t key = (static_cast<uint64_t>(parent + 1) << 32) | function;
+    auto child = m_children.find(key);
+    if (child == m_children.end()) {
+        child = m_children.emplace(key, static_cast<uint32_t>(m_nodes.size())).first;
+        m_nodes.push_back({parent, function});
+    }
+    m_nodes[child->second].calls++;
+    m_stack[m_depth++] = child->second;
+}
+
+void CallGraphProfiler::leave() {
+    if (m_overflow != 0) {
+        m_overflow--;
+        return;
+    }
+    if (m_depth != 0) {
+        account();
+        m_depth--;
+    }
+}
+
+std::vector<CallGraphProfiler::Sample> CallGraphProfiler::nodeCounts() const {
+    std::vector<Sample> counts(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        counts[i] = m_nodes[i].exclusive;
+    }
+    if (m_sampler && m_depth != 0) {
+        counts[m_stack[m_depth - 1]] += m_sampler() - m_last;
+    }
+    return counts;
+}
+
+std::vector<CallGraphProfiler::Function> CallGraphProfiler::functions() const {
+    const std::vector<Sample> exclusive = nodeCounts();
+    // Nodes are created after their parents, such that the inclusive counts accumulate in a single reverse pass
+    std::vector<Sample> inclusive = exclusive;
+    for (size_t i = m_nodes.size(); i-- > 0;) {
+        if (m_nodes[i].parent != s_noNode) {
+            inclusive[m_nodes[i].parent] += inclusive[i];
+        }
+    }
+
+    std::vector<Function> functions(m_functions.size());
+    for (size_t i = 0; i < m_functions.size(); i++) {
+        functions[i].name = m_functions[i].first;
+        functions[i].address = m_functions[i].second;
+    }
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        const Node& node = m_nodes[i];
+        Function& function = functions[node.function];
+        function.calls += node.calls;
+        function.exclusive += exclusive[i];
+        // Only the outermost frame of a recursion contributes to the inclusive counts
+        bool recursive = false;
+        for (uint32_t parent = node.parent; parent != s_noNode && !recursive; parent = m_nodes[parent].parent) {
+            recursive = m_nodes[parent].function == node.function;
+        }
+        if (!recursive) {
+            function.inclusive += inclusive[i];
+        }
+    }
+
+    functions.erase(std::remove_if(functions.begin(), functions.end(), [](const Function& f) { return f.calls == 0; }),
+                    functions.end());
+    std::sort(functions.begin(), functions.end(),
+              [](const Function& a, const Function& b) { return a.inclusive.cycles > b.inclusive.cycles; });
+    return functions;
+}
+
+QByteArray CallGraphProfiler::foldedStacks(Metric metric) const {
+    const std::vector<Sample> counts = nodeCounts();
+    QByteArray folded;
+    std::vector<uint32_t> path;
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        const long long count = metric == Metric::Cycles ? counts[i].cycles : counts[i].misses;
+        if (count <= 0) {
+            continue;
+        }
+        path.clear();
+        for (uint32_t node = static_cast<uint32_t>(i); node != s_noNode; node = m_nodes[node].parent) {
+            path.push_back(m_nodes[node].function);
+        }
+        for (size_t j = path.size(); j-- > 0;) {
+            // Frames are separated by ';', which must not appear within a frame
+            folded += QString(m_functions[path[j]].first).replace(';', ':').toUtf8();
+            folded += j != 0 ? ';' : ' ';
+        }
+        folded += QByteArray::number(count) + '\n';
+    }
+    return folded;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CallGraphProfiler class
+ * Attributes cycles and cache misses to the functions of the loaded program along the calls taken to reach them. A
+ * shadow call stack is maintained from the retired instructions: JAL/JALR linking to ra calls the function containing
+ * the next retired instruction, and JALR x0, 0(ra) returns from it. Counts are only sampled as calls are entered and
+ * left, and the kind of each instruction is decoded once per program into a flat array over the text section, such
+ * that retiring an instruction which neither calls nor returns costs a single lookup.
+ */
+class CallGraphProfiler {
+public:
+    /// Counters from which the profile is attributed; cycles and cache misses
+    struct Sample {
+        long long cycles = 0;
+        long long misses = 0;
+        Sample& operator+=(const Sample& other) {
+            cycles += other.cycles;
+            misses += other.misses;
+            return *this;
+        }
+        Sample operator-(const Sample& other) const { return {cycles - other.cycles, misses - other.misses}; }
+    };
+    using Sampler = std::function<Sample()>;
+
+    enum class Metric { Cycles, Misses };
+
+    /**
+     * @brief The Function struct
+     * Counts of a function; exclusive counts are spent within the function itself, inclusive counts also within the
+     * functions which it called. Recursive calls are counted once in the inclusive counts.
+     */
+    struct Function {
+        QString name;
+        uint32_t address = 0;
+        long long calls = 0;
+        Sample exclusive;
+        Sample inclusive;
+    };
+
+    /// Calls nested deeper than this are attributed to the deepest recorded frame
+    static constexpr unsigned s_maxDepth = 256;
+
+    void setSampler(Sampler sampler) { m_sampler = std::move(sampler); }
+
+    /**
+     * @brief setProgram
+     * Profiles calls within the text section of @p program, or no calls if nullptr, discarding the call graph.
+     */
+    void setProgram(const Program* program);
+
+    /**
+     * @brief clear
+     * Discards the call graph. Profiling continues from the current counters, with the function containing the next
+     * retired instruction as the root of the call stack.
+     */
+    void clear();
+
+    /// Records the retirement of the instruction at @p pc
+    void retire(uint32_t pc) {
+        if (m_pendingCall || m_depth == 0) {
+            enter(pc);
+        }
+        const uint32_t offset = pc - m_textStart;
+        if ((offset >> 2) < m_kinds.size()) {
+            const Kind kind = m_kinds[offset >> 2];
+            if (kind == Kind::Call) {
+                m_pendingCall = true;
+            } else if (kind == Kind::Return) {
+                leave();
+            }
+        }
+    }
+
+    bool empty() const { return m_nodes.empty(); }
+
+    /// @returns the counts of each function which has been called, sorted by decreasing inclusive cycles
+    std::vector<Function> functions() const;
+
+    /**
+     * @brief foldedStacks
+     * @returns the exclusive counts of @p metric of each call stack in the folded stack format of flame graph tools;
+     * one line per call stack, of the functions from the root to the leaf separated by ';', followed by the count.
+     */
+    QByteArray foldedStacks(Metric metric) const;
+
+private:
+    enum class Kind : uint8_t { Other, Call, Return };
+    static constexpr uint32_t s_noNode = UINT32_MAX;
+
+    struct Node {
+        uint32_t parent;
+        uint32_t function;
+        long long calls = 0;
+        Sample exclusive;
+    };
+
+    void enter(uint32_t pc);
+    void leave();
+    /// Attributes the counts since the last call or return to the current frame
+    void account();
+    uint32_t functionAt(uint32_t pc);
+    /// @returns the exclusive counts of each node, including those of the current frame not yet accounted
+    std::vector<Sample> nodeCounts() const;
+
+    Sampler m_sampler;
+    Sample m_last;
+
+    uint32_t m_textStart = 0;
+    std::vector<Kind> m_kinds;
+    std::map<unsigned long, QString> m_symbols;
+    /// Function index of each instruction of the text section which has been called, or s_noNode
+    std::vector<uint32_t> m_functionAt;
+    std::vector<std::pair<QString, uint32_t>> m_functions;
+    std::map<QString, uint32_t> m_functionsByName;
+
+    std::vector<Node> m_nodes;
+    /// Child node of each (parent node + 1, function) pair
+    std::unordered_map<uint64_t, uint32_t> m_children;
+
+    std::array<uint32_t, s_maxDepth> m_stack;
+    unsigned m_depth = 0;
+    /// Calls entered beyond s_maxDepth which have not been left
+    unsigned m_overflow = 0;
+    bool m_pendingCall = false;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,293 @@
+#include "checkpointjournal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "simulationsnapshot.h"
+
+namespace Ripes {
+
+using vsrtl::core::ProcessorCheckpoint;
+using vsrtl::core::RipesProcessor;
+using vsrtl::core::SparseArray;
+
+namespace {
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t getVarint(const uint8_t*& in) {
+    uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        const uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+
+/// Writes the (key, XOR) pairs as their count followed by each key, relative to the preceding key, and XOR value
+template <typename Pairs>
+void putPairs(std::vector<uint8_t>& out, const Pairs& pairs) {
+    putVarint(out, pairs.size());
+    uint64_t previous = 0;
+    for (const auto& [key, value] : pairs) {
+        putVarint(out, key - previous);
+        putVarint(out, value);
+        previous = key;
+    }
+}
+
+void getPairs(const uint8_t*& in, std::map<uint64_t, uint64_t>& pairs) {
+    const uint64_t count = getVarint(in);
+    uint64_t key = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        key += getVarint(in);
+        const uint64_t value = getVarint(in);
+        // Values which XOR to zero cancel out
+        auto it = pairs.emplace(key, 0).first;
+        it->second ^= value;
+        if (it->second == 0) {
+            pairs.erase(it);
+        }
+    }
+}
+
+void copyCounters(const ProcessorCheckpoint& from, ProcessorCheckpoint& to) {
+    to.cycle = from.cycle;
+    to.instructionsRetired = from.instructionsRetired;
+    to.memoryStallCycles = from.memoryStallCycles;
+    to.branchPrediction = from.branchPrediction;
+    to.functionalUnits = from.functionalUnits;
+    to.hazards = from.hazards;
+}
+}  // namespace
+
+void CheckpointJournal::record(RipesProcessor& processor) {
+    m_scratch.journaled = true;
+    processor.saveCheckpoint(m_scratch);
+    Q_ASSERT(m_scratch.cycle > latest());
+
+    Entry& entry = m_entries[m_scratch.cycle];
+    copyCounters(m_scratch, entry.checkpoint);
+    entry.offset = m_arena.size();
+    encodeValues(m_scratch);
+    encodeSpace(processor.getArchRegisters(), m_spaces[0]);
+    encodeSpace(processor.getMemory(), m_spaces[1]);
+    entry.size = m_arena.size() - entry.offset;
+}
+
+void CheckpointJournal::encodeValues(const ProcessorCheckpoint& checkpoint) {
+    const size_t count = checkpoint.registerValues.size() + checkpoint.processorState.size();
+    if (m_values.empty()) {
+        m_registerCount = checkpoint.registerValues.size();
+        m_values.assign(count, 0);
+    }
+    Q_ASSERT(m_values.size() == count && m_registerCount == checkpoint.registerValues.size());
+
+    m_pairs.clear();
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t value = i < m_registerCount ? static_cast<uint64_t>(checkpoint.registerValues[i])
+                                                   : static_cast<uint64_t>(checkpoint.processorState[i - m_registerCount]);
+        if (value != m_values[i]) {
+            m_pairs.emplace_back(i, value ^ m_values[i]);
+            m_values[i] = value;
+        }
+    }
+    putPairs(m_arena, m_pairs);
+}
+
+void CheckpointJournal::encodeSpace(const SparseArray& memory, AddressSpace& space) {
+    // The populated bytes are gathered into the scratch pages, in whatever order the address space stores them. Pages of
+    // the latest checkpoint always have a scratch page, such that pages which are no longer populated are diffed too.
+    for (auto& [index, page] : space.scratch) {
+        std::fill(page.begin(), page.end(), 0);
+    }
+    for (const auto& entry : memory) {
+        const auto address = static_cast<uint32_t>(entry.first);
+        auto& page = space.scratch[address >> s_pageBits];
+        if (page.empty()) {
+            page.assign(s_recordSize, 0);
+        }
+        const uint32_t offset = address & (s_pageSize - 1);
+        page[offset / 8] |= 1 << (offset % 8);
+        page[s_pageSize / 8 + offset] = static_cast<uint8_t>(entry.second);
+    }
+
+    m_pairs.clear();
+    for (const auto& [index, page] : space.scratch) {
+        auto previous = space.pages.find(index);
+        if (previous != space.pages.end() && std::memcmp(previous->second.data(), page.data(), s_recordSize) == 0) {
+            continue;
+        }
+        if (previous == space.pages.end()) {
+            if (std::all_of(page.begin(), page.end(), [](uint8_t byte) { return byte == 0; })) {
+                continue;
+            }
+            previous = space.pages.emplace(index, std::vector<uint8_t>(s_recordSize, 0)).first;
+        }
+        for (unsigned word = 0; word < s_recordWords; word++) {
+            uint32_t current, old;
+            std::memcpy(&current, page.data() + word * 4, 4);
+            std::memcpy(&old, previous->second.data() + word * 4, 4);
+            if (current != old) {
+                m_pairs.emplace_back(static_cast<uint64_t>(index) * s_recordWords + word, current ^ old);
+            }
+        }
+        previous->second = page;
+    }
+    putPairs(m_arena, m_pairs);
+}
+
+void CheckpointJournal::decode(const Entry& entry, Delta& delta) const {
+    const uint8_t* in = m_arena.data() + entry.offset;
+    getPairs(in, delta.values);
+    getPairs(in, delta.spaces[0]);
+    getPairs(in, delta.spaces[1]);
+    Q_ASSERT(in == m_arena.data() + entry.offset + entry.size);
+}
+
+void CheckpointJournal::encode(const Delta& delta, Entry& entry, std::vector<uint8_t>& arena) {
+    entry.offset = arena.size();
+    putPairs(arena, delta.values);
+    putPairs(arena, delta.spaces[0]);
+    putPairs(arena, delta.spaces[1]);
+    entry.size = arena.size() - entry.offset;
+}
+
+void CheckpointJournal::apply(const Delta& delta) {
+    for (const auto& [index, value] : delta.values) {
+        Q_ASSERT(index < m_values.size());
+        m_values[index] ^= value;
+    }
+    for (unsigned i = 0; i < 2; i++) {
+        for (const auto& [key, value] : delta.spaces[i]) {
+            auto& page = m_spaces[i].pages[static_cast<uint32_t>(key / s_recordWords)];
+            if (page.empty()) {
+                page.assign(s_recordSize, 0);
+            }
+            uint8_t* word = page.data() + (key % s_recordWords) * 4;
+            uint32_t current;
+            std::memcpy(&current, word, 4);
+            current ^= static_cast<uint32_t>(value);
+            std::memcpy(word, &current, 4);
+        }
+    }
+}
+
+void CheckpointJournal::writeSpace(const AddressSpace& space, SparseArray& memory) {
+    // Bytes populated after the checkpoint cannot be removed from the address space, and are cleared instead
+    std::vector<uint32_t> cleared;
+    for (const auto& entry : memory) {
+        const auto address = static_cast<uint32_t>(entry.first);
+        const auto page = space.pages.find(address >> s_pageBits);
+        const uint32_t offset = address & (s_pageSize - 1);
+        if (page == space.pages.end() || !(page->second[offset / 8] & (1 << (offset % 8)))) {
+            cleared.push_back(address);
+        }
+    }
+    for (const uint32_t address : cleared) {
+        memory.writeMem(address, 0, 1);
+    }
+
+    std::vector<SimulationSnapshot::Page> pages;
+    pages.reserve(space.pages.size());
+    for (const auto& [index, page] : space.pages) {
+        pages.push_back({index << s_pageBits, page.data(), page.data() + s_pageSize / 8});
+    }
+    SimulationSnapshot::writePages(pages, memory);
+}
+
+void CheckpointJournal::restore(long long cycle, RipesProcessor& processor) {
+    const auto it = m_entries.find(cycle);
+    Q_ASSERT(it != m_entries.end());
+
+    const auto later = std::next(it);
+    if (later != m_entries.end()) {
+        Delta delta;
+        for (auto entry = later; entry != m_entries.end(); ++entry) {
+            decode(entry->second, delta);
+        }
+        apply(delta);
+        // Records are stored in the order of their cycles
+        m_arena.resize(later->second.offset);
+        m_entries.erase(later, m_entries.end());
+    }
+
+    writeSpace(m_spaces[0], processor.getArchRegisters());
+    writeSpace(m_spaces[1], processor.getMemory());
+    copyCounters(it->second.checkpoint, m_scratch);
+    m_scratch.journaled = true;
+    m_scratch.registerValues.assign(m_values.begin(), m_values.begin() + m_registerCount);
+    m_scratch.processorState.assign(m_values.begin() + m_registerCount, m_values.end());
+    processor.restoreCheckpoint(m_scratch);
+}
+
+void CheckpointJournal::discard(const std::function<bool(long long)>& predicate) {
+    // The deltas of discarded checkpoints are merged into the next remaining checkpoint, and the arena is compacted
+    std::vector<uint8_t> arena;
+    arena.reserve(m_arena.size());
+    Delta pending;
+    bool hasPending = false;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (predicate(it->first)) {
+            decode(it->second, pending);
+            hasPending = true;
+            it = m_entries.erase(it);
+            continue;
+        }
+        if (hasPending) {
+            decode(it->second, pending);
+            encode(pending, it->second, arena);
+            pending = Delta();
+            hasPending = false;
+        } else {
+            const size_t offset = arena.size();
+            arena.insert(arena.end(), m_arena.begin() + it->second.offset,
+                         m_arena.begin() + it->second.offset + it->second.size);
+            it->second.offset = offset;
+        }
+        ++it;
+    }
+    m_arena = std::move(arena);
+
+    if (m_entries.empty()) {
+        clear();
+    } else if (hasPending) {
+        // The latest checkpoint was discarded; the state is returned to the latest remaining checkpoint
+        apply(pending);
+    }
+}
+
+void CheckpointJournal::clear() {
+    m_entries.clear();
+    m_arena.clear();
+    m_arena.shrink_to_fit();
+    m_values.clear();
+    m_registerCount = 0;
+    for (auto& space : m_spaces) {
+        space.pages.clear();
+        space.scratch.clear();
+    }
+}
+
+long long CheckpointJournal::latestAtOrBefore(long long cycle) const {
+    auto it = m_entries.upper_bound(cycle);
+    return it == m_entries.begin() ? -1 : std::prev(it)->first;
+}
+
+size_t CheckpointJournal::bytes() const {
+    size_t bytes = m_arena.capacity() + m_values.capacity() * sizeof(uint64_t) + m_entries.size() * sizeof(Entry);
+    for (const auto& space : m_spaces) {
+        bytes += (space.pages.size() + space.scratch.size()) * s_recordSize;
+    }
+    return bytes;
+}
+
+}  // namespace Ripes
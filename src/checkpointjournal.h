@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "processors/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CheckpointJournal class
+ * The checkpoints of a processor, of which only the latest is kept in full. Every checkpoint is recorded as its
+ * difference to the preceding checkpoint: the registers of the design, the processor state, and the words of the
+ * architectural registers and memory which changed, as varint encoded XOR deltas in a single record of an arena. XOR
+ * deltas are their own inverse and may be applied in any order, such that a checkpoint is restored by applying the
+ * deltas of all later checkpoints to the latest, and discarding a checkpoint merges its delta into the next.
+ */
+class CheckpointJournal {
+public:
+    /// Records the current state of @p processor, whose cycle must follow those of all recorded checkpoints.
+    void record(vsrtl::core::RipesProcessor& processor);
+
+    /**
+     * @brief restore
+     * Restores @p processor to the checkpoint recorded in @p cycle, and discards all later checkpoints. Bytes of the
+     * address spaces which were first populated after the checkpoint remain populated, holding zero.
+     */
+    void restore(long long cycle, vsrtl::core::RipesProcessor& processor);
+
+    /// Discards the checkpoints of all cycles for which @p predicate holds
+    void discard(const std::function<bool(long long)>& predicate);
+    void clear();
+
+    bool contains(long long cycle) const { return m_entries.count(cycle) != 0; }
+    /// @returns the cycle of the latest checkpoint recorded no later than @p cycle, or -1 if there is none
+    long long latestAtOrBefore(long long cycle) const;
+    /// @returns the cycle of the latest checkpoint, or -1 if there is none
+    long long latest() const { return m_entries.empty() ? -1 : m_entries.rbegin()->first; }
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+    /// @returns the number of bytes of memory held by the journal
+    size_t bytes() const;
+
+private:
+    static constexpr unsigned s_pageBits = 12;
+    static constexpr unsigned s_pageSize = 1u << s_pageBits;
+    /// A page is kept as the bitmap of its populated bytes followed by its bytes, and diffed as 32-bit words
+    static constexpr unsigned s_recordSize = s_pageSize / 8 + s_pageSize;
+    static constexpr unsigned s_recordWords = s_recordSize / 4;
+
+    using Pages = std::map<uint32_t, std::vector<uint8_t>>;
+
+    struct AddressSpace {
+        /// Contents at the latest checkpoint
+        Pages pages;
+        /// Contents being recorded, kept allocated across checkpoints
+        Pages scratch;
+    };
+
+    struct Entry {
+        /// Counters and statistics of the checkpoint; the values of its registers and state are held by the deltas
+        vsrtl::core::ProcessorCheckpoint checkpoint;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    /// A decoded delta; XOR values indexed by value index, and by word index within each address space
+    struct Delta {
+        std::map<uint64_t, uint64_t> values;
+        std::map<uint64_t, uint64_t> spaces[2];
+    };
+
+    void encodeValues(const vsrtl::core::ProcessorCheckpoint& checkpoint);
+    void encodeSpace(const vsrtl::core::SparseArray& memory, AddressSpace& space);
+    /// XORs the delta recorded for @p entry into @p delta
+    void decode(const Entry& entry, Delta& delta) const;
+    /// Appends @p delta to @p arena as the record of @p entry
+    static void encode(const Delta& delta, Entry& entry, std::vector<uint8_t>& arena);
+    /// XORs @p delta into the latest checkpoint
+    void apply(const Delta& delta);
+    static void writeSpace(const AddressSpace& space, vsrtl::core::SparseArray& memory);
+
+    std::map<long long, Entry> m_entries;
+    std::vector<uint8_t> m_arena;
+
+    /// Register values followed by the processor state, at the latest checkpoint
+    std::vector<uint64_t> m_values;
+    size_t m_registerCount = 0;
+    AddressSpace m_spaces[2];
+
+    vsrtl::core::ProcessorCheckpoint m_scratch;
+    std::vector<std::pair<uint64_t, uint64_t>> m_pairs;
+};
+
+}  // namespace Ripes
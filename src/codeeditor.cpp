@@ -3,6 +3,7 @@
 
 #include <QAction>
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QLinearGradient>
 #include <QMenu>
 #include <QMessageBox>
@@ -192,8 +193,12 @@ void CodeEditor::setupSyntaxHighlighter() {
     // The highlighting is reset upon line count changes, to detect label invalidation
     connect(this->document(), &QTextDocument::cursorPositionChanged, m_highlighter,
             &SyntaxHighlighter::invalidateLabels);
+    connect(m_highlighter, &SyntaxHighlighter::labelsInvalidated, this, &CodeEditor::rehighlightIncrementally);
+    m_highlightTimer.setInterval(0);
+    m_highlightTimer.setSingleShot(true);
+    connect(&m_highlightTimer, &QTimer::timeout, this, &CodeEditor::highlightSlice);
     connect(this->document(), &QTextDocument::blockCountChanged, [=] {
-        m_highlighter->clearAndRehighlight();
+        rehighlightIncrementally();
         auto errors = m_tooltipForLine;
         for (const auto& e : errors.toStdMap()) {
             // Remove any error tooltip for lines which have been deleted
@@ -204,4 +209,51 @@ void CodeEditor::setupSyntaxHighlighter() {
     });
 }
 
+void CodeEditor::setSourceText(const QString& text) {
+    m_highlighter->setSuspended(true);
+    setPlainText(text);
+    m_highlighter->setSuspended(false);
+    rehighlightIncrementally();
+}
+
+void CodeEditor::rehighlightIncrementally() {
+    if (m_highlighter->isSuspended()) {
+        return;
+    }
+    m_highlighter->reset();
+
+    // Visible blocks are highlighted immediately
+    const int viewportHeight = viewport()->height();
+    for (QTextBlock block = firstVisibleBlock();
+         block.isValid() && blockBoundingGeometry(block).translated(contentOffset()).top() <= viewportHeight;
+         block = block.next()) {
+        m_highlighter->rehighlightBlock(block);
+    }
+
+    // The remainder of the document is highlighted in slices. The visible blocks are revisited, such that labels are
+    // recorded in document order. Small documents are completed by the first slice, before any repaint occurs.
+    m_nextHighlightBlock = document()->begin();
+    highlightSlice();
+}
+
+void CodeEditor::highlightSlice() {
+    constexpr qint64 sliceDuration = 10;  // ms
+    QElapsedTimer timer;
+    timer.start();
+    while (m_nextHighlightBlock.isValid() && !timer.hasExpired(sliceDuration)) {
+        m_highlighter->rehighlightBlock(m_nextHighlightBlock);
+        m_nextHighlightBlock = m_nextHighlightBlock.next();
+    }
+
+    if (m_nextHighlightBlock.isValid()) {
+        m_highlightTimer.start();
+        return;
+    }
+
+    // All labels have been recorded; rows using labels declared after their usage may now be validated
+    m_highlighter->rehighlightLabelUsers();
+    // Assembly is deferred while highlighting is pending, see syntaxAccepted()
+    m_changeTimer.start();
+}
+
 }  // namespace Ripes
@@ -3,6 +3,7 @@
 #include <QApplication>
 #include <QPlainTextEdit>
 #include <QScrollBar>
+#include <QTextBlock>
 #include <QTimer>
 
 #include "assembler.h"
@@ -27,11 +28,20 @@ public:
     void setupSyntaxHighlighter();
     void setupChangedTimer();
     void reset() {
+        m_highlightTimer.stop();
+        m_nextHighlightBlock = QTextBlock();
         m_highlighter->reset();
         m_tooltipForLine.clear();
         clear();
     }
-    bool syntaxAccepted() const { return m_tooltipForLine.isEmpty(); }
+    /**
+     * @brief setSourceText
+     * Replaces the contents of the editor without highlighting the new text synchronously; the text is highlighted
+     * incrementally, starting with the visible blocks.
+     */
+    void setSourceText(const QString& text);
+    /// Syntax is only accepted once the entire document has been checked
+    bool syntaxAccepted() const { return !m_nextHighlightBlock.isValid() && m_tooltipForLine.isEmpty(); }
 
 signals:
     void textChanged();
@@ -45,6 +55,8 @@ private slots:
     void highlightCurrentLine();
     void updateSidebar(const QRect&, int);
     void updateTooltip(int line, QString tip);
+    void rehighlightIncrementally();
+    void highlightSlice();
 
 private:
     SyntaxHighlighter* m_highlighter;
@@ -63,6 +75,11 @@ private:
     QTimer m_fontTimer;
     QTimer m_changeTimer;
 
+    // Blocks outside of the viewport are highlighted in slices of limited duration, each time the event loop is idle.
+    // m_nextHighlightBlock is the next block to be highlighted, and is invalid when no highlighting is pending.
+    QTimer m_highlightTimer;
+    QTextBlock m_nextHighlightBlock;
+
     bool eventFilter(QObject* observed, QEvent* event) override;
 };
 
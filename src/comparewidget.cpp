@@ -0,0 +1,187 @@
+#include "comparewidget.h"
+#include "ui_comparewidget.h"
+
+#include <QClipboard>
+#include <QHeaderView>
+#include <QtConcurrent/QtConcurrent>
+
+#include "cachesim/cachesim.h"
+
+namespace Ripes {
+
+namespace {
+/// Minimum interval between the updates of the row of a running simulation
+constexpr qint64 s_updateIntervalMs = 100;
+
+QString percentage(double fraction) {
+    return QString::number(fraction * 100, 'f', 2) + " %";
+}
+}  // namespace
+
+CompareWidget::CompareWidget(const std::vector<ProcessorHandler::ReportedCache>& caches, QWidget* parent)
+    : QDialog(parent), m_ui(new Ui::CompareWidget) {
+    m_ui->setupUi(this);
+    m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
+
+    // Headers in the order of Column
+    const QStringList headers = {"Processor",
+                                 "Status",
+                                 "Cycles",
+                                 "Instructions",
+                                 "CPI",
+                                 "Load-use stalls",
+                                 "Control flushes",
+                                 "Mul/div stalls",
+                                 "Mispredictions",
+                                 "D$ hit rate",
+                                 "I$ hit rate",
+                                 "L2 hit rate",
+                                 "Wall time"};
+    m_ui->table->setColumnCount(NColumns);
+    m_ui->table->setHorizontalHeaderLabels(headers);
+    m_ui->table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_ui->table->verticalHeader()->setVisible(false);
+    m_ui->table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    auto* handler = ProcessorHandler::get();
+    if (!handler->getProgram()) {
+        m_ui->summary->setText("No program is loaded");
+        m_ui->stop->setEnabled(false);
+        return;
+    }
+
+    // All simulations share a copy of the current program, and simulate the caches as configured in the GUI. The
+    // first level caches are simulated with the configuration of the data cache.
+    HeadlessOptions options;
+    options.program = std::make_shared<const Program>(*handler->getProgram());
+    options.unitLatencies = handler->getFunctionalUnitLatencies();
+    for (const auto& [name, cache] : caches) {
+        if (name == "dcache") {
+            options.dataCache = true;
+            options.cacheLines = cache->getLineBits();
+            options.cacheWays = cache->getWaysBits();
+            options.cacheBlocks = cache->getBlockBits();
+            options.hitLatencies[0] = cache->getHitLatency();
+            options.memoryLatency = cache->getMemoryLatency();
+        } else if (name == "icache") {
+            options.instrCache = true;
+        } else if (name == "l2cache") {
+            options.l2Cache = {true, cache->getLineBits(), cache->getWaysBits(), cache->getBlockBits()};
+            options.hitLatencies[1] = cache->getHitLatency();
+            options.memoryLatency = cache->getMemoryLatency();
+        }
+    }
+
+    const auto& processors = ProcessorRegistry::getAvailableProcessors();
+    m_ui->table->setRowCount(static_cast<int>(processors.size()));
+    m_pool.setMaxThreadCount(static_cast<int>(processors.size()));
+    m_timer.start();
+    int row = 0;
+    for (const auto& [id, description] : processors) {
+        setCell(row, Processor, description.name);
+        m_ui->table->item(row, Processor)->setToolTip(description.description);
+        setCell(row, Status, "Running");
+
+        HeadlessOptions job = options;
+        job.processor = id;
+        m_running++;
+        QtConcurrent::run(&m_pool, [this, row, job] {
+            QElapsedTimer updateTimer;
+            updateTimer.start();
+            const auto progress = [&](const HeadlessResult& result) {
+                if (updateTimer.elapsed() >= s_updateIntervalMs) {
+                    updateTimer.restart();
+                    QMetaObject::invokeMethod(
+                        this, [this, row, result] { showResult(row, result, "Running"); }, Qt::QueuedConnection);
+                }
+                return !m_stopping.load(std::memory_order_relaxed);
+            };
+            // Output of the program is discarded
+            const HeadlessResult result = simulate(job, [](const QString&) {}, progress);
+            QMetaObject::invokeMethod(
+                this, [this, row, result] { jobFinished(row, result); }, Qt::QueuedConnection);
+        });
+        row++;
+    }
+    m_ui->summary->setText(QString("Simulating %1 processors").arg(processors.size()));
+}
+
+CompareWidget::~CompareWidget() {
+    m_stopping = true;
+    m_pool.waitForDone();
+    delete m_ui;
+}
+
+void CompareWidget::setCell(int row, Column column, const QString& text) {
+    if (auto* item = m_ui->table->item(row, column)) {
+        item->setText(text);
+        return;
+    }
+    auto* item = new QTableWidgetItem(text);
+    if (column != Processor && column != Status) {
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    m_ui->table->setItem(row, column, item);
+}
+
+void CompareWidget::showResult(int row, const HeadlessResult& result, const QString& status) {
+    setCell(row, Status, status);
+    setCell(row, Cycles, QString::number(result.cycles));
+    setCell(row, Instructions, QString::number(result.instructionsRetired));
+    setCell(row, CPI,
+            result.instructionsRetired == 0
+                ? "-"
+                : QString::number(static_cast<double>(result.cycles) / result.instructionsRetired, 'f', 3));
+    setCell(row, LoadUseStalls, result.hazards ? QString::number(result.hazards->loadUseStallCycles) : "-");
+    setCell(row, ControlFlowFlushes, result.hazards ? QString::number(result.hazards->controlFlowFlushes) : "-");
+    setCell(row, MulDivStalls,
+            result.functionalUnits ? QString::number(result.functionalUnits->dependencyStallCycles +
+                                                     result.functionalUnits->structuralStallCycles)
+                                   : "-");
+    setCell(row, Mispredictions,
+            result.branchPrediction ? QString("%1 / %2")
+                                          .arg(result.branchPrediction->mispredictions)
+                                          .arg(result.branchPrediction->predictions)
+                                    : "-");
+    setCell(row, DataCacheHitRate, result.dataCache.enabled ? percentage(result.dataCache.hitRate) : "-");
+    setCell(row, InstrCacheHitRate, result.instrCache.enabled ? percentage(result.instrCache.hitRate) : "-");
+    setCell(row, L2CacheHitRate, result.l2Cache.enabled ? percentage(result.l2Cache.hitRate) : "-");
+    setCell(row, WallTime, QString::number(result.wallTimeMs) + " ms");
+}
+
+void CompareWidget::jobFinished(int row, const HeadlessResult& result) {
+    if (!result.error.isEmpty()) {
+        setCell(row, Status, result.error);
+    } else {
+        showResult(row, result, result.finished ? "Finished" : "Stopped");
+    }
+    if (--m_running == 0) {
+        m_ui->stop->setEnabled(false);
+        m_ui->summary->setText(QString("Completed in %1 ms").arg(m_timer.elapsed()));
+    }
+}
+
+void CompareWidget::on_stop_clicked() {
+    m_stopping = true;
+    m_ui->stop->setEnabled(false);
+}
+
+void CompareWidget::on_copy_clicked() {
+    // Copy the table to the clipboard, including headers
+    QString textualRepr;
+    for (int j = 0; j < m_ui->table->columnCount(); j++) {
+        textualRepr.append(m_ui->table->horizontalHeaderItem(j)->text());
+        textualRepr.append('\t');
+    }
+    textualRepr.append('\n');
+    for (int i = 0; i < m_ui->table->rowCount(); i++) {
+        for (int j = 0; j < m_ui->table->columnCount(); j++) {
+            const auto* item = m_ui->table->item(i, j);
+            textualRepr.append(item ? item->text() : QString());
+            textualRepr.append('\t');
+        }
+        textualRepr.append('\n');
+    }
+    QApplication::clipboard()->setText(textualRepr);
+}
+}  // namespace Ripes
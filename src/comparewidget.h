@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+#include <atomic>
+#include <vector>
+
+#include "headless.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+namespace Ui {
+class CompareWidget;
+}
+
+/**
+ * @brief The CompareWidget class
+ * Side-by-side comparison of all available processors on the program loaded by the processor handler. Each processor
+ * simulates the program concurrently on a worker thread of its own, within a simulation context independent of the
+ * current processor (see simulate()), and the table is updated with the statistics of each simulation as it
+ * progresses. Simulations still running are stopped once the widget is closed.
+ */
+class CompareWidget : public QDialog {
+    Q_OBJECT
+
+public:
+    /// @p caches are the caches of the GUI (see MemoryTab::reportedCaches), whose configuration is simulated
+    CompareWidget(const std::vector<ProcessorHandler::ReportedCache>& caches, QWidget* parent = nullptr);
+    ~CompareWidget() override;
+
+private slots:
+    void on_copy_clicked();
+    void on_stop_clicked();
+
+private:
+    enum Column {
+        Processor,
+        Status,
+        Cycles,
+        Instructions,
+        CPI,
+        LoadUseStalls,
+        ControlFlowFlushes,
+        MulDivStalls,
+        Mispredictions,
+        DataCacheHitRate,
+        InstrCacheHitRate,
+        L2CacheHitRate,
+        WallTime,
+        NColumns
+    };
+
+    /// Presents the statistics of @p result in @p row
+    void showResult(int row, const HeadlessResult& result, const QString& status);
+    void jobFinished(int row, const HeadlessResult& result);
+    void setCell(int row, Column column, const QString& text);
+
+    Ui::CompareWidget* m_ui = nullptr;
+    QThreadPool m_pool;
+    std::atomic<bool> m_stopping = false;
+    unsigned m_running = 0;
+    QElapsedTimer m_timer;
+};
+}  // namespace Ripes
@@ -0,0 +1,131 @@
+#include "cycleprofiler.h"
+
+#include <algorithm>
+#include <map>
+
+#include "processors/ripesprocessor.h"
+
+namespace Ripes {
+
+void CycleProfiler::setTextSection(uint32_t start, uint32_t end) {
+    m_textStart = start;
+    m_entries.assign((end - start + 3) / 4, Entry());
+}
+
+void CycleProfiler::clear(const vsrtl::core::RipesProcessor* proc) {
+    std::fill(m_entries.begin(), m_entries.end(), Entry());
+    m_startCycle = proc->getCycleCount();
+    sync(proc);
+}
+
+void CycleProfiler::sync(const vsrtl::core::RipesProcessor* proc) {
+    m_cycle = proc->getCycleCount();
+    m_instructionsRetired = proc->getInstructionsRetired();
+    capture(proc);
+}
+
+void CycleProfiler::capture(const vsrtl::core::RipesProcessor* proc) {
+    m_retiringPcs.clear();
+    for (unsigned i = 1; i <= proc->retireWidth(); i++) {
+        m_retiringPcs.push_back(proc->stageInfo(proc->stageCount() - i).pc);
+    }
+
+    // The last stage carries the oldest instruction
+    m_hasOldest = false;
+    for (int stage = static_cast<int>(proc->stageCount()) - 1; stage >= 0; stage--) {
+        const auto info = proc->stageInfo(stage);
+        if (info.stage_valid && info.state == StageInfo::State::None) {
+            m_hasOldest = true;
+            m_oldestPc = info.pc;
+            break;
+        }
+    }
+}
+
+void CycleProfiler::clock(const vsrtl::core::RipesProcessor* proc) {
+    const long long retiredInCycle = proc->getInstructionsRetired() - m_instructionsRetired;
+    if (proc->getCycleCount() == m_cycle + 1) {
+        if (retiredInCycle == 0) {
+            if (Entry* entry = m_hasOldest ? entryAt(m_oldestPc) : nullptr) {
+                entry->stallCycles++;
+            }
+        } else if (retiredInCycle > 0 && retiredInCycle <= static_cast<long long>(m_retiringPcs.size())) {
+            for (long long i = 0; i < retiredInCycle; i++) {
+                retire(m_retiringPcs.at(i));
+            }
+        }
+    }
+    sync(proc);
+}
+
+void CycleProfiler::reverse(const vsrtl::core::RipesProcessor* proc) {
+    // The processor is back in the state it was in at the start of the reversed cycle, which the cycle was attributed
+    // from
+    const long long retiredInCycle = m_instructionsRetired - proc->getInstructionsRetired();
+    const bool reversedCycle = proc->getCycleCount() + 1 == m_cycle && proc->getCycleCount() >= m_startCycle;
+    sync(proc);
+    if (!reversedCycle) {
+        return;
+    }
+    if (retiredInCycle == 0) {
+        if (Entry* entry = m_hasOldest ? entryAt(m_oldestPc) : nullptr) {
+            entry->stallCycles--;
+        }
+    } else if (retiredInCycle > 0 && retiredInCycle <= static_cast<long long>(m_retiringPcs.size())) {
+        for (long long i = 0; i < retiredInCycle; i++) {
+            if (Entry* entry = entryAt(m_retiringPcs.at(i))) {
+                entry->retired--;
+            }
+            if (m_instructionMix) {
+                m_instructionMix->unretire(m_retiringPcs.at(i));
+            }
+        }
+    }
+}
+
+long long CycleProfiler::maxCost() const {
+    long long max = 0;
+    for (const auto& entry : m_entries) {
+        max = std::max(max, entry.cost());
+    }
+    return max;
+}
+
+long long CycleProfiler::totalCost() const {
+    long long total = 0;
+    for (const auto& entry : m_entries) {
+        total += entry.cost();
+    }
+    return total;
+}
+
+std::vector<CycleProfiler::HotSpot> CycleProfiler::symbolHotSpots(const Program& program) const {
+    std::map<uint32_t, HotSpot> hotSpots;
+    for (unsigned i = 0; i < m_entries.size(); i++) {
+        const Entry& entry = m_entries[i];
+        if (entry.cost() == 0) {
+            continue;
+        }
+        const uint32_t address = m_textStart + i * 4;
+        const auto* symbol = program.getSymbolAt(address);
+        const bool inSymbol = symbol && symbol->first >= m_textStart;
+        const uint32_t key = inSymbol ? static_cast<uint32_t>(symbol->first) : m_textStart;
+        auto it = hotSpots.find(key);
+        if (it == hotSpots.end()) {
+            HotSpot hotSpot;
+            hotSpot.name = inSymbol ? symbol->second : QString(TEXT_SECTION_NAME);
+            hotSpot.address = address;
+            it = hotSpots.emplace(key, hotSpot).first;
+        }
+        it->second.entry.retired += entry.retired;
+        it->second.entry.stallCycles += entry.stallCycles;
+    }
+
+    std::vector<HotSpot> result;
+    for (auto& hotSpot : hotSpots) {
+        result.push_back(hotSpot.second);
+    }
+    return result;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+#include "callgraphprofiler.h"
+#include "instructionmix.h"
+#include "loopprofiler.h"
+#include "program.h"
+
+namespace vsrtl {
+namespace core {
+class RipesProcessor;
+}
+}  // namespace vsrtl
+
+namespace Ripes {
+
+/**
+ * @brief The CycleProfiler class
+ * Attributes the instructions retired and the cycles stalled by a processor to the instructions of the text section of
+ * the loaded program. Each cycle in which no instruction retires is a stall cycle of the oldest instruction in flight
+ * at the start of the cycle; the instruction holding up retirement. Counts are kept in a flat array over the text
+ * section, indexed by (address - text start) / 4, such that recording a cycle takes no lookups beyond the stage
+ * information of the processor.
+ */
+class CycleProfiler {
+public:
+    struct Entry {
+        long long retired = 0;
+        long long stallCycles = 0;
+        long long cost() const { return retired + stallCycles; }
+    };
+
+    /**
+     * @brief The HotSpot struct
+     * Aggregated counts of a group of instructions; a symbol or an instruction class. @p address is the lowest address
+     * of the group which has been profiled.
+     */
+    struct HotSpot {
+        QString name;
+        uint32_t address = 0;
+        Entry entry;
+    };
+
+    /**
+     * @brief setTextSection
+     * Profiles the text section spanning [@p start; @p end), discarding all counts.
+     */
+    void setTextSection(uint32_t start, uint32_t end);
+
+    /**
+     * @brief clear
+     * Discards all counts, and synchronizes the profiler with @p proc, from whose current cycle profiling continues.
+     */
+    void clear(const vsrtl::core::RipesProcessor* proc);
+
+    /**
+     * @brief sync
+     * Resynchronizes the profiler with @p proc, after its state was changed by other means than clocking or reversing
+     * it, retaining the counts.
+     */
+    void sync(const vsrtl::core::RipesProcessor* proc);
+
+    /**
+     * @brief clock/reverse
+     * Records the cycle which @p proc has just been clocked through, or removes the cycle which @p proc has just been
+     * reversed past. Cycles reversed past the cycle profiling started at are ignored.
+     */
+    void clock(const vsrtl::core::RipesProcessor* proc);
+    void reverse(const vsrtl::core::RipesProcessor* proc);
+
+    /// Records the retirement of the instruction at @p pc by a functional model, which does not stall
+    void retire(uint32_t pc) {
+        if (Entry* entry = entryAt(pc)) {
+            entry->retired++;
+        }
+        if (m_callGraph) {
+            m_callGraph->retire(pc);
+        }
+        if (m_loops) {
+            m_loops->retire(pc);
+        }
+        if (m_instructionMix) {
+            m_instructionMix->retire(pc);
+        }
+    }
+
+    /// Forwards all retired instructions, in the order of retirement, to @p callGraph
+    void setCallGraph(CallGraphProfiler* callGraph) { m_callGraph = callGraph; }
+    /// Forwards all retired instructions, in the order of retirement, to @p loops
+    void setLoopProfiler(LoopProfiler* loops) { m_loops = loops; }
+    /// Forwards all retired instructions to @p mix, and removes those reversed past from it
+    void setInstructionMix(InstructionMix* mix) { m_instructionMix = mix; }
+
+    /// @returns the counts of the instruction at @p address, or nullptr if the address is outside the text section
+    const Entry* at(uint32_t address) const {
+        const size_t index = indexOf(address);
+        return index < m_entries.size() ? &m_entries[index] : nullptr;
+    }
+    const std::vector<Entry>& entries() const { return m_entries; }
+    uint32_t getTextStart() const { return m_textStart; }
+    long long getStartCycle() const { return m_startCycle; }
+    long long maxCost() const;
+    long long totalCost() const;
+
+    /**
+     * @brief symbolHotSpots
+     * @returns the counts of the profiled instructions rolled up to the symbols of @p program which they follow, sorted
+     * by address. Instructions preceding all symbols are attributed to the text section.
+     */
+    std::vector<HotSpot> symbolHotSpots(const Program& program) const;
+
+private:
+    /// @returns the index of @p address in m_entries, or the size of m_entries if outside the text section
+    size_t indexOf(uint32_t address) const {
+        const uint32_t offset = address - m_textStart;
+        return (offset & 0b11) == 0 && (offset >> 2) < m_entries.size() ? offset >> 2 : m_entries.size();
+    }
+    Entry* entryAt(uint32_t address) {
+        const size_t index = indexOf(address);
+        return index < m_entries.size() ? &m_entries[index] : nullptr;
+    }
+
+    /// Records the retiring and oldest in-flight instructions of @p proc at the start of its current cycle
+    void capture(const vsrtl::core::RipesProcessor* proc);
+
+    std::vector<Entry> m_entries;
+    uint32_t m_textStart = 0;
+    long long m_startCycle = 0;
+
+    long long m_cycle = 0;
+    long long m_instructionsRetired = 0;
+    std::vector<uint32_t> m_retiringPcs;
+    bool m_hasOldest = false;
+    uint32_t m_oldestPc = 0;
+
+    CallGraphProfiler* m_callGraph = nullptr;
+    LoopProfiler* m_loops = nullptr;
+    InstructionMix* m_instructionMix = nullptr;
+};
+
+}  // namespace Ripes
@@ -81,6 +81,7 @@ enum {
     OP = 0b0110011,
     ECALL = 0b1110011,
     AUIPC = 0b0010111,
+    AMO = 0b0101111,
     INVALID = 0b0
 };
 }
@@ -128,13 +129,30 @@ const static QStringList RegNames = QStringList() << "x0"
                                                   << "x30"
                                                   << "x31";
 
+namespace {
+QMap<QString, uint32_t> initCSRNames() {
+    // Read-only counters of the Zicntr and Zihpm extensions, and the machine-mode counters which they shadow
+    QMap<QString, uint32_t> names{
+        {"cycle", 0xC00}, {"time", 0xC01}, {"instret", 0xC02}, {"mcycle", 0xB00}, {"minstret", 0xB02}};
+    for (uint32_t i = 3; i < 32; i++) {
+        names.insert(QString("hpmcounter%1").arg(i), 0xC00 + i);
+        names.insert(QString("mhpmcounter%1").arg(i), 0xB00 + i);
+    }
+    // Upper halves of the 64-bit counters
+    for (const auto& name : names.keys()) {
+        names.insert(name + "h", names.value(name) + 0x80);
+    }
+    names.insert("mhartid", 0xF14);
+    return names;
+}
+}  // namespace
+
+const static QMap<QString, uint32_t> CSRNames = initCSRNames();
+
 const static std::map<int, QString> cacheSizes = {{32, QString("32 Bytes")},   {64, QString("64 Bytes")},
                                                   {128, QString("128 Bytes")}, {256, {QString("256 Bytes")}},
                                                   {512, QString("512 Bytes")}, {1024, QString("1024 Bytes")}};
 
-// splits only at tab characters and parentheses when they include a register name
-const static auto splitter = QRegularExpression(
-    R"(\t|\((?=x(?:[1-2]\d|3[0-1]|\d)|t[0-6]|a[0-7]|s(?:1[0-1]|\d)|[sgt]p|zero)|(?:x(?:[1-2]\d|3[0-1]|\d)|t[0-6]|a[0-7]|s(?:1[0-1]|\d)|[sgt]p|zero)\K\))");
 }  // namespace Ripes
 
 Q_DECLARE_METATYPE(Ripes::displayTypeN)
@@ -0,0 +1,98 @@
+#include "deviceswidget.h"
+#include "ui_deviceswidget.h"
+
+#include <QCheckBox>
+#include <QLabel>
+
+#include "peripherals.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+namespace {
+constexpr int s_ledSize = 16;
+
+QString ledStyle(bool lit) {
+    return QString("border-radius: %1px; border: 1px solid gray; background-color: %2;")
+        .arg(s_ledSize / 2)
+        .arg(lit ? "red" : "darkgray");
+}
+}  // namespace
+
+DevicesWidget::DevicesWidget(QWidget* parent) : QDialog(parent), m_ui(new Ui::DevicesWidget) {
+    m_ui->setupUi(this);
+
+    for (unsigned i = 0; i < LedPanelDevice::s_count; i++) {
+        // Bit 0 is the rightmost LED and switch
+        const int column = static_cast<int>(LedPanelDevice::s_count - 1 - i);
+        auto* led = new QLabel(this);
+        led->setFixedSize(s_ledSize, s_ledSize);
+        led->setStyleSheet(ledStyle(false));
+        m_ui->panelLayout->addWidget(led, 0, column, Qt::AlignCenter);
+        m_leds.push_back(led);
+
+        auto* sw = new QCheckBox(this);
+        sw->setToolTip("Switch " + QString::number(i));
+        connect(sw, &QCheckBox::toggled, this, &DevicesWidget::switchToggled);
+        m_ui->panelLayout->addWidget(sw, 1, column, Qt::AlignCenter);
+        m_switches.push_back(sw);
+    }
+
+    QString addressMap;
+    for (const auto& device : ProcessorHandler::get()->getDevices().devices()) {
+        addressMap += device->name() + ": 0x" + QString::number(device->base(), 16).rightJustified(8, '0') + " - 0x" +
+                      QString::number(device->base() + device->size() - 1, 16).rightJustified(8, '0') + "\n";
+    }
+    m_ui->addressMap->setText(addressMap.trimmed());
+
+    connect(m_ui->uartInput, &QLineEdit::returnPressed, this, &DevicesWidget::on_send_clicked);
+    connect(ProcessorHandler::get(), &ProcessorHandler::devicesChanged, this, &DevicesWidget::updateView);
+}
+
+DevicesWidget::~DevicesWidget() {
+    delete m_ui;
+}
+
+void DevicesWidget::showEvent(QShowEvent* event) {
+    QDialog::showEvent(event);
+    // The devices may have changed arbitrarily while hidden
+    updateView();
+}
+
+void DevicesWidget::updateView() {
+    if (!isVisible()) {
+        return;
+    }
+    auto& devices = ProcessorHandler::get()->getDevices();
+
+    if (const auto* panel = devices.find<LedPanelDevice>()) {
+        const uint32_t leds = panel->leds();
+        for (unsigned i = 0; i < m_leds.size(); i++) {
+            m_leds[i]->setStyleSheet(ledStyle((leds >> i) & 1));
+        }
+    }
+
+    if (const auto* uart = devices.find<UartDevice>()) {
+        m_ui->uartPending->setText(QString::number(uart->pending()) + " bytes pending");
+    }
+}
+
+void DevicesWidget::on_send_clicked() {
+    if (auto* uart = ProcessorHandler::get()->getDevices().find<UartDevice>()) {
+        uart->receive(m_ui->uartInput->text().toUtf8());
+        m_ui->uartInput->clear();
+        updateView();
+    }
+}
+
+void DevicesWidget::switchToggled() {
+    uint32_t switches = 0;
+    for (unsigned i = 0; i < m_switches.size(); i++) {
+        switches |= m_switches[i]->isChecked() ? 1u << i : 0;
+    }
+    if (auto* panel = ProcessorHandler::get()->getDevices().find<LedPanelDevice>()) {
+        panel->setSwitches(switches);
+    }
+}
+
+}  // namespace Ripes
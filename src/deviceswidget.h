@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QDialog>
+
+#include <vector>
+
+QT_FORWARD_DECLARE_CLASS(QCheckBox)
+QT_FORWARD_DECLARE_CLASS(QLabel)
+
+namespace Ripes {
+namespace Ui {
+class DevicesWidget;
+}
+
+/**
+ * @brief The DevicesWidget class
+ * Front panel of the memory mapped devices of the current processor; the LEDs and switches of the LED panel and the
+ * input of the UART. The framebuffer is displayed by the Display tab (see FramebufferTab). The view is updated whenever
+ * the devices change, which is at most once per display frame while running.
+ */
+class DevicesWidget : public QDialog {
+    Q_OBJECT
+
+public:
+    DevicesWidget(QWidget* parent = nullptr);
+    ~DevicesWidget() override;
+
+public slots:
+    /// Updates the view to the current state of the devices. Skipped while the widget is hidden.
+    void updateView();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+
+private slots:
+    void on_send_clicked();
+
+private:
+    void switchToggled();
+
+    Ui::DevicesWidget* m_ui = nullptr;
+    std::vector<QLabel*> m_leds;
+    std::vector<QCheckBox*> m_switches;
+};
+}  // namespace Ripes
@@ -1,20 +1,51 @@
 #include "edittab.h"
 #include "ui_edittab.h"
 
-#include "elfio/elfio.hpp"
-
 #include <QCheckBox>
 #include <QLabel>
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QtConcurrent/QtConcurrent>
 
+#include "assemblycache.h"
 #include "parser.h"
 #include "processorhandler.h"
 #include "program.h"
+#include "programloader.h"
 
 namespace Ripes {
 
+namespace {
+uint programHash(const Program& program) {
+    uint hash = qHash(static_cast<quint64>(program.entryPoint));
+    for (const auto& section : program.sections) {
+        hash ^= qHash(section.name) ^ qHash(static_cast<quint64>(section.address), qHash(section.data)) ^
+                qHash(static_cast<quint64>(section.zeroSize));
+        hash = (hash << 5) | (hash >> 27);
+    }
+    for (const auto& symbol : program.symbols) {
+        hash ^= qHash(static_cast<quint64>(symbol.first), qHash(symbol.second));
+        hash = (hash << 5) | (hash >> 27);
+    }
+    return hash;
+}
+
+bool isSameProgram(const Program& a, const Program& b) {
+    if (a.entryPoint != b.entryPoint || a.symbols != b.symbols || a.sections.size() != b.sections.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.sections.size(); i++) {
+        const auto& sa = a.sections[i];
+        const auto& sb = b.sections[i];
+        if (sa.name != sb.name || sa.address != sb.address || sa.data != sb.data || sa.zeroSize != sb.zeroSize) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
 EditTab::EditTab(QToolBar* toolbar, QWidget* parent) : RipesTab(toolbar, parent), m_ui(new Ui::EditTab) {
     m_ui->setupUi(this);
 
@@ -24,9 +55,9 @@ EditTab::EditTab(QToolBar* toolbar, QWidget* parent) : RipesTab(toolbar, parent)
     // translation is complete
     m_ui->assemblyedit->setupSyntaxHighlighter();
     m_ui->assemblyedit->setupChangedTimer();
-    m_ui->programViewer->setReadOnly(true);
 
     m_assembler = std::make_unique<Assembler>();
+    connect(&m_assemblyWatcher, &QFutureWatcher<AssemblyResult>::finished, this, &EditTab::assemblyFinished);
 
     connect(m_ui->assemblyedit, &CodeEditor::textChanged, this, &EditTab::assemble);
 
@@ -41,6 +72,7 @@ void EditTab::loadFile(const LoadFileParams& fileParams) {
     }
 
     bool success = true;
+    QString error;
     Program loadedProgram;
     switch (fileParams.type) {
         case FileType::Assembly:
@@ -52,14 +84,23 @@ void EditTab::loadFile(const LoadFileParams& fileParams) {
         case FileType::Executable:
             success &= loadElfFile(loadedProgram, file);
             break;
+        case FileType::IntelHex:
+        case FileType::SRecord:
+            success &= loadRecordFile(loadedProgram, file, fileParams.type, error);
+            break;
     }
 
     if (success) {
         m_loadedFile = fileParams;
         m_activeProgram = loadedProgram;
+        m_activeProgramHash = programHash(m_activeProgram);
         emitProgramChanged();
     } else {
-        QMessageBox::warning(this, "Error", "Error: Could not load file " + fileParams.filepath);
+        QString message = "Error: Could not load file " + fileParams.filepath;
+        if (!error.isEmpty()) {
+            message += ": " + error;
+        }
+        QMessageBox::warning(this, "Error", message);
     }
     file.close();
 }
@@ -69,18 +110,34 @@ QString EditTab::getAssemblyText() {
 }
 
 const QByteArray& EditTab::getBinaryData() {
-    return m_assembler->getTextSegment();
+    // The assembler is skipped for cached programs, so the text segment is taken from the assembled program
+    static const QByteArray s_empty;
+    if (!m_editorEnabled) {
+        return s_empty;
+    }
+    const ProgramSection* text = m_activeProgram.getSection(TEXT_SECTION_NAME);
+    return text ? text->data : s_empty;
 }
 
 void EditTab::clearAssemblyEditor() {
+    stopAssembly();
     m_ui->assemblyedit->reset();
     m_assembler->clear();
 }
 
 void EditTab::updateProgramViewerHighlighting() {
-    if (isVisible()) {
-        m_ui->programViewer->updateHighlightedAddresses();
+    if (deferViewUpdate(ProcessorHandler::get()->getCycleCount())) {
+        return;
     }
+    refreshViews();
+}
+
+void EditTab::refreshViews() {
+    m_ui->programViewer->updateHighlightedAddresses();
+}
+
+void EditTab::showAddressRange(uint32_t first, uint32_t last) {
+    m_ui->programViewer->selectAddressRange(first, last);
 }
 
 void EditTab::emitProgramChanged() {
@@ -89,20 +146,77 @@ void EditTab::emitProgramChanged() {
 }
 
 void EditTab::assemble() {
-    if (m_ui->assemblyedit->syntaxAccepted()) {
-        m_assembler->assemble(*m_ui->assemblyedit->document());
-        if (!m_assembler->hasError()) {
-            m_activeProgram = m_assembler->getProgram();
-            emitProgramChanged();
-        } else {
-            QMessageBox err;
-            err.setText("Error during assembling of program");
-            err.exec();
+    if (!m_ui->assemblyedit->syntaxAccepted()) {
+        return;
+    }
+    if (m_assemblyWatcher.isRunning()) {
+        // The running assembly is of an outdated snapshot; it is cancelled, and the document reassembled once the
+        // worker has returned
+        m_cancelAssembly = true;
+        m_assemblyPending = true;
+        return;
+    }
+
+    // The assembler works on a snapshot of the document, such that the document may be edited while assembling
+    const QStringList lines = m_ui->assemblyedit->toPlainText().split('\n');
+    m_cancelAssembly = false;
+    const unsigned generation = m_assemblyGeneration;
+    m_assemblyWatcher.setFuture(QtConcurrent::run([=] {
+        AssemblyResult result;
+        result.generation = generation;
+        const QByteArray key = AssemblyCache::key(lines);
+        if (AssemblyCache::find(key, result.program)) {
+            result.hash = programHash(result.program);
+            return result;
+        }
+        m_assembler->assemble(lines, &m_cancelAssembly);
+        result.cancelled = m_assembler->wasCancelled();
+        result.error = m_assembler->hasError();
+        if (!result.error) {
+            result.program = m_assembler->getProgram();
+            result.hash = programHash(result.program);
+            AssemblyCache::insert(key, result.program);
         }
+        return result;
+    }));
+}
+
+void EditTab::assemblyFinished() {
+    if (m_assemblyPending) {
+        m_assemblyPending = false;
+        assemble();
+        return;
+    }
+
+    const AssemblyResult result = m_assemblyWatcher.result();
+    if (result.cancelled || result.generation != m_assemblyGeneration) {
+        return;
+    }
+    if (result.error) {
+        QMessageBox err;
+        err.setText("Error during assembling of program");
+        err.exec();
+        return;
     }
+    if (result.hash == m_activeProgramHash && isSameProgram(result.program, m_activeProgram)) {
+        // Edits which do not change the assembled program (comments, whitespace) should not reset the processor
+        return;
+    }
+    m_activeProgram = result.program;
+    m_activeProgramHash = result.hash;
+    emitProgramChanged();
+}
+
+void EditTab::stopAssembly() {
+    m_assemblyPending = false;
+    m_cancelAssembly = true;
+    m_assemblyWatcher.waitForFinished();
+    // A finished signal may already be queued; its result is discarded
+    m_assemblyGeneration++;
 }
 
 EditTab::~EditTab() {
+    stopAssembly();
     delete m_ui;
 }
 
@@ -114,12 +228,13 @@ void EditTab::newProgram() {
 
 void EditTab::setAssemblyText(const QString& text) {
     m_ui->assemblyedit->reset();
-    m_ui->assemblyedit->setPlainText(text);
+    m_ui->assemblyedit->setSourceText(text);
 }
 
 void EditTab::enableAssemblyInput() {
     // Clear currently loaded binary/ELF program
     m_activeProgram = Program();
+    m_activeProgramHash = programHash(m_activeProgram);
     m_ui->programViewer->clear();
     enableEditor();
     m_editorEnabled = true;
@@ -148,13 +263,9 @@ void EditTab::on_disassembledViewButton_toggled() {
 }
 
 bool EditTab::loadFlatBinaryFile(Program& program, QFile& file, unsigned long entryPoint, unsigned long loadAt) {
-    ProgramSection section;
-    section.name = TEXT_SECTION_NAME;
-    section.address = loadAt;
-    section.data = file.readAll();
-
-    program.sections.push_back(section);
-    program.entryPoint = entryPoint;
+    if (!Ripes::loadFlatBinaryFile(program, file, entryPoint, loadAt)) {
+        return false;
+    }
 
     m_ui->curInputSrcLabel->setText("Flat binary");
     m_ui->inputSrcPath->setText(file.fileName());
@@ -169,43 +280,12 @@ bool EditTab::loadAssemblyFile(Program&, QFile& file) {
 }
 
 bool EditTab::loadElfFile(Program& program, QFile& file) {
-    ELFIO::elfio reader;
-
     // No file validity checking is performed - it is expected that Loaddialog has done all validity
     // checking.
-    if (!reader.load(file.fileName().toStdString())) {
+    if (!Ripes::loadElfFile(program, file)) {
         assert(false);
     }
 
-    for (const auto& elfSection : reader.sections) {
-        ProgramSection& section = program.sections.emplace_back();
-        section.name = QString::fromStdString(elfSection->get_name());
-        section.address = elfSection->get_address();
-        // QByteArray performs a deep copy of the data when the data array is initialized at construction
-        section.data = QByteArray(elfSection->get_data(), static_cast<int>(elfSection->get_size()));
-
-        if (elfSection->get_type() == SHT_SYMTAB) {
-            // Collect function symbols
-            const ELFIO::symbol_section_accessor symbols(reader, elfSection);
-            for (unsigned int j = 0; j < symbols.get_symbols_num(); ++j) {
-                std::string name;
-                ELFIO::Elf64_Addr value;
-                ELFIO::Elf_Xword size;
-                unsigned char bind;
-                unsigned char type;
-                ELFIO::Elf_Half section_index;
-                unsigned char other;
-                symbols.get_symbol(j, name, value, size, bind, type, section_index, other);
-
-                if (type != STT_FUNC)
-                    continue;
-                program.symbols[value] = QString::fromStdString(name);
-            }
-        }
-    }
-
-    program.entryPoint = reader.get_entry();
-
     m_ui->curInputSrcLabel->setText("Executable (ELF)");
     m_ui->inputSrcPath->setText(file.fileName());
 
@@ -213,4 +293,15 @@ bool EditTab::loadElfFile(Program& program, QFile& file) {
     return true;
 }
 
+bool EditTab::loadRecordFile(Program& program, QFile& file, FileType type, QString& error) {
+    if (!Ripes::loadRecordFile(program, file, type, error)) {
+        return false;
+    }
+
+    m_ui->curInputSrcLabel->setText(type == FileType::IntelHex ? "Intel HEX" : "Motorola S-record");
+    m_ui->inputSrcPath->setText(file.fileName());
+    disableEditor();
+    return true;
+}
+
 }  // namespace Ripes
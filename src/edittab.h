@@ -2,7 +2,9 @@
 
 #include <QByteArray>
 #include <QFile>
+#include <QFutureWatcher>
 #include <QWidget>
+#include <atomic>
 #include <map>
 #include <memory>
 
@@ -19,6 +21,14 @@ class EditTab;
 class Assembler;
 class LoadFileParams;
 
+struct AssemblyResult {
+    bool cancelled = false;
+    bool error = false;
+    Program program;
+    uint hash = 0;
+    unsigned generation = 0;  // Results of assemblies started before the last call to EditTab::stopAssembly are stale
+};
+
 class EditTab : public RipesTab {
     Q_OBJECT
 
@@ -43,6 +53,8 @@ signals:
 
 public slots:
     void updateProgramViewerHighlighting();
+    /// Selects the instructions from @p first to @p last in the program viewer
+    void showAddressRange(uint32_t first, uint32_t last);
 
     void emitProgramChanged();
 
@@ -54,23 +66,38 @@ public slots:
 
 private slots:
     void assemble();
+    void assemblyFinished();
     void on_disassembledViewButton_toggled();
 
+protected:
+    void refreshViews() override;
+
 private:
     void updateProgramViewer();
     bool loadFlatBinaryFile(Program& program, QFile& file, unsigned long entryPoint, unsigned long loadAt);
     bool loadAssemblyFile(Program& program, QFile& file);
     bool loadElfFile(Program& program, QFile& file);
+    bool loadRecordFile(Program& program, QFile& file, FileType type, QString& error);
 
     void setupActions();
+    /**
+     * @brief stopAssembly
+     * Cancels any pending or running background assembly, and waits for the worker to return.
+     */
+    void stopAssembly();
     void enableEditor();
     void disableEditor();
 
     Ui::EditTab* m_ui = nullptr;
     std::unique_ptr<Assembler> m_assembler;
+    QFutureWatcher<AssemblyResult> m_assemblyWatcher;
+    std::atomic<bool> m_cancelAssembly{false};
+    bool m_assemblyPending = false;  // Set if the document changed while it was being assembled
+    unsigned m_assemblyGeneration = 0;
 
     LoadFileParams m_loadedFile;
     Program m_activeProgram;
+    uint m_activeProgramHash = 0;
 
     bool m_editorEnabled = true;
 };
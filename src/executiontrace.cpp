@@ -0,0 +1,211 @@
+#include "executiontrace.h"
+
+#include <cstring>
+
+namespace Ripes {
+
+namespace {
+uint64_t zigzag(uint32_t delta) {
+    return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+}
+
+uint32_t unzigzag(uint64_t value) {
+    return static_cast<uint32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+}  // namespace
+
+bool ExecutionTraceWriter::open(const QString& path) {
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.reserve(s_bufferSize);
+    m_nextPc = 0;
+    m_prevMemAddress = 0;
+    m_regs.fill(0);
+    m_instructions.clear();
+
+    m_buffer.insert(m_buffer.end(), ExecutionTrace::s_magic, ExecutionTrace::s_magic + 8);
+    m_buffer.push_back(ExecutionTrace::s_version);
+    return true;
+}
+
+void ExecutionTraceWriter::close() {
+    if (m_file.isOpen()) {
+        flush();
+        m_file.close();
+    }
+}
+
+void ExecutionTraceWriter::flush() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<qint64>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+void ExecutionTraceWriter::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+        m_buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void ExecutionTraceWriter::write(const TraceRecord& record) {
+    uint8_t flags = 0;
+    if (record.pc != m_nextPc) {
+        flags |= ExecutionTrace::NonSequential;
+    }
+    auto it = m_instructions.find(record.pc);
+    if (it == m_instructions.end() || it->second != record.instr) {
+        flags |= ExecutionTrace::NewPc;
+        m_instructions[record.pc] = record.instr;
+    }
+    const bool regWrite = record.hasRegWrite && record.rd != 0 && record.rd < m_regs.size();
+    if (regWrite) {
+        flags |= ExecutionTrace::RegWrite;
+    }
+    if (record.hasMemAccess) {
+        flags |= ExecutionTrace::MemAccess;
+    }
+
+    m_buffer.push_back(flags);
+    if (flags & ExecutionTrace::NonSequential) {
+        putVarint(zigzag(record.pc - m_nextPc));
+    }
+    if (flags & ExecutionTrace::NewPc) {
+        for (unsigned i = 0; i < 4; i++) {
+            m_buffer.push_back(static_cast<uint8_t>(record.instr >> (i * 8)));
+        }
+    }
+    if (regWrite) {
+        m_buffer.push_back(record.rd);
+        putVarint(zigzag(record.rdValue - m_regs[record.rd]));
+        m_regs[record.rd] = record.rdValue;
+    }
+    if (record.hasMemAccess) {
+        putVarint(zigzag(record.memAddress - m_prevMemAddress));
+        m_prevMemAddress = record.memAddress;
+    }
+    m_nextPc = record.pc + 4;
+
+    if (m_buffer.size() >= s_bufferSize) {
+        flush();
+    }
+}
+
+bool ExecutionTraceReader::open(const QString& path) {
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    m_buffer.clear();
+    m_bufferPos = 0;
+    m_error = false;
+    m_nextPc = 0;
+    m_prevMemAddress = 0;
+    m_regs.fill(0);
+    m_instructions.clear();
+
+    char header[9];
+    if (m_file.read(header, sizeof(header)) != sizeof(header) ||
+        std::memcmp(header, ExecutionTrace::s_magic, 8) != 0 ||
+        static_cast<uint8_t>(header[8]) != ExecutionTrace::s_version) {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool ExecutionTraceReader::getByte(uint8_t& byte) {
+    if (m_bufferPos >= m_buffer.size()) {
+        m_buffer.resize(s_bufferSize);
+        const qint64 n = m_file.read(m_buffer.data(), s_bufferSize);
+        m_buffer.resize(n > 0 ? static_cast<size_t>(n) : 0);
+        m_bufferPos = 0;
+        if (m_buffer.empty()) {
+            return false;
+        }
+    }
+    byte = static_cast<uint8_t>(m_buffer[m_bufferPos++]);
+    return true;
+}
+
+bool ExecutionTraceReader::getVarint(uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        uint8_t byte;
+        if (!getByte(byte)) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ExecutionTraceReader::next(TraceRecord& record) {
+    uint8_t flags;
+    if (!getByte(flags)) {
+        // End of trace
+        return false;
+    }
+
+    // Any failure beyond this point is a truncated or malformed record
+    m_error = true;
+    uint64_t value;
+    record = TraceRecord();
+    record.pc = m_nextPc;
+    if (flags & ExecutionTrace::NonSequential) {
+        if (!getVarint(value)) {
+            return false;
+        }
+        record.pc += unzigzag(value);
+    }
+
+    if (flags & ExecutionTrace::NewPc) {
+        for (unsigned i = 0; i < 4; i++) {
+            uint8_t byte;
+            if (!getByte(byte)) {
+                return false;
+            }
+            record.instr |= static_cast<uint32_t>(byte) << (i * 8);
+        }
+        m_instructions[record.pc] = record.instr;
+    } else {
+        const auto it = m_instructions.find(record.pc);
+        if (it == m_instructions.end()) {
+            return false;
+        }
+        record.instr = it->second;
+    }
+
+    if (flags & ExecutionTrace::RegWrite) {
+        if (!getByte(record.rd) || record.rd >= m_regs.size() || !getVarint(value)) {
+            return false;
+        }
+        record.hasRegWrite = true;
+        record.rdValue = m_regs[record.rd] + unzigzag(value);
+        m_regs[record.rd] = record.rdValue;
+    }
+
+    if (flags & ExecutionTrace::MemAccess) {
+        if (!getVarint(value)) {
+            return false;
+        }
+        record.hasMemAccess = true;
+        record.memAddress = m_prevMemAddress + unzigzag(value);
+        m_prevMemAddress = record.memAddress;
+    }
+
+    m_nextPc = record.pc + 4;
+    m_error = false;
+    return true;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QFile>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The TraceRecord struct
+ * A retired instruction, as recorded in an execution trace.
+ */
+struct TraceRecord {
+    uint32_t pc = 0;
+    uint32_t instr = 0;
+
+    /// Register written by the instruction, if any (x0 is never recorded)
+    bool hasRegWrite = false;
+    uint8_t rd = 0;
+    uint32_t rdValue = 0;
+
+    /// Data memory address accessed by the instruction, if any. Whether the access is a load or a store is given by
+    /// the instruction.
+    bool hasMemAccess = false;
+    uint32_t memAddress = 0;
+};
+
+/**
+ * Execution trace file format
+ * A trace file starts with the 8-byte magic "RIPESTRC" followed by a version byte. Each retired instruction is then
+ * recorded as a flag byte followed by the fields indicated by the flags, in the order of the flags below:
+ *  - NonSequential: zig-zag varint delta of the PC relative to the PC following the previous record.
+ *  - NewPc:         the instruction word (4 bytes, little endian). Emitted only when a PC is first recorded, or when
+ *                   the instruction at it has changed; readers otherwise reuse the instruction word of the previous
+ *                   record of the PC.
+ *  - RegWrite:      register index (1 byte), and zig-zag varint delta of the value relative to the value most recently
+ *                   recorded as written to the register.
+ *  - MemAccess:     zig-zag varint delta of the address relative to the previous recorded memory address.
+ */
+namespace ExecutionTrace {
+constexpr char s_magic[] = "RIPESTRC";
+constexpr uint8_t s_version = 1;
+enum Flags : uint8_t { NonSequential = 1 << 0, NewPc = 1 << 1, RegWrite = 1 << 2, MemAccess = 1 << 3 };
+}  // namespace ExecutionTrace
+
+/**
+ * @brief The ExecutionTraceWriter class
+ * Streams trace records to a file. Records are encoded into an in-memory buffer which is written to the file whenever
+ * it fills up, and upon closing the writer.
+ */
+class ExecutionTraceWriter {
+public:
+    ~ExecutionTraceWriter() { close(); }
+
+    /**
+     * @brief open
+     * Creates (or truncates) the trace file at @p path, and writes the file header.
+     * @returns false if the file could not be opened.
+     */
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    void write(const TraceRecord& record);
+
+private:
+    void flush();
+    void putVarint(uint64_t value);
+
+    static constexpr unsigned s_bufferSize = 1 << 16;
+
+    QFile m_file;
+    std::vector<uint8_t> m_buffer;
+    uint32_t m_nextPc = 0;
+    uint32_t m_prevMemAddress = 0;
+    std::array<uint32_t, 32> m_regs = {};
+    std::unordered_map<uint32_t, uint32_t> m_instructions;
+};
+
+/**
+ * @brief The ExecutionTraceReader class
+ * Reads the records of a trace file written by ExecutionTraceWriter, in order.
+ */
+class ExecutionTraceReader {
+public:
+    /**
+     * @brief open
+     * Opens the trace file at @p path.
+     * @returns false if the file could not be opened or is not a trace file.
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief next
+     * Reads the next record into @p record.
+     * @returns false when the end of the trace is reached, or if the trace is malformed (see hasError()).
+     */
+    bool next(TraceRecord& record);
+    bool hasError() const { return m_error; }
+
+private:
+    bool getByte(uint8_t& byte);
+    bool getVarint(uint64_t& value);
+
+    static constexpr unsigned s_bufferSize = 1 << 16;
+
+    QFile m_file;
+    std::vector<char> m_buffer;
+    unsigned m_bufferPos = 0;
+    bool m_error = false;
+    uint32_t m_nextPc = 0;
+    uint32_t m_prevMemAddress = 0;
+    std::array<uint32_t, 32> m_regs = {};
+    std::unordered_map<uint32_t, uint32_t> m_instructions;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,27 @@
+#include "framebuffertab.h"
+#include "ui_framebuffertab.h"
+
+#include "peripherals.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+FramebufferTab::FramebufferTab(QToolBar* toolbar, QWidget* parent)
+    : RipesTab(toolbar, parent), m_ui(new Ui::FramebufferTab) {
+    m_ui->setupUi(this);
+
+    if (const auto* framebuffer = ProcessorHandler::get()->getDevices().find<FramebufferDevice>()) {
+        m_ui->info->setText(QString("%1x%2 pixels of 0x00RRGGBB, in row-major order at 0x%3 - 0x%4")
+                                .arg(framebuffer->width())
+                                .arg(framebuffer->height())
+                                .arg(QString::number(framebuffer->base(), 16).rightJustified(8, '0'))
+                                .arg(QString::number(framebuffer->base() + framebuffer->size() - 1, 16)
+                                         .rightJustified(8, '0')));
+    }
+}
+
+FramebufferTab::~FramebufferTab() {
+    delete m_ui;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QWidget>
+
+#include "ripestab.h"
+
+namespace Ripes {
+
+namespace Ui {
+class FramebufferTab;
+}
+
+/**
+ * @brief The FramebufferTab class
+ * Displays the framebuffer device mapped into the data memory of the current processor.
+ */
+class FramebufferTab : public RipesTab {
+    Q_OBJECT
+
+public:
+    FramebufferTab(QToolBar* toolbar, QWidget* parent = nullptr);
+    ~FramebufferTab() override;
+
+private:
+    Ui::FramebufferTab* m_ui = nullptr;
+};
+}  // namespace Ripes
@@ -0,0 +1,86 @@
+#include "framebufferwidget.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+
+#include <algorithm>
+
+#include "peripherals.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+FramebufferWidget::FramebufferWidget(QWidget* parent) : QWidget(parent) {
+    if (const auto* framebuffer = ProcessorHandler::get()->getDevices().find<FramebufferDevice>()) {
+        m_image = QImage(static_cast<int>(framebuffer->width()), static_cast<int>(framebuffer->height()),
+                         QImage::Format_RGB32);
+        m_image.fill(Qt::black);
+        m_tileSize = FramebufferDevice::s_tileSize;
+        m_tileColumns = framebuffer->tileColumns();
+    }
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    connect(ProcessorHandler::get(), &ProcessorHandler::devicesChanged, this, &FramebufferWidget::updateView);
+}
+
+QSize FramebufferWidget::sizeHint() const {
+    return m_image.size() * 4;
+}
+
+int FramebufferWidget::scale() const {
+    if (m_image.isNull()) {
+        return 1;
+    }
+    return std::max(1, std::min(width() / m_image.width(), height() / m_image.height()));
+}
+
+QPoint FramebufferWidget::origin() const {
+    const int s = scale();
+    return QPoint((width() - m_image.width() * s) / 2, (height() - m_image.height() * s) / 2);
+}
+
+void FramebufferWidget::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    // Tiles written while hidden have accumulated as dirty
+    updateView();
+}
+
+void FramebufferWidget::updateView() {
+    if (!isVisible() || m_image.isNull()) {
+        return;
+    }
+    auto* framebuffer = ProcessorHandler::get()->getDevices().find<FramebufferDevice>();
+    framebuffer->takeDirtyTiles(reinterpret_cast<uint32_t*>(m_image.bits()), m_tiles);
+
+    // Repaints of the dirty tiles are merged into a single paint event
+    const int s = scale();
+    const QPoint o = origin();
+    const int tileSize = static_cast<int>(m_tileSize) * s;
+    for (const unsigned tile : m_tiles) {
+        const int x = static_cast<int>(tile % m_tileColumns) * tileSize;
+        const int y = static_cast<int>(tile / m_tileColumns) * tileSize;
+        update(QRect(o.x() + x, o.y() + y, tileSize, tileSize));
+    }
+}
+
+void FramebufferWidget::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    const int s = scale();
+    const QPoint o = origin();
+    const QRect target(o, m_image.size() * s);
+
+    // Only the exposed part of the image is scaled and drawn
+    for (const QRect& rect : event->region()) {
+        const QRect exposed = rect.intersected(target);
+        if (!exposed.isEmpty()) {
+            const QRect source((exposed.left() - o.x()) / s, (exposed.top() - o.y()) / s,
+                               (exposed.right() - o.x()) / s - (exposed.left() - o.x()) / s + 1,
+                               (exposed.bottom() - o.y()) / s - (exposed.top() - o.y()) / s + 1);
+            painter.drawImage(QRect(o + source.topLeft() * s, source.size() * s), m_image, source);
+        }
+        for (const QRect& border : (QRegion(rect) - QRegion(target))) {
+            painter.fillRect(border, palette().window());
+        }
+    }
+}
+
+}  // namespace Ripes
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QImage>
+#include <QWidget>
+
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The FramebufferWidget class
+ * Displays the framebuffer device of the current processor, scaled by the largest integer factor which fits the widget.
+ * The widget keeps a copy of the framebuffer, into which only the tiles written since the last update are copied, and
+ * only the area of these tiles is repainted.
+ */
+class FramebufferWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    FramebufferWidget(QWidget* parent = nullptr);
+
+    QSize sizeHint() const override;
+
+public slots:
+    /// Copies and repaints the dirty tiles of the framebuffer. Skipped while the widget is hidden.
+    void updateView();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+
+private:
+    /// @returns the scale and position of the image within the widget
+    int scale() const;
+    QPoint origin() const;
+
+    QImage m_image;
+    unsigned m_tileSize = 0;
+    unsigned m_tileColumns = 0;
+    std::vector<unsigned> m_tiles;
+};
+
+}  // namespace Ripes
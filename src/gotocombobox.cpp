@@ -1,6 +1,7 @@
 #include "gotocombobox.h"
 #include "addressdialog.h"
 #include "defines.h"
+#include "memorysearchdialog.h"
 
 #include <QAbstractItemView>
 #include <QEvent>
@@ -41,6 +42,13 @@ void GoToComboBox::signalFilter(int index) {
             }
             break;
         }
+        case GoToFunction::Search: {
+            MemorySearchDialog dialog;
+            if (dialog.exec() == QDialog::Accepted) {
+                emit jumpToAddress(dialog.getAddress());
+            }
+            break;
+        }
         case GoToFunction::Custom: {
             emit jumpToAddress(addrForIndex(index));
             break;
@@ -51,6 +59,7 @@ void GoToComboBox::signalFilter(int index) {
 
 void GoToSectionComboBox::addTargets() {
     addItem("Address...", QVariant::fromValue<GoToUserData>({GoToFunction::Address, 0}));
+    addItem("Search value...", QVariant::fromValue<GoToUserData>({GoToFunction::Search, 0}));
     if (ProcessorHandler::get()->getProgram()) {
         for (const auto& section : ProcessorHandler::get()->getProgram()->sections) {
             addItem(section.name, QVariant::fromValue<GoToUserData>({GoToFunction::Custom, 0}));
@@ -73,6 +82,10 @@ void GoToRegisterComboBox::addTargets() {
 
 uint32_t GoToRegisterComboBox::addrForIndex(int i) {
     const auto& data = qvariant_cast<GoToUserData>(itemData(i));
+    // Whilst running, registers are read from the live state rather than from the processor
+    if (const auto frame = ProcessorHandler::get()->liveState(); frame && data.arg < frame->registers.size()) {
+        return frame->registers[data.arg];
+    }
     return ProcessorHandler::get()->getRegisterValue(data.arg);
 }
 
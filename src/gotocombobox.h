@@ -5,7 +5,7 @@
 
 namespace Ripes {
 
-enum class GoToFunction { Select, Address, Custom };
+enum class GoToFunction { Select, Address, Search, Custom };
 struct GoToUserData {
     GoToFunction func;
     unsigned arg;
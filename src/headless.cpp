@@ -0,0 +1,1191 @@
+#include "headless.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <climits>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/tlbsim.h"
+#include "hostprofiler.h"
+#include "lockstep.h"
+#include "multihart.h"
+#include "processorhandler.h"
+#include "programloader.h"
+
+namespace Ripes {
+
+namespace {
+const std::map<QString, ProcessorID> s_processorNames = {{"RVSS", ProcessorID::RVSS},
+                                                         {"RV5S", ProcessorID::RV5S},
+                                                         {"RV5S_BTFN", ProcessorID::RV5S_BTFN},
+                                                         {"RV5S_BIMODAL", ProcessorID::RV5S_BIMODAL},
+                                                         {"RV5S_GSHARE", ProcessorID::RV5S_GSHARE},
+                                                         {"RV5S_BTB", ProcessorID::RV5S_BTB},
+                                                         {"RV5S_NO_HZ", ProcessorID::RV5S_NO_HZ},
+                                                         {"RV5S_NO_FW_HZ", ProcessorID::RV5S_NO_FW_HZ},
+                                                         {"RV5S_DUAL", ProcessorID::RV5S_DUAL}};
+
+CacheSim::CachePreset cachePreset(const HeadlessOptions& options) {
+    CacheSim::CachePreset preset;
+    preset.lines = options.cacheLines;
+    preset.ways = options.cacheWays;
+    preset.blocks = options.cacheBlocks;
+    preset.wrPolicy = CacheSim::WritePolicy::WriteBack;
+    preset.wrAllocPolicy = CacheSim::WriteAllocPolicy::WriteAllocate;
+    preset.replPolicy = CacheSim::ReplPolicy::LRU;
+    return preset;
+}
+
+CacheSim::CachePreset cachePreset(const HeadlessOptions& options, const HeadlessOptions::LowerCacheLevel& level) {
+    CacheSim::CachePreset preset = cachePreset(options);
+    preset.lines = level.lines;
+    preset.ways = level.ways;
+    preset.blocks = level.blocks;
+    return preset;
+}
+
+std::unique_ptr<CacheSim> createCache(ProcessorHandler* handler, const HeadlessOptions& options,
+                                      CacheSim::CacheType type, const CacheSim::CachePreset& preset,
+                                      unsigned hitLatency) {
+    auto cache = std::make_unique<CacheSim>(handler, nullptr);
+    cache->setType(type);
+    cache->setPreset(preset);
+    cache->setHitLatency(hitLatency);
+    cache->setMemoryLatency(options.memoryLatency);
+    cache->setWarmup(options.cacheWarmup);
+    return cache;
+}
+
+/**
+ * @brief The CacheHierarchy struct
+ * The caches simulated as per the options of a simulation; the enabled first level caches, backed by the enabled
+ * lower levels.
+ */
+struct CacheHierarchy {
+    // Lower levels are declared first, such that they outlive the caches which they back
+    std::unique_ptr<DRAMModel> dram;
+    std::unique_ptr<CacheSim> l3Cache, l2Cache;
+    std::unique_ptr<CacheSim> dataCache, instrCache;
+    std::unique_ptr<TLBSim> dataTLB, instrTLB;
+};
+
+/**
+ * @brief validateCacheHierarchy
+ * @returns false, and sets @p error, if the cache levels enabled by @p options do not form a hierarchy.
+ */
+bool validateCacheHierarchy(const HeadlessOptions& options, QString& error) {
+    if (options.l3Cache.enabled && !options.l2Cache.enabled) {
+        error = "An L3 cache requires an L2 cache";
+        return false;
+    }
+    if (options.l2Cache.enabled && !options.dataCache && !options.instrCache) {
+        error = "An L2 cache requires a first level cache";
+        return false;
+    }
+    return true;
+}
+
+CacheHierarchy createCaches(ProcessorHandler* handler, const HeadlessOptions& options) {
+    CacheHierarchy caches;
+    if (options.l2Cache.enabled) {
+        caches.l2Cache = createCache(handler, options, CacheSim::CacheType::UnifiedCache,
+                                     cachePreset(options, options.l2Cache), options.hitLatencies[1]);
+        if (options.l3Cache.enabled) {
+            caches.l3Cache = createCache(handler, options, CacheSim::CacheType::UnifiedCache,
+                                         cachePreset(options, options.l3Cache), options.hitLatencies[2]);
+            caches.l2Cache->setNextLevel(caches.l3Cache.get());
+        }
+    }
+    const std::pair<bool, CacheSim::CacheType> firstLevels[] = {{options.dataCache, CacheSim::CacheType::DataCache},
+                                                                {options.instrCache, CacheSim::CacheType::InstrCache}};
+    for (const auto& it : firstLevels) {
+        if (!it.first) {
+            continue;
+        }
+        auto cache = createCache(handler, options, it.second, cachePreset(options), options.hitLatencies[0]);
+        if (caches.l2Cache) {
+            cache->setNextLevel(caches.l2Cache.get());
+        }
+        (it.second == CacheSim::CacheType::DataCache ? caches.dataCache : caches.instrCache) = std::move(cache);
+    }
+    if (options.dram) {
+        caches.dram = std::make_unique<DRAMModel>(options.dramConfig);
+        // The DRAM backs the lowest level, or both first levels if these are not backed by an L2 cache
+        if (CacheSim* lowerLevel = caches.l3Cache ? caches.l3Cache.get() : caches.l2Cache.get()) {
+            lowerLevel->setDRAM(caches.dram.get());
+        } else {
+            for (CacheSim* cache : {caches.dataCache.get(), caches.instrCache.get()}) {
+                if (cache) {
+                    cache->setDRAM(caches.dram.get());
+                }
+            }
+        }
+    }
+    const std::pair<bool, TLBSim::TLBType> tlbs[] = {{options.dataTLB, TLBSim::TLBType::DataTLB},
+                                                     {options.instrTLB, TLBSim::TLBType::InstrTLB}};
+    for (const auto& it : tlbs) {
+        if (!it.first) {
+            continue;
+        }
+        auto tlb = std::make_unique<TLBSim>(handler, it.second);
+        tlb->setConfig(options.tlbConfig);
+        tlb->setStallOnMiss(true);
+        (it.second == TLBSim::TLBType::DataTLB ? caches.dataTLB : caches.instrTLB) = std::move(tlb);
+    }
+    return caches;
+}
+
+CacheStatistics cacheStatistics(const CacheSim* cache, const HeadlessOptions& options) {
+    CacheStatistics stats;
+    if (!cache) {
+        return stats;
+    }
+    stats.enabled = true;
+    if (options.cacheWindow) {
+        const auto [first, last] = *options.cacheWindow;
+        const auto window = cache->getStatistics(first, last);
+        const uint64_t accesses = window.hits + window.misses;
+        stats.hits = window.hits;
+        stats.misses = window.misses;
+        stats.writebacks = window.writebacks;
+        stats.hitRate = accesses == 0 ? 0 : static_cast<double>(window.hits) / accesses;
+        stats.averageAccessTime = cache->getAverageAccessTime(first, last);
+    } else {
+        stats.hits = cache->getHits();
+        stats.misses = cache->getMisses();
+        stats.writebacks = cache->getWritebacks();
+        stats.hitRate = cache->getHitRate();
+        stats.averageAccessTime = cache->getAverageAccessTime();
+    }
+    return stats;
+}
+
+TLBStatistics tlbStatistics(const TLBSim* tlb) {
+    TLBStatistics stats;
+    if (tlb) {
+        stats.enabled = true;
+        stats.entries = tlb->getEntries();
+        stats.reach = tlb->getReach();
+        stats.hits = tlb->getHits();
+        stats.microHits = tlb->getMicroHits();
+        stats.misses = tlb->getMisses();
+        stats.hitRate = tlb->getHitRate();
+        stats.walkCycles = tlb->getWalkCycles();
+    }
+    return stats;
+}
+
+void cacheStatistics(const CacheHierarchy& caches, const HeadlessOptions& options, HeadlessResult& result) {
+    result.dataCache = cacheStatistics(caches.dataCache.get(), options);
+    result.instrCache = cacheStatistics(caches.instrCache.get(), options);
+    result.l2Cache = cacheStatistics(caches.l2Cache.get(), options);
+    result.l3Cache = cacheStatistics(caches.l3Cache.get(), options);
+    if (caches.dram) {
+        result.dram = caches.dram->getStatistics();
+    }
+    result.dataTLB = tlbStatistics(caches.dataTLB.get());
+    result.instrTLB = tlbStatistics(caches.instrTLB.get());
+}
+
+/// Collects the totals and statistics of the simulation performed by @p handler so far into @p result
+void collectStatistics(ProcessorHandler& handler, const HeadlessOptions& options, const CacheHierarchy& caches,
+                       HeadlessResult& result) {
+    result.cycles = handler.getCycleCount();
+    result.instructionsRetired = handler.getInstructionsRetired();
+    const auto* proc = handler.getProcessor();
+    if (const auto* branchPrediction = proc->getBranchPredictionStatistics(); branchPrediction && !options.functional) {
+        result.branchPrediction = *branchPrediction;
+    }
+    if (const auto* functionalUnits = proc->getFunctionalUnitStatistics(); functionalUnits && !options.functional) {
+        result.functionalUnits = *functionalUnits;
+    }
+    if (const auto* hazards = proc->getHazardStatistics(); hazards && !options.functional) {
+        result.hazards = *hazards;
+    }
+    cacheStatistics(caches, options, result);
+}
+
+/**
+ * @brief writeStatisticsReport
+ * Writes the statistics report of the simulation in @p handler to the statistics path of @p options.
+ */
+bool writeStatisticsReport(const HeadlessOptions& options, const HeadlessResult& result,
+                           const ProcessorHandler& handler, const CacheHierarchy& caches) {
+    std::vector<ProcessorHandler::ReportedCache> reported;
+    const std::vector<std::pair<QString, const CacheSim*>> levels = {{"dcache", caches.dataCache.get()},
+                                                                     {"icache", caches.instrCache.get()},
+                                                                     {"l2cache", caches.l2Cache.get()},
+                                                                     {"l3cache", caches.l3Cache.get()}};
+    for (const auto& level : levels) {
+        if (level.second) {
+            reported.push_back(level);
+        }
+    }
+    QJsonObject report = handler.statisticsReport(reported, result.wallTimeMs);
+    report["file"] = options.filepath;
+    const std::pair<QString, const TLBStatistics*> tlbs[] = {{"itlb", &result.instrTLB}, {"dtlb", &result.dataTLB}};
+    if (result.dram) {
+        QJsonObject stats;
+        stats["reads"] = static_cast<qint64>(result.dram->reads);
+        stats["writes"] = static_cast<qint64>(result.dram->writes);
+        stats["row-hits"] = static_cast<qint64>(result.dram->rowHits);
+        stats["row-empty"] = static_cast<qint64>(result.dram->rowEmpty);
+        stats["row-conflicts"] = static_cast<qint64>(result.dram->rowConflicts);
+        stats["row-hit-rate"] = result.dram->rowHitRate();
+        stats["average-miss-latency"] = result.dram->averageReadLatency();
+        report["dram"] = stats;
+    }
+    for (const auto& tlb : tlbs) {
+        if (tlb.second->enabled) {
+            QJsonObject stats;
+            stats["entries"] = static_cast<qint64>(tlb.second->entries);
+            stats["reach"] = static_cast<qint64>(tlb.second->reach);
+            stats["hits"] = static_cast<qint64>(tlb.second->hits);
+            stats["micro-hits"] = static_cast<qint64>(tlb.second->microHits);
+            stats["misses"] = static_cast<qint64>(tlb.second->misses);
+            stats["hit-rate"] = tlb.second->hitRate;
+            stats["walk-cycles"] = static_cast<qint64>(tlb.second->walkCycles);
+            report[tlb.first] = stats;
+        }
+    }
+    report["finished"] = result.finished;
+    if (result.sampled) {
+        // The totals of sampled simulations are extrapolated from the detailed windows
+        report["cycles"] = result.cycles;
+        report["cpi"] = result.instructionsRetired != 0
+                            ? static_cast<double>(result.cycles) / static_cast<double>(result.instructionsRetired)
+                            : 0;
+        report["cycles-per-second"] = result.wallTimeMs > 0 ? result.cycles * 1000.0 / result.wallTimeMs : 0;
+        report["windows"] = static_cast<qint64>(result.windows);
+        report["detailed-cycles"] = result.detailedCycles;
+        report["detailed-instructions"] = result.detailedInstructions;
+    }
+
+    QFile file(options.statisticsPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(QJsonDocument(report).toJson());
+    return true;
+}
+
+/// @returns the caches of @p caches which are simulated, named as per the statistics report
+std::vector<ProcessorHandler::SnapshotCache> snapshotCaches(const CacheHierarchy& caches) {
+    std::vector<ProcessorHandler::SnapshotCache> simulated;
+    const std::vector<ProcessorHandler::SnapshotCache> levels = {{"dcache", caches.dataCache.get()},
+                                                                 {"icache", caches.instrCache.get()},
+                                                                 {"l2cache", caches.l2Cache.get()},
+                                                                 {"l3cache", caches.l3Cache.get()}};
+    for (const auto& level : levels) {
+        if (level.second) {
+            simulated.push_back(level);
+        }
+    }
+    return simulated;
+}
+
+void printCacheStatistics(QTextStream& out, const QString& name, const CacheStatistics& stats) {
+    out << name << ":\n";
+    out << "\tHits:\t\t" << stats.hits << "\n";
+    out << "\tMisses:\t\t" << stats.misses << "\n";
+    out << "\tHit rate:\t" << QString::number(stats.hitRate, 'g', 4) << "\n";
+    out << "\tWritebacks:\t" << stats.writebacks << "\n";
+    out << "\tAMAT (cycles):\t" << QString::number(stats.averageAccessTime, 'g', 4) << "\n";
+}
+
+void printCoherence(QTextStream& out, const HeadlessResult& result) {
+    out << "Coherent data caches:\n";
+    out << "\tHart\tAccesses\tMisses\tMiss rate\tCoherence\tFalse sharing\tUpgrades\tInvalidations\t"
+           "Cache-to-cache\tWritebacks\n";
+    for (size_t i = 0; i < result.coherence.size(); i++) {
+        const auto& c = result.coherence[i];
+        out << "\t" << i << "\t" << c.accesses() << "\t\t" << c.misses << "\t" << QString::number(c.missRate(), 'g', 4)
+            << "\t\t" << c.coherenceMisses << "\t\t" << c.falseSharingMisses << "\t\t" << c.upgrades << "\t\t"
+            << c.invalidations << "\t\t" << c.cacheToCacheTransfers << "\t\t" << c.writebacks << "\n";
+    }
+    if (!result.coherenceLines.empty()) {
+        out << "Contended blocks:\n";
+        out << "\tAddress\t\tInvalidations\tCoherence\tFalse sharing\n";
+        for (const auto& line : result.coherenceLines) {
+            out << "\t0x" << QString::number(line.address, 16).rightJustified(8, '0') << "\t" << line.invalidations
+                << "\t\t" << line.coherenceMisses << "\t\t" << line.falseSharingMisses << "\n";
+        }
+    }
+}
+
+void printDRAMStatistics(QTextStream& out, const DRAMModel::Statistics& stats) {
+    out << "DRAM:\n";
+    out << "\tReads:\t\t" << stats.reads << "\n";
+    out << "\tWrites:\t\t" << stats.writes << "\n";
+    out << "\tRow hits:\t" << stats.rowHits << "\n";
+    out << "\tRow empty:\t" << stats.rowEmpty << "\n";
+    out << "\tRow conflicts:\t" << stats.rowConflicts << "\n";
+    out << "\tRow hit rate:\t" << QString::number(stats.rowHitRate(), 'g', 4) << "\n";
+    out << "\tMiss latency:\t" << QString::number(stats.averageReadLatency(), 'g', 4) << "\n";
+}
+
+void printTLBStatistics(QTextStream& out, const QString& name, const TLBStatistics& stats) {
+    out << name << ":\n";
+    out << "\tEntries:\t" << stats.entries << " (reach " << stats.reach / 1024 << " KiB)\n";
+    out << "\tHits:\t\t" << stats.hits << " (" << stats.microHits << " in micro-TLB)\n";
+    out << "\tMisses:\t\t" << stats.misses << "\n";
+    out << "\tHit rate:\t" << QString::number(stats.hitRate, 'g', 4) << "\n";
+    out << "\tWalk cycles:\t" << stats.walkCycles << "\n";
+}
+
+void printCacheSweep(QTextStream& out, const std::vector<CacheSweepResult>& results) {
+    out << "Cache\tLines\tWays\tBlocks\tReplacement\tWrite policy\tWrite allocation\tSize (bits)\tHits\tMisses\t"
+           "Hit rate\tWritebacks\tAMAT\n";
+    for (const auto& r : results) {
+        const auto& preset = r.config.preset;
+        out << (r.config.type == CacheSim::CacheType::DataCache ? "Data" : "Instruction") << "\t" << (1 << preset.lines)
+            << "\t" << (1 << preset.ways) << "\t" << (1 << preset.blocks) << "\t"
+            << s_cacheReplPolicyStrings.at(preset.replPolicy) << "\t" << s_cacheWritePolicyStrings.at(preset.wrPolicy)
+            << "\t" << s_cacheWriteAllocateStrings.at(preset.wrAllocPolicy) << "\t" << r.sizeBits << "\t" << r.hits
+            << "\t" << r.misses << "\t" << QString::number(r.hitRate, 'g', 4) << "\t" << r.writebacks << "\t"
+            << QString::number(r.averageAccessTime, 'g', 4) << "\n";
+    }
+}
+
+/**
+ * @brief simulateSampled
+ * Alternates between functional fast-forwarding and detailed windows until the program finishes or a limit is reached.
+ */
+void simulateSampled(ProcessorHandler* handler, const HeadlessOptions& options, const CacheHierarchy& caches,
+                     const QElapsedTimer& timer, const std::function<bool(const HeadlessResult&)>& progress,
+                     HeadlessResult& result) {
+    result.sampled = true;
+    auto* proc = handler->getProcessorNonConst();
+    handler->checkValidExecutionRange();
+    while (!proc->finished()) {
+        handler->fastForward(options.sampleInterval);
+
+        const long long windowEnd = proc->getCycleCount() + static_cast<long long>(options.sampleWindow);
+        while (!proc->finished() && proc->getCycleCount() < windowEnd) {
+            if (progress && (proc->getCycleCount() % s_progressInterval) == 0) {
+                collectStatistics(*handler, options, caches, result);
+                result.wallTimeMs = timer.elapsed();
+                if (!progress(result)) {
+                    result.cancelled = true;
+                    break;
+                }
+            }
+            {
+                RIPES_PROFILE_SCOPE("Design::clock");
+                proc->clock();
+            }
+            RIPES_PROFILE_COUNT("cycles", 1);
+            handler->checkValidExecutionRange();
+        }
+        result.windows++;
+
+        if (result.cancelled) {
+            break;
+        }
+        if (options.maxCycles != 0 && static_cast<unsigned long long>(handler->getCycleCount()) >= options.maxCycles) {
+            break;
+        }
+        if (options.timeLimitMs != 0 && static_cast<unsigned long long>(timer.elapsed()) >= options.timeLimitMs) {
+            result.timeLimitReached = true;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief replayCacheTrace
+ * Replays the memory access trace given by @p options through each of the enabled caches.
+ */
+HeadlessResult replayCacheTrace(const HeadlessOptions& options) {
+    HeadlessResult result;
+    result.replayed = true;
+    if (!options.dataCache && !options.instrCache) {
+        result.error = "No cache to replay the trace through";
+        return result;
+    }
+    if (!validateCacheHierarchy(options, result.error)) {
+        return result;
+    }
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!options.cacheSweep.isEmpty()) {
+        std::vector<CacheSim::CachePreset> presets;
+        if (!parseCacheSweep(options.cacheSweep, cachePreset(options), presets, result.error)) {
+            return result;
+        }
+        // The trace is read once, and shared between all swept configurations
+        std::vector<CacheTraceReader::Access> accesses;
+        CacheTraceReader trace;
+        if (!trace.open(options.filepath, options.traceFormat)) {
+            result.error = "Could not load trace file " + options.filepath;
+            return result;
+        }
+        if (!trace.readAll(accesses)) {
+            result.error = "Malformed trace file " + options.filepath;
+            return result;
+        }
+
+        std::vector<CacheSweepConfig> configs;
+        const unsigned hitLatency = options.hitLatencies[0];
+        for (const auto& preset : presets) {
+            if (options.dataCache) {
+                configs.push_back({CacheSim::CacheType::DataCache, preset, hitLatency, options.memoryLatency});
+            }
+            if (options.instrCache) {
+                configs.push_back({CacheSim::CacheType::InstrCache, preset, hitLatency, options.memoryLatency});
+            }
+        }
+        result.sweep = sweepCaches(accesses, configs, options.sweepThreads);
+        result.wallTimeMs = timer.elapsed();
+        return result;
+    }
+
+    // Caches are bound to a simulation context, whose processor is never clocked whilst replaying. The trace is
+    // replayed through all first level caches at once, such that shared lower levels observe their interleaved misses.
+    ProcessorHandler context;
+    CacheTraceReader trace;
+    if (!trace.open(options.filepath, options.traceFormat)) {
+        result.error = "Could not load trace file " + options.filepath;
+        return result;
+    }
+    const auto caches = createCaches(&context, options);
+    CacheSim::replay(trace, caches.instrCache.get(), caches.dataCache.get());
+    if (trace.hasError()) {
+        result.error = "Malformed trace file " + options.filepath;
+        return result;
+    }
+    cacheStatistics(caches, options, result);
+    result.wallTimeMs = timer.elapsed();
+    return result;
+}
+
+}  // namespace
+
+bool loadProgram(const HeadlessOptions& options, Program& program) {
+    QFile file(options.filepath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    switch (options.type) {
+        case FileType::Assembly:
+            return assembleFile(program, file);
+        case FileType::FlatBinary:
+            return loadFlatBinaryFile(program, file, options.binaryEntryPoint, options.binaryLoadAt);
+        case FileType::IntelHex:
+        case FileType::SRecord: {
+            QString error;
+            return loadRecordFile(program, file, options.type, error);
+        }
+        case FileType::Executable: {
+            if (!options.filepath.startsWith(":/")) {
+                return loadElfFile(program, file);
+            }
+            // ELFIO cannot read from the bundled resources, such that bundled examples are loaded from a temporary copy
+            std::unique_ptr<QTemporaryFile> copy(QTemporaryFile::createNativeFile(file));
+            if (!copy || !copy->open()) {
+                return false;
+            }
+            return loadElfFile(program, *copy);
+        }
+    }
+    return false;
+}
+
+bool parseProcessorID(const QString& name, ProcessorID& id) {
+    const auto it = s_processorNames.find(name.toUpper());
+    if (it == s_processorNames.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+QString processorName(ProcessorID id) {
+    for (const auto& it : s_processorNames) {
+        if (it.second == id) {
+            return it.first;
+        }
+    }
+    return QString();
+}
+
+bool parseFileType(const QString& type, const QString& filepath, FileType& fileType) {
+    QString t = type.toLower();
+    if (t.isEmpty()) {
+        const QString suffix = QFileInfo(filepath).suffix().toLower();
+        if (suffix == "s" || suffix == "asm") {
+            t = "asm";
+        } else if (suffix == "bin") {
+            t = "bin";
+        } else if (suffix == "hex" || suffix == "ihex") {
+            t = "ihex";
+        } else if (suffix == "srec" || suffix == "mot" || suffix == "s19" || suffix == "s28" || suffix == "s37") {
+            t = "srec";
+        } else {
+            t = "elf";
+        }
+    }
+    if (t == "asm") {
+        fileType = FileType::Assembly;
+    } else if (t == "bin") {
+        fileType = FileType::FlatBinary;
+    } else if (t == "elf") {
+        fileType = FileType::Executable;
+    } else if (t == "ihex") {
+        fileType = FileType::IntelHex;
+    } else if (t == "srec") {
+        fileType = FileType::SRecord;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+namespace {
+bool parseCacheConfig(const QString& config, int& lines, int& ways, int& blocks) {
+    const auto fields = config.split(',');
+    if (fields.size() != 3) {
+        return false;
+    }
+    bool ok[3];
+    const int l = fields.at(0).toInt(&ok[0]);
+    const int w = fields.at(1).toInt(&ok[1]);
+    const int b = fields.at(2).toInt(&ok[2]);
+    if (!(ok[0] && ok[1] && ok[2])) {
+        return false;
+    }
+    lines = l;
+    ways = w;
+    blocks = b;
+    return true;
+}
+
+/**
+ * @brief writeMemoryDump
+ * Writes the memory image of @p options from @p memory, reporting failure through the error of @p result.
+ */
+void writeMemoryDump(const HeadlessOptions& options, const vsrtl::core::SparseArray& memory, HeadlessResult& result) {
+    QString error;
+    if (!MemoryDump::write(memory, options.memoryDumpPath, options.memoryDumpFormat, options.memoryDumpRange, error)) {
+        result.error = "Could not write memory image: " + error;
+    }
+}
+
+/**
+ * @brief initialRegisters
+ * @returns the register initialization of the processor of @p options, overridden by the register inputs of @p options.
+ */
+RegisterInitialization initialRegisters(const HeadlessOptions& options) {
+    auto registers = ProcessorRegistry::getDescription(options.processor).defaultRegisterVals;
+    for (const auto& [reg, value] : options.registers) {
+        registers[reg] = value;
+    }
+    return registers;
+}
+
+/**
+ * @brief addDataInputs
+ * Writes the data inputs of @p options over the sections of @p program, materializing any zero-filled bytes which they
+ * cover.
+ * @returns false and sets @p error if a data input is not within a section.
+ */
+bool addDataInputs(const HeadlessOptions& options, Program& program, QString& error) {
+    for (const auto& [address, bytes] : options.data) {
+        const auto section = std::find_if(program.sections.begin(), program.sections.end(), [&](const auto& s) {
+            return s.address <= address && address + static_cast<unsigned long>(bytes.size()) <= s.address + s.size();
+        });
+        if (section == program.sections.end()) {
+            error = QString("Data input at 0x%1 is not within a section of the program").arg(address, 0, 16);
+            return false;
+        }
+        const int offset = static_cast<int>(address - section->address);
+        const int end = offset + bytes.size();
+        if (end > section->data.size()) {
+            section->zeroSize -= static_cast<unsigned long>(end - section->data.size());
+            section->data.append(QByteArray(end - section->data.size(), '\0'));
+        }
+        section->data.replace(offset, bytes.size(), bytes);
+    }
+    return true;
+}
+
+/**
+ * @brief simulateMultiHart
+ * Executes @p program on options.harts functional harts sharing its memory (see MultiHartSystem). The harts are run
+ * in slices of s_progressInterval cycles, between which the limits and progress of the simulation are evaluated.
+ */
+void simulateMultiHart(const Program& program, const HeadlessOptions& options, const QElapsedTimer& timer,
+                       const std::function<void(const QString&)>& print,
+                       const std::function<bool(const HeadlessResult&)>& progress, HeadlessResult& result) {
+    MultiHartSystem system(options.harts, program, initialRegisters(options));
+    if (options.dataCache) {
+        system.enableCoherence(options.cacheLines, options.cacheWays, options.cacheBlocks);
+    }
+    const auto output = [&](const QString& str) {
+        if (print) {
+            print(str);
+        } else {
+            result.output += str;
+        }
+    };
+    MultiHartSystem::Result hartResult;
+    while (true) {
+        unsigned long long slice = static_cast<unsigned long long>(hartResult.cycles) + s_progressInterval;
+        if (options.maxCycles != 0) {
+            slice = std::min(slice, options.maxCycles);
+        }
+        hartResult = system.run(options.quantum, slice, output);
+        result.cycles = hartResult.cycles;
+        result.instructionsRetired = 0;
+        for (const long long instructions : hartResult.instructions) {
+            result.instructionsRetired += instructions;
+        }
+        result.wallTimeMs = timer.elapsed();
+        if (hartResult.finished || hartResult.cancelled ||
+            (options.maxCycles != 0 && static_cast<unsigned long long>(hartResult.cycles) >= options.maxCycles)) {
+            break;
+        }
+        if (options.timeLimitMs != 0 && static_cast<unsigned long long>(timer.elapsed()) >= options.timeLimitMs) {
+            result.timeLimitReached = true;
+            break;
+        }
+        if (progress && !progress(result)) {
+            result.cancelled = true;
+            break;
+        }
+    }
+    result.finished = hartResult.finished;
+    result.hartInstructions = hartResult.instructions;
+    result.coherence = hartResult.coherence;
+    result.coherenceLines = hartResult.coherenceLines;
+    if (!hartResult.registers.empty()) {
+        result.registers = hartResult.registers.front();
+    }
+    if (!options.memoryDumpPath.isEmpty()) {
+        writeMemoryDump(options, system.getMemory(), result);
+    }
+}
+
+}  // namespace
+
+bool parseCacheConfig(const QString& config, HeadlessOptions& options) {
+    return parseCacheConfig(config, options.cacheLines, options.cacheWays, options.cacheBlocks);
+}
+
+bool parseCacheConfig(const QString& config, HeadlessOptions::LowerCacheLevel& level) {
+    if (!parseCacheConfig(config, level.lines, level.ways, level.blocks)) {
+        return false;
+    }
+    level.enabled = true;
+    return true;
+}
+
+bool parseCacheLatencies(const QString& latencies, HeadlessOptions& options) {
+    const auto fields = latencies.split(',');
+    if (fields.size() != 4) {
+        return false;
+    }
+    unsigned values[4];
+    for (int i = 0; i < 4; i++) {
+        bool ok;
+        values[i] = fields.at(i).toUInt(&ok);
+        if (!ok) {
+            return false;
+        }
+    }
+    std::copy(values, values + 3, options.hitLatencies);
+    options.memoryLatency = values[3];
+    return true;
+}
+
+bool parseCacheWarmup(const QString& warmup, HeadlessOptions& options) {
+    if (warmup == "none") {
+        options.cacheWarmup = CacheSim::Warmup();
+        return true;
+    }
+    const auto fields = warmup.split(':');
+    if (fields.size() != 2) {
+        return false;
+    }
+    const std::map<QString, CacheSim::Warmup::Mode> modes = {{"cycles", CacheSim::Warmup::Mode::Cycles},
+                                                              {"accesses", CacheSim::Warmup::Mode::Accesses},
+                                                              {"pc", CacheSim::Warmup::Mode::MarkerPC}};
+    const auto mode = modes.find(fields.at(0));
+    bool ok;
+    const unsigned long long value = fields.at(1).toULongLong(&ok, 0);
+    if (mode == modes.end() || !ok || (mode->second == CacheSim::Warmup::Mode::MarkerPC && value > UINT32_MAX)) {
+        return false;
+    }
+    options.cacheWarmup.mode = mode->second;
+    if (mode->second == CacheSim::Warmup::Mode::MarkerPC) {
+        options.cacheWarmup.pc = static_cast<uint32_t>(value);
+    } else {
+        options.cacheWarmup.count = value;
+    }
+    return true;
+}
+
+bool parseCacheWindow(const QString& window, HeadlessOptions& options) {
+    const auto fields = window.split(',');
+    if (fields.size() != 2) {
+        return false;
+    }
+    bool firstOk, lastOk;
+    const uint64_t first = fields.at(0).toULongLong(&firstOk);
+    const uint64_t last = fields.at(1).toULongLong(&lastOk);
+    if (!firstOk || !lastOk || first > last) {
+        return false;
+    }
+    options.cacheWindow = std::make_pair(first, last);
+    return true;
+}
+
+bool parseTLBConfig(const QString& config, HeadlessOptions& options) {
+    static const std::map<QString, CacheSim::ReplPolicy> s_policies = {
+        {"lru", CacheSim::ReplPolicy::LRU},   {"random", CacheSim::ReplPolicy::Random},
+        {"plru", CacheSim::ReplPolicy::PLRU}, {"fifo", CacheSim::ReplPolicy::FIFO},
+        {"lfu", CacheSim::ReplPolicy::LFU},   {"srrip", CacheSim::ReplPolicy::SRRIP}};
+    const auto fields = config.split(',');
+    if (fields.size() != 4) {
+        return false;
+    }
+    bool ok[3];
+    const int sets = fields.at(0).toInt(&ok[0]);
+    const int ways = fields.at(1).toInt(&ok[1]);
+    const unsigned walkLatency = fields.at(3).toUInt(&ok[2]);
+    const auto policy = s_policies.find(fields.at(2).trimmed().toLower());
+    if (!(ok[0] && ok[1] && ok[2]) || sets < 0 || ways < 0 || sets + ways > 16 || policy == s_policies.end()) {
+        return false;
+    }
+    options.tlbConfig.sets = sets;
+    options.tlbConfig.ways = ways;
+    options.tlbConfig.replPolicy = policy->second;
+    options.tlbConfig.walkLatency = walkLatency;
+    return true;
+}
+
+bool parseDRAMConfig(const QString& config, HeadlessOptions& options) {
+    const auto fields = config.split(',');
+    if (fields.size() != 6) {
+        return false;
+    }
+    bool ok[5];
+    const int banks = fields.at(0).toInt(&ok[0]);
+    const int row = fields.at(1).toInt(&ok[1]);
+    const QString policy = fields.at(2).trimmed().toLower();
+    const unsigned tRCD = fields.at(3).toUInt(&ok[2]);
+    const unsigned tCAS = fields.at(4).toUInt(&ok[3]);
+    const unsigned tRP = fields.at(5).toUInt(&ok[4]);
+    if (!(ok[0] && ok[1] && ok[2] && ok[3] && ok[4]) || banks < 0 || row < 2 || banks + row > 31 ||
+        (policy != "open" && policy != "closed")) {
+        return false;
+    }
+    options.dramConfig.bankBits = banks;
+    options.dramConfig.rowBits = row;
+    options.dramConfig.policy = policy == "open" ? DRAMModel::PagePolicy::Open : DRAMModel::PagePolicy::Closed;
+    options.dramConfig.tRCD = tRCD;
+    options.dramConfig.tCAS = tCAS;
+    options.dramConfig.tRP = tRP;
+    return true;
+}
+
+bool parseUnitLatencies(const QString& latencies, HeadlessOptions& options) {
+    const auto fields = latencies.split(',');
+    if (fields.size() != 2) {
+        return false;
+    }
+    bool mulOk, divOk;
+    const unsigned mul = fields.at(0).toUInt(&mulOk);
+    const unsigned div = fields.at(1).toUInt(&divOk);
+    if (!mulOk || !divOk || mul == 0 || div == 0) {
+        return false;
+    }
+    options.unitLatencies.multiply = mul;
+    options.unitLatencies.divide = div;
+    return true;
+}
+
+HeadlessResult simulate(const HeadlessOptions& options, const std::function<void(const QString&)>& print,
+                        const std::function<bool(const HeadlessResult&)>& progress) {
+    if (options.replayTrace) {
+        return replayCacheTrace(options);
+    }
+    // The simulation is performed in a context of its own, independent of the context which the GUI binds to and of
+    // any other simulations executing concurrently.
+    ProcessorHandler context;
+    return simulate(context, options, print, progress);
+}
+
+HeadlessResult simulate(ProcessorHandler& context, const HeadlessOptions& options,
+                        const std::function<void(const QString&)>& print,
+                        const std::function<bool(const HeadlessResult&)>& progress) {
+    if (options.replayTrace) {
+        return replayCacheTrace(options);
+    }
+
+    HeadlessResult result;
+    if (!options.functional && !validateCacheHierarchy(options, result.error)) {
+        return result;
+    }
+    QElapsedTimer timer;
+    timer.start();
+
+    Program program;
+    if (options.program) {
+        program = *options.program;
+    } else if (!loadProgram(options, program)) {
+        result.error = "Could not load file " + options.filepath;
+        return result;
+    }
+    if (!program.getSection(TEXT_SECTION_NAME)) {
+        result.error = QString("Program does not contain a %1 section").arg(TEXT_SECTION_NAME);
+        return result;
+    }
+    if (!addDataInputs(options, program, result.error)) {
+        return result;
+    }
+
+    if (options.harts > 1) {
+        simulateMultiHart(program, options, timer, print, progress, result);
+        result.cycleLimitReached = !result.finished && !result.timeLimitReached && !result.cancelled &&
+                                   options.maxCycles != 0 &&
+                                   static_cast<unsigned long long>(result.cycles) >= options.maxCycles;
+        return result;
+    }
+
+    auto* handler = &context;
+    // The connections of this simulation are scoped to it, such that they do not outlive it in a reused context
+    QObject scope;
+    // Without any widgets present, the reset and program reload requests of the processor handler are serviced
+    // directly.
+    QObject::connect(handler, &ProcessorHandler::reqProcessorReset, &scope,
+                     [=] { handler->getProcessorNonConst()->reset(); });
+    QObject::connect(handler, &ProcessorHandler::reqReloadProgram, &scope,
+                     [=, &program] { handler->loadProgram(&program); });
+    QObject::connect(handler, &ProcessorHandler::print, &scope, [&](const QString& str) {
+        if (print) {
+            print(str);
+        } else {
+            result.output += str;
+        }
+    });
+    QObject::connect(handler, &ProcessorHandler::exit, &scope, [&] { result.finished = true; });
+
+    CacheHierarchy caches;
+    if (!options.functional) {
+        caches = createCaches(handler, options);
+    }
+
+    handler->setFileSandbox(options.ioDirectory.isEmpty() ? QDir::currentPath() : options.ioDirectory);
+    handler->setFunctionalUnitLatencies(options.unitLatencies);
+    handler->selectProcessor(options.processor, initialRegisters(options));
+    if (!options.tracePath.isEmpty() && !handler->startTrace(options.tracePath)) {
+        result.error = "Could not create trace file " + options.tracePath;
+        return result;
+    }
+    if (!options.pipelineTracePath.isEmpty() && !handler->startPipelineTrace(options.pipelineTracePath)) {
+        result.error = "Could not create pipeline trace file " + options.pipelineTracePath;
+        return result;
+    }
+
+    if (!options.restoreSnapshotPath.isEmpty()) {
+        QString error;
+        if (!handler->restoreSnapshot(options.restoreSnapshotPath, snapshotCaches(caches), error)) {
+            result.error = "Could not restore snapshot: " + error;
+            return result;
+        }
+        if (options.functional && handler->getProcessor()->getCycleCount() != 0) {
+            result.error = "Snapshots of detailed simulations cannot be resumed functionally";
+            return result;
+        }
+    }
+
+    if (!options.hostProfilePath.isEmpty()) {
+        HostProfiler::setEnabled(true);
+    }
+    if (options.functional) {
+        handler->setRunCycleLimit(options.maxCycles);
+        QEventLoop loop;
+        QObject::connect(handler, &ProcessorHandler::runFinished, &loop, &QEventLoop::quit);
+        QTimer timeLimit;
+        if (options.timeLimitMs != 0) {
+            timeLimit.setSingleShot(true);
+            QObject::connect(&timeLimit, &QTimer::timeout, [&] {
+                result.timeLimitReached = true;
+                handler->stop();
+            });
+            timeLimit.start(static_cast<int>(std::min<unsigned long long>(options.timeLimitMs, INT_MAX)));
+        }
+        handler->run();
+        loop.exec();
+    } else if (options.sampleInterval != 0) {
+        simulateSampled(handler, options, caches, timer, progress, result);
+    } else {
+        auto* proc = handler->getProcessorNonConst();
+        handler->checkValidExecutionRange();
+        while (!proc->finished()) {
+            if (options.maxCycles != 0 && static_cast<unsigned long long>(proc->getCycleCount()) >= options.maxCycles) {
+                break;
+            }
+            // Polling the timer is kept off the per-cycle path.
+            if (options.timeLimitMs != 0 && (proc->getCycleCount() & 0xFFF) == 0 &&
+                static_cast<unsigned long long>(timer.elapsed()) >= options.timeLimitMs) {
+                result.timeLimitReached = true;
+                break;
+            }
+            if (progress && (proc->getCycleCount() % s_progressInterval) == 0) {
+                collectStatistics(*handler, options, caches, result);
+                result.wallTimeMs = timer.elapsed();
+                if (!progress(result)) {
+                    result.cancelled = true;
+                    break;
+                }
+            }
+            {
+                RIPES_PROFILE_SCOPE("Design::clock");
+                proc->clock();
+            }
+            RIPES_PROFILE_COUNT("cycles", 1);
+            handler->checkValidExecutionRange();
+        }
+    }
+
+    if (!options.hostProfilePath.isEmpty()) {
+        HostProfiler::setEnabled(false);
+    }
+    handler->checkProcessorFinished();
+    handler->stopTrace();
+    handler->stopPipelineTrace();
+    collectStatistics(*handler, options, caches, result);
+    handler->getRegisterValues(result.registers);
+    if (result.sampled) {
+        auto* proc = handler->getProcessor();
+        result.detailedCycles = proc->getCycleCount();
+        result.detailedInstructions = proc->getInstructionsRetired();
+        if (result.detailedInstructions != 0) {
+            const double cpi =
+                static_cast<double>(result.detailedCycles) / static_cast<double>(result.detailedInstructions);
+            const auto functionalInstructions = result.instructionsRetired - result.detailedInstructions;
+            result.cycles = result.detailedCycles + static_cast<long long>(cpi * functionalInstructions);
+        }
+    }
+    result.cycleLimitReached = !result.finished && !result.timeLimitReached && !result.cancelled &&
+                               options.maxCycles != 0 &&
+                               static_cast<unsigned long long>(result.cycles) >= options.maxCycles;
+    result.wallTimeMs = timer.elapsed();
+
+    if (!options.statisticsPath.isEmpty() && !writeStatisticsReport(options, result, *handler, caches)) {
+        result.error = "Could not write statistics report " + options.statisticsPath;
+    }
+    if (!options.flameGraphPath.isEmpty()) {
+        QFile file(options.flameGraphPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            result.error = "Could not write flame graph " + options.flameGraphPath;
+        } else {
+            file.write(handler->getCallGraph().foldedStacks(options.flameGraphMetric));
+        }
+    }
+    if (!options.saveSnapshotPath.isEmpty()) {
+        QString error;
+        if (!handler->saveSnapshot(options.saveSnapshotPath, snapshotCaches(caches), error)) {
+            result.error = error;
+        }
+    }
+    if (!options.memoryDumpPath.isEmpty()) {
+        writeMemoryDump(options, handler->getMemory(), result);
+    }
+    if (!options.hostProfilePath.isEmpty() && !HostProfiler::writeChromeTrace(options.hostProfilePath)) {
+        result.error = "Could not write host profile " + options.hostProfilePath;
+    }
+    return result;
+}
+
+std::vector<HeadlessResult> simulateLockstep(const std::vector<HeadlessOptions>& jobs) {
+    std::vector<HeadlessResult> results(jobs.size());
+    if (jobs.empty()) {
+        return results;
+    }
+    QElapsedTimer timer;
+    timer.start();
+
+    const HeadlessOptions& first = jobs.front();
+    Program program;
+    if (first.program) {
+        program = *first.program;
+    } else if (!loadProgram(first, program)) {
+        for (auto& result : results) {
+            result.error = "Could not load file " + first.filepath;
+        }
+        return results;
+    }
+    if (!program.getSection(TEXT_SECTION_NAME)) {
+        for (auto& result : results) {
+            result.error = QString("Program does not contain a %1 section").arg(TEXT_SECTION_NAME);
+        }
+        return results;
+    }
+
+    // Jobs of invalid inputs are not executed, and lanes map to the remaining jobs
+    std::vector<LockstepSystem::LaneInput> inputs;
+    std::vector<unsigned> laneJobs;
+    for (unsigned i = 0; i < jobs.size(); i++) {
+        if (!jobs[i].data.empty()) {
+            Program validated = program;
+            if (!addDataInputs(jobs[i], validated, results[i].error)) {
+                continue;
+            }
+        }
+        inputs.push_back({initialRegisters(jobs[i]), jobs[i].data});
+        laneJobs.push_back(i);
+    }
+    if (inputs.empty()) {
+        return results;
+    }
+
+    LockstepSystem system(program, inputs);
+    bool stopped = false;
+    bool timeLimitReached = false;
+    unsigned long long cycles = 0;
+    while (!stopped) {
+        cycles += s_progressInterval;
+        if (first.maxCycles != 0) {
+            cycles = std::min(cycles, first.maxCycles);
+        }
+        stopped = system.run(cycles);
+        if (stopped || (first.maxCycles != 0 && cycles >= first.maxCycles)) {
+            break;
+        }
+        if (first.timeLimitMs != 0 && static_cast<unsigned long long>(timer.elapsed()) >= first.timeLimitMs) {
+            timeLimitReached = true;
+            break;
+        }
+    }
+
+    const qint64 wallTimeMs = timer.elapsed();
+    for (unsigned lane = 0; lane < system.lanes(); lane++) {
+        const unsigned job = laneJobs[lane];
+        const auto laneResult = system.result(lane);
+        if (laneResult.unsupported) {
+            results[job] = simulate(jobs[job]);
+            continue;
+        }
+        HeadlessResult& result = results[job];
+        result.finished = laneResult.finished;
+        result.timeLimitReached = !result.finished && timeLimitReached;
+        result.cycles = laneResult.instructions;
+        result.instructionsRetired = laneResult.instructions;
+        result.cycleLimitReached = !result.finished && !result.timeLimitReached && first.maxCycles != 0 &&
+                                   static_cast<unsigned long long>(result.cycles) >= first.maxCycles;
+        result.wallTimeMs = wallTimeMs;
+        result.registers = laneResult.registers;
+        result.output = laneResult.output;
+        result.lockstepLanes = system.lanes();
+    }
+    return results;
+}
+
+int runHeadless(const HeadlessOptions& options) {
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const auto result = simulate(options, [&out](const QString& str) { out << str << flush; });
+    if (!result.error.isEmpty()) {
+        err << "Error: " << result.error << "\n";
+        return 1;
+    }
+    if (result.cycleLimitReached) {
+        err << "Maximum cycle count reached\n";
+    }
+    if (result.timeLimitReached) {
+        err << "Time limit reached\n";
+    }
+
+    out << "\n";
+    if (!result.sweep.empty()) {
+        printCacheSweep(out, result.sweep);
+        return 0;
+    }
+    if (result.replayed) {
+        out << "Trace:\t\t\t" << options.filepath << "\n";
+    } else {
+        out << "Processor:\t\t" << ProcessorRegistry::getDescription(options.processor).name << "\n";
+        if (result.sampled) {
+            out << "Detailed windows:\t" << result.windows << "\n";
+            out << "Detailed cycles:\t" << result.detailedCycles << "\n";
+            out << "Detailed instructions:\t" << result.detailedInstructions << "\n";
+            out << "Cycles (estimated):\t" << result.cycles << "\n";
+        } else {
+            out << "Cycles:\t\t\t" << result.cycles << "\n";
+        }
+        out << "Instructions retired:\t" << result.instructionsRetired << "\n";
+        for (size_t i = 0; i < result.hartInstructions.size(); i++) {
+            out << "  Hart " << i << ":\t\t" << result.hartInstructions[i] << "\n";
+        }
+        if (result.cycles != 0 && result.instructionsRetired != 0) {
+            const double cpi = static_cast<double>(result.cycles) / static_cast<double>(result.instructionsRetired);
+            out << "CPI:\t\t\t" << QString::number(cpi, 'g', 3) << "\n";
+            out << "IPC:\t\t\t" << QString::number(1 / cpi, 'g', 3) << "\n";
+        }
+        if (result.branchPrediction) {
+            const auto& bp = *result.branchPrediction;
+            out << "Branch predictions:\t" << bp.predictions << "\n";
+            out << "Mispredictions:\t\t" << bp.mispredictions;
+            if (bp.predictions != 0) {
+                out << " (" << QString::number(100.0 * bp.mispredictions / bp.predictions, 'f', 2) << "%)";
+            }
+            out << "\n";
+            out << "Flush cycles saved:\t" << bp.flushCyclesSaved << "\n";
+        }
+        if (result.functionalUnits) {
+            out << "MUL/DIV stalls:\t\t" << result.functionalUnits->dependencyStallCycles << "\n";
+            out << "Structural stalls:\t" << result.functionalUnits->structuralStallCycles << "\n";
+        }
+        if (result.hazards) {
+            out << "Load-use stalls:\t" << result.hazards->loadUseStallCycles << "\n";
+            out << "ECALL stalls:\t\t" << result.hazards->ecallStallCycles << "\n";
+            out << "Control-flow flushes:\t" << result.hazards->controlFlowFlushes << "\n";
+            out << "Forwarded operands:\t" << result.hazards->forwardedOperands << "\n";
+            out << "Empty fetch cycles:\t" << result.hazards->emptyFetchCycles << "\n";
+        }
+    }
+    if (!result.coherence.empty()) {
+        printCoherence(out, result);
+    }
+    if (result.dataCache.enabled) {
+        printCacheStatistics(out, "Data cache", result.dataCache);
+    }
+    if (result.instrCache.enabled) {
+        printCacheStatistics(out, "Instruction cache", result.instrCache);
+    }
+    if (result.l2Cache.enabled) {
+        printCacheStatistics(out, "L2 cache", result.l2Cache);
+    }
+    if (result.l3Cache.enabled) {
+        printCacheStatistics(out, "L3 cache", result.l3Cache);
+    }
+    if (result.dram) {
+        printDRAMStatistics(out, *result.dram);
+    }
+    if (result.instrTLB.enabled) {
+        printTLBStatistics(out, "Instruction TLB", result.instrTLB);
+    }
+    if (result.dataTLB.enabled) {
+        printTLBStatistics(out, "Data TLB", result.dataTLB);
+    }
+
+    return 0;
+}
+
+}  // namespace Ripes
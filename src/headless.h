@@ -0,0 +1,454 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "cachesim/cachesweep.h"
+#include "cachesim/coherence.h"
+#include "cachesim/tlbsim.h"
+#include "callgraphprofiler.h"
+#include "memorydump.h"
+#include "processorregistry.h"
+#include "program.h"
+
+namespace Ripes {
+
+class ProcessorHandler;
+
+/**
+ * @brief The HeadlessOptions struct
+ * Configuration of a simulation executed without any graphical interface.
+ */
+struct HeadlessOptions {
+    QString filepath;
+    FileType type = FileType::Executable;
+    unsigned long binaryEntryPoint = 0;
+    unsigned long binaryLoadAt = 0;
+
+    /**
+     * @brief program
+     * If set, this program is simulated rather than the program loaded from filepath, ie. the program currently
+     * loaded in the GUI. Copies of the program share the data of its sections.
+     */
+    std::shared_ptr<const Program> program;
+
+    ProcessorID processor = ProcessorID::RV5S;
+
+    /**
+     * @brief registers/data
+     * Inputs of the program; initial values of registers, overriding the register initialization of the processor,
+     * and bytes written over the image of the program by address. Data inputs must be within the sections of the
+     * program, including their zero-filled bytes.
+     */
+    RegisterInitialization registers;
+    std::map<uint32_t, QByteArray> data;
+
+    /**
+     * @brief unitLatencies
+     * Latencies of the multiplier and divider, for processors which model multi-cycle functional units.
+     */
+    vsrtl::core::FunctionalUnitLatencies unitLatencies;
+
+    /**
+     * @brief functional
+     * Execute the program through the functional interpreter. No cache statistics are gathered in this mode.
+     */
+    bool functional = false;
+
+    /**
+     * @brief harts/quantum
+     * If harts is greater than 1, the program is executed by this number of functional harts sharing its memory, each
+     * on a host thread of its own, which synchronize every quantum instructions (see MultiHartSystem). Harts are told
+     * apart through mhartid. If dataCache is set, each hart has a private L1 data cache of the configuration given by
+     * cacheLines/Ways/Blocks, kept coherent through MESI (see CoherenceModel). No other cache, trace or profiling
+     * options apply in this mode.
+     */
+    unsigned harts = 1;
+    unsigned long long quantum = 1000;
+
+    /**
+     * @brief maxCycles
+     * Stop the simulation after this number of cycles. 0 disables the limit.
+     */
+    unsigned long long maxCycles = 0;
+
+    /**
+     * @brief timeLimitMs
+     * Stop the simulation after this number of milliseconds of wall-clock time. 0 disables the limit.
+     */
+    unsigned long long timeLimitMs = 0;
+
+    /**
+     * @brief sampleInterval/sampleWindow
+     * Sampled simulation. If sampleInterval is non-zero, execution alternates between fast-forwarding sampleInterval
+     * instructions through the functional interpreter, warming up the caches, and detailed windows of sampleWindow
+     * cycles. The cycle count of the full execution is extrapolated from the CPI of the detailed windows, and cache
+     * statistics are gathered within the detailed windows only. Does not apply to functional simulation.
+     */
+    unsigned long long sampleInterval = 0;
+    unsigned long long sampleWindow = 10000;
+
+    /**
+     * @brief ioDirectory
+     * Sandbox directory of the file system calls of the simulated program. The working directory if empty.
+     */
+    QString ioDirectory;
+
+    /**
+     * @brief tracePath
+     * If non-empty, an execution trace of all retired instructions is recorded to this file (see executiontrace.h).
+     */
+    QString tracePath;
+
+    /**
+     * @brief pipelineTracePath
+     * If non-empty, the stage information of every simulated cycle is streamed to this file; as CSV if it has a .csv
+     * extension, in the binary format otherwise (see pipelinetrace.h).
+     */
+    QString pipelineTracePath;
+
+    /**
+     * @brief statisticsPath
+     * If non-empty, a JSON report of the statistics of the simulation is written to this file once it finishes (see
+     * ProcessorHandler::statisticsReport). Does not apply to replayed traces.
+     */
+    QString statisticsPath;
+
+    /**
+     * @brief flameGraphPath/flameGraphMetric
+     * If non-empty, the call stacks of the simulated program are written to this file once it finishes, in the folded
+     * stack format of flame graph tools, weighted by flameGraphMetric (see CallGraphProfiler::foldedStacks).
+     */
+    QString flameGraphPath;
+    CallGraphProfiler::Metric flameGraphMetric = CallGraphProfiler::Metric::Cycles;
+
+    /**
+     * @brief hostProfilePath
+     * If non-empty, the host time spent within the simulator itself is profiled and written to this file as a Chrome
+     * trace event file (see HostProfiler). Requires Ripes to be built with RIPES_HOST_PROFILER. The profiler is global
+     * to the process, so only a single simulation should be profiled at a time.
+     */
+    QString hostProfilePath;
+
+    /**
+     * @brief restoreSnapshotPath/saveSnapshotPath
+     * If non-empty, the simulation is resumed from the snapshot at restoreSnapshotPath rather than started from the
+     * beginning of the program, and a snapshot of the simulation is written to saveSnapshotPath once it stops (see
+     * ProcessorHandler::saveSnapshot). Snapshots must be restored with the processor, program and caches which they
+     * were saved with; snapshots of a detailed simulation cannot be resumed functionally. Does not apply to replayed
+     * traces.
+     */
+    QString restoreSnapshotPath;
+    QString saveSnapshotPath;
+
+    /**
+     * @brief memoryDumpPath/memoryDumpFormat/memoryDumpRange
+     * If non-empty, an image of memoryDumpRange of memory, or of all populated pages of memory if no range is given, is
+     * written to memoryDumpPath in memoryDumpFormat once the simulation stops (see MemoryDump::write). Does not apply
+     * to replayed traces.
+     */
+    QString memoryDumpPath;
+    MemoryDump::Format memoryDumpFormat = MemoryDump::Format::Binary;
+    std::optional<MemoryDump::Range> memoryDumpRange;
+
+    /**
+     * @brief replayTrace/traceFormat
+     * If set, filepath is a memory access trace of traceFormat, which is replayed through the simulated caches without
+     * simulating a processor (see CacheTraceReader).
+     */
+    bool replayTrace = false;
+    CacheTraceReader::Format traceFormat = CacheTraceReader::Format::Ripes;
+
+    /**
+     * @brief cacheSweep/sweepThreads
+     * Grid of cache configurations which a replayed trace is swept across (see parseCacheSweep), rather than the single
+     * configuration given by cacheLines/Ways/Blocks. Up to sweepThreads configurations are simulated concurrently
+     * (0 = one per core).
+     */
+    QString cacheSweep;
+    int sweepThreads = 0;
+
+    bool dataCache = false;
+    bool instrCache = false;
+
+    /**
+     * @brief cacheLines/Ways/Blocks
+     * Cache configuration, given as the base-2 logarithm of each cache dimension.
+     */
+    int cacheLines = 5;
+    int cacheWays = 0;
+    int cacheBlocks = 2;
+
+    /**
+     * @brief l2Cache/l3Cache
+     * Unified second and third level caches, backing the first level caches and the L2 cache respectively. Their
+     * configurations are given as per cacheLines/Ways/Blocks; an L3 cache requires an L2 cache. Lower levels are not
+     * simulated by cache sweeps.
+     */
+    struct LowerCacheLevel {
+        bool enabled;
+        int lines;
+        int ways;
+        int blocks;
+    };
+    LowerCacheLevel l2Cache = {false, 8, 2, 3};
+    LowerCacheLevel l3Cache = {false, 10, 3, 3};
+
+    /**
+     * @brief hitLatencies/memoryLatency
+     * Hit latencies in cycles of the L1, L2 and L3 caches, and latency of the memory behind the last level, from which
+     * the average memory access times of the caches are computed.
+     */
+    unsigned hitLatencies[3] = {1, 10, 30};
+    unsigned memoryLatency = 100;
+
+    /**
+     * @brief cacheWarmup/cacheWindow
+     * Warm-up of the simulated caches, whose accesses are excluded from the reported cache statistics (see
+     * CacheSim::Warmup). If a window of cycles [first; last] is given, the cache statistics are instead reported over
+     * the accesses of that window, as read from the access traces of the caches.
+     */
+    CacheSim::Warmup cacheWarmup;
+    std::optional<std::pair<uint64_t, uint64_t>> cacheWindow;
+
+    /**
+     * @brief dram/dramConfig
+     * If set, the last level caches are backed by a DRAM of banks and row buffers (see DRAMModel) rather than a memory
+     * of memoryLatency cycles.
+     */
+    bool dram = false;
+    DRAMModel::Config dramConfig;
+
+    /**
+     * @brief instrTLB/dataTLB/tlbConfig
+     * Sv32 TLBs in front of the instruction and data memories, both configured as per tlbConfig (see TLBSim). The
+     * processor is stalled for the page walks of TLB misses, if it models memory stalls.
+     */
+    bool instrTLB = false;
+    bool dataTLB = false;
+    TLBSim::Config tlbConfig;
+};
+
+struct TLBStatistics {
+    bool enabled = false;
+    unsigned entries = 0;
+    uint64_t reach = 0;
+    uint64_t hits = 0;
+    uint64_t microHits = 0;
+    uint64_t misses = 0;
+    double hitRate = 0;
+    uint64_t walkCycles = 0;
+};
+
+struct CacheStatistics {
+    bool enabled = false;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t writebacks = 0;
+    double hitRate = 0;
+    /// Average memory access time in cycles, including the lower levels of the cache
+    double averageAccessTime = 0;
+};
+
+/**
+ * @brief The HeadlessResult struct
+ * Outcome and statistics of a simulation executed through simulate().
+ */
+struct HeadlessResult {
+    /**
+     * @brief error
+     * Set if the program could not be loaded. No simulation has been performed in this case.
+     */
+    QString error;
+
+    bool finished = false;
+    /// Set if a memory access trace was replayed; only the cache statistics apply in this case.
+    bool replayed = false;
+    bool cycleLimitReached = false;
+    bool timeLimitReached = false;
+    /// Set if the simulation was stopped by the progress function given to simulate()
+    bool cancelled = false;
+
+    /**
+     * @brief cycles/instructionsRetired
+     * Totals of the execution. For sampled simulations, cycles is the extrapolated cycle count.
+     */
+    long long cycles = 0;
+    long long instructionsRetired = 0;
+    qint64 wallTimeMs = 0;
+
+    /**
+     * @brief sampled
+     * Set for sampled simulations, alongside the number of detailed windows and the cycles and instructions retired
+     * within them.
+     */
+    bool sampled = false;
+    unsigned windows = 0;
+    long long detailedCycles = 0;
+    long long detailedInstructions = 0;
+
+    /// Statistics of the branch predictor, if the simulated processor predicts branches and was not run functionally
+    std::optional<vsrtl::core::BranchPredictionStatistics> branchPrediction;
+    /// Stall statistics of the multi-cycle functional units, if modelled by the simulated processor
+    std::optional<vsrtl::core::FunctionalUnitStatistics> functionalUnits;
+    /// Breakdown of the hazards and stalls, if counted by the simulated processor
+    std::optional<vsrtl::core::HazardStatistics> hazards;
+
+    CacheStatistics dataCache;
+    CacheStatistics instrCache;
+    CacheStatistics l2Cache;
+    CacheStatistics l3Cache;
+    /// Statistics of the DRAM behind the caches, if simulated
+    std::optional<DRAMModel::Statistics> dram;
+    TLBStatistics instrTLB;
+    TLBStatistics dataTLB;
+    /// Results of a cache sweep, one per swept configuration
+    std::vector<CacheSweepResult> sweep;
+
+    /// Instructions retired by each hart of a multi-hart simulation, summing to instructionsRetired
+    std::vector<long long> hartInstructions;
+    /// Statistics of the coherent L1 data cache of each hart, and the most contended blocks, of a multi-hart simulation
+    std::vector<CoherenceModel::HartStatistics> coherence;
+    std::vector<CoherenceModel::LineStatistics> coherenceLines;
+
+    /// Values of the architectural registers once the simulation stopped
+    std::vector<uint32_t> registers;
+
+    /// Number of jobs which were simulated in lockstep, including this one (see simulateLockstep); 0 if simulated alone
+    unsigned lockstepLanes = 0;
+
+    /**
+     * @brief output
+     * Output printed by the program through system calls, if no print function was provided to simulate().
+     */
+    QString output;
+};
+
+/**
+ * @brief parseProcessorID
+ * Parses a processor name as given on the command line (ie. "RV5S") into a ProcessorID.
+ * @returns false if @p name does not identify a processor.
+ */
+bool parseProcessorID(const QString& name, ProcessorID& id);
+
+/**
+ * @brief processorName
+ * @returns the command line name of processor @p id (ie. "RV5S").
+ */
+QString processorName(ProcessorID id);
+
+/**
+ * @brief parseFileType
+ * Parses a file type as given on the command line ('asm', 'bin', 'elf', 'ihex' or 'srec'). If @p type is empty, the
+ * type is inferred from the extension of @p filepath.
+ * @returns false if @p type does not identify a file type.
+ */
+bool parseFileType(const QString& type, const QString& filepath, FileType& fileType);
+
+/**
+ * @brief parseCacheConfig
+ * Parses a cache configuration given as "<lines>,<ways>,<blocks>" into @p options.
+ * @returns false if @p config is malformed.
+ */
+bool parseCacheConfig(const QString& config, HeadlessOptions& options);
+/// Parses a cache configuration given as "<lines>,<ways>,<blocks>" into the lower level cache @p level, enabling it
+bool parseCacheConfig(const QString& config, HeadlessOptions::LowerCacheLevel& level);
+
+/**
+ * @brief parseDRAMConfig
+ * Parses a DRAM configuration given as "<banks>,<row size>,<policy>,<tRCD>,<tCAS>,<tRP>" into @p options, with the
+ * number of banks and the row size in bytes given as log2, policy as open or closed, and the timings in cycles.
+ * @returns false if @p config is malformed.
+ */
+bool parseDRAMConfig(const QString& config, HeadlessOptions& options);
+
+/**
+ * @brief parseTLBConfig
+ * Parses a TLB configuration given as "<sets>,<ways>,<replacement>,<walk latency>" into @p options, with sets and ways
+ * given as log2, and replacement as one of lru, random, plru, fifo, lfu or srrip.
+ * @returns false if @p config is malformed.
+ */
+bool parseTLBConfig(const QString& config, HeadlessOptions& options);
+
+/**
+ * @brief parseCacheLatencies
+ * Parses the hit latencies of the cache levels and the memory latency, given as "<l1>,<l2>,<l3>,<memory>", into
+ * @p options.
+ * @returns false if @p latencies is malformed.
+ */
+bool parseCacheLatencies(const QString& latencies, HeadlessOptions& options);
+
+/**
+ * @brief parseCacheWarmup
+ * Parses the warm-up of the caches, given as "none", "cycles:<n>", "accesses:<n>" or "pc:<address>", into @p options.
+ * @returns false if @p warmup is malformed.
+ */
+bool parseCacheWarmup(const QString& warmup, HeadlessOptions& options);
+
+/**
+ * @brief parseCacheWindow
+ * Parses the window of cycles over which cache statistics are reported, given as "<first>,<last>", into @p options.
+ * @returns false if @p window is malformed, or first follows last.
+ */
+bool parseCacheWindow(const QString& window, HeadlessOptions& options);
+
+/**
+ * @brief parseUnitLatencies
+ * Parses the latencies of the multiplier and divider, given as "<mul>,<div>", into @p options.
+ * @returns false if @p latencies is malformed, or either latency is 0.
+ */
+bool parseUnitLatencies(const QString& latencies, HeadlessOptions& options);
+
+/**
+ * @brief loadProgram
+ * Loads the program file described by the filepath, type, binaryEntryPoint and binaryLoadAt of @p options into
+ * @p program.
+ * @returns false if the file could not be loaded.
+ */
+bool loadProgram(const HeadlessOptions& options, Program& program);
+
+/**
+ * @brief simulate
+ * Loads and executes the program described by @p options within a simulation context of its own. Output of the
+ * program is forwarded to @p print if provided, and otherwise collected in the returned result. Independent
+ * simulations may be executed concurrently from separate threads.
+ * @p progress, if provided, is called from the simulating thread every s_progressInterval cycles of a detailed,
+ * unsampled simulation, with the statistics of the simulation so far. Returning false stops the simulation.
+ */
+HeadlessResult simulate(const HeadlessOptions& options, const std::function<void(const QString&)>& print = {},
+                        const std::function<bool(const HeadlessResult&)>& progress = {});
+constexpr unsigned s_progressInterval = 1 << 16;
+
+/**
+ * @brief simulate
+ * As above, within the simulation context @p context rather than a context of its own. Processors constructed by a
+ * context are kept in its processor pool across simulations, such that later simulations on the same processor only
+ * reset it. A context must only be used by the thread which constructed it.
+ */
+HeadlessResult simulate(ProcessorHandler& context, const HeadlessOptions& options,
+                        const std::function<void(const QString&)>& print = {},
+                        const std::function<bool(const HeadlessResult&)>& progress = {});
+
+/**
+ * @brief simulateLockstep
+ * Simulates @p jobs functionally in lockstep (see LockstepSystem). The jobs must only differ in their register and data
+ * inputs; the program, processor, cycle and time limits of the first job apply to all. Jobs which stop at a system
+ * call which is not supported in lockstep are simulated anew through simulate().
+ * @returns the results of the jobs, in the order of @p jobs.
+ */
+std::vector<HeadlessResult> simulateLockstep(const std::vector<HeadlessOptions>& jobs);
+
+/**
+ * @brief runHeadless
+ * Loads, executes and reports statistics for the program described by @p options to stdout.
+ * @returns a process exit code.
+ */
+int runHeadless(const HeadlessOptions& options);
+
+}  // namespace Ripes
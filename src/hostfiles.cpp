@@ -0,0 +1,111 @@
+#include "hostfiles.h"
+
+#include <QFileInfo>
+
+namespace Ripes {
+
+void HostFiles::setSandbox(const QString& directory) {
+    closeAll();
+    m_sandbox = QDir(QDir(directory).absolutePath());
+}
+
+int HostFiles::open(const QString& path, int flags) {
+    if (QDir::isAbsolutePath(path)) {
+        return -1;
+    }
+    // Symbolic links are resolved before the path is checked against the sandbox. A file which is yet to be created is
+    // resolved through its directory, whereas a dangling link cannot be resolved, and is rejected.
+    const QFileInfo info(QDir::cleanPath(m_sandbox.absoluteFilePath(path)));
+    QString filePath;
+    if (info.exists() || info.isSymLink()) {
+        filePath = info.canonicalFilePath();
+    } else {
+        const QString directory = QFileInfo(info.absolutePath()).canonicalFilePath();
+        filePath = directory.isEmpty() ? QString() : QDir(directory).filePath(info.fileName());
+    }
+    QString sandbox = m_sandbox.canonicalPath();
+    if (filePath.isEmpty() || sandbox.isEmpty()) {
+        return -1;
+    }
+    if (!sandbox.endsWith('/')) {
+        // Only the root directory ends in a separator
+        sandbox += '/';
+    }
+    if (!filePath.startsWith(sandbox)) {
+        // The path escapes the sandbox
+        return -1;
+    }
+
+    QIODevice::OpenMode mode;
+    switch (flags) {
+        case OpenFlags::ReadOnly:
+            mode = QIODevice::ReadOnly;
+            break;
+        case OpenFlags::WriteOnly:
+            mode = QIODevice::WriteOnly | QIODevice::Truncate;
+            break;
+        case OpenFlags::Append:
+            mode = QIODevice::WriteOnly | QIODevice::Append;
+            break;
+        default:
+            return -1;
+    }
+
+    auto file = std::make_unique<QFile>(filePath);
+    if (!file->open(mode)) {
+        return -1;
+    }
+    const int fd = m_nextFd++;
+    m_files[fd] = std::move(file);
+    return fd;
+}
+
+QFile* HostFiles::file(int fd) const {
+    const auto it = m_files.find(fd);
+    return it == m_files.end() ? nullptr : it->second.get();
+}
+
+int HostFiles::read(int fd, char* data, int length) {
+    auto* f = file(fd);
+    return f && length >= 0 ? static_cast<int>(f->read(data, length)) : -1;
+}
+
+int HostFiles::write(int fd, const char* data, int length) {
+    auto* f = file(fd);
+    return f && length >= 0 ? static_cast<int>(f->write(data, length)) : -1;
+}
+
+int HostFiles::seek(int fd, int offset, int whence) {
+    auto* f = file(fd);
+    if (!f) {
+        return -1;
+    }
+
+    qint64 base;
+    switch (whence) {
+        case Whence::Set:
+            base = 0;
+            break;
+        case Whence::Current:
+            base = f->pos();
+            break;
+        case Whence::End:
+            base = f->size();
+            break;
+        default:
+            return -1;
+    }
+    const qint64 pos = base + offset;
+    return pos >= 0 && f->seek(pos) ? static_cast<int>(pos) : -1;
+}
+
+int HostFiles::close(int fd) {
+    return m_files.erase(fd) != 0 ? 0 : -1;
+}
+
+void HostFiles::closeAll() {
+    m_files.clear();
+    m_nextFd = 3;
+}
+
+}  // namespace Ripes
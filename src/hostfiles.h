@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QDir>
+#include <QFile>
+
+#include <map>
+#include <memory>
+
+namespace Ripes {
+
+/**
+ * @brief The HostFiles class
+ * Table of host files opened by a simulated program through file system calls. File descriptors handed to the program
+ * start at 3; descriptors 0-2 are reserved for the standard streams, which are handled by the caller. All paths are
+ * resolved relative to a sandbox directory, and paths resolving to a location outside of it once symbolic links are
+ * resolved are rejected. Files are accessed through buffered QFile objects.
+ */
+class HostFiles {
+public:
+    /// Flags accepted by open(), as defined by RARS
+    enum OpenFlags { ReadOnly = 0, WriteOnly = 1, Append = 9 };
+    /// Origins accepted by seek(), as defined for lseek
+    enum Whence { Set = 0, Current = 1, End = 2 };
+
+    /**
+     * @brief setSandbox
+     * Sets the directory which all paths are resolved relative to. Closes any open files.
+     */
+    void setSandbox(const QString& directory);
+    const QDir& getSandbox() const { return m_sandbox; }
+
+    /**
+     * @brief open
+     * Opens @param path with @param flags.
+     * @returns the file descriptor of the opened file, or -1 on failure.
+     */
+    int open(const QString& path, int flags);
+
+    /**
+     * @brief read/write
+     * Reads/writes up to @param length bytes from/to the file of @param fd.
+     * @returns the number of bytes transferred, or -1 on failure.
+     */
+    int read(int fd, char* data, int length);
+    int write(int fd, const char* data, int length);
+
+    /**
+     * @brief seek
+     * Moves the position of the file of @param fd to @param offset relative to @param whence.
+     * @returns the resulting position, or -1 on failure.
+     */
+    int seek(int fd, int offset, int whence);
+
+    /**
+     * @brief close
+     * @returns 0 if @param fd referred to an open file, else -1.
+     */
+    int close(int fd);
+    void closeAll();
+
+private:
+    QFile* file(int fd) const;
+
+    QDir m_sandbox = QDir::current();
+    std::map<int, std::unique_ptr<QFile>> m_files;
+    int m_nextFd = 3;
+};
+
+}  // namespace Ripes
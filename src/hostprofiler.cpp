@@ -0,0 +1,164 @@
+#include "hostprofiler.h"
+
+#include <QFile>
+#include <QTextStream>
+
+#include <algorithm>
+#include <map>
+
+namespace Ripes {
+
+std::atomic<bool> HostProfiler::s_enabled = false;
+const std::chrono::steady_clock::time_point HostProfiler::s_epoch = std::chrono::steady_clock::now();
+std::mutex HostProfiler::s_buffersMutex;
+std::vector<std::shared_ptr<HostProfiler::ThreadBuffer>> HostProfiler::s_buffers;
+
+namespace {
+
+/// Merges the per-thread aggregates @p from into @p into, by name
+template <typename T, typename F>
+void mergeByName(std::map<QString, HostProfiler::Entry>& into, const std::unordered_map<const char*, T>& from,
+                 F&& merge) {
+    for (const auto& it : from) {
+        auto& entry = into[QString(it.first)];
+        entry.name = QString(it.first);
+        merge(entry, it.second);
+    }
+}
+
+QString jsonString(const QString& str) {
+    QString escaped = str;
+    escaped.replace('\\', "\\\\").replace('"', "\\\"");
+    return '"' + escaped + '"';
+}
+
+}  // namespace
+
+HostProfiler::ThreadBuffer& HostProfiler::threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        buffer->id = static_cast<unsigned>(s_buffers.size()) + 1;
+        s_buffers.push_back(buffer);
+        return buffer;
+    }();
+    return *buffer;
+}
+
+void HostProfiler::setEnabled(bool enabled) {
+    if (enabled) {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        for (const auto& buffer : s_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->events.clear();
+            buffer->scopes.clear();
+            buffer->counters.clear();
+        }
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void HostProfiler::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    auto& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    auto& aggregate = buffer.scopes[name];
+    aggregate.count++;
+    aggregate.totalNs += endNs - startNs;
+    if (buffer.events.size() < s_maxEvents) {
+        buffer.events.push_back({name, startNs, endNs - startNs});
+    }
+}
+
+void HostProfiler::count(const char* name, unsigned long long n) {
+    auto& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.counters[name] += n;
+}
+
+std::vector<HostProfiler::Entry> HostProfiler::scopes() {
+    std::map<QString, Entry> merged;
+    {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        for (const auto& buffer : s_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            mergeByName(merged, buffer->scopes, [](Entry& entry, const Aggregate& aggregate) {
+                entry.count += aggregate.count;
+                entry.totalNs += aggregate.totalNs;
+            });
+        }
+    }
+    std::vector<Entry> entries;
+    for (auto& it : merged) {
+        entries.push_back(std::move(it.second));
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.totalNs > b.totalNs; });
+    return entries;
+}
+
+std::vector<HostProfiler::Entry> HostProfiler::counters() {
+    std::map<QString, Entry> merged;
+    {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        for (const auto& buffer : s_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            mergeByName(merged, buffer->counters,
+                        [](Entry& entry, unsigned long long count) { entry.count += count; });
+        }
+    }
+    std::vector<Entry> entries;
+    for (auto& it : merged) {
+        entries.push_back(std::move(it.second));
+    }
+    return entries;
+}
+
+unsigned long long HostProfiler::counter(const char* name) {
+    const QString key(name);
+    for (const auto& entry : counters()) {
+        if (entry.name == key) {
+            return entry.count;
+        }
+    }
+    return 0;
+}
+
+bool HostProfiler::writeChromeTrace(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    uint64_t endNs = 0;
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (const auto& buffer : s_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const auto& event : buffer->events) {
+            // Trace event timestamps and durations are given in microseconds
+            out << (first ? "" : ",\n") << "{\"name\":" << jsonString(event.name)
+                << ",\"cat\":\"ripes\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << QString::number(event.startNs / 1000.0, 'f', 3)
+                << ",\"dur\":" << QString::number(event.durationNs / 1000.0, 'f', 3) << "}";
+            first = false;
+            endNs = std::max(endNs, event.startNs + event.durationNs);
+        }
+    }
+    std::map<QString, unsigned long long> counterTotals;
+    for (const auto& buffer : s_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const auto& it : buffer->counters) {
+            counterTotals[QString(it.first)] += it.second;
+        }
+    }
+    for (const auto& it : counterTotals) {
+        out << (first ? "" : ",\n") << "{\"name\":" << jsonString(it.first)
+            << ",\"cat\":\"ripes\",\"ph\":\"C\",\"pid\":1,\"ts\":" << QString::number(endNs / 1000.0, 'f', 3)
+            << ",\"args\":{\"total\":" << it.second << "}}";
+        first = false;
+    }
+    out << "\n]}\n";
+    return out.status() == QTextStream::Ok;
+}
+
+}  // namespace Ripes
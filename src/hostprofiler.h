@@ -0,0 +1,139 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The HostProfiler class
+ * Instrumentation of the host time spent within the hot paths of the simulator itself. Scopes are timed through
+ * RIPES_PROFILE_SCOPE and events counted through RIPES_PROFILE_COUNT, both of which compile to nothing unless Ripes is
+ * built with RIPES_HOST_PROFILER, and otherwise reduce to a relaxed atomic load while profiling is disabled.
+ *
+ * Timed scopes and counters are aggregated per name, and timed scopes are additionally recorded as Chrome trace events
+ * (viewable in chrome://tracing or Perfetto), up to s_maxEvents per thread. Recording is performed into buffers of the
+ * recording thread, such that threads only contend with readers of the profile.
+ */
+class HostProfiler {
+public:
+    static constexpr size_t s_maxEvents = 1 << 20;
+
+    /// @returns true if Ripes was built with the host profiler
+    static constexpr bool available() {
+#ifdef RIPES_HOST_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    /// Starts or stops profiling. Starting clears the previous profile.
+    static void setEnabled(bool enabled);
+
+    struct Entry {
+        QString name;
+        unsigned long long count = 0;
+        // Total time spent within the scope, in nanoseconds; 0 for counters
+        unsigned long long totalNs = 0;
+    };
+
+    /// @returns the aggregated timed scopes, by descending total time, and counters of the current profile
+    static std::vector<Entry> scopes();
+    static std::vector<Entry> counters();
+    /// @returns the number of occurrences of counter @p name within the current profile
+    static unsigned long long counter(const char* name);
+
+    /**
+     * @brief writeChromeTrace
+     * Writes the recorded scopes of the current profile to @p path as a Chrome trace event file, with the totals of the
+     * counters recorded at the end of the trace.
+     * @returns false if the file could not be written.
+     */
+    static bool writeChromeTrace(const QString& path);
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch)
+            .count();
+    }
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+    static void count(const char* name, unsigned long long n);
+
+    /**
+     * @brief The Scope class
+     * Times its own lifetime, if profiling is enabled upon construction. @p name must be a string literal.
+     */
+    class Scope {
+    public:
+        explicit Scope(const char* name) : m_name(enabled() ? name : nullptr) {
+            if (m_name) {
+                m_start = now();
+            }
+        }
+        ~Scope() {
+            if (m_name) {
+                record(m_name, m_start, now());
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_start = 0;
+    };
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+    };
+    struct Aggregate {
+        unsigned long long count = 0;
+        unsigned long long totalNs = 0;
+    };
+    /// Profile of a single thread. Names are string literals, and are keyed by their address.
+    struct ThreadBuffer {
+        std::mutex mutex;
+        unsigned id = 0;
+        std::vector<Event> events;
+        std::unordered_map<const char*, Aggregate> scopes;
+        std::unordered_map<const char*, unsigned long long> counters;
+    };
+    static ThreadBuffer& threadBuffer();
+
+    static std::atomic<bool> s_enabled;
+    static const std::chrono::steady_clock::time_point s_epoch;
+    static std::mutex s_buffersMutex;
+    // Buffers of all threads which have recorded to the profiler. Buffers outlive their threads.
+    static std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+};
+
+}  // namespace Ripes
+
+#define RIPES_PROFILE_CONCAT_(a, b) a##b
+#define RIPES_PROFILE_CONCAT(a, b) RIPES_PROFILE_CONCAT_(a, b)
+
+#ifdef RIPES_HOST_PROFILER
+#define RIPES_PROFILE_SCOPE(name) const Ripes::HostProfiler::Scope RIPES_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define RIPES_PROFILE_COUNT(name, n)             \
+    do {                                         \
+        if (Ripes::HostProfiler::enabled()) {    \
+            Ripes::HostProfiler::count(name, n); \
+        }                                        \
+    } while (false)
+#else
+#define RIPES_PROFILE_SCOPE(name)
+#define RIPES_PROFILE_COUNT(name, n) \
+    do {                             \
+    } while (false)
+#endif
@@ -0,0 +1,156 @@
+#include "hotspotsmodel.h"
+
+#include <map>
+
+namespace Ripes {
+
+HotSpotsModel::HotSpotsModel(ProcessorHandler* context, QObject* parent)
+    : QAbstractTableModel(parent), m_context(context) {
+    refresh();
+}
+
+QVariant HotSpotsModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+        case Column::Location:
+            switch (m_grouping) {
+                case Grouping::Instruction:
+                    return "Instruction";
+                case Grouping::InstructionClass:
+                    return "Class";
+                case Grouping::Symbol:
+                    return "Symbol";
+            }
+            return QVariant();
+        case Column::Retired:
+            return "Retired";
+        case Column::StallCycles:
+            return "Stall cycles";
+        case Column::CyclePercentage:
+            return "Cycles (%)";
+        default:
+            return QVariant();
+    }
+}
+
+int HotSpotsModel::rowCount(const QModelIndex&) const {
+    return static_cast<int>(m_hotSpots.size());
+}
+
+int HotSpotsModel::columnCount(const QModelIndex&) const {
+    return NColumns;
+}
+
+void HotSpotsModel::setGrouping(Grouping grouping) {
+    m_grouping = grouping;
+    refresh();
+    emit headerDataChanged(Qt::Horizontal, Column::Location, Column::Location);
+}
+
+void HotSpotsModel::refresh() {
+    beginResetModel();
+    m_hotSpots.clear();
+    const auto& profiler = m_context->getProfiler();
+    m_totalCost = profiler.totalCost();
+    if (m_context->getProgram()) {
+        switch (m_grouping) {
+            case Grouping::Instruction:
+                gatherInstructions();
+                break;
+            case Grouping::InstructionClass:
+                gatherInstructionClasses();
+                break;
+            case Grouping::Symbol:
+                m_hotSpots = profiler.symbolHotSpots(*m_context->getProgram());
+                break;
+        }
+    }
+    endResetModel();
+}
+
+void HotSpotsModel::gatherInstructions() {
+    const auto& profiler = m_context->getProfiler();
+    const auto& entries = profiler.entries();
+    for (unsigned i = 0; i < entries.size(); i++) {
+        if (entries[i].cost() == 0) {
+            continue;
+        }
+        CycleProfiler::HotSpot hotSpot;
+        hotSpot.address = profiler.getTextStart() + i * 4;
+        hotSpot.name = "0x" + QString::number(hotSpot.address, 16).rightJustified(8, '0') + ": " +
+                       m_context->parseInstrAt(hotSpot.address);
+        hotSpot.entry = entries[i];
+        m_hotSpots.push_back(hotSpot);
+    }
+}
+
+void HotSpotsModel::gatherInstructionClasses() {
+    // Instructions are classified by their mnemonic
+    const auto& profiler = m_context->getProfiler();
+    const auto& entries = profiler.entries();
+    std::map<QString, CycleProfiler::HotSpot> classes;
+    for (unsigned i = 0; i < entries.size(); i++) {
+        if (entries[i].cost() == 0) {
+            continue;
+        }
+        const uint32_t address = profiler.getTextStart() + i * 4;
+        const QString mnemonic = m_context->parseInstrAt(address).simplified().section(' ', 0, 0);
+        auto it = classes.find(mnemonic);
+        if (it == classes.end()) {
+            CycleProfiler::HotSpot hotSpot;
+            hotSpot.name = mnemonic;
+            hotSpot.address = address;
+            it = classes.emplace(mnemonic, hotSpot).first;
+        }
+        it->second.entry.retired += entries[i].retired;
+        it->second.entry.stallCycles += entries[i].stallCycles;
+    }
+    for (const auto& hotSpot : classes) {
+        m_hotSpots.push_back(hotSpot.second);
+    }
+}
+
+QVariant HotSpotsModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid())
+        return QVariant();
+
+    const auto& hotSpot = m_hotSpots.at(index.row());
+    const double percentage = m_totalCost == 0 ? 0 : 100.0 * hotSpot.entry.cost() / m_totalCost;
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == Column::Location ? QVariant(Qt::AlignLeft | Qt::AlignVCenter)
+                                                  : QVariant(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    if (role == Qt::UserRole) {
+        switch (index.column()) {
+            case Column::Location:
+                return m_grouping == Grouping::Instruction ? QVariant(hotSpot.address) : QVariant(hotSpot.name);
+            case Column::Retired:
+                return hotSpot.entry.retired;
+            case Column::StallCycles:
+                return hotSpot.entry.stallCycles;
+            case Column::CyclePercentage:
+                return percentage;
+            default:
+                return QVariant();
+        }
+    }
+
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (index.column()) {
+        case Column::Location:
+            return hotSpot.name;
+        case Column::Retired:
+            return QString::number(hotSpot.entry.retired);
+        case Column::StallCycles:
+            return QString::number(hotSpot.entry.stallCycles);
+        case Column::CyclePercentage:
+            return QString::number(percentage, 'f', 2);
+        default:
+            return QVariant();
+    }
+}
+}  // namespace Ripes
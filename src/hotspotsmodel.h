@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QAbstractTableModel>
+
+#include <vector>
+
+#include "cycleprofiler.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+/**
+ * @brief The HotSpotsModel class
+ * Table of the instructions, instruction classes or symbols of the loaded program to which the profile of the
+ * processor handler attributes cycles. Numeric columns provide their raw values through Qt::UserRole, for sorting.
+ */
+class HotSpotsModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { Location = 0, Retired = 1, StallCycles = 2, CyclePercentage = 3, NColumns };
+    enum class Grouping { Instruction, InstructionClass, Symbol };
+    HotSpotsModel(ProcessorHandler* context, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setGrouping(Grouping grouping);
+    /// @returns the address of the first profiled instruction of the hot spot at @p row
+    uint32_t addressForRow(int row) const { return m_hotSpots.at(row).address; }
+
+public slots:
+    void refresh();
+
+private:
+    void gatherInstructions();
+    void gatherInstructionClasses();
+
+    Grouping m_grouping = Grouping::Instruction;
+    std::vector<CycleProfiler::HotSpot> m_hotSpots;
+    long long m_totalCost = 0;
+
+    ProcessorHandler* m_context = nullptr;
+};
+}  // namespace Ripes
@@ -0,0 +1,60 @@
+#include "hotspotswidget.h"
+#include "ui_hotspotswidget.h"
+
+#include <QClipboard>
+#include <QHeaderView>
+#include <QSortFilterProxyModel>
+
+#include "hotspotsmodel.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+HotSpotsWidget::HotSpotsWidget(QWidget* parent) : QDialog(parent), m_ui(new Ui::HotSpotsWidget) {
+    m_ui->setupUi(this);
+
+    m_model = new HotSpotsModel(ProcessorHandler::get(), this);
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+    m_proxyModel->setSortRole(Qt::UserRole);
+    m_ui->hotSpotsView->setModel(m_proxyModel);
+    m_ui->hotSpotsView->setSortingEnabled(true);
+    m_ui->hotSpotsView->sortByColumn(HotSpotsModel::CyclePercentage, Qt::DescendingOrder);
+    m_ui->hotSpotsView->horizontalHeader()->setSectionResizeMode(HotSpotsModel::Location, QHeaderView::Stretch);
+    m_ui->hotSpotsView->verticalHeader()->setVisible(false);
+
+    m_ui->grouping->addItem("Instruction", static_cast<int>(HotSpotsModel::Grouping::Instruction));
+    m_ui->grouping->addItem("Instruction class", static_cast<int>(HotSpotsModel::Grouping::InstructionClass));
+    m_ui->grouping->addItem("Symbol", static_cast<int>(HotSpotsModel::Grouping::Symbol));
+    connect(m_ui->grouping, QOverload<int>::of(&QComboBox::currentIndexChanged), [=](int index) {
+        m_model->setGrouping(static_cast<HotSpotsModel::Grouping>(m_ui->grouping->itemData(index).toInt()));
+    });
+
+    const auto& profiler = ProcessorHandler::get()->getProfiler();
+    m_ui->summary->setText("Profiled since cycle " + QString::number(profiler.getStartCycle()) + "; " +
+                           QString::number(profiler.totalCost()) + " instructions retired and cycles stalled.");
+    m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
+}
+
+HotSpotsWidget::~HotSpotsWidget() {
+    delete m_ui;
+}
+
+void HotSpotsWidget::on_copy_clicked() {
+    // Copy the table to the clipboard in its current order, including headers
+    QString textualRepr;
+    for (int j = 0; j < m_proxyModel->columnCount(); j++) {
+        textualRepr.append(m_proxyModel->headerData(j, Qt::Horizontal).toString());
+        textualRepr.append('\t');
+    }
+    textualRepr.append('\n');
+    for (int i = 0; i < m_proxyModel->rowCount(); i++) {
+        for (int j = 0; j < m_proxyModel->columnCount(); j++) {
+            textualRepr.append(m_proxyModel->data(m_proxyModel->index(i, j)).toString());
+            textualRepr.append('\t');
+        }
+        textualRepr.append('\n');
+    }
+    QApplication::clipboard()->setText(textualRepr);
+}
+}  // namespace Ripes
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QDialog>
+
+QT_FORWARD_DECLARE_CLASS(QSortFilterProxyModel)
+
+namespace Ripes {
+class HotSpotsModel;
+namespace Ui {
+class HotSpotsWidget;
+}
+
+/**
+ * @brief The HotSpotsWidget class
+ * Sortable table of the hot spots of the profile of the loaded program, grouped by instruction, instruction class or
+ * symbol.
+ */
+class HotSpotsWidget : public QDialog {
+    Q_OBJECT
+
+public:
+    HotSpotsWidget(QWidget* parent = nullptr);
+    ~HotSpotsWidget() override;
+
+private slots:
+    void on_copy_clicked();
+
+private:
+    Ui::HotSpotsWidget* m_ui = nullptr;
+    HotSpotsModel* m_model = nullptr;
+    QSortFilterProxyModel* m_proxyModel = nullptr;
+};
+}  // namespace Ripes
@@ -0,0 +1,122 @@
+#include "instructionmix.h"
+
+#include <numeric>
+
+#include "processors/RISC-V/rv_decode.h"
+
+namespace Ripes {
+
+InstructionMix::InstructionMix() : m_counts(opcodeCount(), 0) {}
+
+void InstructionMix::setProgram(const Program* program) {
+    m_opcodes.clear();
+    m_textStart = 0;
+    if (const auto* text = program ? program->getSection(TEXT_SECTION_NAME) : nullptr) {
+        m_textStart = static_cast<uint32_t>(text->address);
+        const auto* data = reinterpret_cast<const uint8_t*>(text->data.constData());
+        const size_t count = static_cast<size_t>(text->data.size()) / 4;
+        m_opcodes.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            const uint32_t instr = data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16) |
+                                   (static_cast<uint32_t>(data[i * 4 + 3]) << 24);
+            m_opcodes[i] = static_cast<uint8_t>(vsrtl::core::Decode::decodeInstr(instr));
+        }
+    }
+    clear();
+}
+
+void InstructionMix::clear() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+}
+
+std::vector<long long> InstructionMix::categoryCounts() const {
+    std::vector<long long> counts(static_cast<unsigned>(Category::NCategories), 0);
+    for (unsigned opcode = 0; opcode < m_counts.size(); opcode++) {
+        counts[static_cast<unsigned>(categoryOf(opcode))] += m_counts[opcode];
+    }
+    return counts;
+}
+
+long long InstructionMix::total() const {
+    return std::accumulate(m_counts.begin(), m_counts.end(), 0LL);
+}
+
+unsigned InstructionMix::opcodeCount() {
+    static_assert(RVInstr::_size() <= UINT8_MAX + 1, "Opcodes are stored as bytes");
+    return RVInstr::_size();
+}
+
+QString InstructionMix::opcodeName(unsigned opcode) {
+    return opcode == RVInstr::NOP ? QString("unknown") : QString(RVInstr::_names()[opcode]).toLower();
+}
+
+InstructionMix::Category InstructionMix::categoryOf(unsigned opcode) {
+    switch (opcode) {
+        case RVInstr::LB:
+        case RVInstr::LH:
+        case RVInstr::LW:
+        case RVInstr::LBU:
+        case RVInstr::LHU:
+            return Category::Load;
+        case RVInstr::SB:
+        case RVInstr::SH:
+        case RVInstr::SW:
+            return Category::Store;
+        case RVInstr::BEQ:
+        case RVInstr::BNE:
+        case RVInstr::BLT:
+        case RVInstr::BGE:
+        case RVInstr::BLTU:
+        case RVInstr::BGEU:
+            return Category::Branch;
+        case RVInstr::JAL:
+        case RVInstr::JALR:
+            return Category::Jump;
+        case RVInstr::MUL:
+        case RVInstr::MULH:
+        case RVInstr::MULHSU:
+        case RVInstr::MULHU:
+        case RVInstr::DIV:
+        case RVInstr::DIVU:
+        case RVInstr::REM:
+        case RVInstr::REMU:
+            return Category::MulDiv;
+        case RVInstr::ECALL:
+            return Category::Ecall;
+        case RVInstr::NOP:
+        case RVInstr::CSRRW:
+        case RVInstr::CSRRS:
+        case RVInstr::CSRRC:
+        case RVInstr::CSRRWI:
+        case RVInstr::CSRRSI:
+        case RVInstr::CSRRCI:
+            return Category::Other;
+        default:
+            return Category::ALU;
+    }
+}
+
+QString InstructionMix::categoryName(Category category) {
+    switch (category) {
+        case Category::ALU:
+            return "ALU";
+        case Category::Load:
+            return "Load";
+        case Category::Store:
+            return "Store";
+        case Category::Branch:
+            return "Branch";
+        case Category::Jump:
+            return "Jump";
+        case Category::MulDiv:
+            return "M extension";
+        case Category::Ecall:
+            return "Ecall";
+        case Category::Other:
+        case Category::NCategories:
+            break;
+    }
+    return "Other";
+}
+
+}  // namespace Ripes
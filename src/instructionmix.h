@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * @brief The InstructionMix class
+ * Counts the retired instructions of the loaded program per instruction (RVInstr). The instructions of the text
+ * section are decoded once per program into a flat array of opcodes, such that retiring an instruction costs a single
+ * lookup and increment. Instructions retired outside of the text section, or which do not decode, are counted as
+ * unknown.
+ */
+class InstructionMix {
+public:
+    enum class Category { ALU, Load, Store, Branch, Jump, MulDiv, Ecall, Other, NCategories };
+
+    InstructionMix();
+
+    /**
+     * @brief setProgram
+     * Decodes the text section of @p program, or no instructions if nullptr, discarding all counts.
+     */
+    void setProgram(const Program* program);
+    void clear();
+
+    /// Records the retirement of the instruction at @p pc
+    void retire(uint32_t pc) { m_counts[opcodeAt(pc)]++; }
+    /// Removes the retirement of the instruction at @p pc, once reversed past
+    void unretire(uint32_t pc) { m_counts[opcodeAt(pc)]--; }
+
+    /// @returns the number of retired instructions of each opcode, indexed by RVInstr; the unknown instructions at 0
+    const std::vector<long long>& counts() const { return m_counts; }
+    /// @returns the number of retired instructions of each category, indexed by Category
+    std::vector<long long> categoryCounts() const;
+    long long total() const;
+
+    static unsigned opcodeCount();
+    /// @returns the mnemonic of @p opcode, or "unknown"
+    static QString opcodeName(unsigned opcode);
+    static Category categoryOf(unsigned opcode);
+    static QString categoryName(Category category);
+
+private:
+    uint8_t opcodeAt(uint32_t pc) const {
+        const uint32_t offset = pc - m_textStart;
+        return (offset & 0b11) == 0 && (offset >> 2) < m_opcodes.size() ? m_opcodes[offset >> 2] : 0;
+    }
+
+    uint32_t m_textStart = 0;
+    std::vector<uint8_t> m_opcodes;
+    std::vector<long long> m_counts;
+};
+
+}  // namespace Ripes
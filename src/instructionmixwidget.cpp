@@ -0,0 +1,102 @@
+#include "instructionmixwidget.h"
+#include "ui_instructionmixwidget.h"
+
+#include <QClipboard>
+#include <QtCharts/QBarCategoryAxis>
+#include <QtCharts/QBarSet>
+#include <QtCharts/QChartView>
+#include <QtCharts/QHorizontalBarSeries>
+#include <QtCharts/QValueAxis>
+#include <algorithm>
+
+#include "instructionmix.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+InstructionMixWidget::InstructionMixWidget(QWidget* parent) : QDialog(parent), m_ui(new Ui::InstructionMixWidget) {
+    m_ui->setupUi(this);
+
+    m_ui->grouping->addItem("Category");
+    m_ui->grouping->addItem("Instruction");
+    connect(m_ui->grouping, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            &InstructionMixWidget::updatePlot);
+
+    m_chartView = new QChartView(this);
+    m_chartView->setRenderHint(QPainter::Antialiasing);
+    m_ui->chartLayout->addWidget(m_chartView);
+
+    m_ui->summary->setText(QString::number(ProcessorHandler::get()->getInstructionMix().total()) +
+                           " instructions retired.");
+    m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
+    updatePlot();
+}
+
+InstructionMixWidget::~InstructionMixWidget() {
+    delete m_ui;
+}
+
+std::vector<std::pair<QString, long long>> InstructionMixWidget::bars() const {
+    const auto& mix = ProcessorHandler::get()->getInstructionMix();
+    std::vector<std::pair<QString, long long>> bars;
+    if (m_ui->grouping->currentIndex() == 0) {
+        const auto counts = mix.categoryCounts();
+        for (unsigned i = 0; i < counts.size(); i++) {
+            bars.emplace_back(InstructionMix::categoryName(static_cast<InstructionMix::Category>(i)), counts[i]);
+        }
+    } else {
+        // Only the instructions which have been retired are plotted, most frequent first
+        const auto& counts = mix.counts();
+        for (unsigned i = 0; i < counts.size(); i++) {
+            if (counts[i] != 0) {
+                bars.emplace_back(InstructionMix::opcodeName(i), counts[i]);
+            }
+        }
+        std::stable_sort(bars.begin(), bars.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    }
+    return bars;
+}
+
+void InstructionMixWidget::updatePlot() {
+    const auto counts = bars();
+    const long long total = ProcessorHandler::get()->getInstructionMix().total();
+
+    QChart* chart = new QChart();
+    chart->setTitle("Dynamic instruction mix");
+    chart->legend()->hide();
+    auto* set = new QBarSet("Retired (%)");
+    QStringList categories;
+    // Horizontal bars are plotted bottom up; the first bar is placed at the top
+    for (auto it = counts.rbegin(); it != counts.rend(); it++) {
+        categories << it->first;
+        *set << (total == 0 ? 0 : 100.0 * it->second / total);
+    }
+    auto* series = new QHorizontalBarSeries(chart);
+    series->append(set);
+    chart->addSeries(series);
+
+    auto* axisY = new QBarCategoryAxis(chart);
+    axisY->append(categories);
+    chart->addAxis(axisY, Qt::AlignLeft);
+    series->attachAxis(axisY);
+    auto* axisX = new QValueAxis(chart);
+    axisX->setRange(0, 100);
+    axisX->setLabelFormat("%.0f  ");
+    axisX->setTitleText("Retired instructions (%)");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    series->attachAxis(axisX);
+
+    // The view takes ownership of the chart, but releases the chart which it replaces
+    QChart* previous = m_chartView->chart();
+    m_chartView->setChart(chart);
+    delete previous;
+}
+
+void InstructionMixWidget::on_copy_clicked() {
+    QString textualRepr = m_ui->grouping->currentText() + "\tRetired\n";
+    for (const auto& bar : bars()) {
+        textualRepr.append(bar.first + '\t' + QString::number(bar.second) + '\n');
+    }
+    QApplication::clipboard()->setText(textualRepr);
+}
+}  // namespace Ripes
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QDialog>
+#include <QtCharts/QChartGlobal>
+#include <vector>
+
+QT_CHARTS_BEGIN_NAMESPACE
+class QChartView;
+QT_CHARTS_END_NAMESPACE
+
+QT_CHARTS_USE_NAMESPACE
+
+namespace Ripes {
+namespace Ui {
+class InstructionMixWidget;
+}
+
+/**
+ * @brief The InstructionMixWidget class
+ * Bar chart of the dynamic instruction mix of the processor handler, per instruction category or per instruction.
+ */
+class InstructionMixWidget : public QDialog {
+    Q_OBJECT
+
+public:
+    InstructionMixWidget(QWidget* parent = nullptr);
+    ~InstructionMixWidget() override;
+
+private slots:
+    void on_copy_clicked();
+
+private:
+    /// @returns the name and count of each bar of the current grouping, in the order in which they are plotted
+    std::vector<std::pair<QString, long long>> bars() const;
+    void updatePlot();
+
+    Ui::InstructionMixWidget* m_ui = nullptr;
+    QChartView* m_chartView = nullptr;
+};
+}  // namespace Ripes
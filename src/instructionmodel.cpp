@@ -1,15 +1,18 @@
 #include "instructionmodel.h"
+#include "hostprofiler.h"
 #include "parser.h"
 
 #include <QHeaderView>
 
 namespace Ripes {
 
-InstructionModel::InstructionModel(QObject* parent) : QAbstractTableModel(parent) {
-    for (unsigned i = 0; i < ProcessorHandler::get()->getProcessor()->stageCount(); i++) {
-        m_stageNames << ProcessorHandler::get()->getProcessor()->stageName(i);
+InstructionModel::InstructionModel(ProcessorHandler* context, QObject* parent)
+    : QAbstractTableModel(parent), m_context(context) {
+    for (unsigned i = 0; i < m_context->getProcessor()->stageCount(); i++) {
+        m_stageNames << m_context->getProcessor()->stageName(i);
         m_stageInfos[m_stageNames.last()];
     }
+    m_rowCount = rowCount();
 }
 
 int InstructionModel::columnCount(const QModelIndex&) const {
@@ -17,37 +20,83 @@ int InstructionModel::columnCount(const QModelIndex&) const {
 }
 
 int InstructionModel::rowCount(const QModelIndex&) const {
-    return ProcessorHandler::get()->getCurrentProgramSize() / ProcessorHandler::get()->currentISA()->bytes();
+    return static_cast<int>(m_context->getInstructionLayout().count());
 }
 
 void InstructionModel::processorWasClocked() {
-    // Reload model
+    RIPES_PROFILE_SCOPE("InstructionModel::processorWasClocked");
+    if (rowCount() != m_rowCount) {
+        // The program has changed without the model being reloaded
+        reload();
+        return;
+    }
+
+    // Only the rows of instructions entering or leaving a stage are re-queried. Contiguous rows are updated as a single
+    // range, and the disassembly of the rows is refreshed alongside their stages, such that instructions modified in
+    // memory are redisassembled once they are fetched.
+    const std::set<int> changedRows = gatherStageInfo();
+    for (auto it = changedRows.begin(); it != changedRows.end();) {
+        const int first = *it;
+        int last = first;
+        while (++it != changedRows.end() && *it == last + 1) {
+            last = *it;
+        }
+        emit dataChanged(index(first, Column::Stage), index(last, Column::Instruction), {Qt::DisplayRole});
+    }
+
+    // Breakpoints may be toggled outside of the model. Views only re-query the visible rows of the column.
+    if (m_rowCount > 0) {
+        emit dataChanged(index(0, Column::Breakpoint), index(m_rowCount - 1, Column::Breakpoint), {Qt::CheckStateRole});
+    }
+}
+
+void InstructionModel::reload() {
     beginResetModel();
+    m_rowCount = rowCount();
     gatherStageInfo();
     endResetModel();
 }
 
-void InstructionModel::gatherStageInfo() {
+std::set<int> InstructionModel::gatherStageInfo() {
+    std::set<int> changedRows;
+    const auto addRow = [&](const StageInfo& info) {
+        if (!info.stage_valid) {
+            return;
+        }
+        const int row = m_context->getInstructionLayout().index(info.pc - m_context->getTextStart());
+        if (row >= 0 && row < m_rowCount) {
+            changedRows.insert(row);
+        }
+    };
+
     bool firstStageChanged = false;
     for (int i = 0; i < m_stageNames.length(); i++) {
+        StageInfo& stageInfo = m_stageInfos[m_stageNames[i]];
+        const StageInfo newStageInfo = m_context->getProcessor()->stageInfo(i);
         if (i == 0) {
-            if (m_stageInfos[m_stageNames[i]].pc != ProcessorHandler::get()->getProcessor()->stageInfo(i).pc) {
+            if (stageInfo.pc != newStageInfo.pc) {
                 firstStageChanged = true;
             }
         }
-        m_stageInfos[m_stageNames[i]] = ProcessorHandler::get()->getProcessor()->stageInfo(i);
+        if (stageInfo.pc != newStageInfo.pc || stageInfo.stage_valid != newStageInfo.stage_valid) {
+            addRow(stageInfo);
+            addRow(newStageInfo);
+        }
+        stageInfo = newStageInfo;
         if (firstStageChanged) {
             emit firstStageInstrChanged(m_stageInfos[m_stageNames[0]].pc);
             firstStageChanged = false;
         }
     }
+    return changedRows;
 }
 
 bool InstructionModel::setData(const QModelIndex& index, const QVariant& value, int role) {
-    const uint32_t addr = indexToAddress(index);
+    const uint32_t addr = indexToAddress(index, m_context);
     if ((index.column() == Column::Breakpoint) && role == Qt::CheckStateRole) {
         if (static_cast<Qt::CheckState>(value.toInt()) == Qt::Checked) {
-            ProcessorHandler::get()->setBreakpoint(addr, !ProcessorHandler::get()->hasBreakpoint(addr));
+            m_context->setBreakpoint(addr, !m_context->hasBreakpoint(addr));
+            emit dataChanged(index, index, {Qt::CheckStateRole});
             return true;
         }
     }
@@ -73,7 +122,7 @@ QVariant InstructionModel::headerData(int section, Qt::Orientation orientation,
 }
 
 QVariant InstructionModel::BPData(uint32_t addr) const {
-    return ProcessorHandler::get()->hasBreakpoint(addr);
+    return m_context->hasBreakpoint(addr);
 }
 QVariant InstructionModel::PCData(uint32_t addr) const {
     return "0x" + QString::number(addr, 16);
@@ -93,14 +142,14 @@ QVariant InstructionModel::stageData(uint32_t addr) const {
 }
 
 QVariant InstructionModel::instructionData(uint32_t addr) const {
-    return ProcessorHandler::get()->parseInstrAt(addr);
+    return m_context->parseInstrAt(addr);
 }
 
 QVariant InstructionModel::data(const QModelIndex& index, int role) const {
     if (!index.isValid()) {
         return QVariant();
     }
-    const uint32_t addr = indexToAddress(index);
+    const uint32_t addr = indexToAddress(index, m_context);
     switch (index.column()) {
         case Column::Breakpoint: {
             if (role == Qt::CheckStateRole) {
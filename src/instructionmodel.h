@@ -13,16 +13,16 @@ namespace Ripes {
 class Parser;
 class Pipeline;
 
-static inline uint32_t indexToAddress(const QModelIndex& index) {
-    if (ProcessorHandler::get()->getProgram()) {
-        return (index.row() * 4) + ProcessorHandler::get()->getProgram()->getSection(TEXT_SECTION_NAME)->address;
+static inline uint32_t indexToAddress(const QModelIndex& index, const ProcessorHandler* context = ProcessorHandler::get()) {
+    if (context->getProgram()) {
+        return context->getInstructionLayout().offset(index.row()) + context->getTextStart();
     }
     return 0;
 }
 
-static inline int addressToIndex(uint32_t addr) {
-    if (ProcessorHandler::get()->getProgram() && ProcessorHandler::get()->getProgram()->getSection(TEXT_SECTION_NAME) != nullptr) {
-        return (addr - ProcessorHandler::get()->getProgram()->getSection(TEXT_SECTION_NAME)->address) / 4;
+static inline int addressToIndex(uint32_t addr, const ProcessorHandler* context = ProcessorHandler::get()) {
+    if (context->getProgram()) {
+        return context->getInstructionLayout().index(addr - context->getTextStart());
     }
     return 0;
 }
@@ -31,7 +31,7 @@ class InstructionModel : public QAbstractTableModel {
     Q_OBJECT
 public:
     enum Column { Breakpoint = 0, PC = 1, Stage = 2, Instruction = 3, NColumns };
-    InstructionModel(QObject* parent = nullptr);
+    InstructionModel(ProcessorHandler* context, QObject* parent = nullptr);
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -43,8 +43,20 @@ public:
     Qt::ItemFlags flags(const QModelIndex& index) const override;
 
 public slots:
+    /**
+     * @brief processorWasClocked
+     * Updates the rows of the instructions which entered or left a stage of the processor since the last update, as
+     * well as the breakpoint column, without resetting the model.
+     */
     void processorWasClocked();
 
+    /**
+     * @brief reload
+     * Resets the model, re-querying all rows. Must be invoked whenever the program or memory of the processor has been
+     * changed, such that the disassembly of any row may have changed.
+     */
+    void reload();
+
 signals:
     /**
      * @brief firstStageInstrChanged
@@ -54,7 +66,8 @@ signals:
     void firstStageInstrChanged(uint32_t) const;
 
 private:
-    void gatherStageInfo();
+    /// Records the current stage information of the processor. @returns the rows whose stages changed.
+    std::set<int> gatherStageInfo();
 
     QVariant BPData(uint32_t addr) const;
     QVariant PCData(uint32_t addr) const;
@@ -63,5 +76,8 @@ private:
 
     QStringList m_stageNames;
     std::map<QString, StageInfo> m_stageInfos;
+
+    ProcessorHandler* m_context = nullptr;
+    int m_rowCount = 0;
 };
 }  // namespace Ripes
@@ -8,8 +8,9 @@
 namespace Ripes {
 
 /// Currently supported ISAs
-enum class ISA { RV32IM };
-const static std::map<ISA, QString> ISANames = {{ISA::RV32IM, "RISC-V"}};
+enum class ISA { RV32IM, RV32IMC };
+/// Name of the family of each ISA; ISAs of the same family are presented together
+const static std::map<ISA, QString> ISANames = {{ISA::RV32IM, "RISC-V"}, {ISA::RV32IMC, "RISC-V"}};
 
 class ISAInfoBase {
 public:
@@ -28,6 +29,9 @@ public:
 
     virtual unsigned elfMachineId() const = 0;
 
+    /// @returns true if instructions of the ISA may be 16 bits wide, as are those of the RISC-V C extension
+    virtual bool hasCompressedInstructions() const { return false; }
+
     /**
      * @brief elfSupportsFlags
      * The instructcion set should determine whether the provided @p flags, as retrieved from an ELF file, are valid
@@ -149,4 +153,22 @@ public:
     }
 };
 
+template <>
+class ISAInfo<ISA::RV32IMC> : public ISAInfo<ISA::RV32IM> {
+public:
+    static const ISAInfo<ISA::RV32IMC>* instance() {
+        static ISAInfo<ISA::RV32IMC> pr;
+        return &pr;
+    }
+
+    QString name() const override { return "RV32IMC"; }
+    ISA isaID() const override { return ISA::RV32IMC; }
+    bool hasCompressedInstructions() const override { return true; }
+
+    QString elfSupportsFlags(unsigned flags) const override {
+        // Executables which may contain compressed instructions are flagged as such
+        return ISAInfo<ISA::RV32IM>::elfSupportsFlags(flags & ~RVC);
+    }
+};
+
 }  // namespace Ripes
@@ -1,31 +1,85 @@
 #pragma once
 
 #include <QStringList>
+#include <QVector>
 
 namespace Ripes {
 
-static QStringList splitQuotes(const QStringList& list) {
-    // Manual string splitter - splits at ' ' (space) and ',' (comma) characters, unless test is delimitered by quotes
-    // or parentheses
-    QStringList ret;
-    for (const auto& s : list) {
-        QString outString;
-        bool inQuote = false;
-        bool inParen = false;
-        for (int i = 0; i < s.length(); i++) {
-            inQuote ^= s[i] == '"';
-            inParen = (inParen || (s[i] == '(')) && s[i] != ')';
-            if ((s[i] == ' ' || s[i] == ',') && !inQuote && !inParen) {
-                ret.append(outString);
-                outString.clear();
-            } else {
-                outString.append(s[i]);
-                if (i == s.length() - 1)
-                    ret.append(outString);
+static bool isDecimalDigit(QChar c) {
+    return c >= '0' && c <= '9';
+}
+
+/// @returns true if a register name (xN, an ABI name, or "zero") starts at index @p i of @p s
+static bool registerStartsAt(const QString& s, int i) {
+    const auto at = [&](int j) { return j < s.length() ? s[j] : QChar(); };
+    const QChar c = at(i);
+    const QChar next = at(i + 1);
+    return (c == 'x' && isDecimalDigit(next)) || (c == 't' && next >= '0' && next <= '6') ||
+           (c == 'a' && next >= '0' && next <= '7') || (c == 's' && isDecimalDigit(next)) ||
+           ((c == 's' || c == 'g' || c == 't') && next == 'p') || s.midRef(i, 4) == QLatin1String("zero");
+}
+
+/// @returns true if a register name ends just before index @p i of @p s
+static bool registerEndsAt(const QString& s, int i) {
+    const auto at = [&](int j) { return j >= 0 ? s[j] : QChar(); };
+    const QChar c1 = at(i - 1);
+    const QChar c2 = at(i - 2);
+    const QChar c3 = at(i - 3);
+    if (isDecimalDigit(c1) && (c2 == 'x' || c2 == 's')) {
+        return true;
+    }
+    return (c3 == 'x' && ((c2 >= '1' && c2 <= '2' && isDecimalDigit(c1)) || (c2 == '3' && c1 >= '0' && c1 <= '1'))) ||
+           (c3 == 's' && c2 == '1' && c1 >= '0' && c1 <= '1') || (c2 == 't' && c1 >= '0' && c1 <= '6') ||
+           (c2 == 'a' && c1 >= '0' && c1 <= '7') || ((c2 == 's' || c2 == 'g' || c2 == 't') && c1 == 'p') ||
+           (i >= 4 && s.midRef(i - 4, 4) == QLatin1String("zero"));
+}
+
+/**
+ * @brief tokenize
+ * Splits a line of assembly into its fields, in a single pass over the line. Fields are separated by tabs, by
+ * parentheses enclosing a register name (which are dropped, such that "4(sp)" becomes "4" and "sp"), and by spaces
+ * and commas outside of quotes and other parentheses. Empty fields are discarded. If @p starts is provided, the index
+ * in @p line at which each field starts is appended to it.
+ */
+static QStringList tokenize(const QString& line, QVector<int>* starts = nullptr) {
+    QStringList fields;
+    QString field;
+    int fieldStart = 0;
+    bool inQuote = false;
+    bool inParen = false;
+    const auto endField = [&](bool resetState) {
+        if (!field.isEmpty()) {
+            fields.append(field);
+            if (starts) {
+                starts->append(fieldStart);
+            }
+            field.clear();
+        }
+        if (resetState) {
+            inQuote = false;
+            inParen = false;
+        }
+    };
+
+    for (int i = 0; i < line.length(); i++) {
+        const QChar c = line[i];
+        // Tabs and register parentheses separate fields unconditionally, and end any quote or parenthesis
+        if (c == '\t' || (c == '(' && registerStartsAt(line, i + 1)) || (c == ')' && registerEndsAt(line, i))) {
+            endField(true);
+            continue;
+        }
+        inQuote ^= c == '"';
+        inParen = (inParen || c == '(') && c != ')';
+        if ((c == ' ' || c == ',') && !inQuote && !inParen) {
+            endField(false);
+        } else {
+            if (field.isEmpty()) {
+                fieldStart = i;
             }
+            field.append(c);
         }
     }
-    ret.removeAll("");
-    return ret;
+    endField(false);
+    return fields;
 }
 }  // namespace Ripes
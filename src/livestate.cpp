@@ -0,0 +1,68 @@
+#include "livestate.h"
+
+namespace Ripes {
+
+bool LiveState::Frame::contains(uint32_t address) const {
+    const auto page = pages.find(address >> s_pageBits);
+    return page != pages.end() && page->second->present.test(address & (s_pageSize - 1));
+}
+
+uint32_t LiveState::Frame::read(uint32_t address, unsigned bytes, uint32_t& present) const {
+    uint32_t value = 0;
+    present = 0;
+    for (unsigned i = 0; i < bytes; i++) {
+        const uint32_t byteAddress = address + i;
+        const auto page = pages.find(byteAddress >> s_pageBits);
+        const uint32_t offset = byteAddress & (s_pageSize - 1);
+        if (page != pages.end() && page->second->present.test(offset)) {
+            present |= 1u << i;
+            value |= static_cast<uint32_t>(page->second->bytes[offset]) << (i * 8);
+        }
+    }
+    return value;
+}
+
+void LiveState::publish(vsrtl::core::RipesProcessor& processor, long long cycle) {
+    for (auto& [index, page] : m_scratch) {
+        page.bytes.fill(0);
+        page.present.reset();
+    }
+    for (const auto& entry : processor.getMemory()) {
+        const auto address = static_cast<uint32_t>(entry.first);
+        Page& page = m_scratch[address >> s_pageBits];
+        const uint32_t offset = address & (s_pageSize - 1);
+        page.present.set(offset);
+        page.bytes[offset] = static_cast<uint8_t>(entry.second);
+    }
+
+    auto frame = std::make_shared<Frame>();
+    frame->cycle = cycle;
+    frame->registers.resize(processor.implementsISA()->regCnt());
+    for (unsigned i = 0; i < frame->registers.size(); i++) {
+        frame->registers[i] = processor.getRegister(i);
+    }
+
+    // Pages which are unchanged since the preceding frame are shared with it
+    const auto previous = std::atomic_load(&m_latest);
+    for (const auto& [index, page] : m_scratch) {
+        if (page.present.none()) {
+            continue;
+        }
+        if (previous) {
+            const auto shared = previous->pages.find(index);
+            if (shared != previous->pages.end() && *shared->second == page) {
+                frame->pages.emplace(index, shared->second);
+                continue;
+            }
+        }
+        frame->pages.emplace(index, std::make_shared<const Page>(page));
+    }
+    std::atomic_store(&m_latest, std::shared_ptr<const Frame>(std::move(frame)));
+}
+
+void LiveState::clear() {
+    std::atomic_store(&m_latest, std::shared_ptr<const Frame>());
+    m_scratch.clear();
+}
+
+}  // namespace Ripes
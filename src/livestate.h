@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "processors/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The LiveState class
+ * Copy-on-write snapshots of the registers and memory of a running processor, published by the simulation thread and
+ * read by views on the GUI thread. Each publication is an immutable frame which shares the pages left unchanged since
+ * the preceding frame. Readers hold on to the frame they read, while the next frame is gathered, such that neither
+ * thread waits on the other.
+ */
+class LiveState {
+public:
+    static constexpr unsigned s_pageBits = 12;
+    static constexpr unsigned s_pageSize = 1 << s_pageBits;
+
+    struct Page {
+        std::array<uint8_t, s_pageSize> bytes{};
+        std::bitset<s_pageSize> present;
+        bool operator==(const Page& other) const { return present == other.present && bytes == other.bytes; }
+    };
+
+    struct Frame {
+        long long cycle = 0;
+        std::vector<uint32_t> registers;
+        std::map<uint32_t, std::shared_ptr<const Page>> pages;
+
+        bool contains(uint32_t address) const;
+        /**
+         * @brief read
+         * @returns the little-endian value of the @p bytes bytes at @p address, of which those not present read as 0.
+         * Bit i of @p present is set if byte i is present.
+         */
+        uint32_t read(uint32_t address, unsigned bytes, uint32_t& present) const;
+    };
+
+    /**
+     * @brief publish
+     * Publishes the current registers and memory of @p processor as of @p cycle. Must only be called from the thread
+     * executing the processor.
+     */
+    void publish(vsrtl::core::RipesProcessor& processor, long long cycle);
+    /// @returns the most recently published frame, or nullptr if none was published since the last clear()
+    std::shared_ptr<const Frame> latest() const { return std::atomic_load(&m_latest); }
+    void clear();
+
+private:
+    std::shared_ptr<const Frame> m_latest;
+    /// Pages being gathered by the next publication, kept allocated between publications
+    std::map<uint32_t, Page> m_scratch;
+};
+
+}  // namespace Ripes
@@ -2,7 +2,6 @@
 #include "ui_loaddialog.h"
 
 #include "elfinfostrings.h"
-#include "elfio/elfio.hpp"
 
 #include "processorhandler.h"
 #include "program.h"
@@ -14,9 +13,63 @@
 #include <QMessageBox>
 #include <QPushButton>
 #include <QRegExpValidator>
+#include <QtConcurrent/QtConcurrent>
 
 namespace Ripes {
 
+namespace {
+/**
+ * @brief readELFHeader
+ * Reads the ELF header of @p filename, and checks that the section header table which it refers to lies within the
+ * file. Section headers and data are not read; they are only read once the file is loaded.
+ */
+ELFHeader readELFHeader(const QString& filename) {
+    ELFHeader header;
+    header.filename = filename;
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        header.errorMessage = "Could not open file";
+        return header;
+    }
+    const QByteArray data = file.read(64 /*size of the ELF64 header*/);
+    const auto* bytes = reinterpret_cast<const uchar*>(data.constData());
+    if (data.size() < 52 /*size of the ELF32 header*/ || bytes[EI_MAG0] != ELFMAG0 || bytes[EI_MAG1] != ELFMAG1 ||
+        bytes[EI_MAG2] != ELFMAG2 || bytes[EI_MAG3] != ELFMAG3 ||
+        (bytes[EI_CLASS] != ELFCLASS32 && bytes[EI_CLASS] != ELFCLASS64) ||
+        (bytes[EI_DATA] != ELFDATA2LSB && bytes[EI_DATA] != ELFDATA2MSB)) {
+        header.errorMessage = "Not an ELF file";
+        return header;
+    }
+    const bool is64 = bytes[EI_CLASS] == ELFCLASS64;
+    if (is64 && data.size() < 64) {
+        header.errorMessage = "Not an ELF file";
+        return header;
+    }
+    const auto field = [&](int offset, int size) {
+        quint64 value = 0;
+        for (int i = 0; i < size; i++) {
+            const int byte = bytes[EI_DATA] == ELFDATA2LSB ? offset + size - 1 - i : offset + i;
+            value = (value << 8) | bytes[byte];
+        }
+        return value;
+    };
+    header.elfClass = bytes[EI_CLASS];
+    header.type = static_cast<unsigned>(field(16, 2));
+    header.machine = static_cast<unsigned>(field(18, 2));
+    header.flags = static_cast<unsigned>(is64 ? field(48, 4) : field(36, 4));
+
+    const quint64 shoff = is64 ? field(40, 8) : field(32, 4);
+    const quint64 shentsize = is64 ? field(58, 2) : field(46, 2);
+    const quint64 shnum = is64 ? field(60, 2) : field(48, 2);
+    if (shoff > static_cast<quint64>(file.size()) || shentsize * shnum > static_cast<quint64>(file.size()) - shoff) {
+        header.errorMessage = "Not an ELF file";
+        return header;
+    }
+    header.valid = true;
+    return header;
+}
+}  // namespace
+
 LoadDialog::TypeButtonID LoadDialog::s_typeIndex = TypeButtonID::ELF;
 QString LoadDialog::s_filePath = QString();
 
@@ -29,11 +82,14 @@ LoadDialog::LoadDialog(QWidget* parent) : QDialog(parent), m_ui(new Ui::LoadDial
     m_fileTypeButtons->addButton(m_ui->assemblyRadioButton, TypeButtonID::Assembly);
     m_fileTypeButtons->addButton(m_ui->binaryRadioButton, TypeButtonID::FlatBinary);
     m_fileTypeButtons->addButton(m_ui->elfRadioButton, TypeButtonID::ELF);
+    m_fileTypeButtons->addButton(m_ui->ihexRadioButton, TypeButtonID::IntelHex);
+    m_fileTypeButtons->addButton(m_ui->srecRadioButton, TypeButtonID::SRecord);
 
     connect(m_fileTypeButtons, QOverload<int, bool>::of(&QButtonGroup::buttonToggled), this,
             &LoadDialog::inputTypeChanged);
     connect(m_ui->openFile, &QPushButton::clicked, this, &LoadDialog::openFileButtonTriggered);
     connect(m_ui->filePath, &QLineEdit::textChanged, this, &LoadDialog::validateCurrentFile);
+    connect(&m_elfWatcher, &QFutureWatcher<ELFHeader>::finished, this, &LoadDialog::elfHeaderRead);
 
     // ===================== Page setups =====================
 
@@ -75,6 +131,16 @@ void LoadDialog::inputTypeChanged() {
             updateELFPageState();
             break;
         }
+        case LoadDialog::TypeButtonID::IntelHex: {
+            m_fileType = FileType::IntelHex;
+            updateRecordPageState();
+            break;
+        }
+        case LoadDialog::TypeButtonID::SRecord: {
+            m_fileType = FileType::SRecord;
+            updateRecordPageState();
+            break;
+        }
     }
     validateCurrentFile();
 }
@@ -98,6 +164,17 @@ void LoadDialog::openFileButtonTriggered() {
             filter = "All files (*)";
             break;
         }
+        case FileType::IntelHex: {
+            title = "Open Intel HEX file";
+            filter = "Intel HEX files [*.hex, *.ihex] (*.hex *.ihex);; All files (*)";
+            break;
+        }
+        case FileType::SRecord: {
+            title = "Open S-record file";
+            filter = "S-record files [*.srec, *.mot, *.s19, *.s28, *.s37] (*.srec *.mot *.s19 *.s28 *.s37);; "
+                     "All files (*)";
+            break;
+        }
     }
 
     const auto filename = QFileDialog::getOpenFileName(this, title, "", filter);
@@ -129,6 +206,16 @@ bool LoadDialog::validateBinaryFile(const QFile&) {
     return loadAtValid && entryPointValid;
 }
 
+bool LoadDialog::validateRecordFile(const QFile& file) {
+    // Only the start of the first record is checked; records are validated as the file is loaded
+    QFile records(file.fileName());
+    char first;
+    if (!records.open(QIODevice::ReadOnly) || !records.getChar(&first)) {
+        return false;
+    }
+    return first == (m_fileType == FileType::IntelHex ? ':' : 'S');
+}
+
 void LoadDialog::setElfInfo(const ELFInfo& info) {
     if (info.valid) {
         m_ui->elfInfo->clear();
@@ -138,32 +225,45 @@ void LoadDialog::setElfInfo(const ELFInfo& info) {
 }
 
 bool LoadDialog::validateELFFile(const QFile& file) {
-    ELFIO::elfio reader;
+    // The header is read off the GUI thread, such that browsing large files does not stall the dialog. The file is
+    // invalid until the header has been read and checked.
+    m_ui->elfInfo->clear();
+    m_elfWatcher.setFuture(QtConcurrent::run(readELFHeader, file.fileName()));
+    return false;
+}
+
+void LoadDialog::elfHeaderRead() {
+    const ELFHeader header = m_elfWatcher.result();
+    if (m_fileType != FileType::Executable || header.filename != m_ui->filePath->text()) {
+        // The selection changed while the header was read
+        return;
+    }
+
     ELFInfo info;
     QString flagErr;
     unsigned elfbits;
     info.valid = true;
 
     // Is it an ELF file?
-    if (!reader.load(file.fileName().toStdString())) {
-        info.errorMessage = "Not an ELF file";
+    if (!header.valid) {
+        info.errorMessage = header.errorMessage;
         info.valid = false;
         goto finish;
     }
 
     // Is it a compatible machine format?
-    if (reader.get_machine() != ProcessorHandler::get()->currentISA()->elfMachineId()) {
+    if (header.machine != ProcessorHandler::get()->currentISA()->elfMachineId()) {
         info.errorMessage = "Incompatible ELF machine type (ISA).<br/><br/>Expected machine type:<br/>'" +
                             QString::number(ProcessorHandler::get()->currentISA()->elfMachineId()) + "' (" +
                             getNameForElfMachine(ProcessorHandler::get()->currentISA()->elfMachineId()) +
-                            ")<br/>but file has machine type:<br/>    '" + QString::number(reader.get_machine()) +
-                            "' (" + getNameForElfMachine(reader.get_machine()) + ")";
+                            ")<br/>but file has machine type:<br/>    '" + QString::number(header.machine) + "' (" +
+                            getNameForElfMachine(header.machine) + ")";
         info.valid = false;
         goto finish;
     }
 
     // Is it a compatible file class?
-    elfbits = reader.get_class() == ELFCLASS32 ? 32 : 64;
+    elfbits = header.elfClass == ELFCLASS32 ? 32 : 64;
     if (elfbits != ProcessorHandler::get()->currentISA()->bits()) {
         const QString bitSize = elfbits == 32 ? "32" : "64";
         info.errorMessage = "Expected " + QString::number(ProcessorHandler::get()->currentISA()->bits()) +
@@ -173,16 +273,16 @@ bool LoadDialog::validateELFFile(const QFile& file) {
     }
 
     // executable? (Not dynamically linked nor relocateable)
-    if (!(reader.get_type() == ET_EXEC)) {
+    if (!(header.type == ET_EXEC)) {
         info.errorMessage = "Only executable ELF files are supported.<br/><br/>File type is<br/>" +
-                            QString::number(reader.get_type()) + " (" + getNameForElfType(reader.get_type()) +
+                            QString::number(header.type) + " (" + getNameForElfType(header.type) +
                             ")<br/>Expected<br/>" + QString::number(ET_EXEC) + " (" + getNameForElfType(ET_EXEC) + ")";
         info.valid = false;
         goto finish;
     }
 
     // Supported flags?
-    flagErr = ProcessorHandler::get()->currentISA()->elfSupportsFlags(reader.get_flags());
+    flagErr = ProcessorHandler::get()->currentISA()->elfSupportsFlags(header.flags);
     if (!flagErr.isEmpty()) {
         info.errorMessage = flagErr;
         info.valid = false;
@@ -193,7 +293,7 @@ bool LoadDialog::validateELFFile(const QFile& file) {
 
 finish:
     setElfInfo(info);
-    return info.valid;
+    m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(info.valid);
 }
 
 bool LoadDialog::fileTypeValidate(const QFile& file) {
@@ -204,6 +304,9 @@ bool LoadDialog::fileTypeValidate(const QFile& file) {
             return validateBinaryFile(file);
         case FileType::Executable:
             return validateELFFile(file);
+        case FileType::IntelHex:
+        case FileType::SRecord:
+            return validateRecordFile(file);
     }
     Q_UNREACHABLE();
 }
@@ -248,6 +351,10 @@ void LoadDialog::updateBinaryPageState() {
 void LoadDialog::updateELFPageState() {
     m_ui->fileTypePages->setCurrentIndex(2);
 }
+void LoadDialog::updateRecordPageState() {
+    // Record files carry their own addresses and start address, and have no options
+    m_ui->fileTypePages->setCurrentIndex(0);
+}
 
 LoadDialog::~LoadDialog() {
     delete m_ui;
@@ -1,15 +1,12 @@
 #pragma once
 #include <QDialog>
+#include <QFutureWatcher>
 
 QT_FORWARD_DECLARE_CLASS(QButtonGroup);
 QT_FORWARD_DECLARE_CLASS(QFile);
 
 #include "program.h"
 
-namespace ELFIO {
-class elfio;
-}
-
 namespace Ripes {
 
 struct ELFInfo {
@@ -18,6 +15,18 @@ struct ELFInfo {
     QString entryPoint;
 };
 
+/// Fields of the header of an ELF file, as required for validating the file before it is loaded
+struct ELFHeader {
+    QString filename;
+    /// Set if the file starts with a well-formed ELF header, and holds the section header table which it refers to
+    bool valid = false;
+    QString errorMessage;
+    unsigned elfClass = 0;
+    unsigned type = 0;
+    unsigned machine = 0;
+    unsigned flags = 0;
+};
+
 namespace Ui {
 class LoadDialog;
 }
@@ -40,11 +49,13 @@ private slots:
     void updateAssemblyPageState();
     void updateBinaryPageState();
     void updateELFPageState();
+    void updateRecordPageState();
 
     void loadFileError(const QString& filename);
+    void elfHeaderRead();
 
 private:
-    enum TypeButtonID { Assembly, FlatBinary, ELF };
+    enum TypeButtonID { Assembly, FlatBinary, ELF, IntelHex, SRecord };
     static TypeButtonID s_typeIndex;
     static QString s_filePath;
 
@@ -53,6 +64,7 @@ private:
     bool validateAssemblyFile(const QFile& file);
     bool validateBinaryFile(const QFile& file);
     bool validateELFFile(const QFile& file);
+    bool validateRecordFile(const QFile& file);
 
     void paletteValidate(QWidget* w, bool valid);
 
@@ -61,6 +73,8 @@ private:
 
     Ui::LoadDialog* m_ui = nullptr;
     QButtonGroup* m_fileTypeButtons = nullptr;
+    /// Reads the header of the selected ELF file off the GUI thread
+    QFutureWatcher<ELFHeader> m_elfWatcher;
 };  // namespace Ripes
 
 }  // namespace Ripes
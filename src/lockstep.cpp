@@ -0,0 +1,670 @@
+#include "lockstep.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "binutils.h"
+#include "defines.h"
+#include "isainfo.h"
+#include "processors/RISC-V/rv_compressed.h"
+#include "processors/RISC-V/rv_instrparser.h"
+#include "processors/ripesprocessor.h"
+
+namespace Ripes {
+
+namespace {
+
+bool branchTaken(const unsigned funct3, const uint32_t a, const uint32_t b) {
+    switch (funct3) {
+        case 0b000:
+            return a == b;
+        case 0b001:
+            return a != b;
+        case 0b100:
+            return static_cast<int32_t>(a) < static_cast<int32_t>(b);
+        case 0b101:
+            return static_cast<int32_t>(a) >= static_cast<int32_t>(b);
+        case 0b110:
+            return a < b;
+        case 0b111:
+            return a >= b;
+        default:
+            return false;
+    }
+}
+
+// As for RVISS
+uint32_t mulh(const uint32_t op1, const uint32_t op2) {
+    return static_cast<uint32_t>(
+        (static_cast<int64_t>(static_cast<int32_t>(op1)) * static_cast<int64_t>(static_cast<int32_t>(op2))) >> 32);
+}
+uint32_t mulhsu(const uint32_t op1, const uint32_t op2) {
+    return static_cast<uint32_t>((static_cast<int64_t>(static_cast<int32_t>(op1)) * static_cast<uint64_t>(op2)) >> 32);
+}
+uint32_t mulhu(const uint32_t op1, const uint32_t op2) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(op1) * static_cast<uint64_t>(op2)) >> 32);
+}
+uint32_t div(const uint32_t op1, const uint32_t op2) {
+    if (op2 == 0) {
+        return static_cast<uint32_t>(-1);
+    } else if (op1 == 0x80000000 && static_cast<int32_t>(op2) == -1) {
+        // Overflow
+        return 0x80000000;
+    }
+    return static_cast<uint32_t>(static_cast<int32_t>(op1) / static_cast<int32_t>(op2));
+}
+uint32_t rem(const uint32_t op1, const uint32_t op2) {
+    if (op2 == 0) {
+        return op1;
+    } else if (op1 == 0x80000000 && static_cast<int32_t>(op2) == -1) {
+        // Overflow
+        return 0;
+    }
+    return static_cast<uint32_t>(static_cast<int32_t>(op1) % static_cast<int32_t>(op2));
+}
+
+/**
+ * @brief readCounter
+ * @returns the value of counter CSR @p csr for a lane which has retired @p instructions, as per
+ * RipesProcessor::readCSR. Only the cycle, time and instret counters are implemented; all other CSRs read as zero.
+ */
+uint32_t readCounter(const unsigned csr, const long long instructions) {
+    const bool high = (csr & 0x80) != 0;
+    const unsigned base = csr & ~0x80u;
+    unsigned index;
+    if (0xC00 <= base && base <= 0xC1F) {
+        index = base - 0xC00;
+    } else if (0xB00 <= base && base <= 0xB1F && base != 0xB01) {
+        index = base - 0xB00;
+    } else {
+        return 0;
+    }
+    if (index > 2) {
+        return 0;
+    }
+    const auto value = static_cast<uint64_t>(instructions);
+    return static_cast<uint32_t>(high ? value >> 32 : value);
+}
+
+}  // namespace
+
+LockstepSystem::LockstepSystem(const Program& program, const std::vector<LaneInput>& lanes)
+    : m_lanes(lanes.size()), m_registers((s_discardRow + 1) * lanes.size(), 0) {
+    if (const auto* text = program.getSection(TEXT_SECTION_NAME)) {
+        m_textStart = static_cast<uint32_t>(text->address);
+        m_textEnd = static_cast<uint32_t>(text->address + text->data.length());
+    }
+    // Zero-filled bytes of the sections are left unwritten, as pages which are not present read as zero
+    for (const auto& section : program.sections) {
+        for (int i = 0; i < section.data.length(); i++) {
+            const uint32_t address = static_cast<uint32_t>(section.address + i);
+            auto& page = m_image[address >> s_pageBits];
+            if (!page) {
+                page = std::make_unique<Page>();
+                page->fill(0);
+            }
+            (*page)[address & (s_pageSize - 1)] = static_cast<uint8_t>(section.data.at(i));
+        }
+    }
+
+    for (unsigned i = 0; i < lanes.size(); i++) {
+        Lane& lane = m_lanes[i];
+        lane.pc = static_cast<uint32_t>(program.entryPoint);
+        for (const auto& [reg, value] : lanes[i].registers) {
+            if (reg != 0 && reg < s_discardRow) {
+                dest(reg)[i] = value;
+            }
+        }
+        for (const auto& [address, bytes] : lanes[i].data) {
+            for (int j = 0; j < bytes.length(); j++) {
+                store(lane, address + j, static_cast<uint8_t>(bytes.at(j)), 1);
+            }
+        }
+    }
+}
+
+LockstepSystem::~LockstepSystem() = default;
+
+LockstepSystem::LaneResult LockstepSystem::result(unsigned index) const {
+    const Lane& lane = m_lanes.at(index);
+    LaneResult result;
+    result.finished = lane.state == LaneState::Finished;
+    result.unsupported = lane.state == LaneState::Unsupported;
+    result.instructions = lane.instructions;
+    result.output = lane.output;
+    for (unsigned r = 0; r < s_discardRow; r++) {
+        result.registers.push_back(reg(r)[index]);
+    }
+    return result;
+}
+
+bool LockstepSystem::run(unsigned long long maxCycles) {
+    // Lanes which reached the cycle limit of a previous run may continue
+    m_scalarLane = 0;
+    uint32_t pc;
+    unsigned running;
+    while (selectLanes(maxCycles, pc, running)) {
+        if (pc < m_textStart || pc >= m_textEnd) {
+            // Only reachable if the entry point is outside of the text section
+            forLanes([&](unsigned lane) { m_lanes[lane].state = LaneState::Finished; });
+            continue;
+        }
+        execute(lookupOp(pc), pc);
+        if (!m_scalar) {
+            updateEfficiency(running);
+        }
+    }
+    return std::none_of(m_lanes.begin(), m_lanes.end(),
+                        [](const Lane& lane) { return lane.state == LaneState::Running; });
+}
+
+bool LockstepSystem::selectLanes(unsigned long long maxCycles, uint32_t& pc, unsigned& running) {
+    const auto eligible = [maxCycles](const Lane& lane) {
+        return lane.state == LaneState::Running && static_cast<unsigned long long>(lane.instructions) < maxCycles;
+    };
+    const unsigned lanes = static_cast<unsigned>(m_lanes.size());
+    m_mask.clear();
+    running = 0;
+
+    if (m_scalar) {
+        while (m_scalarLane < lanes && !eligible(m_lanes[m_scalarLane])) {
+            m_scalarLane++;
+        }
+        if (m_scalarLane == lanes) {
+            return false;
+        }
+        m_mask.push_back(m_scalarLane);
+        m_converged = lanes == 1;
+        pc = m_lanes[m_scalarLane].pc;
+        running = 1;
+        return true;
+    }
+
+    for (const Lane& lane : m_lanes) {
+        if (eligible(lane)) {
+            pc = running == 0 ? lane.pc : std::min(pc, lane.pc);
+            running++;
+        }
+    }
+    if (running == 0) {
+        return false;
+    }
+    for (unsigned i = 0; i < lanes; i++) {
+        if (eligible(m_lanes[i]) && m_lanes[i].pc == pc) {
+            m_mask.push_back(i);
+        }
+    }
+    m_converged = m_mask.size() == lanes;
+    return true;
+}
+
+void LockstepSystem::updateEfficiency(unsigned running) {
+    m_windowSteps++;
+    m_windowInstructions += m_mask.size();
+    m_windowRunning += running;
+    m_laneInstructions += m_mask.size();
+    m_runningLanes += running;
+    if (m_windowSteps == s_efficiencyWindow) {
+        m_scalar = m_windowInstructions < s_minLaneEfficiency * m_windowRunning;
+        m_windowSteps = 0;
+        m_windowInstructions = 0;
+        m_windowRunning = 0;
+    }
+}
+
+const LockstepSystem::Op& LockstepSystem::lookupOp(const uint32_t pc) {
+    auto it = m_ops.find(pc);
+    if (it != m_ops.end()) {
+        return it->second;
+    }
+    // Instructions are halfword aligned, such that a 32-bit instruction following a compressed instruction may span two
+    // pages
+    const auto readHalfword = [this](uint32_t address) {
+        uint16_t halfword = 0;
+        const auto page = m_image.find(address >> s_pageBits);
+        if (page != m_image.end()) {
+            std::memcpy(&halfword, page->second->data() + (address & (s_pageSize - 1)), sizeof(halfword));
+        }
+        return static_cast<uint32_t>(halfword);
+    };
+    const uint32_t low = readHalfword(pc);
+    if (instructionLength(low) == 2) {
+        Op op = decode(expandCompressed(low));
+        op.length = 2;
+        return m_ops.emplace(pc, op).first->second;
+    }
+    return m_ops.emplace(pc, decode(low | readHalfword(pc + 2) << 16)).first->second;
+}
+
+LockstepSystem::Op LockstepSystem::decode(const uint32_t instr) {
+    const auto r = decodeRInstr(instr);
+    Op op;
+    op.rd = static_cast<uint8_t>(r.rd);
+    op.rs1 = static_cast<uint8_t>(r.rs1);
+    op.rs2 = static_cast<uint8_t>(r.rs2);
+    op.funct = static_cast<uint8_t>(r.funct3);
+    const uint32_t immI = static_cast<uint32_t>(signextend<int32_t, 12>(decodeIInstr(instr).imm));
+    const bool alternate = r.funct7 == 0b0100000;
+
+    // Unknown instructions are executed as NOPs, as in RVISS
+    switch (instr & 0b1111111) {
+        case instrType::LUI:
+            op.kind = Kind::Lui;
+            op.imm = instr & 0xfffff000;
+            break;
+        case instrType::AUIPC:
+            op.kind = Kind::Auipc;
+            op.imm = instr & 0xfffff000;
+            break;
+        case instrType::JAL:
+            op.kind = Kind::Jal;
+            op.imm = static_cast<uint32_t>(signextend<int32_t, 21>(immediate(decodeJInstr(instr))));
+            break;
+        case instrType::JALR:
+            op.kind = Kind::Jalr;
+            op.imm = immI;
+            break;
+        case instrType::BRANCH:
+            if (r.funct3 != 0b010 && r.funct3 != 0b011) {
+                op.kind = Kind::Branch;
+                op.imm = static_cast<uint32_t>(signextend<int32_t, 13>(immediate(decodeBInstr(instr))));
+            }
+            break;
+        case instrType::LOAD:
+            if (r.funct3 != 0b011 && r.funct3 < 0b110) {
+                op.kind = Kind::Load;
+                op.imm = immI;
+            }
+            break;
+        case instrType::STORE:
+            if (r.funct3 <= 0b010) {
+                op.kind = Kind::Store;
+                op.imm = static_cast<uint32_t>(signextend<int32_t, 12>(immediate(decodeSInstr(instr))));
+            }
+            break;
+        case instrType::OP_IMM: {
+            static constexpr Alu s_opImm[] = {Alu::Add, Alu::Sll, Alu::Slt, Alu::Sltu,
+                                              Alu::Xor, Alu::Srl, Alu::Or,  Alu::And};
+            op.kind = Kind::Alu;
+            op.immOperand = true;
+            op.alu = r.funct3 == 0b101 && alternate ? Alu::Sra : s_opImm[r.funct3];
+            // Shift amounts are held by the rs2 field
+            op.imm = r.funct3 == 0b001 || r.funct3 == 0b101 ? r.rs2 : immI;
+            break;
+        }
+        case instrType::OP: {
+            static constexpr Alu s_op[] = {Alu::Add, Alu::Sll, Alu::Slt, Alu::Sltu,
+                                           Alu::Xor, Alu::Srl, Alu::Or,  Alu::And};
+            static constexpr Alu s_mulDiv[] = {Alu::Mul, Alu::Mulh, Alu::Mulhsu, Alu::Mulhu,
+                                               Alu::Div, Alu::Divu, Alu::Rem,    Alu::Remu};
+            op.kind = Kind::Alu;
+            if (r.funct7 == 0b1) {
+                op.alu = s_mulDiv[r.funct3];
+            } else if (alternate && r.funct3 == 0b000) {
+                op.alu = Alu::Sub;
+            } else if (alternate && r.funct3 == 0b101) {
+                op.alu = Alu::Sra;
+            } else {
+                op.alu = s_op[r.funct3];
+            }
+            break;
+        }
+        case instrType::AMO:
+            op.kind = Kind::Amo;
+            op.funct = static_cast<uint8_t>(instr >> 27);
+            break;
+        case instrType::ECALL:
+            if (r.funct3 != 0b000) {
+                // CSR instructions; only the read-only counters are implemented, so only the read is performed
+                op.kind = Kind::Csr;
+                op.imm = instr >> 20;
+            } else {
+                op.kind = Kind::Ecall;
+            }
+            break;
+        default:
+            break;
+    }
+    return op;
+}
+
+template <typename F>
+void LockstepSystem::arithmetic(const Op& op, F f) {
+    const uint32_t* a = reg(op.rs1);
+    uint32_t* d = dest(op.rd);
+    if (op.immOperand) {
+        const uint32_t imm = op.imm;
+        forLanes([&](unsigned lane) { d[lane] = f(a[lane], imm); });
+    } else {
+        const uint32_t* b = reg(op.rs2);
+        forLanes([&](unsigned lane) { d[lane] = f(a[lane], b[lane]); });
+    }
+}
+
+void LockstepSystem::execute(const Op& op, const uint32_t pc) {
+    const uint32_t next = pc + op.length;
+    forLanes([&](unsigned lane) { m_lanes[lane].pc = next; });
+
+    switch (op.kind) {
+        case Kind::Nop:
+            break;
+        case Kind::Lui:
+        case Kind::Auipc: {
+            const uint32_t value = op.kind == Kind::Lui ? op.imm : pc + op.imm;
+            uint32_t* d = dest(op.rd);
+            forLanes([&](unsigned lane) { d[lane] = value; });
+            break;
+        }
+        case Kind::Jal: {
+            uint32_t* d = dest(op.rd);
+            forLanes([&](unsigned lane) {
+                d[lane] = next;
+                m_lanes[lane].pc = pc + op.imm;
+            });
+            break;
+        }
+        case Kind::Jalr: {
+            const uint32_t* base = reg(op.rs1);
+            uint32_t* d = dest(op.rd);
+            forLanes([&](unsigned lane) {
+                const uint32_t target = (base[lane] + op.imm) & ~0b1u;
+                d[lane] = next;
+                m_lanes[lane].pc = target;
+            });
+            break;
+        }
+        case Kind::Branch: {
+            const uint32_t* a = reg(op.rs1);
+            const uint32_t* b = reg(op.rs2);
+            forLanes([&](unsigned lane) {
+                if (branchTaken(op.funct, a[lane], b[lane])) {
+                    m_lanes[lane].pc = pc + op.imm;
+                }
+            });
+            break;
+        }
+        case Kind::Load: {
+            const uint32_t* base = reg(op.rs1);
+            uint32_t* d = dest(op.rd);
+            const unsigned size = 1u << (op.funct & 0b11);
+            const bool sign = (op.funct & 0b100) == 0;
+            forLanes([&](unsigned lane) {
+                const uint32_t value = load(m_lanes[lane], base[lane] + op.imm, size);
+                if (size == 1) {
+                    d[lane] = sign ? static_cast<uint32_t>(signextend<int32_t, 8>(value)) : value;
+                } else if (size == 2) {
+                    d[lane] = sign ? static_cast<uint32_t>(signextend<int32_t, 16>(value)) : value;
+                } else {
+                    d[lane] = value;
+                }
+            });
+            break;
+        }
+        case Kind::Store: {
+            const uint32_t* base = reg(op.rs1);
+            const uint32_t* value = reg(op.rs2);
+            const unsigned size = 1u << op.funct;
+            forLanes([&](unsigned lane) { store(m_lanes[lane], base[lane] + op.imm, value[lane], size); });
+            break;
+        }
+        case Kind::Alu:
+            switch (op.alu) {
+                case Alu::Add:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a + b; });
+                    break;
+                case Alu::Sub:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a - b; });
+                    break;
+                case Alu::Sll:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a << (b & 0b11111); });
+                    break;
+                case Alu::Slt:
+                    arithmetic(op, [](uint32_t a, uint32_t b) {
+                        return static_cast<uint32_t>(static_cast<int32_t>(a) < static_cast<int32_t>(b));
+                    });
+                    break;
+                case Alu::Sltu:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return static_cast<uint32_t>(a < b); });
+                    break;
+                case Alu::Xor:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a ^ b; });
+                    break;
+                case Alu::Srl:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a >> (b & 0b11111); });
+                    break;
+                case Alu::Sra:
+                    arithmetic(op, [](uint32_t a, uint32_t b) {
+                        return static_cast<uint32_t>(static_cast<int32_t>(a) >> (b & 0b11111));
+                    });
+                    break;
+                case Alu::Or:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a | b; });
+                    break;
+                case Alu::And:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a & b; });
+                    break;
+                case Alu::Mul:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return a * b; });
+                    break;
+                case Alu::Mulh:
+                    arithmetic(op, mulh);
+                    break;
+                case Alu::Mulhsu:
+                    arithmetic(op, mulhsu);
+                    break;
+                case Alu::Mulhu:
+                    arithmetic(op, mulhu);
+                    break;
+                case Alu::Div:
+                    arithmetic(op, div);
+                    break;
+                case Alu::Divu:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return b == 0 ? static_cast<uint32_t>(-1) : a / b; });
+                    break;
+                case Alu::Rem:
+                    arithmetic(op, rem);
+                    break;
+                case Alu::Remu:
+                    arithmetic(op, [](uint32_t a, uint32_t b) { return b == 0 ? a : a % b; });
+                    break;
+            }
+            break;
+        case Kind::Amo:
+            forLanes([&](unsigned lane) { atomic(lane, op); });
+            break;
+        case Kind::Csr: {
+            uint32_t* d = dest(op.rd);
+            forLanes([&](unsigned lane) { d[lane] = readCounter(op.imm, m_lanes[lane].instructions); });
+            break;
+        }
+        case Kind::Ecall:
+            forLanes([&](unsigned lane) { sysCall(lane); });
+            break;
+    }
+
+    // As for RVISS, lanes finish once their next instruction is outside of the text section
+    forLanes([&](unsigned index) {
+        Lane& lane = m_lanes[index];
+        lane.instructions++;
+        if (lane.state == LaneState::Running && (lane.pc < m_textStart || lane.pc >= m_textEnd)) {
+            lane.state = LaneState::Finished;
+        }
+    });
+}
+
+const LockstepSystem::Page* LockstepSystem::readPage(const Lane& lane, const uint32_t number) const {
+    const auto it = lane.pages.find(number);
+    if (it != lane.pages.end()) {
+        return it->second.get();
+    }
+    const auto shared = m_image.find(number);
+    return shared != m_image.end() ? shared->second.get() : nullptr;
+}
+
+LockstepSystem::Page& LockstepSystem::writePage(Lane& lane, const uint32_t number) {
+    auto& page = lane.pages[number];
+    if (!page) {
+        const auto shared = m_image.find(number);
+        page = shared != m_image.end() ? std::make_unique<Page>(*shared->second) : std::make_unique<Page>();
+        if (shared == m_image.end()) {
+            page->fill(0);
+        }
+    }
+    return *page;
+}
+
+uint32_t LockstepSystem::load(const Lane& lane, const uint32_t address, const unsigned size) const {
+    const uint32_t offset = address & (s_pageSize - 1);
+    if (offset > s_pageSize - size) {
+        // Accesses spanning two pages are rare; read them byte by byte
+        uint32_t value = 0;
+        for (unsigned i = 0; i < size; i++) {
+            value |= load(lane, address + i, 1) << (i * 8);
+        }
+        return value;
+    }
+    const Page* page = readPage(lane, address >> s_pageBits);
+    if (!page) {
+        return 0;
+    }
+    uint32_t value = 0;
+    for (unsigned i = 0; i < size; i++) {
+        value |= static_cast<uint32_t>((*page)[offset + i]) << (i * 8);
+    }
+    return value;
+}
+
+void LockstepSystem::store(Lane& lane, const uint32_t address, const uint32_t value, const unsigned size) {
+    const uint32_t offset = address & (s_pageSize - 1);
+    if (offset > s_pageSize - size) {
+        for (unsigned i = 0; i < size; i++) {
+            store(lane, address + i, value >> (i * 8), 1);
+        }
+        return;
+    }
+    Page& page = writePage(lane, address >> s_pageBits);
+    for (unsigned i = 0; i < size; i++) {
+        page[offset + i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+void LockstepSystem::atomic(const unsigned index, const Op& op) {
+    // As for RVISS, with the reservation of LR.W held per lane
+    Lane& lane = m_lanes[index];
+    const uint32_t address = reg(op.rs1)[index];
+    const uint32_t operand = reg(op.rs2)[index];
+    const uint32_t loaded = load(lane, address, 4);
+    uint32_t result = loaded;
+    uint32_t value = 0;
+    bool write = true;
+    switch (op.funct) {
+        case 0b00010:  // LR.W
+            lane.reservation = address & ~0b11u;
+            write = false;
+            break;
+        case 0b00011:  // SC.W
+            write = lane.reservation == (address & ~0b11u);
+            result = write ? 0 : 1;
+            value = operand;
+            lane.reservation = 1;
+            break;
+        case 0b00001:  // AMOSWAP.W
+            value = operand;
+            break;
+        case 0b00000:  // AMOADD.W
+            value = loaded + operand;
+            break;
+        case 0b00100:  // AMOXOR.W
+            value = loaded ^ operand;
+            break;
+        case 0b01100:  // AMOAND.W
+            value = loaded & operand;
+            break;
+        case 0b01000:  // AMOOR.W
+            value = loaded | operand;
+            break;
+        case 0b10000:  // AMOMIN.W
+            value = static_cast<int32_t>(loaded) < static_cast<int32_t>(operand) ? loaded : operand;
+            break;
+        case 0b10100:  // AMOMAX.W
+            value = static_cast<int32_t>(loaded) > static_cast<int32_t>(operand) ? loaded : operand;
+            break;
+        case 0b11000:  // AMOMINU.W
+            value = std::min(loaded, operand);
+            break;
+        case 0b11100:  // AMOMAXU.W
+            value = std::max(loaded, operand);
+            break;
+        default:
+            return;
+    }
+    if (write) {
+        store(lane, address, value, 4);
+    }
+    dest(op.rd)[index] = result;
+}
+
+void LockstepSystem::sysCall(const unsigned index) {
+    Lane& lane = m_lanes[index];
+    const auto* isa = ISAInfo<ISA::RV32IM>::instance();
+    const uint32_t val = reg(10)[index];
+    switch (reg(17)[index]) {
+        case SysCall::PrintInt:
+            lane.output += QString::number(static_cast<int>(val));
+            break;
+        case SysCall::PrintFloat: {
+            float f;
+            std::memcpy(&f, &val, sizeof(f));
+            lane.output += QString::number(static_cast<double>(f));
+            break;
+        }
+        case SysCall::PrintChar:
+            lane.output += QChar(val);
+            break;
+        case SysCall::PrintIntHex:
+            lane.output += "0x" + QString::number(val, 16).rightJustified(isa->bytes(), '0');
+            break;
+        case SysCall::PrintIntBinary:
+            lane.output += "0b" + QString::number(val, 2).rightJustified(isa->bits(), '0');
+            break;
+        case SysCall::PrintIntUnsigned:
+            lane.output += QString::number(val);
+            break;
+        case SysCall::PrintStr: {
+            QByteArray string;
+            for (uint32_t address = val;; address++) {
+                const char c = static_cast<char>(load(lane, address, 1));
+                if (c == '\0') {
+                    break;
+                }
+                string.append(c);
+            }
+            lane.output += QString::fromUtf8(string);
+            break;
+        }
+        case SysCall::Write: {
+            // Only writes to the console are performed in lockstep
+            const int length = static_cast<int>(reg(12)[index]);
+            if (length < 0 || (val != 1 && val != 2)) {
+                lane.state = LaneState::Unsupported;
+                break;
+            }
+            QByteArray data(length, '\0');
+            for (int i = 0; i < length; i++) {
+                data[i] = static_cast<char>(load(lane, reg(11)[index] + i, 1));
+            }
+            lane.output += QString::fromUtf8(data);
+            dest(10)[index] = static_cast<uint32_t>(length);
+            break;
+        }
+        case SysCall::Exit:
+        case SysCall::Exit2:
+            lane.state = LaneState::Finished;
+            break;
+        default:
+            lane.state = LaneState::Unsupported;
+            break;
+    }
+}
+
+}  // namespace Ripes
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "processorregistry.h"
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * @brief The LockstepSystem class
+ * Executes instances (lanes) of the same RV32IMAC program in lockstep, for batches of functional simulations which only
+ * differ in their inputs, such as the test inputs of an autograder. Each instruction is decoded once and executed for
+ * all lanes at its address, upon a register file laid out as a structure of arrays; lanes of converged control flow
+ * execute an instruction as a single loop over their registers.
+ * The lanes share the text section and the initial memory image of the program, which are read-only. Each lane writes
+ * to copy-on-write pages of its own, overlaying the shared image. Lanes of diverged control flow are masked; each step
+ * executes the instruction at the lowest program counter of the running lanes, for the lanes at that program counter,
+ * such that the lanes reconverge at the join points of structured control flow. Should the steps of a window of
+ * s_efficiencyWindow steps execute fewer than s_minLaneEfficiency of the running lanes on average, the lanes are
+ * executed one at a time from there on.
+ * As for RVISS, each lane executes an instruction per cycle. The console system calls and exit are supported. A lane
+ * which performs any other system call is stopped and marked unsupported, such that it may be simulated by other means.
+ * Stores to the text section do not modify the instructions which are executed, and memory mapped devices are not
+ * modelled.
+ */
+class LockstepSystem {
+public:
+    static constexpr unsigned long long s_efficiencyWindow = 1 << 12;
+    static constexpr double s_minLaneEfficiency = 0.5;
+
+    /**
+     * @brief The LaneInput struct
+     * Initial values of the registers of a lane, and bytes written to its memory by address over the image of the
+     * program.
+     */
+    struct LaneInput {
+        RegisterInitialization registers;
+        std::map<uint32_t, QByteArray> data;
+    };
+
+    struct LaneResult {
+        /// Set if the lane exited or left the text section
+        bool finished = false;
+        /// Set if the lane stopped at a system call which is not supported in lockstep
+        bool unsupported = false;
+        long long instructions = 0;
+        /// Values of the architectural registers of the lane once stopped
+        std::vector<uint32_t> registers;
+        QString output;
+    };
+
+    LockstepSystem(const Program& program, const std::vector<LaneInput>& lanes);
+    ~LockstepSystem();
+
+    /**
+     * @brief run
+     * Executes the running lanes until each of them has stopped or executed @p maxCycles instructions.
+     * @returns true if all lanes have stopped.
+     */
+    bool run(unsigned long long maxCycles);
+
+    unsigned lanes() const { return static_cast<unsigned>(m_lanes.size()); }
+    LaneResult result(unsigned lane) const;
+
+    /// @returns true if the lanes diverged such that they are executed one at a time
+    bool isScalar() const { return m_scalar; }
+    /// Average fraction of the running lanes which each step in lockstep executed
+    double laneEfficiency() const {
+        return m_runningLanes != 0 ? static_cast<double>(m_laneInstructions) / m_runningLanes : 0;
+    }
+
+private:
+    static constexpr unsigned s_pageBits = 12;
+    static constexpr uint32_t s_pageSize = 1 << s_pageBits;
+    using Page = std::array<uint8_t, s_pageSize>;
+    using Pages = std::unordered_map<uint32_t, std::unique_ptr<Page>>;
+
+    enum class Kind : uint8_t { Nop, Lui, Auipc, Jal, Jalr, Branch, Load, Store, Alu, Amo, Csr, Ecall };
+    enum class Alu : uint8_t {
+        Add, Sub, Sll, Slt, Sltu, Xor, Srl, Sra, Or, And, Mul, Mulh, Mulhsu, Mulhu, Div, Divu, Rem, Remu
+    };
+
+    /**
+     * @brief The Op struct
+     * A decoded instruction. funct holds funct3 of branches, loads and stores, and funct5 of atomic memory operations.
+     * The second operand of arithmetic instructions is imm if immOperand is set. length is the size in bytes of the
+     * instruction which the op was decoded from, compressed instructions being decoded from their 32-bit expansion.
+     */
+    struct Op {
+        Kind kind = Kind::Nop;
+        Alu alu = Alu::Add;
+        uint8_t rd = 0, rs1 = 0, rs2 = 0, funct = 0;
+        uint8_t length = 4;
+        bool immOperand = false;
+        uint32_t imm = 0;
+    };
+
+    enum class LaneState : uint8_t { Running, Finished, Unsupported };
+    struct Lane {
+        uint32_t pc = 0;
+        LaneState state = LaneState::Running;
+        long long instructions = 0;
+        uint32_t reservation = 1;
+        Pages pages;
+        QString output;
+    };
+
+    static Op decode(uint32_t instr);
+    const Op& lookupOp(uint32_t pc);
+    /**
+     * @brief selectLanes
+     * Selects the lanes of the next step into m_mask, which execute the instruction at @p pc, out of @p running lanes
+     * which have not reached @p maxCycles.
+     * @returns false if no lane may execute.
+     */
+    bool selectLanes(unsigned long long maxCycles, uint32_t& pc, unsigned& running);
+    void execute(const Op& op, uint32_t pc);
+    void updateEfficiency(unsigned running);
+
+    /**
+     * @brief forLanes
+     * Calls @p f with the index of each lane of the current step. The lanes of a fully converged step are iterated
+     * contiguously, such that simple operations upon the register file may be vectorized by the compiler.
+     */
+    template <typename F>
+    void forLanes(F f) const {
+        if (m_converged) {
+            const unsigned lanes = static_cast<unsigned>(m_lanes.size());
+            for (unsigned lane = 0; lane < lanes; lane++) {
+                f(lane);
+            }
+        } else {
+            for (const unsigned lane : m_mask) {
+                f(lane);
+            }
+        }
+    }
+    template <typename F>
+    void arithmetic(const Op& op, F f);
+
+    /// Register @p r of all lanes. Writes to x0 are directed to a register row which is never read.
+    const uint32_t* reg(unsigned r) const { return &m_registers[r * m_lanes.size()]; }
+    uint32_t* dest(unsigned r) { return &m_registers[(r == 0 ? s_discardRow : r) * m_lanes.size()]; }
+    static constexpr unsigned s_discardRow = 32;
+
+    const Page* readPage(const Lane& lane, uint32_t number) const;
+    Page& writePage(Lane& lane, uint32_t number);
+    uint32_t load(const Lane& lane, uint32_t address, unsigned size) const;
+    void store(Lane& lane, uint32_t address, uint32_t value, unsigned size);
+    void atomic(unsigned index, const Op& op);
+    void sysCall(unsigned index);
+
+    uint32_t m_textStart = 0;
+    uint32_t m_textEnd = 0;
+    Pages m_image;
+    std::unordered_map<uint32_t, Op> m_ops;
+    std::vector<Lane> m_lanes;
+    // Registers of all lanes; row r holds register r of each lane
+    std::vector<uint32_t> m_registers;
+
+    std::vector<unsigned> m_mask;
+    bool m_converged = false;
+    bool m_scalar = false;
+    // Lane executed by scalar steps
+    unsigned m_scalarLane = 0;
+
+    unsigned long long m_windowSteps = 0;
+    unsigned long long m_windowInstructions = 0;
+    unsigned long long m_windowRunning = 0;
+    unsigned long long m_laneInstructions = 0;
+    unsigned long long m_runningLanes = 0;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,126 @@
+#include "loopprofiler.h"
+
+#include <algorithm>
+
+#include "defines.h"
+
+namespace Ripes {
+
+void LoopProfiler::setProgram(const Program* program) {
+    m_kinds.clear();
+    m_targets.clear();
+    m_textStart = 0;
+    if (const auto* text = program ? program->getSection(TEXT_SECTION_NAME) : nullptr) {
+        m_textStart = static_cast<uint32_t>(text->address);
+        const auto* data = reinterpret_cast<const uint8_t*>(text->data.constData());
+        const size_t count = static_cast<size_t>(text->data.size()) / 4;
+        m_kinds.assign(count, Kind::Other);
+        m_targets.assign(count, 0);
+        for (size_t i = 0; i < count; i++) {
+            const uint32_t instr = data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16) |
+                                   (static_cast<uint32_t>(data[i * 4 + 3]) << 24);
+            const uint32_t opcode = instr & 0b1111111;
+            const uint32_t rd = (instr >> 7) & 0b11111;
+            const uint32_t rs1 = (instr >> 15) & 0b11111;
+            const uint32_t pc = m_textStart + static_cast<uint32_t>(i * 4);
+            // Immediates are sign extended through their top bit, instruction bit 31
+            const uint32_t sign = static_cast<uint32_t>(static_cast<int32_t>(instr) >> 31);
+            if (opcode == instrType::BRANCH || (opcode == instrType::JAL && rd == 0)) {
+                const uint32_t imm = opcode == instrType::BRANCH
+                                         ? (sign << 12) | ((instr & 0x80) << 4) | ((instr >> 20) & 0x7e0) |
+                                               ((instr >> 7) & 0x1e)
+                                         : (sign << 20) | (instr & 0xff000) | ((instr >> 9) & 0x800) |
+                                               ((instr >> 20) & 0x7fe);
+                if (static_cast<int32_t>(imm) <= 0) {
+                    m_kinds[i] = Kind::BackEdge;
+                    m_targets[i] = pc + imm;
+                }
+            } else if ((opcode == instrType::JAL || opcode == instrType::JALR) && rd == 1) {
+                m_kinds[i] = Kind::Call;
+            } else if (opcode == instrType::JALR && rd == 0 && rs1 == 1 && (instr >> 20) == 0) {
+                m_kinds[i] = Kind::Return;
+            }
+        }
+    }
+    m_loopAt.assign(m_kinds.size(), s_noLoop);
+    clear();
+}
+
+void LoopProfiler::clear() {
+    m_loops.clear();
+    std::fill(m_loopAt.begin(), m_loopAt.end(), s_noLoop);
+    m_depth = 0;
+    m_callDepth = 0;
+    m_pendingBackEdge = false;
+}
+
+LoopProfiler::Sample LoopProfiler::sample() const {
+    Sample sample = m_sampler ? m_sampler() : Sample();
+    sample.instructions = m_instructions;
+    return sample;
+}
+
+void LoopProfiler::account(Frame& frame, const Sample& sample) {
+    Loop& loop = m_loops[frame.loop];
+    loop.counts += sample - frame.last;
+    loop.measuredIterations++;
+    frame.last = sample;
+}
+
+void LoopProfiler::backEdgeTaken() {
+    const uint32_t index = (m_pendingBranch - m_textStart) >> 2;
+    if (m_loopAt[index] == s_noLoop) {
+        m_loopAt[index] = static_cast<uint32_t>(m_loops.size());
+        Loop loop;
+        loop.branch = m_pendingBranch;
+        loop.target = m_pendingTarget;
+        m_loops.push_back(loop);
+    }
+    const uint32_t loopIndex = m_loopAt[index];
+    Loop& loop = m_loops[loopIndex];
+
+    for (unsigned i = m_depth; i-- > 0;) {
+        if (m_stack[i].loop == loopIndex) {
+            // Loops still open above this one overlap it rather than nest within it, and are dropped
+            m_depth = i + 1;
+            account(m_stack[i], sample());
+            loop.trips++;
+            return;
+        }
+    }
+    if (m_depth == s_maxDepth) {
+        return;
+    }
+    // The loop is entered; its first iteration has just completed, and its second starts
+    m_stack[m_depth++] = {loopIndex, m_callDepth, sample()};
+    loop.entries++;
+    loop.trips += 2;
+}
+
+void LoopProfiler::leaveLoops(uint32_t pc) {
+    bool sampled = false;
+    Sample current;
+    while (m_depth != 0) {
+        Frame& frame = m_stack[m_depth - 1];
+        const Loop& loop = m_loops[frame.loop];
+        const bool inBody = pc >= loop.target && pc <= loop.branch;
+        if (m_callDepth > frame.callDepth || (m_callDepth == frame.callDepth && inBody)) {
+            break;
+        }
+        if (!sampled) {
+            current = sample();
+            sampled = true;
+        }
+        account(frame, current);
+        m_depth--;
+    }
+}
+
+std::vector<LoopProfiler::Loop> LoopProfiler::loops() const {
+    std::vector<Loop> loops = m_loops;
+    std::sort(loops.begin(), loops.end(),
+              [](const Loop& a, const Loop& b) { return a.counts.cycles > b.counts.cycles; });
+    return loops;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * @brief The LoopProfiler class
+ * Detects the natural loops of the loaded program as they execute, and attributes cycles, instructions and data cache
+ * accesses to them. A loop is identified by its back edge; a branch or JAL x0 to a target at or before itself, which
+ * is taken whenever the next retired instruction is the target. A loop is entered once its back edge is first taken,
+ * and left once an instruction outside of [target; branch] retires at the call depth at which it was entered, or the
+ * function it was entered in returns. Each interval between taking the back edge and taking it again or leaving the
+ * loop is one measured iteration; the first iteration after entering a loop precedes its detection, and is only
+ * counted towards the trip count.
+ * Back edges and calls are decoded once per program into a flat array over the text section, such that retiring an
+ * instruction outside of a loop costs a single lookup, and within a loop additionally a range check.
+ */
+class LoopProfiler {
+public:
+    /// Counters from which loops are attributed
+    struct Sample {
+        long long cycles = 0;
+        long long instructions = 0;
+        long long dataAccesses = 0;
+        long long dataMisses = 0;
+        Sample& operator+=(const Sample& other) {
+            cycles += other.cycles;
+            instructions += other.instructions;
+            dataAccesses += other.dataAccesses;
+            dataMisses += other.dataMisses;
+            return *this;
+        }
+        Sample operator-(const Sample& other) const {
+            return {cycles - other.cycles, instructions - other.instructions, dataAccesses - other.dataAccesses,
+                    dataMisses - other.dataMisses};
+        }
+    };
+    /// Samples the counters of the simulation; instructions are counted by the profiler itself
+    using Sampler = std::function<Sample()>;
+
+    /**
+     * @brief The Loop struct
+     * Counts of a loop over its measured iterations. @p entries is the number of times the loop was entered, and
+     * @p trips the total number of iterations executed, including the first iteration of each entry.
+     */
+    struct Loop {
+        uint32_t branch = 0;
+        uint32_t target = 0;
+        long long entries = 0;
+        long long trips = 0;
+        long long measuredIterations = 0;
+        Sample counts;
+
+        double cyclesPerIteration() const {
+            return measuredIterations > 0 ? static_cast<double>(counts.cycles) / measuredIterations : 0;
+        }
+        double cpi() const {
+            return counts.instructions > 0 ? static_cast<double>(counts.cycles) / counts.instructions : 0;
+        }
+        double dataMissRate() const {
+            return counts.dataAccesses > 0 ? static_cast<double>(counts.dataMisses) / counts.dataAccesses : 0;
+        }
+    };
+
+    /// Loops nested deeper than this are not profiled
+    static constexpr unsigned s_maxDepth = 64;
+
+    void setSampler(Sampler sampler) { m_sampler = std::move(sampler); }
+
+    /**
+     * @brief setProgram
+     * Profiles loops within the text section of @p program, or no loops if nullptr, discarding all loops.
+     */
+    void setProgram(const Program* program);
+
+    /**
+     * @brief clear
+     * Discards the counts of all loops. Profiling continues from the current counters, outside of any loop.
+     */
+    void clear();
+
+    /// Records the retirement of the instruction at @p pc
+    void retire(uint32_t pc) {
+        if (m_pendingBackEdge) {
+            m_pendingBackEdge = false;
+            if (pc == m_pendingTarget) {
+                backEdgeTaken();
+            }
+        }
+        if (m_depth != 0) {
+            leaveLoops(pc);
+        }
+        const uint32_t offset = pc - m_textStart;
+        if ((offset >> 2) < m_kinds.size()) {
+            switch (m_kinds[offset >> 2]) {
+                case Kind::Other:
+                    break;
+                case Kind::BackEdge:
+                    m_pendingBackEdge = true;
+                    m_pendingBranch = pc;
+                    m_pendingTarget = m_targets[offset >> 2];
+                    break;
+                case Kind::Call:
+                    m_callDepth++;
+                    break;
+                case Kind::Return:
+                    m_callDepth--;
+                    break;
+            }
+        }
+        m_instructions++;
+    }
+
+    bool empty() const { return m_loops.empty(); }
+
+    /// @returns the counts of each loop which has been entered, sorted by decreasing cycles
+    std::vector<Loop> loops() const;
+
+private:
+    enum class Kind : uint8_t { Other, BackEdge, Call, Return };
+    static constexpr uint32_t s_noLoop = UINT32_MAX;
+
+    struct Frame {
+        uint32_t loop;
+        long long callDepth;
+        Sample last;
+    };
+
+    void backEdgeTaken();
+    void leaveLoops(uint32_t pc);
+    /// Attributes the counts since the last back edge of the loop of @p frame to it, as one measured iteration
+    void account(Frame& frame, const Sample& sample);
+    /// @returns the current counters; the instructions retired before the one being retired
+    Sample sample() const;
+
+    Sampler m_sampler;
+    long long m_instructions = 0;
+
+    uint32_t m_textStart = 0;
+    std::vector<Kind> m_kinds;
+    /// Target of each back edge of the text section
+    std::vector<uint32_t> m_targets;
+    /// Loop index of each back edge of the text section which has been taken
+    std::vector<uint32_t> m_loopAt;
+
+    std::vector<Loop> m_loops;
+
+    std::array<Frame, s_maxDepth> m_stack;
+    unsigned m_depth = 0;
+    long long m_callDepth = 0;
+    bool m_pendingBackEdge = false;
+    uint32_t m_pendingBranch = 0;
+    uint32_t m_pendingTarget = 0;
+};
+
+}  // namespace Ripes
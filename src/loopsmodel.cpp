@@ -0,0 +1,128 @@
+#include "loopsmodel.h"
+
+namespace Ripes {
+
+LoopsModel::LoopsModel(ProcessorHandler* context, QObject* parent) : QAbstractTableModel(parent), m_context(context) {
+    refresh();
+}
+
+QVariant LoopsModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal)
+        return QVariant();
+    if (role == Qt::ToolTipRole) {
+        switch (section) {
+            case Column::Trips:
+                return "Iterations executed, across all entries of the loop";
+            case Column::CyclesPerIteration:
+            case Column::CPI:
+            case Column::DataMissRate:
+                return "Measured from the second iteration of each entry of the loop, once the loop was detected";
+            case Column::CyclePercentage:
+                return "Cycles of the measured iterations, relative to all cycles profiled";
+            default:
+                return QVariant();
+        }
+    }
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+        case Column::Location:
+            return "Loop";
+        case Column::Entries:
+            return "Entries";
+        case Column::Trips:
+            return "Trips";
+        case Column::CyclesPerIteration:
+            return "Cycles/iteration";
+        case Column::CPI:
+            return "CPI";
+        case Column::DataMissRate:
+            return "D-cache miss rate (%)";
+        case Column::CyclePercentage:
+            return "Cycles (%)";
+        default:
+            return QVariant();
+    }
+}
+
+int LoopsModel::rowCount(const QModelIndex&) const {
+    return static_cast<int>(m_loops.size());
+}
+
+int LoopsModel::columnCount(const QModelIndex&) const {
+    return NColumns;
+}
+
+void LoopsModel::refresh() {
+    beginResetModel();
+    m_loops = m_context->getLoopProfiler().loops();
+    m_names.clear();
+    m_totalCycles = m_context->getCycleCount() - m_context->getProfiler().getStartCycle();
+    const Program* program = m_context->getProgram();
+    for (const auto& loop : m_loops) {
+        // Loops are named by their extent, and the symbol containing their head
+        QString name = "0x" + QString::number(loop.target, 16).rightJustified(8, '0') + " - 0x" +
+                       QString::number(loop.branch, 16).rightJustified(8, '0');
+        if (const auto* symbol = program ? program->getSymbolAt(loop.target) : nullptr) {
+            name = symbol->second + ": " + name;
+        }
+        m_names.push_back(name);
+    }
+    endResetModel();
+}
+
+QVariant LoopsModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid())
+        return QVariant();
+
+    const auto& loop = m_loops.at(index.row());
+    const double percentage = m_totalCycles <= 0 ? 0 : 100.0 * loop.counts.cycles / m_totalCycles;
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == Column::Location ? QVariant(Qt::AlignLeft | Qt::AlignVCenter)
+                                                  : QVariant(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    if (role == Qt::UserRole) {
+        switch (index.column()) {
+            case Column::Location:
+                return loop.target;
+            case Column::Entries:
+                return loop.entries;
+            case Column::Trips:
+                return loop.trips;
+            case Column::CyclesPerIteration:
+                return loop.cyclesPerIteration();
+            case Column::CPI:
+                return loop.cpi();
+            case Column::DataMissRate:
+                return loop.dataMissRate();
+            case Column::CyclePercentage:
+                return percentage;
+            default:
+                return QVariant();
+        }
+    }
+
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (index.column()) {
+        case Column::Location:
+            return m_names.at(index.row());
+        case Column::Entries:
+            return QString::number(loop.entries);
+        case Column::Trips:
+            return QString::number(loop.trips);
+        case Column::CyclesPerIteration:
+            return QString::number(loop.cyclesPerIteration(), 'f', 2);
+        case Column::CPI:
+            return QString::number(loop.cpi(), 'f', 2);
+        case Column::DataMissRate:
+            return loop.counts.dataAccesses == 0 ? "-" : QString::number(100.0 * loop.dataMissRate(), 'f', 2);
+        case Column::CyclePercentage:
+            return QString::number(percentage, 'f', 2);
+        default:
+            return QVariant();
+    }
+}
+}  // namespace Ripes
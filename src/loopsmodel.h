@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QAbstractTableModel>
+
+#include <vector>
+
+#include "loopprofiler.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+/**
+ * @brief The LoopsModel class
+ * Table of the loops of the loaded program detected by the loop profiler of the processor handler. Numeric columns
+ * provide their raw values through Qt::UserRole, for sorting.
+ */
+class LoopsModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column {
+        Location = 0,
+        Entries = 1,
+        Trips = 2,
+        CyclesPerIteration = 3,
+        CPI = 4,
+        DataMissRate = 5,
+        CyclePercentage = 6,
+        NColumns
+    };
+    LoopsModel(ProcessorHandler* context, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    const LoopProfiler::Loop& loopForRow(int row) const { return m_loops.at(row); }
+
+public slots:
+    void refresh();
+
+private:
+    std::vector<LoopProfiler::Loop> m_loops;
+    std::vector<QString> m_names;
+    long long m_totalCycles = 0;
+
+    ProcessorHandler* m_context = nullptr;
+};
+}  // namespace Ripes
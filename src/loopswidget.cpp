@@ -0,0 +1,59 @@
+#include "loopswidget.h"
+#include "ui_loopswidget.h"
+
+#include <QClipboard>
+#include <QHeaderView>
+#include <QSortFilterProxyModel>
+
+#include "loopsmodel.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+LoopsWidget::LoopsWidget(QWidget* parent) : QDialog(parent), m_ui(new Ui::LoopsWidget) {
+    m_ui->setupUi(this);
+
+    m_model = new LoopsModel(ProcessorHandler::get(), this);
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+    m_proxyModel->setSortRole(Qt::UserRole);
+    m_ui->loopsView->setModel(m_proxyModel);
+    m_ui->loopsView->setSortingEnabled(true);
+    m_ui->loopsView->sortByColumn(LoopsModel::CyclePercentage, Qt::DescendingOrder);
+    m_ui->loopsView->horizontalHeader()->setSectionResizeMode(LoopsModel::Location, QHeaderView::Stretch);
+    m_ui->loopsView->verticalHeader()->setVisible(false);
+    m_ui->loopsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_ui->loopsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    connect(m_ui->loopsView, &QAbstractItemView::doubleClicked, [=](const QModelIndex& index) {
+        const auto& loop = m_model->loopForRow(m_proxyModel->mapToSource(index).row());
+        emit showAddressRange(loop.target, loop.branch);
+        accept();
+    });
+
+    m_ui->summary->setText(QString::number(m_model->rowCount()) + " loops executed since cycle " +
+                           QString::number(ProcessorHandler::get()->getProfiler().getStartCycle()) + ".");
+    m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
+}
+
+LoopsWidget::~LoopsWidget() {
+    delete m_ui;
+}
+
+void LoopsWidget::on_copy_clicked() {
+    // Copy the table to the clipboard in its current order, including headers
+    QString textualRepr;
+    for (int j = 0; j < m_proxyModel->columnCount(); j++) {
+        textualRepr.append(m_proxyModel->headerData(j, Qt::Horizontal).toString());
+        textualRepr.append('\t');
+    }
+    textualRepr.append('\n');
+    for (int i = 0; i < m_proxyModel->rowCount(); i++) {
+        for (int j = 0; j < m_proxyModel->columnCount(); j++) {
+            textualRepr.append(m_proxyModel->data(m_proxyModel->index(i, j)).toString());
+            textualRepr.append('\t');
+        }
+        textualRepr.append('\n');
+    }
+    QApplication::clipboard()->setText(textualRepr);
+}
+}  // namespace Ripes
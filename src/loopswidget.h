@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QDialog>
+
+QT_FORWARD_DECLARE_CLASS(QSortFilterProxyModel)
+
+namespace Ripes {
+class LoopsModel;
+namespace Ui {
+class LoopsWidget;
+}
+
+/**
+ * @brief The LoopsWidget class
+ * Sortable table of the loops of the loaded program which have been executed. Activating a loop requests its
+ * instructions to be shown.
+ */
+class LoopsWidget : public QDialog {
+    Q_OBJECT
+
+public:
+    LoopsWidget(QWidget* parent = nullptr);
+    ~LoopsWidget() override;
+
+signals:
+    void showAddressRange(uint32_t first, uint32_t last);
+
+private slots:
+    void on_copy_clicked();
+
+private:
+    Ui::LoopsWidget* m_ui = nullptr;
+    LoopsModel* m_model = nullptr;
+    QSortFilterProxyModel* m_proxyModel = nullptr;
+};
+}  // namespace Ripes
@@ -1,8 +1,10 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "comparewidget.h"
 #include "defines.h"
 #include "edittab.h"
+#include "framebuffertab.h"
 #include "loaddialog.h"
 #include "memorytab.h"
 #include "parser.h"
@@ -19,6 +21,7 @@
 #include <QFileDialog>
 #include <QFontDatabase>
 #include <QIcon>
+#include <QJsonDocument>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QStackedWidget>
@@ -59,12 +62,17 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), m_ui(new Ui::Main
     m_memoryTab = new MemoryTab(tb, this);
     m_stackedTabs->insertWidget(2, m_memoryTab);
 
+    tb = addToolBar("Display");
+    tb->setVisible(false);
+    m_framebufferTab = new FramebufferTab(tb, this);
+    m_stackedTabs->insertWidget(3, m_framebufferTab);
+
     // Setup tab bar
     m_ui->tabbar->addFancyTab(QIcon(":/icons/binary-code.svg"), "Editor");
     m_ui->tabbar->addFancyTab(QIcon(":/icons/cpu.svg"), "Processor");
     m_ui->tabbar->addFancyTab(QIcon(":/icons/ram-memory.svg"), "Memory");
+    m_ui->tabbar->addFancyTab(QIcon(":/icons/graph.svg"), "Display");
     connect(m_ui->tabbar, &FancyTabBar::activeIndexChanged, m_stackedTabs, &QStackedWidget::setCurrentIndex);
-    connect(m_ui->tabbar, &FancyTabBar::activeIndexChanged, m_editTab, &EditTab::updateProgramViewerHighlighting);
 
     m_ui->tabbar->setActiveIndex(1);
 
@@ -73,9 +81,12 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), m_ui(new Ui::Main
     // setup and connect widgets
     connect(m_processorTab, &ProcessorTab::update, this, &MainWindow::updateMemoryTab);
     connect(m_processorTab, &ProcessorTab::update, m_editTab, &EditTab::updateProgramViewerHighlighting);
+    connect(m_processorTab, &ProcessorTab::showAddressRange, [=](uint32_t first, uint32_t last) {
+        m_ui->tabbar->setActiveIndex(0);
+        m_editTab->showAddressRange(first, last);
+    });
     connect(this, &MainWindow::update, m_processorTab, &ProcessorTab::restart);
     connect(this, &MainWindow::updateMemoryTab, m_memoryTab, &MemoryTab::update);
-    connect(m_stackedTabs, &QStackedWidget::currentChanged, m_memoryTab, &MemoryTab::update);
     connect(m_editTab, &EditTab::programChanged, ProcessorHandler::get(), &ProcessorHandler::loadProgram);
     connect(m_editTab, &EditTab::editorStateChanged, [=] { this->m_hasSavedFile = false; });
 
@@ -132,6 +143,47 @@ void MainWindow::setupMenus() {
             [saveAsAction](bool enabled) { saveAsAction->setEnabled(enabled); });
     m_ui->menuFile->addAction(saveAsAction);
 
+    auto* saveStatisticsAction = new QAction("Save Statistics Report...", this);
+    connect(saveStatisticsAction, &QAction::triggered, this, &MainWindow::saveStatisticsTriggered);
+    // Statistics are only reported while the processor is not running
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted,
+            [saveStatisticsAction] { saveStatisticsAction->setEnabled(false); });
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished,
+            [saveStatisticsAction] { saveStatisticsAction->setEnabled(true); });
+    m_ui->menuFile->addAction(saveStatisticsAction);
+
+    auto* saveFlameGraphAction = new QAction("Save Flame Graph...", this);
+    saveFlameGraphAction->setToolTip("Save the call stacks of the program in the folded stack format of flame graphs");
+    connect(saveFlameGraphAction, &QAction::triggered, this, &MainWindow::saveFlameGraphTriggered);
+    // The call graph is only accessible while the processor is not running
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted,
+            [saveFlameGraphAction] { saveFlameGraphAction->setEnabled(false); });
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished,
+            [saveFlameGraphAction] { saveFlameGraphAction->setEnabled(true); });
+    m_ui->menuFile->addAction(saveFlameGraphAction);
+
+    auto* compareAction = new QAction("Compare Processors...", this);
+    compareAction->setToolTip(
+        "Simulate the current program on all processors concurrently, and compare their statistics");
+    connect(compareAction, &QAction::triggered, this, &MainWindow::compareProcessorsTriggered);
+    m_ui->menuFile->addAction(compareAction);
+
+    auto* saveSnapshotAction = new QAction("Save Snapshot...", this);
+    connect(saveSnapshotAction, &QAction::triggered, this, &MainWindow::saveSnapshotTriggered);
+    auto* loadSnapshotAction = new QAction("Load Snapshot...", this);
+    connect(loadSnapshotAction, &QAction::triggered, this, &MainWindow::loadSnapshotTriggered);
+    // Snapshots are only saved and restored while the processor is not running
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, [saveSnapshotAction, loadSnapshotAction] {
+        saveSnapshotAction->setEnabled(false);
+        loadSnapshotAction->setEnabled(false);
+    });
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, [saveSnapshotAction, loadSnapshotAction] {
+        saveSnapshotAction->setEnabled(true);
+        loadSnapshotAction->setEnabled(true);
+    });
+    m_ui->menuFile->addAction(saveSnapshotAction);
+    m_ui->menuFile->addAction(loadSnapshotAction);
+
     m_ui->menuFile->addSeparator();
 
     const QIcon exitIcon = QIcon(":/icons/cancel.svg");
@@ -260,6 +312,16 @@ void MainWindow::saveFilesTriggered() {
         QFile file(diag.binaryPath());
         writeBinaryFile(file, m_editTab->getBinaryData());
     }
+
+    if (!diag.memoryPath().isEmpty()) {
+        // The memory image is read from the processor, which must not modify memory while it is written
+        m_processorTab->pause();
+        QString error;
+        if (!MemoryDump::write(ProcessorHandler::get()->getMemory(), diag.memoryPath(), diag.memoryFormat(),
+                               diag.memoryRange(), error)) {
+            QMessageBox::warning(this, "Error", error);
+        }
+    }
 }
 
 void MainWindow::saveFilesAsTriggered() {
@@ -271,6 +333,76 @@ void MainWindow::saveFilesAsTriggered() {
     saveFilesTriggered();
 }
 
+void MainWindow::saveStatisticsTriggered() {
+    const QString path =
+        QFileDialog::getSaveFileName(this, "Save Statistics Report", QString(), "JSON files (*.json);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    auto* handler = ProcessorHandler::get();
+    const QJsonObject report = handler->statisticsReport(m_memoryTab->reportedCaches(), handler->getRunTimeMs());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "Error", "Could not write statistics report to " + path);
+        return;
+    }
+    file.write(QJsonDocument(report).toJson());
+}
+
+void MainWindow::saveFlameGraphTriggered() {
+    const QString cyclesFilter = "Folded stacks, cycles (*.folded)";
+    const QString missesFilter = "Folded stacks, cache misses (*.folded)";
+    QString filter = cyclesFilter;
+    const QString path = QFileDialog::getSaveFileName(this, "Save Flame Graph", QString(),
+                                                      cyclesFilter + ";;" + missesFilter, &filter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "Error", "Could not write flame graph to " + path);
+        return;
+    }
+    const auto metric = filter == missesFilter ? CallGraphProfiler::Metric::Misses : CallGraphProfiler::Metric::Cycles;
+    file.write(ProcessorHandler::get()->getCallGraph().foldedStacks(metric));
+}
+
+void MainWindow::compareProcessorsTriggered() {
+    // The comparison is simulated independently of the current processor, which may keep running
+    CompareWidget w(m_memoryTab->reportedCaches(), this);
+    w.exec();
+}
+
+void MainWindow::saveSnapshotTriggered() {
+    const QString path = QFileDialog::getSaveFileName(this, "Save Snapshot", QString(),
+                                                      "Ripes snapshots (*.rsnap);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!ProcessorHandler::get()->saveSnapshot(path, m_memoryTab->snapshotCaches(), error)) {
+        QMessageBox::warning(this, "Error", error);
+    }
+}
+
+void MainWindow::loadSnapshotTriggered() {
+    const QString path =
+        QFileDialog::getOpenFileName(this, "Load Snapshot", QString(), "Ripes snapshots (*.rsnap);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!ProcessorHandler::get()->restoreSnapshot(path, m_memoryTab->snapshotCaches(), error)) {
+        QMessageBox::warning(this, "Error", "Could not load snapshot: " + error);
+        return;
+    }
+    m_processorTab->snapshotRestored();
+}
+
 void MainWindow::newProgramTriggered() {
     QMessageBox mbox;
     mbox.setWindowTitle("New Program...");
@@ -15,6 +15,7 @@ class MainWindow;
 }
 
 class EditTab;
+class FramebufferTab;
 class MemoryTab;
 class ProcessorTab;
 class ProcessorHandler;
@@ -38,6 +39,11 @@ private slots:
 
     void saveFilesTriggered();
     void saveFilesAsTriggered();
+    void saveStatisticsTriggered();
+    void saveFlameGraphTriggered();
+    void compareProcessorsTriggered();
+    void saveSnapshotTriggered();
+    void loadSnapshotTriggered();
     void newProgramTriggered();
 
     void processorUpdated() { emit updateMemoryTab(); }
@@ -63,5 +69,6 @@ private:
     ProcessorTab* m_processorTab = nullptr;
     EditTab* m_editTab = nullptr;
     MemoryTab* m_memoryTab = nullptr;
+    FramebufferTab* m_framebufferTab = nullptr;
 };
 }  // namespace Ripes
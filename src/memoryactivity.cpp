@@ -0,0 +1,89 @@
+#include "memoryactivity.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+void MemoryActivity::clear(long long cycle, unsigned undoDepth) {
+    m_pages.clear();
+    m_pageIndices.clear();
+    m_workingSet.clear();
+    m_undo.clear();
+    m_startCycle = cycle;
+    m_undoDepth = undoDepth;
+    m_hasLastPage = false;
+    m_generation++;
+}
+
+void MemoryActivity::record(long long cycle, uint32_t address, bool write) {
+    if (cycle < m_startCycle) {
+        return;
+    }
+
+    const uint32_t pageAddress = address & ~(s_pageSize - 1);
+    if (!m_hasLastPage || pageAddress != m_lastPage) {
+        const auto it = m_pageIndices.find(pageAddress);
+        if (it == m_pageIndices.end()) {
+            m_lastIndex = static_cast<unsigned>(m_pages.size());
+            m_pageIndices[pageAddress] = m_lastIndex;
+            m_pages.emplace_back();
+            m_pages.back().address = pageAddress;
+        } else {
+            m_lastIndex = it->second;
+        }
+        m_lastPage = pageAddress;
+        m_hasLastPage = true;
+    }
+
+    Page& page = m_pages[m_lastIndex];
+    (write ? page.writes : page.reads)++;
+    const long long interval = intervalOf(cycle);
+    if (m_workingSet.size() <= static_cast<size_t>(interval)) {
+        m_workingSet.resize(interval + 1, 0);
+    }
+    m_undo.push_back({cycle, m_lastIndex, write, page.lastInterval});
+    if (m_undo.size() > m_undoDepth) {
+        m_undo.pop_front();
+    }
+    if (page.lastInterval != interval) {
+        page.lastInterval = interval;
+        m_workingSet[interval]++;
+    }
+    m_generation++;
+}
+
+void MemoryActivity::reverse(long long cycle) {
+    if (!m_undo.empty() && m_undo.back().cycle == cycle) {
+        const UndoEntry entry = m_undo.back();
+        m_undo.pop_back();
+        Page& page = m_pages[entry.page];
+        (entry.write ? page.writes : page.reads)--;
+        if (page.lastInterval != entry.prevInterval) {
+            m_workingSet[page.lastInterval]--;
+            page.lastInterval = entry.prevInterval;
+        }
+        // A page which is no longer accessed at all is removed, if it was the most recently added page
+        if (page.accesses() == 0 && entry.page + 1 == m_pages.size()) {
+            m_pageIndices.erase(page.address);
+            m_pages.pop_back();
+            m_hasLastPage = false;
+        }
+        m_generation++;
+    }
+
+    const long long intervals = cycle > m_startCycle ? intervalOf(cycle - 1) + 1 : 0;
+    if (m_workingSet.size() > static_cast<size_t>(intervals)) {
+        m_workingSet.resize(intervals);
+        m_generation++;
+    }
+}
+
+long long MemoryActivity::maxAccesses() const {
+    long long max = 0;
+    for (const auto& page : m_pages) {
+        max = std::max(max, page.accesses());
+    }
+    return max;
+}
+
+}  // namespace Ripes
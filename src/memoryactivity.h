@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief The MemoryActivity class
+ * Counts the data memory reads and writes of a processor per page of memory, and the working set of the processor; the
+ * number of distinct pages accessed within each interval of s_intervalCycles cycles. Recording an access costs a single
+ * page lookup, which is skipped for consecutive accesses to the same page. Accesses of the most recent cycles may be
+ * undone, as the processor is reversed.
+ */
+class MemoryActivity {
+public:
+    static constexpr unsigned s_pageBits = 12;
+    static constexpr unsigned s_pageSize = 1 << s_pageBits;
+    static constexpr unsigned s_intervalCycles = 1000;
+
+    struct Page {
+        uint32_t address = 0;
+        long long reads = 0;
+        long long writes = 0;
+        long long accesses() const { return reads + writes; }
+        /// Index of the latest working set interval in which the page was accessed
+        long long lastInterval = -1;
+    };
+
+    /**
+     * @brief clear
+     * Discards all counts. Counting continues from @p cycle, at which the first working set interval starts. Accesses of
+     * up to @p undoDepth of the most recently recorded cycles can be undone.
+     */
+    void clear(long long cycle, unsigned undoDepth);
+
+    /// Records an access to @p address in @p cycle
+    void record(long long cycle, uint32_t address, bool write);
+
+    /**
+     * @brief reverse
+     * Removes the access recorded in @p cycle (if any), and all working set intervals starting after it, as the
+     * processor has been reversed past @p cycle.
+     */
+    void reverse(long long cycle);
+
+    /// @returns the accessed pages, in the order in which they were first accessed
+    const std::vector<Page>& pages() const { return m_pages; }
+    /// @returns the number of distinct pages accessed within each working set interval, starting at getStartCycle()
+    const std::vector<unsigned>& workingSet() const { return m_workingSet; }
+    long long getStartCycle() const { return m_startCycle; }
+    long long maxAccesses() const;
+
+    /// @returns a counter which is incremented whenever the counts change, for views to detect updates
+    unsigned long long generation() const { return m_generation; }
+
+private:
+    struct UndoEntry {
+        long long cycle;
+        unsigned page;
+        bool write;
+        long long prevInterval;
+    };
+
+    long long intervalOf(long long cycle) const { return (cycle - m_startCycle) / s_intervalCycles; }
+
+    std::vector<Page> m_pages;
+    std::unordered_map<uint32_t, unsigned> m_pageIndices;
+    std::vector<unsigned> m_workingSet;
+    long long m_startCycle = 0;
+    unsigned long long m_generation = 0;
+
+    std::deque<UndoEntry> m_undo;
+    unsigned m_undoDepth = 0;
+
+    // Page of the previously recorded access
+    uint32_t m_lastPage = 0;
+    unsigned m_lastIndex = 0;
+    bool m_hasLastPage = false;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,233 @@
+#include "memorydump.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace Ripes {
+namespace MemoryDump {
+
+namespace {
+constexpr unsigned s_bytesPerLine = 16;
+/// Encoded output is buffered up to this size before being written to the file
+constexpr int s_bufferSize = 64 * 1024;
+constexpr char s_hexDigits[] = "0123456789ABCDEF";
+
+/**
+ * @brief The Writer class
+ * Encodes blocks of memory in a given format into a buffered file.
+ */
+class Writer {
+public:
+    Writer(QFile& file, Format format) : m_file(file), m_format(format) { m_buffer.reserve(s_bufferSize + 256); }
+
+    /// Encodes the @p size bytes of @p data, located at @p address
+    void bytes(uint32_t address, const uint8_t* data, unsigned size) {
+        switch (m_format) {
+            case Format::Binary:
+                m_buffer.append(reinterpret_cast<const char*>(data), static_cast<int>(size));
+                break;
+            case Format::IntelHex:
+                intelHex(address, data, size);
+                break;
+            case Format::Verilog:
+                verilog(address, data, size);
+                break;
+        }
+        flushIfFull();
+    }
+
+    /// Writes @p size zero bytes to a raw binary image
+    void zeros(uint64_t size) {
+        while (size != 0) {
+            const auto count = static_cast<int>(std::min<uint64_t>(size, s_bufferSize));
+            m_buffer.append(count, '\0');
+            size -= static_cast<uint64_t>(count);
+            flushIfFull();
+        }
+    }
+
+    /// Terminates the image, and writes any buffered output
+    bool finish() {
+        if (m_format == Format::IntelHex) {
+            m_buffer.append(":00000001FF\n");
+        }
+        flush();
+        return m_ok;
+    }
+
+private:
+    void hexByte(uint8_t byte) {
+        m_buffer.append(s_hexDigits[byte >> 4]);
+        m_buffer.append(s_hexDigits[byte & 0xF]);
+    }
+
+    /// Appends an Intel HEX record of @p type, followed by its checksum
+    void record(uint8_t type, uint16_t offset, const uint8_t* data, unsigned size) {
+        m_buffer.append(':');
+        uint8_t checksum = 0;
+        const uint8_t header[] = {static_cast<uint8_t>(size), static_cast<uint8_t>(offset >> 8),
+                                  static_cast<uint8_t>(offset), type};
+        for (const uint8_t byte : header) {
+            hexByte(byte);
+            checksum += byte;
+        }
+        for (unsigned i = 0; i < size; i++) {
+            hexByte(data[i]);
+            checksum += data[i];
+        }
+        hexByte(static_cast<uint8_t>(-checksum));
+        m_buffer.append('\n');
+    }
+
+    void intelHex(uint32_t address, const uint8_t* data, unsigned size) {
+        while (size != 0) {
+            const uint16_t upper = static_cast<uint16_t>(address >> 16);
+            if (upper != m_upperAddress) {
+                const uint8_t segment[] = {static_cast<uint8_t>(upper >> 8), static_cast<uint8_t>(upper)};
+                record(0x04 /*extended linear address*/, 0, segment, 2);
+                m_upperAddress = upper;
+            }
+            // Records may not cross a 64 KiB boundary
+            const unsigned count = std::min({size, s_bytesPerLine, 0x10000 - (address & 0xFFFF)});
+            record(0x00 /*data*/, static_cast<uint16_t>(address), data, count);
+            address += count;
+            data += count;
+            size -= count;
+        }
+    }
+
+    void verilog(uint32_t address, const uint8_t* data, unsigned size) {
+        if (!m_nextAddress || *m_nextAddress != address) {
+            m_buffer.append('@');
+            for (int shift = 28; shift >= 0; shift -= 4) {
+                m_buffer.append(s_hexDigits[(address >> shift) & 0xF]);
+            }
+            m_buffer.append('\n');
+        }
+        m_nextAddress = static_cast<uint64_t>(address) + size;
+        for (unsigned i = 0; i < size; i++) {
+            hexByte(data[i]);
+            m_buffer.append((i + 1) % s_bytesPerLine == 0 || i + 1 == size ? '\n' : ' ');
+        }
+    }
+
+    void flushIfFull() {
+        if (m_buffer.size() >= s_bufferSize) {
+            flush();
+        }
+    }
+
+    void flush() {
+        m_ok &= m_file.write(m_buffer) == m_buffer.size();
+        m_buffer.clear();
+    }
+
+    QFile& m_file;
+    Format m_format;
+    QByteArray m_buffer;
+    bool m_ok = true;
+    uint16_t m_upperAddress = 0;
+    std::optional<uint64_t> m_nextAddress;
+};
+
+/// Reads the @p size bytes at @p address into @p data. Unpopulated bytes read as 0, and are left unpopulated.
+void readBytes(const vsrtl::core::SparseArray& memory, uint32_t address, uint8_t* data, unsigned size) {
+    for (unsigned i = 0; i < size; i++) {
+        data[i] = memory.contains(address + i) ? static_cast<uint8_t>(memory.readMemConst(address + i)) : 0;
+    }
+}
+}  // namespace
+
+bool parseFormat(const QString& name, Format& format) {
+    if (name == "bin") {
+        format = Format::Binary;
+    } else if (name == "ihex") {
+        format = Format::IntelHex;
+    } else if (name == "verilog") {
+        format = Format::Verilog;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString suffix(Format format) {
+    switch (format) {
+        case Format::Binary:
+            return ".img";
+        case Format::IntelHex:
+            return ".hex";
+        case Format::Verilog:
+            return ".mem";
+    }
+    Q_UNREACHABLE();
+}
+
+bool parseRange(const QString& text, Range& range) {
+    const QStringList bounds = text.split('-');
+    if (bounds.size() != 2) {
+        return false;
+    }
+    bool firstOk, lastOk;
+    range.first = bounds[0].trimmed().toUInt(&firstOk, 16);
+    range.last = bounds[1].trimmed().toUInt(&lastOk, 16);
+    return firstOk && lastOk && range.first <= range.last;
+}
+
+bool write(const vsrtl::core::SparseArray& memory, const QString& path, Format format,
+           const std::optional<Range>& range, QString& error) {
+    // Blocks of at most a page are written; either the pages overlapping the range, or all populated pages
+    std::vector<Range> blocks;
+    if (range) {
+        for (uint64_t address = range->first; address <= range->last;) {
+            const uint64_t pageEnd = (address | (s_pageSize - 1));
+            const uint64_t last = std::min<uint64_t>(pageEnd, range->last);
+            blocks.push_back({static_cast<uint32_t>(address), static_cast<uint32_t>(last)});
+            address = last + 1;
+        }
+    } else {
+        std::set<uint32_t> pages;
+        for (const auto& entry : memory) {
+            pages.insert(static_cast<uint32_t>(entry.first) >> s_pageBits);
+        }
+        for (const uint32_t page : pages) {
+            blocks.push_back({page << s_pageBits, (page << s_pageBits) | (s_pageSize - 1)});
+        }
+        if (format == Format::Binary && !blocks.empty() &&
+            static_cast<uint64_t>(blocks.back().last) - blocks.front().first + 1 > s_maxBinarySpan) {
+            error = "The populated memory spans more than " + QString::number(s_maxBinarySpan >> 20) +
+                    " MiB; give an address range or use a hex format";
+            return false;
+        }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = "Could not open " + path + " for writing";
+        return false;
+    }
+    Writer writer(file, format);
+    std::vector<uint8_t> page(s_pageSize);
+    std::optional<uint64_t> nextAddress;
+    for (const Range& block : blocks) {
+        if (format == Format::Binary && nextAddress) {
+            // Zero-fill the gap between populated pages
+            writer.zeros(block.first - *nextAddress);
+        }
+        const unsigned size = block.last - block.first + 1;
+        readBytes(memory, block.first, page.data(), size);
+        writer.bytes(block.first, page.data(), size);
+        nextAddress = static_cast<uint64_t>(block.last) + 1;
+    }
+    if (!writer.finish()) {
+        error = "Could not write " + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace MemoryDump
+}  // namespace Ripes
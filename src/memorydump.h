@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <optional>
+
+#include "VSRTL/core/vsrtl_memory.h"
+
+namespace Ripes {
+
+/**
+ * Export of memory images for use outside of Ripes, such as for initializing the memories of FPGA or RTL simulation
+ * flows. Images are streamed to their file page by page, straight from the memory address space, such that no copy of
+ * the image is collected in host memory.
+ */
+namespace MemoryDump {
+constexpr unsigned s_pageBits = 12;
+constexpr unsigned s_pageSize = 1 << s_pageBits;
+/// Largest span of memory which is written as a raw binary image, gaps between populated pages included
+constexpr uint64_t s_maxBinarySpan = 256 * 1024 * 1024;
+
+enum class Format {
+    /// Raw bytes, without any addresses
+    Binary,
+    /// Intel HEX records of 16 bytes, with extended linear address records for addresses beyond 64 KiB
+    IntelHex,
+    /// Byte-wide Verilog $readmemh image; '@' address markers followed by lines of 16 bytes, as per objcopy -O verilog
+    Verilog
+};
+
+/// Inclusive range of addresses
+struct Range {
+    uint32_t first = 0;
+    uint32_t last = 0;
+};
+
+/// Parses the format names 'bin', 'ihex' and 'verilog'
+bool parseFormat(const QString& name, Format& format);
+/// @returns the file name suffix of images of @p format
+QString suffix(Format format);
+/// Parses a range given as <first>-<last>, of (0x-prefixed) hex addresses
+bool parseRange(const QString& text, Range& range);
+
+/**
+ * @brief write
+ * Writes the bytes of @p range of @p memory to @p path in @p format, or, if no range is given, all pages of memory
+ * which contain a populated byte. Bytes which are not populated are written as 0. Raw binary images of all populated
+ * pages span from the first to the last page, with the gaps between them zero-filled, and are limited to
+ * s_maxBinarySpan bytes.
+ * @returns false if the image could not be written, with a description of the error in @p error.
+ */
+bool write(const vsrtl::core::SparseArray& memory, const QString& path, Format format,
+           const std::optional<Range>& range, QString& error);
+}  // namespace MemoryDump
+
+}  // namespace Ripes
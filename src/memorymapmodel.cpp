@@ -0,0 +1,118 @@
+#include "memorymapmodel.h"
+
+#include <QColor>
+
+namespace Ripes {
+
+MemoryMapModel::MemoryMapModel(ProcessorHandler* context, QObject* parent)
+    : QAbstractTableModel(parent), m_context(context) {
+    refresh();
+}
+
+QVariant MemoryMapModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+        case Column::Page:
+            return "Page";
+        case Column::Reads:
+            return "Reads";
+        case Column::Writes:
+            return "Writes";
+        case Column::Accesses:
+            return "Accesses";
+        default:
+            return QVariant();
+    }
+}
+
+int MemoryMapModel::rowCount(const QModelIndex&) const {
+    return m_rows;
+}
+
+int MemoryMapModel::columnCount(const QModelIndex&) const {
+    return NColumns;
+}
+
+uint32_t MemoryMapModel::addressForRow(int row) const {
+    const auto& pages = m_context->getMemoryActivity().pages();
+    return row >= 0 && row < static_cast<int>(pages.size()) ? pages[row].address : 0;
+}
+
+void MemoryMapModel::refresh() {
+    const auto& activity = m_context->getMemoryActivity();
+    if (activity.generation() == m_generation) {
+        return;
+    }
+    m_generation = activity.generation();
+    m_maxAccesses = activity.maxAccesses();
+
+    const int pages = static_cast<int>(activity.pages().size());
+    if (pages < m_rows) {
+        beginResetModel();
+        m_rows = pages;
+        endResetModel();
+        return;
+    }
+    if (pages > m_rows) {
+        beginInsertRows(QModelIndex(), m_rows, pages - 1);
+        m_rows = pages;
+        endInsertRows();
+    }
+    if (m_rows > 0) {
+        emit dataChanged(index(0, 0), index(m_rows - 1, NColumns - 1));
+    }
+}
+
+QVariant MemoryMapModel::data(const QModelIndex& index, int role) const {
+    const auto& pages = m_context->getMemoryActivity().pages();
+    if (!index.isValid() || index.row() >= static_cast<int>(pages.size()))
+        return QVariant();
+
+    const auto& page = pages[index.row()];
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == Column::Page ? QVariant(Qt::AlignLeft | Qt::AlignVCenter)
+                                              : QVariant(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    if (role == Qt::BackgroundRole && index.column() == Column::Accesses) {
+        if (m_maxAccesses == 0 || page.accesses() == 0) {
+            return QVariant();
+        }
+        const double heat = static_cast<double>(page.accesses()) / m_maxAccesses;
+        return QColor(255, 0, 0, static_cast<int>(30 + 170 * heat));
+    }
+
+    if (role == Qt::UserRole) {
+        switch (index.column()) {
+            case Column::Page:
+                return page.address;
+            case Column::Reads:
+                return page.reads;
+            case Column::Writes:
+                return page.writes;
+            case Column::Accesses:
+                return page.accesses();
+            default:
+                return QVariant();
+        }
+    }
+
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (index.column()) {
+        case Column::Page:
+            return "0x" + QString::number(page.address, 16).rightJustified(8, '0') + " - 0x" +
+                   QString::number(page.address + MemoryActivity::s_pageSize - 1, 16).rightJustified(8, '0');
+        case Column::Reads:
+            return QString::number(page.reads);
+        case Column::Writes:
+            return QString::number(page.writes);
+        case Column::Accesses:
+            return QString::number(page.accesses());
+        default:
+            return QVariant();
+    }
+}
+}  // namespace Ripes
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QAbstractTableModel>
+
+#include "memoryactivity.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MemoryMapModel class
+ * Table of the pages of memory accessed by the current processor, as counted by the memory activity of the processor
+ * handler. The accesses of each page are shaded by their share of the accesses of the most accessed page. Numeric
+ * columns provide their raw values through Qt::UserRole, for sorting.
+ */
+class MemoryMapModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { Page = 0, Reads = 1, Writes = 2, Accesses = 3, NColumns };
+    MemoryMapModel(ProcessorHandler* context, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /// @returns the address of the page at @p row
+    uint32_t addressForRow(int row) const;
+
+public slots:
+    /**
+     * @brief refresh
+     * Updates the model to the current counts. Rows of newly accessed pages are appended, and the model is only reset
+     * if pages were removed (ie. by a reset or reversal of the processor).
+     */
+    void refresh();
+
+private:
+    int m_rows = 0;
+    long long m_maxAccesses = 0;
+    unsigned long long m_generation = 0;
+
+    ProcessorHandler* m_context = nullptr;
+};
+}  // namespace Ripes
@@ -0,0 +1,113 @@
+#include "memorymapwidget.h"
+#include "ui_memorymapwidget.h"
+
+#include <QHeaderView>
+#include <QSortFilterProxyModel>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+#include <algorithm>
+
+#include "memorymapmodel.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+MemoryMapWidget::MemoryMapWidget(QWidget* parent) : QWidget(parent), m_ui(new Ui::MemoryMapWidget) {
+    m_ui->setupUi(this);
+
+    m_model = new MemoryMapModel(ProcessorHandler::get(), this);
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+    m_proxyModel->setSortRole(Qt::UserRole);
+    m_ui->pagesView->setModel(m_proxyModel);
+    m_ui->pagesView->setSortingEnabled(true);
+    m_ui->pagesView->sortByColumn(MemoryMapModel::Page, Qt::AscendingOrder);
+    m_ui->pagesView->horizontalHeader()->setSectionResizeMode(MemoryMapModel::Page, QHeaderView::Stretch);
+    m_ui->pagesView->verticalHeader()->setVisible(false);
+    connect(m_ui->pagesView, &QTableView::doubleClicked, [=](const QModelIndex& index) {
+        emit pageSelected(m_model->addressForRow(m_proxyModel->mapToSource(index).row()));
+    });
+
+    m_chart = new QChart();
+    m_chart->legend()->hide();
+    m_chart->setTitle("Working set (pages accessed per " + QString::number(MemoryActivity::s_intervalCycles) +
+                      " cycles)");
+    m_series = new QLineSeries(m_chart);
+    m_chart->addSeries(m_series);
+    m_chart->createDefaultAxes();
+    auto* chartView = new QChartView(m_chart, this);
+    chartView->setRenderHint(QPainter::Antialiasing);
+    m_ui->workingSetLayout->addWidget(chartView);
+}
+
+MemoryMapWidget::~MemoryMapWidget() {
+    delete m_ui;
+}
+
+void MemoryMapWidget::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    // The counts may have changed arbitrarily while hidden
+    m_plottedIntervals = -1;
+    updateView();
+}
+
+void MemoryMapWidget::updateView() {
+    if (!isVisible()) {
+        return;
+    }
+    m_model->refresh();
+    updatePlot();
+
+    const auto& activity = ProcessorHandler::get()->getMemoryActivity();
+    const auto& workingSet = activity.workingSet();
+    const unsigned latest = workingSet.empty() ? 0 : workingSet.back();
+    m_ui->summary->setText(QString::number(activity.pages().size()) + " pages accessed since cycle " +
+                           QString::number(activity.getStartCycle()) + ". Working set of the latest interval: " +
+                           QString::number(latest) + " pages (" +
+                           QString::number(latest * MemoryActivity::s_pageSize / 1024) + " KiB).");
+}
+
+void MemoryMapWidget::updatePlot() {
+    const auto& activity = ProcessorHandler::get()->getMemoryActivity();
+    const auto& workingSet = activity.workingSet();
+    const int intervals = static_cast<int>(workingSet.size());
+    const auto pointOf = [&](int interval) {
+        return QPointF(activity.getStartCycle() + static_cast<double>(interval) * MemoryActivity::s_intervalCycles,
+                       workingSet[interval]);
+    };
+
+    if (intervals < m_plottedIntervals || m_series->count() != m_plottedIntervals) {
+        // Intervals were removed; replot all intervals in one go
+        QVector<QPointF> points;
+        points.reserve(intervals);
+        m_maxWorkingSet = 0;
+        for (int i = 0; i < intervals; i++) {
+            points.append(pointOf(i));
+            m_maxWorkingSet = std::max(m_maxWorkingSet, workingSet[i]);
+        }
+        m_series->replace(points);
+    } else {
+        // The latest plotted interval may still have been accumulating accesses
+        if (m_plottedIntervals > 0) {
+            m_series->replace(m_plottedIntervals - 1, pointOf(m_plottedIntervals - 1));
+            m_maxWorkingSet = std::max(m_maxWorkingSet, workingSet[m_plottedIntervals - 1]);
+        }
+        for (int i = m_plottedIntervals; i < intervals; i++) {
+            m_series->append(pointOf(i));
+            m_maxWorkingSet = std::max(m_maxWorkingSet, workingSet[i]);
+        }
+    }
+    m_plottedIntervals = intervals;
+
+    if (auto* axisX = qobject_cast<QValueAxis*>(m_chart->axes(Qt::Horizontal).first())) {
+        axisX->setRange(activity.getStartCycle(),
+                        activity.getStartCycle() + std::max(1, intervals) * MemoryActivity::s_intervalCycles);
+        axisX->setLabelFormat("%d");
+    }
+    if (auto* axisY = qobject_cast<QValueAxis*>(m_chart->axes(Qt::Vertical).first())) {
+        axisY->setRange(0, std::max(1u, m_maxWorkingSet));
+        axisY->setLabelFormat("%d");
+    }
+}
+}  // namespace Ripes
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QWidget>
+#include <QtCharts/QChartGlobal>
+
+QT_FORWARD_DECLARE_CLASS(QSortFilterProxyModel)
+
+QT_CHARTS_BEGIN_NAMESPACE
+class QChart;
+class QLineSeries;
+QT_CHARTS_END_NAMESPACE
+
+QT_CHARTS_USE_NAMESPACE
+
+namespace Ripes {
+class MemoryMapModel;
+namespace Ui {
+class MemoryMapWidget;
+}
+
+/**
+ * @brief The MemoryMapWidget class
+ * Overview of the data memory activity of the current processor; a sortable heatmap of the read and write counts of
+ * each accessed page, and a plot of the working set over time.
+ */
+class MemoryMapWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    MemoryMapWidget(QWidget* parent = nullptr);
+    ~MemoryMapWidget() override;
+
+public slots:
+    /// Updates the table and plot to the current counts. Skipped while the widget is hidden.
+    void updateView();
+
+signals:
+    /// Emitted when a page is double-clicked, with the address of the page
+    void pageSelected(uint32_t address);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+
+private:
+    /// Appends the working set intervals which have not yet been plotted, and replots if intervals were removed
+    void updatePlot();
+
+    Ui::MemoryMapWidget* m_ui = nullptr;
+    MemoryMapModel* m_model = nullptr;
+    QSortFilterProxyModel* m_proxyModel = nullptr;
+    QChart* m_chart = nullptr;
+    QLineSeries* m_series = nullptr;
+    int m_plottedIntervals = 0;
+    unsigned m_maxWorkingSet = 0;
+};
+}  // namespace Ripes
@@ -1,14 +1,18 @@
 #include "memorymodel.h"
+#include "hostprofiler.h"
 
 #include <QBrush>
 #include <QFont>
 
 namespace Ripes {
 
-MemoryModel::MemoryModel(QObject* parent) : QAbstractTableModel(parent) {}
+MemoryModel::MemoryModel(ProcessorHandler* context, QObject* parent)
+    : QAbstractTableModel(parent), m_context(context) {
+    connect(m_context, &ProcessorHandler::liveStateChanged, this, &MemoryModel::liveStateChanged);
+}
 
 int MemoryModel::columnCount(const QModelIndex&) const {
-    return FIXED_COLUMNS_CNT + ProcessorHandler::get()->currentISA()->bytes() /* byte columns */;
+    return FIXED_COLUMNS_CNT + m_context->currentISA()->bytes() /* byte columns */;
 }
 
 int MemoryModel::rowCount(const QModelIndex&) const {
@@ -16,26 +20,139 @@ int MemoryModel::rowCount(const QModelIndex&) const {
 }
 
 void MemoryModel::processorWasClocked() {
-    // Reload model
+    RIPES_PROFILE_SCOPE("MemoryModel::processorWasClocked");
+    if (m_rows.size() != m_rowsVisible) {
+        reload();
+        return;
+    }
+
+    m_live = m_context->liveState();
+    if (!m_context->memoryWritesSince(m_writeCursor, m_writes)) {
+        refreshRows();
+        return;
+    }
+
+    const int lastColumn = columnCount() - 1;
+
+    const unsigned bytes = m_context->currentISA()->bytes();
+    const long long topAddress = rowAddress(0);
+    for (const auto& write : m_writes) {
+        // Refresh each row overlapped by the write
+        const long long first = write.address - (write.address % bytes);
+        const long long last = static_cast<long long>(write.address) + write.bytes - 1;
+        for (long long address = first; address <= last; address += bytes) {
+            if (address > topAddress || (topAddress - address) / bytes >= static_cast<long long>(m_rows.size())) {
+                continue;
+            }
+            const int row = static_cast<int>((topAddress - address) / bytes);
+            if (refreshRow(row)) {
+                emit dataChanged(index(row, 0), index(row, lastColumn));
+            }
+        }
+    }
+}
+
+void MemoryModel::liveStateChanged() {
+    m_live = m_context->liveState();
+    if (!m_live) {
+        return;
+    }
+    if (m_rows.size() != m_rowsVisible) {
+        reload();
+        return;
+    }
+    refreshRows();
+}
+
+void MemoryModel::refreshRows() {
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int row = 0; row < static_cast<int>(m_rows.size()); row++) {
+        if (refreshRow(row)) {
+            firstChanged = firstChanged < 0 ? row : firstChanged;
+            lastChanged = row;
+        }
+    }
+    if (firstChanged >= 0) {
+        emit dataChanged(index(firstChanged, 0), index(lastChanged, columnCount() - 1));
+    }
+}
+
+void MemoryModel::reload() {
+    m_live = m_context->liveState();
     beginResetModel();
+    // The write log is consumed, given that all rows are read anew
+    m_context->memoryWritesSince(m_writeCursor, m_writes);
+    m_rows.assign(m_rowsVisible, Row());
+    for (int row = 0; row < static_cast<int>(m_rows.size()); row++) {
+        refreshRow(row, true);
+    }
     endResetModel();
 }
 
+long long MemoryModel::rowAddress(int row) const {
+    const auto bytes = m_context->currentISA()->bytes();
+    return static_cast<long long>(m_centralAddress) + ((((m_rowsVisible * bytes) / 2) / bytes) * bytes) -
+           (row * bytes);
+}
+
+bool MemoryModel::refreshRow(int row, bool force) {
+    Row& entry = m_rows[row];
+    const unsigned bytes = m_context->currentISA()->bytes();
+    const long long address = rowAddress(row);
+    const bool valid = validAddress(address);
+    uint32_t present = 0;
+    uint32_t value = 0;
+    if (valid && m_live) {
+        value = m_live->read(static_cast<uint32_t>(address), bytes, present);
+    } else if (valid) {
+        const auto& memory = m_context->getMemory();
+        for (unsigned i = 0; i < bytes; i++) {
+            present |= memory.contains(static_cast<unsigned>(address + i)) ? 1u << i : 0;
+        }
+        // Dont read memory which is not present (this will create an entry in the memory if done so).
+        if (present != 0) {
+            value = memory.readMemConst(static_cast<unsigned>(address));
+        }
+    }
+
+    if (!force && entry.address == address && entry.valid == valid && entry.present == present &&
+        entry.value == value) {
+        return false;
+    }
+
+    if (force || entry.address != address) {
+        entry.addressText = valid ? encodeRadixValue(address, Radix::Hex) : QString("-");
+    }
+    entry.address = address;
+    entry.valid = valid;
+    entry.present = present;
+    entry.value = value;
+    // Bytes which are not present are shown as "fake" entries of X's, and invalid addresses as "-"
+    entry.wordText = !valid ? "-" : !(present & 1) ? "X" : encodeRadixValue(value, m_radix, bytes * 8);
+    entry.byteTexts.resize(bytes);
+    for (unsigned i = 0; i < bytes; i++) {
+        entry.byteTexts[i] =
+            !valid ? "-" : !(present & (1u << i)) ? "X" : encodeRadixValue((value >> (i * 8)) & 0xFF, m_radix, 8);
+    }
+    return true;
+}
+
 bool MemoryModel::validAddress(long long address) const {
-    return !(address < 0 || (address > (std::pow(2, ProcessorHandler::get()->currentISA()->bits()) - 1)));
+    return !(address < 0 || (address > (std::pow(2, m_context->currentISA()->bits()) - 1)));
 }
 
 void MemoryModel::setCentralAddress(uint32_t address) {
-    address = address - (address % ProcessorHandler::get()->currentISA()->bytes());
+    address = address - (address % m_context->currentISA()->bytes());
     m_centralAddress = address;
-    processorWasClocked();
+    reload();
 }
 
 void MemoryModel::offsetCentralAddress(int rowOffset) {
-    const int byteOffset = rowOffset * ProcessorHandler::get()->currentISA()->bytes();
+    const int byteOffset = rowOffset * m_context->currentISA()->bytes();
     const long long newCenterAddress = static_cast<long long>(m_centralAddress) + byteOffset;
     m_centralAddress = !validAddress(newCenterAddress) ? m_centralAddress : newCenterAddress;
-    processorWasClocked();
+    reload();
 }
 
 QVariant MemoryModel::headerData(int section, Qt::Orientation orientation, int role) const {
@@ -54,11 +171,11 @@ QVariant MemoryModel::headerData(int section, Qt::Orientation orientation, int r
 
 void MemoryModel::setRowsVisible(unsigned rows) {
     m_rowsVisible = rows;
-    processorWasClocked();
+    reload();
 }
 
 QVariant MemoryModel::data(const QModelIndex& index, int role) const {
-    if (!index.isValid()) {
+    if (!index.isValid() || index.row() >= static_cast<int>(m_rows.size())) {
         return QVariant();
     }
 
@@ -69,37 +186,38 @@ QVariant MemoryModel::data(const QModelIndex& index, int role) const {
         return QFont("Inconsolata", 11);
     }
 
-    const auto bytes = ProcessorHandler::get()->currentISA()->bytes();
-    const long long alignedAddress = static_cast<long long>(m_centralAddress) +
-                                     ((((m_rowsVisible * bytes) / 2) / bytes) * bytes) - (index.row() * bytes);
+    const Row& row = m_rows[index.row()];
     const unsigned byteOffset = index.column() - FIXED_COLUMNS_CNT;
 
+    if (role == Qt::BackgroundRole) {
+        // Highlight the contents of watched memory
+        uint32_t address;
+        unsigned bytes;
+        if (index.column() != Column::Address && indexRange(index, address, bytes) &&
+            m_context->getWatchpoints().isWatched(address, bytes)) {
+            return QBrush(QColor(0xFF, 0xF0, 0xB0));
+        }
+        return QVariant();
+    }
+
     if (index.column() == Column::Address) {
         if (role == Qt::DisplayRole) {
-            return addrData(alignedAddress);
+            return row.addressText;
         } else if (role == Qt::ForegroundRole) {
-            // Assign a brush if one of the byte-indexed address covered by the aligned address has been written to
-            QVariant unusedAddressBrush;
-            for (unsigned i = 0; i < ProcessorHandler::get()->currentISA()->bytes(); i++) {
-                QVariant addressBrush = fgColorData(alignedAddress, i);
-                if (addressBrush.isNull()) {
-                    return addressBrush;
-                } else {
-                    unusedAddressBrush = addressBrush;
-                }
-            }
-            return unusedAddressBrush;
+            // Assign a brush if none of the byte-indexed addresses covered by the aligned address have been written to
+            return row.valid && row.present != 0 ? QVariant() : QBrush(Qt::lightGray);
         }
     } else {
         switch (role) {
             case Qt::ForegroundRole:
-                return fgColorData(alignedAddress, index.column() == Column::WordValue ? 0 : byteOffset);
+                return fgColorData(row, index.column() == Column::WordValue ? 0 : byteOffset);
             case Qt::DisplayRole:
                 if (index.column() == Column::WordValue) {
-                    return wordData(alignedAddress);
-                } else {
-                    return byteData(alignedAddress, byteOffset);
+                    return row.wordText;
+                } else if (byteOffset < row.byteTexts.size()) {
+                    return row.byteTexts[byteOffset];
                 }
+                break;
             default:
                 break;
         }
@@ -108,51 +226,31 @@ QVariant MemoryModel::data(const QModelIndex& index, int role) const {
     return QVariant();
 }
 
-void MemoryModel::setRadix(Radix r) {
-    m_radix = r;
-    processorWasClocked();
-}
-
-QVariant MemoryModel::addrData(long long address) const {
-    if (!validAddress(address)) {
-        return "-";
+bool MemoryModel::indexRange(const QModelIndex& index, uint32_t& address, unsigned& bytes) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(m_rows.size()) || !m_rows[index.row()].valid) {
+        return false;
     }
-    return encodeRadixValue(address, Radix::Hex);
-}
-
-QVariant MemoryModel::fgColorData(long long address, unsigned byteOffset) const {
-    if (!validAddress(address) ||
-        !ProcessorHandler::get()->getMemory().contains(static_cast<unsigned>(address + byteOffset))) {
-        return QBrush(Qt::lightGray);
+    const Row& row = m_rows[index.row()];
+    if (index.column() < FIXED_COLUMNS_CNT) {
+        address = static_cast<uint32_t>(row.address);
+        bytes = m_context->currentISA()->bytes();
     } else {
-        return QVariant();  // default
+        address = static_cast<uint32_t>(row.address) + (index.column() - FIXED_COLUMNS_CNT);
+        bytes = 1;
     }
+    return true;
 }
 
-QVariant MemoryModel::byteData(long long address, unsigned byteOffset) const {
-    if (!validAddress(address)) {
-        return "-";
-    } else if (!ProcessorHandler::get()->getMemory().contains(static_cast<unsigned>(address + byteOffset))) {
-        // Dont read the memory (this will create an entry in the memory if done so). Instead, create a "fake" entry in
-        // the memory model, containing X's.
-        return "X";
-    } else {
-        uint32_t value = ProcessorHandler::get()->getMemory().readMemConst(static_cast<unsigned>(address));
-        value = value >> (byteOffset * 8);
-        return encodeRadixValue(value & 0xFF, m_radix, 8);
-    }
+void MemoryModel::setRadix(Radix r) {
+    m_radix = r;
+    reload();
 }
 
-QVariant MemoryModel::wordData(long long address) const {
-    if (!validAddress(address)) {
-        return "-";
-    } else if (!ProcessorHandler::get()->getMemory().contains(static_cast<unsigned>(address))) {
-        // Dont read the memory (this will create an entry in the memory if done so). Instead, create a "fake" entry in
-        // the memory model, containing X's.
-        return "X";
+QVariant MemoryModel::fgColorData(const Row& row, unsigned byteOffset) const {
+    if (!row.valid || !(row.present & (1u << byteOffset))) {
+        return QBrush(Qt::lightGray);
     } else {
-        uint32_t value = ProcessorHandler::get()->getMemory().readMemConst(static_cast<unsigned>(address));
-        return encodeRadixValue(value, m_radix, ProcessorHandler::get()->currentISA()->bits());
+        return QVariant();  // default
     }
 }
 
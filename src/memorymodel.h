@@ -2,6 +2,8 @@
 
 #include <QAbstractTableModel>
 
+#include <vector>
+
 #include "processorhandler.h"
 #include "radix.h"
 
@@ -11,7 +13,7 @@ class MemoryModel : public QAbstractTableModel {
     Q_OBJECT
 public:
     enum Column { Address = 0, WordValue = 1, FIXED_COLUMNS_CNT };
-    MemoryModel(QObject* parent = nullptr);
+    MemoryModel(ProcessorHandler* context, QObject* parent = nullptr);
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -24,22 +26,71 @@ public:
     void setRadix(Radix r);
     Radix getRadix() const { return m_radix; }
 
+    /**
+     * @brief indexRange
+     * Retrieves the memory range displayed by @p index; the word of the row for the address and word columns, or the
+     * byte of a byte column.
+     * @returns false if @p index does not display a valid address.
+     */
+    bool indexRange(const QModelIndex& index, uint32_t& address, unsigned& bytes) const;
+
 public slots:
+    /**
+     * @brief processorWasClocked
+     * Refreshes the rows whose addresses were written since the last refresh, as given by the memory write log of the
+     * processor handler. All rows are refreshed if the log is incomplete.
+     */
     void processorWasClocked();
     void setRowsVisible(unsigned rows);
     void offsetCentralAddress(int rowOffset);
     void setCentralAddress(uint32_t address);
+    /// Refreshes all rows, ie. after the watchpoints of the processor handler have changed
+    void watchpointsChanged() { reload(); }
+    /// Refreshes all rows from the live state published whilst running
+    void liveStateChanged();
 
 private:
+    /**
+     * @brief The Row struct
+     * Cached contents of a visible row; the word at its address, which of its bytes are present in memory, and the
+     * radix-formatted strings of the word and bytes. Strings are only reformatted when the value of the row changes.
+     */
+    struct Row {
+        long long address = -1;
+        bool valid = false;
+        uint32_t present = 0;  // Bit i is set if byte i of the row is present in memory
+        uint32_t value = 0;
+        QString addressText;
+        QString wordText;
+        std::vector<QString> byteTexts;
+    };
+
     bool validAddress(long long address) const;
-    QVariant addrData(long long address) const;
-    QVariant byteData(long long address, unsigned byteOffset) const;
-    QVariant wordData(long long address) const;
-    QVariant fgColorData(long long address, unsigned byteOffset) const;
+    long long rowAddress(int row) const;
+    /// Rebuilds the cache of all rows, and resets the model
+    void reload();
+    /// Refreshes the cache of all rows, notifying the views of the rows which changed
+    void refreshRows();
+    /**
+     * @brief refreshRow
+     * Reads the word of @p row from memory into its cache entry, reformatting its strings if the contents changed or
+     * @p force is set.
+     * @returns true if the contents of the row changed.
+     */
+    bool refreshRow(int row, bool force = false);
+    QVariant fgColorData(const Row& row, unsigned byteOffset) const;
 
     Radix m_radix = Radix::Hex;
 
     long long m_centralAddress = 4;  // Address at the center of the model
     unsigned m_rowsVisible = 0;      // Number of rows currently visible in the view associated with the model
+
+    std::vector<Row> m_rows;
+    unsigned long long m_writeCursor = 0;
+    std::vector<ProcessorHandler::MemoryWrite> m_writes;
+
+    ProcessorHandler* m_context = nullptr;
+    /// Live state which rows are read from whilst running, in place of the memory of the processor
+    std::shared_ptr<const LiveState::Frame> m_live;
 };
 }  // namespace Ripes
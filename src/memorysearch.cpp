@@ -0,0 +1,81 @@
+#include "memorysearch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace Ripes {
+namespace MemorySearch {
+
+std::vector<Page> pages(const vsrtl::core::SparseArray& memory) {
+    constexpr unsigned overlap = s_maxPatternLength - 1;
+
+    // Populated bytes are gathered into their page, in whatever order the address space stores them
+    std::vector<Page> result;
+    std::unordered_map<uint32_t, size_t> indices;
+    for (const auto& entry : memory) {
+        const uint32_t address = static_cast<uint32_t>(entry.first);
+        const uint32_t pageAddress = address & ~(s_pageSize - 1);
+        auto it = indices.find(pageAddress);
+        if (it == indices.end()) {
+            it = indices.emplace(pageAddress, result.size()).first;
+            result.emplace_back();
+            result.back().address = pageAddress;
+            result.back().data.assign(s_pageSize + overlap, 0);
+            result.back().present.assign(s_pageSize + overlap, 0);
+        }
+        Page& page = result[it->second];
+        page.data[address - pageAddress] = static_cast<uint8_t>(entry.second);
+        page.present[address - pageAddress] = 1;
+    }
+
+    std::sort(result.begin(), result.end(), [](const Page& a, const Page& b) { return a.address < b.address; });
+    // Copy the head of each page onto the tail of its predecessor, such that matches spanning both are found
+    for (size_t i = 1; i < result.size(); i++) {
+        Page& previous = result[i - 1];
+        if (static_cast<uint64_t>(previous.address) + s_pageSize == result[i].address) {
+            std::copy_n(result[i].data.begin(), overlap, previous.data.begin() + s_pageSize);
+            std::copy_n(result[i].present.begin(), overlap, previous.present.begin() + s_pageSize);
+        }
+    }
+    return result;
+}
+
+std::vector<uint32_t> find(const Page& page, const QByteArray& pattern, unsigned alignment) {
+    std::vector<uint32_t> matches;
+    const size_t length = static_cast<size_t>(pattern.size());
+    if (length == 0 || length > s_maxPatternLength || alignment == 0) {
+        return matches;
+    }
+
+    // Candidates are located by their first byte using memchr, which the C library vectorizes, and are then compared
+    // in full. Matches may start anywhere within the page, and extend into the bytes copied from the following page.
+    const uint8_t* data = page.data.data();
+    const uint8_t* present = page.present.data();
+    const auto* bytes = reinterpret_cast<const uint8_t*>(pattern.constData());
+    size_t offset = 0;
+    while (offset < s_pageSize) {
+        const void* hit = std::memchr(data + offset, bytes[0], s_pageSize - offset);
+        if (!hit) {
+            break;
+        }
+        const size_t at = static_cast<size_t>(static_cast<const uint8_t*>(hit) - data);
+        if ((page.address + at) % alignment == 0 && std::memcmp(data + at, bytes, length) == 0 &&
+            std::find(present + at, present + at + length, 0) == present + at + length) {
+            matches.push_back(page.address + static_cast<uint32_t>(at));
+        }
+        offset = at + 1;
+    }
+    return matches;
+}
+
+QByteArray valuePattern(uint32_t value, unsigned bytes) {
+    QByteArray pattern;
+    for (unsigned i = 0; i < bytes; i++, value >>= 8) {
+        pattern.append(static_cast<char>(value & 0xFF));
+    }
+    return pattern;
+}
+
+}  // namespace MemorySearch
+}  // namespace Ripes
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QByteArray>
+
+#include <cstdint>
+#include <vector>
+
+#include "VSRTL/core/vsrtl_memory.h"
+
+namespace Ripes {
+
+/**
+ * Search of the populated bytes of a memory address space for a byte pattern
+ * Memory is first copied into pages of contiguous host memory (see pages()), which may then be searched independently
+ * and in parallel, without accessing the address space itself.
+ */
+namespace MemorySearch {
+constexpr unsigned s_pageBits = 12;
+constexpr unsigned s_pageSize = 1 << s_pageBits;
+/// Longest pattern which may be searched for; matches may span at most two pages
+constexpr unsigned s_maxPatternLength = 64;
+
+/**
+ * @brief The Page struct
+ * Copy of a page of memory, followed by the first s_maxPatternLength - 1 bytes of the subsequent page. Bytes which are
+ * not populated in memory read as 0 in data, and are marked as such in present.
+ */
+struct Page {
+    uint32_t address = 0;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> present;
+};
+
+/// @returns copies of the pages of @p memory which contain any populated byte, in ascending order of address
+std::vector<Page> pages(const vsrtl::core::SparseArray& memory);
+
+/**
+ * @brief find
+ * @returns the addresses within @p page at which @p pattern starts, and which are a multiple of @p alignment, in
+ * ascending order. Every byte of a match must be populated.
+ */
+std::vector<uint32_t> find(const Page& page, const QByteArray& pattern, unsigned alignment);
+
+/// @returns the little-endian byte pattern of the @p bytes least significant bytes of @p value
+QByteArray valuePattern(uint32_t value, unsigned bytes);
+}  // namespace MemorySearch
+
+}  // namespace Ripes
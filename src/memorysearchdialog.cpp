@@ -0,0 +1,160 @@
+#include "memorysearchdialog.h"
+#include "ui_memorysearchdialog.h"
+
+#include <QPushButton>
+#include <QRegExp>
+#include <QtConcurrent/QtConcurrent>
+
+#include <functional>
+
+#include "processorhandler.h"
+#include "radix.h"
+
+namespace Ripes {
+
+MemorySearchDialog::MemorySearchDialog(QWidget* parent) : QDialog(parent), m_ui(new Ui::MemorySearchDialog) {
+    m_ui->setupUi(this);
+    setWindowTitle("Search memory");
+
+    m_ui->type->addItem("Byte", static_cast<int>(PatternType::Byte));
+    m_ui->type->addItem("Halfword", static_cast<int>(PatternType::Halfword));
+    m_ui->type->addItem("Word", static_cast<int>(PatternType::Word));
+    m_ui->type->addItem("Bytes (hex)", static_cast<int>(PatternType::Bytes));
+    m_ui->type->addItem("Text", static_cast<int>(PatternType::Text));
+    m_ui->type->setCurrentIndex(m_ui->type->findData(static_cast<int>(PatternType::Word)));
+    connect(m_ui->type, QOverload<int>::of(&QComboBox::currentIndexChanged), [=](int index) {
+        const auto type = static_cast<PatternType>(m_ui->type->itemData(index).toInt());
+        m_ui->aligned->setEnabled(type == PatternType::Halfword || type == PatternType::Word);
+    });
+    connect(m_ui->value, &QLineEdit::returnPressed, this, &MemorySearchDialog::on_search_clicked);
+
+    m_ui->buttonBox->button(QDialogButtonBox::Ok)->setText("Go to");
+    m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+    // Enter starts a search rather than accepting the dialog
+    m_ui->buttonBox->button(QDialogButtonBox::Ok)->setAutoDefault(false);
+    m_ui->search->setDefault(true);
+
+    connect(m_ui->matches, &QListWidget::currentItemChanged, [=](QListWidgetItem* item) {
+        m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(item != nullptr);
+        if (item) {
+            m_address = item->data(Qt::UserRole).toUInt();
+        }
+    });
+    connect(m_ui->matches, &QListWidget::itemDoubleClicked, [=](QListWidgetItem* item) {
+        m_address = item->data(Qt::UserRole).toUInt();
+        accept();
+    });
+
+    connect(&m_watcher, &QFutureWatcher<std::vector<uint32_t>>::resultsReadyAt, this,
+            &MemorySearchDialog::resultsReady);
+    connect(&m_watcher, &QFutureWatcher<std::vector<uint32_t>>::finished, this, &MemorySearchDialog::searchFinished);
+
+    // The dialog is modal, so memory cannot change whilst it is open; it is copied once for all searches
+    m_pages = MemorySearch::pages(ProcessorHandler::get()->getMemory());
+    m_ui->status->setText(QString::number(m_pages.size()) + " populated pages of memory");
+}
+
+MemorySearchDialog::~MemorySearchDialog() {
+    cancelSearch();
+    delete m_ui;
+}
+
+void MemorySearchDialog::cancelSearch() {
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+bool MemorySearchDialog::parsePattern(QByteArray& pattern, unsigned& alignment) const {
+    const auto type = static_cast<PatternType>(m_ui->type->currentData().toInt());
+    const QString text = m_ui->value->text();
+    alignment = 1;
+
+    switch (type) {
+        case PatternType::Byte:
+        case PatternType::Halfword:
+        case PatternType::Word: {
+            const unsigned bytes = type == PatternType::Byte ? 1 : type == PatternType::Halfword ? 2 : 4;
+            bool ok;
+            const long long value = text.trimmed().startsWith("0b", Qt::CaseInsensitive)
+                                        ? text.trimmed().mid(2).toLongLong(&ok, 2)
+                                        : text.trimmed().toLongLong(&ok, 0);
+            // Values may be given as either signed or unsigned integers of the selected width
+            const long long range = 1LL << (bytes * 8);
+            if (!ok || value < -(range / 2) || value >= range) {
+                return false;
+            }
+            pattern = MemorySearch::valuePattern(static_cast<uint32_t>(value), bytes);
+            alignment = m_ui->aligned->isChecked() ? bytes : 1;
+            break;
+        }
+        case PatternType::Bytes: {
+            QString hex = text;
+            hex.remove(QRegExp("\\s|0[xX]"));
+            if (hex.size() % 2 != 0 || !QRegExp("[0-9a-fA-F]*").exactMatch(hex)) {
+                return false;
+            }
+            pattern = QByteArray::fromHex(hex.toLatin1());
+            break;
+        }
+        case PatternType::Text:
+            pattern = text.toUtf8();
+            break;
+    }
+    return !pattern.isEmpty() && static_cast<unsigned>(pattern.size()) <= MemorySearch::s_maxPatternLength;
+}
+
+void MemorySearchDialog::on_search_clicked() {
+    cancelSearch();
+    m_ui->matches->clear();
+    m_matches = 0;
+
+    QByteArray pattern;
+    unsigned alignment;
+    if (!parsePattern(pattern, alignment)) {
+        m_ui->status->setText("Invalid search pattern (at most " + QString::number(MemorySearch::s_maxPatternLength) +
+                              " bytes)");
+        return;
+    }
+
+    std::vector<const MemorySearch::Page*> pages;
+    pages.reserve(m_pages.size());
+    for (const auto& page : m_pages) {
+        pages.push_back(&page);
+    }
+    const std::function<std::vector<uint32_t>(const MemorySearch::Page*)> search =
+        [pattern, alignment](const MemorySearch::Page* page) { return MemorySearch::find(*page, pattern, alignment); };
+    m_ui->status->setText("Searching...");
+    m_watcher.setFuture(QtConcurrent::mapped(pages, search));
+}
+
+void MemorySearchDialog::resultsReady(int begin, int end) {
+    const auto* program = ProcessorHandler::get()->getProgram();
+    for (int i = begin; i < end && m_matches <= s_maxMatches; i++) {
+        for (const uint32_t address : m_watcher.resultAt(i)) {
+            if (m_matches++ == s_maxMatches) {
+                break;
+            }
+            QString text = encodeRadixValue(address, Radix::Hex);
+            const auto* section = program ? program->getSectionAt(address) : nullptr;
+            if (section) {
+                text += "  " + section->name + "+" + QString::number(address - section->address);
+            }
+            auto* item = new QListWidgetItem(text);
+            item->setData(Qt::UserRole, address);
+            m_ui->matches->addItem(item);
+        }
+    }
+    if (m_matches > s_maxMatches) {
+        m_watcher.cancel();
+    }
+}
+
+void MemorySearchDialog::searchFinished() {
+    // Pages finish out of order; the hexadecimal addresses of equal width sort by address
+    m_ui->matches->sortItems();
+    const unsigned listed = static_cast<unsigned>(m_ui->matches->count());
+    m_ui->status->setText(m_matches > s_maxMatches ? "Showing the first " + QString::number(listed) + " matches found"
+                                                   : QString::number(listed) + " matches");
+}
+
+}  // namespace Ripes
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include <vector>
+
+#include "memorysearch.h"
+
+namespace Ripes {
+
+namespace Ui {
+class MemorySearchDialog;
+}
+
+/**
+ * @brief The MemorySearchDialog class
+ * Searches all populated memory of the current processor for a value, byte sequence or text, and lists the addresses
+ * at which it was found. Memory is copied when the dialog is opened, after which pages are searched in parallel and
+ * matches are listed as the search progresses. The address of the selected match is available through getAddress()
+ * once the dialog has been accepted.
+ */
+class MemorySearchDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit MemorySearchDialog(QWidget* parent = nullptr);
+    ~MemorySearchDialog() override;
+
+    uint32_t getAddress() const { return m_address; }
+
+private slots:
+    void on_search_clicked();
+
+private:
+    enum class PatternType { Byte, Halfword, Word, Bytes, Text };
+
+    /**
+     * @brief parsePattern
+     * Converts the search input into the byte pattern to search for, and the alignment of its matches.
+     * @returns false if the input is not a valid pattern of the selected type.
+     */
+    bool parsePattern(QByteArray& pattern, unsigned& alignment) const;
+    void resultsReady(int begin, int end);
+    void searchFinished();
+    void cancelSearch();
+
+    static constexpr unsigned s_maxMatches = 10000;
+
+    Ui::MemorySearchDialog* m_ui = nullptr;
+    std::vector<MemorySearch::Page> m_pages;
+    QFutureWatcher<std::vector<uint32_t>> m_watcher;
+    unsigned m_matches = 0;
+    uint32_t m_address = 0;
+};
+}  // namespace Ripes
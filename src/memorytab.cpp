@@ -1,6 +1,7 @@
 #include "memorytab.h"
 #include "ui_memorytab.h"
 
+#include <QCheckBox>
 #include <QGraphicsItem>
 #include <QToolBar>
 
@@ -17,24 +18,67 @@ MemoryTab::MemoryTab(QToolBar* toolbar, QWidget* parent) : RipesTab(toolbar, par
 
     m_ui->dataCache->setType(CacheSim::CacheType::DataCache);
     m_ui->instructionCache->setType(CacheSim::CacheType::InstrCache);
+    m_ui->l2Cache->setType(CacheSim::CacheType::UnifiedCache);
+    m_ui->l2Cache->getCache()->setHitLatency(10);
+
+    // The L2 cache is only accessed by the L1 caches while enabled
+    m_ui->l2Cache->setEnabled(false);
+    connect(m_ui->l2Enabled, &QCheckBox::toggled, [=](bool enabled) {
+        m_ui->l2Cache->setEnabled(enabled);
+        CacheSim* nextLevel = enabled ? m_ui->l2Cache->getCache() : nullptr;
+        m_ui->dataCache->getCache()->setNextLevel(nextLevel);
+        m_ui->instructionCache->getCache()->setNextLevel(nextLevel);
+    });
 
     // Make selection changes in the cache trigger the memory viewer to set its central address to the selected address
     connect(m_ui->dataCache, &CacheWidget::cacheAddressSelected, m_ui->memoryViewerWidget,
             &MemoryViewerWidget::setCentralAddress);
     connect(m_ui->instructionCache, &CacheWidget::cacheAddressSelected, m_ui->memoryViewerWidget,
             &MemoryViewerWidget::setCentralAddress);
+    connect(m_ui->l2Cache, &CacheWidget::cacheAddressSelected, m_ui->memoryViewerWidget,
+            &MemoryViewerWidget::setCentralAddress);
+    connect(m_ui->memoryMap, &MemoryMapWidget::pageSelected, m_ui->memoryViewerWidget,
+            &MemoryViewerWidget::setCentralAddress);
 
     // Make cache configuration changes emit processor reset requests
     connect(m_ui->dataCache, &CacheWidget::configurationChanged, [=] { emit reqProcessorReset(); });
     connect(m_ui->instructionCache, &CacheWidget::configurationChanged, [=] { emit reqProcessorReset(); });
+    connect(m_ui->l2Cache, &CacheWidget::configurationChanged, [=] { emit reqProcessorReset(); });
 
-    // During processor running, it should not be possible to interact with the memory viewer or cache widgets
-    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, [=] { setEnabled(false); });
-    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, [=] { setEnabled(true); });
+    // During processor running, it should not be possible to interact with the cache widgets. The memory viewer
+    // presents the live state of the processor, and may be browsed.
+    connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, [=] { m_ui->tabWidget->setEnabled(false); });
+    connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, [=] { m_ui->tabWidget->setEnabled(true); });
 }
 
 void MemoryTab::update() {
+    if (deferViewUpdate(ProcessorHandler::get()->getCycleCount())) {
+        return;
+    }
+    refreshViews();
+}
+
+void MemoryTab::refreshViews() {
     m_ui->memoryViewerWidget->updateView();
+    m_ui->memoryMap->updateView();
+}
+
+std::vector<ProcessorHandler::ReportedCache> MemoryTab::reportedCaches() const {
+    std::vector<ProcessorHandler::ReportedCache> caches = {{"dcache", m_ui->dataCache->getCache()},
+                                                           {"icache", m_ui->instructionCache->getCache()}};
+    if (m_ui->l2Enabled->isChecked()) {
+        caches.push_back({"l2cache", m_ui->l2Cache->getCache()});
+    }
+    return caches;
+}
+
+std::vector<ProcessorHandler::SnapshotCache> MemoryTab::snapshotCaches() const {
+    std::vector<ProcessorHandler::SnapshotCache> caches = {{"dcache", m_ui->dataCache->getCache()},
+                                                           {"icache", m_ui->instructionCache->getCache()}};
+    if (m_ui->l2Enabled->isChecked()) {
+        caches.push_back({"l2cache", m_ui->l2Cache->getCache()});
+    }
+    return caches;
 }
 
 MemoryTab::~MemoryTab() {
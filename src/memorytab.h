@@ -23,12 +23,27 @@ public:
     MemoryTab(QToolBar* toolbar, QWidget* parent = nullptr);
     ~MemoryTab() override;
 
+    /**
+     * @brief reportedCaches
+     * @returns the simulated caches, named as per the keys of ProcessorHandler::statisticsReport.
+     */
+    std::vector<ProcessorHandler::ReportedCache> reportedCaches() const;
+    /**
+     * @brief snapshotCaches
+     * @returns the simulated caches, named as per the statistics report, whose state is included in simulation
+     * snapshots.
+     */
+    std::vector<ProcessorHandler::SnapshotCache> snapshotCaches() const;
+
 signals:
     void reqProcessorReset();
 
 public slots:
     void update();
 
+protected:
+    void refreshViews() override;
+
 private:
     Ui::MemoryTab* m_ui = nullptr;
 };
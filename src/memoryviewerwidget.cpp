@@ -1,8 +1,11 @@
 #include "memoryviewerwidget.h"
 #include "ui_memoryviewerwidget.h"
 
+#include <QMenu>
 #include <QTableView>
 
+#include <algorithm>
+
 #include "gotocombobox.h"
 #include "memorymodel.h"
 
@@ -11,6 +14,67 @@ namespace Ripes {
 MemoryViewerWidget::MemoryViewerWidget(QWidget* parent) : QWidget(parent), m_ui(new Ui::MemoryViewerWidget) {
     m_ui->setupUi(this);
     updateModel();
+
+    m_ui->memoryView->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(m_ui->memoryView, &QWidget::customContextMenuRequested, this, &MemoryViewerWidget::showContextMenu);
+}
+
+void MemoryViewerWidget::showContextMenu(const QPoint& pos) {
+    // Watchpoints are checked by the simulation thread, and are not modified whilst running
+    if (ProcessorHandler::get()->isRunning()) {
+        return;
+    }
+    const QModelIndex clicked = m_ui->memoryView->indexAt(pos);
+    auto indexes = m_ui->memoryView->selectionModel()->selectedIndexes();
+    if (!indexes.contains(clicked)) {
+        indexes = {clicked};
+    }
+
+    // The watched range spans all of the selected cells
+    uint64_t begin = UINT64_MAX;
+    uint64_t end = 0;
+    for (const auto& index : indexes) {
+        uint32_t address;
+        unsigned bytes;
+        if (m_memoryModel->indexRange(index, address, bytes)) {
+            begin = std::min<uint64_t>(begin, address);
+            end = std::max<uint64_t>(end, static_cast<uint64_t>(address) + bytes);
+        }
+    }
+    if (begin >= end) {
+        return;
+    }
+    const uint32_t address = static_cast<uint32_t>(begin);
+    const uint32_t size = static_cast<uint32_t>(end - begin);
+
+    auto* handler = ProcessorHandler::get();
+    QMenu menu;
+    const auto addWatchAction = [&](const QString& text, unsigned kinds) {
+        menu.addAction(text, [=] {
+            handler->addWatchpoint(address, size, kinds);
+            m_memoryModel->watchpointsChanged();
+        });
+    };
+    const QString range =
+        QString("0x%1..0x%2").arg(address, 8, 16, QChar('0')).arg(address + size - 1, 8, 16, QChar('0'));
+    addWatchAction("Watch reads of " + range, Watchpoints::Read);
+    addWatchAction("Watch writes to " + range, Watchpoints::Write);
+    addWatchAction("Watch value changes of " + range, Watchpoints::Change);
+    addWatchAction("Watch all accesses to " + range, Watchpoints::Read | Watchpoints::Write | Watchpoints::Change);
+    menu.addSeparator();
+    if (const auto* watchpoint = handler->getWatchpoints().find(address, size)) {
+        const uint32_t watchAddress = watchpoint->address;
+        menu.addAction("Remove watchpoint at 0x" + QString::number(watchAddress, 16), [=] {
+            handler->removeWatchpoint(watchAddress);
+            m_memoryModel->watchpointsChanged();
+        });
+    }
+    auto* clearAction = menu.addAction("Remove all watchpoints", [=] {
+        handler->clearWatchpoints();
+        m_memoryModel->watchpointsChanged();
+    });
+    clearAction->setEnabled(!handler->getWatchpoints().empty());
+    menu.exec(m_ui->memoryView->viewport()->mapToGlobal(pos));
 }
 
 MemoryViewerWidget::~MemoryViewerWidget() {
@@ -28,7 +92,7 @@ void MemoryViewerWidget::updateView() {
 void MemoryViewerWidget::updateModel() {
     auto* oldModel = m_memoryModel;
 
-    m_memoryModel = new MemoryModel(this);
+    m_memoryModel = new MemoryModel(ProcessorHandler::get(), this);
     m_ui->memoryView->setModel(m_memoryModel);
     m_ui->radixSelector->setRadix(m_memoryModel->getRadix());
     connect(m_ui->radixSelector, &RadixSelectorWidget::radixChanged, m_memoryModel, &MemoryModel::setRadix);
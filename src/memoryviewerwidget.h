@@ -26,6 +26,13 @@ public slots:
     void setCentralAddress(uint32_t address);
 
 private:
+    /**
+     * @brief showContextMenu
+     * Offers to watch or stop watching the memory displayed by the selected cells, or the cell at @p pos if it is not
+     * selected.
+     */
+    void showContextMenu(const QPoint& pos);
+
     Ui::MemoryViewerWidget* m_ui = nullptr;
 };
 }  // namespace Ripes
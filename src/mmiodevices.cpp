@@ -0,0 +1,110 @@
+#include "mmiodevices.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+bool MMIODevices::add(std::unique_ptr<MMIODevice> device, QString& error) {
+    const uint64_t end = static_cast<uint64_t>(device->base()) + device->size();
+    if (device->size() == 0 || end > (1ull << 32)) {
+        error = "Invalid address range of device " + device->name();
+        return false;
+    }
+    const auto it = std::upper_bound(m_devices.begin(), m_devices.end(), device->base(),
+                                     [](uint32_t base, const auto& other) { return base < other->base(); });
+    const bool overlapsPrevious = it != m_devices.begin() && (*std::prev(it))->contains(device->base());
+    const bool overlapsNext = it != m_devices.end() && (*it)->base() < end;
+    if (overlapsPrevious || overlapsNext) {
+        const auto& other = overlapsPrevious ? *std::prev(it) : *it;
+        error = "Device " + device->name() + " overlaps device " + other->name();
+        return false;
+    }
+    m_devices.insert(it, std::move(device));
+    updatePages();
+    return true;
+}
+
+void MMIODevices::clear() {
+    m_devices.clear();
+    m_pages.clear();
+}
+
+void MMIODevices::updatePages() {
+    m_pages.clear();
+    for (const auto& device : m_devices) {
+        const uint32_t first = device->base() >> s_pageBits;
+        const uint32_t last = (device->base() + (device->size() - 1)) >> s_pageBits;
+        if ((last >> 6) >= m_pages.size()) {
+            m_pages.resize((last >> 6) + 1, 0);
+        }
+        for (uint64_t page = first; page <= last; page++) {
+            m_pages[page >> 6] |= 1ull << (page & 63);
+        }
+    }
+}
+
+MMIODevice* MMIODevices::deviceAt(uint32_t address) const {
+    // The device preceding the first device starting beyond the address is the only candidate
+    const auto it = std::upper_bound(m_devices.begin(), m_devices.end(), address,
+                                     [](uint32_t addr, const auto& device) { return addr < device->base(); });
+    if (it == m_devices.begin()) {
+        return nullptr;
+    }
+    MMIODevice* device = std::prev(it)->get();
+    return device->contains(address) ? device : nullptr;
+}
+
+bool MMIODevices::read(uint32_t address, uint32_t& value) const {
+    const MMIODevice* device = deviceAt(address);
+    if (!device || !m_memory) {
+        return false;
+    }
+    // Registers are read a word at a time; narrower and unaligned loads are served from the containing word
+    const uint32_t offset = address - device->base();
+    uint32_t word = 0;
+    if (!device->read(offset & ~0x3u, word, *m_memory)) {
+        return false;
+    }
+    value = word >> ((offset & 0x3u) * 8);
+    return true;
+}
+
+void MMIODevices::write(uint32_t address, uint32_t value, unsigned bytes) {
+    if (MMIODevice* device = deviceAt(address)) {
+        device->write(address - device->base(), value, bytes);
+    }
+}
+
+void MMIODevices::reset() {
+    for (const auto& device : m_devices) {
+        device->reset();
+    }
+    sync();
+}
+
+void MMIODevices::sync() {
+    for (const auto& device : m_devices) {
+        if (m_memory) {
+            device->sync(*m_memory);
+        }
+        device->setChanged();
+    }
+}
+
+bool MMIODevices::takeChanged() {
+    bool changed = false;
+    for (const auto& device : m_devices) {
+        changed |= device->takeChanged();
+    }
+    return changed;
+}
+
+unsigned long long MMIODevices::changes() const {
+    unsigned long long changes = 0;
+    for (const auto& device : m_devices) {
+        changes += device->changes();
+    }
+    return changes;
+}
+
+}  // namespace Ripes
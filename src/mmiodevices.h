@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "VSRTL/core/vsrtl_memory.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MMIODevice class
+ * A peripheral owning the address range [base; base + size[ of the data memory. Device registers are memory backed:
+ * stores to the range are performed upon memory as any other store, after which the device is notified through
+ * write(). Registers whose value is not held in memory (ie. a counter or an input) are provided by read(). Memory
+ * backed state is thereby checkpointed, reversed and saved in snapshots along with the rest of the memory. Devices
+ * which present memory backed state to a view keep a copy of it, updated through write() and sync(), such that the
+ * view never reads the memory of a running processor.
+ */
+class MMIODevice {
+public:
+    MMIODevice(const QString& name, uint32_t base, uint32_t size) : m_name(name), m_base(base), m_size(size) {}
+    virtual ~MMIODevice() = default;
+
+    const QString& name() const { return m_name; }
+    uint32_t base() const { return m_base; }
+    uint32_t size() const { return m_size; }
+    bool contains(uint32_t address) const { return address - m_base < m_size; }
+
+    /**
+     * @brief read
+     * Reads the register word at the word aligned @p offset into @p value. Loads may be evaluated several times per
+     * cycle by the detailed processors, and are re-evaluated when reversing, such that reads must not have side
+     * effects.
+     * @returns false if the register is read from @p memory.
+     */
+    virtual bool read(uint32_t /*offset*/, uint32_t& /*value*/, const vsrtl::core::SparseArray& /*memory*/) const {
+        return false;
+    }
+
+    /**
+     * @brief write
+     * Called once a store of the @p bytes low bytes of @p value to @p offset has been performed upon memory. Called on
+     * the simulation thread.
+     */
+    virtual void write(uint32_t /*offset*/, uint32_t /*value*/, unsigned /*bytes*/) {}
+
+    /// Discards any state of the device which is not held in memory
+    virtual void reset() {}
+
+    /// Re-reads any memory backed state of the device from @p memory, after it has been modified outside of write()
+    virtual void sync(const vsrtl::core::SparseArray& /*memory*/) {}
+
+    /// @returns true if the device has changed since last called, such that views of the device should be updated
+    bool takeChanged() { return m_changed.exchange(false); }
+    void setChanged() {
+        m_changed = true;
+        m_changes++;
+    }
+    /// @returns the number of times the device has changed, by stores, inputs or synchronization
+    unsigned long long changes() const { return m_changes; }
+
+private:
+    const QString m_name;
+    const uint32_t m_base;
+    const uint32_t m_size;
+    std::atomic<bool> m_changed{true};
+    std::atomic<unsigned long long> m_changes{0};
+};
+
+/**
+ * @brief The MMIODevices class
+ * Registry of the memory mapped devices of a simulation context. Devices are kept in a table sorted by address, in
+ * which the device owning an address is found through binary search. The data memory access paths of the processors
+ * test a single bit of a page bitmap per access, and only accesses to pages flagged as holding a device are dispatched
+ * through the table; all other accesses are unaffected by the presence of devices.
+ */
+class MMIODevices {
+public:
+    static constexpr unsigned s_pageBits = 12;
+
+    /**
+     * @brief add
+     * Maps @p device into the address space.
+     * @returns false, with a description of the error in @p error, if the range of the device is empty or overlaps
+     * the range of another device.
+     */
+    bool add(std::unique_ptr<MMIODevice> device, QString& error);
+    void clear();
+
+    /// @returns all devices, sorted by address
+    const std::vector<std::unique_ptr<MMIODevice>>& devices() const { return m_devices; }
+    bool empty() const { return m_devices.empty(); }
+
+    /// @returns the first device of type T, or nullptr if no such device is mapped
+    template <typename T>
+    T* find() const {
+        for (const auto& device : m_devices) {
+            if (auto* match = dynamic_cast<T*>(device.get())) {
+                return match;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Sets the memory which device registers are backed by
+    void setMemory(const vsrtl::core::SparseArray* memory) { m_memory = memory; }
+
+    /// @returns true if any device overlaps the page containing @p address.
+    bool isDevicePage(uint32_t address) const {
+        const uint32_t page = address >> s_pageBits;
+        return (page >> 6) < m_pages.size() && (m_pages[page >> 6] >> (page & 63)) & 1;
+    }
+
+    /// @returns the device owning @p address, or nullptr
+    MMIODevice* deviceAt(uint32_t address) const;
+
+    /**
+     * @brief read
+     * Reads the word at @p address into @p value, if the address is a register provided by a device rather than memory.
+     * Callers should only read from device pages (see isDevicePage).
+     */
+    bool read(uint32_t address, uint32_t& value) const;
+
+    /**
+     * @brief write
+     * Notifies the device owning @p address, if any, of a store of @p bytes of @p value which has been performed upon
+     * memory. Callers should only notify stores to device pages (see isDevicePage).
+     */
+    void write(uint32_t address, uint32_t value, unsigned bytes);
+
+    /// Resets and synchronizes all devices (see MMIODevice::reset and MMIODevice::sync)
+    void reset();
+    /// Synchronizes all devices with their memory, ie. after the memory has been reversed or restored
+    void sync();
+    /// @returns true if any device has changed since last called
+    bool takeChanged();
+    /// @returns the number of changes of all devices (see MMIODevice::changes)
+    unsigned long long changes() const;
+
+private:
+    void updatePages();
+
+    std::vector<std::unique_ptr<MMIODevice>> m_devices;
+    // Bitmap over the 4 KiB pages of the address space, set for pages overlapped by any device
+    std::vector<uint64_t> m_pages;
+    const vsrtl::core::SparseArray* m_memory = nullptr;
+};
+
+}  // namespace Ripes
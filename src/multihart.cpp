@@ -0,0 +1,248 @@
+#include "multihart.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "defines.h"
+
+namespace Ripes {
+
+MultiHartSystem::MultiHartSystem(unsigned harts, const Program& program, const RegisterInitialization& registers)
+    : m_memory(std::make_unique<vsrtl::core::SparseArray>()), m_interconnect(harts) {
+    const auto* text = program.getSection(TEXT_SECTION_NAME);
+    for (unsigned id = 0; id < harts; id++) {
+        auto hart = std::make_unique<Hart>();
+        hart->system = this;
+        hart->registers = std::make_unique<vsrtl::core::SparseArray>();
+        hart->iss = std::make_unique<vsrtl::core::RVISS>(m_memory.get(), hart->registers.get());
+        auto& iss = *hart->iss;
+        iss.setHartId(id);
+        iss.setInterconnect(&m_interconnect);
+        iss.handleSysCall.Connect(hart.get(), &Hart::sysCall);
+        if (text) {
+            iss.setExecutableRange(static_cast<uint32_t>(text->address),
+                                   static_cast<uint32_t>(text->address + text->data.length()));
+        }
+        iss.setPCInitialValue(static_cast<uint32_t>(program.entryPoint));
+        for (const auto& [reg, value] : registers) {
+            iss.setRegister(reg, reg == 2 ? value - id * s_stackSize : value);
+        }
+        iss.reset();
+        m_harts.push_back(std::move(hart));
+    }
+    if (!m_harts.empty()) {
+        for (const auto& section : program.sections) {
+            m_harts.front()->iss->writeMemRange(static_cast<uint32_t>(section.address),
+                                                reinterpret_cast<const uint8_t*>(section.data.constData()),
+                                                static_cast<size_t>(section.data.length()));
+        }
+    }
+}
+
+MultiHartSystem::~MultiHartSystem() = default;
+
+void MultiHartSystem::enableCoherence(int lines, int ways, int blocks) {
+    m_coherence = std::make_unique<CoherenceModel>(static_cast<unsigned>(m_harts.size()), lines, ways, blocks);
+    for (auto& hart : m_harts) {
+        hart->iss->accessesTraced.Connect(hart.get(), &Hart::accessesTraced);
+        hart->iss->setMemoryAccessTracing(true);
+    }
+}
+
+MultiHartSystem::Result MultiHartSystem::run(unsigned long long quantum, unsigned long long maxCycles,
+                                             const std::function<void(const QString&)>& print,
+                                             const std::atomic<bool>* stop) {
+    m_print = print;
+    m_stop = stop;
+    m_result = Result();
+    m_arrived = 0;
+    m_stopped = false;
+    quantum = std::max(quantum, 1ull);
+
+    // The first hart executes on the calling thread
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < m_harts.size(); i++) {
+        threads.emplace_back([this, &hart = *m_harts[i], quantum, maxCycles] { runHart(hart, quantum, maxCycles); });
+    }
+    if (!m_harts.empty()) {
+        runHart(*m_harts.front(), quantum, maxCycles);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Result result = m_result;
+    for (const auto& hart : m_harts) {
+        result.instructions.push_back(hart->iss->getInstructionsRetired());
+        result.cycles = std::max(result.cycles, hart->iss->getCycleCount());
+        std::vector<uint32_t> values(hart->iss->implementsISA()->regCnt());
+        hart->iss->readRegisters(values.data(), static_cast<unsigned>(values.size()));
+        result.registers.push_back(std::move(values));
+        if (m_coherence) {
+            result.coherence.push_back(m_coherence->statistics(static_cast<unsigned>(result.coherence.size())));
+        }
+    }
+    if (m_coherence) {
+        result.coherenceLines = m_coherence->lines();
+        result.coherenceLines.resize(std::min(result.coherenceLines.size(), s_reportedLines));
+    }
+    return result;
+}
+
+void MultiHartSystem::runHart(Hart& hart, unsigned long long quantum, unsigned long long maxCycles) {
+    auto& iss = *hart.iss;
+    do {
+        // The last quantum is truncated at the cycle limit
+        unsigned long long budget = quantum;
+        if (maxCycles != 0) {
+            budget = std::min(budget, maxCycles - std::min<unsigned long long>(iss.getCycleCount(), maxCycles));
+        }
+        for (; budget != 0 && !iss.finished() && !m_exited.load(std::memory_order_relaxed); budget--) {
+            iss.clock();
+            if (!iss.isExecutableAddress(iss.nextFetchedAddress())) {
+                vsrtl::core::FinalizeReason fr;
+                fr.exitedExecutableRegion = true;
+                iss.finalize(fr);
+            }
+        }
+        // Pages are copied anew once past the barrier, after all stores of the quantum have been performed
+        iss.synchronize();
+        if (m_coherence) {
+            // Disabling tracing emits the accesses traced within the quantum
+            iss.setMemoryAccessTracing(false);
+            iss.setMemoryAccessTracing(true);
+        }
+    } while (barrier(maxCycles));
+}
+
+bool MultiHartSystem::barrier(unsigned long long maxCycles) {
+    std::unique_lock<std::mutex> lock(m_barrierMutex);
+    if (++m_arrived == m_harts.size()) {
+        // All other harts are blocked; their state may be read
+        simulateCoherence();
+        bool finished = true;
+        long long cycles = 0;
+        for (const auto& hart : m_harts) {
+            finished &= hart->iss->finished();
+            cycles = std::max(cycles, hart->iss->getCycleCount());
+        }
+        m_result.exited = m_exited.load(std::memory_order_relaxed);
+        m_result.finished = finished || m_result.exited;
+        m_result.cycleLimitReached = !m_result.finished && maxCycles != 0 &&
+                                     static_cast<unsigned long long>(cycles) >= maxCycles;
+        m_result.cancelled = !m_result.finished && m_stop && m_stop->load(std::memory_order_relaxed);
+        m_stopped = m_result.finished || m_result.cycleLimitReached || m_result.cancelled;
+        m_arrived = 0;
+        m_generation++;
+        m_barrierCondition.notify_all();
+        return !m_stopped;
+    }
+    const unsigned long long generation = m_generation;
+    m_barrierCondition.wait(lock, [&] { return m_generation != generation; });
+    return !m_stopped;
+}
+
+void MultiHartSystem::simulateCoherence() {
+    if (!m_coherence) {
+        return;
+    }
+    size_t longest = 0;
+    for (const auto& hart : m_harts) {
+        longest = std::max(longest, hart->accesses.size());
+    }
+    for (size_t i = 0; i < longest; i++) {
+        for (unsigned id = 0; id < m_harts.size(); id++) {
+            const auto& accesses = m_harts[id]->accesses;
+            if (i < accesses.size()) {
+                m_coherence->access(id, accesses[i].address,
+                                    accesses[i].kind == vsrtl::core::TracedMemoryAccess::Store);
+            }
+        }
+    }
+    for (auto& hart : m_harts) {
+        hart->accesses.clear();
+    }
+}
+
+void MultiHartSystem::print(const QString& output) {
+    if (m_print) {
+        std::lock_guard<std::mutex> lock(m_printMutex);
+        m_print(output);
+    }
+}
+
+void MultiHartSystem::handleSysCall(Hart& hart) {
+    auto& iss = *hart.iss;
+    const unsigned arg = iss.getRegister(17);
+    const uint32_t val = iss.getRegister(10);
+    switch (arg) {
+        case SysCall::PrintInt:
+            print(QString::number(static_cast<int>(val)));
+            break;
+        case SysCall::PrintFloat:
+            print(QString::number(static_cast<double>(*reinterpret_cast<const float*>(&val))));
+            break;
+        case SysCall::PrintChar:
+            print(QChar(val));
+            break;
+        case SysCall::PrintIntHex:
+            print("0x" + QString::number(val, 16).rightJustified(iss.implementsISA()->bytes(), '0'));
+            break;
+        case SysCall::PrintIntBinary:
+            print("0b" + QString::number(val, 2).rightJustified(iss.implementsISA()->bits(), '0'));
+            break;
+        case SysCall::PrintIntUnsigned:
+            print(QString::number(val));
+            break;
+        case SysCall::PrintStr: {
+            // The string is read in blocks, searching each block for the null terminator
+            static constexpr unsigned s_blockSize = 64;
+            uint8_t block[s_blockSize];
+            QByteArray string;
+            for (uint32_t address = val;; address += s_blockSize) {
+                {
+                    std::lock_guard<std::mutex> lock(m_interconnect.mutex);
+                    iss.readMemRange(address, block, s_blockSize);
+                }
+                const auto* terminator = static_cast<const uint8_t*>(std::memchr(block, 0, s_blockSize));
+                string.append(reinterpret_cast<const char*>(block),
+                              terminator ? static_cast<int>(terminator - block) : static_cast<int>(s_blockSize));
+                if (terminator) {
+                    break;
+                }
+            }
+            print(QString::fromUtf8(string));
+            break;
+        }
+        case SysCall::Write: {
+            // Only the console may be written to
+            const int length = static_cast<int>(iss.getRegister(12));
+            if (length < 0 || (val != 1 && val != 2)) {
+                iss.setRegister(10, static_cast<uint32_t>(-1));
+                break;
+            }
+            QByteArray data(length, '\0');
+            {
+                std::lock_guard<std::mutex> lock(m_interconnect.mutex);
+                iss.readMemRange(iss.getRegister(11), reinterpret_cast<uint8_t*>(data.data()), length);
+            }
+            print(QString::fromUtf8(data));
+            iss.setRegister(10, static_cast<uint32_t>(length));
+            break;
+        }
+        case SysCall::Exit:
+        case SysCall::Exit2: {
+            vsrtl::core::FinalizeReason fr;
+            fr.exitSyscall = true;
+            iss.finalize(fr);
+            m_exited.store(true, std::memory_order_relaxed);
+            break;
+        }
+        default:
+            iss.setRegister(10, static_cast<uint32_t>(-1));
+            break;
+    }
+}
+
+}  // namespace Ripes
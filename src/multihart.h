@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cachesim/coherence.h"
+#include "processorregistry.h"
+#include "processors/RISC-V/rviss/rviss.h"
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MultiHartSystem class
+ * A multi-core system of functional RV32IMA harts (see RVISS), each executing on a host thread of its own whilst
+ * sharing a single memory address space. Harts execute in time quanta: each hart executes up to a quantum of
+ * instructions, after which all harts meet at a barrier and synchronize, making the stores of each hart visible to the
+ * loads of all others. Smaller quanta model a tighter coupling of the harts at the expense of more frequent
+ * synchronization, whereas LR/SC and atomic memory operations are coherent at all times. Each hart executes an
+ * instruction per cycle, such that the cycles of the system are those of the hart which executed the most instructions.
+ * Harts read their id from mhartid, and start at the entry point of the program with the register initialization of
+ * the system, except for their stack pointers, which are offset downwards by s_stackSize per hart. The console system
+ * calls and exit are supported; an exit stops all harts at the end of the current quantum. Other system calls fail,
+ * returning -1.
+ * If enabled, the data accesses of the harts are simulated through coherent private L1 caches (see CoherenceModel).
+ * The accesses of each quantum are recorded by each hart, and performed upon the caches at the barrier, interleaving
+ * the harts access by access.
+ */
+class MultiHartSystem {
+public:
+    static constexpr uint32_t s_stackSize = 0x10000;
+
+    struct Result {
+        /// Set if a hart executed an exit system call
+        bool exited = false;
+        /// Set if all harts finished or a hart exited
+        bool finished = false;
+        bool cycleLimitReached = false;
+        bool cancelled = false;
+        long long cycles = 0;
+        /// Instructions retired by each hart
+        std::vector<long long> instructions;
+        /// Values of the architectural registers of each hart once stopped
+        std::vector<std::vector<uint32_t>> registers;
+        /// Statistics of the cache of each hart, and the most contended blocks, if coherence is simulated
+        std::vector<CoherenceModel::HartStatistics> coherence;
+        std::vector<CoherenceModel::LineStatistics> coherenceLines;
+    };
+
+    /// Maximum number of blocks reported in Result::coherenceLines
+    static constexpr size_t s_reportedLines = 16;
+
+    MultiHartSystem(unsigned harts, const Program& program, const RegisterInitialization& registers);
+    ~MultiHartSystem();
+
+    /**
+     * @brief enableCoherence
+     * Simulates the data accesses of all harts through private L1 caches of 2^lines sets, 2^ways ways and 2^blocks
+     * words per block, kept coherent through MESI. Statistics accumulate across runs.
+     */
+    void enableCoherence(int lines, int ways, int blocks);
+
+    /**
+     * @brief run
+     * Executes the harts in quanta of @p quantum instructions until all harts have finished, a hart has exited,
+     * @p maxCycles cycles have been executed (0 = unlimited) or @p stop is set. Output of the console system calls is
+     * forwarded to @p print from the thread of the printing hart, one call at a time.
+     */
+    Result run(unsigned long long quantum, unsigned long long maxCycles,
+               const std::function<void(const QString&)>& print, const std::atomic<bool>* stop = nullptr);
+
+    /// Memory address space shared by the harts
+    const vsrtl::core::SparseArray& getMemory() const { return *m_memory; }
+
+private:
+    struct Hart {
+        MultiHartSystem* system;
+        std::unique_ptr<vsrtl::core::SparseArray> registers;
+        std::unique_ptr<vsrtl::core::RVISS> iss;
+        /// Data accesses of the current quantum, as recorded for the coherence model
+        std::vector<vsrtl::core::TracedMemoryAccess> accesses;
+        void sysCall() { system->handleSysCall(*this); }
+        void accessesTraced(const std::vector<vsrtl::core::TracedMemoryAccess>& traced) {
+            for (const auto& access : traced) {
+                if (access.kind != vsrtl::core::TracedMemoryAccess::Fetch) {
+                    accesses.push_back(access);
+                }
+            }
+        }
+    };
+
+    void runHart(Hart& hart, unsigned long long quantum, unsigned long long maxCycles);
+    /**
+     * @brief barrier
+     * Blocks until all harts have completed the current quantum. The last hart to arrive determines whether the
+     * simulation continues.
+     * @returns false if the simulation has stopped.
+     */
+    bool barrier(unsigned long long maxCycles);
+    /// Performs the accesses recorded by all harts upon the coherence model. Must only be called within the barrier.
+    void simulateCoherence();
+    void handleSysCall(Hart& hart);
+    void print(const QString& output);
+
+    std::unique_ptr<vsrtl::core::SparseArray> m_memory;
+    vsrtl::core::HartInterconnect m_interconnect;
+    std::vector<std::unique_ptr<Hart>> m_harts;
+    std::unique_ptr<CoherenceModel> m_coherence;
+
+    std::function<void(const QString&)> m_print;
+    std::mutex m_printMutex;
+    const std::atomic<bool>* m_stop = nullptr;
+    std::atomic<bool> m_exited{false};
+
+    std::mutex m_barrierMutex;
+    std::condition_variable m_barrierCondition;
+    unsigned m_arrived = 0;
+    unsigned long long m_generation = 0;
+    bool m_stopped = false;
+    Result m_result;
+};
+
+}  // namespace Ripes
@@ -1,139 +1,104 @@
 #include "parser.h"
 #include "defines.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <iostream>
 
-#include <QDataStream>
 #include <QFile>
 
 #include "binutils.h"
+#include "processors/RISC-V/rv_compressed.h"
+#include "processors/RISC-V/rv_instrparser.h"
 
 namespace Ripes {
 
-Parser::Parser() {
-    // generate word parser functors
-    m_decodeRInstr = generateWordParser(vector<int>{5, 3, 5, 5, 7});  // from LSB to MSB
-    m_decodeIInstr = generateWordParser(vector<int>{5, 3, 5, 12});
-    m_decodeSInstr = generateWordParser(vector<int>{5, 3, 5, 5, 7});
-    m_decodeBInstr = generateWordParser(vector<int>{1, 4, 3, 5, 5, 6, 1});
-    m_decodeUInstr = generateWordParser(vector<int>{5, 20});
-    m_decodeJInstr = generateWordParser(vector<int>{5, 8, 1, 10, 1});
-}
-
-Parser::~Parser() {}
-
-QString Parser::disassemble(const Program& program, AddrOffsetMap& addrOffsetMap) const {
-    return stringifyProgram(program, 4,
-                            [this, &program](const std::vector<char>& buffer, uint32_t index) {
-                                // Hardcoded for RV32 for now
-                                uint32_t instr = 0;
-                                for (int i = 0; i < 4; i++) {
-                                    instr |= (buffer[i] & 0xFF) << (CHAR_BIT * i);
-                                }
-                                return disassemble(program, instr, index);
-                            },
-                            addrOffsetMap);
-}
-
-QString Parser::binarize(const Program& program, AddrOffsetMap& addrOffsetMap) const {
-    return stringifyProgram(
-        program, 4,
-        [](const std::vector<char>& buffer, uint32_t) {
-            QString binaryString;
-            for (auto byte : buffer) {
-                binaryString.prepend(QString().setNum(static_cast<uint8_t>(byte), 2).rightJustified(8, '0'));
-            }
-            return binaryString;
-        },
-        addrOffsetMap);
+InstructionLayout::InstructionLayout(const QByteArray& text, bool compressed)
+    : m_size(static_cast<uint32_t>(text.size())) {
+    if (compressed) {
+        for (uint32_t offset = 0; offset < m_size;) {
+            m_offsets.push_back(offset);
+            offset += instructionLength(static_cast<uint8_t>(text.at(static_cast<int>(offset))));
+        }
+        // Offsets are implied by the indices of the instructions unless an instruction is not word aligned
+        if (std::any_of(m_offsets.begin(), m_offsets.end(), [](uint32_t offset) { return (offset & 0b11) != 0; })) {
+            m_count = static_cast<unsigned>(m_offsets.size());
+            return;
+        }
+        m_offsets.clear();
+    }
+    m_count = (m_size + 3) / 4;
 }
 
-namespace {
-void incrementAddressOffsetMap(const QString& text, AddrOffsetMap& map, int& offsets) {
-    map[text.count('\n')] = offsets++;
+int InstructionLayout::index(uint32_t offset) const {
+    if (offset >= m_size) {
+        return -1;
+    }
+    if (m_offsets.empty()) {
+        return static_cast<int>(offset / 4);
+    }
+    return static_cast<int>(std::upper_bound(m_offsets.begin(), m_offsets.end(), offset) - m_offsets.begin()) - 1;
 }
-}  // namespace
-
-QString Parser::stringifyProgram(const Program& program, unsigned stride,
-                                 std::function<QString(const std::vector<char>&, uint32_t index)> stringifier,
-                                 AddrOffsetMap& addrOffsetMap) const {
-    const auto* textSection = program.getSection(TEXT_SECTION_NAME);
-    if (!textSection)
-        return QString();
-
-    QString out;
-    auto dataStream = QDataStream(textSection->data);
-    std::vector<char> buffer;
-    buffer.resize(stride);
-
-    int infoOffsets = 0;
-
-    for (unsigned long addr = textSection->address; addr < textSection->address + textSection->data.length();
-         addr += stride) {
-        dataStream.readRawData(buffer.data(), stride);
-
-        // Function label
-        if (program.symbols.count(addr)) {
-            // We are adding non-instruction lines to the output string. Record the line number as well as the sum of
-            // invalid lines up to the given point.
-            incrementAddressOffsetMap(out, addrOffsetMap, infoOffsets);
-            out += "\n";
-            incrementAddressOffsetMap(out, addrOffsetMap, infoOffsets);
-            out += QString::number(addr, 16).rightJustified(8, '0') + " <" + program.symbols.at(addr) + ">:\n";
-        }
 
-        // Instruction address
-        out += "\t" + QString::number(addr, 16) + ":\t\t";
+Parser::Parser() {}
 
-        // Instruction word
-        QString wordString;
-        for (auto byte : buffer) {
-            wordString.prepend(QString().setNum(static_cast<uint8_t>(byte), 16).rightJustified(2, '0'));
-        }
-        out += wordString + "\t\t";
+Parser::~Parser() {}
 
-        // Stringified instruction
-        out += stringifier(buffer, addr) + "\n";
+namespace {
+/// Appends the @p digits least significant digits of @p value in base 2^@p bitsPerDigit, most significant first
+void appendDigits(QString& out, unsigned long value, int digits, int bitsPerDigit) {
+    static constexpr char s_digits[] = "0123456789abcdef";
+    const int start = out.size();
+    out.resize(start + digits);
+    QChar* data = out.data() + start;
+    for (int i = digits - 1; i >= 0; i--, value >>= bitsPerDigit) {
+        data[i] = QLatin1Char(s_digits[value & ((1u << bitsPerDigit) - 1)]);
     }
-    return out;
 }
 
-decode_functor Parser::generateWordParser(std::vector<int> bitFields) {
-    // Generates functors that can decode a binary number based on the input
-    // vector which is supplied upon generation
-
-    // Assert that total bitField size is (32-7)=25-bit. Subtract 7 for op-code
-    int tot = 0;
-    for (const auto& field : bitFields) {
-        tot += field;
+int hexDigits(unsigned long value) {
+    int digits = 1;
+    while (value >>= 4) {
+        digits++;
     }
-    assert(tot == 25 && "Requested word parsing format is not 32-bit in length");
-
-    // Generate vector of <fieldsize,bitmask>
-    std::vector<std::pair<uint32_t, uint32_t>> parseVector;
+    return digits;
+}
+}  // namespace
 
-    // Generate bit masks and fill parse vector
-    for (const auto& field : bitFields) {
-        parseVector.emplace_back(field, generateBitmask(field));
+QString Parser::instructionLine(const Program& program, uint32_t instr, uint32_t address, bool binary,
+                                bool compressed) const {
+    // Lines are formatted into a single preallocated string; the listing formats one per visible or copied row
+    const int bits = compressed && instructionLength(instr) == 2 ? 16 : 32;
+    QString line;
+    line.reserve(64);
+    line += '\t';
+    appendDigits(line, address, hexDigits(address), 4);
+    line += QLatin1String(":\t\t");
+    appendDigits(line, instr, bits / 4, 4);
+    line += QLatin1String("\t\t");
+    if (binary) {
+        appendDigits(line, instr, bits, 1);
+    } else {
+        line += disassemble(program, instr, address, compressed);
     }
+    return line;
+}
 
-    // Create parse functor
-    decode_functor wordParser = [=](uint32_t word) {
-        word = word >> 7;  // remove OpCode
-        std::vector<uint32_t> parsedWord;
-        for (const auto& field : parseVector) {
-            parsedWord.insert(parsedWord.begin(), word & field.second);
-            word = word >> field.first;
-        }
-        return parsedWord;
-    };
-
-    return wordParser;
+QString Parser::labelLine(unsigned long address, const QString& symbol) const {
+    QString line;
+    line.reserve(symbol.size() + 12);
+    appendDigits(line, address, std::max(8, hexDigits(address)), 4);
+    line += QLatin1String(" <");
+    line += symbol;
+    line += QLatin1String(">:");
+    return line;
 }
 
-QString Parser::disassemble(const Program& program, uint32_t instr, uint32_t address) const {
+QString Parser::disassemble(const Program& program, uint32_t instr, uint32_t address, bool compressed) const {
+    if (compressed && instructionLength(instr) == 2) {
+        return generateCompressedString(instr & 0xffff, address, program);
+    }
     switch (instr & 0x7f) {
         case instrType::LUI:
             return generateLuiString(instr);
@@ -154,7 +119,8 @@ QString Parser::disassemble(const Program& program, uint32_t instr, uint32_t add
         case instrType::OP:
             return generateOpInstrString(instr);
         case instrType::ECALL:
-            return generateEcallString(instr);
+            // CSR instructions share the opcode of ECALL
+            return decodeIInstr(instr).funct3 == 0 ? generateEcallString(instr) : generateCSRString(instr);
         default:
             return QString("Invalid instruction");
     }
@@ -163,66 +129,91 @@ QString Parser::generateEcallString(uint32_t) const {
     return QString("ecall");
 }
 
+QString Parser::generateCSRString(uint32_t instr) const {
+    const auto fields = decodeIInstr(instr);
+    const QString csr = CSRNames.key(fields.imm, "0x" + QString::number(fields.imm, 16));
+    switch (fields.funct3) {
+        case 0b001:  // CSRRW
+            return QString("csrrw x%1 %2 x%3").arg(fields.rd).arg(csr).arg(fields.rs1);
+        case 0b010:  // CSRRS
+            if (fields.rs1 == 0) {
+                // csrr special case
+                return QString("csrr x%1 %2").arg(fields.rd).arg(csr);
+            }
+            return QString("csrrs x%1 %2 x%3").arg(fields.rd).arg(csr).arg(fields.rs1);
+        case 0b011:  // CSRRC
+            return QString("csrrc x%1 %2 x%3").arg(fields.rd).arg(csr).arg(fields.rs1);
+        case 0b101:  // CSRRWI
+            return QString("csrrwi x%1 %2 %3").arg(fields.rd).arg(csr).arg(fields.rs1);
+        case 0b110:  // CSRRSI
+            return QString("csrrsi x%1 %2 %3").arg(fields.rd).arg(csr).arg(fields.rs1);
+        case 0b111:  // CSRRCI
+            return QString("csrrci x%1 %2 %3").arg(fields.rd).arg(csr).arg(fields.rs1);
+        default:
+            return QString("Invalid instruction");
+    }
+}
+
 QString Parser::generateOpInstrString(uint32_t instr) const {
-    std::vector<uint32_t> fields = decodeRInstr(instr);
-    switch (fields[3]) {
+    const auto fields = decodeRInstr(instr);
+    switch (fields.funct3) {
         case 0b000:
-            if (fields[0] == 0) {
-                return QString("add x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
-            } else if (fields[0] == 0b0100000) {
-                return QString("sub x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
-            } else if (fields[0] == 0b0000001) {
-                return QString("mul x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0) {
+                return QString("add x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
+            } else if (fields.funct7 == 0b0100000) {
+                return QString("sub x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
+            } else if (fields.funct7 == 0b0000001) {
+                return QString("mul x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
             break;
         case 0b001:
-            if (fields[0] == 0b0000001) {
-                return QString("mulh x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
-            } else if (fields[0] == 0) {
-                return QString("sll x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0b0000001) {
+                return QString("mulh x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
+            } else if (fields.funct7 == 0) {
+                return QString("sll x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
             break;
         case 0b010:
-            if (fields[0] == 0b0000001) {
-                return QString("mulhsu x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
-            } else if (fields[0] == 0) {
-                return QString("slt x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0b0000001) {
+                return QString("mulhsu x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
+            } else if (fields.funct7 == 0) {
+                return QString("slt x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
             break;
         case 0b011:
-            if (fields[0] == 0b0000001) {
-                return QString("mulhu x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0b0000001) {
+                return QString("mulhu x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             } else {
-                return QString("sltu x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+                return QString("sltu x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
         case 0b100:
-            if (fields[0] == 0b1) {
-                return QString("div x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0b1) {
+                return QString("div x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             } else {
-                return QString("xor x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+                return QString("xor x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
         case 0b101:
-            if (fields[0] == 0) {
-                return QString("srl x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0) {
+                return QString("srl x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
 
-            } else if (fields[0] == 0b0100000) {
-                return QString("sra x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            } else if (fields.funct7 == 0b0100000) {
+                return QString("sra x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
 
-            } else if (fields[0] == 0b1) {
-                return QString("divu x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            } else if (fields.funct7 == 0b1) {
+                return QString("divu x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
             break;
         case 0b110:
-            if (fields[0] == 0b1) {
-                return QString("rem x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0b1) {
+                return QString("rem x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             } else {
-                return QString("or x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+                return QString("or x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
         case 0b111:
-            if (fields[0] == 0b1) {
-                return QString("remu x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+            if (fields.funct7 == 0b1) {
+                return QString("remu x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             } else {
-                return QString("and x%1 x%2 x%3").arg(fields[4]).arg(fields[2]).arg(fields[1]);
+                return QString("and x%1 x%2 x%3").arg(fields.rd).arg(fields.rs1).arg(fields.rs2);
             }
         default:
             break;
@@ -231,97 +222,97 @@ QString Parser::generateOpInstrString(uint32_t instr) const {
 }
 
 QString Parser::generateOpImmString(uint32_t instr) const {
-    std::vector<uint32_t> fields = decodeIInstr(instr);
-    switch (fields[2]) {
+    const auto fields = decodeIInstr(instr);
+    switch (fields.funct3) {
         case 0b000:  // ADDI
-            if (fields[3] == 0 && fields[1] == 0) {
+            if (fields.rd == 0 && fields.rs1 == 0) {
                 // nop special case
                 return QString("nop");
             }
-            return QString("addi x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(signextend<int32_t, 12>(fields[0]));
+            return QString("addi x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(signextend<int32_t, 12>(fields.imm));
         case 0b001:  // SLLI
-            return QString("slli x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(fields[0] & 0b11111);
+            return QString("slli x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(fields.imm & 0b11111);
         case 0b010:  // SLTI
-            return QString("slti x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(signextend<int32_t, 12>(fields[0]));
+            return QString("slti x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(signextend<int32_t, 12>(fields.imm));
         case 0b011:  // SLTIU
-            return QString("sltiu x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(fields[0]);
+            return QString("sltiu x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(fields.imm);
         case 0b100:  // XORI
-            return QString("xori x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(fields[0]);
+            return QString("xori x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(fields.imm);
         case 0b101:
-            if ((fields[0] >> 5) == 0) {
-                return QString("srli x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(fields[0] & 0b11111);
+            if ((fields.imm >> 5) == 0) {
+                return QString("srli x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(fields.imm & 0b11111);
             } else {  // SRAI
-                return QString("srai x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(fields[0] & 0b11111);
+                return QString("srai x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(fields.imm & 0b11111);
             }
         case 0b110:  // ORI
-            return QString("ori x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(fields[0]);
+            return QString("ori x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(fields.imm);
         case 0b111:  // ANDI
-            return QString("andi x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(fields[0]);
+            return QString("andi x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(fields.imm);
         default:
             return QString();
     }
 }
 
 QString Parser::generateStoreString(uint32_t instr) const {
-    std::vector<uint32_t> fields = decodeSInstr(instr);
-    auto offset = signextend<int32_t, 12>((fields[0] << 5) | fields[4]);
-    switch (fields[3]) {
+    const auto fields = decodeSInstr(instr);
+    auto offset = signextend<int32_t, 12>(immediate(fields));
+    switch (fields.funct3) {
         case 0b000:  // SB
-            return QString("sb x%1 %2(x%3)").arg(fields[1]).arg(offset).arg(fields[2]);
+            return QString("sb x%1 %2(x%3)").arg(fields.rs2).arg(offset).arg(fields.rs1);
         case 0b001:  // SH
-            return QString("sh x%1 %2(x%3)").arg(fields[1]).arg(offset).arg(fields[2]);
+            return QString("sh x%1 %2(x%3)").arg(fields.rs2).arg(offset).arg(fields.rs1);
         case 0b010:  // SW
-            return QString("sw x%1 %2(x%3)").arg(fields[1]).arg(offset).arg(fields[2]);
+            return QString("sw x%1 %2(x%3)").arg(fields.rs2).arg(offset).arg(fields.rs1);
         default:
             return QString();
     }
 }
 
 QString Parser::generateLoadString(uint32_t instr) const {
-    std::vector<uint32_t> fields = decodeIInstr(instr);
+    const auto fields = decodeIInstr(instr);
 
     // Handle different load types by pointer casting and subsequent
     // dereferencing. This will handle whether to sign or zero extend.
-    switch (fields[2]) {
+    switch (fields.funct3) {
         case 0b000:  // LB - load sign extended byte
-            return QString("lb x%1 %2(x%3)").arg(fields[3]).arg(signextend<int, 12>(fields[0])).arg(fields[1]);
+            return QString("lb x%1 %2(x%3)").arg(fields.rd).arg(signextend<int, 12>(fields.imm)).arg(fields.rs1);
         case 0b001:  // LH load sign extended halfword
-            return QString("lh x%1 %2(x%3)").arg(fields[3]).arg(signextend<int, 12>(fields[0])).arg(fields[1]);
+            return QString("lh x%1 %2(x%3)").arg(fields.rd).arg(signextend<int, 12>(fields.imm)).arg(fields.rs1);
         case 0b010:  // LW load word
-            return QString("lw x%1 %2(x%3)").arg(fields[3]).arg(signextend<int, 12>(fields[0])).arg(fields[1]);
+            return QString("lw x%1 %2(x%3)").arg(fields.rd).arg(signextend<int, 12>(fields.imm)).arg(fields.rs1);
         case 0b100:  // LBU load zero extended byte
-            return QString("lbu x%1 %2(x%3)").arg(fields[3]).arg(signextend<int, 12>(fields[0])).arg(fields[1]);
+            return QString("lbu x%1 %2(x%3)").arg(fields.rd).arg(signextend<int, 12>(fields.imm)).arg(fields.rs1);
         case 0b101:  // LHU load zero extended halfword
-            return QString("lhu x%1 %2(x%3)").arg(fields[3]).arg(signextend<int, 12>(fields[0])).arg(fields[1]);
+            return QString("lhu x%1 %2(x%3)").arg(fields.rd).arg(signextend<int, 12>(fields.imm)).arg(fields.rs1);
         default:
             return QString();
     }
 }
 
 QString Parser::generateBranchString(uint32_t instr, uint32_t address, const Program& program) const {
-    std::vector<uint32_t> fields = decodeBInstr(instr);
-    auto offset = signextend<int32_t, 13>((fields[0] << 12) | (fields[1] << 5) | (fields[5] << 1) | (fields[6] << 11));
+    const auto fields = decodeBInstr(instr);
+    auto offset = signextend<int32_t, 13>(immediate(fields));
 
     QString brStr;
 
-    switch (fields[4]) {
+    switch (fields.funct3) {
         case 0b000:  // BEQ
-            brStr = QString("beq x%1 x%2 %3").arg(fields[3]).arg(fields[2]).arg(offset);
+            brStr = QString("beq x%1 x%2 %3").arg(fields.rs1).arg(fields.rs2).arg(offset);
             break;
         case 0b001:  // BNE
-            brStr = QString("bne x%1 x%2 %3").arg(fields[3]).arg(fields[2]).arg(offset);
+            brStr = QString("bne x%1 x%2 %3").arg(fields.rs1).arg(fields.rs2).arg(offset);
             break;
         case 0b100:  // BLT - signed comparison
-            brStr = QString("blt x%1 x%2 %3").arg(fields[3]).arg(fields[2]).arg(offset);
+            brStr = QString("blt x%1 x%2 %3").arg(fields.rs1).arg(fields.rs2).arg(offset);
             break;
         case 0b101:  // BGE - signed comparison
-            brStr = QString("bge x%1 x%2 %3").arg(fields[3]).arg(fields[2]).arg(offset);
+            brStr = QString("bge x%1 x%2 %3").arg(fields.rs1).arg(fields.rs2).arg(offset);
             break;
         case 0b110:  // BLTU
-            brStr = QString("bltu x%1 x%2 %3").arg(fields[3]).arg(fields[2]).arg(offset);
+            brStr = QString("bltu x%1 x%2 %3").arg(fields.rs1).arg(fields.rs2).arg(offset);
             break;
         case 0b111:  // BGEU
-            brStr = QString("bgeu x%1 x%2 %3").arg(fields[3]).arg(fields[2]).arg(offset);
+            brStr = QString("bgeu x%1 x%2 %3").arg(fields.rs1).arg(fields.rs2).arg(offset);
             break;
         default:
             return QString();
@@ -337,23 +328,23 @@ QString Parser::generateBranchString(uint32_t instr, uint32_t address, const Pro
 }
 
 QString Parser::generateJalrString(uint32_t instr) const {
-    std::vector<uint32_t> fields = decodeIInstr(instr);
-    return QString("jalr x%1 x%2 %3").arg(fields[3]).arg(fields[1]).arg(signextend<int32_t, 12>(fields[0]));
+    const auto fields = decodeIInstr(instr);
+    return QString("jalr x%1 x%2 %3").arg(fields.rd).arg(fields.rs1).arg(signextend<int32_t, 12>(fields.imm));
 }
 
 QString Parser::generateLuiString(uint32_t instr) const {
-    std::vector<uint32_t> fields = decodeUInstr(instr);
-    return QString("lui x%1 %2").arg(fields[1]).arg("0x" + QString::number(fields[0], 16));
+    const auto fields = decodeUInstr(instr);
+    return QString("lui x%1 %2").arg(fields.rd).arg("0x" + QString::number(fields.imm, 16));
 }
 
 QString Parser::generateAuipcString(uint32_t instr) const {
-    std::vector<uint32_t> fields = decodeUInstr(instr);
-    return QString("auipc x%1 %2").arg(fields[1]).arg("0x" + QString::number(fields[0], 16));
+    const auto fields = decodeUInstr(instr);
+    return QString("auipc x%1 %2").arg(fields.rd).arg("0x" + QString::number(fields.imm, 16));
 }
 
 QString Parser::generateJalString(uint32_t instr, uint32_t address, const Program& program) const {
-    std::vector<uint32_t> fields = decodeJInstr(instr);
-    uint32_t target = signextend<int32_t, 21>(fields[0] << 20 | fields[1] << 1 | fields[2] << 11 | fields[3] << 12);
+    const auto fields = decodeJInstr(instr);
+    uint32_t target = signextend<int32_t, 21>(immediate(fields));
 
     target += address;
 
@@ -362,6 +353,100 @@ QString Parser::generateJalString(uint32_t instr, uint32_t address, const Progra
         landingPadSymbol = " <" + program.symbols.at(target) + ">";
     }
 
-    return QString("jal x%1 %2").arg(fields[4]).arg("0x" + QString::number(target, 16)) + landingPadSymbol;
+    return QString("jal x%1 %2").arg(fields.rd).arg("0x" + QString::number(target, 16)) + landingPadSymbol;
+}
+
+QString Parser::generateCompressedString(uint32_t instr, uint32_t address, const Program& program) const {
+    if (expandCompressed(instr) == 0) {
+        return QString("Invalid instruction");
+    }
+    using namespace rvc;
+    const unsigned funct3 = bitField<13, 3>(instr);
+    // rd/rs1 and rs2 of the CR, CI and CSS formats, and the registers of the other formats, which address x8-x15
+    const unsigned rd = bitField<7, 5>(instr);
+    const unsigned rs2 = bitField<2, 5>(instr);
+    const unsigned rdp = bitField<2, 3>(instr) + 8;
+    const unsigned rs1p = bitField<7, 3>(instr) + 8;
+
+    const auto jumpTarget = [&](uint32_t offset) {
+        const uint32_t target = address + offset;
+        QString str = "0x" + QString::number(target, 16);
+        if (program.symbols.count(target)) {
+            str += " <" + program.symbols.at(target) + ">";
+        }
+        return str;
+    };
+    const auto branchTarget = [&](uint32_t offset) {
+        QString str = QString::number(static_cast<int32_t>(offset));
+        if (program.symbols.count(address + offset)) {
+            str += " <" + program.symbols.at(address + offset) + ">";
+        }
+        return str;
+    };
+
+    switch (bitField<0, 2>(instr)) {
+        case 0b00:
+            switch (funct3) {
+                case 0b000:
+                    return QString("c.addi4spn x%1 x2 %2").arg(rdp).arg(immCIW(instr));
+                case 0b010:
+                    return QString("c.lw x%1 %2(x%3)").arg(rdp).arg(immCLW(instr)).arg(rs1p);
+                default:  // C.SW
+                    return QString("c.sw x%1 %2(x%3)").arg(rdp).arg(immCLW(instr)).arg(rs1p);
+            }
+        case 0b01:
+            switch (funct3) {
+                case 0b000:
+                    if (rd == 0) {
+                        return QString("c.nop");
+                    }
+                    return QString("c.addi x%1 %2").arg(rd).arg(static_cast<int32_t>(immCI(instr)));
+                case 0b001:
+                    return QString("c.jal ") + jumpTarget(immCJ(instr));
+                case 0b010:
+                    return QString("c.li x%1 %2").arg(rd).arg(static_cast<int32_t>(immCI(instr)));
+                case 0b011:
+                    if (rd == 2) {
+                        return QString("c.addi16sp x2 %1").arg(static_cast<int32_t>(immAddi16sp(instr)));
+                    }
+                    return QString("c.lui x%1 %2").arg(rd).arg("0x" + QString::number(immCI(instr) & 0xfffff, 16));
+                case 0b100:
+                    switch (bitField<10, 2>(instr)) {
+                        case 0b00:
+                            return QString("c.srli x%1 %2").arg(rs1p).arg(rs2);
+                        case 0b01:
+                            return QString("c.srai x%1 %2").arg(rs1p).arg(rs2);
+                        case 0b10:
+                            return QString("c.andi x%1 %2").arg(rs1p).arg(static_cast<int32_t>(immCI(instr)));
+                        default: {
+                            static const char* const s_names[] = {"c.sub", "c.xor", "c.or", "c.and"};
+                            return QString("%1 x%2 x%3").arg(s_names[bitField<5, 2>(instr)]).arg(rs1p).arg(rdp);
+                        }
+                    }
+                case 0b101:
+                    return QString("c.j ") + jumpTarget(immCJ(instr));
+                case 0b110:
+                    return QString("c.beqz x%1 ").arg(rs1p) + branchTarget(immCB(instr));
+                default:
+                    return QString("c.bnez x%1 ").arg(rs1p) + branchTarget(immCB(instr));
+            }
+        default:
+            switch (funct3) {
+                case 0b000:
+                    return QString("c.slli x%1 %2").arg(rd).arg(rs2);
+                case 0b010:
+                    return QString("c.lwsp x%1 %2(x2)").arg(rd).arg(immLwsp(instr));
+                case 0b100:
+                    if (!bitField<12, 1>(instr)) {
+                        return rs2 == 0 ? QString("c.jr x%1").arg(rd) : QString("c.mv x%1 x%2").arg(rd).arg(rs2);
+                    }
+                    if (rs2 == 0) {
+                        return QString("c.jalr x%1").arg(rd);
+                    }
+                    return QString("c.add x%1 x%2").arg(rd).arg(rs2);
+                default:  // C.SWSP
+                    return QString("c.swsp x%1 %2(x2)").arg(rs2).arg(immSwsp(instr));
+            }
+    }
 }
 }  // namespace Ripes
@@ -17,9 +17,30 @@ namespace Ripes {
 */
 
 using namespace std;
-typedef std::function<std::vector<uint32_t>(uint32_t)> decode_functor;
 
-using AddrOffsetMap = std::map<unsigned long, int>;
+/**
+ * @brief The InstructionLayout class
+ * Maps between the index of each instruction of a text section and its offset within the section. Instructions are
+ * 32 bits wide, unless the section may contain compressed instructions, in which case the offset of each instruction
+ * is determined by the sizes of the instructions preceding it. Offsets are only stored if they are not implied by the
+ * indices of the instructions.
+ */
+class InstructionLayout {
+public:
+    InstructionLayout() = default;
+    InstructionLayout(const QByteArray& text, bool compressed);
+
+    unsigned count() const { return m_count; }
+    /// @returns the offset of the instruction at @p index
+    uint32_t offset(unsigned index) const { return m_offsets.empty() ? index * 4 : m_offsets[index]; }
+    /// @returns the index of the instruction at or containing @p offset, or -1 if @p offset is beyond the section
+    int index(uint32_t offset) const;
+
+private:
+    uint32_t m_size = 0;
+    unsigned m_count = 0;
+    std::vector<uint32_t> m_offsets;
+};
 
 class Parser {
 public:
@@ -28,36 +49,29 @@ public:
         return &parser;
     }
 
-    QString disassemble(const Program& program, uint32_t instr, uint32_t address) const;
+    /**
+     * @brief disassemble
+     * @returns the disassembly of @param instr at @param address. If @param compressed is set, @param instr is
+     * disassembled as a compressed instruction if its size indicates so.
+     */
+    QString disassemble(const Program& program, uint32_t instr, uint32_t address, bool compressed = false) const;
 
-    // Const interfaces to intstruction decode lamdas
-    std::vector<uint32_t> decodeUInstr(uint32_t instr) const { return m_decodeUInstr(instr); }
-    std::vector<uint32_t> decodeJInstr(uint32_t instr) const { return m_decodeJInstr(instr); }
-    std::vector<uint32_t> decodeIInstr(uint32_t instr) const { return m_decodeIInstr(instr); }
-    std::vector<uint32_t> decodeSInstr(uint32_t instr) const { return m_decodeSInstr(instr); }
-    std::vector<uint32_t> decodeRInstr(uint32_t instr) const { return m_decodeRInstr(instr); }
-    std::vector<uint32_t> decodeBInstr(uint32_t instr) const { return m_decodeBInstr(instr); }
+    /**
+     * @brief instructionLine
+     * @returns the line of a program listing showing @param instr at @param address; its address, instruction word and
+     * either its disassembly or (if @param binary is true) its binary representation. Compressed instructions (if
+     * @param compressed is set) are shown as halfwords.
+     */
+    QString instructionLine(const Program& program, uint32_t instr, uint32_t address, bool binary,
+                            bool compressed = false) const;
 
-    QString disassemble(const Program& program, AddrOffsetMap& addrOffsetMap) const;
-    QString binarize(const Program& program, AddrOffsetMap& addrOffsetMap) const;
+    /// @returns the line of a program listing which labels @param address with @param symbol
+    QString labelLine(unsigned long address, const QString& symbol) const;
 
 private:
-    QString stringifyProgram(const Program& program, unsigned stride,
-                             std::function<QString(const std::vector<char>& buffer, uint32_t index)> stringifier,
-                             AddrOffsetMap& addrOffsetMap) const;
-
     Parser();
     ~Parser();
 
-    // Instruction decode lambda functions; runtime generated
-    decode_functor generateWordParser(std::vector<int> bitFields);
-    decode_functor m_decodeUInstr;
-    decode_functor m_decodeJInstr;
-    decode_functor m_decodeIInstr;
-    decode_functor m_decodeSInstr;
-    decode_functor m_decodeRInstr;
-    decode_functor m_decodeBInstr;
-
     // String generating functions
     QString generateBranchString(uint32_t instr, uint32_t address, const Program& program) const;
     QString generateLuiString(uint32_t instr) const;
@@ -69,5 +83,7 @@ private:
     QString generateOpImmString(uint32_t instr) const;
     QString generateOpInstrString(uint32_t instr) const;
     QString generateEcallString(uint32_t instr) const;
+    QString generateCSRString(uint32_t instr) const;
+    QString generateCompressedString(uint32_t instr, uint32_t address, const Program& program) const;
 };
 }  // namespace Ripes
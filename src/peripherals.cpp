@@ -0,0 +1,185 @@
+#include "peripherals.h"
+
+#include <QChar>
+
+#include <algorithm>
+
+namespace Ripes {
+
+namespace {
+/// Reads the word at @p address, without populating the memory with the bytes which are not present
+uint32_t readWord(const vsrtl::core::SparseArray& memory, uint32_t address) {
+    uint32_t value = 0;
+    for (unsigned i = 0; i < 4; i++) {
+        if (memory.contains(address + i)) {
+            value |= (static_cast<uint32_t>(memory.readMemConst(address + i)) & 0xFF) << (i * 8);
+        }
+    }
+    return value;
+}
+
+/// Writes the @p bytes low bytes of @p value to @p offset of the words of @p words, ignoring bytes beyond the words
+template <typename Words>
+void writeBytes(Words& words, size_t count, uint32_t offset, uint32_t value, unsigned bytes) {
+    for (unsigned i = 0; i < bytes; i++) {
+        const uint32_t byteOffset = offset + i;
+        if (byteOffset / 4 >= count) {
+            return;
+        }
+        const unsigned shift = (byteOffset % 4) * 8;
+        const uint32_t word = words[byteOffset / 4];
+        words[byteOffset / 4] = (word & ~(0xFFu << shift)) | (((value >> (i * 8)) & 0xFF) << shift);
+    }
+}
+}  // namespace
+
+void UartDevice::receive(const QByteArray& data) {
+    {
+        QMutexLocker lock(&m_rxMutex);
+        m_rx.insert(m_rx.end(), data.begin(), data.end());
+    }
+    setChanged();
+}
+
+int UartDevice::pending() const {
+    QMutexLocker lock(&m_rxMutex);
+    return static_cast<int>(m_rx.size());
+}
+
+bool UartDevice::read(uint32_t offset, uint32_t& value, const vsrtl::core::SparseArray&) const {
+    QMutexLocker lock(&m_rxMutex);
+    switch (offset) {
+        case RxData:
+            value = m_rx.empty() ? 0 : m_rx.front();
+            return true;
+        case Status:
+            // Transmission completes immediately
+            value = TxReady | (m_rx.empty() ? 0 : RxValid);
+            return true;
+        default:
+            return false;
+    }
+}
+
+void UartDevice::write(uint32_t offset, uint32_t value, unsigned) {
+    switch (offset) {
+        case TxData:
+            m_transmit(QChar(static_cast<uint8_t>(value & 0xFF)));
+            break;
+        case Status:
+            if (value & RxValid) {
+                QMutexLocker lock(&m_rxMutex);
+                if (!m_rx.empty()) {
+                    m_rx.pop_front();
+                }
+            }
+            setChanged();
+            break;
+        default:
+            break;
+    }
+}
+
+void UartDevice::reset() {
+    QMutexLocker lock(&m_rxMutex);
+    m_rx.clear();
+}
+
+bool TimerDevice::read(uint32_t offset, uint32_t& value, const vsrtl::core::SparseArray& memory) const {
+    const auto time = static_cast<uint64_t>(m_counters->performanceCounter(vsrtl::core::PerformanceCounter::Cycles));
+    switch (offset) {
+        case TimeLow:
+            value = static_cast<uint32_t>(time);
+            return true;
+        case TimeHigh:
+            value = static_cast<uint32_t>(time >> 32);
+            return true;
+        case Status: {
+            const uint64_t compare = static_cast<uint64_t>(readWord(memory, base() + CompareLow)) |
+                                     (static_cast<uint64_t>(readWord(memory, base() + CompareHigh)) << 32);
+            value = time >= compare ? Due : 0;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool LedPanelDevice::read(uint32_t offset, uint32_t& value, const vsrtl::core::SparseArray&) const {
+    if (offset != Switches) {
+        return false;
+    }
+    value = m_switches;
+    return true;
+}
+
+void LedPanelDevice::write(uint32_t offset, uint32_t value, unsigned bytes) {
+    if (offset >= Switches) {
+        return;
+    }
+    uint32_t leds = m_leds;
+    writeBytes(&leds, 1, offset, value, bytes);
+    m_leds = leds & ((1u << s_count) - 1);
+    setChanged();
+}
+
+void LedPanelDevice::sync(const vsrtl::core::SparseArray& memory) {
+    m_leds = readWord(memory, base() + Leds) & ((1u << s_count) - 1);
+}
+
+FramebufferDevice::FramebufferDevice(uint32_t base, unsigned width, unsigned height)
+    : MMIODevice("Framebuffer", base, width * height * 4),
+      m_width(width),
+      m_height(height),
+      m_tileColumns((width + s_tileSize - 1) / s_tileSize),
+      m_tileRows((height + s_tileSize - 1) / s_tileSize),
+      m_pixels(width * height, 0),
+      m_dirty(m_tileColumns * m_tileRows, true) {
+    for (unsigned tile = 0; tile < m_dirty.size(); tile++) {
+        m_dirtyTiles.push_back(tile);
+    }
+}
+
+void FramebufferDevice::takeDirtyTiles(uint32_t* pixels, std::vector<unsigned>& tiles) {
+    QMutexLocker lock(&m_pixelsMutex);
+    tiles.swap(m_dirtyTiles);
+    m_dirtyTiles.clear();
+    for (const unsigned tile : tiles) {
+        m_dirty[tile] = false;
+        const unsigned x0 = (tile % m_tileColumns) * s_tileSize;
+        const unsigned y0 = (tile / m_tileColumns) * s_tileSize;
+        const unsigned x1 = std::min(x0 + s_tileSize, m_width);
+        const unsigned y1 = std::min(y0 + s_tileSize, m_height);
+        for (unsigned y = y0; y < y1; y++) {
+            for (unsigned x = x0; x < x1; x++) {
+                pixels[y * m_width + x] = 0xFF000000 | (m_pixels[y * m_width + x] & 0xFFFFFF);
+            }
+        }
+    }
+}
+
+void FramebufferDevice::write(uint32_t offset, uint32_t value, unsigned bytes) {
+    {
+        QMutexLocker lock(&m_pixelsMutex);
+        writeBytes(m_pixels, m_pixels.size(), offset, value, bytes);
+        // A store of up to a word touches at most two pixels
+        markDirty(offset / 4);
+        if ((offset + bytes - 1) / 4 != offset / 4 && (offset + bytes - 1) / 4 < m_pixels.size()) {
+            markDirty((offset + bytes - 1) / 4);
+        }
+    }
+    setChanged();
+}
+
+void FramebufferDevice::sync(const vsrtl::core::SparseArray& memory) {
+    QMutexLocker lock(&m_pixelsMutex);
+    for (unsigned i = 0; i < m_pixels.size(); i++) {
+        const uint32_t pixel = readWord(memory, base() + i * 4);
+        if (pixel != m_pixels[i]) {
+            m_pixels[i] = pixel;
+            markDirty(i);
+        }
+    }
+}
+
+}  // namespace Ripes
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "mmiodevices.h"
+#include "processors/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The UartDevice class
+ * Serial port. Bytes stored to TxData are transmitted to the console. Received bytes are queued, with the oldest byte
+ * read from RxData while Status.RxValid is set; given that reads have no side effects, a received byte is consumed by
+ * storing RxValid to Status.
+ */
+class UartDevice : public MMIODevice {
+public:
+    static constexpr uint32_t s_defaultBase = 0xF0000000;
+    static constexpr uint32_t s_size = 0x10;
+    enum Register : uint32_t { TxData = 0x0, RxData = 0x4, Status = 0x8 };
+    enum StatusBit : uint32_t { RxValid = 0b01, TxReady = 0b10 };
+
+    UartDevice(uint32_t base, const std::function<void(const QString&)>& transmit)
+        : MMIODevice("UART", base, s_size), m_transmit(transmit) {}
+
+    /// Queues @p data for reception by the program. May be called from any thread.
+    void receive(const QByteArray& data);
+    /// @returns the number of received bytes which have not yet been consumed
+    int pending() const;
+
+    bool read(uint32_t offset, uint32_t& value, const vsrtl::core::SparseArray& memory) const override;
+    void write(uint32_t offset, uint32_t value, unsigned bytes) override;
+    void reset() override;
+
+private:
+    std::function<void(const QString&)> m_transmit;
+    mutable QMutex m_rxMutex;
+    std::deque<uint8_t> m_rx;
+};
+
+/**
+ * @brief The TimerDevice class
+ * Free-running 64-bit timer counting the cycles of the simulation, alongside a memory backed compare value. Status.Due
+ * is set while the time is at or beyond the compare value.
+ */
+class TimerDevice : public MMIODevice {
+public:
+    static constexpr uint32_t s_defaultBase = 0xF0000100;
+    static constexpr uint32_t s_size = 0x14;
+    enum Register : uint32_t { TimeLow = 0x0, TimeHigh = 0x4, CompareLow = 0x8, CompareHigh = 0xC, Status = 0x10 };
+    enum StatusBit : uint32_t { Due = 0b1 };
+
+    TimerDevice(uint32_t base, const vsrtl::core::PerformanceCounterSource* counters)
+        : MMIODevice("Timer", base, s_size), m_counters(counters) {}
+
+    bool read(uint32_t offset, uint32_t& value, const vsrtl::core::SparseArray& memory) const override;
+
+private:
+    const vsrtl::core::PerformanceCounterSource* m_counters;
+};
+
+/**
+ * @brief The LedPanelDevice class
+ * A row of LEDs, lit by the memory backed bits of Leds, and a row of switches, read from Switches.
+ */
+class LedPanelDevice : public MMIODevice {
+public:
+    static constexpr uint32_t s_defaultBase = 0xF0000200;
+    static constexpr uint32_t s_size = 0x8;
+    static constexpr unsigned s_count = 8;
+    enum Register : uint32_t { Leds = 0x0, Switches = 0x4 };
+
+    LedPanelDevice(uint32_t base) : MMIODevice("LED panel", base, s_size) {}
+
+    uint32_t leds() const { return m_leds; }
+    uint32_t switches() const { return m_switches; }
+    /// Sets the state of the switches. May be called from any thread.
+    void setSwitches(uint32_t switches) { m_switches = switches; }
+
+    bool read(uint32_t offset, uint32_t& value, const vsrtl::core::SparseArray& memory) const override;
+    void write(uint32_t offset, uint32_t value, unsigned bytes) override;
+    void sync(const vsrtl::core::SparseArray& memory) override;
+
+private:
+    std::atomic<uint32_t> m_leds{0};
+    std::atomic<uint32_t> m_switches{0};
+};
+
+/**
+ * @brief The FramebufferDevice class
+ * A memory backed display of width x height pixels in row-major order, one word of 0x00RRGGBB per pixel. The display
+ * is divided into tiles of s_tileSize x s_tileSize pixels, and stores mark the tiles which they write as dirty, such
+ * that views only copy and repaint the tiles which have been written since they were last updated.
+ */
+class FramebufferDevice : public MMIODevice {
+public:
+    static constexpr uint32_t s_defaultBase = 0xF0010000;
+    static constexpr unsigned s_defaultWidth = 128;
+    static constexpr unsigned s_defaultHeight = 128;
+    static constexpr unsigned s_tileSize = 16;
+
+    FramebufferDevice(uint32_t base, unsigned width, unsigned height);
+
+    unsigned width() const { return m_width; }
+    unsigned height() const { return m_height; }
+    unsigned tileColumns() const { return m_tileColumns; }
+    unsigned tileRows() const { return m_tileRows; }
+
+    /**
+     * @brief takeDirtyTiles
+     * Copies the pixels of the tiles which have been written since last taken into @p pixels, which holds width x
+     * height pixels in row-major order, as opaque 0xFFRRGGBB colors. The indices (row * tileColumns() + column) of
+     * the copied tiles are returned in @p tiles. May be called from any thread.
+     */
+    void takeDirtyTiles(uint32_t* pixels, std::vector<unsigned>& tiles);
+
+    void write(uint32_t offset, uint32_t value, unsigned bytes) override;
+    void sync(const vsrtl::core::SparseArray& memory) override;
+
+private:
+    void markDirty(unsigned pixel) {
+        const unsigned tile = (pixel / m_width / s_tileSize) * m_tileColumns + (pixel % m_width) / s_tileSize;
+        if (!m_dirty[tile]) {
+            m_dirty[tile] = true;
+            m_dirtyTiles.push_back(tile);
+        }
+    }
+
+    const unsigned m_width;
+    const unsigned m_height;
+    const unsigned m_tileColumns;
+    const unsigned m_tileRows;
+    QMutex m_pixelsMutex;
+    std::vector<uint32_t> m_pixels;
+    // Dirty flag of each tile, and the dirty tiles in the order in which they were first written
+    std::vector<bool> m_dirty;
+    std::vector<unsigned> m_dirtyTiles;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,149 @@
+#include "pipelinetrace.h"
+
+#include <QFileInfo>
+
+#include <algorithm>
+#include <iterator>
+
+#include "processors/ripesprocessor.h"
+
+namespace Ripes {
+
+namespace {
+uint64_t zigzag(int64_t delta) {
+    return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+}
+
+const char* stateName(StageInfo::State state) {
+    switch (state) {
+        case StageInfo::State::Stalled:
+            return "stalled";
+        case StageInfo::State::Flushed:
+            return "flushed";
+        default:
+            return "";
+    }
+}
+}  // namespace
+
+namespace PipelineTrace {
+Format formatOf(const QString& path) {
+    return QFileInfo(path).suffix().toLower() == "csv" ? Format::CSV : Format::Binary;
+}
+}  // namespace PipelineTrace
+
+bool PipelineTraceWriter::open(const QString& path, PipelineTrace::Format format,
+                               const vsrtl::core::RipesProcessor* proc) {
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    m_format = format;
+    m_buffer.clear();
+    m_buffer.reserve(s_bufferSize);
+    m_nextCycle = 0;
+    m_pcs.assign(proc->stageCount(), 0);
+
+    if (m_format == PipelineTrace::Format::CSV) {
+        QString header = "cycle";
+        for (unsigned stage = 0; stage < proc->stageCount(); stage++) {
+            const QString name = proc->stageName(stage);
+            header += "," + name + "," + name + " state";
+        }
+        putString(header + "\n");
+    } else {
+        m_buffer.insert(m_buffer.end(), PipelineTrace::s_magic, PipelineTrace::s_magic + 8);
+        m_buffer.push_back(PipelineTrace::s_version);
+        m_buffer.push_back(static_cast<uint8_t>(proc->stageCount()));
+        for (unsigned stage = 0; stage < proc->stageCount(); stage++) {
+            const QByteArray name = proc->stageName(stage).toUtf8().left(0xFF);
+            m_buffer.push_back(static_cast<uint8_t>(name.size()));
+            m_buffer.insert(m_buffer.end(), name.begin(), name.end());
+        }
+    }
+    return true;
+}
+
+void PipelineTraceWriter::close() {
+    if (m_file.isOpen()) {
+        flush();
+        m_file.close();
+    }
+}
+
+void PipelineTraceWriter::flush() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<qint64>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+void PipelineTraceWriter::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+        m_buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void PipelineTraceWriter::putString(const QString& string) {
+    const QByteArray bytes = string.toUtf8();
+    m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+}
+
+void PipelineTraceWriter::write(const vsrtl::core::RipesProcessor* proc) {
+    const long long cycle = proc->getCycleCount();
+    const unsigned stages = std::min<unsigned>(proc->stageCount(), m_pcs.size());
+
+    if (m_format == PipelineTrace::Format::CSV) {
+        // Rows are formatted directly into the buffer, keeping string allocations off the per-cycle path
+        char digits[24];
+        int n = 0;
+        for (unsigned long long value = static_cast<unsigned long long>(std::max(0LL, cycle)); n == 0 || value != 0;
+             value /= 10) {
+            digits[n++] = static_cast<char>('0' + value % 10);
+        }
+        m_buffer.insert(m_buffer.end(), std::make_reverse_iterator(digits + n), std::make_reverse_iterator(digits));
+        for (unsigned stage = 0; stage < stages; stage++) {
+            const StageInfo info = proc->stageInfo(stage);
+            m_buffer.push_back(',');
+            if (info.stage_valid) {
+                m_buffer.push_back('0');
+                m_buffer.push_back('x');
+                for (int shift = 28; shift >= 0; shift -= 4) {
+                    m_buffer.push_back(static_cast<uint8_t>("0123456789abcdef"[(info.pc >> shift) & 0xF]));
+                }
+            }
+            m_buffer.push_back(',');
+            for (const char* c = stateName(info.state); *c; c++) {
+                m_buffer.push_back(static_cast<uint8_t>(*c));
+            }
+        }
+        m_buffer.push_back('\n');
+    } else {
+        putVarint(zigzag(cycle - m_nextCycle));
+        for (unsigned stage = 0; stage < stages; stage++) {
+            const StageInfo info = proc->stageInfo(stage);
+            const unsigned state = static_cast<unsigned>(info.state) & 0b11;
+            uint8_t flags = static_cast<uint8_t>(state << PipelineTrace::StateShift);
+            if (info.stage_valid) {
+                flags |= PipelineTrace::Valid;
+                if (info.pc != m_pcs[stage]) {
+                    flags |= PipelineTrace::PcChanged;
+                }
+            }
+            m_buffer.push_back(flags);
+            if (flags & PipelineTrace::PcChanged) {
+                putVarint(zigzag(static_cast<int32_t>(info.pc - m_pcs[stage])));
+                m_pcs[stage] = info.pc;
+            }
+        }
+    }
+    m_nextCycle = cycle + 1;
+
+    if (m_buffer.size() >= s_bufferSize) {
+        flush();
+    }
+}
+
+}  // namespace Ripes
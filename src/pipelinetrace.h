@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+class RipesProcessor;
+}
+}  // namespace vsrtl
+
+namespace Ripes {
+
+/**
+ * Pipeline trace file formats
+ * A pipeline trace records the stage information (see StageInfo) of every stage of a processor, for each cycle which
+ * the processor is clocked or reversed into. Cycles are recorded in the order in which they were simulated, such that a
+ * cycle which was reversed past and re-simulated appears more than once; the last record of a cycle is authoritative.
+ *
+ * CSV: A header row of "cycle" followed by "<stage>,<stage> state" for each stage, and a row per record. The PC of a
+ *      stage is given in hexadecimal, and left empty if the stage holds no valid instruction. The state is empty,
+ *      "stalled" or "flushed".
+ *
+ * Binary: The 8-byte magic "RIPESPIP", a version byte, the number of stages (1 byte) and the name of each stage as a
+ *         length byte followed by its characters. Each record is then encoded as a zig-zag varint of the cycle
+ *         relative to the cycle following the previous record, followed by a byte per stage holding the flags below
+ *         and the StageInfo::State in the bits above StateShift. If PcChanged is set, a zig-zag varint delta of the PC
+ *         relative to the PC previously recorded for the stage follows the byte.
+ */
+namespace PipelineTrace {
+constexpr char s_magic[] = "RIPESPIP";
+constexpr uint8_t s_version = 1;
+enum Flags : uint8_t { Valid = 1 << 0, PcChanged = 1 << 1, StateShift = 2 };
+enum class Format { CSV, Binary };
+
+/// @returns the format of the pipeline trace file at @p path; CSV if it has a .csv extension, binary otherwise
+Format formatOf(const QString& path);
+}  // namespace PipelineTrace
+
+/**
+ * @brief The PipelineTraceWriter class
+ * Streams the stage information of a processor to a pipeline trace file, one record per cycle. Records are encoded
+ * into an in-memory buffer which is written to the file whenever it fills up, and upon closing the writer; no history
+ * of the recorded cycles is retained.
+ */
+class PipelineTraceWriter {
+public:
+    ~PipelineTraceWriter() { close(); }
+
+    /**
+     * @brief open
+     * Creates (or truncates) the trace file at @p path, and writes the file header describing the stages of @p proc.
+     * @returns false if the file could not be opened.
+     */
+    bool open(const QString& path, PipelineTrace::Format format, const vsrtl::core::RipesProcessor* proc);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /// Records the stage information of @p proc in its current cycle
+    void write(const vsrtl::core::RipesProcessor* proc);
+
+private:
+    void flush();
+    void putVarint(uint64_t value);
+    void putString(const QString& string);
+
+    static constexpr unsigned s_bufferSize = 1 << 16;
+
+    QFile m_file;
+    PipelineTrace::Format m_format = PipelineTrace::Format::Binary;
+    std::vector<uint8_t> m_buffer;
+    long long m_nextCycle = 0;
+    std::vector<uint32_t> m_pcs;
+};
+
+}  // namespace Ripes
@@ -1,15 +1,107 @@
 #include "processorhandler.h"
 
+#include "cachesim/cachesim.h"
+#include "cachesim/tlbsim.h"
+#include "hostprofiler.h"
 #include "parser.h"
+#include "peripherals.h"
 #include "processorregistry.h"
 #include "program.h"
+#include "simulationsnapshot.h"
 
+#include <QJsonArray>
 #include <QMessageBox>
 #include <QtConcurrent/QtConcurrent>
 
+#include <algorithm>
+#include <cstring>
+#include <future>
+
 namespace Ripes {
 
-ProcessorHandler::ProcessorHandler() {
+namespace {
+QByteArray readString(vsrtl::core::RipesProcessor* proc, uint32_t address) {
+    // The string is read in blocks, searching each block for the null terminator
+    static constexpr unsigned s_blockSize = 64;
+    uint8_t block[s_blockSize];
+    QByteArray string;
+    for (;; address += s_blockSize) {
+        proc->readMemRange(address, block, s_blockSize);
+        const auto* terminator = static_cast<const uint8_t*>(std::memchr(block, 0, s_blockSize));
+        const unsigned length = terminator ? static_cast<unsigned>(terminator - block) : s_blockSize;
+        string.append(reinterpret_cast<const char*>(block), static_cast<int>(length));
+        if (terminator) {
+            return string;
+        }
+    }
+}
+
+/// Processor constructed on a worker thread by ProcessorHandler::prepareProcessor, until it is selected
+QMutex s_preparedMutex;
+ProcessorID s_preparedID;
+std::future<std::unique_ptr<vsrtl::core::RipesProcessor>> s_preparedProcessor;
+
+std::unique_ptr<vsrtl::core::RipesProcessor> takePreparedProcessor(ProcessorID id) {
+    QMutexLocker lock(&s_preparedMutex);
+    if (!s_preparedProcessor.valid() || s_preparedID != id) {
+        return nullptr;
+    }
+    return s_preparedProcessor.get();
+}
+
+/// @returns a 64-bit FNV-1a hash of the entry point and sections of @p program, identifying it within snapshots
+uint64_t programFingerprint(const Program& program) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const auto mix = [&hash](const char* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ull;
+        }
+    };
+    const auto mixValue = [&mix](uint64_t value) { mix(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    mixValue(program.entryPoint);
+    for (const auto& section : program.sections) {
+        mixValue(section.address);
+        mixValue(static_cast<uint64_t>(section.data.size()));
+        mixValue(section.zeroSize);
+        mix(section.data.constData(), static_cast<size_t>(section.data.size()));
+    }
+    return hash;
+}
+}  // namespace
+
+void ProcessorHandler::prepareProcessor(ProcessorID id) {
+    QMutexLocker lock(&s_preparedMutex);
+    s_preparedID = id;
+    s_preparedProcessor = std::async(std::launch::async, [id] {
+        auto processor = ProcessorRegistry::constructProcessor(id);
+        processor->verifyAndInitialize();
+        return processor;
+    });
+}
+
+ProcessorHandler::ProcessorHandler(QObject* parent) : QObject(parent) {
+    connect(&m_runWatcher, &QFutureWatcher<void>::finished, this, &ProcessorHandler::runWatcherFinished);
+
+    // Output buffered during a run is flushed to the log at most once per display frame
+    m_outputFlushTimer.setInterval(16);
+    connect(&m_outputFlushTimer, &QTimer::timeout, this, &ProcessorHandler::flushOutput);
+
+    addDefaultDevices();
+
+    m_profiler.setCallGraph(&m_callGraph);
+    m_callGraph.setSampler([this] {
+        return CallGraphProfiler::Sample{getCycleCount(), m_cacheMisses.load(std::memory_order_relaxed)};
+    });
+    m_profiler.setLoopProfiler(&m_loops);
+    m_profiler.setInstructionMix(&m_instructionMix);
+    m_loops.setSampler([this] {
+        LoopProfiler::Sample sample;
+        sample.cycles = getCycleCount();
+        sample.dataAccesses = m_dataCacheAccesses.load(std::memory_order_relaxed);
+        sample.dataMisses = m_dataCacheMisses.load(std::memory_order_relaxed);
+        return sample;
+    });
+
     // Contruct the default processor
     selectProcessor(m_currentID, ProcessorRegistry::getDescription(m_currentID).defaultRegisterVals);
 }
@@ -25,27 +117,47 @@ void ProcessorHandler::loadProgram(const Program* p) {
     auto& mem = m_currentProcessor->getMemory();
 
     m_program = p;
+    m_resetVersion.reset();
+    m_textStart = textSection->address;
+    m_textEnd = textSection->address + textSection->data.length();
+    m_instructionLayout = InstructionLayout(textSection->data, currentISA()->hasCompressedInstructions());
+    m_currentProcessor->setExecutableRange(m_textStart, m_textEnd);
+    m_fastEngine->setExecutableRange(m_textStart, m_textEnd);
     // Memory initializations
     mem.clearInitializationMemories();
     for (const auto& seg : p->sections) {
+        // Zero-filled bytes of the section are left unwritten, as unwritten memory reads as zero
         mem.addInitializationMemory(seg.address, seg.data.data(), seg.data.length());
     }
 
     m_currentProcessor->setPCInitialValue(p->entryPoint);
+    m_fastEngine->setPCInitialValue(p->entryPoint);
+    m_currentProcessor->textSectionLoaded(textSection->data);
 
-    const auto textStart = textSection->address;
-    const auto textEnd = textSection->address + textSection->data.length();
-
-    // Update breakpoints to stay within the loaded program range
-    std::vector<uint32_t> bpsToRemove;
-    for (const auto& bp : m_breakpoints) {
-        if ((bp < textStart) || (bp >= textEnd)) {
-            bpsToRemove.push_back(bp);
+    // Rebuild the breakpoint bitmap over the new text section, retaining the breakpoints which stay within it
+    std::vector<uint32_t> breakpoints;
+    for (unsigned i = 0; i < m_breakpoints.size(); i++) {
+        if (m_breakpoints[i]) {
+            breakpoints.push_back(m_breakpointsBase + i * 2);
         }
     }
-    for (const auto& bp : bpsToRemove) {
-        m_breakpoints.erase(bp);
+    m_breakpointsBase = m_textStart;
+    m_breakpoints.assign((m_textEnd - m_textStart + 1) / 2, false);
+    m_breakpointRegions.assign(m_breakpoints.size(), 0);
+    m_breakpointCount = 0;
+    for (const auto& bp : breakpoints) {
+        setBreakpoint(bp, true);
     }
+    for (auto it = m_breakpointConditions.begin(); it != m_breakpointConditions.end();) {
+        it = hasBreakpoint(it->first) ? std::next(it) : m_breakpointConditions.erase(it);
+    }
+    m_profiler.setTextSection(m_textStart, m_textEnd);
+    m_callGraph.setProgram(p);
+    m_loops.setProgram(p);
+    m_instructionMix.setProgram(p);
+    m_accessPatterns.setProgram(p);
+    // Symbols of the new program may change the disassembly of any instruction
+    m_disassemblyCache.assign((m_textEnd - m_textStart + 1) / 2, DisassemblyCacheEntry());
 
     emit reqProcessorReset();
 }
@@ -66,48 +178,1239 @@ const vsrtl::core::SparseArray& ProcessorHandler::getRegisters() const {
 }
 
 void ProcessorHandler::run() {
+    publishRunStatistics(m_currentProcessor.get());
+    m_bufferOutput = true;
+    m_outputFlushTimer.start();
+    m_runTimer.start();
+    m_liveStateTimer.start();
+    m_watchpointTriggered = false;
+    // Memory may have been edited since the processor was last clocked. A watched store which is pending at the next
+    // clock edge is kept, as it has not yet been performed.
+    m_watchpoints.resync(m_currentProcessor->getMemory());
     emit runStarted();
+
+    // A clocked processor hands over from its oldest instruction in flight
+    if (canFastRun() && (m_currentProcessor->getCycleCount() == 0 || handOverToFastEngine())) {
+        m_isFastRunning = true;
+        m_runWatcher.setFuture(QtConcurrent::run([=] { fastRun(); }));
+        return;
+    }
+    runDetailed();
+}
+
+void ProcessorHandler::runDetailed() {
     /** We create a cycleFunctor for running the design which will stop further running of the design when:
      * - The user has stopped running the processor (m_stopRunningFlag)
      * - the processor has finished executing
-     * - the processor has hit a breakpoint
+     * - the processor has hit a breakpoint or watchpoint
+     * VSRTL clocks the design and calls the functor after every cycle. Only the checks which must stop the processor
+     * in the exact cycle are performed every cycle; each of these returns immediately unless it may apply, such as
+     * when breakpoints or watchpoints are set. The remaining checks are performed every s_runCheckInterval cycles.
      */
+    checkRunProgress(m_currentProcessor.get());
     const auto& cycleFunctor = [=] {
-        bool stopRunning = m_stopRunningFlag;
-        ProcessorHandler::get()->checkValidExecutionRange();
-        stopRunning |=
-            ProcessorHandler::get()->checkBreakpoint() || m_currentProcessor->finished() || m_stopRunningFlag;
+        RIPES_PROFILE_SCOPE("ProcessorHandler::run functor");
+        RIPES_PROFILE_COUNT("cycles", 1);
+        checkValidExecutionRange();
+        bool stopRunning = checkBreakpoint() || checkWatchpoint() || m_currentProcessor->finished();
+        stopRunning |= checksRunTargetEachCycle() && runTargetReached(m_currentProcessor.get());
+        if (stopRunning || static_cast<unsigned long long>(getCycleCount()) >= m_nextRunCheckCycle) {
+            // The run statistics are published as of the cycle in which running stops
+            stopRunning |= checkRunProgress(m_currentProcessor.get());
+        }
+        return stopRunning;
+    };
 
-        if (stopRunning) {
+    // Start running through the VSRTL Widget interface, with the caches simulated alongside on a separate thread,
+    // unless the processor depends on the caches within each cycle
+    if (!hasMissStalls()) {
+        m_cacheAccessQueue.start();
+    }
+    if (!hasView()) {
+        // Without a widget, such as when simulating headlessly, the design is clocked on a worker thread instead
+        m_runWatcher.setFuture(QtConcurrent::run([=] {
+            // A finished processor or a reached run target is not clocked any further. Breakpoints and watchpoints
+            // are only checked once clocked, such that a run may resume from the breakpoint it stopped at.
+            if (m_currentProcessor->finished() || runTargetReached(m_currentProcessor.get())) {
+                return;
+            }
+            m_currentProcessor->clock();
+            while (!cycleFunctor()) {
+                m_currentProcessor->clock();
+            }
+        }));
+        return;
+    }
+    m_runWatcher.setFuture(m_vsrtlWidget->run([=] {
+        if (cycleFunctor()) {
             m_vsrtlWidget->stop();
         }
+    }));
+}
+
+void ProcessorHandler::runUntil(RunCondition condition, unsigned long long value) {
+    m_hasRunTarget = true;
+    m_runCondition = condition;
+    m_runTarget = value;
+    run();
+}
+
+bool ProcessorHandler::runTargetReached(const vsrtl::core::RipesProcessor* proc) const {
+    if (!m_hasRunTarget) {
+        return false;
+    }
+    switch (m_runCondition) {
+        case RunCondition::Cycle:
+            return static_cast<unsigned long long>(getCycleCount()) >= m_runTarget;
+        case RunCondition::InstructionsRetired:
+            return static_cast<unsigned long long>(getInstructionsRetired()) >= m_runTarget;
+        case RunCondition::PC:
+            return m_runTarget <= UINT32_MAX && proc->isFetching(static_cast<uint32_t>(m_runTarget));
+    }
+    return false;
+}
+
+bool ProcessorHandler::checkRunProgress(vsrtl::core::RipesProcessor* proc) {
+    publishRunStatistics(proc);
+    if (m_liveStateTimer.hasExpired(s_liveStateIntervalMs)) {
+        m_liveState.publish(*proc, getCycleCount());
+        m_liveStateTimer.start();
+    }
+    const auto cycle = static_cast<unsigned long long>(getCycleCount());
+    bool stopRunning = m_stopRunningFlag.load(std::memory_order_relaxed);
+    stopRunning |= m_runCycleLimit != 0 && cycle >= m_runCycleLimit;
+    stopRunning |= runTargetReached(proc);
+
+    m_nextRunCheckCycle = cycle + s_runCheckInterval;
+    if (m_runCycleLimit != 0) {
+        m_nextRunCheckCycle = std::min(m_nextRunCheckCycle, m_runCycleLimit);
+    }
+    if (m_hasRunTarget && m_runCondition == RunCondition::Cycle) {
+        m_nextRunCheckCycle = std::min(m_nextRunCheckCycle, m_runTarget);
+    }
+    return stopRunning;
+}
+
+bool ProcessorHandler::canFastRun() const {
+    // The interpreter does not model the stalls of the processor
+    if (!m_fastRunEnabled || !m_program || hasMissStalls() || !m_detailedObservers.empty()) {
+        return false;
+    }
+    if (inBreakpointRegion(m_currentProcessor->getPcForStage(0))) {
+        return false;
+    }
+    return m_currentProcessor->getCycleCount() == 0 || !isPipelineTracing();
+}
+
+void ProcessorHandler::setDetailedObserver(const void* observer, bool observing) {
+    if (observing) {
+        m_detailedObservers.insert(observer);
+    } else {
+        m_detailedObservers.erase(observer);
+    }
+}
+
+long long ProcessorHandler::getFastForwardedCycles() const {
+    return m_fastEngine->getCycleCount();
+}
+
+void ProcessorHandler::setMissStallCache(CacheSim* cache, bool enabled) {
+    const bool instr = cache->getType() == CacheSim::CacheType::InstrCache;
+    CacheSim*& stallCache = instr ? m_latencyModel.instrCache : m_latencyModel.dataCache;
+    if (enabled) {
+        stallCache = cache;
+    } else if (stallCache == cache) {
+        stallCache = nullptr;
+    }
+    m_currentProcessor->setMemoryLatencyModel(hasMissStalls() ? &m_latencyModel : nullptr);
+}
+
+void ProcessorHandler::setMissStallTLB(TLBSim* tlb, bool enabled) {
+    const bool instr = tlb->getType() == TLBSim::TLBType::InstrTLB;
+    TLBSim*& stallTLB = instr ? m_latencyModel.instrTLB : m_latencyModel.dataTLB;
+    if (enabled) {
+        stallTLB = tlb;
+    } else if (stallTLB == tlb) {
+        stallTLB = nullptr;
+    }
+    m_currentProcessor->setMemoryLatencyModel(hasMissStalls() ? &m_latencyModel : nullptr);
+}
+
+void ProcessorHandler::setFunctionalUnitLatencies(const vsrtl::core::FunctionalUnitLatencies& latencies) {
+    m_functionalUnitLatencies = latencies;
+    m_currentProcessor->setFunctionalUnitLatencies(latencies);
+}
+
+unsigned ProcessorHandler::CacheLatencyModel::fetchStallCycles(uint32_t address) const {
+    // Page walks precede the cache access
+    unsigned cycles = instrTLB ? instrTLB->getStallCycles(address) : 0;
+    if (instrCache) {
+        cycles += instrCache->getStallCycles(address, CacheSim::AccessType::Read);
+    }
+    return cycles;
+}
+
+unsigned ProcessorHandler::CacheLatencyModel::dataStallCycles(uint32_t address, bool write) const {
+    unsigned cycles = dataTLB ? dataTLB->getStallCycles(address) : 0;
+    if (dataCache) {
+        cycles += dataCache->getStallCycles(address, write ? CacheSim::AccessType::Write : CacheSim::AccessType::Read);
+    }
+    return cycles;
+}
+
+long long ProcessorHandler::PerformanceCounters::performanceCounter(vsrtl::core::PerformanceCounter counter) const {
+    switch (counter) {
+        case vsrtl::core::PerformanceCounter::Cycles:
+            return m_handler->getCycleCount();
+        case vsrtl::core::PerformanceCounter::InstructionsRetired:
+            return m_handler->getInstructionsRetired();
+        case vsrtl::core::PerformanceCounter::InstrCacheMisses: {
+            // The counters count all misses since the caches were reset, regardless of their warm-up
+            const auto* cache = m_handler->m_latencyModel.instrCache;
+            return cache ? static_cast<long long>(cache->getAccessTrace().back().misses) : 0;
+        }
+        case vsrtl::core::PerformanceCounter::DataCacheMisses: {
+            const auto* cache = m_handler->m_latencyModel.dataCache;
+            return cache ? static_cast<long long>(cache->getAccessTrace().back().misses) : 0;
+        }
+        default:
+            // Stalls are only modelled by the current processor
+            return m_handler->m_currentProcessor->performanceCounter(counter);
+    }
+}
+
+void ProcessorHandler::fastRun() {
+    auto* iss = m_fastEngine.get();
+    // Memory may have been modified since the interpreter last executed
+    iss->invalidateMemory();
+    iss->setWatchpoints(m_watchpoints.empty() ? nullptr : &m_watchpoints);
+    // Warm up the caches, should running continue on the current processor
+    iss->setMemoryAccessTracing(true);
+    checkRunProgress(iss);
+    while (true) {
+        stepFastEngine();
+
+        if (!isExecutableAddress(iss->nextFetchedAddress())) {
+            FinalizeReason fr;
+            fr.exitedExecutableRegion = true;
+            iss->finalize(fr);
+        }
+
+        if (iss->finished()) {
+            break;
+        }
+        if (inBreakpointRegion(iss->getPcForStage(0))) {
+            // The current processor continues towards the breakpoint, such that it triggers with a filled pipeline
+            m_resumeDetailedRun = true;
+            break;
+        }
+        if (iss->watchpointHit()) {
+            m_watchpointTriggered = true;
+            break;
+        }
+        if (checksRunTargetEachCycle() && runTargetReached(iss)) {
+            break;
+        }
+        if (static_cast<unsigned long long>(getCycleCount()) >= m_nextRunCheckCycle && checkRunProgress(iss)) {
+            break;
+        }
+    }
+    iss->setWatchpoints(nullptr);
+    iss->setMemoryAccessTracing(false);
+    publishRunStatistics(iss);
+}
+
+void ProcessorHandler::finishFastRun() {
+    if (!m_isFastRunning) {
+        return;
+    }
+    m_isFastRunning = false;
+
+    // The interpreter writes memory behind the back of the current processor
+    m_currentProcessor->memoryModified();
+    if (m_currentProcessor->getCycleCount() != 0) {
+        resumeFromFastEngine();
+        return;
+    }
+    m_currentProcessor->setProgramCounter(m_fastEngine->getPcForStage(0));
+    if (m_fastEngine->finished()) {
+        FinalizeReason fr;
+        fr.exitSyscall = true;
+        m_currentProcessor->finalize(fr);
+    }
+    m_profiler.sync(m_currentProcessor.get());
+}
+
+void ProcessorHandler::runWatcherFinished() {
+    m_cacheAccessQueue.stop();
+    if (m_resumeDetailedRun) {
+        m_resumeDetailedRun = false;
+        finishFastRun();
+        m_watchpoints.resync(m_currentProcessor->getMemory());
+        runDetailed();
+        return;
+    }
+    m_hasRunTarget = false;
+    m_runTimeMs += m_runTimer.elapsed();
+    finishFastRun();
+    syncMemoryWriteLog();
+    m_outputFlushTimer.stop();
+    m_bufferOutput = false;
+    m_liveState.clear();
+    m_liveStateNotifiedCycle = -1;
+    flushOutput();
+    emit runFinished();
+}
+
+void ProcessorHandler::processorWasReset() {
+    m_isFastRunning = false;
+    m_resumeDetailedRun = false;
+    m_runTimeMs = 0;
+    m_snapshotCycle = 0;
+    if (!m_resimulating) {
+        m_hostFiles.closeAll();
+        m_sysCallLog.clear();
+    }
+    m_fastEngine->reset();
+    m_checkpoints.clear();
+    m_checkpointInterval = m_checkpointBaseInterval;
+
+    m_currentProcessor->saveCheckpoint(m_emptyPipeline);
+    m_emptyPipeline.memory.reset();
+    m_emptyPipeline.registers.reset();
+    syncTrace();
+    syncMemoryWriteLog();
+    m_profiler.clear(m_currentProcessor.get());
+    m_callGraph.clear();
+    m_loops.clear();
+    m_instructionMix.clear();
+    m_accessPatterns.clear();
+    m_memoryActivity.clear(0, vsrtl::core::ClockedComponent::reverseStackSize());
+    syncWatchpoints();
+    m_devices.reset();
+    if (!m_bufferOutput) {
+        notifyDevicesChanged();
+    }
+    for (auto& it : m_breakpointConditions) {
+        it.second.hits = 0;
+    }
+    if (isPipelineTracing()) {
+        m_pipelineTraceWriter.write(m_currentProcessor.get());
+    }
+    m_resetVersion = stateVersion();
+}
+
+ProcessorHandler::StateVersion ProcessorHandler::stateVersion() const {
+    StateVersion version;
+    version.cycles = m_currentProcessor->getCycleCount();
+    version.fastCycles = m_fastEngine->getCycleCount();
+    version.memoryWrites = m_memoryWriteCount;
+    version.registerWrites = m_registerWrites;
+    version.deviceChanges = m_devices.changes();
+    return version;
+}
+
+bool ProcessorHandler::isInResetState() const {
+    return m_resetVersion && *m_resetVersion == stateVersion();
+}
+
+bool ProcessorHandler::handOverToFastEngine() {
+    auto* proc = m_currentProcessor.get();
+    auto* iss = m_fastEngine.get();
+
+    while (!proc->finished() && systemCallInFlight()) {
+        proc->clock();
+        checkValidExecutionRange();
+    }
+    if (proc->finished()) {
+        return false;
+    }
+
+    // Resume from the oldest instruction in flight
+    uint32_t pc = proc->getPcForStage(0);
+    for (int stage = static_cast<int>(proc->stageCount()) - 1; stage >= 0; stage--) {
+        const auto info = proc->stageInfo(stage);
+        if (info.stage_valid && info.state == StageInfo::State::None) {
+            pc = info.pc;
+            break;
+        }
+    }
+    iss->setProgramCounter(pc);
+    iss->invalidateMemory();
+    return true;
+}
+
+void ProcessorHandler::resumeFromFastEngine() {
+    auto* proc = m_currentProcessor.get();
+    auto* iss = m_fastEngine.get();
+
+    // Empty the pipeline of the current processor, and continue from where the interpreter stopped. What the processor
+    // has learned, such as the tables of its branch predictor, is carried over. Any multiplication or division in
+    // flight has completed while the interpreter ran, such that the empty scoreboard of the functional units is exact.
+    std::vector<long long> learnedState;
+    proc->saveLearnedState(learnedState);
+    m_emptyPipeline.cycle = proc->getCycleCount();
+    m_emptyPipeline.instructionsRetired = proc->getInstructionsRetired();
+    m_emptyPipeline.memoryStallCycles = proc->getMemoryStallCycles();
+    if (const auto* branchPrediction = proc->getBranchPredictionStatistics()) {
+        m_emptyPipeline.branchPrediction = *branchPrediction;
+    }
+    if (const auto* functionalUnits = proc->getFunctionalUnitStatistics()) {
+        m_emptyPipeline.functionalUnits = *functionalUnits;
+    }
+    if (const auto* hazards = proc->getHazardStatistics()) {
+        m_emptyPipeline.hazards = *hazards;
+    }
+    proc->restoreCheckpoint(m_emptyPipeline);
+    proc->restoreLearnedState(learnedState);
+    proc->setProgramCounter(iss->getPcForStage(0));
+    if (iss->finished()) {
+        FinalizeReason fr;
+        fr.exitSyscall = true;
+        proc->finalize(fr);
+    }
+    checkValidExecutionRange();
+    syncTrace();
+    syncMemoryWriteLog();
+    m_profiler.sync(proc);
+}
+
+unsigned long long ProcessorHandler::fastForward(unsigned long long instructions) {
+    stop();
+    if (!handOverToFastEngine()) {
+        return 0;
+    }
+
+    auto* iss = m_fastEngine.get();
+    unsigned long long executed = 0;
+    m_isFastRunning = true;
+    iss->setMemoryAccessTracing(true);
+    while (executed < instructions && !iss->finished()) {
+        stepFastEngine();
+        executed++;
+
+        FinalizeReason fr;
+        fr.exitedExecutableRegion = !isExecutableAddress(iss->nextFetchedAddress());
+        iss->finalize(fr);
+    }
+    iss->setMemoryAccessTracing(false);
+    m_isFastRunning = false;
+    resumeFromFastEngine();
+
+    return executed;
+}
+
+bool ProcessorHandler::startTrace(const QString& path) {
+    if (!m_traceWriter.open(path)) {
+        return false;
+    }
+    syncTrace();
+    return true;
+}
+
+bool ProcessorHandler::startPipelineTrace(const QString& path) {
+    if (!m_pipelineTraceWriter.open(path, PipelineTrace::formatOf(path), m_currentProcessor.get())) {
+        return false;
+    }
+    m_pipelineTraceWriter.write(m_currentProcessor.get());
+    return true;
+}
+
+bool ProcessorHandler::memoryWritesSince(unsigned long long& cursor, std::vector<MemoryWrite>& writes) const {
+    writes.clear();
+    const bool complete = cursor >= m_memoryWritesInvalidated && m_memoryWriteCount - cursor <= s_memoryWriteLogSize;
+    for (unsigned long long i = cursor; complete && i < m_memoryWriteCount; i++) {
+        writes.push_back(m_memoryWriteLog[i % s_memoryWriteLogSize]);
+    }
+    cursor = m_memoryWriteCount;
+    return complete;
+}
+
+bool ProcessorHandler::currentDataAccess(MemoryWrite& access, bool& write) const {
+    const auto* memory = getDataMemory();
+    if (!memory) {
+        return false;
+    }
+    switch (memory->op.uValue()) {
+        case MemOp::SB:
+        case MemOp::SH:
+        case MemOp::SW:
+            if (memory->wr_en.uValue() != 1) {
+                return false;
+            }
+            write = true;
+            break;
+        case MemOp::LB:
+        case MemOp::LBU:
+        case MemOp::LH:
+        case MemOp::LHU:
+        case MemOp::LW:
+            write = false;
+            break;
+        default:
+            return false;
+    }
+    switch (memory->op.uValue()) {
+        case MemOp::SB:
+        case MemOp::LB:
+        case MemOp::LBU:
+            access.bytes = 1;
+            break;
+        case MemOp::SH:
+        case MemOp::LH:
+        case MemOp::LHU:
+            access.bytes = 2;
+            break;
+        default:
+            access.bytes = 4;
+            break;
+    }
+    access.address = static_cast<uint32_t>(memory->addr.uValue());
+    return true;
+}
+
+void ProcessorHandler::captureMemoryWrite() {
+    bool write = false;
+    m_hasPendingMemoryWrite = currentDataAccess(m_pendingMemoryWrite, write) && write;
+    captureDeviceWrite();
+}
+
+void ProcessorHandler::addDefaultDevices() {
+    QString error;
+    bool added = m_devices.add(std::make_unique<UartDevice>(UartDevice::s_defaultBase,
+                                                            [this](const QString& output) { printOutput(output); }),
+                               error);
+    added &= m_devices.add(std::make_unique<TimerDevice>(TimerDevice::s_defaultBase, &m_performanceCounters), error);
+    added &= m_devices.add(std::make_unique<LedPanelDevice>(LedPanelDevice::s_defaultBase), error);
+    added &= m_devices.add(std::make_unique<FramebufferDevice>(FramebufferDevice::s_defaultBase,
+                                                               FramebufferDevice::s_defaultWidth,
+                                                               FramebufferDevice::s_defaultHeight),
+                           error);
+    Q_ASSERT(added && "Default devices overlap");
+    Q_UNUSED(added);
+}
+
+void ProcessorHandler::captureDeviceWrite() {
+    bool write = false;
+    // A store which the processor is stalled on has already been dispatched
+    m_hasPendingDeviceWrite = !m_devices.empty() && currentDataAccess(m_pendingDeviceWrite, write) && write &&
+                              m_devices.isDevicePage(m_pendingDeviceWrite.address) &&
+                              !m_currentProcessor->isRepeatedMemoryAccess(false);
+}
+
+void ProcessorHandler::notifyDevicesChanged() {
+    if (m_devices.takeChanged()) {
+        emit devicesChanged();
+    }
+}
+
+void ProcessorHandler::syncTrace() {
+    const auto* proc = m_currentProcessor.get();
+    m_traceInstructionsRetired = proc->getInstructionsRetired();
+    updateTraceRetiringPcs();
+    m_traceMemAccesses.clear();
+}
+
+void ProcessorHandler::updateTraceRetiringPcs() {
+    const auto* proc = m_currentProcessor.get();
+    m_traceRetiringPcs.clear();
+    for (unsigned i = 1; i <= proc->retireWidth(); i++) {
+        m_traceRetiringPcs.push_back(proc->stageInfo(proc->stageCount() - i).pc);
+    }
+}
+
+void ProcessorHandler::traceInstruction(const vsrtl::core::RipesProcessor* proc, uint32_t pc, bool hasMemAccess,
+                                        uint32_t address) {
+    TraceRecord record;
+    record.pc = pc;
+    record.instr = m_currentProcessor->getMemory().readMem(pc);
+    record.hasMemAccess = hasMemAccess;
+    record.memAddress = address;
+    switch (record.instr & 0b1111111) {
+        case instrType::LUI:
+        case instrType::AUIPC:
+        case instrType::JAL:
+        case instrType::JALR:
+        case instrType::LOAD:
+        case instrType::OP_IMM:
+        case instrType::OP:
+            record.rd = (record.instr >> 7) & 0b11111;
+            record.hasRegWrite = record.rd != 0;
+            record.rdValue = proc->getRegister(record.rd);
+            break;
+        default:
+            break;
+    }
+    m_traceWriter.write(record);
+}
+
+void ProcessorHandler::stepFastEngine() {
+    auto* iss = m_fastEngine.get();
+    if (!isTracing()) {
+        const uint32_t pc = iss->getPcForStage(0);
+        // The data memory address is computed from the base register prior to executing the instruction, given that
+        // the instruction may overwrite it
+        auto* pattern = m_accessPatterns.lookup(pc);
+        const uint32_t address = pattern ? iss->getRegister(pattern->base) + pattern->offset : 0;
+        const long long retired = iss->getInstructionsRetired();
+        iss->clock();
+        if (iss->getInstructionsRetired() != retired) {
+            m_profiler.retire(pc);
+            if (pattern) {
+                m_accessPatterns.record(*pattern, address);
+            }
+        }
+        return;
+    }
+
+    // The data memory address is computed from the source register prior to executing the instruction, given that the
+    // instruction may overwrite it.
+    const uint32_t pc = iss->getPcForStage(0);
+    const uint32_t instr = m_currentProcessor->getMemory().readMem(pc);
+    const uint32_t opcode = instr & 0b1111111;
+    const uint32_t base = iss->getRegister((instr >> 15) & 0b11111);
+    uint32_t address = 0;
+    if (opcode == instrType::LOAD) {
+        address = base + static_cast<uint32_t>(static_cast<int32_t>(instr) >> 20);
+    } else if (opcode == instrType::STORE) {
+        const uint32_t imm = static_cast<uint32_t>(static_cast<int32_t>(instr & 0xFE000000) >> 20);
+        address = base + (imm | ((instr >> 7) & 0b11111));
+    }
+
+    const long long retired = iss->getInstructionsRetired();
+    iss->clock();
+    if (iss->getInstructionsRetired() != retired) {
+        traceInstruction(iss, pc, opcode == instrType::LOAD || opcode == instrType::STORE, address);
+        m_profiler.retire(pc);
+        if (auto* pattern = m_accessPatterns.lookup(pc)) {
+            m_accessPatterns.record(*pattern, address);
+        }
+    }
+}
+
+void ProcessorHandler::traceProcessorCycle() {
+    auto* proc = m_currentProcessor.get();
+    const long long retired = proc->getInstructionsRetired();
+    const long long retiredInCycle = retired - m_traceInstructionsRetired;
+    if (retiredInCycle > 0 && retiredInCycle <= static_cast<long long>(m_traceRetiringPcs.size())) {
+        for (long long i = 0; i < retiredInCycle; i++) {
+            const uint32_t pc = m_traceRetiringPcs.at(i);
+            const uint32_t opcode = proc->getMemory().readMem(pc) & 0b1111111;
+            const bool hasMemAccess =
+                (opcode == instrType::LOAD || opcode == instrType::STORE) && !m_traceMemAccesses.empty();
+            uint32_t address = 0;
+            if (hasMemAccess) {
+                address = m_traceMemAccesses.front();
+                m_traceMemAccesses.pop_front();
+            }
+            traceInstruction(proc, pc, hasMemAccess, address);
+        }
+    } else if (retiredInCycle != 0) {
+        // The processor was reversed in between clocks
+        m_traceMemAccesses.clear();
+    }
+    m_traceInstructionsRetired = retired;
+    updateTraceRetiringPcs();
+
+    // Record the data memory access performed in this cycle, to be retired in a later cycle
+    const auto* memory = getDataMemory();
+    if (!memory) {
+        return;
+    }
+    switch (memory->op.uValue()) {
+        case MemOp::SB:
+        case MemOp::SH:
+        case MemOp::SW:
+            if (memory->wr_en.uValue() != 1) {
+                return;
+            }
+            break;
+        case MemOp::LB:
+        case MemOp::LBU:
+        case MemOp::LH:
+        case MemOp::LHU:
+        case MemOp::LW:
+            break;
+        default:
+            return;
+    }
+    m_traceMemAccesses.push_back(memory->addr.uValue());
+    // Accesses made by instructions which never retire must not accumulate
+    if (m_traceMemAccesses.size() > proc->stageCount()) {
+        m_traceMemAccesses.pop_front();
+    }
+}
+
+void ProcessorHandler::recordAccessPattern() {
+    if (m_accessPatterns.empty()) {
+        return;
+    }
+    // The data memory access of the current cycle is made by the instruction in the data access stage
+    MemoryWrite access;
+    bool write = false;
+    auto* proc = m_currentProcessor.get();
+    if (!currentDataAccess(access, write) || proc->isRepeatedMemoryAccess(false)) {
+        return;
+    }
+    if (auto* pattern = m_accessPatterns.lookup(proc->getPcForStage(proc->dataAccessStage()))) {
+        m_accessPatterns.record(*pattern, access.address);
+    }
+}
+
+bool ProcessorHandler::systemCallInFlight() const {
+    for (unsigned stage = 0; stage < m_currentProcessor->stageCount(); stage++) {
+        const auto info = m_currentProcessor->stageInfo(stage);
+        if (!info.stage_valid) {
+            continue;
+        }
+        // CSR instructions share the opcode of ECALL, and are distinguished by a non-zero funct3
+        const uint32_t instr = m_currentProcessor->getMemory().readMem(info.pc);
+        if ((instr & 0b1111111) == instrType::ECALL && ((instr >> 12) & 0b111) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ProcessorHandler::processorWasClocked() {
+    m_profiler.clock(m_currentProcessor.get());
+    if (m_hasPendingDeviceWrite) {
+        // The store has been performed upon memory at the clock edge
+        const auto& store = m_pendingDeviceWrite;
+        m_devices.write(store.address, m_currentProcessor->getMemory().readMem(store.address), store.bytes);
+    }
+    if (!m_devices.empty()) {
+        captureDeviceWrite();
+        if (!m_bufferOutput) {
+            notifyDevicesChanged();
+        }
+    }
+    if (isTracing()) {
+        traceProcessorCycle();
+    }
+    if (isPipelineTracing()) {
+        m_pipelineTraceWriter.write(m_currentProcessor.get());
+    }
+    recordAccessPattern();
+    if (!hasView()) {
+        return;
+    }
+
+    // The store performed at the clock edge was pending in the preceding cycle
+    if (m_hasPendingMemoryWrite) {
+        m_memoryWriteLog[m_memoryWriteCount++ % s_memoryWriteLogSize] = m_pendingMemoryWrite;
+    }
+    const long long cycle = m_currentProcessor->getCycleCount();
+    bool write = false;
+    const bool accessing = currentDataAccess(m_pendingMemoryWrite, write);
+    m_hasPendingMemoryWrite = accessing && write;
+    if (accessing && !m_currentProcessor->isRepeatedMemoryAccess(false)) {
+        m_memoryActivity.record(cycle, m_pendingMemoryWrite.address, write);
+    }
+
+    // Checkpoints are recorded in the order of their cycles; cycles preceding the latest checkpoint are re-simulated
+    if (cycle % m_checkpointInterval != 0 || cycle <= m_checkpoints.latest()) {
+        return;
+    }
+
+    if (m_checkpoints.size() >= s_maxCheckpoints) {
+        thinCheckpoints();
+        if (cycle % m_checkpointInterval != 0) {
+            return;
+        }
+    }
+
+    m_checkpoints.record(*m_currentProcessor);
+    const size_t budget = static_cast<size_t>(m_checkpointBudget) << 20;
+    while (m_checkpoints.bytes() > budget && m_checkpoints.size() > 1 && m_checkpointInterval < (1u << 31)) {
+        thinCheckpoints();
+    }
+}
+
+void ProcessorHandler::thinCheckpoints() {
+    m_checkpointInterval *= 2;
+    m_checkpoints.discard([this](long long cycle) { return cycle % m_checkpointInterval != 0; });
+}
+
+void ProcessorHandler::processorWasReversed() {
+    m_profiler.reverse(m_currentProcessor.get());
+    // The shadow call and loop stacks and the access patterns cannot be reversed, such that they restart from the
+    // reversed cycle
+    m_callGraph.clear();
+    m_loops.clear();
+    m_accessPatterns.clear();
+    m_memoryActivity.reverse(m_currentProcessor->getCycleCount() + 1);
+    syncMemoryWriteLog();
+    syncWatchpoints();
+    // Memory backed device registers may have been reverted
+    m_devices.sync();
+    if (!m_bufferOutput) {
+        notifyDevicesChanged();
+    }
+    if (isPipelineTracing()) {
+        m_pipelineTraceWriter.write(m_currentProcessor.get());
+    }
+}
+
+bool ProcessorHandler::isCheckpointCycle(long long cycle) const {
+    return m_checkpoints.contains(cycle) || cycle % m_checkpointInterval == 0;
+}
+
+void ProcessorHandler::setCheckpointInterval(unsigned cycles) {
+    Q_ASSERT(cycles > 0);
+    m_checkpointBaseInterval = cycles;
+    m_checkpointInterval = cycles;
+    m_checkpoints.clear();
+}
+
+void ProcessorHandler::setCheckpointBudget(unsigned megabytes) {
+    Q_ASSERT(megabytes > 0);
+    m_checkpointBudget = megabytes;
+}
+
+bool ProcessorHandler::canGotoCycle(long long cycle) const {
+    if (cycle < 0 || m_fastEngine->getCycleCount() != 0) {
+        return false;
+    }
+    if (m_snapshotCycle == 0 || cycle >= m_currentProcessor->getCycleCount()) {
+        return true;
+    }
+    // The cycles preceding a restored snapshot cannot be re-simulated, such that moving backwards requires a checkpoint
+    // as per gotoCycle(); all checkpoints have been recorded since the snapshot was restored.
+    return m_checkpoints.latestAtOrBefore(cycle - vsrtl::core::ClockedComponent::reverseStackSize()) >= 0;
+}
+
+bool ProcessorHandler::gotoCycle(long long cycle) {
+    if (!canGotoCycle(cycle)) {
+        return false;
+    }
+
+    if (cycle < m_currentProcessor->getCycleCount()) {
+        // Restore the latest checkpoint which leaves at least a full reverse stack of cycles to be re-simulated. This
+        // ensures that the reverse stacks of the design only contain state of the re-simulated cycles.
+        const long long latestRestorable = cycle - vsrtl::core::ClockedComponent::reverseStackSize();
+        const long long restoredCycle = m_checkpoints.latestAtOrBefore(latestRestorable);
+        if (restoredCycle < 0) {
+            m_resimulating = true;
+            m_currentProcessor->reset();
+            m_resimulating = false;
+        } else {
+            // Any later checkpoints are discarded, and will be recorded anew while re-simulating
+            m_checkpoints.restore(restoredCycle, *m_currentProcessor);
+            syncTrace();
+            syncMemoryWriteLog();
+            // The profile of the cycles preceding the checkpoint is not recorded in the checkpoint
+            m_profiler.clear(m_currentProcessor.get());
+            m_callGraph.clear();
+            m_loops.clear();
+            m_instructionMix.clear();
+            m_accessPatterns.clear();
+            m_memoryActivity.clear(restoredCycle, vsrtl::core::ClockedComponent::reverseStackSize());
+            emit checkpointRestored(restoredCycle);
+        }
+    }
+
+    while (m_currentProcessor->getCycleCount() < cycle && !m_currentProcessor->finished()) {
+        m_currentProcessor->clock();
+        checkValidExecutionRange();
+    }
+    syncWatchpoints();
+    m_devices.sync();
+    notifyDevicesChanged();
+
+    return m_currentProcessor->getCycleCount() == cycle;
+}
+
+long long ProcessorHandler::reverseUntil(const std::function<bool()>& hit) {
+    const long long current = m_currentProcessor->getCycleCount();
+    if (!canGotoCycle(current) || current == 0) {
+        return -1;
+    }
+
+    long long windowEnd = current;
+    long long found = -1;
+    while (found < 0 && windowEnd > 0) {
+        // Scan the cycles from the latest checkpoint preceding the window end (or the reset state)
+        const long long windowStart = std::max(m_checkpoints.latestAtOrBefore(windowEnd - 1), 0LL);
+        if (!gotoCycle(windowStart)) {
+            break;
+        }
+        while (true) {
+            if (hit()) {
+                found = m_currentProcessor->getCycleCount();
+            }
+            if (m_currentProcessor->getCycleCount() + 1 >= windowEnd || m_currentProcessor->finished()) {
+                break;
+            }
+            m_currentProcessor->clock();
+            checkValidExecutionRange();
+        }
+        windowEnd = windowStart;
+    }
+
+    gotoCycle(found < 0 ? current : found);
+    return found;
+}
+
+long long ProcessorHandler::reverseContinue() {
+    // Evaluating conditions while searching must not count as hits
+    std::map<uint32_t, long long> hits;
+    for (const auto& it : m_breakpointConditions) {
+        hits[it.first] = it.second.hits;
+    }
+    const long long cycle = reverseUntil([this] { return checkBreakpoint(); });
+    for (auto& it : m_breakpointConditions) {
+        it.second.hits = hits[it.first];
+    }
+    return cycle;
+}
+
+long long ProcessorHandler::reverseUntilRegisterChanged(unsigned reg) {
+    const uint32_t value = m_currentProcessor->getRegister(reg);
+    return reverseUntil([=] { return m_currentProcessor->getRegister(reg) != value; });
+}
+
+long long ProcessorHandler::reverseUntilMemoryChanged(uint32_t address, unsigned bytes) {
+    const auto readRange = [=] {
+        std::vector<uint8_t> value(bytes);
+        m_currentProcessor->readMemRange(address, value.data(), bytes);
+        return value;
     };
+    const auto value = readRange();
+    return reverseUntil([&] { return readRange() != value; });
+}
+
+vsrtl::core::RipesProcessor* ProcessorHandler::activeProcessor() const {
+    if (m_isFastRunning) {
+        return m_fastEngine.get();
+    }
+    return m_currentProcessor.get();
+}
+
+long long ProcessorHandler::getCycleCount() const {
+    return m_currentProcessor->getCycleCount() + m_fastEngine->getCycleCount();
+}
+
+long long ProcessorHandler::getInstructionsRetired() const {
+    return m_currentProcessor->getInstructionsRetired() + m_fastEngine->getInstructionsRetired();
+}
+
+QJsonObject ProcessorHandler::statisticsReport(const std::vector<ReportedCache>& caches, qint64 wallTimeMs) const {
+    const auto* proc = m_currentProcessor.get();
+    const long long cycles = getCycleCount();
+    const long long retired = getInstructionsRetired();
+
+    QJsonObject report;
+    report["proc"] = ProcessorRegistry::getDescription(m_currentID).name;
+    report["cycles"] = cycles;
+    report["instructions-retired"] = retired;
+    report["cpi"] = retired != 0 ? static_cast<double>(cycles) / retired : 0;
+    report["memory-stall-cycles"] = proc->getMemoryStallCycles();
+    if (const auto* branchPrediction = proc->getBranchPredictionStatistics()) {
+        QJsonObject bp;
+        bp["predictions"] = branchPrediction->predictions;
+        bp["mispredictions"] = branchPrediction->mispredictions;
+        bp["flush-cycles-saved"] = branchPrediction->flushCyclesSaved;
+        report["branch-prediction"] = bp;
+    }
+    if (const auto* functionalUnits = proc->getFunctionalUnitStatistics()) {
+        QJsonObject units;
+        units["dependency-stall-cycles"] = functionalUnits->dependencyStallCycles;
+        units["structural-stall-cycles"] = functionalUnits->structuralStallCycles;
+        report["functional-units"] = units;
+    }
+    if (const auto* hazards = proc->getHazardStatistics()) {
+        QJsonObject obj;
+        obj["load-use-stall-cycles"] = hazards->loadUseStallCycles;
+        obj["ecall-stall-cycles"] = hazards->ecallStallCycles;
+        obj["control-flow-flushes"] = hazards->controlFlowFlushes;
+        obj["forwarded-operands"] = hazards->forwardedOperands;
+        obj["empty-fetch-cycles"] = hazards->emptyFetchCycles;
+        report["hazards"] = obj;
+    }
+    for (const auto& [name, cache] : caches) {
+        QJsonObject obj;
+        obj["hits"] = static_cast<qint64>(cache->getHits());
+        obj["misses"] = static_cast<qint64>(cache->getMisses());
+        obj["writebacks"] = static_cast<qint64>(cache->getWritebacks());
+        obj["hit-rate"] = cache->getHitRate();
+        obj["amat"] = cache->getAverageAccessTime();
+        report[name] = obj;
+    }
+    if (!m_callGraph.empty()) {
+        QJsonArray functions;
+        for (const auto& function : m_callGraph.functions()) {
+            QJsonObject obj;
+            obj["name"] = function.name;
+            obj["address"] = "0x" + QString::number(function.address, 16);
+            obj["calls"] = function.calls;
+            obj["exclusive-cycles"] = function.exclusive.cycles;
+            obj["inclusive-cycles"] = function.inclusive.cycles;
+            obj["exclusive-cache-misses"] = function.exclusive.misses;
+            obj["inclusive-cache-misses"] = function.inclusive.misses;
+            functions.append(obj);
+        }
+        report["functions"] = functions;
+    }
+    if (!m_loops.empty()) {
+        QJsonArray loops;
+        for (const auto& loop : m_loops.loops()) {
+            QJsonObject obj;
+            obj["branch"] = "0x" + QString::number(loop.branch, 16);
+            obj["target"] = "0x" + QString::number(loop.target, 16);
+            obj["entries"] = loop.entries;
+            obj["trips"] = loop.trips;
+            obj["cycles"] = loop.counts.cycles;
+            obj["instructions"] = loop.counts.instructions;
+            obj["cycles-per-iteration"] = loop.cyclesPerIteration();
+            obj["cpi"] = loop.cpi();
+            obj["data-cache-accesses"] = loop.counts.dataAccesses;
+            obj["data-cache-miss-rate"] = loop.dataMissRate();
+            loops.append(obj);
+        }
+        report["loops"] = loops;
+    }
+    if (m_instructionMix.total() != 0) {
+        QJsonObject categories;
+        const auto categoryCounts = m_instructionMix.categoryCounts();
+        for (unsigned i = 0; i < categoryCounts.size(); i++) {
+            const QString name = InstructionMix::categoryName(static_cast<InstructionMix::Category>(i));
+            categories[name.toLower().replace(' ', '-')] = categoryCounts[i];
+        }
+        QJsonObject instructions;
+        const auto& counts = m_instructionMix.counts();
+        for (unsigned i = 0; i < counts.size(); i++) {
+            if (counts[i] != 0) {
+                instructions[InstructionMix::opcodeName(i)] = counts[i];
+            }
+        }
+        report["instruction-mix"] = QJsonObject({{"categories", categories}, {"instructions", instructions}});
+    }
+    report["wall-time-ms"] = wallTimeMs;
+    report["cycles-per-second"] = wallTimeMs > 0 ? cycles * 1000.0 / wallTimeMs : 0;
+    return report;
+}
+
+bool ProcessorHandler::saveSnapshot(const QString& path, const std::vector<SnapshotCache>& caches, QString& error) {
+    if (isRunning()) {
+        error = "Snapshots cannot be saved while running";
+        return false;
+    }
+    if (!m_program) {
+        error = "No program is loaded";
+        return false;
+    }
+
+    vsrtl::core::ProcessorCheckpoint checkpoint;
+    m_currentProcessor->saveCheckpoint(checkpoint);
+
+    SnapshotWriter out;
+    out.put(static_cast<uint32_t>(m_currentID));
+    out.put(programFingerprint(*m_program));
+    out.put<int64_t>(checkpoint.cycle);
+    out.put<int64_t>(checkpoint.instructionsRetired);
+    out.put<int64_t>(checkpoint.memoryStallCycles);
+    out.put<int64_t>(m_fastEngine->getCycleCount());
+    out.put<int64_t>(m_fastEngine->getInstructionsRetired());
+    const auto& bp = checkpoint.branchPrediction;
+    const auto& units = checkpoint.functionalUnits;
+    const auto& hazards = checkpoint.hazards;
+    for (const long long counter : {bp.predictions, bp.mispredictions, bp.flushCyclesSaved, units.dependencyStallCycles,
+                                    units.structuralStallCycles, hazards.loadUseStallCycles, hazards.ecallStallCycles,
+                                    hazards.controlFlowFlushes, hazards.forwardedOperands, hazards.emptyFetchCycles}) {
+        out.put<int64_t>(counter);
+    }
+    out.put(static_cast<uint32_t>(checkpoint.registerValues.size()));
+    for (const auto value : checkpoint.registerValues) {
+        out.put(static_cast<uint64_t>(value));
+    }
+    out.put(static_cast<uint32_t>(checkpoint.processorState.size()));
+    for (const auto value : checkpoint.processorState) {
+        out.put<int64_t>(value);
+    }
+    out.putPages(*checkpoint.registers);
+    out.putPages(*checkpoint.memory);
+
+    out.put(static_cast<uint32_t>(caches.size()));
+    for (const auto& [name, cache] : caches) {
+        out.putString(name);
+        cache->writeSnapshot(out);
+    }
+
+    if (!out.write(path)) {
+        error = "Could not write snapshot " + path;
+        return false;
+    }
+    return true;
+}
+
+bool ProcessorHandler::restoreSnapshot(const QString& path, const std::vector<SnapshotCache>& caches,
+                                       QString& error) {
+    if (isRunning()) {
+        error = "Snapshots cannot be restored while running";
+        return false;
+    }
+    if (!m_program) {
+        error = "No program is loaded";
+        return false;
+    }
+
+    // The snapshot is decoded in full before the simulation is modified. Pages are referenced within the snapshot.
+    SnapshotReader in;
+    if (!in.open(path, error)) {
+        return false;
+    }
+    const auto id = static_cast<ProcessorID>(in.get<uint32_t>());
+    const uint64_t fingerprint = in.get<uint64_t>();
+    if (in.ok() && id != m_currentID) {
+        error = QString("The snapshot was taken with the %1 processor")
+                    .arg(ProcessorRegistry::getAvailableProcessors().count(id)
+                             ? ProcessorRegistry::getDescription(id).name
+                             : QString("unknown"));
+        return false;
+    }
+    if (in.ok() && fingerprint != programFingerprint(*m_program)) {
+        error = "The snapshot was taken with another program";
+        return false;
+    }
+
+    vsrtl::core::ProcessorCheckpoint checkpoint;
+    checkpoint.cycle = in.get<int64_t>();
+    checkpoint.instructionsRetired = in.get<int64_t>();
+    checkpoint.memoryStallCycles = in.get<int64_t>();
+    const long long fastCycles = in.get<int64_t>();
+    const long long fastInstructions = in.get<int64_t>();
+    auto& bp = checkpoint.branchPrediction;
+    auto& units = checkpoint.functionalUnits;
+    auto& hazards = checkpoint.hazards;
+    for (long long* counter : {&bp.predictions, &bp.mispredictions, &bp.flushCyclesSaved, &units.dependencyStallCycles,
+                               &units.structuralStallCycles, &hazards.loadUseStallCycles, &hazards.ecallStallCycles,
+                               &hazards.controlFlowFlushes, &hazards.forwardedOperands, &hazards.emptyFetchCycles}) {
+        *counter = in.get<int64_t>();
+    }
+    std::vector<uint64_t> registerValues;
+    in.getVector(registerValues);
+    checkpoint.registerValues.assign(registerValues.begin(), registerValues.end());
+    std::vector<int64_t> processorState;
+    in.getVector(processorState);
+    checkpoint.processorState.assign(processorState.begin(), processorState.end());
+    std::vector<SimulationSnapshot::Page> registerPages, memoryPages;
+    in.getPages(registerPages);
+    in.getPages(memoryPages);
+    if (!in.ok() || checkpoint.cycle < 0 || fastCycles < 0) {
+        error = "The snapshot is truncated or malformed";
+        return false;
+    }
+
+    const uint32_t cacheCount = in.get<uint32_t>();
+    if (!in.ok() || cacheCount != caches.size()) {
+        error = QString("The snapshot holds the state of %1 caches, whereas %2 are simulated")
+                    .arg(in.ok() ? QString::number(cacheCount) : QString("no"))
+                    .arg(caches.size());
+        return false;
+    }
+    std::vector<std::pair<CacheSim*, CacheSim::SnapshotState>> cacheStates;
+    for (uint32_t i = 0; i < cacheCount; i++) {
+        const QString name = in.getString();
+        const auto cache = std::find_if(caches.begin(), caches.end(),
+                                        [&name](const SnapshotCache& cache) { return cache.first == name; });
+        if (cache == caches.end()) {
+            error = in.ok() ? QString("The snapshot holds the state of a cache '%1' which is not simulated").arg(name)
+                            : QString("The snapshot is truncated or malformed");
+            return false;
+        }
+        cacheStates.emplace_back(cache->second, CacheSim::SnapshotState());
+        if (!cache->second->readSnapshot(in, cacheStates.back().second, error)) {
+            error = QString("Cache '%1': %2").arg(name, error);
+            return false;
+        }
+    }
+    if (!in.atEnd()) {
+        error = "The snapshot is malformed";
+        return false;
+    }
+
+    // Memory and registers are written on top of their reset state, which they are a superset of
+    m_currentProcessor->reset();
+    SimulationSnapshot::writePages(registerPages, m_currentProcessor->getArchRegisters());
+    SimulationSnapshot::writePages(memoryPages, m_currentProcessor->getMemory());
+    m_currentProcessor->restoreCheckpoint(checkpoint);
+    m_fastEngine->setCounts(fastCycles, fastInstructions);
+    m_fastEngine->setProgramCounter(m_currentProcessor->getPcForStage(0));
+    m_snapshotCycle = checkpoint.cycle;
 
-    // Start running through the VSRTL Widget interface
-    connect(&m_runWatcher, &QFutureWatcher<void>::finished, this, &ProcessorHandler::runFinished);
-    m_runWatcher.setFuture(m_vsrtlWidget->run(cycleFunctor));
+    syncTrace();
+    syncMemoryWriteLog();
+    m_profiler.clear(m_currentProcessor.get());
+    m_callGraph.clear();
+    m_loops.clear();
+    m_instructionMix.clear();
+    m_accessPatterns.clear();
+    m_memoryActivity.clear(checkpoint.cycle, vsrtl::core::ClockedComponent::reverseStackSize());
+    syncWatchpoints();
+    m_devices.sync();
+    notifyDevicesChanged();
+    if (hasView()) {
+        // Reversing past the restored cycle is bounded by a checkpoint of it
+        m_checkpoints.record(*m_currentProcessor);
+    }
+    for (auto& [cache, state] : cacheStates) {
+        cache->restoreSnapshot(std::move(state), checkpoint.cycle);
+    }
+    if (isPipelineTracing()) {
+        m_pipelineTraceWriter.write(m_currentProcessor.get());
+    }
+    return true;
 }
 
 void ProcessorHandler::setBreakpoint(const uint32_t address, bool enabled) {
-    if (enabled && isExecutableAddress(address)) {
-        m_breakpoints.insert(address);
-    } else {
-        m_breakpoints.erase(address);
+    // Breakpoints may only be set on instructions within the text section
+    const uint32_t offset = address - m_breakpointsBase;
+    if ((offset & 0b1) != 0 || (offset >> 1) >= m_breakpoints.size()) {
+        return;
+    }
+    const unsigned index = offset >> 1;
+    if (m_breakpoints[index] != enabled) {
+        m_breakpoints[index] = enabled;
+        enabled ? m_breakpointCount++ : m_breakpointCount--;
+        const unsigned first = index > s_breakpointRegion ? index - s_breakpointRegion : 0;
+        const unsigned last = std::min<unsigned>(index + s_breakpointRegion, m_breakpoints.size() - 1);
+        for (unsigned i = first; i <= last; i++) {
+            enabled ? m_breakpointRegions[i]++ : m_breakpointRegions[i]--;
+        }
+    }
+    if (!enabled) {
+        m_breakpointConditions.erase(address);
     }
 }
 
-void ProcessorHandler::loadProcessorToWidget(vsrtl::VSRTLWidget* widget) {
-    m_vsrtlWidget = widget;
-    widget->setDesign(m_currentProcessor.get());
+bool ProcessorHandler::setBreakpointCondition(uint32_t address, const QString& expression, QString& error) {
+    if (expression.trimmed().isEmpty()) {
+        m_breakpointConditions.erase(address);
+        setBreakpoint(address, true);
+        return true;
+    }
+    BreakpointCondition condition;
+    if (!condition.compile(expression, currentISA(), error)) {
+        return false;
+    }
+    setBreakpoint(address, true);
+    if (!hasBreakpoint(address)) {
+        error = "Breakpoints may only be set on instructions within the text section";
+        return false;
+    }
+    m_breakpointConditions[address] = {std::move(condition), 0};
+    return true;
 }
 
-bool ProcessorHandler::hasBreakpoint(const uint32_t address) const {
-    return m_breakpoints.count(address);
+const BreakpointCondition* ProcessorHandler::getBreakpointCondition(uint32_t address) const {
+    const auto it = m_breakpointConditions.find(address);
+    return it == m_breakpointConditions.end() ? nullptr : &it->second.condition;
 }
 
-bool ProcessorHandler::checkBreakpoint() {
-    const auto pc = m_currentProcessor->getPcForStage(0);
-    return m_breakpoints.count(pc);
+void ProcessorHandler::loadProcessorToWidget(vsrtl::VSRTLWidget* widget) {
+    m_vsrtlWidget = widget;
+    widget->setDesign(m_currentProcessor.get());
 }
 
 void ProcessorHandler::toggleBreakpoint(const uint32_t address) {
@@ -115,17 +1418,98 @@ void ProcessorHandler::toggleBreakpoint(const uint32_t address) {
 }
 
 void ProcessorHandler::clearBreakpoints() {
-    m_breakpoints.clear();
+    m_breakpoints.assign(m_breakpoints.size(), false);
+    m_breakpointRegions.assign(m_breakpoints.size(), 0);
+    m_breakpointCount = 0;
+    m_breakpointConditions.clear();
+}
+
+bool ProcessorHandler::checkWatchpoint() {
+    if (m_watchpoints.empty()) {
+        return false;
+    }
+
+    bool triggered = false;
+    // The store presented to the data memory in the preceding cycle has been performed at the clock edge
+    if (m_hasWatchedStore) {
+        m_hasWatchedStore = false;
+        triggered |= m_watchpoints.checkChange(m_watchedStore.address, m_watchedStore.bytes, m_watchedStorePc,
+                                               m_currentProcessor->getMemory());
+    }
+
+    MemoryWrite access;
+    bool write = false;
+    if (currentDataAccess(access, write) && m_watchpoints.isWatchedPage(access.address) &&
+        !m_currentProcessor->isRepeatedMemoryAccess(false)) {
+        const uint32_t pc = m_currentProcessor->getPcForStage(m_currentProcessor->dataAccessStage());
+        triggered |= m_watchpoints.checkAccess(access.address, access.bytes, write, pc);
+        if (write && m_watchpoints.watchesChange(access.address, access.bytes)) {
+            m_hasWatchedStore = true;
+            m_watchedStore = access;
+            m_watchedStorePc = pc;
+        }
+    }
+    m_watchpointTriggered = triggered;
+    return triggered;
+}
+
+void ProcessorHandler::addWatchpoint(uint32_t address, uint32_t size, unsigned kinds) {
+    m_watchpoints.add(address, size, kinds, m_currentProcessor->getMemory());
+    m_hasWatchedStore = false;
+}
+
+void ProcessorHandler::removeWatchpoint(uint32_t address) {
+    m_watchpoints.remove(address);
+    m_hasWatchedStore = false;
+}
+
+void ProcessorHandler::clearWatchpoints() {
+    m_watchpoints.clear();
+    m_hasWatchedStore = false;
+}
+
+std::vector<vsrtl::core::RipesProcessor*> ProcessorHandler::getConstructedProcessors() {
+    std::vector<vsrtl::core::RipesProcessor*> processors = {m_currentProcessor.get()};
+    for (const auto& it : m_processorPool) {
+        processors.push_back(it.second.get());
+    }
+    return processors;
 }
 
 void ProcessorHandler::selectProcessor(const ProcessorID& id, RegisterInitialization setup) {
     m_program = nullptr;
+    m_textStart = 0;
+    m_textEnd = 0;
+    m_instructionLayout = InstructionLayout();
+    m_profiler.setTextSection(0, 0);
+    m_disassemblyCache.clear();
+    stopPipelineTrace();
+
+    // Constructed processors are kept in a pool, such that switching back to a processor only requires a reset of its
+    // design, rather than constructing and verifying it anew
+    if (m_currentProcessor) {
+        m_processorPool[m_currentID] = std::move(m_currentProcessor);
+    }
     m_currentID = id;
+    auto pooled = m_processorPool.find(m_currentID);
+    const bool reused = pooled != m_processorPool.end();
+    bool verified = reused;
 
     // Processor initializations
-    m_currentProcessor = ProcessorRegistry::constructProcessor(m_currentID);
-    m_currentProcessor->handleSysCall.Connect(this, &ProcessorHandler::handleSysCall);
-    m_currentProcessor->isExecutableAddress = [=](uint32_t address) { return isExecutableAddress(address); };
+    if (reused) {
+        m_currentProcessor = std::move(pooled->second);
+        m_processorPool.erase(pooled);
+    } else {
+        m_currentProcessor = takePreparedProcessor(m_currentID);
+        verified = m_currentProcessor != nullptr;
+        if (!verified) {
+            m_currentProcessor = ProcessorRegistry::constructProcessor(m_currentID);
+        }
+        m_currentProcessor->handleSysCall.Connect(this, &ProcessorHandler::handleSysCall);
+    }
+    m_currentProcessor->setMemoryLatencyModel(hasMissStalls() ? &m_latencyModel : nullptr);
+    m_currentProcessor->setFunctionalUnitLatencies(m_functionalUnitLatencies);
+    m_currentProcessor->setPerformanceCounterSource(&m_performanceCounters);
 
     // Register initializations
     auto& regs = m_currentProcessor->getArchRegisters();
@@ -143,100 +1527,247 @@ void ProcessorHandler::selectProcessor(const ProcessorID& id, RegisterInitializa
                                      ptrValueBytes.data(), m_currentProcessor->implementsISA()->bytes());
     }
 
-    m_currentProcessor->verifyAndInitialize();
+    // Bind the functional interpreter to the address spaces of the selected processor
+    m_isFastRunning = false;
+    m_fastEngine = std::make_unique<vsrtl::core::RVISS>(&m_currentProcessor->getMemory(), &regs);
+    m_fastEngine->setCompressedInstructions(currentISA()->hasCompressedInstructions());
+    m_fastEngine->setPerformanceCounterSource(&m_performanceCounters);
+    m_fastEngine->handleSysCall.Connect(this, &ProcessorHandler::handleSysCall);
+    m_devices.setMemory(&m_currentProcessor->getMemory());
+    m_currentProcessor->setMMIODevices(&m_devices);
+    m_fastEngine->setMMIODevices(&m_devices);
+    m_callGraph.setProgram(nullptr);
+    m_loops.setProgram(nullptr);
+    m_instructionMix.setProgram(nullptr);
+    m_accessPatterns.setProgram(nullptr);
+
+    if (verified) {
+        // Discard the state of any previous simulation, and apply the register initializations. Any program of the
+        // previous simulation is replaced once the current program is reloaded.
+        m_currentProcessor->getMemory().clearInitializationMemories();
+        m_currentProcessor->reset();
+    } else {
+        m_currentProcessor->verifyAndInitialize();
+    }
+    if (!reused) {
+        m_currentProcessor->designWasReset.Connect(this, &ProcessorHandler::processorWasReset);
+        m_currentProcessor->designWasClocked.Connect(this, &ProcessorHandler::processorWasClocked);
+        m_currentProcessor->designWasReversed.Connect(this, &ProcessorHandler::processorWasReversed);
+        // The newly constructed processor is in its reset state
+        processorWasReset();
+    }
 
     // Processor loaded. Request for the currently assembled program to be loaded into the processor
     emit reqReloadProgram();
 }
 
 int ProcessorHandler::getCurrentProgramSize() const {
-    if (m_program) {
-        const auto* textSection = m_program->getSection(TEXT_SECTION_NAME);
-        if (textSection)
-            return textSection->data.length();
+    return static_cast<int>(m_textEnd - m_textStart);
+}
+
+QString ProcessorHandler::parseInstrAt(const uint32_t addr) const {
+    if (!m_program) {
+        return QString();
+    }
+    const uint32_t word = m_currentProcessor->getMemory().readMem(addr);
+    const bool compressed = currentISA()->hasCompressedInstructions();
+    const uint32_t offset = addr - m_textStart;
+    if ((offset & 0b1) != 0 || (offset >> 1) >= m_disassemblyCache.size()) {
+        return Parser::getParser()->disassemble(*m_program, word, addr, compressed);
+    }
+    DisassemblyCacheEntry& entry = m_disassemblyCache[offset >> 1];
+    if (!entry.valid || entry.word != word) {
+        entry.text = Parser::getParser()->disassemble(*m_program, word, addr, compressed);
+        entry.word = word;
+        entry.valid = true;
     }
+    return entry.text;
+}
 
-    return 0;
+const std::array<ProcessorHandler::SysCallHandler, ProcessorHandler::s_sysCallTableSize>&
+ProcessorHandler::sysCallTable() {
+    using vsrtl::core::RipesProcessor;
+    static const auto table = [] {
+        std::array<SysCallHandler, s_sysCallTableSize> t{};
+        t[SysCall::None] = [](ProcessorHandler&, RipesProcessor*, uint32_t) {};
+        t[SysCall::PrintInt] = [](ProcessorHandler& h, RipesProcessor*, uint32_t val) {
+            h.printOutput(QString::number(static_cast<int>(val)));
+        };
+        t[SysCall::PrintFloat] = [](ProcessorHandler& h, RipesProcessor*, uint32_t val) {
+            auto* v_f = reinterpret_cast<const float*>(&val);
+            h.printOutput(QString::number(static_cast<double>(*v_f)));
+        };
+        t[SysCall::PrintStr] = [](ProcessorHandler& h, RipesProcessor* proc, uint32_t val) {
+            h.printOutput(QString::fromUtf8(readString(proc, val)));
+        };
+        t[SysCall::Read] = [](ProcessorHandler& h, RipesProcessor* proc, uint32_t val) {
+            const uint32_t buffer = proc->getRegister(11);
+            const int length = static_cast<int>(proc->getRegister(12));
+            // Files are read in blocks which are written directly into memory
+            static constexpr int s_blockSize = 4096;
+            char block[s_blockSize];
+            int total = 0;
+            while (total < length) {
+                const int requested = std::min(s_blockSize, length - total);
+                const int n = static_cast<int>(val) <= 2 ? -1 : h.m_hostFiles.read(val, block, requested);
+                if (n < 0) {
+                    total = total == 0 ? -1 : total;
+                    break;
+                }
+                proc->writeMemRange(buffer + total, reinterpret_cast<const uint8_t*>(block), n);
+                total += n;
+                if (n < requested) {
+                    break;
+                }
+            }
+            if (total > 0) {
+                // The functional interpreter caches memory pages and translated instructions
+                h.m_fastEngine->invalidateMemory(buffer, total);
+                h.invalidateMemoryWriteLog();
+            }
+            proc->setRegister(10, total);
+        };
+        t[SysCall::Write] = [](ProcessorHandler& h, RipesProcessor* proc, uint32_t val) {
+            const uint32_t buffer = proc->getRegister(11);
+            const int length = static_cast<int>(proc->getRegister(12));
+            if (length < 0) {
+                proc->setRegister(10, -1);
+                return;
+            }
+            QByteArray data(length, '\0');
+            proc->readMemRange(buffer, reinterpret_cast<uint8_t*>(data.data()), length);
+            if (val == 1 || val == 2) {
+                // Standard output and error are printed to the log
+                h.printOutput(QString::fromUtf8(data));
+                proc->setRegister(10, length);
+            } else {
+                proc->setRegister(10, h.m_hostFiles.write(val, data.constData(), length));
+            }
+        };
+        t[SysCall::LSeek] = [](ProcessorHandler& h, RipesProcessor* proc, uint32_t val) {
+            proc->setRegister(10, h.m_hostFiles.seek(val, proc->getRegister(11), proc->getRegister(12)));
+        };
+        t[SysCall::Close] = [](ProcessorHandler& h, RipesProcessor* proc, uint32_t val) {
+            proc->setRegister(10, val <= 2 ? 0 : h.m_hostFiles.close(val));
+        };
+        t[SysCall::Exit] = t[SysCall::Exit2] = [](ProcessorHandler&, RipesProcessor* proc, uint32_t) {
+            FinalizeReason fr;
+            fr.exitSyscall = true;
+            proc->finalize(fr);
+        };
+        t[SysCall::PrintChar] = [](ProcessorHandler& h, RipesProcessor*, uint32_t val) { h.printOutput(QChar(val)); };
+        t[SysCall::PrintIntHex] = [](ProcessorHandler& h, RipesProcessor*, uint32_t val) {
+            h.printOutput("0x" + QString::number(val, 16).rightJustified(h.currentISA()->bytes(), '0'));
+        };
+        t[SysCall::PrintIntBinary] = [](ProcessorHandler& h, RipesProcessor*, uint32_t val) {
+            h.printOutput("0b" + QString::number(val, 2).rightJustified(h.currentISA()->bits(), '0'));
+        };
+        t[SysCall::PrintIntUnsigned] = [](ProcessorHandler& h, RipesProcessor*, uint32_t val) {
+            h.printOutput(QString::number(static_cast<unsigned>(val)));
+        };
+        return t;
+    }();
+    return table;
 }
 
-unsigned long ProcessorHandler::getTextStart() const {
-    if (m_program) {
-        const auto* textSection = m_program->getSection(TEXT_SECTION_NAME);
-        if (textSection)
-            return textSection->address;
+void ProcessorHandler::handleSysCall() {
+    auto* proc = activeProcessor();
+    const unsigned int arg = proc->getRegister(17);
+    const auto val = proc->getRegister(10);
+    // The functional interpreter never re-executes its cycles. Exiting has no effect outside of the processor.
+    const bool recorded = proc == m_currentProcessor.get() && arg != SysCall::Exit && arg != SysCall::Exit2;
+    if (recorded && replaySysCall(proc, arg)) {
+        return;
+    }
+    performSysCall(proc, arg, val);
+    if (recorded) {
+        recordSysCall(proc, arg);
     }
+}
 
-    return 0;
+bool ProcessorHandler::replaySysCall(vsrtl::core::RipesProcessor* proc, unsigned arg) {
+    const auto it = m_sysCallLog.find(proc->getCycleCount());
+    if (it == m_sysCallLog.end()) {
+        return false;
+    }
+    if (it->second.arg != arg) {
+        // Execution has diverged from the recorded execution
+        m_sysCallLog.erase(it, m_sysCallLog.end());
+        return false;
+    }
+    const SysCallRecord& record = it->second;
+    if (!record.data.isEmpty()) {
+        proc->writeMemRange(record.address, reinterpret_cast<const uint8_t*>(record.data.constData()),
+                            record.data.size());
+        m_fastEngine->invalidateMemory(record.address, record.data.size());
+        invalidateMemoryWriteLog();
+    }
+    proc->setRegister(10, record.result);
+    return true;
 }
 
-QString ProcessorHandler::parseInstrAt(const uint32_t addr) const {
-    if (m_program) {
-        return Parser::getParser()->disassemble(*m_program, m_currentProcessor->getMemory().readMem(addr), addr);
-    } else {
-        return QString();
+void ProcessorHandler::recordSysCall(vsrtl::core::RipesProcessor* proc, unsigned arg) {
+    SysCallRecord& record = m_sysCallLog[proc->getCycleCount()];
+    record = SysCallRecord();
+    record.arg = arg;
+    record.result = proc->getRegister(10);
+    if (arg == SysCall::Read && static_cast<int>(record.result) > 0) {
+        record.address = proc->getRegister(11);
+        record.data.resize(static_cast<int>(record.result));
+        proc->readMemRange(record.address, reinterpret_cast<uint8_t*>(record.data.data()), record.data.size());
     }
 }
 
-void ProcessorHandler::handleSysCall() {
-    const unsigned int arg = m_currentProcessor->getRegister(17);
-    const auto val = m_currentProcessor->getRegister(10);
-    switch (arg) {
-        case SysCall::None:
-            return;
-        case SysCall::PrintInt: {
-            emit print(QString::number(static_cast<int>(val)));
-            return;
-        }
-        case SysCall::PrintFloat: {
-            auto* v_f = reinterpret_cast<const float*>(&val);
-            emit print(QString::number(static_cast<double>(*v_f)));
-            return;
-        }
-        case SysCall::PrintStr: {
-            QByteArray string;
-            char byte;
-            unsigned int address = val;
-            do {
-                byte = static_cast<char>(m_currentProcessor->getMemory().readMem(address++) & 0xFF);
-                string.append(byte);
-            } while (byte != '\0');
-            emit print(QString::fromUtf8(string));
-            return;
-        }
-        case SysCall::Exit2:
-        case SysCall::Exit: {
-            FinalizeReason fr;
-            fr.exitSyscall = true;
-            m_currentProcessor->finalize(fr);
-            return;
-        }
-        case SysCall::PrintChar: {
-            QString ch = QChar(val);
-            emit print(ch);
-            break;
-        }
-        case SysCall::PrintIntHex: {
-            emit print("0x" + QString::number(val, 16).rightJustified(currentISA()->bytes(), '0'));
-            return;
-        }
-        case SysCall::PrintIntBinary: {
-            emit print("0b" + QString::number(val, 2).rightJustified(currentISA()->bits(), '0'));
-            return;
-        }
-        case SysCall::PrintIntUnsigned: {
-            emit print(QString::number(static_cast<unsigned>(val)));
-            return;
-        }
-        default: {
-            QMessageBox::warning(nullptr, "Error",
-                                 "Unknown system call argument in register a0: " + QString::number(arg));
+void ProcessorHandler::performSysCall(vsrtl::core::RipesProcessor* proc, unsigned arg, uint32_t val) {
+    if (arg < s_sysCallTableSize) {
+        if (const SysCallHandler handler = sysCallTable()[arg]) {
+            handler(*this, proc, val);
             return;
         }
+    } else if (arg == SysCall::Open) {
+        const QString path = QString::fromUtf8(readString(proc, val));
+        proc->setRegister(10, m_hostFiles.open(path, proc->getRegister(11)));
+        return;
+    }
+
+    const QString err = "Unknown system call argument in register a0: " + QString::number(arg);
+    if (m_vsrtlWidget) {
+        // System calls are handled on the thread executing the processor; the warning is shown on the GUI thread
+        QMetaObject::invokeMethod(
+            this, [err] { QMessageBox::warning(nullptr, "Error", err); }, Qt::QueuedConnection);
+    } else {
+        // Not bound to the GUI; we may be executing in any thread
+        printOutput(err + "\n");
+    }
+}
+
+void ProcessorHandler::printOutput(const QString& output) {
+    if (!m_bufferOutput) {
+        emit print(output);
+        return;
+    }
+    QMutexLocker lock(&m_outputMutex);
+    m_outputBuffer.append(output);
+}
+
+void ProcessorHandler::flushOutput() {
+    QString output;
+    {
+        QMutexLocker lock(&m_outputMutex);
+        output.swap(m_outputBuffer);
+    }
+    if (!output.isEmpty()) {
+        emit print(output);
+    }
+    notifyDevicesChanged();
+    if (const auto frame = m_liveState.latest(); frame && frame->cycle != m_liveStateNotifiedCycle) {
+        m_liveStateNotifiedCycle = frame->cycle;
+        emit liveStateChanged();
     }
 }
 
 void ProcessorHandler::checkProcessorFinished() {
-    if (m_currentProcessor->finished())
+    if (m_currentProcessor->finished() || m_fastEngine->finished())
         emit exit();
 }
 
@@ -245,31 +1776,35 @@ void ProcessorHandler::stop() {
         m_stopRunningFlag = true;
     m_runWatcher.waitForFinished();
     m_stopRunningFlag = false;
-}
-
-bool ProcessorHandler::isExecutableAddress(uint32_t address) const {
-    if (m_program) {
-        if (auto* textSection = m_program->getSection(TEXT_SECTION_NAME)) {
-            const auto textStart = textSection->address;
-            const auto textEnd = textSection->address + textSection->data.length();
-            return textStart <= address && address < textEnd;
-        }
-    }
-    return false;
+    // The finished run is not resumed on the current processor once stopped
+    m_resumeDetailedRun = false;
+    m_cacheAccessQueue.stop();
+    finishFastRun();
 }
 
 void ProcessorHandler::checkValidExecutionRange() const {
-    const auto pc = m_currentProcessor->nextFetchedAddress();
+    // Finalizing without a reason has no effect, and is skipped while the next fetch is within the executable range
+    if (isExecutableAddress(m_currentProcessor->nextFetchedAddress())) {
+        return;
+    }
     FinalizeReason fr;
-    fr.exitedExecutableRegion = !isExecutableAddress(pc);
+    fr.exitedExecutableRegion = true;
     m_currentProcessor->finalize(fr);
 }
 
 void ProcessorHandler::setRegisterValue(const unsigned idx, uint32_t value) {
+    m_registerWrites++;
+    // The system calls of the following cycles may differ from those recorded
+    m_sysCallLog.erase(m_sysCallLog.upper_bound(m_currentProcessor->getCycleCount()), m_sysCallLog.end());
     m_currentProcessor->setRegister(idx, value);
 }
 
 uint32_t ProcessorHandler::getRegisterValue(const unsigned idx) const {
     return m_currentProcessor->getRegister(idx);
 }
+
+void ProcessorHandler::getRegisterValues(std::vector<uint32_t>& values) const {
+    values.resize(currentISA()->regCnt());
+    m_currentProcessor->readRegisters(values.data(), static_cast<unsigned>(values.size()));
+}
 }  // namespace Ripes
@@ -1,25 +1,65 @@
 #pragma once
 
 #include <QFuture>
+#include <QElapsedTimer>
 #include <QFutureWatcher>
+#include <QJsonObject>
+#include <QMutex>
 #include <QObject>
+#include <QTimer>
 
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "accesspatterns.h"
+#include "breakpointcondition.h"
+#include "cachesim/cacheaccessqueue.h"
+#include "checkpointjournal.h"
+#include "cycleprofiler.h"
+#include "executiontrace.h"
+#include "hostfiles.h"
+#include "livestate.h"
+#include "memoryactivity.h"
+#include "mmiodevices.h"
+#include "parser.h"
+#include "pipelinetrace.h"
 #include "processorregistry.h"
+#include "processors/RISC-V/rviss/rviss.h"
 #include "program.h"
+#include "snapshot.h"
+#include "watchpoints.h"
 
 #include "vsrtl_widget.h"
 
 namespace Ripes {
 
+class CacheSim;
+class TLBSim;
+
 /**
  * @brief The ProcessorHandler class
  * Manages construction and destruction of a VSRTL processor design, when selecting between processors.
  * Manages all interaction and control of the current processor.
+ * A ProcessorHandler is a self-contained simulation context; it owns its processor, program, breakpoints and
+ * checkpoints, and any number of handlers may simulate independently of each other, in separate threads. The GUI is
+ * bound to the handler returned by ProcessorHandler::get().
  */
 class ProcessorHandler : public QObject {
     Q_OBJECT
 
 public:
+    explicit ProcessorHandler(QObject* parent = nullptr);
+
+    /**
+     * @brief get
+     * @returns the simulation context which the GUI is bound to.
+     */
     static ProcessorHandler* get() {
         static auto* handler = new ProcessorHandler;
         return handler;
@@ -27,6 +67,14 @@ public:
 
     vsrtl::core::RipesProcessor* getProcessorNonConst() { return m_currentProcessor.get(); }
     const vsrtl::core::RipesProcessor* getProcessor() { return m_currentProcessor.get(); }
+    /// @returns the current processor, followed by all processors kept in the processor pool
+    std::vector<vsrtl::core::RipesProcessor*> getConstructedProcessors();
+    /**
+     * @brief getFastEngine
+     * @returns the functional interpreter bound to the address spaces of the current processor. The interpreter is
+     * reconstructed whenever a processor is selected.
+     */
+    vsrtl::core::RVISS* getFastEngine() { return m_fastEngine.get(); }
     const ProcessorID& getID() const { return m_currentID; }
     const Program* getProgram() const { return m_program; }
     const ISAInfoBase* currentISA() const { return m_currentProcessor->implementsISA(); }
@@ -38,13 +86,39 @@ public:
      */
     void loadProcessorToWidget(vsrtl::VSRTLWidget* widget);
 
+    /**
+     * @brief hasView
+     * @returns true if a VSRTL widget has been bound to this context. Without a view, nothing will inspect or rewind
+     * the simulation, and per-cycle bookkeeping which only serves that purpose (checkpoints, cache undo traces) is
+     * skipped.
+     */
+    bool hasView() const { return m_vsrtlWidget != nullptr; }
+
+    /**
+     * @brief isInResetState
+     * @returns true if the current processor has not been clocked nor otherwise modified since it was last reset, and
+     * the loaded program has not changed since. Resetting the processor in this state would reproduce its current
+     * state, and re-initialization of memory from the program may be skipped.
+     */
+    bool isInResetState() const;
+
     /**
      * @brief selectProcessor
      * Constructs the processor identified by @param id, and performs all necessary initialization through the
-     * RipesProcessor interface.
+     * RipesProcessor interface. Processors which were previously selected are reset and reused rather than
+     * constructed anew.
      */
     void selectProcessor(const ProcessorID& id, RegisterInitialization setup = RegisterInitialization());
 
+    /**
+     * @brief prepareProcessor
+     * Starts constructing and verifying the processor identified by @param id on a worker thread. The next selection
+     * of the processor, in any context, takes over the prepared processor rather than constructing it anew. Used for
+     * constructing the default processor while the application is starting up.
+     */
+    static void prepareProcessor(ProcessorID id);
+    static constexpr ProcessorID s_defaultProcessor = ProcessorID::RV5S;
+
     /**
      * @brief checkValidExecutionRange
      * Checks whether the processor, given continued clocking, that it will execute within the currently validated
@@ -57,23 +131,33 @@ public:
      * @brief isExecutableAddress
      * @returns whether @param address is within the executable section of the currently loaded program.
      */
-    bool isExecutableAddress(uint32_t address) const;
+    bool isExecutableAddress(uint32_t address) const { return m_textStart <= address && address < m_textEnd; }
 
     /**
-     * @brief getCurrentProgramSize
-     * @return size (in bytes) of the currently loaded .text segment
+     * @brief getTextStart/getTextEnd
+     * @returns the bounds [start; end[ of the text section of the currently loaded program. Both are 0 if no program
+     * is loaded.
      */
-    int getCurrentProgramSize() const;
+    uint32_t getTextStart() const { return m_textStart; }
+    uint32_t getTextEnd() const { return m_textEnd; }
+
+    /**
+     * @brief getInstructionLayout
+     * @returns the offsets of the instructions of the text section of the currently loaded program, which are not
+     * word-spaced if the program contains compressed instructions.
+     */
+    const InstructionLayout& getInstructionLayout() const { return m_instructionLayout; }
 
     /**
-     * @brief getEntryPoint
-     * @return address of the entry point of the currently loaded program
+     * @brief getCurrentProgramSize
+     * @return size (in bytes) of the currently loaded .text segment
      */
-    unsigned long getTextStart() const;
+    int getCurrentProgramSize() const;
 
     /**
      * @brief parseInstrAt
-     * @return string representation of the instruction at @param addr
+     * @return string representation of the instruction at @param addr. Instructions within the text section are
+     * disassembled once, and re-disassembled only after they have been overwritten in memory.
      */
     QString parseInstrAt(const uint32_t address) const;
 
@@ -86,6 +170,19 @@ public:
     const vsrtl::core::RVMemory<RV_REG_WIDTH, RV_REG_WIDTH>* getDataMemory() const;
     const vsrtl::core::ROM<RV_REG_WIDTH, RV_INSTR_WIDTH>* getInstrMemory() const;
 
+    struct MemoryWrite {
+        uint32_t address;
+        unsigned bytes;
+    };
+    /**
+     * @brief memoryWritesSince
+     * Collects the data memory writes performed by clocking the current processor since @param cursor into
+     * @param writes, and advances @param cursor past them. Views start out with a cursor of 0.
+     * @returns false if memory may have been modified by other means since @param cursor (resets, reversals, system
+     * calls, runs, or more writes than are logged), in which case all of memory must be considered modified.
+     */
+    bool memoryWritesSince(unsigned long long& cursor, std::vector<MemoryWrite>& writes) const;
+
     /**
      * @brief setRegisterValue
      * Set the value of register @param idx to @param value.
@@ -98,11 +195,81 @@ public:
      */
     uint32_t getRegisterValue(const unsigned idx) const;
 
-    bool checkBreakpoint();
+    /**
+     * @brief getRegisterValues
+     * Reads the values of all registers of the current ISA into @param values, in a single pass over the register
+     * file. @param values is resized as needed, allowing callers to reuse its storage between reads.
+     */
+    void getRegisterValues(std::vector<uint32_t>& values) const;
+
+    /**
+     * @brief checkBreakpoint
+     * @returns true if a breakpoint is set at the address of any instruction fetched by the current processor in the
+     * current cycle, and its condition (if any) holds. Executed every cycle while running; returns immediately if no
+     * breakpoints are set.
+     */
+    bool checkBreakpoint() {
+        if (m_breakpointCount == 0) {
+            return false;
+        }
+        const uint32_t pc = m_currentProcessor->getPcForStage(0);
+        for (unsigned i = 0; i < m_currentProcessor->fetchWidth(); i++) {
+            if (hasBreakpoint(pc + 4 * i) && breakpointTriggers(pc + 4 * i, m_currentProcessor.get())) {
+                return true;
+            }
+        }
+        return false;
+    }
     void setBreakpoint(const uint32_t address, bool enabled);
     void toggleBreakpoint(const uint32_t address);
-    bool hasBreakpoint(const uint32_t address) const;
+    bool hasBreakpoint(const uint32_t address) const {
+        const uint32_t offset = address - m_breakpointsBase;
+        return m_breakpointCount != 0 && (offset & 0b1) == 0 && (offset >> 1) < m_breakpoints.size() &&
+               m_breakpoints[offset >> 1];
+    }
     void clearBreakpoints();
+    /**
+     * @brief inBreakpointRegion
+     * @returns true if @p address is within s_breakpointRegion halfwords of a breakpoint. Running switches from the
+     * functional interpreter to the current processor upon entering a breakpoint region, such that breakpoints
+     * trigger with the pipeline of the processor filled.
+     */
+    bool inBreakpointRegion(const uint32_t address) const {
+        const uint32_t offset = address - m_breakpointsBase;
+        return m_breakpointCount != 0 && (offset >> 1) < m_breakpointRegions.size() &&
+               m_breakpointRegions[offset >> 1] != 0;
+    }
+    static constexpr unsigned s_breakpointRegion = 128;
+
+    /**
+     * @brief setBreakpointCondition
+     * Sets a breakpoint at @p address which only triggers when @p expression holds (see BreakpointCondition), or makes
+     * the breakpoint unconditional if @p expression is empty. Hit counts restart from zero.
+     * @returns false, with a description of the error in @p error, if @p expression is invalid or no breakpoint may be
+     * set at @p address.
+     */
+    bool setBreakpointCondition(uint32_t address, const QString& expression, QString& error);
+    /// @returns the condition of the breakpoint at @p address, or nullptr if it is unconditional or not set
+    const BreakpointCondition* getBreakpointCondition(uint32_t address) const;
+
+    /**
+     * @brief checkWatchpoint
+     * @returns true if a watchpoint was triggered by the data memory access of the current processor in the current
+     * cycle, or by a change of value due to the store performed at the preceding clock edge. Executed every cycle while
+     * running; returns immediately if no watchpoints are set, and otherwise unless a watched page is accessed.
+     */
+    bool checkWatchpoint();
+    /**
+     * @brief addWatchpoint/removeWatchpoint/clearWatchpoints
+     * Data watchpoints stop run() like breakpoints do. See Watchpoints for the supported @p kinds.
+     */
+    void addWatchpoint(uint32_t address, uint32_t size, unsigned kinds);
+    void removeWatchpoint(uint32_t address);
+    void clearWatchpoints();
+    const Watchpoints& getWatchpoints() const { return m_watchpoints; }
+    /// @returns true if the last run or checkWatchpoint() stopped on a watchpoint, described by Watchpoints::lastHit().
+    bool watchpointTriggered() const { return m_watchpointTriggered; }
+
     void checkProcessorFinished();
 
     /**
@@ -113,12 +280,352 @@ public:
      */
     void run();
 
+    /**
+     * @brief The RunCondition enum
+     * Conditions upon which runUntil() stops running: the total cycle count or number of retired instructions reaching
+     * a value, or the first stage of the processor reaching a PC.
+     */
+    enum class RunCondition { Cycle, InstructionsRetired, PC };
+
+    /**
+     * @brief runUntil
+     * Asynchronously runs the current processor, as per run(), until @param condition is met for @param value.
+     */
+    void runUntil(RunCondition condition, unsigned long long value);
+
+    /**
+     * @brief runFor
+     * Asynchronously runs the current processor, as per run(), for @param cycles cycles.
+     */
+    void runFor(unsigned long long cycles) { runUntil(RunCondition::Cycle, getCycleCount() + cycles); }
+
+    /**
+     * @brief fastForward
+     * Synchronously executes up to @param instructions instructions through the functional interpreter, continuing from
+     * the current state of the current processor, with memory access tracing enabled such that cache simulators are
+     * warmed up. Instructions in flight in the current processor which have not yet been retired are re-executed by
+     * the interpreter. Afterwards, the current processor is left with an empty pipeline at the PC of the
+     * interpreter, retaining its cycle and retired instruction counts, such that detailed simulation may continue from
+     * there. The current processor may not be reversed past this point.
+     * @returns the number of instructions executed by the interpreter.
+     */
+    unsigned long long fastForward(unsigned long long instructions);
+
     /**
      * @brief stop
      * Sets the m_stopRunningFlag, and waits for any currently running asynchronous run execution to finish.
      */
     void stop();
 
+    /**
+     * @brief setFastRunEnabled
+     * If enabled, run() will execute the program through the functional RVISS interpreter whenever canFastRun() holds.
+     * Execution is handed back to the current processor once running is stopped, or once the interpreter enters a
+     * breakpoint region, from which the current processor continues running.
+     */
+    void setFastRunEnabled(bool enabled) { m_fastRunEnabled = enabled; }
+    bool isFastRunEnabled() const { return m_fastRunEnabled; }
+
+    /**
+     * @brief setDetailedObserver
+     * Registers @p observer as inspecting the cycles of the current processor while @p observing, such as a cache
+     * simulator. Running only uses the functional interpreter whilst the processor has no observers. The views of the
+     * processor itself are only refreshed once running stops, and need not be registered.
+     */
+    void setDetailedObserver(const void* observer, bool observing);
+
+    /**
+     * @brief getFastForwardedCycles
+     * @returns the number of the cycles of getCycleCount() which were executed through the functional interpreter
+     * rather than modelled by the current processor.
+     */
+    long long getFastForwardedCycles() const;
+
+    /**
+     * @brief setRunCycleLimit
+     * Stops run() once the total cycle count reaches @param cycles. 0 disables the limit.
+     */
+    void setRunCycleLimit(unsigned long long cycles) { m_runCycleLimit = cycles; }
+
+    /**
+     * @brief setFileSandbox
+     * Sets the directory which paths given to the file system calls (open, read, write, lseek, close) are resolved
+     * relative to. Simulated programs cannot open files outside of this directory. Defaults to the working directory.
+     */
+    void setFileSandbox(const QString& directory) { m_hostFiles.setSandbox(directory); }
+
+    /**
+     * @brief startTrace/stopTrace
+     * Records every instruction retired by the current processor or the functional interpreter to the execution trace
+     * file at @param path (see executiontrace.h), until stopTrace() is called. Cycles re-simulated by gotoCycle() are
+     * recorded again. Must not be called while running.
+     * @returns false if the trace file could not be created.
+     */
+    bool startTrace(const QString& path);
+    void stopTrace() { m_traceWriter.close(); }
+    bool isTracing() const { return m_traceWriter.isOpen(); }
+
+    /**
+     * @brief startPipelineTrace/stopPipelineTrace
+     * Streams the stage information of the current processor in every cycle it is reset, clocked or reversed into to
+     * the pipeline trace file at @param path (see pipelinetrace.h), until stopPipelineTrace() is called. The format is
+     * given by the extension of @param path. Cycles executed through the functional interpreter are not recorded. The
+     * trace is stopped when another processor is selected. Must not be called while running.
+     * @returns false if the trace file could not be created.
+     */
+    bool startPipelineTrace(const QString& path);
+    void stopPipelineTrace() { m_pipelineTraceWriter.close(); }
+    bool isPipelineTracing() const { return m_pipelineTraceWriter.isOpen(); }
+
+    /**
+     * @brief getProfiler
+     * @returns the profile of the instructions retired and cycles stalled by the current processor and the functional
+     * interpreter over the text section of the loaded program, since the last reset. Re-simulating cycles from a
+     * checkpoint restarts the profile from the restored cycle. Must not be accessed while running.
+     */
+    const CycleProfiler& getProfiler() const { return m_profiler; }
+
+    /**
+     * @brief getCallGraph
+     * @returns the call graph of the functions executed by the current processor and the functional interpreter since
+     * the last reset, with the cycles and first level cache misses spent within them. Reversing or re-simulating cycles
+     * from a checkpoint restarts the call graph. Must not be accessed while running.
+     */
+    const CallGraphProfiler& getCallGraph() const { return m_callGraph; }
+    /// Counts a demand miss of a first level cache simulated within this context
+    void recordCacheMiss() { m_cacheMisses.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief getLoopProfiler
+     * @returns the loops executed by the current processor and the functional interpreter since the last reset, with
+     * the cycles, instructions and data cache accesses of their iterations. Reversing or re-simulating cycles from a
+     * checkpoint restarts the loop profile. Must not be accessed while running.
+     */
+    const LoopProfiler& getLoopProfiler() const { return m_loops; }
+
+    /**
+     * @brief getInstructionMix
+     * @returns the number of instructions of each kind retired by the current processor and the functional interpreter
+     * since the last reset. Re-simulating cycles from a checkpoint restarts the counts. Must not be accessed while
+     * running.
+     */
+    const InstructionMix& getInstructionMix() const { return m_instructionMix; }
+
+    /**
+     * @brief getAccessPatterns
+     * @returns the stride and reuse patterns of the data memory accesses of each load and store instruction executed by
+     * the current processor and the functional interpreter since the last reset. Reversing or re-simulating cycles from
+     * a checkpoint restarts the analysis. Must not be accessed while running.
+     */
+    const AccessPatternAnalyzer& getAccessPatterns() const { return m_accessPatterns; }
+    /// Counts a demand access of a data cache simulated within this context
+    void recordDataCacheAccess(bool miss) {
+        m_dataCacheAccesses.fetch_add(1, std::memory_order_relaxed);
+        if (miss) {
+            m_dataCacheMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief getMemoryActivity
+     * @returns the per-page data memory access counts and working set of the current processor since the last reset,
+     * or the last checkpoint restored by gotoCycle(). Accesses made through the functional interpreter are not counted.
+     * Must not be accessed while running.
+     */
+    const MemoryActivity& getMemoryActivity() const { return m_memoryActivity; }
+
+    /**
+     * @brief getDevices
+     * @returns the memory mapped devices of the current processor and the functional interpreter; a UART, a timer, an
+     * LED/switch panel and a framebuffer, at the default addresses of each device (see peripherals.h).
+     */
+    MMIODevices& getDevices() { return m_devices; }
+
+    /**
+     * @brief getCycleCount & getInstructionsRetired
+     * @returns the total number of cycles/retired instructions, accumulated across the current processor and any
+     * functional execution performed since the last reset.
+     */
+    long long getCycleCount() const;
+    long long getInstructionsRetired() const;
+
+    /**
+     * @brief getRunTimeMs
+     * @returns the host wall-clock time spent in run() since the last reset, in milliseconds.
+     */
+    qint64 getRunTimeMs() const { return m_runTimeMs; }
+
+    /**
+     * @brief ReportedCache
+     * A cache whose statistics are included in a statistics report, under the given name.
+     */
+    using ReportedCache = std::pair<QString, const CacheSim*>;
+
+    /**
+     * @brief statisticsReport
+     * @returns a machine-readable report of the statistics of the current processor since the last reset: cycles,
+     * instructions retired, CPI, stall counters, branch prediction statistics, the hit/miss/writeback totals of
+     * @p caches, and the host wall-clock time @p wallTimeMs of the run with the simulated cycles per second derived from
+     * it. Must not be called while running.
+     */
+    QJsonObject statisticsReport(const std::vector<ReportedCache>& caches, qint64 wallTimeMs) const;
+
+    /**
+     * @brief SnapshotCache
+     * A cache whose state is included in a simulation snapshot, under the given name.
+     */
+    using SnapshotCache = std::pair<QString, CacheSim*>;
+
+    /**
+     * @brief saveSnapshot/restoreSnapshot
+     * Saves the complete state of the simulation to the snapshot file at @p path (see simulationsnapshot.h); the
+     * memory, architectural and pipeline registers, cycle and instruction counts and statistics of the current
+     * processor and the functional interpreter, and the tag stores and statistics of @p caches. Restoring a snapshot
+     * resets the processor and returns it, and @p caches, to the saved state, such that a long execution may be
+     * resumed without re-simulating it. The snapshot must have been saved with the same processor, program and cache
+     * configurations, and the same set of caches, and the cycles preceding the restored cycle cannot be reversed into.
+     * Must not be called while running.
+     * @returns false, with a description of the error in @p error, if the snapshot could not be saved or restored. The
+     * simulation is left untouched if restoring fails.
+     */
+    bool saveSnapshot(const QString& path, const std::vector<SnapshotCache>& caches, QString& error);
+    bool restoreSnapshot(const QString& path, const std::vector<SnapshotCache>& caches, QString& error);
+
+    /**
+     * @brief The RunStatistics struct
+     * Progress of the current processor, published by the simulating thread while running.
+     */
+    struct RunStatistics {
+        long long cycles = 0;
+        long long instructionsRetired = 0;
+        long long memoryStallCycles = 0;
+        uint32_t pc = 0;
+        // Cycles executed through the functional interpreter, included in cycles
+        long long fastForwardedCycles = 0;
+        // Statistics of the branch predictor of the processor, if it predicts branches
+        bool predictsBranches = false;
+        vsrtl::core::BranchPredictionStatistics branchPrediction;
+        // Stall statistics of the multi-cycle functional units of the processor, if it models these
+        bool modelsFunctionalUnits = false;
+        vsrtl::core::FunctionalUnitStatistics functionalUnits;
+        // Breakdown of the hazards and stalls of the processor, if it counts these
+        bool modelsHazards = false;
+        vsrtl::core::HazardStatistics hazards;
+    };
+
+    /**
+     * @brief getRunStatistics
+     * @returns the most recently published run statistics. Safe to call from any thread while run() is executing,
+     * contrary to getCycleCount() and getInstructionsRetired().
+     */
+    RunStatistics getRunStatistics() const { return m_runStatistics.read(); }
+
+    /**
+     * @brief gotoCycle
+     * Returns the current processor to its state in @param cycle. Moving backwards restores the nearest checkpoint
+     * preceding @param cycle (or resets the processor) and re-simulates forward from there. System calls of the
+     * re-simulated cycles are replayed rather than performed again (see replaySysCall).
+     * @returns true if the processor reached @param cycle.
+     */
+    bool gotoCycle(long long cycle);
+
+    /**
+     * @brief canGotoCycle
+     * @returns whether @param cycle is reachable through gotoCycle. This is not the case if any part of the current
+     * execution was performed by the functional interpreter, given that its cycles cannot be re-simulated by the
+     * current processor, nor for cycles which cannot be re-simulated from a checkpoint recorded since a snapshot was
+     * restored (see restoreSnapshot).
+     */
+    bool canGotoCycle(long long cycle) const;
+
+    /**
+     * @brief reverseContinue
+     * Returns the current processor to the latest preceding cycle in which a breakpoint was hit. The checkpoints
+     * preceding the current cycle are restored one at a time, from the latest, and the cycles between each checkpoint
+     * and the next are re-simulated without updating any views, recording the last cycle in which the condition held.
+     * Hit counts of conditional breakpoints are left untouched.
+     * @returns the cycle which was returned to, or -1 (leaving the processor in its current cycle) if no preceding cycle
+     * hit a breakpoint.
+     */
+    long long reverseContinue();
+    /**
+     * @brief reverseUntilRegisterChanged/reverseUntilMemoryChanged
+     * Returns the current processor to the latest preceding cycle in which register @p reg, or the @p bytes of memory
+     * at @p address, held a different value than in the current cycle; ie. the cycle before the value was last
+     * changed. Searched as in reverseContinue().
+     */
+    long long reverseUntilRegisterChanged(unsigned reg);
+    long long reverseUntilMemoryChanged(uint32_t address, unsigned bytes);
+
+    /**
+     * @brief setCheckpointInterval
+     * Sets the number of cycles between checkpoints of the current processor. Once the checkpoints exceed the memory
+     * budget (see setCheckpointBudget) or s_maxCheckpoints checkpoints have been recorded, the interval is doubled and
+     * every other checkpoint is discarded, bounding the memory used for checkpoints regardless of the length of the
+     * execution.
+     */
+    void setCheckpointInterval(unsigned cycles);
+    /**
+     * @brief setCheckpointBudget
+     * Sets the memory budget of the checkpoints of the current processor, in MiB. Checkpoints only hold the values which
+     * changed since the preceding checkpoint (see CheckpointJournal), such that the number of checkpoints, and with it
+     * the distance which is re-simulated when moving backwards, depends on the amount of state written by the program.
+     */
+    void setCheckpointBudget(unsigned megabytes);
+    unsigned getCheckpointBudget() const { return m_checkpointBudget; }
+
+    /**
+     * @brief isCheckpointCycle
+     * @returns true if a checkpoint is, or is about to be, recorded for @param cycle. Components with state outside
+     * of the processor (ie. cache simulators) may use this to record their own state alongside the processor.
+     */
+    bool isCheckpointCycle(long long cycle) const;
+    /// @returns true whilst the processor is being run asynchronously through run()
+    bool isRunning() const { return m_runWatcher.isRunning(); }
+    /**
+     * @brief liveState
+     * @returns the registers and memory of the running processor, as of the most recent publication, for views which
+     * are browsed whilst running. Published every s_liveStateIntervalMs; nullptr when not running.
+     */
+    std::shared_ptr<const LiveState::Frame> liveState() const { return m_liveState.latest(); }
+    unsigned getCheckpointInterval() const { return m_checkpointInterval; }
+
+    /**
+     * @brief getCacheAccessQueue
+     * @returns the queue through which cache simulators are decoupled from the processor whilst it is run. The queue
+     * is drained before running finishes, such that the caches are consistent with the processor once it has stopped.
+     */
+    CacheAccessQueue& getCacheAccessQueue() { return m_cacheAccessQueue; }
+
+    /**
+     * @brief setMissStallCache
+     * Stalls the current processor for the miss penalties of the instruction or data cache @param cache (see
+     * CacheSim::getStallCycles) upon accessing its instruction or data memory, as per the type of the cache, if the
+     * processor models memory stalls. @param enabled false stops stalling on the misses of @param cache. Whilst
+     * stalling on misses, the processor is not run through the functional interpreter, and the caches are simulated
+     * alongside the processor rather than decoupled from it. The processor must be reset after changing the caches.
+     */
+    void setMissStallCache(CacheSim* cache, bool enabled);
+    /**
+     * @brief setMissStallTLB
+     * Stalls the current processor for the page walks of the misses of the instruction or data TLB @param tlb, as per
+     * setMissStallCache.
+     */
+    void setMissStallTLB(TLBSim* tlb, bool enabled);
+    /// @returns true if the current processor is stalled on the misses of any cache or TLB
+    bool hasMissStalls() const {
+        return m_latencyModel.instrCache || m_latencyModel.dataCache || m_latencyModel.instrTLB ||
+               m_latencyModel.dataTLB;
+    }
+
+    /**
+     * @brief setFunctionalUnitLatencies
+     * Sets the latencies of the multiplier and divider of the current and any subsequently selected processor, if the
+     * processor models multi-cycle functional units. The processor must be reset after changing the latencies.
+     */
+    void setFunctionalUnitLatencies(const vsrtl::core::FunctionalUnitLatencies& latencies);
+    const vsrtl::core::FunctionalUnitLatencies& getFunctionalUnitLatencies() const { return m_functionalUnitLatencies; }
+
 signals:
     /**
      * @brief reqProcessorReset
@@ -154,17 +661,123 @@ signals:
     void runStarted();
     void runFinished();
 
+    /**
+     * @brief checkpointRestored
+     * Emitted when the current processor has been restored to the checkpoint recorded in @param cycle.
+     */
+    void checkpointRestored(long long cycle);
+
+    /**
+     * @brief devicesChanged
+     * Emitted when the state of any memory mapped device has changed. Whilst running, changes are batched and emitted
+     * at most once per display frame, alongside buffered output.
+     */
+    void devicesChanged();
+
+    /**
+     * @brief liveStateChanged
+     * Emitted whilst running when a new live state has been published (see liveState()), at most once per display
+     * frame.
+     */
+    void liveStateChanged();
+
 public slots:
     void loadProgram(const Program* p);
 
 private slots:
+    /**
+     * @brief handleSysCall
+     * Handles the system call identified by the a7 register of the active processor. Called once the processor has
+     * been clocked, for each ecall instruction handled in the cycle. System calls below s_sysCallTableSize are
+     * dispatched through sysCallTable().
+     */
     void handleSysCall();
+    void runWatcherFinished();
+    void flushOutput();
 
 private:
-    ProcessorHandler();
+    using SysCallHandler = void (*)(ProcessorHandler& handler, vsrtl::core::RipesProcessor* proc, uint32_t a0);
+    static constexpr unsigned s_sysCallTableSize = 128;
+    /// @returns the handlers of the system calls, indexed by SysCall value; nullptr for unknown system calls
+    static const std::array<SysCallHandler, s_sysCallTableSize>& sysCallTable();
+
+    /**
+     * @brief activeProcessor
+     * @returns the processor which is currently executing the program; the functional interpreter whilst fast-running,
+     * else the current processor.
+     */
+    vsrtl::core::RipesProcessor* activeProcessor() const;
+
+    /**
+     * @brief canFastRun
+     * @returns true if execution may be handed over to the functional interpreter; if it is enabled, nothing observes
+     * the cycles of the processor (see setDetailedObserver), and its program counter is not within a breakpoint region.
+     * A processor which has been clocked since its last reset is only handed over whilst its pipeline is not traced.
+     */
+    bool canFastRun() const;
+    void fastRun();
+    /**
+     * @brief handOverToFastEngine/resumeFromFastEngine
+     * Hands execution of a clocked processor over to the functional interpreter, which continues from the oldest
+     * instruction in flight, once any system call in flight has been performed. Afterwards, execution is resumed by
+     * the current processor, from an empty pipeline at the program counter of the interpreter, retaining its cycle and
+     * retired instruction counts, statistics and learned state (see RipesProcessor::saveLearnedState).
+     * @returns false if the processor finished before execution could be handed over.
+     */
+    bool handOverToFastEngine();
+    void resumeFromFastEngine();
+    /// Runs the current processor, rather than the functional interpreter, as per run()
+    void runDetailed();
+
+    /**
+     * @brief finishFastRun
+     * Hands the program counter and finishing state of the functional interpreter back to the current processor.
+     * Memories and registers are shared between the two models and require no transfer.
+     */
+    void finishFastRun();
+    void processorWasReset();
+    void processorWasClocked();
+    void processorWasReversed();
 
-    ProcessorID m_currentID = ProcessorID::RV5S;
+    ProcessorID m_currentID = s_defaultProcessor;
     std::unique_ptr<vsrtl::core::RipesProcessor> m_currentProcessor;
+    /// Previously selected processors, which are reset and reused if selected again
+    std::map<ProcessorID, std::unique_ptr<vsrtl::core::RipesProcessor>> m_processorPool;
+
+    /**
+     * @brief m_fastEngine
+     * Functional interpreter bound to the address spaces of m_currentProcessor.
+     */
+    std::unique_ptr<vsrtl::core::RVISS> m_fastEngine;
+    bool m_fastRunEnabled = true;
+    bool m_isFastRunning = false;
+    /// Set by the functional interpreter upon reaching a breakpoint region, from which the current processor continues
+    bool m_resumeDetailedRun = false;
+    std::set<const void*> m_detailedObservers;
+    /**
+     * @brief The StateVersion struct
+     * Counts of the events which modify the simulated state; the cycles clocked by the current processor and the
+     * functional interpreter, writes to memory other than by clocking (see invalidateMemoryWriteLog), edits of
+     * registers and changes of devices, such as received input. The state remains the reset state for as long as these
+     * are unchanged since the last reset.
+     */
+    struct StateVersion {
+        long long cycles = 0;
+        long long fastCycles = 0;
+        unsigned long long memoryWrites = 0;
+        unsigned long long registerWrites = 0;
+        unsigned long long deviceChanges = 0;
+        bool operator==(const StateVersion& other) const {
+            return cycles == other.cycles && fastCycles == other.fastCycles && memoryWrites == other.memoryWrites &&
+                   registerWrites == other.registerWrites && deviceChanges == other.deviceChanges;
+        }
+    };
+    StateVersion stateVersion() const;
+    /// Version of the state after the last reset, if the processor has been reset since a program was loaded
+    std::optional<StateVersion> m_resetVersion;
+    unsigned long long m_registerWrites = 0;
+    /// Number of cycles between the checks of a run which are not performed every cycle (see checkRunProgress)
+    static constexpr unsigned s_runCheckInterval = 1024;
 
     /**
      * @brief m_vsrtlWidget
@@ -172,10 +785,328 @@ private:
      */
     vsrtl::VSRTLWidget* m_vsrtlWidget = nullptr;
 
-    std::set<uint32_t> m_breakpoints;
+    /**
+     * @brief m_breakpoints
+     * Breakpoint bitmap over the text section of the loaded program, indexed by (address - m_breakpointsBase) / 2 such
+     * that breakpoints may be set on compressed instructions.
+     * m_breakpointCount is the number of set breakpoints, allowing breakpoint checks to return early when zero.
+     */
+    std::vector<bool> m_breakpoints;
+    uint32_t m_breakpointsBase = 0;
+    unsigned m_breakpointCount = 0;
+    /// Number of breakpoints within s_breakpointRegion halfwords of each halfword of the breakpoint bitmap
+    std::vector<uint16_t> m_breakpointRegions;
+
+    /**
+     * @brief m_breakpointConditions
+     * Compiled conditions of conditional breakpoints, and the number of times which their address has been reached
+     * since the last reset. Conditions are only looked up once the breakpoint bitmap matches, such that conditional
+     * breakpoints do not slow down running past unrelated addresses.
+     */
+    struct ConditionalBreakpoint {
+        BreakpointCondition condition;
+        long long hits = 0;
+    };
+    std::map<uint32_t, ConditionalBreakpoint> m_breakpointConditions;
+    /// @returns true if the breakpoint set at @p address triggers when reached by @p proc
+    bool breakpointTriggers(uint32_t address, const vsrtl::core::RipesProcessor* proc) {
+        if (m_breakpointConditions.empty()) {
+            return true;
+        }
+        const auto it = m_breakpointConditions.find(address);
+        if (it == m_breakpointConditions.end()) {
+            return true;
+        }
+        auto& breakpoint = it->second;
+        breakpoint.hits++;
+        return breakpoint.condition.evaluate([proc](unsigned i) { return proc->getRegister(i); }, breakpoint.hits) !=
+               0;
+    }
+
+    /**
+     * @brief m_watchpoints
+     * Data watchpoints of the current processor and the functional interpreter. m_watchedStore is a store to a watched
+     * Change range which the current processor performs at its next clock edge, after which the range is compared.
+     */
+    Watchpoints m_watchpoints;
+    bool m_hasWatchedStore = false;
+    MemoryWrite m_watchedStore;
+    uint32_t m_watchedStorePc = 0;
+    bool m_watchpointTriggered = false;
+    /// Re-reads the value of the watched Change ranges after memory has been modified outside of a running processor
+    void syncWatchpoints() {
+        m_hasWatchedStore = false;
+        m_watchpoints.resync(m_currentProcessor->getMemory());
+    }
     const Program* m_program = nullptr;
 
+    /**
+     * @brief m_textStart/m_textEnd
+     * Bounds of the text section of m_program, captured upon loading the program such that per-cycle execution range
+     * checks need not look up the section.
+     */
+    uint32_t m_textStart = 0;
+    uint32_t m_textEnd = 0;
+    InstructionLayout m_instructionLayout;
+
+    /**
+     * @brief m_disassemblyCache
+     * Disassembly of the instructions of the text section of m_program, indexed by (address - m_textStart) / 2 and
+     * populated lazily by parseInstrAt(). Each entry records the word which it was disassembled from, such that entries
+     * are invalidated by writes to the text section without the memory having to notify the cache.
+     */
+    struct DisassemblyCacheEntry {
+        bool valid = false;
+        uint32_t word = 0;
+        QString text;
+    };
+    mutable std::vector<DisassemblyCacheEntry> m_disassemblyCache;
+
     QFutureWatcher<void> m_runWatcher;
-    bool m_stopRunningFlag = false;
+    std::atomic<bool> m_stopRunningFlag = false;
+    CacheAccessQueue m_cacheAccessQueue;
+
+    /**
+     * @brief The CacheLatencyModel class
+     * Memory latency model of the current processor; the stall cycles of the caches and TLBs which the processor is
+     * stalled on the misses of.
+     */
+    class CacheLatencyModel : public vsrtl::core::MemoryLatencyModel {
+    public:
+        unsigned fetchStallCycles(uint32_t address) const override;
+        unsigned dataStallCycles(uint32_t address, bool write) const override;
+
+        CacheSim* instrCache = nullptr;
+        CacheSim* dataCache = nullptr;
+        TLBSim* instrTLB = nullptr;
+        TLBSim* dataTLB = nullptr;
+    };
+    CacheLatencyModel m_latencyModel;
+
+    /**
+     * @brief The PerformanceCounters class
+     * Performance counter source of the current processor and the functional interpreter. Cycles and instructions are
+     * counted across both models, and cache misses are those of the caches which the processor is stalled on, being the
+     * only caches which are simulated in lockstep with the processor.
+     */
+    class PerformanceCounters : public vsrtl::core::PerformanceCounterSource {
+    public:
+        explicit PerformanceCounters(const ProcessorHandler* handler) : m_handler(handler) {}
+        long long performanceCounter(vsrtl::core::PerformanceCounter counter) const override;
+
+    private:
+        const ProcessorHandler* m_handler;
+    };
+    PerformanceCounters m_performanceCounters = PerformanceCounters(this);
+    vsrtl::core::FunctionalUnitLatencies m_functionalUnitLatencies;
+
+    /**
+     * @brief printOutput
+     * Prints @param output to the log. Whilst running, output produced by the simulating thread is buffered in
+     * m_outputBuffer and flushed by flushOutput(), once per m_outputFlushTimer interval and once running finishes.
+     */
+    void printOutput(const QString& output);
+    bool m_bufferOutput = false;
+
+    /**
+     * @brief m_hostFiles
+     * Host files opened by the simulated program. All files are closed upon resetting the processor, other than when
+     * it is reset to re-simulate its cycles (see gotoCycle).
+     */
+    HostFiles m_hostFiles;
+
+    /**
+     * @brief replaySysCall/recordSysCall
+     * The results of the system calls performed by the current processor are recorded alongside their cycle.
+     * Re-executing a recorded cycle, such as when re-simulating from a checkpoint in gotoCycle() or clocking after
+     * reversing, replays the recorded result rather than performing the system call again; output is not printed
+     * again, and host files are not accessed again. Host files thereby remain in the state of the latest cycle
+     * executed.
+     * @returns true if the system call @p arg of the current cycle was replayed.
+     */
+    bool replaySysCall(vsrtl::core::RipesProcessor* proc, unsigned arg);
+    void recordSysCall(vsrtl::core::RipesProcessor* proc, unsigned arg);
+    void performSysCall(vsrtl::core::RipesProcessor* proc, unsigned arg, uint32_t val);
+    struct SysCallRecord {
+        unsigned arg = 0;
+        // Value of a0 after the system call
+        uint32_t result = 0;
+        // Data read into memory at address, if any
+        uint32_t address = 0;
+        QByteArray data;
+    };
+    std::map<long long, SysCallRecord> m_sysCallLog;
+    /// Set whilst the current processor is reset for re-simulating its cycles, which retains the system call log
+    bool m_resimulating = false;
+    QMutex m_outputMutex;
+    QString m_outputBuffer;
+    QTimer m_outputFlushTimer;
+    unsigned long long m_runCycleLimit = 0;
+
+    /**
+     * @brief runTargetReached
+     * @returns true if the target of the current runUntil() request has been reached. @param proc is the processor
+     * currently being executed.
+     */
+    bool runTargetReached(const vsrtl::core::RipesProcessor* proc) const;
+    /// @returns true if the run target must be checked every cycle; cycle targets are met by scheduling the run checks
+    bool checksRunTargetEachCycle() const { return m_hasRunTarget && m_runCondition != RunCondition::Cycle; }
+
+    /**
+     * @brief checkRunProgress
+     * Performs the checks of a run which need not be performed every cycle: publishes the run statistics of @param
+     * proc, polls m_stopRunningFlag, and checks the cycle limit and run target. The next check is scheduled in
+     * m_nextRunCheckCycle, no later than the cycle in which the cycle limit or a cycle target is reached. Publishes the
+     * live state of @param proc once s_liveStateIntervalMs has passed since the last publication.
+     * @returns true if running should stop.
+     */
+    bool checkRunProgress(vsrtl::core::RipesProcessor* proc);
+    unsigned long long m_nextRunCheckCycle = 0;
+
+    /// Registers and memory of the running processor, published by checkRunProgress every s_liveStateIntervalMs
+    LiveState m_liveState;
+    QElapsedTimer m_liveStateTimer;
+    long long m_liveStateNotifiedCycle = -1;
+    static constexpr unsigned s_liveStateIntervalMs = 100;
+
+    /**
+     * @brief publishRunStatistics
+     * Publishes the progress of @param proc, the processor currently being executed, to m_runStatistics.
+     */
+    void publishRunStatistics(const vsrtl::core::RipesProcessor* proc) {
+        RunStatistics stats{getCycleCount(), getInstructionsRetired(), m_currentProcessor->getMemoryStallCycles(),
+                            proc->getPcForStage(0)};
+        stats.fastForwardedCycles = getFastForwardedCycles();
+        if (const auto* branchPrediction = m_currentProcessor->getBranchPredictionStatistics()) {
+            stats.predictsBranches = true;
+            stats.branchPrediction = *branchPrediction;
+        }
+        if (const auto* functionalUnits = m_currentProcessor->getFunctionalUnitStatistics()) {
+            stats.modelsFunctionalUnits = true;
+            stats.functionalUnits = *functionalUnits;
+        }
+        if (const auto* hazards = m_currentProcessor->getHazardStatistics()) {
+            stats.modelsHazards = true;
+            stats.hazards = *hazards;
+        }
+        m_runStatistics.publish(stats);
+    }
+    Snapshot<RunStatistics> m_runStatistics;
+
+    // Host time spent in run() since the last reset, and the timer of the current run
+    QElapsedTimer m_runTimer;
+    qint64 m_runTimeMs = 0;
+
+    /**
+     * @brief stepFastEngine
+     * Executes a single instruction through the functional interpreter, recording it to the execution trace if
+     * tracing.
+     */
+    void stepFastEngine();
+
+    /**
+     * @brief traceProcessorCycle
+     * Records the instructions retired by the current processor in the cycle which was just clocked, if any. The
+     * retired instructions are those which occupied the retiring stages prior to the clock, oldest first, and the data
+     * memory address of each is the oldest address accessed by a yet unretired instruction, as recorded in
+     * m_traceMemAccesses.
+     */
+    void traceProcessorCycle();
+    void traceInstruction(const vsrtl::core::RipesProcessor* proc, uint32_t pc, bool hasMemAccess, uint32_t address);
+    /// Records the data memory access which the current processor makes in the cycle just clocked into, if any
+    void recordAccessPattern();
+    /**
+     * @brief syncTrace
+     * Resynchronizes trace recording with the current processor, after its state was changed by other means than
+     * clocking (resets, checkpoint restores).
+     */
+    void syncTrace();
+    void updateTraceRetiringPcs();
+
+    /// Discards the memory write log, after memory was modified by other means than clocking the current processor
+    void invalidateMemoryWriteLog() { m_memoryWritesInvalidated = ++m_memoryWriteCount; }
+    /**
+     * @brief currentDataAccess
+     * @returns true if the current processor accesses data memory in its current cycle, in which case the access
+     * is written to @p access and @p write.
+     */
+    bool currentDataAccess(MemoryWrite& access, bool& write) const;
+    /// Records the store which the current processor performs at its next clock edge, if any, as pending
+    void captureMemoryWrite();
+    void syncMemoryWriteLog() {
+        invalidateMemoryWriteLog();
+        captureMemoryWrite();
+    }
+    static constexpr unsigned s_memoryWriteLogSize = 64;
+    std::array<MemoryWrite, s_memoryWriteLogSize> m_memoryWriteLog;
+    unsigned long long m_memoryWriteCount = 0;
+    unsigned long long m_memoryWritesInvalidated = 0;
+    bool m_hasPendingMemoryWrite = false;
+    MemoryWrite m_pendingMemoryWrite;
+
+    /**
+     * @brief m_devices
+     * Memory mapped devices. Stores of the current processor to device pages are dispatched to the devices once
+     * performed at the clock edge; m_pendingDeviceWrite is such a store which is pending at the next clock edge.
+     */
+    MMIODevices m_devices;
+    bool m_hasPendingDeviceWrite = false;
+    MemoryWrite m_pendingDeviceWrite;
+    void addDefaultDevices();
+    void captureDeviceWrite();
+    /// Emits devicesChanged if any device has changed since last notified
+    void notifyDevicesChanged();
+
+    CycleProfiler m_profiler;
+    CallGraphProfiler m_callGraph;
+    /// Demand misses of the first level caches of this context, from which the call graph attributes cache misses
+    std::atomic<long long> m_cacheMisses = 0;
+    LoopProfiler m_loops;
+    /// Demand accesses and misses of the data caches of this context, from which the loop profile is attributed
+    std::atomic<long long> m_dataCacheAccesses = 0;
+    std::atomic<long long> m_dataCacheMisses = 0;
+    InstructionMix m_instructionMix;
+    AccessPatternAnalyzer m_accessPatterns;
+    MemoryActivity m_memoryActivity;
+    ExecutionTraceWriter m_traceWriter;
+    PipelineTraceWriter m_pipelineTraceWriter;
+    /// Addresses of the instructions in the retiring stages of the current processor, oldest first
+    std::vector<uint32_t> m_traceRetiringPcs;
+    long long m_traceInstructionsRetired = 0;
+    std::deque<uint32_t> m_traceMemAccesses;
+
+    /**
+     * @brief systemCallInFlight
+     * @returns true if any valid stage of the current processor contains an ecall instruction. The side effects of such
+     * an instruction may already have been performed, so it must not be re-executed by fastForward().
+     */
+    bool systemCallInFlight() const;
+
+    /**
+     * @brief m_emptyPipeline
+     * Microarchitectural state of the current processor right after reset, used for emptying its pipeline when
+     * resuming detailed execution after fastForward().
+     */
+    vsrtl::core::ProcessorCheckpoint m_emptyPipeline;
+    bool m_hasRunTarget = false;
+    RunCondition m_runCondition = RunCondition::Cycle;
+    unsigned long long m_runTarget = 0;
+
+    /**
+     * @brief m_checkpoints
+     * Checkpoints of the current processor, indexed by the cycle in which they were recorded. The number of checkpoints
+     * is bounded to also bound the checkpoints which cache simulators record alongside them.
+     */
+    CheckpointJournal m_checkpoints;
+    static constexpr unsigned s_maxCheckpoints = 1024;
+    unsigned m_checkpointBudget = 64;
+    /// Cycle of the snapshot which the current execution was restored from, if any, or 0
+    long long m_snapshotCycle = 0;
+    /// Searches backwards from the current cycle for the latest cycle in which @p hit holds; see reverseContinue().
+    long long reverseUntil(const std::function<bool()>& hit);
+    /// Doubles the checkpoint interval, discarding the checkpoints of cycles which are no longer checkpoint cycles
+    void thinCheckpoints();
+    unsigned m_checkpointBaseInterval = 10000;
+    unsigned m_checkpointInterval = m_checkpointBaseInterval;
 };
 }  // namespace Ripes
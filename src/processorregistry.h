@@ -3,19 +3,29 @@
 #include <QMetaType>
 #include <map>
 #include <memory>
+#include <tuple>
 
 #include "isainfo.h"
 #include "processors/ripesprocessor.h"
 
 #include "processors/RISC-V/rv5s/rv5s.h"
-#include "processors/RISC-V/rv5s_no_fw_hz/rv5s_no_fw_hz.h"
-#include "processors/RISC-V/rv5s_no_hz/rv5s_no_hz.h"
+#include "processors/RISC-V/rv5s_dual/rv5s_dual.h"
 #include "processors/RISC-V/rvss/rvss.h"
 
 namespace Ripes {
 
 // =============================== Processors =================================
-enum class ProcessorID { RVSS, RV5S, RV5S_NO_HZ, RV5S_NO_FW_HZ };
+enum class ProcessorID {
+    RVSS,
+    RV5S,
+    RV5S_BTFN,
+    RV5S_BIMODAL,
+    RV5S_GSHARE,
+    RV5S_BTB,
+    RV5S_NO_HZ,
+    RV5S_NO_FW_HZ,
+    RV5S_DUAL
+};
 // ============================================================================
 
 using RegisterInitialization = std::map<unsigned, uint32_t>;
@@ -28,6 +38,7 @@ struct Layout {
      * layout. stageLabelPositions determines the position of stage labels as a relative distance based on the processor
      * models' width in the VSRTL view. Should be in the range [0;1].
      * Must contain an entry for each stage in the processor model.
+     * If file is empty, the components of the model are placed automatically.
      */
     std::vector<double> stageLabelPositions;
 };
@@ -51,11 +62,21 @@ public:
             case ProcessorID::RV5S_NO_FW_HZ:
                 return std::make_unique<vsrtl::core::RV5S_NO_FW_HZ>();
             case ProcessorID::RV5S:
-                return std::make_unique<vsrtl::core::RV5S>();
+                return std::make_unique<vsrtl::core::RV5S<>>();
+            case ProcessorID::RV5S_BTFN:
+                return std::make_unique<vsrtl::core::RV5S<>>(vsrtl::core::BranchPredictor::Type::BTFN);
+            case ProcessorID::RV5S_BIMODAL:
+                return std::make_unique<vsrtl::core::RV5S<>>(vsrtl::core::BranchPredictor::Type::Bimodal);
+            case ProcessorID::RV5S_GSHARE:
+                return std::make_unique<vsrtl::core::RV5S<>>(vsrtl::core::BranchPredictor::Type::GShare);
+            case ProcessorID::RV5S_BTB:
+                return std::make_unique<vsrtl::core::RV5S<>>(vsrtl::core::BranchPredictor::Type::BTB);
             case ProcessorID::RVSS:
                 return std::make_unique<vsrtl::core::RVSS>();
             case ProcessorID::RV5S_NO_HZ:
                 return std::make_unique<vsrtl::core::RV5S_NO_HZ>();
+            case ProcessorID::RV5S_DUAL:
+                return std::make_unique<vsrtl::core::RV5S_DUAL>();
         }
         Q_UNREACHABLE();
     }
@@ -67,9 +88,9 @@ private:
         // RISC-V single cycle
         ProcessorDescription desc;
         desc.id = ProcessorID::RVSS;
-        desc.isa = ISAInfo<ISA::RV32IM>::instance();
+        desc.isa = ISAInfo<ISA::RV32IMC>::instance();
         desc.name = "Single Cycle Processor";
-        desc.description = "A single cycle processor";
+        desc.description = "A single cycle processor. Compressed (RV32C) instructions are expanded before decoding.";
         desc.layouts = {{"Standard", ":/layouts/RISC-V/rvss/rv_ss_standard_layout.json", {0.5}},
                         {"Extended", ":/layouts/RISC-V/rvss/rv_ss_extended_layout.json", {0.5}}};
         desc.defaultRegisterVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
@@ -86,6 +107,32 @@ private:
         desc.defaultRegisterVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
         m_descriptions[desc.id] = desc;
 
+        // RISC-V 5-Stage with branch prediction. Control flow is resolved in the EX stage, as for the above processor
+        // (which predicts all branches as not taken); mispredictions flush the IF and ID stages.
+        const std::vector<std::tuple<ProcessorID, QString, QString>> predictorVariants = {
+            {ProcessorID::RV5S_BTFN, "static BTFN",
+             "static backward taken/forward not taken prediction of branches. JAL is predicted taken."},
+            {ProcessorID::RV5S_BIMODAL, "bimodal predictor",
+             "a bimodal predictor; a table of 2-bit saturating counters indexed by the PC. JAL is predicted taken."},
+            {ProcessorID::RV5S_GSHARE, "gshare predictor",
+             "a gshare predictor; a table of 2-bit saturating counters indexed by the PC XOR'ed with the global branch "
+             "history. JAL is predicted taken."},
+            {ProcessorID::RV5S_BTB, "BTB",
+             "a direct-mapped branch target buffer, predicting all control-flow instructions (including JALR) which "
+             "were last taken to their previous target."}};
+        const auto rv5sLayouts = desc.layouts;
+        for (const auto& variant : predictorVariants) {
+            desc = ProcessorDescription();
+            desc.id = std::get<0>(variant);
+            desc.isa = ISAInfo<ISA::RV32IM>::instance();
+            desc.name = "5-Stage Processor w/ " + std::get<1>(variant);
+            desc.description = "A 5-Stage in-order processor with hazard detection/elimination and forwarding, and " +
+                               std::get<2>(variant);
+            desc.layouts = rv5sLayouts;
+            desc.defaultRegisterVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
+            m_descriptions[desc.id] = desc;
+        }
+
         // RISC-V 5-stage without hazard detection
         desc = ProcessorDescription();
         desc.id = ProcessorID::RV5S_NO_HZ;
@@ -112,6 +159,20 @@ private:
                          {0.08, 0.31, 0.56, 0.76, 0.9}}};
         desc.defaultRegisterVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
         m_descriptions[desc.id] = desc;
+
+        // RISC-V dual-issue 5-stage. No layout is provided for the model; its components are placed automatically.
+        desc = ProcessorDescription();
+        desc.id = ProcessorID::RV5S_DUAL;
+        desc.isa = ISAInfo<ISA::RV32IM>::instance();
+        desc.name = "Dual-issue 5-Stage Processor";
+        desc.description =
+            "A dual-issue 5-Stage in-order processor with hazard detection/elimination and forwarding. Pairs of "
+            "independent instructions are issued to two lanes, each with its own ALU and branch unit. Data memory "
+            "accesses and ECALLs are only issued to the first lane, and a control-flow instruction may only be paired "
+            "with the instruction preceding it.";
+        desc.layouts = {{"Automatic", "", {0.04, 0.2, 0.26, 0.44, 0.5, 0.68, 0.74, 0.88, 0.94}}};
+        desc.defaultRegisterVals = {{2, 0x7ffffff0}, {3, 0x10000000}};
+        m_descriptions[desc.id] = desc;
     }
 
     static ProcessorRegistry& instance() {
@@ -8,21 +8,25 @@
 
 #include "../../ripesprocessor.h"
 
+#include <type_traits>
+
 // Functional units
 #include "../riscv.h"
 #include "../rv_alu.h"
 #include "../rv_branch.h"
+#include "../rv_branchpredictor.h"
 #include "../rv_control.h"
 #include "../rv_decode.h"
 #include "../rv_ecallchecker.h"
 #include "../rv_immediate.h"
 #include "../rv_memory.h"
+#include "../rv_muldiv.h"
 #include "../rv_registerfile.h"
 
 // Stage separating registers
-#include "../rv5s_no_fw_hz/rv5s_no_fw_hz_ifid.h"
 #include "rv5s_exmem.h"
 #include "rv5s_idex.h"
+#include "rv5s_ifid.h"
 #include "rv5s_memwb.h"
 
 // Forwarding & Hazard detection unit
@@ -33,28 +37,75 @@ namespace vsrtl {
 namespace core {
 using namespace Ripes;
 
+/**
+ * @brief The RV5S class
+ * The 5-stage RISC-V processors, with and without forwarding, hazard detection/elimination and branch prediction. The
+ * components of disabled units are omitted from the design, alongside their wiring, and all logic of the processor
+ * which concerns them is compiled out.
+ * Branches are resolved in the EX stage. With hazard detection, the instructions following a branch are fetched as
+ * predicted by the branch prediction unit (by default predicting not taken), and flushed upon mispredictions; memory
+ * and functional unit latencies stall the pipeline. Without, the IF and ID stages are flushed upon taken branches, and
+ * RAW hazards on loads (and without forwarding, any RAW hazard) are not resolved.
+ * Hazard detection requires forwarding, and branch prediction is only wired alongside hazard detection, whose flushes
+ * and stalls it relies on.
+ */
+template <bool Forwarding = true, bool HazardDetection = true, bool BranchPrediction = true>
 class RV5S : public RipesProcessor {
+    static_assert(!HazardDetection || Forwarding, "Hazard detection requires forwarding");
+    static_assert(BranchPrediction == HazardDetection, "Branch prediction is only wired alongside hazard detection");
+
+    using PcRegister = std::conditional_t<HazardDetection, RegisterClEn<RV_REG_WIDTH>, Register<RV_REG_WIDTH>>;
+    using IFIDRegister = std::conditional_t<BranchPrediction, RV5S_IFID, IFID>;
+    using IDEXRegister = std::conditional_t<Forwarding, RV5S_IDEX, IDEX>;
+    using EXMEMRegister = std::conditional_t<HazardDetection, RV5S_EXMEM, EXMEM>;
+    using MEMWBRegister = std::conditional_t<HazardDetection, RV5S_MEMWB, MEMWB>;
+    using StallCycleRegister = Register<HazardUnit::s_stallCycleBits>;
+
 public:
     enum Stage { IF = 0, ID = 1, EX = 2, MEM = 3, WB = 4, STAGECOUNT };
-    RV5S() : RipesProcessor("5-Stage RISC-V Processor") {
+    RV5S(BranchPredictor::Type predictor = BranchPredictor::Type::NotTaken) : RipesProcessor(designName()) {
         // -----------------------------------------------------------------------
         // Program counter
         pc_reg->out >> pc_4->op1;
         4 >> pc_4->op2;
-        pc_src->out >> pc_reg->in;
-        0 >> pc_reg->clear;
-        hzunit->hazardFEEnable >> pc_reg->enable;
+        if constexpr (BranchPrediction) {
+            bpunit->next_pc >> pc_reg->in;
+        } else {
+            pc_src->out >> pc_reg->in;
+        }
+        if constexpr (HazardDetection) {
+            0 >> pc_reg->clear;
+            hzunit->hazardFEEnable >> pc_reg->enable;
+        }
 
         // Note: pc_src works uses the PcSrc enum, but is selected by the boolean signal
         // from the controlflow OR gate. PcSrc enum values must adhere to the boolean
-        // 0/1 values.
+        // 0/1 values. pc_src selects the resolved address following the instruction in the EX stage.
         controlflow_or->out >> pc_src->select;
 
-        controlflow_or->out >> *efsc_or->in[0];
+        if constexpr (BranchPrediction) {
+            // -----------------------------------------------------------------------
+            // Branch prediction
+            bpunit->predictor().setType(predictor);
+            pc_reg->out >> bpunit->if_pc;
+            instr_mem->data_out >> bpunit->if_instr;
+            idex_reg->pred_pc_out >> bpunit->ex_pred_pc;
+            pc_src->out >> bpunit->ex_resolved_pc;
+
+            bpunit->mispredict >> *efsc_or->in[0];
+        } else {
+            controlflow_or->out >> *efsc_or->in[0];
+        }
         ecallChecker->syscallExit >> *efsc_or->in[1];
 
-        efsc_or->out >> *efschz_or->in[0];
-        hzunit->hazardIDEXClear >> *efschz_or->in[1];
+        if constexpr (HazardDetection) {
+            efsc_or->out >> *efschz_or->in[0];
+            hzunit->hazardIDEXClear >> *efschz_or->in[1];
+
+            // The EX stage is not flushed whilst held by a data memory stall
+            efschz_or->out >> *idex_clear_and->in[0];
+            hzunit->hazardEXMEMEnable >> *idex_clear_and->in[1];
+        }
 
         // -----------------------------------------------------------------------
         // Instruction memory
@@ -92,38 +143,55 @@ public:
         // -----------------------------------------------------------------------
         // Branch
         idex_reg->br_op_out >> branch->comp_op;
-        reg1_fw_src->out >> branch->op1;
-        reg2_fw_src->out >> branch->op2;
+        // The branch operands are only forwarded alongside hazard detection
+        if constexpr (HazardDetection) {
+            reg1_fw_src->out >> branch->op1;
+            reg2_fw_src->out >> branch->op2;
+        } else {
+            idex_reg->r1_out >> branch->op1;
+            idex_reg->r2_out >> branch->op2;
+        }
 
         branch->res >> *br_and->in[0];
         idex_reg->do_br_out >> *br_and->in[1];
         br_and->out >> *controlflow_or->in[0];
         idex_reg->do_jmp_out >> *controlflow_or->in[1];
 
-        pc_4->out >> pc_src->get(PcSrc::PC4);
+        if constexpr (BranchPrediction) {
+            idex_reg->pc4_out >> pc_src->get(PcSrc::PC4);
+        } else {
+            pc_4->out >> pc_src->get(PcSrc::PC4);
+        }
         alu->res >> pc_src->get(PcSrc::ALU);
 
         // -----------------------------------------------------------------------
         // ALU
-
-        // Forwarding multiplexers
-        idex_reg->r1_out >> reg1_fw_src->get(ForwardingSrc::IdStage);
-        exmem_reg->alures_out >>
-            reg1_fw_src->get(ForwardingSrc::MemStage);  // Todo: Mem stage needs a mux to allow for AUIPC forwarding
-        reg_wr_src->out >> reg1_fw_src->get(ForwardingSrc::WbStage);
-        funit->alu_reg1_forwarding_ctrl >> reg1_fw_src->select;
-
-        idex_reg->r2_out >> reg2_fw_src->get(ForwardingSrc::IdStage);
-        exmem_reg->alures_out >> reg2_fw_src->get(ForwardingSrc::MemStage);
-        reg_wr_src->out >> reg2_fw_src->get(ForwardingSrc::WbStage);
-        funit->alu_reg2_forwarding_ctrl >> reg2_fw_src->select;
-
-        // ALU operand multiplexers
-        reg1_fw_src->out >> alu_op1_src->get(AluSrc1::REG1);
+        if constexpr (Forwarding) {
+            // Forwarding multiplexers
+            idex_reg->r1_out >> reg1_fw_src->get(ForwardingSrc::IdStage);
+            exmem_reg->alures_out >>
+                reg1_fw_src->get(ForwardingSrc::MemStage);  // Todo: Mem stage needs a mux to allow for AUIPC forwarding
+            reg_wr_src->out >> reg1_fw_src->get(ForwardingSrc::WbStage);
+            funit->alu_reg1_forwarding_ctrl >> reg1_fw_src->select;
+
+            idex_reg->r2_out >> reg2_fw_src->get(ForwardingSrc::IdStage);
+            exmem_reg->alures_out >> reg2_fw_src->get(ForwardingSrc::MemStage);
+            reg_wr_src->out >> reg2_fw_src->get(ForwardingSrc::WbStage);
+            funit->alu_reg2_forwarding_ctrl >> reg2_fw_src->select;
+
+            // ALU operand multiplexers
+            reg1_fw_src->out >> alu_op1_src->get(AluSrc1::REG1);
+        } else {
+            idex_reg->r1_out >> alu_op1_src->get(AluSrc1::REG1);
+        }
         idex_reg->pc_out >> alu_op1_src->get(AluSrc1::PC);
         idex_reg->alu_op1_ctrl_out >> alu_op1_src->select;
 
-        reg2_fw_src->out >> alu_op2_src->get(AluSrc2::REG2);
+        if constexpr (Forwarding) {
+            reg2_fw_src->out >> alu_op2_src->get(AluSrc2::REG2);
+        } else {
+            idex_reg->r2_out >> alu_op2_src->get(AluSrc2::REG2);
+        }
         idex_reg->imm_out >> alu_op2_src->get(AluSrc2::IMM);
         idex_reg->alu_op2_ctrl_out >> alu_op2_src->select;
 
@@ -131,6 +199,7 @@ public:
         alu_op2_src->out >> alu->op2;
 
         idex_reg->alu_ctrl_out >> alu->ctrl;
+        alu->setProcessor(this);
 
         // -----------------------------------------------------------------------
         // Data memory
@@ -142,29 +211,56 @@ public:
 
         // -----------------------------------------------------------------------
         // Ecall checker
-
-        idex_reg->opcode_out >> ecallChecker->opcode;
-        ecallChecker->setSysCallSignal(&handleSysCall);
-        hzunit->stallEcallHandling >> ecallChecker->stallEcallHandling;
+        if constexpr (HazardDetection) {
+            idex_reg->opcode_out >> ecallChecker->opcode;
+        } else {
+            decode->opcode >> ecallChecker->opcode;
+        }
+        ecallChecker->setProcessor(this);
+        if constexpr (HazardDetection) {
+            hzunit->stallEcallHandling >> ecallChecker->stallEcallHandling;
+        } else {
+            0 >> ecallChecker->stallEcallHandling;
+        }
 
         // -----------------------------------------------------------------------
         // IF/ID
         pc_4->out >> ifid_reg->pc4_in;
         pc_reg->out >> ifid_reg->pc_in;
         instr_mem->data_out >> ifid_reg->instr_in;
-        hzunit->hazardFEEnable >> ifid_reg->enable;
+        if constexpr (BranchPrediction) {
+            bpunit->pred_pc >> ifid_reg->pred_pc_in;
+        }
+        if constexpr (HazardDetection) {
+            hzunit->hazardFEEnable >> ifid_reg->enable;
+        } else {
+            1 >> ifid_reg->enable;
+        }
         efsc_or->out >> ifid_reg->clear;
         1 >> ifid_reg->valid_in;  // Always valid unless register is cleared
 
         // -----------------------------------------------------------------------
         // ID/EX
-        hzunit->hazardIDEXEnable >> idex_reg->enable;
-        hzunit->hazardIDEXClear >> idex_reg->stalled_in;
-        efschz_or->out >> idex_reg->clear;
+        if constexpr (HazardDetection) {
+            hzunit->hazardIDEXEnable >> idex_reg->enable;
+            hzunit->hazardIDEXClear >> idex_reg->stalled_in;
+            idex_clear_and->out >> idex_reg->clear;
+        } else {
+            1 >> idex_reg->enable;
+            if constexpr (Forwarding) {
+                0 >> idex_reg->stalled_in;
+            }
+            controlflow_or->out >> idex_reg->clear;
+        }
 
         // Data
         ifid_reg->pc4_out >> idex_reg->pc4_in;
         ifid_reg->pc_out >> idex_reg->pc_in;
+        if constexpr (BranchPrediction) {
+            ifid_reg->pred_pc_out >> idex_reg->pred_pc_in;
+        } else if constexpr (Forwarding) {
+            0 >> idex_reg->pred_pc_in;  // Branches are not predicted
+        }
         registerFile->r1_out >> idex_reg->r1_in;
         registerFile->r2_out >> idex_reg->r2_in;
         immediate->imm >> idex_reg->imm_in;
@@ -181,25 +277,37 @@ public:
         control->comp_ctrl >> idex_reg->br_op_in;
         control->do_branch >> idex_reg->do_br_in;
         control->do_jump >> idex_reg->do_jmp_in;
-        decode->r1_reg_idx >> idex_reg->rd_reg1_idx_in;
-        decode->r2_reg_idx >> idex_reg->rd_reg2_idx_in;
-        decode->opcode >> idex_reg->opcode_in;
+        if constexpr (Forwarding) {
+            decode->r1_reg_idx >> idex_reg->rd_reg1_idx_in;
+            decode->r2_reg_idx >> idex_reg->rd_reg2_idx_in;
+            decode->opcode >> idex_reg->opcode_in;
+        }
         control->mem_do_read_ctrl >> idex_reg->mem_do_read_in;
 
         ifid_reg->valid_out >> idex_reg->valid_in;
 
         // -----------------------------------------------------------------------
         // EX/MEM
-        1 >> exmem_reg->enable;
-        hzunit->hazardEXMEMClear >> exmem_reg->clear;
-        hzunit->hazardEXMEMClear >> *mem_stalled_or->in[0];
-        idex_reg->stalled_out >> *mem_stalled_or->in[1];
-        mem_stalled_or->out >> exmem_reg->stalled_in;
+        if constexpr (HazardDetection) {
+            hzunit->hazardEXMEMEnable >> exmem_reg->enable;
+            hzunit->hazardEXMEMClear >> exmem_reg->clear;
+            hzunit->hazardEXMEMClear >> *mem_stalled_or->in[0];
+            idex_reg->stalled_out >> *mem_stalled_or->in[1];
+            mem_stalled_or->out >> exmem_reg->stalled_in;
+        } else {
+            0 >> exmem_reg->clear;
+            1 >> exmem_reg->enable;
+        }
 
         // Data
         idex_reg->pc_out >> exmem_reg->pc_in;
         idex_reg->pc4_out >> exmem_reg->pc4_in;
-        reg2_fw_src->out >> exmem_reg->r2_in;
+        // The store data is only forwarded alongside hazard detection
+        if constexpr (HazardDetection) {
+            reg2_fw_src->out >> exmem_reg->r2_in;
+        } else {
+            idex_reg->r2_out >> exmem_reg->r2_in;
+        }
         alu->res >> exmem_reg->alures_in;
 
         // Control
@@ -214,8 +322,11 @@ public:
 
         // -----------------------------------------------------------------------
         // MEM/WB
-
-        exmem_reg->stalled_out >> memwb_reg->stalled_in;
+        if constexpr (HazardDetection) {
+            exmem_reg->stalled_out >> *wb_stalled_or->in[0];
+            hzunit->hazardMEMStall >> *wb_stalled_or->in[1];
+            wb_stalled_or->out >> memwb_reg->stalled_in;
+        }
 
         // Data
         exmem_reg->pc_out >> memwb_reg->pc_in;
@@ -226,37 +337,65 @@ public:
         // Control
         exmem_reg->reg_wr_src_ctrl_out >> memwb_reg->reg_wr_src_ctrl_in;
         exmem_reg->wr_reg_idx_out >> memwb_reg->wr_reg_idx_in;
-        exmem_reg->reg_do_write_out >> memwb_reg->reg_do_write_in;
+        if constexpr (HazardDetection) {
+            // A bubble is inserted into the WB stage whilst the MEM stage is stalled on a data memory access
+            exmem_reg->reg_do_write_out >> *wb_do_write_and->in[0];
+            hzunit->hazardEXMEMEnable >> *wb_do_write_and->in[1];
+            wb_do_write_and->out >> memwb_reg->reg_do_write_in;
+
+            exmem_reg->valid_out >> *wb_valid_and->in[0];
+            hzunit->hazardEXMEMEnable >> *wb_valid_and->in[1];
+            wb_valid_and->out >> memwb_reg->valid_in;
+        } else {
+            exmem_reg->reg_do_write_out >> memwb_reg->reg_do_write_in;
+
+            exmem_reg->valid_out >> memwb_reg->valid_in;
+        }
 
-        exmem_reg->valid_out >> memwb_reg->valid_in;
+        if constexpr (Forwarding) {
+            // -----------------------------------------------------------------------
+            // Forwarding unit
+            idex_reg->rd_reg1_idx_out >> funit->id_reg1_idx;
+            idex_reg->rd_reg2_idx_out >> funit->id_reg2_idx;
 
-        // -----------------------------------------------------------------------
-        // Forwarding unit
-        idex_reg->rd_reg1_idx_out >> funit->id_reg1_idx;
-        idex_reg->rd_reg2_idx_out >> funit->id_reg2_idx;
+            exmem_reg->wr_reg_idx_out >> funit->mem_reg_wr_idx;
+            exmem_reg->reg_do_write_out >> funit->mem_reg_wr_en;
 
-        exmem_reg->wr_reg_idx_out >> funit->mem_reg_wr_idx;
-        exmem_reg->reg_do_write_out >> funit->mem_reg_wr_en;
+            memwb_reg->wr_reg_idx_out >> funit->wb_reg_wr_idx;
+            memwb_reg->reg_do_write_out >> funit->wb_reg_wr_en;
+        }
 
-        memwb_reg->wr_reg_idx_out >> funit->wb_reg_wr_idx;
-        memwb_reg->reg_do_write_out >> funit->wb_reg_wr_en;
+        if constexpr (HazardDetection) {
+            // -----------------------------------------------------------------------
+            // Hazard detection unit
+            decode->r1_reg_idx >> hzunit->id_reg1_idx;
+            decode->r2_reg_idx >> hzunit->id_reg2_idx;
+            decode->opcode >> hzunit->id_opcode;
+            hzunit->setMulDivScoreboard(&m_mulDiv);
 
-        // -----------------------------------------------------------------------
-        // Hazard detection unit
-        decode->r1_reg_idx >> hzunit->id_reg1_idx;
-        decode->r2_reg_idx >> hzunit->id_reg2_idx;
+            idex_reg->mem_do_read_out >> hzunit->ex_do_mem_read_en;
+            idex_reg->wr_reg_idx_out >> hzunit->ex_reg_wr_idx;
 
-        idex_reg->mem_do_read_out >> hzunit->ex_do_mem_read_en;
-        idex_reg->wr_reg_idx_out >> hzunit->ex_reg_wr_idx;
+            exmem_reg->reg_do_write_out >> hzunit->mem_do_reg_write;
 
-        exmem_reg->reg_do_write_out >> hzunit->mem_do_reg_write;
+            memwb_reg->reg_do_write_out >> hzunit->wb_do_reg_write;
 
-        memwb_reg->reg_do_write_out >> hzunit->wb_do_reg_write;
+            idex_reg->opcode_out >> hzunit->opcode;
 
-        idex_reg->opcode_out >> hzunit->opcode;
+            pc_reg->out >> hzunit->if_pc;
+            exmem_reg->alures_out >> hzunit->mem_addr;
+            exmem_reg->mem_do_read_out >> hzunit->mem_do_read_en;
+            exmem_reg->mem_do_write_out >> hzunit->mem_do_write_en;
+            bpunit->mispredict >> hzunit->ex_controlflow;
+
+            hzunit->fetch_stall_cycles_next >> fetch_stall_reg->in;
+            fetch_stall_reg->out >> hzunit->fetch_stall_cycles;
+            hzunit->data_stall_cycles_next >> data_stall_reg->in;
+            data_stall_reg->out >> hzunit->data_stall_cycles;
+        }
     }
 
-    // Design subcomponents
+    // Design subcomponents. Components of disabled units are not created, and are null.
     SUBCOMPONENT(registerFile, RegisterFile<true>);
     SUBCOMPONENT(alu, ALU);
     SUBCOMPONENT(control, Control);
@@ -266,41 +405,54 @@ public:
     SUBCOMPONENT(pc_4, Adder<RV_REG_WIDTH>);
 
     // Registers
-    SUBCOMPONENT(pc_reg, RegisterClEn<RV_REG_WIDTH>);
+    SUBCOMPONENT(pc_reg, PcRegister);
+    // Remaining cycles of the fetch and data memory stalls
+    StallCycleRegister* fetch_stall_reg = optionalComponent<HazardDetection, StallCycleRegister>("fetch_stall_reg");
+    StallCycleRegister* data_stall_reg = optionalComponent<HazardDetection, StallCycleRegister>("data_stall_reg");
 
     // Stage seperating registers
-    SUBCOMPONENT(ifid_reg, IFID);
-    SUBCOMPONENT(idex_reg, RV5S_IDEX);
-    SUBCOMPONENT(exmem_reg, RV5S_EXMEM);
-    SUBCOMPONENT(memwb_reg, RV5S_MEMWB);
+    SUBCOMPONENT(ifid_reg, IFIDRegister);
+    SUBCOMPONENT(idex_reg, IDEXRegister);
+    SUBCOMPONENT(exmem_reg, EXMEMRegister);
+    SUBCOMPONENT(memwb_reg, MEMWBRegister);
 
     // Multiplexers
     SUBCOMPONENT(reg_wr_src, TYPE(EnumMultiplexer<RegWrSrc, RV_REG_WIDTH>));
     SUBCOMPONENT(pc_src, TYPE(EnumMultiplexer<PcSrc, RV_REG_WIDTH>));
     SUBCOMPONENT(alu_op1_src, TYPE(EnumMultiplexer<AluSrc1, RV_REG_WIDTH>));
     SUBCOMPONENT(alu_op2_src, TYPE(EnumMultiplexer<AluSrc2, RV_REG_WIDTH>));
-    SUBCOMPONENT(reg1_fw_src, TYPE(EnumMultiplexer<ForwardingSrc, RV_REG_WIDTH>));
-    SUBCOMPONENT(reg2_fw_src, TYPE(EnumMultiplexer<ForwardingSrc, RV_REG_WIDTH>));
+    using ForwardingMultiplexer = EnumMultiplexer<ForwardingSrc, RV_REG_WIDTH>;
+    ForwardingMultiplexer* reg1_fw_src = optionalComponent<Forwarding, ForwardingMultiplexer>("reg1_fw_src");
+    ForwardingMultiplexer* reg2_fw_src = optionalComponent<Forwarding, ForwardingMultiplexer>("reg2_fw_src");
 
     // Memories
-    SUBCOMPONENT(instr_mem, TYPE(ROM<RV_REG_WIDTH, RV_INSTR_WIDTH>));
+    SUBCOMPONENT(instr_mem, TYPE(RVInstrMemory<RV_REG_WIDTH, RV_INSTR_WIDTH>));
     SUBCOMPONENT(data_mem, TYPE(RVMemory<RV_REG_WIDTH, RV_REG_WIDTH>));
 
     // Forwarding & hazard detection units
-    SUBCOMPONENT(funit, ForwardingUnit);
-    SUBCOMPONENT(hzunit, HazardUnit);
+    ForwardingUnit* funit = optionalComponent<Forwarding, ForwardingUnit>("funit");
+    HazardUnit* hzunit = optionalComponent<HazardDetection, HazardUnit>("hzunit");
+    BranchPredictionUnit* bpunit = optionalComponent<BranchPrediction, BranchPredictionUnit>("bpunit");
 
     // Gates
+    using Or2 = Or<1, 2>;
+    using And2 = And<1, 2>;
     // True if branch instruction and branch taken
-    SUBCOMPONENT(br_and, TYPE(And<1, 2>));
+    SUBCOMPONENT(br_and, And2);
     // True if branch taken or jump instruction
-    SUBCOMPONENT(controlflow_or, TYPE(Or<1, 2>));
-    // True if controlflow action or performing syscall finishing
-    SUBCOMPONENT(efsc_or, TYPE(Or<1, 2>));
+    SUBCOMPONENT(controlflow_or, Or2);
+    // True if misprediction (or without prediction, controlflow action) or performing syscall finishing
+    SUBCOMPONENT(efsc_or, Or2);
     // True if above or stalling due to load-use hazard
-    SUBCOMPONENT(efschz_or, TYPE(Or<1, 2>));
+    Or2* efschz_or = optionalComponent<HazardDetection, Or2>("efschz_or");
 
-    SUBCOMPONENT(mem_stalled_or, TYPE(Or<1, 2>));
+    Or2* mem_stalled_or = optionalComponent<HazardDetection, Or2>("mem_stalled_or");
+    // True if above and not stalling on a data memory access
+    And2* idex_clear_and = optionalComponent<HazardDetection, And2>("idex_clear_and");
+    // Bubble insertion into the WB stage upon data memory stalls
+    Or2* wb_stalled_or = optionalComponent<HazardDetection, Or2>("wb_stalled_or");
+    And2* wb_do_write_and = optionalComponent<HazardDetection, And2>("wb_do_write_and");
+    And2* wb_valid_and = optionalComponent<HazardDetection, And2>("wb_valid_and");
 
     // Address spaces
     ADDRESSSPACE(m_memory);
@@ -324,7 +476,14 @@ public:
         Q_UNREACHABLE();
         // clang-format on
     }
-    unsigned int nextFetchedAddress() const override { return pc_src->out.uValue(); }
+    unsigned int dataAccessStage() const override { return MEM; }
+    unsigned int nextFetchedAddress() const override {
+        if constexpr (BranchPrediction) {
+            return bpunit->next_pc.uValue();
+        } else {
+            return pc_src->out.uValue();
+        }
+    }
     QString stageName(unsigned int idx) const override {
         // clang-format off
         switch (idx) {
@@ -339,34 +498,7 @@ public:
         // clang-format on
     }
     StageInfo stageInfo(unsigned int stage) const override {
-        bool stageValid = true;
-        // Has the pipeline stage been filled?
-        stageValid &= stage <= m_cycleCount;
-
-        // clang-format off
-        // Has the stage been cleared?
-        switch(stage){
-        case ID: stageValid &= ifid_reg->valid_out.uValue(); break;
-        case EX: stageValid &= idex_reg->valid_out.uValue(); break;
-        case MEM: stageValid &= exmem_reg->valid_out.uValue(); break;
-        case WB: stageValid &= memwb_reg->valid_out.uValue(); break;
-        default: case IF: break;
-        }
-
-        // Is the stage carrying a valid (executable) PC?
-        switch(stage){
-        case ID: stageValid &= isExecutableAddress(ifid_reg->pc_out.uValue()); break;
-        case EX: stageValid &= isExecutableAddress(idex_reg->pc_out.uValue()); break;
-        case MEM: stageValid &= isExecutableAddress(exmem_reg->pc_out.uValue()); break;
-        case WB: stageValid &= isExecutableAddress(memwb_reg->pc_out.uValue()); break;
-        default: case IF: stageValid &= isExecutableAddress(pc_reg->out.uValue()); break;
-        }
-
-        // Are we currently clearing the pipeline due to a syscall exit? if such, all stages before the EX stage are invalid
-        if(stage < EX){
-            stageValid &= !ecallChecker->isSysCallExiting();
-        }
-        // clang-format on
+        const bool stageValid = stage < STAGECOUNT && (stageValidMask() >> stage) & 1;
 
         // Gather stage state info
         StageInfo::State state = StageInfo ::State::None;
@@ -379,7 +511,7 @@ public:
                 }
                 break;
             case EX: {
-                if (idex_reg->stalled_out.uValue() == 1) {
+                if (isStalled(idex_reg)) {
                     state = StageInfo::State::Stalled;
                 } else if (m_cycleCount > EX && idex_reg->valid_out.uValue() == 0) {
                     state = StageInfo::State::Flushed;
@@ -387,7 +519,7 @@ public:
                 break;
             }
             case MEM: {
-                if (exmem_reg->stalled_out.uValue() == 1) {
+                if (isStalled(exmem_reg)) {
                     state = StageInfo::State::Stalled;
                 } else if (m_cycleCount > MEM && exmem_reg->valid_out.uValue() == 0) {
                     state = StageInfo::State::Flushed;
@@ -395,7 +527,7 @@ public:
                 break;
             }
             case WB: {
-                if (memwb_reg->stalled_out.uValue() == 1) {
+                if (isStalled(memwb_reg)) {
                     state = StageInfo::State::Stalled;
                 } else if (m_cycleCount > WB && memwb_reg->valid_out.uValue() == 0) {
                     state = StageInfo::State::Flushed;
@@ -410,6 +542,7 @@ public:
     void setProgramCounter(uint32_t address) override {
         pc_reg->forceValue(0, address);
         propagateDesign();
+        invalidateStageValidity();
     }
     void setPCInitialValue(uint32_t address) override { pc_reg->setInitValue(address); }
     SparseArray& getMemory() override { return *m_memory; }
@@ -422,20 +555,17 @@ public:
             m_syscallExitCycle = m_cycleCount;
         }
         ecallChecker->setSysCallExiting(ecallChecker->isSysCallExiting() || fr.exitSyscall);
+        invalidateStageValidity();
     }
 
     const Component* getDataMemory() const override { return data_mem; }
     const Component* getInstrMemory() const override { return instr_mem; }
+    void setMMIODevices(MMIODevices* devices) override { data_mem->setDevices(devices); }
+    void memoryModified() override { instr_mem->invalidate(); }
 
     bool finished() const override {
         // The processor is finished when there are no more valid instructions in the pipeline
-        bool allStagesInvalid = true;
-        for (int stage = IF; stage < STAGECOUNT; stage++) {
-            allStagesInvalid &= !stageInfo(stage).stage_valid;
-            if (!allStagesInvalid)
-                break;
-        }
-        return allStagesInvalid;
+        return stageValidMask() == 0;
     }
 
     void setRegister(unsigned i, uint32_t v) override { setSynchronousValue(registerFile->_wr_mem, i, v); }
@@ -447,7 +577,42 @@ public:
             m_instructionsRetired++;
         }
 
+        if constexpr (BranchPrediction) {
+            // The branch predictor is trained with the control-flow instruction leaving the EX stage, if any
+            const bool resolved = hzunit->hazardEXMEMEnable.uValue() &&
+                                  (idex_reg->do_br_out.uValue() || idex_reg->do_jmp_out.uValue());
+            BranchPredictor::Outcome outcome;
+            outcome.pc = idex_reg->pc_out.uValue();
+            outcome.target = pc_src->out.uValue();
+            outcome.conditional = idex_reg->do_br_out.uValue();
+            outcome.taken = controlflow_or->out.uValue();
+            outcome.mispredicted = bpunit->mispredict.uValue();
+            bpunit->predictor().clock(resolved ? &outcome : nullptr);
+        }
+
+        if constexpr (HazardDetection) {
+            // The multi-cycle functional units are advanced with the instruction leaving the EX stage, if any. Stalls
+            // on the units are superseded by data memory stalls.
+            const bool exAdvances = hzunit->hazardEXMEMEnable.uValue() && !hzunit->hazardEXMEMClear.uValue();
+            m_mulDiv.clock(exAdvances, idex_reg->opcode_out.uValue(), idex_reg->wr_reg_idx_out.uValue(),
+                           idex_reg->reg_do_write_out.uValue(),
+                           hzunit->hazardEXMEMEnable.uValue() ? hzunit->mulDivStall() : MulDivScoreboard::Stall::None);
+
+            accumulateHazardStatistics(1);
+
+            // The stall cycles of the accesses of the next cycle are given by the memory latency model
+            hzunit->forgetKnownStallCycles();
+        }
+        if (data_mem->wr_en.uValue()) {
+            instr_mem->invalidate(data_mem->addr.uValue(), 4);
+        }
         RipesProcessor::clock();
+        if constexpr (HazardDetection) {
+            // The processor was stalled on memory in the previous cycle if the stall cycle counters were loaded
+            if (isStalledOnMemory()) {
+                m_memoryStallCycles++;
+            }
+        }
     }
 
     void reverse() override {
@@ -457,26 +622,248 @@ public:
             ecallChecker->setSysCallExiting(false);
             m_syscallExitCycle = -1;
         }
+        invalidateStageValidity();
+        if constexpr (HazardDetection) {
+            if (isStalledOnMemory()) {
+                m_memoryStallCycles--;
+            }
+            // The memory latency model may not yet have reversed the previous cycle; its stall cycles are those which
+            // were latched at the end of the cycle
+            hzunit->setKnownStallCycles(fetch_stall_reg->out.uValue(), data_stall_reg->out.uValue());
+            m_mulDiv.reverse();
+        }
+        if constexpr (BranchPrediction) {
+            // Predictions of the previous cycle are made with the prediction tables prior to its training
+            bpunit->predictor().reverse();
+        }
+        // The store being reversed is not known until the processor has been reversed
+        instr_mem->invalidate();
         RipesProcessor::reverse();
         if (memwb_reg->valid_out.uValue() != 0 && isExecutableAddress(memwb_reg->pc_out.uValue())) {
             m_instructionsRetired--;
         }
+        if constexpr (HazardDetection) {
+            accumulateHazardStatistics(-1);
+        }
     }
 
     void reset() override {
         ecallChecker->setSysCallExiting(false);
+        invalidateStageValidity();
+        if constexpr (HazardDetection) {
+            hzunit->forgetKnownStallCycles();
+            m_mulDiv.reset();
+            m_hazards = HazardStatistics();
+        }
+        if constexpr (BranchPrediction) {
+            bpunit->predictor().reset();
+        }
         RipesProcessor::reset();
         m_syscallExitCycle = -1;
     }
 
+    void saveCheckpoint(ProcessorCheckpoint& checkpoint) override {
+        RipesProcessor::saveCheckpoint(checkpoint);
+        checkpoint.processorState = {m_syscallExitCycle, ecallChecker->isSysCallExiting()};
+        if constexpr (HazardDetection) {
+            checkpoint.processorState.push_back(static_cast<long long>(hzunit->fetch_stall_cycles_next.uValue()));
+            checkpoint.processorState.push_back(static_cast<long long>(hzunit->data_stall_cycles_next.uValue()));
+            m_mulDiv.saveState(checkpoint.processorState);
+            checkpoint.functionalUnits = m_mulDiv.getStatistics();
+            checkpoint.hazards = m_hazards;
+        }
+        if constexpr (BranchPrediction) {
+            bpunit->predictor().saveState(checkpoint.processorState);
+            checkpoint.branchPrediction = bpunit->predictor().getStatistics();
+        }
+    }
+
+    void restoreCheckpoint(const ProcessorCheckpoint& checkpoint) override {
+        if constexpr (HazardDetection) {
+            if (checkpoint.memory || checkpoint.journaled) {
+                // As when reversing, the stall cycles of the restored cycle are those which were to be latched at its
+                // end
+                hzunit->setKnownStallCycles(checkpoint.processorState.at(2), checkpoint.processorState.at(3));
+            } else {
+                // The microarchitectural state is restored alongside other architectural state, whose accesses are new
+                hzunit->forgetKnownStallCycles();
+            }
+            m_mulDiv.restoreState(checkpoint.processorState, s_mulDivStateOffset);
+            m_mulDiv.setStatistics(checkpoint.functionalUnits);
+            m_hazards = checkpoint.hazards;
+        }
+        if constexpr (BranchPrediction) {
+            bpunit->predictor().restoreState(checkpoint.processorState, s_predictorStateOffset);
+            bpunit->predictor().setStatistics(checkpoint.branchPrediction);
+        }
+        RipesProcessor::restoreCheckpoint(checkpoint);
+        m_syscallExitCycle = checkpoint.processorState.at(0);
+        ecallChecker->setSysCallExiting(checkpoint.processorState.at(1));
+        invalidateStageValidity();
+    }
+
+    void saveLearnedState(std::vector<long long>& state) const override {
+        if constexpr (BranchPrediction) {
+            bpunit->predictor().saveState(state);
+        }
+    }
+    void restoreLearnedState(const std::vector<long long>& state) override {
+        if constexpr (BranchPrediction) {
+            bpunit->predictor().restoreState(state, 0);
+        }
+    }
+
+    void setMemoryLatencyModel(const MemoryLatencyModel* model) override {
+        if constexpr (HazardDetection) {
+            hzunit->setMemoryLatencyModel(model);
+        }
+    }
+    bool supportsMemoryStalls() const override { return HazardDetection; }
+    bool isRepeatedMemoryAccess(bool instr) const override {
+        if constexpr (HazardDetection) {
+            // Accesses are repeated in each of their stall cycles following the first
+            return (instr ? fetch_stall_reg : data_stall_reg)->out.uValue() != 0;
+        } else {
+            return false;
+        }
+    }
+    void memoryLatenciesChanged() override {
+        if constexpr (HazardDetection) {
+            if (hzunit->getMemoryLatencyModel()) {
+                propagateDesign();
+            }
+        }
+    }
+
+    const BranchPredictionStatistics* getBranchPredictionStatistics() const override {
+        if constexpr (BranchPrediction) {
+            return &bpunit->predictor().getStatistics();
+        } else {
+            return nullptr;
+        }
+    }
+
+    void setFunctionalUnitLatencies(const FunctionalUnitLatencies& latencies) override {
+        if constexpr (HazardDetection) {
+            m_mulDiv.setLatencies(latencies);
+        }
+    }
+    bool supportsFunctionalUnitLatencies() const override { return HazardDetection; }
+    const FunctionalUnitStatistics* getFunctionalUnitStatistics() const override {
+        return HazardDetection ? &m_mulDiv.getStatistics() : nullptr;
+    }
+    const HazardStatistics* getHazardStatistics() const override { return HazardDetection ? &m_hazards : nullptr; }
+
 private:
+    static const char* designName() {
+        if constexpr (HazardDetection) {
+            return "5-Stage RISC-V Processor";
+        } else if constexpr (Forwarding) {
+            return "5-Stage RISC-V Processor without forwarding";
+        } else {
+            return "5-Stage RISC-V Processor without forwarding or hazard detection";
+        }
+    }
+
+    /// @returns a new subcomponent @p name of the design if @p Enabled, otherwise null
+    template <bool Enabled, typename T>
+    T* optionalComponent(const char* name) {
+        if constexpr (Enabled) {
+            return create_component<T>(name);
+        } else {
+            return nullptr;
+        }
+    }
+
+    /// @returns true if the stage separating register @p reg holds a stalled instruction
+    template <typename StageRegister>
+    static bool isStalled(const StageRegister* reg) {
+        if constexpr (HazardDetection) {
+            return reg->stalled_out.uValue() == 1;
+        } else {
+            return false;
+        }
+    }
+
+    // Indices of the multiply/divide scoreboard and branch predictor state in ProcessorCheckpoint::processorState,
+    // following the state of the processor
+    static constexpr size_t s_mulDivStateOffset = 4;
+    static constexpr size_t s_predictorStateOffset = s_mulDivStateOffset + MulDivScoreboard::s_stateSize;
+
+    // Timing of the multiplier and divider, which are functionally part of the ALU. Only modelled alongside hazard
+    // detection, which stalls on the units.
+    MulDivScoreboard m_mulDiv;
+
+    HazardStatistics m_hazards;
+
+    /**
+     * @brief accumulateHazardStatistics
+     * Adds the hazards of the current cycle to m_hazards, multiplied by @p sign; 1 when clocking the cycle, and -1
+     * when the cycle has been reversed to.
+     */
+    void accumulateHazardStatistics(int sign) {
+        const bool memAdvances = hzunit->hazardEXMEMEnable.uValue();
+        m_hazards.loadUseStallCycles += sign * hzunit->loadUseStall();
+        m_hazards.ecallStallCycles += sign * hzunit->ecallStall();
+        m_hazards.controlFlowFlushes += sign * (bpunit->mispredict.uValue() && memAdvances);
+        m_hazards.emptyFetchCycles += sign * (hzunit->fetchStall() || (efsc_or->out.uValue() && memAdvances));
+
+        // Operands are counted once the instruction in the EX stage advances
+        if (idex_reg->valid_out.uValue() && memAdvances && !hzunit->hazardEXMEMClear.uValue()) {
+            m_hazards.forwardedOperands +=
+                sign * ((funit->alu_reg1_forwarding_ctrl.uValue() != ForwardingSrc::IdStage) +
+                        (funit->alu_reg2_forwarding_ctrl.uValue() != ForwardingSrc::IdStage));
+        }
+    }
+
+    /// @returns true if the processor was stalled on memory in the cycle preceding the current cycle
+    bool isStalledOnMemory() const {
+        return fetch_stall_reg->out.uValue() != 0 || data_stall_reg->out.uValue() != 0;
+    }
+
     /**
      * @brief m_syscallExitCycle
      * The variable will contain the cycle of which an exit system call was executed. From this, we may determine
      * when we roll back an exit system call during rewinding.
      */
     long long m_syscallExitCycle = -1;
+
+    /**
+     * @brief stageValidMask
+     * @returns a mask with bit i set if stage i currently carries a valid instruction.
+     */
+    unsigned stageValidMask() const {
+        return m_stageValidity.mask(m_cycleCount, [this] { return computeStageValidMask(); });
+    }
+    void invalidateStageValidity() { m_stageValidity.invalidate(); }
+
+    unsigned computeStageValidMask() const {
+        // A stage is valid if it has not been cleared, and is carrying a valid (executable) PC
+        unsigned mask = 0;
+        mask |= isExecutableAddress(pc_reg->out.uValue()) << IF;
+        mask |= (ifid_reg->valid_out.uValue() && isExecutableAddress(ifid_reg->pc_out.uValue())) << ID;
+        mask |= (idex_reg->valid_out.uValue() && isExecutableAddress(idex_reg->pc_out.uValue())) << EX;
+        mask |= (exmem_reg->valid_out.uValue() && isExecutableAddress(exmem_reg->pc_out.uValue())) << MEM;
+        mask |= (memwb_reg->valid_out.uValue() && isExecutableAddress(memwb_reg->pc_out.uValue())) << WB;
+
+        // Are we currently clearing the pipeline due to a syscall exit? if such, all stages before the EX stage are
+        // invalid
+        if (ecallChecker->isSysCallExiting()) {
+            mask &= ~((1u << IF) | (1u << ID));
+        }
+
+        // Has the pipeline been filled up to the stage?
+        if (m_cycleCount < WB) {
+            mask &= (1u << (m_cycleCount + 1)) - 1;
+        }
+        return mask;
+    }
+
+    StageValidityCache m_stageValidity;
 };
 
+using RV5S_NO_HZ = RV5S<true, false, false>;
+using RV5S_NO_FW_HZ = RV5S<false, false, false>;
+
 }  // namespace core
 }  // namespace vsrtl
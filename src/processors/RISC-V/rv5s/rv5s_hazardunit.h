@@ -1,9 +1,13 @@
 #pragma once
 
+#include "../../ripesprocessor.h"
 #include "../riscv.h"
+#include "../rv_muldiv.h"
 
 #include "VSRTL/core/vsrtl_component.h"
 
+#include <algorithm>
+
 namespace vsrtl {
 namespace core {
 using namespace Ripes;
@@ -11,15 +15,89 @@ using namespace Ripes;
 class HazardUnit : public Component {
 public:
     HazardUnit(std::string name, SimComponent* parent) : Component(name, parent) {
-        hazardFEEnable << [=] { return !hasHazard(); };
-        hazardIDEXEnable << [=] { return !hasEcallHazard(); };
-        hazardEXMEMClear << [=] { return hasEcallHazard(); };
-        hazardIDEXClear << [=] { return hasLoadUseHazard(); };
-        stallEcallHandling << [=] { return hasEcallHazard(); };
+        hazardFEEnable << [=] { return !hasHazard() && !hasFetchStall() && !hasDataStall(); };
+        hazardIDEXEnable << [=] { return !hasEcallHazard() && !hasDataStall(); };
+        hazardEXMEMEnable << [=] { return !hasDataStall(); };
+        hazardEXMEMClear << [=] { return hasEcallHazard() && !hasDataStall(); };
+        hazardIDEXClear << [=] {
+            // Fetch and multiply/divide stalls insert a bubble into the EX stage, unless the EX stage is held by an
+            // ECALL hazard
+            return (hasLoadUseHazard() || ((hasFetchStall() || hasMulDivHazard()) && !hasEcallHazard())) &&
+                   !hasDataStall();
+        };
+        hazardMEMStall << [=] { return hasDataStall(); };
+        stallEcallHandling << [=] { return hasEcallHazard() || hasDataStall(); };
+
+        fetch_stall_cycles_next << [=] {
+            if (ex_controlflow.uValue()) {
+                // The fetched instruction is discarded
+                return 0u;
+            }
+            const unsigned remaining = fetch_stall_cycles.uValue();
+            return remaining == 0 ? fetchStallCycles() : remaining - 1;
+        };
+        data_stall_cycles_next << [=] {
+            if (!hasDataAccess()) {
+                return 0u;
+            }
+            const unsigned remaining = data_stall_cycles.uValue();
+            return remaining == 0 ? dataStallCycles() : remaining - 1;
+        };
+    }
+
+    /**
+     * @brief setMemoryLatencyModel
+     * Stalls the front end for the stall cycles of each fetch, and the entire pipeline up to and including the MEM
+     * stage for the stall cycles of each data memory access, as given by @p model. Memory accesses are not stalled if
+     * nullptr.
+     */
+    void setMemoryLatencyModel(const MemoryLatencyModel* model) { m_latencyModel = model; }
+    const MemoryLatencyModel* getMemoryLatencyModel() const { return m_latencyModel; }
+
+    /**
+     * @brief setKnownStallCycles
+     * Sets the stall cycles of the new fetch and data memory accesses of the current cycle, as already determined by
+     * the memory latency model, which are used in place of the model until forgetKnownStallCycles() is called. When
+     * reversing or restoring the processor to a cycle, the model may no longer be in the state it was in when the
+     * cycle was first simulated; the stall cycles are then those which were latched into the stall cycle registers at
+     * the end of the cycle.
+     */
+    void setKnownStallCycles(unsigned fetch, unsigned data) {
+        m_stallCyclesKnown = true;
+        m_knownFetchStallCycles = fetch;
+        m_knownDataStallCycles = data;
     }
+    void forgetKnownStallCycles() { m_stallCyclesKnown = false; }
+
+    /**
+     * @brief setMulDivScoreboard
+     * Stalls instructions in the ID stage on the results and availability of the multi-cycle functional units tracked
+     * by @p scoreboard. Multiplications and divisions complete in a single cycle if nullptr.
+     */
+    void setMulDivScoreboard(const MulDivScoreboard* scoreboard) { m_scoreboard = scoreboard; }
+
+    /// @returns the stall of the instruction in the ID stage on the multi-cycle functional units, if any
+    MulDivScoreboard::Stall mulDivStall() const {
+        if (!m_scoreboard) {
+            return MulDivScoreboard::Stall::None;
+        }
+        return m_scoreboard->stall(opcode.uValue(), ex_reg_wr_idx.uValue(), id_opcode.uValue(), id_reg1_idx.uValue(),
+                                   id_reg2_idx.uValue());
+    }
+
+    /// @returns true if the front end is stalled by a load-use hazard in the current cycle
+    bool loadUseStall() const { return hasLoadUseHazard() && !hasDataStall(); }
+    /// @returns true if the front end is stalled by an ECALL hazard in the current cycle
+    bool ecallStall() const { return hasEcallHazard() && !hasDataStall(); }
+    /// @returns true if the front end is stalled on instruction memory in the current cycle
+    bool fetchStall() const { return hasFetchStall() && !hasDataStall(); }
+
+    // Width of the stall cycle counters; stall cycles beyond the range of the counters are saturated
+    static constexpr unsigned s_stallCycleBits = 16;
 
     INPUTPORT(id_reg1_idx, RV_REGS_BITS);
     INPUTPORT(id_reg2_idx, RV_REGS_BITS);
+    INPUTPORT_ENUM(id_opcode, RVInstr);
 
     INPUTPORT(ex_reg_wr_idx, RV_REGS_BITS);
     INPUTPORT(ex_do_mem_read_en, 1);
@@ -30,24 +108,91 @@ public:
 
     INPUTPORT_ENUM(opcode, RVInstr);
 
+    // Memory accesses; the fetched address, the data memory access of the MEM stage, and whether the instruction in
+    // the EX stage redirects the front end
+    INPUTPORT(if_pc, RV_REG_WIDTH);
+    INPUTPORT(mem_addr, RV_REG_WIDTH);
+    INPUTPORT(mem_do_read_en, 1);
+    INPUTPORT(mem_do_write_en, 1);
+    INPUTPORT(ex_controlflow, 1);
+
+    // Stall cycle counters: the number of cycles remaining of the current fetch and data memory access stalls,
+    // including the final cycle in which the access completes; 0 if the access of the cycle is a new access. Shall be
+    // connected through registers.
+    INPUTPORT(fetch_stall_cycles, s_stallCycleBits);
+    INPUTPORT(data_stall_cycles, s_stallCycleBits);
+    OUTPUTPORT(fetch_stall_cycles_next, s_stallCycleBits);
+    OUTPUTPORT(data_stall_cycles_next, s_stallCycleBits);
+
     // Hazard Front End enable: Low when stalling the front end (shall be connected to a register 'enable' input port).
     // The
     OUTPUTPORT(hazardFEEnable, 1);
 
-    // Hazard IDEX enable: Low when stalling due to an ECALL hazard
+    // Hazard IDEX enable: Low when stalling due to an ECALL hazard or a data memory stall
     OUTPUTPORT(hazardIDEXEnable, 1);
 
+    // Hazard EXMEM enable: Low when stalling on a data memory access. The stages preceding the MEM stage shall not be
+    // flushed whilst low, given that these are held.
+    OUTPUTPORT(hazardEXMEMEnable, 1);
+
     // EXMEM clear: High when an ECALL hazard is detected
     OUTPUTPORT(hazardEXMEMClear, 1);
-    // IDEX clear: High when a load-use hazard is detected
+    // IDEX clear: High when a load-use hazard is detected, or a bubble is inserted due to a fetch or multiply/divide
+    // stall
     OUTPUTPORT(hazardIDEXClear, 1);
 
+    // MEM stall: High when stalling on a data memory access; a bubble is inserted into the WB stage
+    OUTPUTPORT(hazardMEMStall, 1);
+
     // Stall Ecall Handling: High whenever we are about to handle an ecall, but have outstanding writes in the pipeline
     // which must be comitted to the register file before handling the ecall.
     OUTPUTPORT(stallEcallHandling, 1);
 
 private:
-    bool hasHazard() { return hasLoadUseHazard() || hasEcallHazard(); }
+    bool hasHazard() { return hasLoadUseHazard() || hasEcallHazard() || hasMulDivHazard(); }
+
+    bool hasMulDivHazard() const { return mulDivStall() != MulDivScoreboard::Stall::None; }
+
+    unsigned saturateStallCycles(unsigned cycles) const {
+        return std::min(cycles, (1u << s_stallCycleBits) - 1);
+    }
+
+    unsigned fetchStallCycles() const {
+        if (m_stallCyclesKnown) {
+            return m_knownFetchStallCycles;
+        }
+        return m_latencyModel ? saturateStallCycles(m_latencyModel->fetchStallCycles(if_pc.uValue())) : 0;
+    }
+
+    unsigned dataStallCycles() const {
+        if (m_stallCyclesKnown) {
+            return m_knownDataStallCycles;
+        }
+        if (!m_latencyModel) {
+            return 0;
+        }
+        return saturateStallCycles(m_latencyModel->dataStallCycles(mem_addr.uValue(), mem_do_write_en.uValue()));
+    }
+
+    bool hasDataAccess() const { return mem_do_read_en.uValue() || mem_do_write_en.uValue(); }
+
+    // An access is stalled in all but the final of its stall cycles, if any
+    bool hasFetchStall() const {
+        if (ex_controlflow.uValue()) {
+            // Fetches are not stalled if the fetched instruction is discarded
+            return false;
+        }
+        const unsigned remaining = fetch_stall_cycles.uValue();
+        return remaining == 0 ? fetchStallCycles() != 0 : remaining > 1;
+    }
+
+    bool hasDataStall() const {
+        if (!hasDataAccess()) {
+            return false;
+        }
+        const unsigned remaining = data_stall_cycles.uValue();
+        return remaining == 0 ? dataStallCycles() != 0 : remaining > 1;
+    }
 
     bool hasLoadUseHazard() const {
         const unsigned exidx = ex_reg_wr_idx.uValue();
@@ -66,6 +211,12 @@ private:
         const bool isEcall = opcode.uValue() == RVInstr::ECALL;
         return isEcall && (mem_do_reg_write.uValue() || wb_do_reg_write.uValue());
     }
+
+    const MemoryLatencyModel* m_latencyModel = nullptr;
+    const MulDivScoreboard* m_scoreboard = nullptr;
+    bool m_stallCyclesKnown = false;
+    unsigned m_knownFetchStallCycles = 0;
+    unsigned m_knownDataStallCycles = 0;
 };
 }  // namespace core
 }  // namespace vsrtl
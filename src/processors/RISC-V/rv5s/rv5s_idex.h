@@ -15,7 +15,8 @@ using namespace Ripes;
 /**
  * @brief The RV5S_IDEX class
  * A specialization of the default IDEX stage separating register utilized by the rv5s_no_fw_hz processor. Storage of register
- * read indices is added, which are required by the forwarding unit.
+ * read indices is added, which are required by the forwarding unit, alongside the address predicted to follow the
+ * instruction, which is required for resolving the prediction.
  */
 class RV5S_IDEX : public IDEX {
 public:
@@ -23,6 +24,7 @@ public:
         CONNECT_REGISTERED_CLEN_INPUT(rd_reg1_idx, clear, enable);
         CONNECT_REGISTERED_CLEN_INPUT(rd_reg2_idx, clear, enable);
         CONNECT_REGISTERED_CLEN_INPUT(opcode, clear, enable);
+        CONNECT_REGISTERED_CLEN_INPUT(pred_pc, clear, enable);
 
         // We want stalling info to persist through clearing of the register, so stalled register is always enabled and
         // never cleared.
@@ -32,6 +34,7 @@ public:
     REGISTERED_CLEN_INPUT(rd_reg1_idx, RV_REGS_BITS);
     REGISTERED_CLEN_INPUT(rd_reg2_idx, RV_REGS_BITS);
     REGISTERED_CLEN_INPUT(opcode, RVInstr::width());
+    REGISTERED_CLEN_INPUT(pred_pc, RV_REG_WIDTH);
 
     REGISTERED_CLEN_INPUT(stalled, 1);
 };
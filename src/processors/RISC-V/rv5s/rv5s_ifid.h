@@ -0,0 +1,29 @@
+#pragma once
+
+#include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_register.h"
+
+#include "../riscv.h"
+
+#include "../rv5s_no_fw_hz/rv5s_no_fw_hz_ifid.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The RV5S_IFID class
+ * A specialization of the default IFID stage separating register utilized by the rv5s_no_fw_hz processor. Storage of
+ * the address predicted to follow the fetched instruction is added, which is required for resolving the prediction.
+ */
+class RV5S_IFID : public IFID {
+public:
+    RV5S_IFID(std::string name, SimComponent* parent) : IFID(name, parent) {
+        CONNECT_REGISTERED_CLEN_INPUT(pred_pc, clear, enable);
+    }
+
+    REGISTERED_CLEN_INPUT(pred_pc, RV_REG_WIDTH);
+};
+
+}  // namespace core
+}  // namespace vsrtl
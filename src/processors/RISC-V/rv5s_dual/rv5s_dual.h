@@ -0,0 +1,722 @@
+#pragma once
+
+#include "VSRTL/core/vsrtl_adder.h"
+#include "VSRTL/core/vsrtl_constant.h"
+#include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_logicgate.h"
+#include "VSRTL/core/vsrtl_multiplexer.h"
+
+#include "../../ripesprocessor.h"
+
+// Functional units
+#include "../riscv.h"
+#include "../rv_alu.h"
+#include "../rv_branch.h"
+#include "../rv_control.h"
+#include "../rv_decode.h"
+#include "../rv_ecallchecker.h"
+#include "../rv_immediate.h"
+#include "../rv_memory.h"
+#include "../rv_registerfile.h"
+
+// Stage separating registers
+#include "../rv5s/rv5s_exmem.h"
+#include "../rv5s/rv5s_idex.h"
+#include "../rv5s/rv5s_memwb.h"
+#include "../rv5s_no_fw_hz/rv5s_no_fw_hz_ifid.h"
+
+// Forwarding & Hazard detection unit
+#include "rv5s_dual_forwardingunit.h"
+#include "rv5s_dual_hazardunit.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The RV5S_DUAL class
+ * A dual-issue in-order variant of the 5-stage processor. Pairs of consecutive instructions are fetched and decoded,
+ * and issued together to two lanes of the EX, MEM and WB stages, as permitted by the pairing rules of the hazard unit
+ * (see DualHazardUnit). Each lane has its own ALU and branch comparator, and writes the results of its instructions
+ * through a dedicated write port of the register file. Data memory is only accessible from lane 0. Within each stage,
+ * lane 0 carries the older of the instructions of the lanes. Control flow is resolved in the EX stage, and the
+ * fall-through path is fetched meanwhile.
+ */
+class RV5S_DUAL : public RipesProcessor {
+public:
+    // Stages are ordered by age: lane 1 of each stage precedes lane 0, and IF fetches the pair at the PC
+    enum Stage { IF = 0, ID1 = 1, ID0 = 2, EX1 = 3, EX0 = 4, MEM1 = 5, MEM0 = 6, WB1 = 7, WB0 = 8, STAGECOUNT };
+    RV5S_DUAL() : RipesProcessor("Dual-issue 5-Stage RISC-V Processor") {
+        // -----------------------------------------------------------------------
+        // Program counter
+        pc_reg->out >> pc_4->op1;
+        4 >> pc_4->op2;
+        pc_reg->out >> pc_8->op1;
+        8 >> pc_8->op2;
+        fetch_src->out >> pc_reg->in;
+        0 >> pc_reg->clear;
+        hzunit->hazardPCEnable >> pc_reg->enable;
+
+        pc_8->out >> fetch_src->get(DualFetchSrc::Pair);
+        pc_src0->out >> fetch_src->get(DualFetchSrc::Ex0);
+        pc_src1->out >> fetch_src->get(DualFetchSrc::Ex1);
+        hzunit->fetch_src_ctrl >> fetch_src->select;
+
+        // Note: pc_src0/1 use the PcSrc enum, but are selected by the boolean signal from the controlflow OR gates.
+        // PcSrc enum values must adhere to the boolean 0/1 values.
+        controlflow_or0->out >> pc_src0->select;
+        controlflow_or1->out >> pc_src1->select;
+
+        controlflow_or0->out >> *redirect_or->in[0];
+        controlflow_or1->out >> *redirect_or->in[1];
+
+        redirect_or->out >> *efsc_or->in[0];
+        ecallChecker->syscallExit >> *efsc_or->in[1];
+
+        efsc_or->out >> *efschz_or->in[0];
+        hzunit->hazardIDEXClear >> *efschz_or->in[1];
+
+        // -----------------------------------------------------------------------
+        // Instruction memory
+        pc_reg->out >> instr_mem0->addr;
+        instr_mem0->setMemory(m_memory);
+        pc_4->out >> instr_mem1->addr;
+        instr_mem1->setMemory(m_memory);
+
+        // -----------------------------------------------------------------------
+        // Decode
+        ifid0_reg->instr_out >> decode0->instr;
+        ifid1_reg->instr_out >> decode1->instr;
+
+        // -----------------------------------------------------------------------
+        // Control signals
+        decode0->opcode >> control0->opcode;
+        decode1->opcode >> control1->opcode;
+
+        // -----------------------------------------------------------------------
+        // Immediate
+        decode0->opcode >> immediate0->opcode;
+        ifid0_reg->instr_out >> immediate0->instr;
+        decode1->opcode >> immediate1->opcode;
+        ifid1_reg->instr_out >> immediate1->instr;
+
+        // -----------------------------------------------------------------------
+        // Registers
+        decode0->r1_reg_idx >> registerFile->r1_addr;
+        decode0->r2_reg_idx >> registerFile->r2_addr;
+        decode1->r1_reg_idx >> registerFile->r3_addr;
+        decode1->r2_reg_idx >> registerFile->r4_addr;
+
+        memwb0_reg->wr_reg_idx_out >> registerFile->wr1_addr;
+        memwb0_reg->reg_do_write_out >> registerFile->wr1_en;
+        reg_wr_src0->out >> registerFile->data1_in;
+        memwb0_reg->mem_read_out >> reg_wr_src0->get(RegWrSrc::MEMREAD);
+        memwb0_reg->alures_out >> reg_wr_src0->get(RegWrSrc::ALURES);
+        memwb0_reg->pc4_out >> reg_wr_src0->get(RegWrSrc::PC4);
+        memwb0_reg->reg_wr_src_ctrl_out >> reg_wr_src0->select;
+
+        memwb1_reg->wr_reg_idx_out >> registerFile->wr2_addr;
+        memwb1_reg->reg_do_write_out >> registerFile->wr2_en;
+        reg_wr_src1->out >> registerFile->data2_in;
+        memwb1_reg->mem_read_out >> reg_wr_src1->get(RegWrSrc::MEMREAD);
+        memwb1_reg->alures_out >> reg_wr_src1->get(RegWrSrc::ALURES);
+        memwb1_reg->pc4_out >> reg_wr_src1->get(RegWrSrc::PC4);
+        memwb1_reg->reg_wr_src_ctrl_out >> reg_wr_src1->select;
+
+        registerFile->setMemory(m_regMem);
+
+        // -----------------------------------------------------------------------
+        // Branch
+        idex0_reg->br_op_out >> branch0->comp_op;
+        reg1_fw_src0->out >> branch0->op1;
+        reg2_fw_src0->out >> branch0->op2;
+
+        branch0->res >> *br_and0->in[0];
+        idex0_reg->do_br_out >> *br_and0->in[1];
+        br_and0->out >> *controlflow_or0->in[0];
+        idex0_reg->do_jmp_out >> *controlflow_or0->in[1];
+
+        idex0_reg->pc4_out >> pc_src0->get(PcSrc::PC4);
+        alu0->res >> pc_src0->get(PcSrc::ALU);
+
+        idex1_reg->br_op_out >> branch1->comp_op;
+        reg1_fw_src1->out >> branch1->op1;
+        reg2_fw_src1->out >> branch1->op2;
+
+        branch1->res >> *br_and1->in[0];
+        idex1_reg->do_br_out >> *br_and1->in[1];
+        br_and1->out >> *controlflow_or1->in[0];
+        idex1_reg->do_jmp_out >> *controlflow_or1->in[1];
+
+        idex1_reg->pc4_out >> pc_src1->get(PcSrc::PC4);
+        alu1->res >> pc_src1->get(PcSrc::ALU);
+
+        // -----------------------------------------------------------------------
+        // ALUs
+
+        // Forwarding multiplexers
+        idex0_reg->r1_out >> reg1_fw_src0->get(DualForwardingSrc::IdStage);
+        idex0_reg->r2_out >> reg2_fw_src0->get(DualForwardingSrc::IdStage);
+        idex1_reg->r1_out >> reg1_fw_src1->get(DualForwardingSrc::IdStage);
+        idex1_reg->r2_out >> reg2_fw_src1->get(DualForwardingSrc::IdStage);
+        for (auto* fw_src : {reg1_fw_src0, reg2_fw_src0, reg1_fw_src1, reg2_fw_src1}) {
+            exmem0_reg->alures_out >> fw_src->get(DualForwardingSrc::Mem0Stage);
+            exmem1_reg->alures_out >> fw_src->get(DualForwardingSrc::Mem1Stage);
+            reg_wr_src0->out >> fw_src->get(DualForwardingSrc::Wb0Stage);
+            reg_wr_src1->out >> fw_src->get(DualForwardingSrc::Wb1Stage);
+        }
+        funit->ex0_reg1_forwarding_ctrl >> reg1_fw_src0->select;
+        funit->ex0_reg2_forwarding_ctrl >> reg2_fw_src0->select;
+        funit->ex1_reg1_forwarding_ctrl >> reg1_fw_src1->select;
+        funit->ex1_reg2_forwarding_ctrl >> reg2_fw_src1->select;
+
+        // ALU operand multiplexers
+        reg1_fw_src0->out >> alu_op1_src0->get(AluSrc1::REG1);
+        idex0_reg->pc_out >> alu_op1_src0->get(AluSrc1::PC);
+        idex0_reg->alu_op1_ctrl_out >> alu_op1_src0->select;
+
+        reg2_fw_src0->out >> alu_op2_src0->get(AluSrc2::REG2);
+        idex0_reg->imm_out >> alu_op2_src0->get(AluSrc2::IMM);
+        idex0_reg->alu_op2_ctrl_out >> alu_op2_src0->select;
+
+        alu_op1_src0->out >> alu0->op1;
+        alu_op2_src0->out >> alu0->op2;
+        idex0_reg->alu_ctrl_out >> alu0->ctrl;
+        alu0->setProcessor(this);
+
+        reg1_fw_src1->out >> alu_op1_src1->get(AluSrc1::REG1);
+        idex1_reg->pc_out >> alu_op1_src1->get(AluSrc1::PC);
+        idex1_reg->alu_op1_ctrl_out >> alu_op1_src1->select;
+
+        reg2_fw_src1->out >> alu_op2_src1->get(AluSrc2::REG2);
+        idex1_reg->imm_out >> alu_op2_src1->get(AluSrc2::IMM);
+        idex1_reg->alu_op2_ctrl_out >> alu_op2_src1->select;
+
+        alu_op1_src1->out >> alu1->op1;
+        alu_op2_src1->out >> alu1->op2;
+        idex1_reg->alu_ctrl_out >> alu1->ctrl;
+        alu1->setProcessor(this);
+
+        // -----------------------------------------------------------------------
+        // Data memory; accessed only by lane 0
+        exmem0_reg->alures_out >> data_mem->addr;
+        exmem0_reg->mem_do_write_out >> data_mem->wr_en;
+        exmem0_reg->r2_out >> data_mem->data_in;
+        exmem0_reg->mem_op_out >> data_mem->op;
+        data_mem->mem->setMemory(m_memory);
+
+        // -----------------------------------------------------------------------
+        // Ecall checker; ECALLs are only issued to lane 0
+        idex0_reg->opcode_out >> ecallChecker->opcode;
+        ecallChecker->setProcessor(this);
+        hzunit->stallEcallHandling >> ecallChecker->stallEcallHandling;
+
+        // -----------------------------------------------------------------------
+        // IF/ID
+        // Slot 0 is loaded with the deferred instruction of slot 1 upon a pairing conflict. The issueSplit signal
+        // selects the Slot0Src multiplexers, such that Slot0Src enum values must adhere to the boolean 0/1 values.
+        instr_mem0->data_out >> slot0_instr_src->get(Slot0Src::Fetch);
+        ifid1_reg->instr_out >> slot0_instr_src->get(Slot0Src::Deferred);
+        pc_reg->out >> slot0_pc_src->get(Slot0Src::Fetch);
+        ifid1_reg->pc_out >> slot0_pc_src->get(Slot0Src::Deferred);
+        pc_4->out >> slot0_pc4_src->get(Slot0Src::Fetch);
+        ifid1_reg->pc4_out >> slot0_pc4_src->get(Slot0Src::Deferred);
+        for (auto* slot0_src : {slot0_instr_src, slot0_pc_src, slot0_pc4_src}) {
+            hzunit->issueSplit >> slot0_src->select;
+        }
+
+        slot0_pc4_src->out >> ifid0_reg->pc4_in;
+        slot0_pc_src->out >> ifid0_reg->pc_in;
+        slot0_instr_src->out >> ifid0_reg->instr_in;
+        hzunit->hazardFEEnable >> ifid0_reg->enable;
+        efsc_or->out >> ifid0_reg->clear;
+        1 >> ifid0_reg->valid_in;  // Always valid unless register is cleared
+
+        efsc_or->out >> *ifid1_clear_or->in[0];
+        hzunit->issueSplit >> *ifid1_clear_or->in[1];
+
+        pc_8->out >> ifid1_reg->pc4_in;
+        pc_4->out >> ifid1_reg->pc_in;
+        instr_mem1->data_out >> ifid1_reg->instr_in;
+        hzunit->hazardFEEnable >> ifid1_reg->enable;
+        ifid1_clear_or->out >> ifid1_reg->clear;
+        1 >> ifid1_reg->valid_in;  // Always valid unless register is cleared
+
+        // -----------------------------------------------------------------------
+        // ID/EX
+        efschz_or->out >> *idex1_clear_or->in[0];
+        hzunit->issueSplit >> *idex1_clear_or->in[1];
+
+        hzunit->hazardIDEXEnable >> idex0_reg->enable;
+        hzunit->hazardIDEXClear >> idex0_reg->stalled_in;
+        efschz_or->out >> idex0_reg->clear;
+
+        hzunit->hazardIDEXEnable >> idex1_reg->enable;
+        hzunit->hazardIDEXClear >> idex1_reg->stalled_in;
+        idex1_clear_or->out >> idex1_reg->clear;
+
+        // Data
+        ifid0_reg->pc4_out >> idex0_reg->pc4_in;
+        ifid0_reg->pc_out >> idex0_reg->pc_in;
+        0 >> idex0_reg->pred_pc_in;
+        registerFile->r1_out >> idex0_reg->r1_in;
+        registerFile->r2_out >> idex0_reg->r2_in;
+        immediate0->imm >> idex0_reg->imm_in;
+
+        ifid1_reg->pc4_out >> idex1_reg->pc4_in;
+        ifid1_reg->pc_out >> idex1_reg->pc_in;
+        0 >> idex1_reg->pred_pc_in;
+        registerFile->r3_out >> idex1_reg->r1_in;
+        registerFile->r4_out >> idex1_reg->r2_in;
+        immediate1->imm >> idex1_reg->imm_in;
+
+        // Control
+        connectIDEXControl(decode0, control0, ifid0_reg, idex0_reg);
+        connectIDEXControl(decode1, control1, ifid1_reg, idex1_reg);
+
+        // -----------------------------------------------------------------------
+        // EX/MEM
+        hzunit->hazardEXMEMClear >> *mem_stalled_or0->in[0];
+        idex0_reg->stalled_out >> *mem_stalled_or0->in[1];
+        hzunit->hazardEXMEMClear >> *mem_stalled_or1->in[0];
+        idex1_reg->stalled_out >> *mem_stalled_or1->in[1];
+
+        // Data
+        reg2_fw_src0->out >> exmem0_reg->r2_in;
+        alu0->res >> exmem0_reg->alures_in;
+        mem_stalled_or0->out >> exmem0_reg->stalled_in;
+        connectEXMEM(idex0_reg, exmem0_reg);
+
+        reg2_fw_src1->out >> exmem1_reg->r2_in;
+        alu1->res >> exmem1_reg->alures_in;
+        mem_stalled_or1->out >> exmem1_reg->stalled_in;
+        connectEXMEM(idex1_reg, exmem1_reg);
+
+        // -----------------------------------------------------------------------
+        // MEM/WB
+        data_mem->data_out >> memwb0_reg->mem_read_in;
+        connectMEMWB(exmem0_reg, memwb0_reg);
+
+        // Lane 1 does not access data memory
+        0 >> memwb1_reg->mem_read_in;
+        connectMEMWB(exmem1_reg, memwb1_reg);
+
+        // -----------------------------------------------------------------------
+        // Forwarding unit
+        idex0_reg->rd_reg1_idx_out >> funit->ex0_reg1_idx;
+        idex0_reg->rd_reg2_idx_out >> funit->ex0_reg2_idx;
+        idex1_reg->rd_reg1_idx_out >> funit->ex1_reg1_idx;
+        idex1_reg->rd_reg2_idx_out >> funit->ex1_reg2_idx;
+
+        exmem0_reg->wr_reg_idx_out >> funit->mem0_reg_wr_idx;
+        exmem0_reg->reg_do_write_out >> funit->mem0_reg_wr_en;
+        exmem1_reg->wr_reg_idx_out >> funit->mem1_reg_wr_idx;
+        exmem1_reg->reg_do_write_out >> funit->mem1_reg_wr_en;
+
+        memwb0_reg->wr_reg_idx_out >> funit->wb0_reg_wr_idx;
+        memwb0_reg->reg_do_write_out >> funit->wb0_reg_wr_en;
+        memwb1_reg->wr_reg_idx_out >> funit->wb1_reg_wr_idx;
+        memwb1_reg->reg_do_write_out >> funit->wb1_reg_wr_en;
+
+        // -----------------------------------------------------------------------
+        // Hazard detection unit
+        decode0->opcode >> hzunit->id0_opcode;
+        decode0->r1_reg_idx >> hzunit->id0_reg1_idx;
+        decode0->r2_reg_idx >> hzunit->id0_reg2_idx;
+        decode0->wr_reg_idx >> hzunit->id0_reg_wr_idx;
+        control0->reg_do_write_ctrl >> hzunit->id0_do_reg_write;
+
+        ifid1_reg->valid_out >> hzunit->id1_valid;
+        decode1->opcode >> hzunit->id1_opcode;
+        decode1->r1_reg_idx >> hzunit->id1_reg1_idx;
+        decode1->r2_reg_idx >> hzunit->id1_reg2_idx;
+
+        idex0_reg->opcode_out >> hzunit->ex0_opcode;
+        idex0_reg->wr_reg_idx_out >> hzunit->ex0_reg_wr_idx;
+        idex0_reg->mem_do_read_out >> hzunit->ex0_do_mem_read_en;
+        controlflow_or0->out >> hzunit->ex0_controlflow;
+        controlflow_or1->out >> hzunit->ex1_controlflow;
+
+        exmem0_reg->reg_do_write_out >> hzunit->mem0_do_reg_write;
+        exmem1_reg->reg_do_write_out >> hzunit->mem1_do_reg_write;
+        memwb0_reg->reg_do_write_out >> hzunit->wb0_do_reg_write;
+        memwb1_reg->reg_do_write_out >> hzunit->wb1_do_reg_write;
+    }
+
+    // Design subcomponents
+    SUBCOMPONENT(registerFile, DualWriteRegisterFile<true>);
+    SUBCOMPONENT(alu0, ALU);
+    SUBCOMPONENT(alu1, ALU);
+    SUBCOMPONENT(control0, Control);
+    SUBCOMPONENT(control1, Control);
+    SUBCOMPONENT(immediate0, Immediate);
+    SUBCOMPONENT(immediate1, Immediate);
+    SUBCOMPONENT(decode0, Decode);
+    SUBCOMPONENT(decode1, Decode);
+    SUBCOMPONENT(branch0, Branch);
+    SUBCOMPONENT(branch1, Branch);
+    SUBCOMPONENT(pc_4, Adder<RV_REG_WIDTH>);
+    SUBCOMPONENT(pc_8, Adder<RV_REG_WIDTH>);
+
+    // Registers
+    SUBCOMPONENT(pc_reg, RegisterClEn<RV_REG_WIDTH>);
+
+    // Stage seperating registers
+    SUBCOMPONENT(ifid0_reg, IFID);
+    SUBCOMPONENT(ifid1_reg, IFID);
+    SUBCOMPONENT(idex0_reg, RV5S_IDEX);
+    SUBCOMPONENT(idex1_reg, RV5S_IDEX);
+    SUBCOMPONENT(exmem0_reg, RV5S_EXMEM);
+    SUBCOMPONENT(exmem1_reg, RV5S_EXMEM);
+    SUBCOMPONENT(memwb0_reg, RV5S_MEMWB);
+    SUBCOMPONENT(memwb1_reg, RV5S_MEMWB);
+
+    // Multiplexers
+    SUBCOMPONENT(fetch_src, TYPE(EnumMultiplexer<DualFetchSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(slot0_instr_src, TYPE(EnumMultiplexer<Slot0Src, RV_REG_WIDTH>));
+    SUBCOMPONENT(slot0_pc_src, TYPE(EnumMultiplexer<Slot0Src, RV_REG_WIDTH>));
+    SUBCOMPONENT(slot0_pc4_src, TYPE(EnumMultiplexer<Slot0Src, RV_REG_WIDTH>));
+    SUBCOMPONENT(reg_wr_src0, TYPE(EnumMultiplexer<RegWrSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(reg_wr_src1, TYPE(EnumMultiplexer<RegWrSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(pc_src0, TYPE(EnumMultiplexer<PcSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(pc_src1, TYPE(EnumMultiplexer<PcSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(alu_op1_src0, TYPE(EnumMultiplexer<AluSrc1, RV_REG_WIDTH>));
+    SUBCOMPONENT(alu_op1_src1, TYPE(EnumMultiplexer<AluSrc1, RV_REG_WIDTH>));
+    SUBCOMPONENT(alu_op2_src0, TYPE(EnumMultiplexer<AluSrc2, RV_REG_WIDTH>));
+    SUBCOMPONENT(alu_op2_src1, TYPE(EnumMultiplexer<AluSrc2, RV_REG_WIDTH>));
+    SUBCOMPONENT(reg1_fw_src0, TYPE(EnumMultiplexer<DualForwardingSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(reg2_fw_src0, TYPE(EnumMultiplexer<DualForwardingSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(reg1_fw_src1, TYPE(EnumMultiplexer<DualForwardingSrc, RV_REG_WIDTH>));
+    SUBCOMPONENT(reg2_fw_src1, TYPE(EnumMultiplexer<DualForwardingSrc, RV_REG_WIDTH>));
+
+    // Memories
+    SUBCOMPONENT(instr_mem0, TYPE(RVInstrMemory<RV_REG_WIDTH, RV_INSTR_WIDTH>));
+    SUBCOMPONENT(instr_mem1, TYPE(RVInstrMemory<RV_REG_WIDTH, RV_INSTR_WIDTH>));
+    SUBCOMPONENT(data_mem, TYPE(RVMemory<RV_REG_WIDTH, RV_REG_WIDTH>));
+
+    // Forwarding & hazard detection units
+    SUBCOMPONENT(funit, DualForwardingUnit);
+    SUBCOMPONENT(hzunit, DualHazardUnit);
+
+    // Gates
+    // True if branch instruction and branch taken
+    SUBCOMPONENT(br_and0, TYPE(And<1, 2>));
+    SUBCOMPONENT(br_and1, TYPE(And<1, 2>));
+    // True if branch taken or jump instruction
+    SUBCOMPONENT(controlflow_or0, TYPE(Or<1, 2>));
+    SUBCOMPONENT(controlflow_or1, TYPE(Or<1, 2>));
+    // True if either lane redirects the front end
+    SUBCOMPONENT(redirect_or, TYPE(Or<1, 2>));
+    // True if above or performing syscall finishing
+    SUBCOMPONENT(efsc_or, TYPE(Or<1, 2>));
+    // True if above or stalling due to load-use hazard
+    SUBCOMPONENT(efschz_or, TYPE(Or<1, 2>));
+    // Slot 1 of the ID stage and lane 1 of the EX stage are additionally cleared upon a pairing conflict
+    SUBCOMPONENT(ifid1_clear_or, TYPE(Or<1, 2>));
+    SUBCOMPONENT(idex1_clear_or, TYPE(Or<1, 2>));
+
+    SUBCOMPONENT(mem_stalled_or0, TYPE(Or<1, 2>));
+    SUBCOMPONENT(mem_stalled_or1, TYPE(Or<1, 2>));
+
+    // Address spaces
+    ADDRESSSPACE(m_memory);
+    ADDRESSSPACE(m_regMem);
+
+    SUBCOMPONENT(ecallChecker, EcallChecker);
+
+    // Ripes interface compliance
+    virtual const ISAInfoBase* implementsISA() const override { return ISAInfo<ISA::RV32IM>::instance(); }
+    unsigned int stageCount() const override { return STAGECOUNT; }
+    unsigned int getPcForStage(unsigned int idx) const override {
+        // clang-format off
+        switch (idx) {
+            case IF: return pc_reg->out.uValue();
+            case ID1: return ifid1_reg->pc_out.uValue();
+            case ID0: return ifid0_reg->pc_out.uValue();
+            case EX1: return idex1_reg->pc_out.uValue();
+            case EX0: return idex0_reg->pc_out.uValue();
+            case MEM1: return exmem1_reg->pc_out.uValue();
+            case MEM0: return exmem0_reg->pc_out.uValue();
+            case WB1: return memwb1_reg->pc_out.uValue();
+            case WB0: return memwb0_reg->pc_out.uValue();
+            default: assert(false && "Processor does not contain stage");
+        }
+        Q_UNREACHABLE();
+        // clang-format on
+    }
+    unsigned int dataAccessStage() const override { return MEM0; }
+    unsigned int fetchWidth() const override { return 2; }
+    unsigned int retireWidth() const override { return 2; }
+    unsigned int nextFetchedAddress() const override { return fetch_src->out.uValue(); }
+    QString stageName(unsigned int idx) const override {
+        // clang-format off
+        switch (idx) {
+            case IF: return "IF";
+            case ID1: return "ID1";
+            case ID0: return "ID0";
+            case EX1: return "EX1";
+            case EX0: return "EX0";
+            case MEM1: return "MEM1";
+            case MEM0: return "MEM0";
+            case WB1: return "WB1";
+            case WB0: return "WB0";
+            default: assert(false && "Processor does not contain stage");
+        }
+        Q_UNREACHABLE();
+        // clang-format on
+    }
+    StageInfo stageInfo(unsigned int stage) const override {
+        const bool stageValid = stage < STAGECOUNT && (stageValidMask() >> stage) & 1;
+
+        // Gather stage state info
+        StageInfo::State state = StageInfo ::State::None;
+        const bool filled = m_cycleCount > pipelineDepth(stage);
+        switch (stage) {
+            case IF:
+                break;
+            case ID1:
+            case ID0: {
+                const auto* reg = stage == ID0 ? ifid0_reg : ifid1_reg;
+                if (filled && reg->valid_out.uValue() == 0) {
+                    state = StageInfo::State::Flushed;
+                }
+                break;
+            }
+            case EX1:
+            case EX0: {
+                const auto* reg = stage == EX0 ? idex0_reg : idex1_reg;
+                if (reg->stalled_out.uValue() == 1) {
+                    state = StageInfo::State::Stalled;
+                } else if (filled && reg->valid_out.uValue() == 0) {
+                    state = StageInfo::State::Flushed;
+                }
+                break;
+            }
+            case MEM1:
+            case MEM0: {
+                const auto* reg = stage == MEM0 ? exmem0_reg : exmem1_reg;
+                if (reg->stalled_out.uValue() == 1) {
+                    state = StageInfo::State::Stalled;
+                } else if (filled && reg->valid_out.uValue() == 0) {
+                    state = StageInfo::State::Flushed;
+                }
+                break;
+            }
+            case WB1:
+            case WB0: {
+                const auto* reg = stage == WB0 ? memwb0_reg : memwb1_reg;
+                if (reg->stalled_out.uValue() == 1) {
+                    state = StageInfo::State::Stalled;
+                } else if (filled && reg->valid_out.uValue() == 0) {
+                    state = StageInfo::State::Flushed;
+                }
+                break;
+            }
+        }
+
+        return StageInfo({getPcForStage(stage), stageValid, state});
+    }
+
+    void setProgramCounter(uint32_t address) override {
+        pc_reg->forceValue(0, address);
+        propagateDesign();
+        invalidateStageValidity();
+    }
+    void setPCInitialValue(uint32_t address) override { pc_reg->setInitValue(address); }
+    SparseArray& getMemory() override { return *m_memory; }
+    unsigned int getRegister(unsigned i) const override { return registerFile->getRegister(i); }
+    SparseArray& getArchRegisters() override { return *m_regMem; }
+    void finalize(const FinalizeReason& fr) override {
+        if (fr.exitSyscall && !ecallChecker->isSysCallExiting()) {
+            // An exit system call was executed. Record the cycle of the execution, and enable the ecallChecker's system
+            // call exiting signal.
+            m_syscallExitCycle = m_cycleCount;
+        }
+        ecallChecker->setSysCallExiting(ecallChecker->isSysCallExiting() || fr.exitSyscall);
+        invalidateStageValidity();
+    }
+
+    const Component* getDataMemory() const override { return data_mem; }
+    const Component* getInstrMemory() const override { return instr_mem0; }
+    void setMMIODevices(MMIODevices* devices) override { data_mem->setDevices(devices); }
+    void memoryModified() override {
+        instr_mem0->invalidate();
+        instr_mem1->invalidate();
+    }
+
+    bool finished() const override {
+        // The processor is finished when there are no more valid instructions in the pipeline
+        return stageValidMask() == 0;
+    }
+
+    void setRegister(unsigned i, uint32_t v) override { setSynchronousValue(registerFile->_wr1_mem, i, v); }
+
+    void clock() override {
+        // Up to two instructions are retired in each cycle; one for each valid lane of the WB stage with a PC within
+        // the executable range of the program
+        m_instructionsRetired += retiringInstructions();
+        if (data_mem->wr_en.uValue()) {
+            instr_mem0->invalidate(data_mem->addr.uValue(), 4);
+            instr_mem1->invalidate(data_mem->addr.uValue(), 4);
+        }
+        RipesProcessor::clock();
+    }
+
+    void reverse() override {
+        if (m_syscallExitCycle != -1 && (m_cycleCount - 1) == m_syscallExitCycle) {
+            // We are about to undo an exit syscall instruction. In this case, the syscall exiting sequence should
+            // be terminate
+            ecallChecker->setSysCallExiting(false);
+            m_syscallExitCycle = -1;
+        }
+        invalidateStageValidity();
+        // The store being reversed is not known until the processor has been reversed
+        memoryModified();
+        RipesProcessor::reverse();
+        m_instructionsRetired -= retiringInstructions();
+    }
+
+    void reset() override {
+        ecallChecker->setSysCallExiting(false);
+        invalidateStageValidity();
+        RipesProcessor::reset();
+        m_syscallExitCycle = -1;
+    }
+
+    void saveCheckpoint(ProcessorCheckpoint& checkpoint) override {
+        RipesProcessor::saveCheckpoint(checkpoint);
+        checkpoint.processorState = {m_syscallExitCycle, ecallChecker->isSysCallExiting()};
+    }
+
+    void restoreCheckpoint(const ProcessorCheckpoint& checkpoint) override {
+        RipesProcessor::restoreCheckpoint(checkpoint);
+        m_syscallExitCycle = checkpoint.processorState.at(0);
+        ecallChecker->setSysCallExiting(checkpoint.processorState.at(1));
+        invalidateStageValidity();
+    }
+
+private:
+    template <typename Decode_t, typename Control_t, typename IFID_t, typename IDEX_t>
+    static void connectIDEXControl(Decode_t* decode, Control_t* control, IFID_t* ifid, IDEX_t* idex) {
+        decode->wr_reg_idx >> idex->wr_reg_idx_in;
+        control->reg_wr_src_ctrl >> idex->reg_wr_src_ctrl_in;
+        control->reg_do_write_ctrl >> idex->reg_do_write_in;
+        control->alu_op1_ctrl >> idex->alu_op1_ctrl_in;
+        control->alu_op2_ctrl >> idex->alu_op2_ctrl_in;
+        control->mem_do_write_ctrl >> idex->mem_do_write_in;
+        control->alu_ctrl >> idex->alu_ctrl_in;
+        control->mem_ctrl >> idex->mem_op_in;
+        control->comp_ctrl >> idex->br_op_in;
+        control->do_branch >> idex->do_br_in;
+        control->do_jump >> idex->do_jmp_in;
+        decode->r1_reg_idx >> idex->rd_reg1_idx_in;
+        decode->r2_reg_idx >> idex->rd_reg2_idx_in;
+        decode->opcode >> idex->opcode_in;
+        control->mem_do_read_ctrl >> idex->mem_do_read_in;
+
+        ifid->valid_out >> idex->valid_in;
+    }
+
+    template <typename IDEX_t, typename EXMEM_t>
+    void connectEXMEM(IDEX_t* idex, EXMEM_t* exmem) {
+        1 >> exmem->enable;
+        hzunit->hazardEXMEMClear >> exmem->clear;
+
+        // Data
+        idex->pc_out >> exmem->pc_in;
+        idex->pc4_out >> exmem->pc4_in;
+
+        // Control
+        idex->reg_wr_src_ctrl_out >> exmem->reg_wr_src_ctrl_in;
+        idex->wr_reg_idx_out >> exmem->wr_reg_idx_in;
+        idex->reg_do_write_out >> exmem->reg_do_write_in;
+        idex->mem_do_write_out >> exmem->mem_do_write_in;
+        idex->mem_do_read_out >> exmem->mem_do_read_in;
+        idex->mem_op_out >> exmem->mem_op_in;
+
+        idex->valid_out >> exmem->valid_in;
+    }
+
+    template <typename EXMEM_t, typename MEMWB_t>
+    static void connectMEMWB(EXMEM_t* exmem, MEMWB_t* memwb) {
+        exmem->stalled_out >> memwb->stalled_in;
+
+        // Data
+        exmem->pc_out >> memwb->pc_in;
+        exmem->pc4_out >> memwb->pc4_in;
+        exmem->alures_out >> memwb->alures_in;
+
+        // Control
+        exmem->reg_wr_src_ctrl_out >> memwb->reg_wr_src_ctrl_in;
+        exmem->wr_reg_idx_out >> memwb->wr_reg_idx_in;
+        exmem->reg_do_write_out >> memwb->reg_do_write_in;
+
+        exmem->valid_out >> memwb->valid_in;
+    }
+
+    /// @returns the number of instructions which are retired when clocking the current cycle
+    int retiringInstructions() const {
+        int retiring = 0;
+        for (const auto* memwb : {memwb0_reg, memwb1_reg}) {
+            if (memwb->valid_out.uValue() != 0 && isExecutableAddress(memwb->pc_out.uValue())) {
+                retiring++;
+            }
+        }
+        return retiring;
+    }
+
+    /// @returns the number of cycles from an instruction being fetched until it reaches @p stage
+    static unsigned pipelineDepth(unsigned stage) { return (stage + 1) / 2; }
+
+    /**
+     * @brief m_syscallExitCycle
+     * The variable will contain the cycle of which an exit system call was executed. From this, we may determine
+     * when we roll back an exit system call during rewinding.
+     */
+    long long m_syscallExitCycle = -1;
+
+    /**
+     * @brief stageValidMask
+     * @returns a mask with bit i set if stage i currently carries a valid instruction.
+     */
+    unsigned stageValidMask() const {
+        return m_stageValidity.mask(m_cycleCount, [this] { return computeStageValidMask(); });
+    }
+    void invalidateStageValidity() { m_stageValidity.invalidate(); }
+
+    unsigned computeStageValidMask() const {
+        // A stage is valid if it has not been cleared, and is carrying a valid (executable) PC
+        const auto valid = [&](const auto* reg) {
+            return reg->valid_out.uValue() && isExecutableAddress(reg->pc_out.uValue());
+        };
+        unsigned mask = 0;
+        mask |= isExecutableAddress(pc_reg->out.uValue()) << IF;
+        mask |= valid(ifid1_reg) << ID1;
+        mask |= valid(ifid0_reg) << ID0;
+        mask |= valid(idex1_reg) << EX1;
+        mask |= valid(idex0_reg) << EX0;
+        mask |= valid(exmem1_reg) << MEM1;
+        mask |= valid(exmem0_reg) << MEM0;
+        mask |= valid(memwb1_reg) << WB1;
+        mask |= valid(memwb0_reg) << WB0;
+
+        // Are we currently clearing the pipeline due to a syscall exit? if such, all stages before the EX stage are
+        // invalid
+        if (ecallChecker->isSysCallExiting()) {
+            mask &= ~((1u << IF) | (1u << ID1) | (1u << ID0));
+        }
+
+        // Has the pipeline been filled up to the stage?
+        for (unsigned stage = 0; stage < STAGECOUNT; stage++) {
+            if (pipelineDepth(stage) > m_cycleCount) {
+                mask &= ~(1u << stage);
+            }
+        }
+        return mask;
+    }
+
+    StageValidityCache m_stageValidity;
+};
+
+}  // namespace core
+}  // namespace vsrtl
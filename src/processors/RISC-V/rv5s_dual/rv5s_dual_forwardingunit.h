@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../riscv.h"
+
+#include "VSRTL/core/vsrtl_component.h"
+
+namespace Ripes {
+Enum(DualForwardingSrc, IdStage, Mem0Stage, Mem1Stage, Wb0Stage, Wb1Stage);
+}
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The DualForwardingUnit class
+ * Forwarding unit of the dual-issue processor. Each operand of the two EX stage lanes is forwarded from the youngest
+ * instruction in the MEM and WB stages writing the operand register. Within a stage, lane 1 carries the younger
+ * instruction. The instructions of a pair are never dependent on each other, such that no forwarding is performed
+ * between the lanes of the EX stage.
+ */
+class DualForwardingUnit : public Component {
+public:
+    DualForwardingUnit(std::string name, SimComponent* parent) : Component(name, parent) {
+        ex0_reg1_forwarding_ctrl << [=] { return forwardingSrc(ex0_reg1_idx.uValue()); };
+        ex0_reg2_forwarding_ctrl << [=] { return forwardingSrc(ex0_reg2_idx.uValue()); };
+        ex1_reg1_forwarding_ctrl << [=] { return forwardingSrc(ex1_reg1_idx.uValue()); };
+        ex1_reg2_forwarding_ctrl << [=] { return forwardingSrc(ex1_reg2_idx.uValue()); };
+    }
+
+    INPUTPORT(ex0_reg1_idx, RV_REGS_BITS);
+    INPUTPORT(ex0_reg2_idx, RV_REGS_BITS);
+    INPUTPORT(ex1_reg1_idx, RV_REGS_BITS);
+    INPUTPORT(ex1_reg2_idx, RV_REGS_BITS);
+
+    INPUTPORT(mem0_reg_wr_idx, RV_REGS_BITS);
+    INPUTPORT(mem0_reg_wr_en, 1);
+    INPUTPORT(mem1_reg_wr_idx, RV_REGS_BITS);
+    INPUTPORT(mem1_reg_wr_en, 1);
+
+    INPUTPORT(wb0_reg_wr_idx, RV_REGS_BITS);
+    INPUTPORT(wb0_reg_wr_en, 1);
+    INPUTPORT(wb1_reg_wr_idx, RV_REGS_BITS);
+    INPUTPORT(wb1_reg_wr_en, 1);
+
+    OUTPUTPORT_ENUM(ex0_reg1_forwarding_ctrl, DualForwardingSrc);
+    OUTPUTPORT_ENUM(ex0_reg2_forwarding_ctrl, DualForwardingSrc);
+    OUTPUTPORT_ENUM(ex1_reg1_forwarding_ctrl, DualForwardingSrc);
+    OUTPUTPORT_ENUM(ex1_reg2_forwarding_ctrl, DualForwardingSrc);
+
+private:
+    VSRTL_VT_U forwardingSrc(unsigned idx) const {
+        if (idx == 0) {
+            return DualForwardingSrc::IdStage;
+        } else if (idx == mem1_reg_wr_idx.uValue() && mem1_reg_wr_en.uValue()) {
+            return DualForwardingSrc::Mem1Stage;
+        } else if (idx == mem0_reg_wr_idx.uValue() && mem0_reg_wr_en.uValue()) {
+            return DualForwardingSrc::Mem0Stage;
+        } else if (idx == wb1_reg_wr_idx.uValue() && wb1_reg_wr_en.uValue()) {
+            return DualForwardingSrc::Wb1Stage;
+        } else if (idx == wb0_reg_wr_idx.uValue() && wb0_reg_wr_en.uValue()) {
+            return DualForwardingSrc::Wb0Stage;
+        } else {
+            return DualForwardingSrc::IdStage;
+        }
+    }
+};
+}  // namespace core
+}  // namespace vsrtl
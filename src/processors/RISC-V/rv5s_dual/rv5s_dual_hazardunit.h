@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../riscv.h"
+
+#include "VSRTL/core/vsrtl_component.h"
+
+namespace Ripes {
+// Address fetched in the following cycle: the pair following the fetched pair, or the resolved address following the
+// control-flow instruction in lane 0 or 1 of the EX stage
+Enum(DualFetchSrc, Pair, Ex0, Ex1);
+// Instruction latched into slot 0 of the IF/ID register: the first fetched instruction, or the instruction in slot 1 of
+// the ID stage, which was deferred by a pairing conflict. Values must adhere to the boolean 0/1 values.
+Enum(Slot0Src, Fetch = 0, Deferred = 1);
+}  // namespace Ripes
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The DualHazardUnit class
+ * Hazard detection and issue unit of the dual-issue processor. The instructions of the two slots in the ID stage are
+ * issued together to lanes 0 and 1 of the EX stage, unless they conflict as per the pairing rules:
+ * - slot 1 may not read the register written by slot 0,
+ * - slot 1 may not access data memory, which is only accessible from lane 0,
+ * - neither slot may hold an ECALL, which is issued alone to lane 0,
+ * - slot 0 may not hold a control-flow instruction, given that slot 1 holds its fall-through instruction.
+ * Upon a conflict, slot 0 is issued alone to lane 0, and slot 1 is deferred into slot 0 of the ID stage, from which it
+ * is issued in the following cycle. The fetch of the following pair is repeated meanwhile.
+ */
+class DualHazardUnit : public Component {
+public:
+    DualHazardUnit(std::string name, SimComponent* parent) : Component(name, parent) {
+        hazardFEEnable << [=] { return !hasHazard(); };
+        hazardPCEnable << [=] { return !hasHazard() && !hasPairingConflict(); };
+        hazardIDEXEnable << [=] { return !hasEcallHazard(); };
+        hazardIDEXClear << [=] { return hasLoadUseHazard(); };
+        hazardEXMEMClear << [=] { return hasEcallHazard(); };
+        issueSplit << [=] { return hasPairingConflict(); };
+        stallEcallHandling << [=] { return hasEcallHazard(); };
+
+        fetch_src_ctrl << [=] {
+            if (ex0_controlflow.uValue()) {
+                return DualFetchSrc::Ex0;
+            } else if (ex1_controlflow.uValue()) {
+                return DualFetchSrc::Ex1;
+            } else {
+                return DualFetchSrc::Pair;
+            }
+        };
+    }
+
+    // Slots 0 and 1 of the ID stage
+    INPUTPORT_ENUM(id0_opcode, RVInstr);
+    INPUTPORT(id0_reg1_idx, RV_REGS_BITS);
+    INPUTPORT(id0_reg2_idx, RV_REGS_BITS);
+    INPUTPORT(id0_reg_wr_idx, RV_REGS_BITS);
+    INPUTPORT(id0_do_reg_write, 1);
+
+    INPUTPORT(id1_valid, 1);
+    INPUTPORT_ENUM(id1_opcode, RVInstr);
+    INPUTPORT(id1_reg1_idx, RV_REGS_BITS);
+    INPUTPORT(id1_reg2_idx, RV_REGS_BITS);
+
+    // Lane 0 of the EX stage, and whether the instructions of either lane redirect the front end
+    INPUTPORT_ENUM(ex0_opcode, RVInstr);
+    INPUTPORT(ex0_reg_wr_idx, RV_REGS_BITS);
+    INPUTPORT(ex0_do_mem_read_en, 1);
+    INPUTPORT(ex0_controlflow, 1);
+    INPUTPORT(ex1_controlflow, 1);
+
+    INPUTPORT(mem0_do_reg_write, 1);
+    INPUTPORT(mem1_do_reg_write, 1);
+    INPUTPORT(wb0_do_reg_write, 1);
+    INPUTPORT(wb1_do_reg_write, 1);
+
+    // Hazard Front End enable: Low when stalling the IF/ID register (shall be connected to a register 'enable' input
+    // port).
+    OUTPUTPORT(hazardFEEnable, 1);
+    // Hazard PC enable: as above, and additionally low whilst repeating the fetch of a pair due to a pairing conflict
+    OUTPUTPORT(hazardPCEnable, 1);
+
+    // Hazard IDEX enable: Low when stalling due to an ECALL hazard
+    OUTPUTPORT(hazardIDEXEnable, 1);
+    // IDEX clear: High when a load-use hazard is detected
+    OUTPUTPORT(hazardIDEXClear, 1);
+    // EXMEM clear: High when an ECALL hazard is detected
+    OUTPUTPORT(hazardEXMEMClear, 1);
+
+    // Issue split: High when slot 0 of the ID stage is issued alone, and slot 1 is deferred. Lane 1 of the EX stage and
+    // slot 1 of the ID stage shall be cleared, and slot 0 of the ID stage loaded with the deferred instruction.
+    OUTPUTPORT(issueSplit, 1);
+
+    OUTPUTPORT_ENUM(fetch_src_ctrl, DualFetchSrc);
+
+    // Stall Ecall Handling: High whenever we are about to handle an ecall, but have outstanding writes in the pipeline
+    // which must be comitted to the register file before handling the ecall.
+    OUTPUTPORT(stallEcallHandling, 1);
+
+private:
+    static bool isControlFlow(unsigned opcode) {
+        switch (opcode) {
+            case RVInstr::JAL:
+            case RVInstr::JALR:
+            case RVInstr::BEQ:
+            case RVInstr::BNE:
+            case RVInstr::BLT:
+            case RVInstr::BGE:
+            case RVInstr::BLTU:
+            case RVInstr::BGEU:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static bool isMemoryAccess(unsigned opcode) {
+        switch (opcode) {
+            case RVInstr::LB:
+            case RVInstr::LH:
+            case RVInstr::LW:
+            case RVInstr::LBU:
+            case RVInstr::LHU:
+            case RVInstr::SB:
+            case RVInstr::SH:
+            case RVInstr::SW:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Instructions in the ID stage are flushed if the front end is redirected, in which case no hazards apply to them
+    bool isRedirecting() const { return ex0_controlflow.uValue() || ex1_controlflow.uValue(); }
+
+    bool hasHazard() const { return hasLoadUseHazard() || hasEcallHazard(); }
+
+    bool hasPairingConflict() const {
+        if (!id1_valid.uValue() || isRedirecting() || hasHazard()) {
+            return false;
+        }
+        const unsigned op0 = id0_opcode.uValue();
+        const unsigned op1 = id1_opcode.uValue();
+        if (isControlFlow(op0) || op0 == RVInstr::ECALL || op1 == RVInstr::ECALL || isMemoryAccess(op1)) {
+            return true;
+        }
+        const unsigned wridx = id0_reg_wr_idx.uValue();
+        return id0_do_reg_write.uValue() && wridx != 0 &&
+               (wridx == id1_reg1_idx.uValue() || wridx == id1_reg2_idx.uValue());
+    }
+
+    bool hasLoadUseHazard() const {
+        if (!ex0_do_mem_read_en.uValue() || isRedirecting()) {
+            return false;
+        }
+        const unsigned exidx = ex0_reg_wr_idx.uValue();
+        const bool slot0 = exidx == id0_reg1_idx.uValue() || exidx == id0_reg2_idx.uValue();
+        const bool slot1 = id1_valid.uValue() && (exidx == id1_reg1_idx.uValue() || exidx == id1_reg2_idx.uValue());
+        return slot0 || slot1;
+    }
+
+    bool hasEcallHazard() const {
+        // As for the single-issue processor, all outstanding writes to the register file must be performed before
+        // handling an ECALL. ECALLs are only issued to lane 0.
+        const bool isEcall = ex0_opcode.uValue() == RVInstr::ECALL;
+        return isEcall && (mem0_do_reg_write.uValue() || mem1_do_reg_write.uValue() || wb0_do_reg_write.uValue() ||
+                           wb1_do_reg_write.uValue());
+    }
+};
+}  // namespace core
+}  // namespace vsrtl
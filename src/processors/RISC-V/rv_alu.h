@@ -2,6 +2,7 @@
 
 #include <math.h>
 
+#include "../ripesprocessor.h"
 #include "riscv.h"
 
 #include "VSRTL/core/vsrtl_component.h"
@@ -95,6 +96,10 @@ public:
                 case ALUOp::LTU:
                     return static_cast<uint32_t>(op1.uValue() < op2.uValue() ? 1 : 0);
 
+                case ALUOp::CSR:
+                    // CSR instructions read the CSR given by op2. Writes to the read-only counters are ignored.
+                    return m_processor ? m_processor->readCSR(op2.uValue() & 0xFFF) : 0;
+
                 case ALUOp::NOP:
                     return 0xDEADBEEF;
 
@@ -104,11 +109,20 @@ public:
         };
     }
 
+    /**
+     * @brief setProcessor
+     * Sets the processor whose CSRs are read by CSR instructions executing in the ALU.
+     */
+    void setProcessor(const RipesProcessor* processor) { m_processor = processor; }
+
     INPUTPORT_ENUM(ctrl, ALUOp);
     INPUTPORT(op1, RV_REG_WIDTH);
     INPUTPORT(op2, RV_REG_WIDTH);
 
     OUTPUTPORT(res, RV_REG_WIDTH);
+
+private:
+    const RipesProcessor* m_processor = nullptr;
 };
 
 }  // namespace core
@@ -0,0 +1,303 @@
+#pragma once
+
+#include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_register.h"
+
+#include "../../binutils.h"
+#include "../ripesprocessor.h"
+#include "riscv.h"
+#include "rv_instrparser.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The BranchPredictor class
+ * Predicts the address fetched after each instruction from the instruction word and its address, which are available
+ * in the fetch stage. Conditional branch and JAL targets are computed by predecoding the instruction; the BTB
+ * additionally predicts JALR targets. Direction state (counters, global history, BTB entries) is trained with the
+ * outcome of each resolved control-flow instruction.
+ * The predictor is clocked alongside the processor upon every cycle, such that it may be reversed alongside the
+ * reverse stacks of the design.
+ */
+class BranchPredictor {
+public:
+    enum class Type {
+        // Always predicts the fall-through path (ie. no prediction)
+        NotTaken,
+        // Static backward taken/forward not taken; JAL is predicted taken
+        BTFN,
+        // Table of 2-bit saturating counters indexed by the PC
+        Bimodal,
+        // Table of 2-bit saturating counters indexed by the PC XOR'ed with the global branch history
+        GShare,
+        // Branch target buffer; predicts any control-flow instruction which was last taken to its previous target
+        BTB
+    };
+
+    /**
+     * @brief The Outcome struct
+     * The resolution of a control-flow instruction, as determined in the stage which resolves control flow.
+     */
+    struct Outcome {
+        uint32_t pc = 0;
+        uint32_t target = 0;
+        bool conditional = false;
+        bool taken = false;
+        bool mispredicted = false;
+    };
+
+    static constexpr unsigned s_counterBits = 10;
+    static constexpr unsigned s_historyBits = s_counterBits;
+    static constexpr unsigned s_btbBits = 6;
+
+    /**
+     * @brief BranchPredictor
+     * @param mispredictionPenalty: number of cycles flushed upon a misprediction. Taken control-flow instructions cost
+     * this many cycles without prediction, from which the flush cycles saved by prediction are derived.
+     */
+    BranchPredictor(unsigned mispredictionPenalty) : m_mispredictionPenalty(mispredictionPenalty) { reset(); }
+
+    void setType(Type type) {
+        m_type = type;
+        reset();
+    }
+    Type getType() const { return m_type; }
+
+    /**
+     * @brief predict
+     * @returns the predicted address of the instruction following instruction @p instr at address @p pc.
+     */
+    uint32_t predict(uint32_t pc, uint32_t instr) const {
+        const uint32_t fallthrough = pc + 4;
+        const uint32_t opcode = bitField<0, 7>(instr);
+        const bool isBranch = opcode == s_branchOpcode && (bitField<12, 3>(instr) & 0b110) != 0b010;
+        switch (m_type) {
+            case Type::NotTaken:
+                return fallthrough;
+            case Type::BTFN:
+                if (opcode == s_jalOpcode) {
+                    return pc + jalOffset(instr);
+                }
+                if (isBranch && branchOffset(instr) < 0) {
+                    return pc + branchOffset(instr);
+                }
+                return fallthrough;
+            case Type::Bimodal:
+            case Type::GShare:
+                if (opcode == s_jalOpcode) {
+                    return pc + jalOffset(instr);
+                }
+                if (isBranch && m_counters.at(counterIndex(pc)) >= s_weaklyTaken) {
+                    return pc + branchOffset(instr);
+                }
+                return fallthrough;
+            case Type::BTB: {
+                const BTBEntry& entry = m_btb.at(btbIndex(pc));
+                return entry.valid && entry.tag == pc ? entry.target : fallthrough;
+            }
+        }
+        return fallthrough;
+    }
+
+    /**
+     * @brief clock
+     * Trains the predictor with @p outcome, the control-flow instruction resolved in the cycle being clocked, if any.
+     */
+    void clock(const Outcome* outcome) {
+        Undo undo;
+        undo.statistics = m_statistics;
+        undo.history = m_history;
+        if (outcome) {
+            undo.counterIndex = counterIndex(outcome->pc);
+            undo.btbIndex = btbIndex(outcome->pc);
+            undo.counter = m_counters.empty() ? 0 : m_counters.at(undo.counterIndex);
+            undo.btbEntry = m_btb.empty() ? BTBEntry() : m_btb.at(undo.btbIndex);
+            train(*outcome);
+        }
+        m_undoStack.push_front(undo);
+        if (m_undoStack.size() > ClockedComponent::reverseStackSize()) {
+            m_undoStack.pop_back();
+        }
+    }
+
+    void reverse() {
+        if (m_undoStack.empty()) {
+            return;
+        }
+        const Undo& undo = m_undoStack.front();
+        if (!m_counters.empty()) {
+            m_counters.at(undo.counterIndex) = undo.counter;
+        }
+        if (!m_btb.empty()) {
+            m_btb.at(undo.btbIndex) = undo.btbEntry;
+        }
+        m_history = undo.history;
+        m_statistics = undo.statistics;
+        m_undoStack.pop_front();
+    }
+
+    void reset() {
+        const bool counters = m_type == Type::Bimodal || m_type == Type::GShare;
+        m_counters.assign(counters ? 1u << s_counterBits : 0, s_weaklyNotTaken);
+        m_btb.assign(m_type == Type::BTB ? 1u << s_btbBits : 0, BTBEntry());
+        m_history = 0;
+        m_statistics = BranchPredictionStatistics();
+        m_undoStack.clear();
+    }
+
+    const BranchPredictionStatistics& getStatistics() const { return m_statistics; }
+    void setStatistics(const BranchPredictionStatistics& statistics) { m_statistics = statistics; }
+
+    /**
+     * @brief saveState/restoreState
+     * Appends the prediction tables and global history to @p state, or restores them from @p state starting at
+     * @p offset. Restoring clears the undo stack; the predictor cannot be reversed past the restored state.
+     */
+    void saveState(std::vector<long long>& state) const {
+        state.push_back(m_history);
+        for (unsigned i = 0; i < m_counters.size(); i += s_countersPerWord) {
+            unsigned long long word = 0;
+            for (unsigned j = 0; j < s_countersPerWord; j++) {
+                word |= static_cast<unsigned long long>(m_counters.at(i + j)) << (2 * j);
+            }
+            state.push_back(static_cast<long long>(word));
+        }
+        for (const auto& entry : m_btb) {
+            // Entries are word aligned, such that an invalid entry cannot be mistaken for a valid one
+            const unsigned long long word = (static_cast<unsigned long long>(entry.tag) << 32) | entry.target;
+            state.push_back(entry.valid ? static_cast<long long>(word) : s_invalidBTBEntry);
+        }
+    }
+    void restoreState(const std::vector<long long>& state, size_t offset) {
+        m_history = static_cast<uint32_t>(state.at(offset++));
+        for (unsigned i = 0; i < m_counters.size(); i += s_countersPerWord) {
+            const auto word = static_cast<unsigned long long>(state.at(offset++));
+            for (unsigned j = 0; j < s_countersPerWord; j++) {
+                m_counters.at(i + j) = (word >> (2 * j)) & 0b11;
+            }
+        }
+        for (auto& entry : m_btb) {
+            const long long word = state.at(offset++);
+            entry.valid = word != s_invalidBTBEntry;
+            entry.tag = entry.valid ? static_cast<uint32_t>(static_cast<unsigned long long>(word) >> 32) : 0;
+            entry.target = entry.valid ? static_cast<uint32_t>(word) : 0;
+        }
+        m_undoStack.clear();
+    }
+
+private:
+    struct BTBEntry {
+        bool valid = false;
+        uint32_t tag = 0;
+        uint32_t target = 0;
+    };
+
+    struct Undo {
+        BranchPredictionStatistics statistics;
+        uint32_t history = 0;
+        unsigned counterIndex = 0;
+        uint8_t counter = 0;
+        unsigned btbIndex = 0;
+        BTBEntry btbEntry;
+    };
+
+    static constexpr uint32_t s_branchOpcode = 0b1100011;
+    static constexpr uint32_t s_jalOpcode = 0b1101111;
+    static constexpr uint8_t s_weaklyNotTaken = 0b01;
+    static constexpr uint8_t s_weaklyTaken = 0b10;
+    static constexpr unsigned s_countersPerWord = 32;
+    static constexpr long long s_invalidBTBEntry = -1;
+    static_assert((1u << s_counterBits) % s_countersPerWord == 0, "Counters must pack into whole words");
+
+    static int32_t branchOffset(uint32_t instr) { return signextend<int32_t, 13>(immediate(decodeBInstr(instr))); }
+    static int32_t jalOffset(uint32_t instr) { return signextend<int32_t, 21>(immediate(decodeJInstr(instr))); }
+
+    unsigned counterIndex(uint32_t pc) const {
+        const uint32_t index = m_type == Type::GShare ? (pc >> 2) ^ m_history : pc >> 2;
+        return index & ((1u << s_counterBits) - 1);
+    }
+    unsigned btbIndex(uint32_t pc) const { return (pc >> 2) & ((1u << s_btbBits) - 1); }
+
+    void train(const Outcome& outcome) {
+        m_statistics.predictions++;
+        if (outcome.mispredicted) {
+            m_statistics.mispredictions++;
+            m_statistics.flushCyclesSaved -= m_mispredictionPenalty;
+        }
+        if (outcome.taken) {
+            m_statistics.flushCyclesSaved += m_mispredictionPenalty;
+        }
+
+        if (!m_counters.empty() && outcome.conditional) {
+            uint8_t& counter = m_counters.at(counterIndex(outcome.pc));
+            counter = outcome.taken ? std::min<uint8_t>(counter + 1, 0b11) : std::max<uint8_t>(counter, 1) - 1;
+            m_history = ((m_history << 1) | outcome.taken) & ((1u << s_historyBits) - 1);
+        }
+
+        if (!m_btb.empty()) {
+            BTBEntry& entry = m_btb.at(btbIndex(outcome.pc));
+            if (outcome.taken) {
+                entry = {true, outcome.pc, outcome.target};
+            } else if (entry.tag == outcome.pc) {
+                entry.valid = false;
+            }
+        }
+    }
+
+    const unsigned m_mispredictionPenalty;
+    Type m_type = Type::NotTaken;
+    std::vector<uint8_t> m_counters;
+    std::vector<BTBEntry> m_btb;
+    uint32_t m_history = 0;
+    BranchPredictionStatistics m_statistics;
+    std::deque<Undo> m_undoStack;
+};
+
+/**
+ * @brief The BranchPredictionUnit class
+ * Selects the next fetched address. In the absence of a misprediction, the address predicted for the fetched
+ * instruction is fetched. The predicted address is carried alongside the instruction to the stage in which control flow
+ * is resolved; if the resolved address differs, the instruction was mispredicted, and fetching is redirected to the
+ * resolved address.
+ */
+class BranchPredictionUnit : public Component {
+public:
+    BranchPredictionUnit(std::string name, SimComponent* parent) : Component(name, parent) {
+        pred_pc << [=] { return m_predictor.predict(if_pc.uValue(), if_instr.uValue()); };
+        mispredict << [=] { return isMispredicted(); };
+        next_pc << [=] {
+            return isMispredicted() ? ex_resolved_pc.uValue()
+                                    : m_predictor.predict(if_pc.uValue(), if_instr.uValue());
+        };
+    }
+
+    BranchPredictor& predictor() { return m_predictor; }
+    const BranchPredictor& predictor() const { return m_predictor; }
+
+    INPUTPORT(if_pc, RV_REG_WIDTH);
+    INPUTPORT(if_instr, RV_INSTR_WIDTH);
+
+    // Address predicted to follow the instruction in the resolving stage, and the resolved address
+    INPUTPORT(ex_pred_pc, RV_REG_WIDTH);
+    INPUTPORT(ex_resolved_pc, RV_REG_WIDTH);
+
+    // Predicted address following the fetched instruction
+    OUTPUTPORT(pred_pc, RV_REG_WIDTH);
+    OUTPUTPORT(mispredict, 1);
+    OUTPUTPORT(next_pc, RV_REG_WIDTH);
+
+private:
+    bool isMispredicted() const { return ex_resolved_pc.uValue() != ex_pred_pc.uValue(); }
+
+    // The IF and ID stages are flushed upon a misprediction
+    BranchPredictor m_predictor = BranchPredictor(2);
+};
+
+}  // namespace core
+}  // namespace vsrtl
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../../defines.h"
+#include "rv_instrparser.h"
+
+namespace Ripes {
+
+/** RV32C standard extension
+ * Compressed instructions are 16-bit encodings of common RV32I instructions, identified by the two least significant
+ * bits of the instruction being anything but 0b11. Each compressed instruction is expanded into its 32-bit
+ * equivalent, such that only fetch and the program counter increment need to be aware of the extension.
+ */
+
+/// @returns the size in bytes of the instruction whose least significant halfword is @p instr
+constexpr unsigned instructionLength(const uint32_t instr) {
+    return (instr & 0b11) == 0b11 ? 4 : 2;
+}
+
+namespace rvc {
+
+/// @returns @p value sign extended from its @p bits least significant bits
+constexpr uint32_t signExtend(const uint32_t value, const unsigned bits) {
+    const uint32_t sign = 1u << (bits - 1);
+    return ((value & ((sign << 1) - 1)) ^ sign) - sign;
+}
+
+/** 32-bit instruction encoders, the inverses of the field extractors of rv_instrparser.h */
+constexpr uint32_t encodeR(uint32_t opcode, uint32_t rd, uint32_t funct3, uint32_t rs1, uint32_t rs2, uint32_t funct7) {
+    return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+constexpr uint32_t encodeI(uint32_t opcode, uint32_t rd, uint32_t funct3, uint32_t rs1, uint32_t imm) {
+    return ((imm & 0xfff) << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+constexpr uint32_t encodeS(uint32_t opcode, uint32_t funct3, uint32_t rs1, uint32_t rs2, uint32_t imm) {
+    return (bitField<5, 7>(imm) << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (bitField<0, 5>(imm) << 7) |
+           opcode;
+}
+constexpr uint32_t encodeB(uint32_t opcode, uint32_t funct3, uint32_t rs1, uint32_t rs2, uint32_t imm) {
+    return (bitField<12, 1>(imm) << 31) | (bitField<5, 6>(imm) << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) |
+           (bitField<1, 4>(imm) << 8) | (bitField<11, 1>(imm) << 7) | opcode;
+}
+constexpr uint32_t encodeU(uint32_t opcode, uint32_t rd, uint32_t imm) {
+    return (imm & 0xfffff000) | (rd << 7) | opcode;
+}
+constexpr uint32_t encodeJ(uint32_t opcode, uint32_t rd, uint32_t imm) {
+    return (bitField<20, 1>(imm) << 31) | (bitField<1, 10>(imm) << 21) | (bitField<11, 1>(imm) << 20) |
+           (bitField<12, 8>(imm) << 12) | (rd << 7) | opcode;
+}
+
+/** Immediates of the compressed formats, as scattered across the bits of the instruction */
+/// CI format; imm[5] at bit 12 and imm[4:0] at bits 6:2, sign extended
+constexpr uint32_t immCI(const uint32_t c) {
+    return signExtend((bitField<12, 1>(c) << 5) | bitField<2, 5>(c), 6);
+}
+/// C.LW and C.SW; uimm[5:3] at bits 12:10, uimm[2] at bit 6 and uimm[6] at bit 5
+constexpr uint32_t immCLW(const uint32_t c) {
+    return (bitField<10, 3>(c) << 3) | (bitField<6, 1>(c) << 2) | (bitField<5, 1>(c) << 6);
+}
+/// C.ADDI4SPN; nzuimm[5:4|9:6|2|3] at bits 12:5
+constexpr uint32_t immCIW(const uint32_t c) {
+    return (bitField<11, 2>(c) << 4) | (bitField<7, 4>(c) << 6) | (bitField<6, 1>(c) << 2) | (bitField<5, 1>(c) << 3);
+}
+/// C.ADDI16SP; nzimm[9] at bit 12 and nzimm[4|6|8:7|5] at bits 6:2, sign extended
+constexpr uint32_t immAddi16sp(const uint32_t c) {
+    return signExtend((bitField<12, 1>(c) << 9) | (bitField<6, 1>(c) << 4) | (bitField<5, 1>(c) << 6) |
+                          (bitField<3, 2>(c) << 7) | (bitField<2, 1>(c) << 5),
+                      10);
+}
+/// C.LWSP; uimm[5] at bit 12 and uimm[4:2|7:6] at bits 6:2
+constexpr uint32_t immLwsp(const uint32_t c) {
+    return (bitField<12, 1>(c) << 5) | (bitField<4, 3>(c) << 2) | (bitField<2, 2>(c) << 6);
+}
+/// C.SWSP; uimm[5:2|7:6] at bits 12:7
+constexpr uint32_t immSwsp(const uint32_t c) {
+    return (bitField<9, 4>(c) << 2) | (bitField<7, 2>(c) << 6);
+}
+/// CB format branches; offset[8|4:3] at bits 12:10 and offset[7:6|2:1|5] at bits 6:2, sign extended
+constexpr uint32_t immCB(const uint32_t c) {
+    return signExtend((bitField<12, 1>(c) << 8) | (bitField<10, 2>(c) << 3) | (bitField<5, 2>(c) << 6) |
+                          (bitField<3, 2>(c) << 1) | (bitField<2, 1>(c) << 5),
+                      9);
+}
+/// CJ format; offset[11|4|9:8|10|6|7|3:1|5] at bits 12:2, sign extended
+constexpr uint32_t immCJ(const uint32_t c) {
+    return signExtend((bitField<12, 1>(c) << 11) | (bitField<11, 1>(c) << 4) | (bitField<9, 2>(c) << 8) |
+                          (bitField<8, 1>(c) << 10) | (bitField<7, 1>(c) << 6) | (bitField<6, 1>(c) << 7) |
+                          (bitField<3, 3>(c) << 1) | (bitField<2, 1>(c) << 5),
+                      12);
+}
+
+/** Compressed instruction encoders, the inverses of the immediate extractors above. Registers of the CIW, CL, CS, CA
+ * and CB formats are given as their full register numbers, which must be within x8-x15.
+ */
+constexpr uint32_t encodeCR(uint32_t op, uint32_t funct4, uint32_t rd, uint32_t rs2) {
+    return (funct4 << 12) | (rd << 7) | (rs2 << 2) | op;
+}
+constexpr uint32_t encodeCI(uint32_t op, uint32_t funct3, uint32_t rd, uint32_t imm) {
+    return (funct3 << 13) | (bitField<5, 1>(imm) << 12) | (rd << 7) | (bitField<0, 5>(imm) << 2) | op;
+}
+constexpr uint32_t encodeCLW(uint32_t funct3, uint32_t rs1, uint32_t rd, uint32_t imm) {
+    return (funct3 << 13) | (bitField<3, 3>(imm) << 10) | ((rs1 - 8) << 7) | (bitField<2, 1>(imm) << 6) |
+           (bitField<6, 1>(imm) << 5) | ((rd - 8) << 2);
+}
+constexpr uint32_t encodeAddi4spn(uint32_t rd, uint32_t imm) {
+    return (bitField<4, 2>(imm) << 11) | (bitField<6, 4>(imm) << 7) | (bitField<2, 1>(imm) << 6) |
+           (bitField<3, 1>(imm) << 5) | ((rd - 8) << 2);
+}
+constexpr uint32_t encodeAddi16sp(uint32_t imm) {
+    return (0b011 << 13) | (bitField<9, 1>(imm) << 12) | (2 << 7) | (bitField<4, 1>(imm) << 6) |
+           (bitField<6, 1>(imm) << 5) | (bitField<7, 2>(imm) << 3) | (bitField<5, 1>(imm) << 2) | 0b01;
+}
+constexpr uint32_t encodeLwsp(uint32_t rd, uint32_t imm) {
+    return (0b010 << 13) | (bitField<5, 1>(imm) << 12) | (rd << 7) | (bitField<2, 3>(imm) << 4) |
+           (bitField<6, 2>(imm) << 2) | 0b10;
+}
+constexpr uint32_t encodeSwsp(uint32_t rs2, uint32_t imm) {
+    return (0b110 << 13) | (bitField<2, 4>(imm) << 9) | (bitField<6, 2>(imm) << 7) | (rs2 << 2) | 0b10;
+}
+constexpr uint32_t encodeCA(uint32_t funct6, uint32_t rd, uint32_t funct2, uint32_t rs2) {
+    return (funct6 << 10) | ((rd - 8) << 7) | (funct2 << 5) | ((rs2 - 8) << 2) | 0b01;
+}
+/// C.SRLI, C.SRAI and C.ANDI; funct2 selects the operation
+constexpr uint32_t encodeCBImm(uint32_t funct2, uint32_t rd, uint32_t imm) {
+    return (0b100 << 13) | (bitField<5, 1>(imm) << 12) | (funct2 << 10) | ((rd - 8) << 7) | (bitField<0, 5>(imm) << 2) |
+           0b01;
+}
+constexpr uint32_t encodeCB(uint32_t funct3, uint32_t rs1, uint32_t imm) {
+    return (funct3 << 13) | (bitField<8, 1>(imm) << 12) | (bitField<3, 2>(imm) << 10) | ((rs1 - 8) << 7) |
+           (bitField<6, 2>(imm) << 5) | (bitField<1, 2>(imm) << 3) | (bitField<5, 1>(imm) << 2) | 0b01;
+}
+constexpr uint32_t encodeCJ(uint32_t funct3, uint32_t imm) {
+    return (funct3 << 13) | (bitField<11, 1>(imm) << 12) | (bitField<4, 1>(imm) << 11) | (bitField<8, 2>(imm) << 9) |
+           (bitField<10, 1>(imm) << 8) | (bitField<6, 1>(imm) << 7) | (bitField<7, 1>(imm) << 6) |
+           (bitField<1, 3>(imm) << 3) | (bitField<5, 1>(imm) << 2) | 0b01;
+}
+
+}  // namespace rvc
+
+/**
+ * @brief expandCompressed
+ * @returns the 32-bit instruction which the compressed instruction @p c (in its 16 least significant bits) expands
+ * to, or 0 if @p c is illegal, reserved or not implemented (the floating-point loads and stores, and C.EBREAK). The
+ * all-zero halfword is illegal, such that zero-filled memory never expands to a valid instruction.
+ */
+constexpr uint32_t expandCompressed(const uint32_t c) {
+    using namespace rvc;
+    const uint32_t funct3 = bitField<13, 3>(c);
+    // rd/rs1 and rs2 of the CR, CI and CSS formats
+    const uint32_t rd = bitField<7, 5>(c);
+    const uint32_t rs2 = bitField<2, 5>(c);
+    // The 3-bit register fields of the other formats address x8-x15; rd'/rs2' at bits 4:2 and rs1'/rd' at bits 9:7
+    const uint32_t rdp = bitField<2, 3>(c) + 8;
+    const uint32_t rs1p = bitField<7, 3>(c) + 8;
+
+    switch (bitField<0, 2>(c)) {
+        case 0b00:
+            switch (funct3) {
+                case 0b000:  // C.ADDI4SPN
+                    return immCIW(c) == 0 ? 0 : encodeI(instrType::OP_IMM, rdp, 0b000, 2, immCIW(c));
+                case 0b010:  // C.LW
+                    return encodeI(instrType::LOAD, rdp, 0b010, rs1p, immCLW(c));
+                case 0b110:  // C.SW
+                    return encodeS(instrType::STORE, 0b010, rs1p, rdp, immCLW(c));
+                default:
+                    return 0;
+            }
+        case 0b01:
+            switch (funct3) {
+                case 0b000:  // C.ADDI and C.NOP
+                    return encodeI(instrType::OP_IMM, rd, 0b000, rd, immCI(c));
+                case 0b001:  // C.JAL
+                    return encodeJ(instrType::JAL, 1, immCJ(c));
+                case 0b010:  // C.LI
+                    return encodeI(instrType::OP_IMM, rd, 0b000, 0, immCI(c));
+                case 0b011:
+                    if (rd == 2) {  // C.ADDI16SP
+                        return immAddi16sp(c) == 0 ? 0 : encodeI(instrType::OP_IMM, 2, 0b000, 2, immAddi16sp(c));
+                    }
+                    // C.LUI
+                    return immCI(c) == 0 ? 0 : encodeU(instrType::LUI, rd, immCI(c) << 12);
+                case 0b100:
+                    switch (bitField<10, 2>(c)) {
+                        case 0b00:  // C.SRLI; shift amounts of 32 and above are reserved for RV32C
+                            return bitField<12, 1>(c) ? 0 : encodeI(instrType::OP_IMM, rs1p, 0b101, rs1p, rs2);
+                        case 0b01:  // C.SRAI
+                            return bitField<12, 1>(c)
+                                       ? 0
+                                       : encodeI(instrType::OP_IMM, rs1p, 0b101, rs1p, (0b0100000 << 5) | rs2);
+                        case 0b10:  // C.ANDI
+                            return encodeI(instrType::OP_IMM, rs1p, 0b111, rs1p, immCI(c));
+                        default:
+                            if (bitField<12, 1>(c)) {
+                                // C.SUBW and C.ADDW of RV64C
+                                return 0;
+                            }
+                            switch (bitField<5, 2>(c)) {
+                                case 0b00:  // C.SUB
+                                    return encodeR(instrType::OP, rs1p, 0b000, rs1p, rdp, 0b0100000);
+                                case 0b01:  // C.XOR
+                                    return encodeR(instrType::OP, rs1p, 0b100, rs1p, rdp, 0);
+                                case 0b10:  // C.OR
+                                    return encodeR(instrType::OP, rs1p, 0b110, rs1p, rdp, 0);
+                                default:  // C.AND
+                                    return encodeR(instrType::OP, rs1p, 0b111, rs1p, rdp, 0);
+                            }
+                    }
+                case 0b101:  // C.J
+                    return encodeJ(instrType::JAL, 0, immCJ(c));
+                case 0b110:  // C.BEQZ
+                    return encodeB(instrType::BRANCH, 0b000, rs1p, 0, immCB(c));
+                default:  // C.BNEZ
+                    return encodeB(instrType::BRANCH, 0b001, rs1p, 0, immCB(c));
+            }
+        case 0b10:
+            switch (funct3) {
+                case 0b000:  // C.SLLI
+                    return bitField<12, 1>(c) ? 0 : encodeI(instrType::OP_IMM, rd, 0b001, rd, rs2);
+                case 0b010:  // C.LWSP
+                    return rd == 0 ? 0 : encodeI(instrType::LOAD, rd, 0b010, 2, immLwsp(c));
+                case 0b100:
+                    if (!bitField<12, 1>(c)) {
+                        if (rs2 == 0) {  // C.JR
+                            return rd == 0 ? 0 : encodeI(instrType::JALR, 0, 0b000, rd, 0);
+                        }
+                        // C.MV
+                        return encodeR(instrType::OP, rd, 0b000, 0, rs2, 0);
+                    }
+                    if (rs2 == 0) {
+                        // C.JALR. C.EBREAK (rd = 0) is not implemented, given that EBREAK is not decoded.
+                        return rd == 0 ? 0 : encodeI(instrType::JALR, 1, 0b000, rd, 0);
+                    }
+                    // C.ADD
+                    return encodeR(instrType::OP, rd, 0b000, rd, rs2, 0);
+                case 0b110:  // C.SWSP
+                    return encodeS(instrType::STORE, 0b010, 2, rs2, immSwsp(c));
+                default:
+                    return 0;
+            }
+        default:
+            // Not a compressed instruction
+            return 0;
+    }
+}
+
+static_assert(expandCompressed(0x0000) == 0, "illegal instruction");
+static_assert(expandCompressed(0x0001) == 0x00000013, "c.nop");
+static_assert(expandCompressed(0x1141) == 0xff010113, "c.addi sp, -16");
+static_assert(expandCompressed(0x0048) == 0x00410513, "c.addi4spn a0, sp, 4");
+static_assert(expandCompressed(0x4188) == 0x0005a503, "c.lw a0, 0(a1)");
+static_assert(expandCompressed(0xc188) == 0x00a5a023, "c.sw a0, 0(a1)");
+static_assert(expandCompressed(0x4505) == 0x00100513, "c.li a0, 1");
+static_assert(expandCompressed(0x6505) == 0x00001537, "c.lui a0, 1");
+static_assert(expandCompressed(0x7179) == 0xfd010113, "c.addi16sp sp, -48");
+static_assert(expandCompressed(0x8d0d) == 0x40b50533, "c.sub a0, a1");
+static_assert(expandCompressed(0x8505) == 0x40155513, "c.srai a0, 1");
+static_assert(expandCompressed(0x050a) == 0x00251513, "c.slli a0, 2");
+static_assert(expandCompressed(0x4532) == 0x00c12503, "c.lwsp a0, 12(sp)");
+static_assert(expandCompressed(0xc62a) == 0x00a12623, "c.swsp a0, 12(sp)");
+static_assert(expandCompressed(0x8082) == 0x00008067, "c.jr ra");
+static_assert(expandCompressed(0x9002) == 0, "c.ebreak");
+static_assert(expandCompressed(0x9082) == 0x000080e7, "c.jalr ra");
+static_assert(expandCompressed(0x852e) == 0x00b00533, "c.mv a0, a1");
+static_assert(expandCompressed(0x952e) == 0x00b50533, "c.add a0, a1");
+static_assert(expandCompressed(0xa001) == 0x0000006f, "c.j 0");
+static_assert(expandCompressed(0xfd75) == 0xfe051ee3, "c.bnez a0, -4");
+static_assert(rvc::encodeCJ(0b101, static_cast<uint32_t>(-2)) == 0xbffd, "c.j -2");
+static_assert(rvc::encodeCB(0b111, 10, static_cast<uint32_t>(-4)) == 0xfd75, "c.bnez a0, -4");
+
+}  // namespace Ripes
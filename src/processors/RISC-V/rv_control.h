@@ -80,6 +80,10 @@ public:
                 // Jump instructions
                 case RVInstr::JALR:
                 case RVInstr::JAL:
+
+                // CSR instructions
+                case RVInstr::CSRRW: case RVInstr::CSRRS: case RVInstr::CSRRC:
+                case RVInstr::CSRRWI: case RVInstr::CSRRSI: case RVInstr::CSRRCI:
                     return 1;
                 default: return 0;
             }
@@ -147,6 +151,11 @@ public:
             case RVInstr::JAL:
                 return AluSrc2::IMM;
 
+            // CSR instructions; the CSR number is carried by the immediate
+            case RVInstr::CSRRW: case RVInstr::CSRRS: case RVInstr::CSRRC:
+            case RVInstr::CSRRWI: case RVInstr::CSRRSI: case RVInstr::CSRRCI:
+                return AluSrc2::IMM;
+
             default:
                 return AluSrc2::REG2;
             }
@@ -198,6 +207,9 @@ public:
                     return ALUOp::REM;
                 case RVInstr::REMU:
                     return ALUOp::REMU;
+                case RVInstr::CSRRW: case RVInstr::CSRRS: case RVInstr::CSRRC:
+                case RVInstr::CSRRWI: case RVInstr::CSRRSI: case RVInstr::CSRRCI:
+                    return ALUOp::CSR;
                 default: return ALUOp::NOP;
             }
         };
@@ -1,8 +1,8 @@
 #pragma once
 
-#include "Signals/Signal.h"
 #include "VSRTL/core/vsrtl_component.h"
 
+#include "../ripesprocessor.h"
 #include "riscv.h"
 
 namespace vsrtl {
@@ -14,7 +14,7 @@ public:
     EcallChecker(std::string name, SimComponent* parent) : Component(name, parent) {
         dummy << [=] {
             if (opcode.uValue() == RVInstr::ECALL && !stallEcallHandling.uValue()) {
-                m_signal->Emit();
+                m_processor->requestSysCall();
             }
             return 0;
         };
@@ -26,7 +26,8 @@ public:
         syscallExit << [=] { return m_syscallExit; };
     }
 
-    void setSysCallSignal(Gallant::Signal0<>* sig) { m_signal = sig; }
+    /// The system calls of the ecall instructions seen by the checker are requested from @p processor
+    void setProcessor(RipesProcessor* processor) { m_processor = processor; }
 
     /**
      * @brief setSysCallExiting
@@ -35,7 +36,7 @@ public:
     void setSysCallExiting(bool state) { m_syscallExit = state; }
     bool isSysCallExiting() const { return m_syscallExit; }
 
-    Gallant::Signal0<>* m_signal;
+    RipesProcessor* m_processor = nullptr;
 
     INPUTPORT_ENUM(opcode, RVInstr);
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "VSRTL/core/vsrtl_component.h"
+#include "riscv.h"
+#include "rv_compressed.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The Expander class
+ * Expands compressed (RV32C) instructions into their 32-bit equivalents, such that the decoder and immediate generator
+ * only see 32-bit instructions. 32-bit instructions are passed through. Illegal compressed instructions expand to 0,
+ * which is decoded as a NOP as are other unknown instructions. length is the size of the fetched instruction in bytes,
+ * by which the program counter is incremented.
+ */
+class Expander : public Component {
+public:
+    Expander(std::string name, SimComponent* parent) : Component(name, parent) {
+        exp_instr << [=] {
+            const uint32_t word = instr.uValue();
+            return instructionLength(word) == 4 ? word : expandCompressed(word & 0xffff);
+        };
+
+        length << [=] { return instructionLength(instr.uValue()); };
+    }
+
+    INPUTPORT(instr, RV_INSTR_WIDTH);
+    OUTPUTPORT(exp_instr, RV_INSTR_WIDTH);
+    OUTPUTPORT(length, RV_REG_WIDTH);
+};
+
+}  // namespace core
+}  // namespace vsrtl
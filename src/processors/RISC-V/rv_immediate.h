@@ -17,9 +17,7 @@ public:
                 case RVInstr::AUIPC:
                     return instr.uValue() & 0xfffff000;
                 case RVInstr::JAL: {
-                    const auto fields = RVInstrParser::getParser()->decodeJInstr(instr.uValue());
-                    return static_cast<unsigned>(
-                        signextend<int32_t, 21>(fields[0] << 20 | fields[1] << 1 | fields[2] << 11 | fields[3] << 12));
+                    return static_cast<unsigned>(signextend<int32_t, 21>(immediate(decodeJInstr(instr.uValue()))));
                 }
                 case RVInstr::JALR: {
                     return static_cast<unsigned>(signextend<int32_t, 12>((instr.uValue() >> 20)));
@@ -30,9 +28,7 @@ public:
                 case RVInstr::BGE:
                 case RVInstr::BLTU:
                 case RVInstr::BGEU: {
-                    const auto fields = RVInstrParser::getParser()->decodeBInstr(instr.uValue());
-                    return static_cast<unsigned>(signextend<int32_t, 13>((fields[0] << 12) | (fields[1] << 5) |
-                                                                         (fields[5] << 1) | (fields[6] << 11)));
+                    return static_cast<unsigned>(signextend<int32_t, 13>(immediate(decodeBInstr(instr.uValue()))));
                 }
                 case RVInstr::LB:
                 case RVInstr::LH:
@@ -49,11 +45,18 @@ public:
                 case RVInstr::SRLI:
                 case RVInstr::SRAI:
                     return static_cast<unsigned>(signextend<int32_t, 12>((instr.uValue() >> 20)));
+                case RVInstr::CSRRW:
+                case RVInstr::CSRRS:
+                case RVInstr::CSRRC:
+                case RVInstr::CSRRWI:
+                case RVInstr::CSRRSI:
+                case RVInstr::CSRRCI:
+                    // The CSR number
+                    return instr.uValue() >> 20;
                 case RVInstr::SB:
                 case RVInstr::SH:
                 case RVInstr::SW: {
-                    return static_cast<unsigned>(signextend<int32_t, 12>(((instr.uValue() & 0xfe000000)) >> 20) |
-                                                 ((instr.uValue() & 0xf80) >> 7));
+                    return static_cast<unsigned>(signextend<int32_t, 12>(immediate(decodeSInstr(instr.uValue()))));
                 }
                 default:
                     return unsigned(0xDEADBEEF);
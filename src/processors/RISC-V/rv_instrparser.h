@@ -1,43 +1,83 @@
 #pragma once
 
-#include <assert.h>
-#include <functional>
-#include "../../binutils.h"
+#include <cstdint>
 
 namespace Ripes {
 
-typedef std::function<std::vector<uint32_t>(uint32_t)> decode_functor;
-static inline decode_functor generateInstrParser(std::vector<int> bitFields) {
-    // Generates functors that can decode a binary number based on the input
-    // vector which is supplied upon generation
-
-    // Assert that total bitField size is (32-7)=25-bit. Subtract 7 for op-code
-    int tot = 0;
-    for (const auto& field : bitFields) {
-        tot += field;
-    }
-    assert(tot == 25 && "Requested word parsing format is not 32-bit in length");
-
-    // Generate vector of <fieldsize,bitmask>
-    std::vector<std::pair<uint32_t, uint32_t>> parseVector;
-
-    // Generate bit masks and fill parse vector
-    for (const auto& field : bitFields) {
-        parseVector.emplace_back(field, generateBitmask(field));
-    }
-
-    // Create parse functor
-    decode_functor instrParser = [=](uint32_t word) {
-        word = word >> 7;  // remove OpCode
-        std::vector<uint32_t> parsedWord;
-        for (const auto& field : parseVector) {
-            parsedWord.insert(parsedWord.begin(), word & field.second);
-            word = word >> field.first;
-        }
-        return parsedWord;
-    };
-
-    return instrParser;
+/**
+ * @brief bitField
+ * @returns the @p width bits of @p word starting at bit index @p offset.
+ */
+template <unsigned offset, unsigned width>
+constexpr uint32_t bitField(const uint32_t word) {
+    static_assert(offset + width <= 32, "Requested bit field exceeds a 32-bit word");
+    static_assert(width > 0 && width < 32, "Bit field width must be in the range [1;31]");
+    return (word >> offset) & ((1u << width) - 1);
 }
 
+/** Instruction field extractors
+ * Each extractor splits an instruction word into the fields of its instruction format. Immediate fields are returned
+ * as their raw, unshifted bit slices, named by the immediate bits which they contain.
+ */
+struct RVRFields {
+    uint32_t rd, funct3, rs1, rs2, funct7;
+};
+constexpr RVRFields decodeRInstr(const uint32_t instr) {
+    return {bitField<7, 5>(instr), bitField<12, 3>(instr), bitField<15, 5>(instr), bitField<20, 5>(instr),
+            bitField<25, 7>(instr)};
+}
+
+struct RVIFields {
+    uint32_t rd, funct3, rs1, imm;
+};
+constexpr RVIFields decodeIInstr(const uint32_t instr) {
+    return {bitField<7, 5>(instr), bitField<12, 3>(instr), bitField<15, 5>(instr), bitField<20, 12>(instr)};
+}
+
+struct RVSFields {
+    uint32_t imm4_0, funct3, rs1, rs2, imm11_5;
+};
+constexpr RVSFields decodeSInstr(const uint32_t instr) {
+    return {bitField<7, 5>(instr), bitField<12, 3>(instr), bitField<15, 5>(instr), bitField<20, 5>(instr),
+            bitField<25, 7>(instr)};
+}
+
+struct RVBFields {
+    uint32_t imm11, imm4_1, funct3, rs1, rs2, imm10_5, imm12;
+};
+constexpr RVBFields decodeBInstr(const uint32_t instr) {
+    return {bitField<7, 1>(instr),  bitField<8, 4>(instr),  bitField<12, 3>(instr), bitField<15, 5>(instr),
+            bitField<20, 5>(instr), bitField<25, 6>(instr), bitField<31, 1>(instr)};
+}
+
+struct RVUFields {
+    uint32_t rd, imm;
+};
+constexpr RVUFields decodeUInstr(const uint32_t instr) {
+    return {bitField<7, 5>(instr), bitField<12, 20>(instr)};
+}
+
+struct RVJFields {
+    uint32_t rd, imm19_12, imm11, imm10_1, imm20;
+};
+constexpr RVJFields decodeJInstr(const uint32_t instr) {
+    return {bitField<7, 5>(instr), bitField<12, 8>(instr), bitField<20, 1>(instr), bitField<21, 10>(instr),
+            bitField<31, 1>(instr)};
+}
+
+/** Immediate reconstruction from the raw fields of the S, B and J formats */
+constexpr uint32_t immediate(const RVSFields& f) {
+    return (f.imm11_5 << 5) | f.imm4_0;
+}
+constexpr uint32_t immediate(const RVBFields& f) {
+    return (f.imm12 << 12) | (f.imm11 << 11) | (f.imm10_5 << 5) | (f.imm4_1 << 1);
+}
+constexpr uint32_t immediate(const RVJFields& f) {
+    return (f.imm20 << 20) | (f.imm19_12 << 12) | (f.imm11 << 11) | (f.imm10_1 << 1);
+}
+
+static_assert(decodeRInstr(0x40b50533).funct7 == 0b0100000, "sub a0, a0, a1");
+static_assert(immediate(decodeBInstr(0xfe000ee3)) == 0x1ffc, "beq x0, x0, -4");
+static_assert(immediate(decodeJInstr(0x0080006f)) == 8, "jal x0, 8");
+
 }  // namespace Ripes
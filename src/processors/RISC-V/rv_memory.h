@@ -4,6 +4,12 @@
 #include "VSRTL/core/vsrtl_wire.h"
 #include "riscv.h"
 
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "../../mmiodevices.h"
+
 namespace vsrtl {
 namespace core {
 using namespace Ripes;
@@ -33,23 +39,31 @@ public:
         wr_width->out >> mem->wr_width;
 
         data_out << [=] {
+            const uint32_t word = loadedWord();
             switch (op.uValue()) {
                 case MemOp::LB:
-                    return static_cast<uint32_t>(signextend<int32_t, 8>(mem->data_out.uValue() & 0xFF));
+                    return static_cast<uint32_t>(signextend<int32_t, 8>(word & 0xFF));
                 case MemOp::LBU:
-                    return mem->data_out.uValue() & 0xFF;
+                    return word & 0xFF;
                 case MemOp::LH:
-                    return static_cast<uint32_t>(signextend<int32_t, 16>(mem->data_out.uValue() & 0xFFFF));
+                    return static_cast<uint32_t>(signextend<int32_t, 16>(word & 0xFFFF));
                 case MemOp::LHU:
-                    return mem->data_out.uValue() & 0xFFFF;
+                    return word & 0xFFFF;
                 case MemOp::LW:
-                    return mem->data_out.uValue();
+                    return word;
                 default:
-                    return mem->data_out.uValue();
+                    return word;
             }
         };
     }
 
+    /**
+     * @brief setDevices
+     * Loads from pages holding memory mapped devices read the registers of the devices which are not backed by memory
+     * from @p devices. Stores are performed upon memory, and are dispatched to the devices by the environment.
+     */
+    void setDevices(const MMIODevices* devices) { m_devices = devices; }
+
     SUBCOMPONENT(mem, TYPE(MemoryAsyncRd<RV_REG_WIDTH, RV_REG_WIDTH>));
 
     WIRE(wr_width, ceillog2(RV_REG_WIDTH / 8 + 1));
@@ -59,6 +73,93 @@ public:
     INPUTPORT(wr_en, 1);
     INPUTPORT_ENUM(op, MemOp);
     OUTPUTPORT(data_out, dataWidth);
+
+private:
+    uint32_t loadedWord() const {
+        const uint32_t address = static_cast<uint32_t>(addr.uValue());
+        uint32_t value = 0;
+        if (m_devices && m_devices->isDevicePage(address) && m_devices->read(address, value)) {
+            return value;
+        }
+        return static_cast<uint32_t>(mem->data_out.uValue());
+    }
+
+    const MMIODevices* m_devices = nullptr;
+};
+
+/**
+ * @brief The RVInstrMemory class
+ * Instruction memory which serves fetches from a fetch buffer of 256-byte blocks, copied from memory upon first fetch.
+ * Sequential fetches and control flow within the current block are served through a pointer to it, and other blocks
+ * are looked up by their address once crossed into. Blocks are read without populating memory, and are discarded
+ * when written to. The processor must invalidate the buffer whenever memory is written; through its data memory, or
+ * by the environment (see RipesProcessor::memoryModified()).
+ */
+template <unsigned int addrWidth, unsigned int dataWidth>
+class RVInstrMemory : public ROM<addrWidth, dataWidth> {
+public:
+    RVInstrMemory(std::string name, SimComponent* parent) : ROM<addrWidth, dataWidth>(name, parent) {
+        this->data_out << [=] { return fetch(static_cast<uint32_t>(this->addr.uValue())); };
+    }
+
+    void setMemory(SparseArray* memory) {
+        ROM<addrWidth, dataWidth>::setMemory(memory);
+        m_memory = memory;
+        invalidate();
+    }
+
+    /// Discards all buffered blocks
+    void invalidate() {
+        m_blocks.clear();
+        m_block = nullptr;
+    }
+
+    /// Discards the buffered blocks holding any of the bytes [@p address; @p address + @p size[
+    void invalidate(uint32_t address, unsigned size) {
+        if (m_blocks.empty() || size == 0) {
+            return;
+        }
+        const uint32_t last = address + size - 1;
+        for (uint32_t number = address >> s_blockBits;; number++) {
+            m_blocks.erase(number);
+            if (number == last >> s_blockBits) {
+                break;
+            }
+        }
+        m_block = nullptr;
+    }
+
+private:
+    static constexpr unsigned s_blockBits = 8;
+    static constexpr uint32_t s_blockSize = 1 << s_blockBits;
+    using Block = std::array<uint32_t, s_blockSize / 4>;
+
+    uint32_t fetch(uint32_t address) {
+        if ((address & 0b11) != 0) {
+            // Misaligned fetches are not buffered
+            return m_memory->readMemConst(address);
+        }
+        const uint32_t number = address >> s_blockBits;
+        if (!m_block || m_blockNumber != number) {
+            auto& block = m_blocks[number];
+            if (!block) {
+                block = std::make_unique<Block>();
+                const uint32_t base = number << s_blockBits;
+                for (uint32_t i = 0; i < block->size(); i++) {
+                    (*block)[i] = m_memory->readMemConst(base + (i << 2));
+                }
+            }
+            m_block = block.get();
+            m_blockNumber = number;
+        }
+        return (*m_block)[(address & (s_blockSize - 1)) >> 2];
+    }
+
+    SparseArray* m_memory = nullptr;
+    std::unordered_map<uint32_t, std::unique_ptr<Block>> m_blocks;
+    /// Block of the most recent fetch
+    Block* m_block = nullptr;
+    uint32_t m_blockNumber = 0;
 };
 
 }  // namespace core
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "VSRTL/core/vsrtl_register.h"
+
+#include "../ripesprocessor.h"
+#include "riscv.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The MulDivScoreboard class
+ * Models the timing of a pipelined multiplier and an iterative divider, which functionally execute within the single
+ * cycle of the EX stage. The scoreboard tracks the cycles remaining until the results of the multiplications and
+ * divisions which have left the EX stage may be consumed, and the cycles remaining until the divider may accept a new
+ * division. Instructions in the ID stage are stalled until their operands and unit are available.
+ * The scoreboard is clocked alongside the processor upon every cycle, such that it may be reversed alongside the
+ * reverse stacks of the design.
+ */
+class MulDivScoreboard {
+public:
+    enum class Stall { None, Dependency, Structural };
+
+    static bool isMultiply(unsigned opcode) {
+        return opcode == RVInstr::MUL || opcode == RVInstr::MULH || opcode == RVInstr::MULHSU ||
+               opcode == RVInstr::MULHU;
+    }
+    static bool isDivide(unsigned opcode) {
+        return opcode == RVInstr::DIV || opcode == RVInstr::DIVU || opcode == RVInstr::REM || opcode == RVInstr::REMU;
+    }
+
+    MulDivScoreboard() { reset(); }
+
+    void setLatencies(const FunctionalUnitLatencies& latencies) {
+        m_latencies = latencies;
+        m_latencies.multiply = std::max(m_latencies.multiply, 1u);
+        m_latencies.divide = std::max(m_latencies.divide, 1u);
+        reset();
+    }
+    const FunctionalUnitLatencies& getLatencies() const { return m_latencies; }
+
+    /**
+     * @brief stall
+     * @returns whether the instruction @p idOpcode in the ID stage, reading registers @p idRs1 and @p idRs2, must be
+     * stalled, given instruction @p exOpcode writing register @p exRd in the EX stage. Dependencies take precedence
+     * over the divider being occupied.
+     */
+    Stall stall(unsigned exOpcode, unsigned exRd, unsigned idOpcode, unsigned idRs1, unsigned idRs2) const {
+        const unsigned exLatency = latency(exOpcode);
+        const auto depends = [&](unsigned rs) {
+            return rs != 0 && (m_remaining.at(rs) != 0 || (exLatency > 1 && exRd == rs));
+        };
+        if (depends(idRs1) || depends(idRs2)) {
+            return Stall::Dependency;
+        }
+        if (isDivide(idOpcode) && (m_dividerRemaining != 0 || (isDivide(exOpcode) && m_latencies.divide > 1))) {
+            return Stall::Structural;
+        }
+        return Stall::None;
+    }
+
+    /**
+     * @brief clock
+     * Advances the units by a cycle. If @p exAdvances, instruction @p exOpcode left the EX stage in the cycle, writing
+     * register @p exRd if @p exWrites. @p stalled is the stall of the ID stage in the cycle, which is accounted in the
+     * statistics of the units.
+     */
+    void clock(bool exAdvances, unsigned exOpcode, unsigned exRd, bool exWrites, Stall stalled) {
+        m_undoStack.push_front({m_remaining, m_dividerRemaining, m_statistics});
+        if (m_undoStack.size() > ClockedComponent::reverseStackSize()) {
+            m_undoStack.pop_back();
+        }
+
+        for (auto& remaining : m_remaining) {
+            remaining = remaining > 0 ? remaining - 1 : 0;
+        }
+        m_dividerRemaining = m_dividerRemaining > 0 ? m_dividerRemaining - 1 : 0;
+
+        if (exAdvances) {
+            // A dependent instruction may enter the EX stage once the latency of its operand has passed. It was
+            // stalled in the cycle in which the instruction left the EX stage, and is so for the remaining cycles.
+            const unsigned remaining = std::max(latency(exOpcode), 2u) - 2;
+            if (exWrites && exRd != 0) {
+                // Later writes to the register supersede the result of the unit
+                m_remaining.at(exRd) = remaining;
+            }
+            if (isDivide(exOpcode)) {
+                m_dividerRemaining = remaining;
+            }
+        }
+
+        if (stalled == Stall::Dependency) {
+            m_statistics.dependencyStallCycles++;
+        } else if (stalled == Stall::Structural) {
+            m_statistics.structuralStallCycles++;
+        }
+    }
+
+    void reverse() {
+        if (m_undoStack.empty()) {
+            return;
+        }
+        const Undo& undo = m_undoStack.front();
+        m_remaining = undo.remaining;
+        m_dividerRemaining = undo.dividerRemaining;
+        m_statistics = undo.statistics;
+        m_undoStack.pop_front();
+    }
+
+    void reset() {
+        m_remaining.fill(0);
+        m_dividerRemaining = 0;
+        m_statistics = FunctionalUnitStatistics();
+        m_undoStack.clear();
+    }
+
+    const FunctionalUnitStatistics& getStatistics() const { return m_statistics; }
+    void setStatistics(const FunctionalUnitStatistics& statistics) { m_statistics = statistics; }
+
+    /**
+     * @brief saveState/restoreState
+     * Appends the s_stateSize entries of the state of the units to @p state, or restores them from @p state starting
+     * at @p offset. Restoring clears the undo stack; the scoreboard cannot be reversed past the restored state.
+     */
+    static constexpr size_t s_stateSize = RV_REGS + 1;
+    void saveState(std::vector<long long>& state) const {
+        state.insert(state.end(), m_remaining.begin(), m_remaining.end());
+        state.push_back(m_dividerRemaining);
+    }
+    void restoreState(const std::vector<long long>& state, size_t offset) {
+        for (auto& remaining : m_remaining) {
+            remaining = static_cast<unsigned>(state.at(offset++));
+        }
+        m_dividerRemaining = static_cast<unsigned>(state.at(offset));
+        m_undoStack.clear();
+    }
+
+private:
+    struct Undo {
+        std::array<unsigned, RV_REGS> remaining;
+        unsigned dividerRemaining;
+        FunctionalUnitStatistics statistics;
+    };
+
+    unsigned latency(unsigned opcode) const {
+        if (isMultiply(opcode)) {
+            return m_latencies.multiply;
+        }
+        return isDivide(opcode) ? m_latencies.divide : 1;
+    }
+
+    FunctionalUnitLatencies m_latencies;
+    // Cycles remaining until the result written to each register may be consumed by an instruction leaving the ID stage
+    std::array<unsigned, RV_REGS> m_remaining;
+    // Cycles remaining until the divider may accept a division leaving the ID stage
+    unsigned m_dividerRemaining = 0;
+    FunctionalUnitStatistics m_statistics;
+    std::deque<Undo> m_undoStack;
+};
+
+}  // namespace core
+}  // namespace vsrtl
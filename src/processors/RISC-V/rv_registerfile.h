@@ -102,5 +102,125 @@ private:
     SparseArray* m_memory = nullptr;
 };
 
+/**
+ * @brief The DualWriteRegisterFile class
+ * A variant of the RegisterFile with four read ports and two write ports, for processors issuing two instructions per
+ * cycle. Read ports 1 and 2 and write port 1 belong to the older of the two instructions, and read ports 3 and 4 and
+ * write port 2 to the younger. If both ports write the same register, the write of the younger instruction (port 2)
+ * takes precedence.
+ */
+template <bool readBypass>
+class DualWriteRegisterFile : public Component {
+public:
+    SetGraphicsType(ClockedComponent);
+    DualWriteRegisterFile(std::string name, SimComponent* parent) : Component(name, parent) {
+        // Writes
+
+        // Disable writes to register 0, and writes of port 1 which are superseded by port 2
+        wr1_en_0->setSensitiveTo(wr1_en);
+        wr1_en_0->setSensitiveTo(wr1_addr);
+        wr1_en_0->setSensitiveTo(wr2_en);
+        wr1_en_0->setSensitiveTo(wr2_addr);
+        wr1_en_0->out << [=] {
+            const unsigned idx = wr1_addr.uValue();
+            return wr1_en.uValue() && idx != 0 && !(wr2_en.uValue() && wr2_addr.uValue() == idx);
+        };
+        wr2_en_0->setSensitiveTo(wr2_en);
+        wr2_en_0->out << [=] { return wr2_en.uValue() && wr2_addr.uValue() != 0; };
+
+        wr1_addr >> _wr1_mem->addr;
+        wr1_en_0->out >> _wr1_mem->wr_en;
+        data1_in >> _wr1_mem->data_in;
+        4 >> _wr1_mem->wr_width;
+
+        wr2_addr >> _wr2_mem->addr;
+        wr2_en_0->out >> _wr2_mem->wr_en;
+        data2_in >> _wr2_mem->data_in;
+        4 >> _wr2_mem->wr_width;
+
+        // Reads
+        r1_addr >> _rd1_mem->addr;
+        r2_addr >> _rd2_mem->addr;
+        r3_addr >> _rd3_mem->addr;
+        r4_addr >> _rd4_mem->addr;
+
+        if constexpr (readBypass) {
+            // See RegisterFile; the younger write is bypassed if both ports write the read register
+            r1_out << [=] { return bypassedRead(r1_addr, _rd1_mem->data_out); };
+            r2_out << [=] { return bypassedRead(r2_addr, _rd2_mem->data_out); };
+            r3_out << [=] { return bypassedRead(r3_addr, _rd3_mem->data_out); };
+            r4_out << [=] { return bypassedRead(r4_addr, _rd4_mem->data_out); };
+        } else {
+            _rd1_mem->data_out >> r1_out;
+            _rd2_mem->data_out >> r2_out;
+            _rd3_mem->data_out >> r3_out;
+            _rd4_mem->data_out >> r4_out;
+        }
+    }
+
+    SUBCOMPONENT(_wr1_mem, TYPE(WrMemory<RV_REGS_BITS, RV_REG_WIDTH, false>));
+    SUBCOMPONENT(_wr2_mem, TYPE(WrMemory<RV_REGS_BITS, RV_REG_WIDTH, false>));
+    SUBCOMPONENT(_rd1_mem, TYPE(RdMemory<RV_REGS_BITS, RV_REG_WIDTH, false>));
+    SUBCOMPONENT(_rd2_mem, TYPE(RdMemory<RV_REGS_BITS, RV_REG_WIDTH, false>));
+    SUBCOMPONENT(_rd3_mem, TYPE(RdMemory<RV_REGS_BITS, RV_REG_WIDTH, false>));
+    SUBCOMPONENT(_rd4_mem, TYPE(RdMemory<RV_REGS_BITS, RV_REG_WIDTH, false>));
+
+    INPUTPORT(r1_addr, RV_REGS_BITS);
+    INPUTPORT(r2_addr, RV_REGS_BITS);
+    INPUTPORT(r3_addr, RV_REGS_BITS);
+    INPUTPORT(r4_addr, RV_REGS_BITS);
+
+    INPUTPORT(wr1_addr, RV_REGS_BITS);
+    INPUTPORT(data1_in, RV_REG_WIDTH);
+    WIRE(wr1_en_0, 1);
+    INPUTPORT(wr1_en, 1);
+
+    INPUTPORT(wr2_addr, RV_REGS_BITS);
+    INPUTPORT(data2_in, RV_REG_WIDTH);
+    WIRE(wr2_en_0, 1);
+    INPUTPORT(wr2_en, 1);
+
+    OUTPUTPORT(r1_out, RV_REG_WIDTH);
+    OUTPUTPORT(r2_out, RV_REG_WIDTH);
+    OUTPUTPORT(r3_out, RV_REG_WIDTH);
+    OUTPUTPORT(r4_out, RV_REG_WIDTH);
+
+    VSRTL_VT_U getRegister(unsigned i) { return m_memory->readMem<false>(i); }
+
+    std::vector<VSRTL_VT_U> getRegisters() {
+        std::vector<VSRTL_VT_U> regs;
+        for (int i = 0; i < RV_REGS; i++)
+            regs.push_back(getRegister(i));
+        return regs;
+    }
+
+    void setMemory(SparseArray* mem) {
+        m_memory = mem;
+        // All memory components must point to the same memory
+        _wr1_mem->setMemory(m_memory);
+        _wr2_mem->setMemory(m_memory);
+        _rd1_mem->setMemory(m_memory);
+        _rd2_mem->setMemory(m_memory);
+        _rd3_mem->setMemory(m_memory);
+        _rd4_mem->setMemory(m_memory);
+    }
+
+private:
+    template <typename AddrPort, typename DataPort>
+    VSRTL_VT_U bypassedRead(const AddrPort& addr, const DataPort& data) const {
+        const unsigned rd_idx = addr.uValue();
+        if (rd_idx == 0) {
+            return 0;
+        } else if (wr2_en.uValue() && wr2_addr.uValue() == rd_idx) {
+            return data2_in.uValue();
+        } else if (wr1_en.uValue() && wr1_addr.uValue() == rd_idx) {
+            return data1_in.uValue();
+        }
+        return data.uValue();
+    }
+
+    SparseArray* m_memory = nullptr;
+};
+
 }  // namespace core
 }  // namespace vsrtl
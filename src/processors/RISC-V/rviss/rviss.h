@@ -0,0 +1,785 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "VSRTL/core/vsrtl_design.h"
+
+#include "../../ripesprocessor.h"
+
+#include "../../../binutils.h"
+#include "../../../defines.h"
+#include "../../../mmiodevices.h"
+#include "../../../watchpoints.h"
+#include "../riscv.h"
+#include "../rv_compressed.h"
+
+namespace vsrtl {
+namespace core {
+using namespace Ripes;
+
+/**
+ * @brief The TracedMemoryAccess struct
+ * A memory access traced by the interpreter; the fetch of the instruction at pc, or its load or store of address.
+ */
+struct TracedMemoryAccess {
+    enum Kind : uint8_t { Fetch, Load, Store };
+    uint32_t address;
+    uint32_t pc;
+    Kind kind;
+};
+
+/**
+ * @brief The HartInterconnect struct
+ * Connects the interpreters of harts which execute concurrently on separate host threads whilst sharing a memory
+ * address space. The address space is only accessed whilst holding mutex, as are the LR.W reservations of the harts,
+ * indexed by hart id, which are cleared by stores of any hart to the reserved word.
+ */
+struct HartInterconnect {
+    static constexpr uint32_t s_noReservation = 1;
+    explicit HartInterconnect(unsigned harts) : reservations(harts, s_noReservation) {}
+    std::mutex mutex;
+    std::vector<uint32_t> reservations;
+};
+
+/**
+ * @brief The RVISS class
+ * A functional, instruction-set level interpreter for RV32IMAC and the counter CSRs of Zicsr. The interpreter does not
+ * contain a VSRTL netlist; each clock cycle executes a single instruction directly on the memory and register address
+ * spaces which it has been bound to.
+ * Instructions are translated into basic blocks of pre-decoded operations upon first execution. A block is bounded by
+ * a control-flow instruction (branch, JAL, JALR or ECALL) or the end of the executable region, and is cached by its
+ * start address. Each operation carries a pointer to the handler which executes it, such that executing a cached
+ * block requires no decoding. Compressed instructions are expanded upon translation. Blocks are invalidated when a
+ * store writes to them.
+ * Data loads are served from 4 KiB host pages, copied from the memory address space upon first touch. Stores are
+ * written through to both the memory address space and any cached page, such that the address space is always up to
+ * date. Pages are discarded upon reset and through invalidateMemory(), which must be called whenever the memory
+ * address space is modified outside of the interpreter.
+ * The interpreter is intended to be bound to the address spaces of a detailed (VSRTL) processor model, such that
+ * execution may be handed back and forth between the two models without copying any architectural state.
+ * The interpreter does not support reversing clock cycles.
+ */
+class RVISS : public RipesProcessor {
+public:
+    RVISS(SparseArray* memory, SparseArray* regMem) : RipesProcessor("RISC-V ISS"), m_memory(memory), m_regMem(regMem) {}
+
+    // Ripes interface compliance
+    virtual const ISAInfoBase* implementsISA() const override {
+        return m_compressed ? static_cast<const ISAInfoBase*>(ISAInfo<ISA::RV32IMC>::instance())
+                            : ISAInfo<ISA::RV32IM>::instance();
+    }
+    unsigned int stageCount() const override { return 1; }
+    unsigned int getPcForStage(unsigned int) const override { return m_pc; }
+    unsigned int nextFetchedAddress() const override { return m_pc; }
+    QString stageName(unsigned int) const override { return "•"; }
+    StageInfo stageInfo(unsigned int) const override {
+        return StageInfo({m_pc, isExecutableAddress(m_pc), StageInfo::State::None});
+    }
+    void setProgramCounter(uint32_t address) override { m_pc = address; }
+    void setPCInitialValue(uint32_t address) override { m_pcInitialValue = address; }
+    SparseArray& getMemory() override { return *m_memory; }
+    unsigned int getRegister(unsigned i) const override { return i == 0 ? 0 : m_regMem->readMemConst(i << 2); }
+    SparseArray& getArchRegisters() override { return *m_regMem; }
+    void setRegister(unsigned i, uint32_t v) override {
+        if (i != 0) {
+            m_regMem->writeMem(i << 2, v);
+        }
+    }
+    void textSectionLoaded(const QByteArray&) override { invalidateBlocks(); }
+    void finalize(const FinalizeReason& fr) override {
+        // No pipeline to drain; the interpreter is finished as soon as a finalization reason is given.
+        m_finished |= fr.any();
+    }
+    bool finished() const override { return m_finished; }
+
+    /**
+     * @brief setCompressedInstructions
+     * Enables execution of compressed (RV32C) instructions; enabled by default. When disabled, instructions are always
+     * 32 bits wide, and those which would be compressed are executed as NOPs, as by processor models which do not
+     * implement the C extension.
+     */
+    void setCompressedInstructions(bool enabled) {
+        if (enabled != m_compressed) {
+            m_compressed = enabled;
+            invalidateBlocks();
+        }
+    }
+
+    /**
+     * @brief setMemoryAccessTracing
+     * If enabled, all instruction fetches and data memory accesses are traced, and emitted through accessesTraced in
+     * batches of up to s_accessBatchSize accesses, in program order. Disabling tracing emits the accesses traced so
+     * far. Disabled by default, given that tracing is only required for warming up cache simulators.
+     */
+    void setMemoryAccessTracing(bool enabled) {
+        if (!enabled) {
+            flushTracedAccesses();
+        }
+        m_traceAccesses = enabled;
+    }
+    Gallant::Signal1<const std::vector<TracedMemoryAccess>&> accessesTraced;
+    static constexpr size_t s_accessBatchSize = 1024;
+
+    /**
+     * @brief setWatchpoints
+     * Matches the data memory accesses of the interpreter against @p watchpoints, which may be nullptr. Accesses to
+     * unwatched pages cost a single bit test. watchpointHit() reports whether a watchpoint triggered in the last cycle.
+     */
+    void setWatchpoints(Watchpoints* watchpoints) { m_watchpoints = watchpoints; }
+    bool watchpointHit() const { return m_watchpointHit; }
+
+    /**
+     * @brief setMMIODevices
+     * Loads from pages holding memory mapped devices read the registers of the devices which are not backed by memory,
+     * and stores to such pages are dispatched to the devices once performed upon memory. Accesses to other pages cost a
+     * single bit test.
+     */
+    void setMMIODevices(MMIODevices* devices) override { m_devices = devices; }
+
+    /**
+     * @brief setInterconnect
+     * Shares the memory address space of the interpreter with the other harts of @p interconnect, which may be
+     * nullptr for a single hart. Loads are served from the pages cached by the interpreter, such that stores of other
+     * harts only become visible to them once synchronize() is called, whereas LR/SC and atomic memory operations are
+     * always performed upon the shared address space. Translated blocks are not invalidated by stores of other harts.
+     */
+    void setInterconnect(HartInterconnect* interconnect) { m_interconnect = interconnect; }
+
+    /**
+     * @brief synchronize
+     * Discards the cached pages, such that stores of the other harts sharing the address space become visible to the
+     * loads of the interpreter.
+     */
+    void synchronize() {
+        m_pages.clear();
+        m_lastPage = nullptr;
+    }
+
+    const Component* getDataMemory() const override { return nullptr; }
+    const Component* getInstrMemory() const override { return nullptr; }
+
+    void clock() override {
+        if (m_finished) {
+            return;
+        }
+        m_watchpointHit = false;
+        if (!m_block || m_blockIndex >= m_block->ops.size() || m_block->ops[m_blockIndex].pc != m_pc) {
+            m_block = &lookupBlock(m_pc);
+            m_blockIndex = 0;
+        }
+        const Op& op = m_block->ops[m_blockIndex++];
+        if (m_traceAccesses) {
+            m_tracedAccesses.push_back({op.pc, op.pc, TracedMemoryAccess::Fetch});
+        }
+        m_pc = op.pc + op.size;
+        m_instrPc = op.pc;
+        op.exec(*this, op);
+        if (m_tracedAccesses.size() >= s_accessBatchSize) {
+            flushTracedAccesses();
+        }
+
+        m_cycleCount++;
+        m_instructionsRetired++;
+    }
+
+    void reverse() override {}
+
+    void reset() override {
+        m_pc = m_pcInitialValue;
+        m_cycleCount = 0;
+        m_instructionsRetired = 0;
+        m_finished = false;
+        m_tracedAccesses.clear();
+        reservation() = HartInterconnect::s_noReservation;
+        // Memory is reinitialized upon reset, so no previous translation or page may be trusted.
+        invalidateMemory();
+    }
+
+    /**
+     * @brief setCounts
+     * Sets the cycle and retired instruction counts of the interpreter, ie. when restoring an execution which it was
+     * part of from a simulation snapshot.
+     */
+    void setCounts(long long cycles, long long instructionsRetired) {
+        m_cycleCount = cycles;
+        m_instructionsRetired = instructionsRetired;
+    }
+
+    /**
+     * @brief invalidateMemory
+     * Discards all cached pages and translated blocks. Must be called if the memory address space has been modified
+     * outside of the interpreter, before continuing execution.
+     */
+    void invalidateMemory() {
+        m_pages.clear();
+        m_lastPage = nullptr;
+        invalidateBlocks();
+    }
+
+    /**
+     * @brief invalidateMemory
+     * Discards the cached pages and translated blocks which overlap the bytes [address; address + size[.
+     */
+    void invalidateMemory(const uint32_t address, const unsigned size) {
+        if (size == 0) {
+            return;
+        }
+        for (uint64_t page = address >> s_pageBits; page <= (uint64_t(address) + size - 1) >> s_pageBits; page++) {
+            m_pages.erase(static_cast<uint32_t>(page));
+        }
+        m_lastPage = nullptr;
+        invalidateBlocksAt(address, size);
+    }
+
+private:
+    struct Op;
+    using OpHandler = void (*)(RVISS&, const Op&);
+
+    /**
+     * @brief The Op struct
+     * A pre-decoded instruction of size bytes. Handlers are executed with the program counter already set to the
+     * address of the sequentially next instruction; control-flow handlers overwrite it.
+     */
+    struct Op {
+        OpHandler exec;
+        uint32_t pc;
+        uint32_t imm;
+        uint8_t rd, rs1, rs2, size;
+    };
+
+    struct Block {
+        uint32_t start = 0;
+        uint32_t end = 0;
+        std::vector<Op> ops;
+    };
+
+    // Upper bound on the number of instructions in a block, to bound translation of long straight-line sequences.
+    static constexpr unsigned s_maxBlockSize = 256;
+
+    /// Locks the memory address space whilst accessing it, if it is shared with other harts
+    std::unique_lock<std::mutex> lockMemory() const {
+        return m_interconnect ? std::unique_lock<std::mutex>(m_interconnect->mutex) : std::unique_lock<std::mutex>();
+    }
+
+    /// Word reserved by the last LR.W of the hart, if any. Must be accessed whilst the memory is locked.
+    uint32_t& reservation() { return m_interconnect ? m_interconnect->reservations[hartId()] : m_reservation; }
+
+    inline uint32_t reg(unsigned i) const { return i == 0 ? 0 : m_regMem->readMemConst(i << 2); }
+    inline void setReg(unsigned i, uint32_t v) {
+        if (i != 0) {
+            m_regMem->writeMem(i << 2, v);
+        }
+    }
+
+    Block& lookupBlock(const uint32_t pc) {
+        auto it = m_blocks.find(pc);
+        if (it != m_blocks.end()) {
+            return it->second;
+        }
+
+        if (!isExecutableAddress(pc)) {
+            // Code outside of the executable region may be modified without us noticing; never cache it.
+            m_scratchBlock = translateBlock(pc);
+            return m_scratchBlock;
+        }
+        return m_blocks.emplace(pc, translateBlock(pc)).first->second;
+    }
+
+    void invalidateBlocks() {
+        m_blocks.clear();
+        m_block = nullptr;
+    }
+
+    /**
+     * @brief invalidateBlocksAt
+     * Removes any cached block which contains the bytes [address; address + size[.
+     */
+    void invalidateBlocksAt(const uint32_t address, const unsigned size) {
+        for (auto it = m_blocks.begin(); it != m_blocks.end();) {
+            const Block& block = it->second;
+            if (address < block.end && block.start < address + size) {
+                if (m_block == &block) {
+                    m_block = nullptr;
+                }
+                it = m_blocks.erase(it);
+            } else {
+                it++;
+            }
+        }
+    }
+
+    static constexpr unsigned s_pageBits = 12;
+    static constexpr uint32_t s_pageSize = 1 << s_pageBits;
+    using Page = std::array<uint8_t, s_pageSize>;
+
+    /**
+     * @brief page
+     * @returns the cached page containing @param address, copying it from the memory address space upon first touch.
+     * The copy does not insert the untouched words of the page into the sparse memory address space.
+     */
+    inline Page& page(const uint32_t address) {
+        const uint32_t number = address >> s_pageBits;
+        if (m_lastPage && m_lastPageNumber == number) {
+            return *m_lastPage;
+        }
+        auto& page = m_pages[number];
+        if (!page) {
+            page = std::make_unique<Page>();
+            const auto lock = lockMemory();
+            const uint32_t base = number << s_pageBits;
+            for (uint32_t offset = 0; offset < s_pageSize; offset += 4) {
+                const uint32_t word = m_memory->readMemConst(base + offset);
+                for (unsigned i = 0; i < 4; i++) {
+                    (*page)[offset + i] = static_cast<uint8_t>(word >> (i * 8));
+                }
+            }
+        }
+        m_lastPageNumber = number;
+        m_lastPage = page.get();
+        return *page;
+    }
+
+    inline uint32_t load(const uint32_t address, const unsigned size) {
+        if (m_traceAccesses) {
+            m_tracedAccesses.push_back({address, m_instrPc, TracedMemoryAccess::Load});
+        }
+        if (m_watchpoints && m_watchpoints->isWatchedPage(address)) {
+            m_watchpointHit |= m_watchpoints->checkAccess(address, size, false, m_instrPc);
+        }
+        if (m_devices && m_devices->isDevicePage(address)) {
+            uint32_t value = 0;
+            if (m_devices->read(address, value)) {
+                return value;
+            }
+        }
+        const uint32_t offset = address & (s_pageSize - 1);
+        if (offset > s_pageSize - 4) {
+            // Accesses spanning two pages are rare; read them directly from the address space
+            const auto lock = lockMemory();
+            return m_memory->readMemConst(address);
+        }
+        const uint8_t* bytes = page(address).data() + offset;
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    inline void store(const uint32_t address, const uint32_t value, const unsigned size) {
+        if (m_traceAccesses) {
+            m_tracedAccesses.push_back({address, m_instrPc, TracedMemoryAccess::Store});
+        }
+        const bool watched = m_watchpoints && m_watchpoints->isWatchedPage(address);
+        if (watched) {
+            m_watchpointHit |= m_watchpoints->checkAccess(address, size, true, m_instrPc);
+        }
+        {
+            const auto lock = lockMemory();
+            m_memory->writeMem(address, value, size);
+            clearReservations(address, size);
+            if (watched) {
+                m_watchpointHit |= m_watchpoints->checkChange(address, size, m_instrPc, *m_memory);
+            }
+        }
+        if (m_devices && m_devices->isDevicePage(address)) {
+            m_devices->write(address, value, size);
+        }
+        updateCachedPages(address, value, size);
+        if (isExecutableAddress(address)) {
+            invalidateBlocksAt(address, size);
+        }
+    }
+
+    /// Clears the reservations of all harts sharing the address space on the words of [address; address + size[
+    void clearReservations(const uint32_t address, const unsigned size) {
+        if (!m_interconnect) {
+            return;
+        }
+        for (uint32_t& reserved : m_interconnect->reservations) {
+            if (reserved == (address & ~0b11u) || reserved == ((address + size - 1) & ~0b11u)) {
+                reserved = HartInterconnect::s_noReservation;
+            }
+        }
+    }
+
+    /// Writes a store through to the pages cached by the interpreter
+    void updateCachedPages(const uint32_t address, const uint32_t value, const unsigned size) {
+        for (unsigned i = 0; i < size; i++) {
+            // Only pages which have already been touched are updated; others are copied once touched
+            const uint32_t byteAddress = address + i;
+            const uint32_t number = byteAddress >> s_pageBits;
+            Page* p = m_lastPage && m_lastPageNumber == number ? m_lastPage : nullptr;
+            if (!p) {
+                const auto it = m_pages.find(number);
+                p = it == m_pages.end() ? nullptr : it->second.get();
+            }
+            if (p) {
+                (*p)[byteAddress & (s_pageSize - 1)] = static_cast<uint8_t>(value >> (i * 8));
+            }
+        }
+    }
+
+    /**
+     * @brief atomic
+     * Executes the LR.W, SC.W or AMO*.W instruction @p op, of which imm holds funct5, upon the memory address space.
+     * The access is traced and matched against watchpoints as a store, but is not dispatched to memory mapped devices.
+     */
+    void atomic(const Op& op) {
+        const uint32_t address = reg(op.rs1);
+        const uint32_t operand = reg(op.rs2);
+        const unsigned funct5 = op.imm;
+        const unsigned rd = op.rd;
+        const uint32_t pc = m_instrPc;
+        if (m_traceAccesses) {
+            m_tracedAccesses.push_back({address, pc, TracedMemoryAccess::Store});
+        }
+        const bool watched = m_watchpoints && m_watchpoints->isWatchedPage(address);
+        if (watched) {
+            m_watchpointHit |= m_watchpoints->checkAccess(address, 4, funct5 != 0b00010, pc);
+        }
+
+        uint32_t result = 0;
+        bool write = true;
+        uint32_t value = 0;
+        {
+            const auto lock = lockMemory();
+            const uint32_t loaded = m_memory->readMem(address);
+            result = loaded;
+            switch (funct5) {
+                case 0b00010:  // LR.W
+                    reservation() = address & ~0b11u;
+                    write = false;
+                    break;
+                case 0b00011:  // SC.W; succeeds, writing 0 to rd, if the word is still reserved
+                    write = reservation() == (address & ~0b11u);
+                    result = write ? 0 : 1;
+                    value = operand;
+                    reservation() = HartInterconnect::s_noReservation;
+                    break;
+                case 0b00001:  // AMOSWAP.W
+                    value = operand;
+                    break;
+                case 0b00000:  // AMOADD.W
+                    value = loaded + operand;
+                    break;
+                case 0b00100:  // AMOXOR.W
+                    value = loaded ^ operand;
+                    break;
+                case 0b01100:  // AMOAND.W
+                    value = loaded & operand;
+                    break;
+                case 0b01000:  // AMOOR.W
+                    value = loaded | operand;
+                    break;
+                case 0b10000:  // AMOMIN.W
+                    value = static_cast<int32_t>(loaded) < static_cast<int32_t>(operand) ? loaded : operand;
+                    break;
+                case 0b10100:  // AMOMAX.W
+                    value = static_cast<int32_t>(loaded) > static_cast<int32_t>(operand) ? loaded : operand;
+                    break;
+                case 0b11000:  // AMOMINU.W
+                    value = std::min(loaded, operand);
+                    break;
+                case 0b11100:  // AMOMAXU.W
+                    value = std::max(loaded, operand);
+                    break;
+                default:
+                    // Unknown atomic operations are executed as NOPs, as other unknown instructions
+                    return;
+            }
+            if (write) {
+                m_memory->writeMem(address, value, 4);
+                clearReservations(address, 4);
+                if (watched) {
+                    m_watchpointHit |= m_watchpoints->checkChange(address, 4, pc, *m_memory);
+                }
+            }
+        }
+        if (write) {
+            updateCachedPages(address, value, 4);
+            if (isExecutableAddress(address)) {
+                invalidateBlocksAt(address, 4);
+            }
+        }
+        setReg(rd, result);
+    }
+
+    Block translateBlock(const uint32_t start) const {
+        const auto lock = lockMemory();
+        Block block;
+        block.start = start;
+        uint32_t pc = start;
+        bool endOfBlock = false;
+        do {
+            uint32_t instr = m_memory->readMemConst(pc);
+            const unsigned size = m_compressed ? instructionLength(instr) : 4;
+            if (size == 2) {
+                instr = expandCompressed(instr & 0xffff);
+            }
+            block.ops.push_back(translate(instr, pc, size, endOfBlock));
+            pc += size;
+        } while (!endOfBlock && block.ops.size() < s_maxBlockSize && isExecutableAddress(pc));
+        block.end = pc;
+        return block;
+    }
+
+    static Op translate(const uint32_t instr, const uint32_t pc, const unsigned size, bool& endOfBlock) {
+        const auto r = decodeRInstr(instr);
+        Op op{nullptr,
+              pc,
+              0,
+              static_cast<uint8_t>(r.rd),
+              static_cast<uint8_t>(r.rs1),
+              static_cast<uint8_t>(r.rs2),
+              static_cast<uint8_t>(size)};
+        const uint32_t immI = static_cast<uint32_t>(signextend<int32_t, 12>(decodeIInstr(instr).imm));
+
+        switch (instr & 0b1111111) {
+            case instrType::LUI:
+                op.imm = instr & 0xfffff000;
+                op.exec = [](RVISS& s, const Op& o) { s.setReg(o.rd, o.imm); };
+                break;
+            case instrType::AUIPC:
+                op.imm = instr & 0xfffff000;
+                op.exec = [](RVISS& s, const Op& o) { s.setReg(o.rd, o.pc + o.imm); };
+                break;
+            case instrType::JAL:
+                endOfBlock = true;
+                op.imm = static_cast<uint32_t>(signextend<int32_t, 21>(immediate(decodeJInstr(instr))));
+                op.exec = [](RVISS& s, const Op& o) {
+                    s.setReg(o.rd, o.pc + o.size);
+                    s.m_pc = o.pc + o.imm;
+                };
+                break;
+            case instrType::JALR:
+                endOfBlock = true;
+                op.imm = immI;
+                op.exec = [](RVISS& s, const Op& o) {
+                    const uint32_t target = (s.reg(o.rs1) + o.imm) & ~0b1;
+                    s.setReg(o.rd, o.pc + o.size);
+                    s.m_pc = target;
+                };
+                break;
+            case instrType::BRANCH:
+                endOfBlock = true;
+                op.imm = static_cast<uint32_t>(signextend<int32_t, 13>(immediate(decodeBInstr(instr))));
+                op.exec = translateBranch(r.funct3);
+                break;
+            case instrType::LOAD:
+                op.imm = immI;
+                op.exec = translateLoad(r.funct3);
+                break;
+            case instrType::STORE:
+                op.imm = static_cast<uint32_t>(signextend<int32_t, 12>(immediate(decodeSInstr(instr))));
+                op.exec = translateStore(r.funct3);
+                break;
+            case instrType::OP_IMM:
+                op.imm = immI;
+                op.exec = translateOpImm(r.funct3, r.funct7);
+                break;
+            case instrType::OP:
+                op.exec = translateOp(r.funct3, r.funct7);
+                break;
+            case instrType::AMO:
+                // Stores may invalidate the block which is currently executing; see translateStore()
+                op.imm = instr >> 27;
+                op.exec = [](RVISS& s, const Op& o) { s.atomic(o); };
+                break;
+            case instrType::ECALL:
+                if (r.funct3 != 0b000) {
+                    // CSR instructions; only the read-only counters are implemented, so only the read is performed
+                    op.imm = instr >> 20;
+                    op.exec = [](RVISS& s, const Op& o) { s.setReg(o.rd, s.readCSR(o.imm)); };
+                    break;
+                }
+                endOfBlock = true;
+                op.exec = [](RVISS& s, const Op&) { s.handleSysCall.Emit(); };
+                break;
+            default:
+                break;
+        }
+
+        if (!op.exec) {
+            // Unknown instructions are executed as NOPs, as in the detailed models
+            op.exec = [](RVISS&, const Op&) {};
+        }
+        return op;
+    }
+
+    // clang-format off
+    static OpHandler translateBranch(const unsigned funct3) {
+        switch (funct3) {
+            case 0b000: return [](RVISS& s, const Op& o) { if (s.reg(o.rs1) == s.reg(o.rs2)) s.m_pc = o.pc + o.imm; };
+            case 0b001: return [](RVISS& s, const Op& o) { if (s.reg(o.rs1) != s.reg(o.rs2)) s.m_pc = o.pc + o.imm; };
+            case 0b100: return [](RVISS& s, const Op& o) {
+                if (static_cast<int32_t>(s.reg(o.rs1)) < static_cast<int32_t>(s.reg(o.rs2))) s.m_pc = o.pc + o.imm; };
+            case 0b101: return [](RVISS& s, const Op& o) {
+                if (static_cast<int32_t>(s.reg(o.rs1)) >= static_cast<int32_t>(s.reg(o.rs2))) s.m_pc = o.pc + o.imm; };
+            case 0b110: return [](RVISS& s, const Op& o) { if (s.reg(o.rs1) < s.reg(o.rs2)) s.m_pc = o.pc + o.imm; };
+            case 0b111: return [](RVISS& s, const Op& o) { if (s.reg(o.rs1) >= s.reg(o.rs2)) s.m_pc = o.pc + o.imm; };
+            default: return nullptr;
+        }
+    }
+
+    static OpHandler translateLoad(const unsigned funct3) {
+        switch (funct3) {
+            case 0b000: return [](RVISS& s, const Op& o) {
+                s.setReg(o.rd, static_cast<uint32_t>(signextend<int32_t, 8>(s.load(s.reg(o.rs1) + o.imm, 1) & 0xFF))); };
+            case 0b001: return [](RVISS& s, const Op& o) {
+                s.setReg(o.rd, static_cast<uint32_t>(signextend<int32_t, 16>(s.load(s.reg(o.rs1) + o.imm, 2) & 0xFFFF))); };
+            case 0b010: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.load(s.reg(o.rs1) + o.imm, 4)); };
+            case 0b100: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.load(s.reg(o.rs1) + o.imm, 1) & 0xFF); };
+            case 0b101: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.load(s.reg(o.rs1) + o.imm, 2) & 0xFFFF); };
+            default: return nullptr;
+        }
+    }
+
+    static OpHandler translateStore(const unsigned funct3) {
+        // Stores may invalidate the block which is currently executing, so the operation must not be accessed after the
+        // store has been performed.
+        switch (funct3) {
+            case 0b000: return [](RVISS& s, const Op& o) { s.store(s.reg(o.rs1) + o.imm, s.reg(o.rs2), 1); };
+            case 0b001: return [](RVISS& s, const Op& o) { s.store(s.reg(o.rs1) + o.imm, s.reg(o.rs2), 2); };
+            case 0b010: return [](RVISS& s, const Op& o) { s.store(s.reg(o.rs1) + o.imm, s.reg(o.rs2), 4); };
+            default: return nullptr;
+        }
+    }
+
+    static OpHandler translateOpImm(const unsigned funct3, const unsigned funct7) {
+        switch (funct3) {
+            case 0b000: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) + o.imm); };
+            case 0b010: return [](RVISS& s, const Op& o) {
+                s.setReg(o.rd, static_cast<int32_t>(s.reg(o.rs1)) < static_cast<int32_t>(o.imm) ? 1 : 0); };
+            case 0b011: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) < o.imm ? 1 : 0); };
+            case 0b100: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) ^ o.imm); };
+            case 0b110: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) | o.imm); };
+            case 0b111: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) & o.imm); };
+            case 0b001: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) << o.rs2); };
+            case 0b101:
+                if (funct7 == 0b0100000) {
+                    return [](RVISS& s, const Op& o) {
+                        s.setReg(o.rd, static_cast<uint32_t>(static_cast<int32_t>(s.reg(o.rs1)) >> o.rs2)); };
+                }
+                return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) >> o.rs2); };
+            default: return nullptr;
+        }
+    }
+
+    static OpHandler translateOp(const unsigned funct3, const unsigned funct7) {
+        if (funct7 == 0b1) {
+            return translateMExtension(funct3);
+        }
+        switch (funct3) {
+            case 0b000:
+                if (funct7 == 0b0100000) {
+                    return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) - s.reg(o.rs2)); };
+                }
+                return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) + s.reg(o.rs2)); };
+            case 0b001: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) << (s.reg(o.rs2) & 0b11111)); };
+            case 0b010: return [](RVISS& s, const Op& o) {
+                s.setReg(o.rd, static_cast<int32_t>(s.reg(o.rs1)) < static_cast<int32_t>(s.reg(o.rs2)) ? 1 : 0); };
+            case 0b011: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) < s.reg(o.rs2) ? 1 : 0); };
+            case 0b100: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) ^ s.reg(o.rs2)); };
+            case 0b101:
+                if (funct7 == 0b0100000) {
+                    return [](RVISS& s, const Op& o) {
+                        s.setReg(o.rd, static_cast<uint32_t>(static_cast<int32_t>(s.reg(o.rs1)) >> (s.reg(o.rs2) & 0b11111))); };
+                }
+                return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) >> (s.reg(o.rs2) & 0b11111)); };
+            case 0b110: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) | s.reg(o.rs2)); };
+            case 0b111: return [](RVISS& s, const Op& o) { s.setReg(o.rd, s.reg(o.rs1) & s.reg(o.rs2)); };
+            default: return nullptr;
+        }
+    }
+
+    static OpHandler translateMExtension(const unsigned funct3) {
+        switch (funct3) {
+            case 0b000: return [](RVISS& s, const Op& o) {
+                s.setReg(o.rd, static_cast<uint32_t>(static_cast<int32_t>(s.reg(o.rs1)) * static_cast<int32_t>(s.reg(o.rs2)))); };
+            case 0b001: return [](RVISS& s, const Op& o) { s.setReg(o.rd, mulh(s.reg(o.rs1), s.reg(o.rs2))); };
+            case 0b010: return [](RVISS& s, const Op& o) { s.setReg(o.rd, mulhsu(s.reg(o.rs1), s.reg(o.rs2))); };
+            case 0b011: return [](RVISS& s, const Op& o) { s.setReg(o.rd, mulhu(s.reg(o.rs1), s.reg(o.rs2))); };
+            case 0b100: return [](RVISS& s, const Op& o) { s.setReg(o.rd, div(s.reg(o.rs1), s.reg(o.rs2))); };
+            case 0b101: return [](RVISS& s, const Op& o) { s.setReg(o.rd, divu(s.reg(o.rs1), s.reg(o.rs2))); };
+            case 0b110: return [](RVISS& s, const Op& o) { s.setReg(o.rd, rem(s.reg(o.rs1), s.reg(o.rs2))); };
+            case 0b111: return [](RVISS& s, const Op& o) { s.setReg(o.rd, remu(s.reg(o.rs1), s.reg(o.rs2))); };
+            default: return nullptr;
+        }
+    }
+    // clang-format on
+
+    static uint32_t mulh(const uint32_t op1, const uint32_t op2) {
+        return static_cast<uint32_t>(
+            (static_cast<int64_t>(static_cast<int32_t>(op1)) * static_cast<int64_t>(static_cast<int32_t>(op2))) >> 32);
+    }
+    static uint32_t mulhsu(const uint32_t op1, const uint32_t op2) {
+        return static_cast<uint32_t>((static_cast<int64_t>(static_cast<int32_t>(op1)) * static_cast<uint64_t>(op2)) >>
+                                     32);
+    }
+    static uint32_t mulhu(const uint32_t op1, const uint32_t op2) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(op1) * static_cast<uint64_t>(op2)) >> 32);
+    }
+    static uint32_t div(const uint32_t op1, const uint32_t op2) {
+        if (op2 == 0) {
+            return static_cast<uint32_t>(-1);
+        } else if (op1 == 0x80000000 && static_cast<int32_t>(op2) == -1) {
+            // Overflow
+            return 0x80000000;
+        }
+        return static_cast<uint32_t>(static_cast<int32_t>(op1) / static_cast<int32_t>(op2));
+    }
+    static uint32_t divu(const uint32_t op1, const uint32_t op2) {
+        return op2 == 0 ? static_cast<uint32_t>(-1) : op1 / op2;
+    }
+    static uint32_t rem(const uint32_t op1, const uint32_t op2) {
+        if (op2 == 0) {
+            return op1;
+        } else if (op1 == 0x80000000 && static_cast<int32_t>(op2) == -1) {
+            // Overflow
+            return 0;
+        }
+        return static_cast<uint32_t>(static_cast<int32_t>(op1) % static_cast<int32_t>(op2));
+    }
+    static uint32_t remu(const uint32_t op1, const uint32_t op2) { return op2 == 0 ? op1 : op1 % op2; }
+
+    SparseArray* m_memory = nullptr;
+    SparseArray* m_regMem = nullptr;
+    HartInterconnect* m_interconnect = nullptr;
+    /// Reservation of LR.W when not sharing the address space with other harts
+    uint32_t m_reservation = HartInterconnect::s_noReservation;
+
+    uint32_t m_pc = 0;
+    // Address of the executing instruction; m_pc has been advanced past it
+    uint32_t m_instrPc = 0;
+    uint32_t m_pcInitialValue = 0;
+    bool m_compressed = true;
+    bool m_finished = false;
+    bool m_traceAccesses = false;
+    Watchpoints* m_watchpoints = nullptr;
+    bool m_watchpointHit = false;
+    MMIODevices* m_devices = nullptr;
+    // Accesses traced since accessesTraced was last emitted
+    std::vector<TracedMemoryAccess> m_tracedAccesses;
+    void flushTracedAccesses() {
+        if (!m_tracedAccesses.empty()) {
+            accessesTraced.Emit(m_tracedAccesses);
+            m_tracedAccesses.clear();
+        }
+    }
+
+    // Page cache; m_lastPage is the most recently accessed page, numbered m_lastPageNumber
+    std::unordered_map<uint32_t, std::unique_ptr<Page>> m_pages;
+    Page* m_lastPage = nullptr;
+    uint32_t m_lastPageNumber = 0;
+
+    // Translation cache
+    std::unordered_map<uint32_t, Block> m_blocks;
+    Block m_scratchBlock;
+    const Block* m_block = nullptr;
+    unsigned m_blockIndex = 0;
+};
+
+}  // namespace core
+}  // namespace vsrtl
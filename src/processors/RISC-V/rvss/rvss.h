@@ -14,6 +14,7 @@
 #include "../rv_control.h"
 #include "../rv_decode.h"
 #include "../rv_ecallchecker.h"
+#include "../rv_expander.h"
 #include "../rv_immediate.h"
 #include "../rv_memory.h"
 #include "../rv_registerfile.h"
@@ -27,8 +28,10 @@ public:
     RVSS() : RipesProcessor("Single Cycle RISC-V Processor") {
         // -----------------------------------------------------------------------
         // Program counter
+        // The program counter is incremented by the size of the fetched instruction, which is 2 for compressed
+        // instructions
         pc_reg->out >> pc_4->op1;
-        4 >> pc_4->op2;
+        expander->length >> pc_4->op2;
         pc_src->out >> pc_reg->in;
 
         // Note: pc_src works uses the PcSrc enum, but is selected by the boolean signal
@@ -41,9 +44,13 @@ public:
         pc_reg->out >> instr_mem->addr;
         instr_mem->setMemory(m_memory);
 
+        // -----------------------------------------------------------------------
+        // Expander
+        instr_mem->data_out >> expander->instr;
+
         // -----------------------------------------------------------------------
         // Decode
-        instr_mem->data_out >> decode->instr;
+        expander->exp_instr >> decode->instr;
 
         // -----------------------------------------------------------------------
         // Control signals
@@ -52,7 +59,7 @@ public:
         // -----------------------------------------------------------------------
         // Immediate
         decode->opcode >> immediate->opcode;
-        instr_mem->data_out >> immediate->instr;
+        expander->exp_instr >> immediate->instr;
 
         // -----------------------------------------------------------------------
         // Registers
@@ -96,6 +103,7 @@ public:
         alu_op2_src->out >> alu->op2;
 
         control->alu_ctrl >> alu->ctrl;
+        alu->setProcessor(this);
 
         // -----------------------------------------------------------------------
         // Data memory
@@ -108,7 +116,7 @@ public:
         // -----------------------------------------------------------------------
         // Ecall checker
         decode->opcode >> ecallChecker->opcode;
-        ecallChecker->setSysCallSignal(&handleSysCall);
+        ecallChecker->setProcessor(this);
         0 >> ecallChecker->stallEcallHandling;
     }
 
@@ -117,6 +125,7 @@ public:
     SUBCOMPONENT(alu, ALU);
     SUBCOMPONENT(control, Control);
     SUBCOMPONENT(immediate, Immediate);
+    SUBCOMPONENT(expander, Expander);
     SUBCOMPONENT(decode, Decode);
     SUBCOMPONENT(branch, Branch);
     SUBCOMPONENT(pc_4, Adder<RV_REG_WIDTH>);
@@ -131,7 +140,7 @@ public:
     SUBCOMPONENT(alu_op2_src, TYPE(EnumMultiplexer<AluSrc2, RV_REG_WIDTH>));
 
     // Memories
-    SUBCOMPONENT(instr_mem, TYPE(ROM<RV_REG_WIDTH, RV_INSTR_WIDTH>));
+    SUBCOMPONENT(instr_mem, TYPE(RVInstrMemory<RV_REG_WIDTH, RV_INSTR_WIDTH>));
     SUBCOMPONENT(data_mem, TYPE(RVMemory<RV_REG_WIDTH, RV_REG_WIDTH>));
 
     // Gates
@@ -145,7 +154,7 @@ public:
     SUBCOMPONENT(ecallChecker, EcallChecker);
 
     // Ripes interface compliance
-    virtual const ISAInfoBase* implementsISA() const override { return ISAInfo<ISA::RV32IM>::instance(); }
+    virtual const ISAInfoBase* implementsISA() const override { return ISAInfo<ISA::RV32IMC>::instance(); }
     unsigned int stageCount() const override { return 1; }
     unsigned int getPcForStage(unsigned int) const override { return pc_reg->out.uValue(); }
     unsigned int nextFetchedAddress() const override { return pc_src->out.uValue(); }
@@ -171,6 +180,8 @@ public:
 
     const Component* getDataMemory() const override { return data_mem; }
     const Component* getInstrMemory() const override { return instr_mem; }
+    void setMMIODevices(MMIODevices* devices) override { data_mem->setDevices(devices); }
+    void memoryModified() override { instr_mem->invalidate(); }
 
     void setRegister(unsigned i, uint32_t v) override { setSynchronousValue(registerFile->_wr_mem, i, v); }
 
@@ -178,9 +189,12 @@ public:
         // Single cycle processor; 1 instruction retired per cycle!
         m_instructionsRetired++;
 
-        // m_finishInNextCycle may be set during Design::clock(). Store the value before clocking the processor, and
-        // emit finished if this was the final clock cycle.
+        // m_finishInNextCycle may be set during RipesProcessor::clock(). Store the value before clocking the processor,
+        // and emit finished if this was the final clock cycle.
         const bool finishInThisCycle = m_finishInNextCycle;
+        if (data_mem->wr_en.uValue()) {
+            instr_mem->invalidate(data_mem->addr.uValue(), 4);
+        }
         RipesProcessor::clock();
         if (finishInThisCycle) {
             m_finished = true;
@@ -189,6 +203,8 @@ public:
 
     void reverse() override {
         m_instructionsRetired--;
+        // The store being reversed is not known until the processor has been reversed
+        instr_mem->invalidate();
         RipesProcessor::reverse();
         // Ensure that reverses performed when we expected to finish in the following cycle, clears this expectation.
         m_finishInNextCycle = false;
@@ -201,6 +217,17 @@ public:
         m_finished = false;
     }
 
+    void saveCheckpoint(ProcessorCheckpoint& checkpoint) override {
+        RipesProcessor::saveCheckpoint(checkpoint);
+        checkpoint.processorState = {m_finishInNextCycle, m_finished};
+    }
+
+    void restoreCheckpoint(const ProcessorCheckpoint& checkpoint) override {
+        RipesProcessor::restoreCheckpoint(checkpoint);
+        m_finishInNextCycle = checkpoint.processorState.at(0);
+        m_finished = checkpoint.processorState.at(1);
+    }
+
 private:
     bool m_finishInNextCycle = false;
     bool m_finished = false;
@@ -1,14 +1,22 @@
 #pragma once
 
+#include <QByteArray>
 #include <QString>
 
+#include <algorithm>
+#include <climits>
 #include <map>
+#include <memory>
+#include <vector>
 #include "Signals/Signal.h"
 #include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_register.h"
 
 #include "../isainfo.h"
 
 namespace Ripes {
+class MMIODevices;
+
 enum SysCall {
     None = 0,
     PrintInt = 1,
@@ -19,7 +27,12 @@ enum SysCall {
     PrintIntHex = 34,
     PrintIntBinary = 35,
     PrintIntUnsigned = 36,
-    Exit2 = 93
+    Close = 57,
+    LSeek = 62,
+    Read = 63,
+    Write = 64,
+    Exit2 = 93,
+    Open = 1024
 };
 
 /**
@@ -50,6 +63,144 @@ namespace vsrtl {
 namespace core {
 using namespace Ripes;
 
+/**
+ * @brief The BranchPredictionStatistics struct
+ * Statistics of the branch predictor of a processor. predictions counts the resolved control-flow instructions, and
+ * flushCyclesSaved the cycles which would have been flushed without prediction, less those flushed upon mispredictions.
+ */
+struct BranchPredictionStatistics {
+    long long predictions = 0;
+    long long mispredictions = 0;
+    long long flushCyclesSaved = 0;
+};
+
+/**
+ * @brief The FunctionalUnitLatencies struct
+ * Latencies in cycles of the multi-cycle functional units of a processor; the number of cycles from an instruction
+ * entering the unit until its result may be consumed. The multiplier is pipelined, accepting an instruction each cycle,
+ * whereas the divider is iterative, and is occupied for the full latency of each division.
+ */
+struct FunctionalUnitLatencies {
+    unsigned multiply = 1;
+    unsigned divide = 1;
+};
+
+/**
+ * @brief The FunctionalUnitStatistics struct
+ * Cycles in which a processor stalled an instruction on the result of a multi-cycle functional unit (dependency), or on
+ * the unit being occupied (structural).
+ */
+struct FunctionalUnitStatistics {
+    long long dependencyStallCycles = 0;
+    long long structuralStallCycles = 0;
+};
+
+/**
+ * @brief The HazardStatistics struct
+ * Breakdown of the causes of the stalls and bubbles of a pipelined processor. Load-use and ECALL stalls are counted in
+ * cycles, control-flow flushes in resolved mispredictions, and forwarded operands in the operands of the instructions
+ * executed which were forwarded from a later stage. Empty fetch cycles are those in which no instruction entered the
+ * pipeline from the fetch stage, due to a fetch stall or a flush.
+ */
+struct HazardStatistics {
+    long long loadUseStallCycles = 0;
+    long long ecallStallCycles = 0;
+    long long controlFlowFlushes = 0;
+    long long forwardedOperands = 0;
+    long long emptyFetchCycles = 0;
+};
+
+/**
+ * @brief The ProcessorCheckpoint struct
+ * A full snapshot of the state of a processor at a given cycle. Restoring a checkpoint returns the processor to the
+ * exact state it was in when the checkpoint was created.
+ * If memory and registers are not set, the checkpoint only describes the microarchitectural state of the processor,
+ * and restoring it leaves the memory and architectural registers of the processor untouched.
+ */
+struct ProcessorCheckpoint {
+    long long cycle = 0;
+    long long instructionsRetired = 0;
+    long long memoryStallCycles = 0;
+    BranchPredictionStatistics branchPrediction;
+    FunctionalUnitStatistics functionalUnits;
+    HazardStatistics hazards;
+    std::unique_ptr<SparseArray> memory;
+    std::unique_ptr<SparseArray> registers;
+    /// Set if the memory and architectural registers are recorded separately (see CheckpointJournal), in which case
+    /// saveCheckpoint() does not copy them, and the checkpoint is restored after they have been restored.
+    bool journaled = false;
+    /// Values of all registers in the design, in the order of a depth-first traversal of the component tree
+    std::vector<VSRTL_VT_U> registerValues;
+    /// Any additional state which is kept by the processor outside of its components
+    std::vector<long long> processorState;
+};
+
+/**
+ * @brief The StageValidityCache class
+ * Memoizes the mask of the pipeline stages of a processor which carry a valid instruction. finished() and stageInfo()
+ * are queried several times per cycle while running, so the mask is computed at most once per cycle, and recomputed
+ * once the cycle changes or once invalidated, as is required when the pipeline state is modified outside of clocking.
+ */
+class StageValidityCache {
+public:
+    /// @returns the mask of cycle @p cycle, computed by @p compute if not already known
+    template <typename Compute>
+    unsigned mask(long long cycle, const Compute& compute) const {
+        if (m_cycle != cycle) {
+            m_mask = compute();
+            m_cycle = cycle;
+        }
+        return m_mask;
+    }
+    void invalidate() { m_cycle = -1; }
+
+private:
+    mutable unsigned m_mask = 0;
+    mutable long long m_cycle = -1;
+};
+
+/**
+ * @brief The MemoryLatencyModel class
+ * Determines the number of cycles which a processor is stalled for upon accessing its instruction and data memories,
+ * in addition to the single cycle of the access itself (ie. the miss penalty of a cache in front of the memory). The
+ * model is queried whenever the processor is propagated in a cycle where it issues a new access, both before and after
+ * the access has been simulated by the model, and must return the same number of cycles in both cases.
+ */
+class MemoryLatencyModel {
+public:
+    virtual ~MemoryLatencyModel() = default;
+    virtual unsigned fetchStallCycles(uint32_t address) const = 0;
+    virtual unsigned dataStallCycles(uint32_t address, bool write) const = 0;
+};
+
+/**
+ * @brief The PerformanceCounter enum
+ * Events counted by the hardware performance monitor of a processor, which programs read through the counter CSRs. The
+ * cycle and time CSRs read Cycles, instret reads InstructionsRetired, and hpmcounter3..8 read the remaining counters
+ * in order.
+ */
+enum class PerformanceCounter {
+    Cycles,
+    InstructionsRetired,
+    MemoryStallCycles,
+    BranchMispredictions,
+    LoadUseStallCycles,
+    FunctionalUnitStallCycles,
+    InstrCacheMisses,
+    DataCacheMisses
+};
+
+/**
+ * @brief The PerformanceCounterSource class
+ * Provides the counts of the performance counters of a processor as seen by the environment, which may simulate events
+ * outside of the processor (ie. cache misses), or may split execution across multiple processor models.
+ */
+class PerformanceCounterSource {
+public:
+    virtual ~PerformanceCounterSource() = default;
+    virtual long long performanceCounter(PerformanceCounter counter) const = 0;
+};
+
 class RipesProcessor : public Design {
 public:
     RipesProcessor(std::string name) : Design(name) {}
@@ -73,6 +224,34 @@ public:
      */
     virtual unsigned int getPcForStage(unsigned int stageIndex) const = 0;
 
+    /**
+     * @brief dataAccessStage
+     * @return index of the stage in which the processor accesses its data memory
+     */
+    virtual unsigned int dataAccessStage() const { return 0; }
+
+    /**
+     * @brief fetchWidth
+     * @return number of consecutive instructions fetched in each cycle, starting at the address of stage 0
+     */
+    virtual unsigned int fetchWidth() const { return 1; }
+
+    /**
+     * @brief retireWidth
+     * @return maximum number of instructions retired in each cycle. These are retired from the last retireWidth()
+     * stages, of which the last stage carries the oldest instruction.
+     */
+    virtual unsigned int retireWidth() const { return 1; }
+
+    /**
+     * @brief isFetching
+     * @returns true if the instruction at @p address is fetched in the current cycle
+     */
+    bool isFetching(uint32_t address) const {
+        const uint32_t offset = address - getPcForStage(0);
+        return (offset & 0b11) == 0 && (offset >> 2) < fetchWidth();
+    }
+
     /**
      * @brief stageName
      * @return name of stage identified by @param stageIndex
@@ -124,6 +303,65 @@ public:
      */
     virtual void setRegister(unsigned i, uint32_t v) = 0;
 
+    /**
+     * @brief readRegisters
+     * Reads the values of the first @p count architectural registers into @p values.
+     */
+    virtual void readRegisters(uint32_t* values, unsigned count) const {
+        for (unsigned i = 0; i < count; i++) {
+            values[i] = getRegister(i);
+        }
+    }
+
+    /**
+     * @brief readMemRange
+     * Reads the @p length bytes at @p address into @p data, a word at a time. Bytes which are not present in the
+     * address space read as zero, and are not populated by the read.
+     * @returns true if any byte of the range is present.
+     */
+    bool readMemRange(uint32_t address, uint8_t* data, size_t length) {
+        const SparseArray& memory = getMemory();
+        bool any = false;
+        for (size_t i = 0; i < length; i += 4) {
+            const unsigned bytes = static_cast<unsigned>(std::min<size_t>(4, length - i));
+            unsigned present = 0;
+            for (unsigned j = 0; j < bytes; j++) {
+                present |= memory.contains(address + static_cast<uint32_t>(i + j)) ? 1u << j : 0;
+            }
+            const uint32_t word = present != 0 ? memory.readMemConst(address + static_cast<uint32_t>(i)) : 0;
+            for (unsigned j = 0; j < bytes; j++) {
+                data[i + j] = present & (1u << j) ? static_cast<uint8_t>(word >> (j * CHAR_BIT)) : 0;
+            }
+            any |= present != 0;
+        }
+        return any;
+    }
+
+    /**
+     * @brief writeMemRange
+     * Writes the @p length bytes of @p data to @p address, a word at a time.
+     */
+    void writeMemRange(uint32_t address, const uint8_t* data, size_t length) {
+        SparseArray& memory = getMemory();
+        size_t i = 0;
+        for (; i + 4 <= length; i += 4) {
+            const uint32_t word = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16) |
+                                  (static_cast<uint32_t>(data[i + 3]) << 24);
+            memory.writeMem(address + static_cast<uint32_t>(i), word, 4);
+        }
+        for (; i < length; i++) {
+            memory.writeMem(address + static_cast<uint32_t>(i), data[i], 1);
+        }
+        memoryModified();
+    }
+
+    /**
+     * @brief memoryModified
+     * Called whenever the memory address space has been modified other than through the data memory of the processor,
+     * such that the processor discards any state derived from memory (ie. its fetch buffer) before propagating again.
+     */
+    virtual void memoryModified() {}
+
     /**
      * @brief setProgramCounter
      * Sets the program counter of the processor to @param address
@@ -136,25 +374,115 @@ public:
      */
     virtual void setPCInitialValue(uint32_t address) = 0;
 
+    /**
+     * @brief textSectionLoaded
+     * Called by the environment once a new .text section @param text has been installed in memory. Processors may use
+     * this to precompute information derived from the instruction stream.
+     */
+    virtual void textSectionLoaded(const QByteArray& /*text*/) {}
+
     void reset() override {
+        // Memory is reinitialized upon reset
+        memoryModified();
         Design::reset();
         m_instructionsRetired = 0;
+        m_memoryStallCycles = 0;
+    }
+
+    /**
+     * @brief saveCheckpoint
+     * Records the current state of the processor into @p checkpoint. Processors which keep state outside of their
+     * registers and address spaces must extend this function, storing such state in checkpoint.processorState.
+     */
+    virtual void saveCheckpoint(ProcessorCheckpoint& checkpoint) {
+        checkpoint.cycle = m_cycleCount;
+        checkpoint.instructionsRetired = m_instructionsRetired;
+        checkpoint.memoryStallCycles = m_memoryStallCycles;
+        if (!checkpoint.journaled) {
+            checkpoint.memory = std::make_unique<SparseArray>(getMemory());
+            checkpoint.registers = std::make_unique<SparseArray>(getArchRegisters());
+        }
+        checkpoint.registerValues.clear();
+        forEachRegister(this, [&](RegisterBase* reg) { checkpoint.registerValues.push_back(registerValue(reg)); });
+    }
+
+    /**
+     * @brief restoreCheckpoint
+     * Returns the processor to the state recorded in @p checkpoint. The reverse stacks of the design are not modified;
+     * it is the responsibility of the caller to not reverse past the cycle of the checkpoint.
+     */
+    virtual void restoreCheckpoint(const ProcessorCheckpoint& checkpoint) {
+        m_cycleCount = checkpoint.cycle;
+        m_instructionsRetired = checkpoint.instructionsRetired;
+        m_memoryStallCycles = checkpoint.memoryStallCycles;
+        if (checkpoint.memory) {
+            getMemory() = *checkpoint.memory;
+        }
+        memoryModified();
+        if (checkpoint.registers) {
+            getArchRegisters() = *checkpoint.registers;
+        }
+        auto value = checkpoint.registerValues.begin();
+        forEachRegister(this, [&](RegisterBase* reg) {
+            Q_ASSERT(value != checkpoint.registerValues.end());
+            reg->forceValue(0, *value++);
+        });
+        propagateDesign();
+    }
+
+    /**
+     * @brief saveLearnedState/restoreLearnedState
+     * Appends the state which the processor has learned from the instructions executed so far, such as the tables of a
+     * branch predictor, to @p state, or restores it from @p state. Unlike the contents of the pipeline, this state
+     * remains meaningful after execution has been handed over to another engine and back.
+     */
+    virtual void saveLearnedState(std::vector<long long>& /*state*/) const {}
+    virtual void restoreLearnedState(const std::vector<long long>& /*state*/) {}
+
+    /**
+     * @brief setExecutableRange
+     * Set by the environment instantiating the processor to the range of addresses [@p start; @p end[ which are valid
+     * to be executed.
+     */
+    void setExecutableRange(uint32_t start, uint32_t end) {
+        m_executableStart = start;
+        m_executableEnd = end;
     }
 
     /**
      * @brief isExecutableAddress
-     * Callback registerred by the environment instantiating the processor. The environment shall return whether the @p
-     * address is an address which is valid to be executed.
+     * @returns whether @p address is within the executable range set by the environment.
      */
-    std::function<bool(uint32_t)> isExecutableAddress;
+    bool isExecutableAddress(uint32_t address) const {
+        return m_executableStart <= address && address < m_executableEnd;
+    }
 
     /**
      * @brief handleSysCall
      * Signal for passing control to the outside environment whenever a system call must be handled (RISC-V ecall
-     * instruction).
+     * instruction). Ecall instructions are only recorded as pending while the design propagates (see
+     * requestSysCall), and the signal is emitted once the processor has been clocked, such that propagation is free of
+     * side effects and the environment is never re-entered from within the design.
      */
     Gallant::Signal0<> handleSysCall;
 
+    /**
+     * @brief requestSysCall
+     * Records that an ecall instruction is to be handled in the current cycle. Propagating the design more than once
+     * within a cycle, or outside of clock(), requests the system call at most once.
+     */
+    void requestSysCall() { m_sysCallPending = true; }
+
+    void clock() override {
+        // Requests recorded by propagations outside of clocking, such as when restoring a checkpoint, are not handled
+        m_sysCallPending = false;
+        Design::clock();
+        if (m_sysCallPending) {
+            m_sysCallPending = false;
+            handleSysCall.Emit();
+        }
+    }
+
     /**
      * @brief finalize
      * Called from the outside environment to indicate that the processor should start or stop its finishing sequence.
@@ -179,9 +507,178 @@ public:
      */
     long long getInstructionsRetired() const { return m_instructionsRetired; }
 
+    /**
+     * @brief setMemoryLatencyModel
+     * Stalls the processor for the cycles given by @p model upon each access to its instruction and data memories, if
+     * the processor models memory stalls (see supportsMemoryStalls()). nullptr disables stalling. The processor must
+     * be reset after changing the model.
+     */
+    virtual void setMemoryLatencyModel(const MemoryLatencyModel* /*model*/) {}
+    virtual bool supportsMemoryStalls() const { return false; }
+
+    /**
+     * @brief isRepeatedMemoryAccess
+     * @returns true if the access to the instruction (@p instr) or data memory in the current cycle is a repetition of
+     * an earlier access, which the processor is stalled on, rather than a new access.
+     */
+    virtual bool isRepeatedMemoryAccess(bool /*instr*/) const { return false; }
+
+    /**
+     * @brief setMMIODevices
+     * Dispatches the data memory accesses of the processor which target pages holding memory mapped devices through
+     * @p devices, which may be nullptr.
+     */
+    virtual void setMMIODevices(MMIODevices* /*devices*/) {}
+
+    /**
+     * @brief memoryLatenciesChanged
+     * Called by the environment when the stall cycles given by the memory latency model of the processor for the
+     * current cycle may have changed outside of clocking the processor (ie. when the model is reset), such that the
+     * control signals of the processor are re-evaluated.
+     */
+    virtual void memoryLatenciesChanged() {}
+
+    /**
+     * @brief getMemoryStallCycles
+     * @returns the number of cycles in which the processor has been stalled on its memories, as per its memory latency
+     * model.
+     */
+    long long getMemoryStallCycles() const { return m_memoryStallCycles; }
+
+    /**
+     * @brief getBranchPredictionStatistics
+     * @returns the statistics of the branch predictor of the processor, or nullptr if the processor does not predict
+     * branches.
+     */
+    virtual const BranchPredictionStatistics* getBranchPredictionStatistics() const { return nullptr; }
+
+    /**
+     * @brief setFunctionalUnitLatencies
+     * Sets the latencies of the multiplier and divider of the processor, if the processor models multi-cycle functional
+     * units (see supportsFunctionalUnitLatencies()). Otherwise, all instructions execute in a single cycle. The
+     * processor must be reset after changing the latencies.
+     */
+    virtual void setFunctionalUnitLatencies(const FunctionalUnitLatencies& /*latencies*/) {}
+    virtual bool supportsFunctionalUnitLatencies() const { return false; }
+
+    /**
+     * @brief getFunctionalUnitStatistics
+     * @returns the stall statistics of the multi-cycle functional units of the processor, or nullptr if the processor
+     * does not model these.
+     */
+    virtual const FunctionalUnitStatistics* getFunctionalUnitStatistics() const { return nullptr; }
+
+    /**
+     * @brief getHazardStatistics
+     * @returns the breakdown of the hazards and stalls of the processor, or nullptr if the processor does not count
+     * these.
+     */
+    virtual const HazardStatistics* getHazardStatistics() const { return nullptr; }
+
+    /**
+     * @brief performanceCounter
+     * @returns the events counted by @p counter which this processor has simulated since it was reset. Events which the
+     * processor does not model, such as cache misses, read as zero.
+     */
+    long long performanceCounter(PerformanceCounter counter) const {
+        switch (counter) {
+            case PerformanceCounter::Cycles:
+                return m_cycleCount;
+            case PerformanceCounter::InstructionsRetired:
+                return m_instructionsRetired;
+            case PerformanceCounter::MemoryStallCycles:
+                return m_memoryStallCycles;
+            case PerformanceCounter::BranchMispredictions: {
+                const auto* branchPrediction = getBranchPredictionStatistics();
+                return branchPrediction ? branchPrediction->mispredictions : 0;
+            }
+            case PerformanceCounter::LoadUseStallCycles: {
+                const auto* hazards = getHazardStatistics();
+                return hazards ? hazards->loadUseStallCycles : 0;
+            }
+            case PerformanceCounter::FunctionalUnitStallCycles: {
+                const auto* functionalUnits = getFunctionalUnitStatistics();
+                return functionalUnits ? functionalUnits->dependencyStallCycles + functionalUnits->structuralStallCycles
+                                       : 0;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * @brief setPerformanceCounterSource
+     * Counter CSRs are read from @p source if set, or otherwise from the events simulated by the processor itself.
+     */
+    void setPerformanceCounterSource(const PerformanceCounterSource* source) { m_counterSource = source; }
+
+    /**
+     * @brief setHartId
+     * Sets the id of the hart which this processor implements in a multi-hart system, as read through mhartid. Harts
+     * are numbered from 0, which is the id of a single-hart system.
+     */
+    void setHartId(unsigned id) { m_hartId = id; }
+    unsigned hartId() const { return m_hartId; }
+
+    /**
+     * @brief readCSR
+     * @returns the value of CSR @p csr as read by a CSR instruction executing in the current cycle. Only the read-only
+     * counters of the Zicsr/Zicntr extensions, their machine-mode aliases and mhartid are implemented; the hpmcounters
+     * which do not count a PerformanceCounter, and all other CSRs, read as zero.
+     */
+    uint32_t readCSR(unsigned csr) const {
+        if (csr == 0xF14) {
+            return m_hartId;
+        }
+        // The upper halves of the 64-bit counters are mapped at an offset of 0x80
+        const bool high = (csr & 0x80) != 0;
+        const unsigned base = csr & ~0x80u;
+        unsigned index;
+        if (0xC00 <= base && base <= 0xC1F) {
+            index = base - 0xC00;
+        } else if (0xB00 <= base && base <= 0xB1F && base != 0xB01) {
+            index = base - 0xB00;
+        } else {
+            return 0;
+        }
+        // time reads the cycle counter; the counters following it are numbered from instret onwards
+        if (index > static_cast<unsigned>(PerformanceCounter::DataCacheMisses) + 1) {
+            return 0;
+        }
+        const auto counter = static_cast<PerformanceCounter>(index <= 1 ? 0 : index - 1);
+        const long long count = m_counterSource ? m_counterSource->performanceCounter(counter)
+                                                : performanceCounter(counter);
+        const auto value = static_cast<uint64_t>(count);
+        return static_cast<uint32_t>(high ? value >> 32 : value);
+    }
+
 protected:
     // Statistics
     long long m_instructionsRetired = 0;
+    long long m_memoryStallCycles = 0;
+
+private:
+    uint32_t m_executableStart = 0;
+    uint32_t m_executableEnd = 0;
+    const PerformanceCounterSource* m_counterSource = nullptr;
+    unsigned m_hartId = 0;
+    bool m_sysCallPending = false;
+
+    template <typename F>
+    static void forEachRegister(SimComponent* component, const F& f) {
+        for (const auto& subcomponent : component->getSubComponents()) {
+            if (auto* reg = dynamic_cast<RegisterBase*>(&*subcomponent)) {
+                f(reg);
+            }
+            forEachRegister(&*subcomponent, f);
+        }
+    }
+
+    static VSRTL_VT_U registerValue(RegisterBase* reg) {
+        // Registers drive their stored value on their only output port
+        Q_ASSERT(reg->getOutputs().size() == 1);
+        return (*reg->getOutputs().begin())->uValue();
+    }
 };
 
 }  // namespace core
@@ -15,10 +15,13 @@ ProcessorSelectionDialog::ProcessorSelectionDialog(QWidget* parent)
 
     // Initialize top level ISA items
     m_ui->processors->setHeaderHidden(true);
-    std::map<ISA, QTreeWidgetItem*> isaItems;
+    std::map<QString, QTreeWidgetItem*> isaItems;
     for (const auto& isa : ISANames) {
+        if (isaItems.count(isa.second) != 0) {
+            continue;
+        }
         auto* isaItem = new QTreeWidgetItem({isa.second});
-        isaItems[isa.first] = isaItem;
+        isaItems[isa.second] = isaItem;
         isaItem->setFlags(isaItem->flags() & ~(Qt::ItemIsSelectable));
         m_ui->processors->insertTopLevelItem(m_ui->processors->topLevelItemCount(), isaItem);
     }
@@ -35,10 +38,14 @@ ProcessorSelectionDialog::ProcessorSelectionDialog(QWidget* parent)
             processorItem->setFont(ProcessorColumn, font);
             selectedItem = processorItem;
         }
-        auto* isaItem = isaItems.at(desc.second.isa->isaID());
+        auto* isaItem = isaItems.at(ISANames.at(desc.second.isa->isaID()));
         isaItem->insertChild(isaItem->childCount(), processorItem);
     }
 
+    const auto& latencies = ProcessorHandler::get()->getFunctionalUnitLatencies();
+    m_ui->mulLatency->setValue(latencies.multiply);
+    m_ui->divLatency->setValue(latencies.divide);
+
     connect(m_ui->processors, &QTreeWidget::currentItemChanged, this, &ProcessorSelectionDialog::selectionChanged);
 
     connect(m_ui->buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
@@ -53,6 +60,13 @@ RegisterInitialization ProcessorSelectionDialog::getRegisterInitialization() con
     return m_ui->regInitWidget->getInitialization();
 }
 
+vsrtl::core::FunctionalUnitLatencies ProcessorSelectionDialog::getFunctionalUnitLatencies() const {
+    vsrtl::core::FunctionalUnitLatencies latencies;
+    latencies.multiply = m_ui->mulLatency->value();
+    latencies.divide = m_ui->divLatency->value();
+    return latencies;
+}
+
 ProcessorSelectionDialog::~ProcessorSelectionDialog() {
     delete m_ui;
 }
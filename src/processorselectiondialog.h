@@ -21,6 +21,7 @@ public:
     ProcessorID getSelectedId() const { return m_selectedID; }
     RegisterInitialization getRegisterInitialization() const;
     Layout getSelectedLayout() const;
+    vsrtl::core::FunctionalUnitLatencies getFunctionalUnitLatencies() const;
 
 private slots:
     void selectionChanged(QTreeWidgetItem* current, QTreeWidgetItem* previous);
@@ -2,17 +2,26 @@
 #include "ui_processortab.h"
 
 #include <QDir>
+#include <QFileDialog>
+#include <QGraphicsView>
+#include <QInputDialog>
+#include <QMenu>
 #include <QMessageBox>
 #include <QScrollBar>
 #include <QSpinBox>
 #include <QTemporaryFile>
 
+#include "deviceswidget.h"
+#include "hostprofiler.h"
+#include "hotspotswidget.h"
 #include "instructionmodel.h"
+#include "loopswidget.h"
 #include "parser.h"
 #include "processorhandler.h"
 #include "processorregistry.h"
 #include "processorselectiondialog.h"
 #include "registermodel.h"
+#include "runtodialog.h"
 #include "stagetablemodel.h"
 #include "stagetablewidget.h"
 
@@ -33,21 +42,20 @@ ProcessorTab::ProcessorTab(QToolBar* toolbar, QWidget* parent) : RipesTab(toolba
     // By default, lock the VSRTL widget
     m_vsrtlWidget->setLocked(true);
 
-    m_stageModel = new StageTableModel(this);
+    // The stage table records the history of the pipeline, and is thus updated regardless of whether the tab is visible
+    m_stageModel = new StageTableModel(ProcessorHandler::get(), this);
     connect(this, &ProcessorTab::update, m_stageModel, &StageTableModel::processorWasClocked);
 
     updateInstructionModel();
     m_ui->registerWidget->updateModel();
-    connect(this, &ProcessorTab::update, m_ui->registerWidget, &RegisterWidget::updateView);
-    connect(this, &ProcessorTab::update, this, &ProcessorTab::updateStatistics);
-    connect(this, &ProcessorTab::update, this, &ProcessorTab::updateInstructionLabels);
+    connect(this, &ProcessorTab::update, this, &ProcessorTab::updateViews);
 
     setupSimulatorActions();
 
     // Setup statistics update timer
     m_statUpdateTimer = new QTimer(this);
     m_statUpdateTimer->setInterval(100);
-    connect(m_statUpdateTimer, &QTimer::timeout, this, &ProcessorTab::updateStatistics);
+    connect(m_statUpdateTimer, &QTimer::timeout, this, &ProcessorTab::updateLiveStatistics);
 
     // Connect ECALL functionality to application output log and scroll to bottom
     connect(this, &ProcessorTab::appendToLog, [this](QString string) {
@@ -74,25 +82,29 @@ void ProcessorTab::printToLog(const QString& text) {
 }
 
 void ProcessorTab::loadLayout(const Layout& layout) {
-    if (layout.name.isEmpty() || layout.file.isEmpty())
+    if (layout.name.isEmpty())
         return;  // Not a valid layout
 
     if (layout.stageLabelPositions.size() != ProcessorHandler::get()->getProcessor()->stageCount()) {
         Q_ASSERT(false && "A stage label position must be specified for each stage");
     }
 
-    // cereal expects the archive file to be present standalone on disk, and available through an ifstream. Copy the
-    // resource layout file (bundled within the binary as a Qt resource) to a temporary file, for loading the layout.
-    const auto& layoutResourceFilename = layout.file;
-    QFile layoutResourceFile(layoutResourceFilename);
-    QTemporaryFile* tmpLayoutFile = QTemporaryFile::createNativeFile(layoutResourceFile);
-    if (!tmpLayoutFile->open()) {
-        QMessageBox::warning(this, "Error", "Could not create temporary layout file");
-        return;
-    }
+    // Layouts without a file keep the automatic placement of the components
+    if (!layout.file.isEmpty()) {
+        // cereal expects the archive file to be present standalone on disk, and available through an ifstream. Copy
+        // the resource layout file (bundled within the binary as a Qt resource) to a temporary file, for loading the
+        // layout.
+        const auto& layoutResourceFilename = layout.file;
+        QFile layoutResourceFile(layoutResourceFilename);
+        QTemporaryFile* tmpLayoutFile = QTemporaryFile::createNativeFile(layoutResourceFile);
+        if (!tmpLayoutFile->open()) {
+            QMessageBox::warning(this, "Error", "Could not create temporary layout file");
+            return;
+        }
 
-    m_vsrtlWidget->getTopLevelComponent()->loadLayoutFile(tmpLayoutFile->fileName());
-    tmpLayoutFile->remove();
+        m_vsrtlWidget->getTopLevelComponent()->loadLayoutFile(tmpLayoutFile->fileName());
+        tmpLayoutFile->remove();
+    }
 
     // Adjust stage label positions
     const auto& parent = m_stageInstructionLabels.at(0)->parentItem();
@@ -123,6 +135,22 @@ void ProcessorTab::setupSimulatorActions() {
     m_reverseAction->setToolTip("Undo a clock cycle (F4)");
     m_toolbar->addAction(m_reverseAction);
 
+    // Searching backwards is offered through the menu of the reverse action
+    m_reverseContinueAction = new QAction("Reverse continue (Shift+F4)", this);
+    connect(m_reverseContinueAction, &QAction::triggered, this, &ProcessorTab::reverseContinue);
+    m_reverseContinueAction->setShortcut(QKeySequence("Shift+F4"));
+    m_reverseContinueAction->setToolTip("Return to the latest preceding cycle in which a breakpoint was hit");
+    m_reverseUntilChangedAction = new QAction("Reverse until changed...", this);
+    connect(m_reverseUntilChangedAction, &QAction::triggered, this, &ProcessorTab::reverseUntilChanged);
+    m_reverseUntilChangedAction->setToolTip(
+        "Return to the cycle before a register or memory location was last changed");
+    auto* reverseMenu = new QMenu(this);
+    reverseMenu->addAction(m_reverseContinueAction);
+    reverseMenu->addAction(m_reverseUntilChangedAction);
+    m_reverseAction->setMenu(reverseMenu);
+    // Shortcuts of menu actions are only active while the menu is shown, unless the actions are added to the tab
+    addAction(m_reverseContinueAction);
+
     const QIcon clockIcon = QIcon(":/icons/step.svg");
     m_clockAction = new QAction(clockIcon, "Clock (F5)", this);
     connect(m_clockAction, &QAction::triggered, this, &ProcessorTab::clock);
@@ -131,7 +159,7 @@ void ProcessorTab::setupSimulatorActions() {
     m_toolbar->addAction(m_clockAction);
 
     QTimer* timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &ProcessorTab::clock);
+    connect(timer, &QTimer::timeout, this, &ProcessorTab::autoClock);
 
     const QIcon startAutoClockIcon = QIcon(":/icons/step-clock.svg");
     const QIcon stopAutoTimerIcon = QIcon(":/icons/stop-clock.svg");
@@ -160,6 +188,24 @@ void ProcessorTab::setupSimulatorActions() {
     m_autoClockInterval->setValue(100);
     m_toolbar->addWidget(m_autoClockInterval);
 
+    m_autoClockCycles = new QSpinBox(this);
+    m_autoClockCycles->setRange(1, 10000);
+    m_autoClockCycles->setSuffix(" cycles");
+    m_autoClockCycles->setToolTip(
+        "Cycles per auto clock interval.\nThe views are refreshed at most once per display frame while auto "
+        "clocking.");
+    m_autoClockCycles->setValue(1);
+    m_toolbar->addWidget(m_autoClockCycles);
+
+    // Views are refreshed at most once per display frame (~60 Hz) while auto clocking
+    m_viewRefreshTimer = new QTimer(this);
+    m_viewRefreshTimer->setSingleShot(true);
+    m_viewRefreshTimer->setInterval(16);
+    connect(m_viewRefreshTimer, &QTimer::timeout, this, [=] {
+        RIPES_PROFILE_SCOPE("ProcessorTab view update");
+        emit update();
+    });
+
     const QIcon runIcon = QIcon(":/icons/run.svg");
     m_runAction = new QAction(runIcon, "Run (F8)", this);
     m_runAction->setShortcut(QKeySequence("F8"));
@@ -170,6 +216,28 @@ void ProcessorTab::setupSimulatorActions() {
         "breakpoint is hit.");
     connect(m_runAction, &QAction::toggled, this, &ProcessorTab::run);
     m_toolbar->addAction(m_runAction);
+
+    // Running through the functional interpreter is offered through the menu of the run action
+    m_fastRunAction = new QAction("Run functionally when possible", this);
+    m_fastRunAction->setCheckable(true);
+    m_fastRunAction->setChecked(ProcessorHandler::get()->isFastRunEnabled());
+    m_fastRunAction->setToolTip(
+        "Execute the program through a functional interpreter while running, whenever no caches are simulated and\n"
+        "the pipeline is not traced. The processor then does not simulate the cycles of the run.");
+    connect(m_fastRunAction, &QAction::toggled,
+            [](bool checked) { ProcessorHandler::get()->setFastRunEnabled(checked); });
+    auto* runMenu = new QMenu(this);
+    runMenu->addAction(m_fastRunAction);
+    m_runAction->setMenu(runMenu);
+
+    const QIcon runToIcon = QIcon(":/icons/crosshair.svg");
+    m_runToAction = new QAction(runToIcon, "Run to... (F9)", this);
+    m_runToAction->setShortcut(QKeySequence("F9"));
+    m_runToAction->setToolTip(
+        "Run for a number of cycles, or until reaching a cycle, number of retired instructions or PC (F9).\n"
+        "As with Run, GUI updates are disabled until the run stops.");
+    connect(m_runToAction, &QAction::triggered, this, &ProcessorTab::runTo);
+    m_toolbar->addAction(m_runToAction);
     m_toolbar->addSeparator();
 
     const QIcon tagIcon = QIcon(":/icons/tag.svg");
@@ -183,13 +251,155 @@ void ProcessorTab::setupSimulatorActions() {
     m_stageTableAction = new QAction(tableIcon, "Show stage table", this);
     connect(m_stageTableAction, &QAction::triggered, this, &ProcessorTab::showStageTable);
     m_toolbar->addAction(m_stageTableAction);
+
+    const QIcon hotSpotsIcon = QIcon(":/icons/analytics.svg");
+    m_hotSpotsAction = new QAction(hotSpotsIcon, "Show hot spots", this);
+    m_hotSpotsAction->setToolTip(
+        "Show the instructions, instruction classes and symbols to which the retired instructions and stalled cycles "
+        "are attributed");
+    connect(m_hotSpotsAction, &QAction::triggered, this, &ProcessorTab::showHotSpots);
+    m_toolbar->addAction(m_hotSpotsAction);
+
+    const QIcon loopsIcon = QIcon(":/icons/graph.svg");
+    m_loopsAction = new QAction(loopsIcon, "Show loops", this);
+    m_loopsAction->setToolTip(
+        "Show the trip counts, cycles per iteration, CPI and data cache miss rate of the loops which have been "
+        "executed");
+    connect(m_loopsAction, &QAction::triggered, this, &ProcessorTab::showLoops);
+    m_toolbar->addAction(m_loopsAction);
+
+    const QIcon devicesIcon = QIcon(":/icons/server.svg");
+    m_devicesAction = new QAction(devicesIcon, "Show devices", this);
+    m_devicesAction->setToolTip("Show the LED panel and UART mapped into the data memory");
+    connect(m_devicesAction, &QAction::triggered, this, &ProcessorTab::showDevices);
+    m_toolbar->addAction(m_devicesAction);
+
+    const QIcon traceIcon = QIcon(":/icons/notepad.svg");
+    m_traceAction = new QAction(traceIcon, "Record execution trace", this);
+    m_traceAction->setCheckable(true);
+    m_traceAction->setChecked(false);
+    m_traceAction->setToolTip("Record all retired instructions to an execution trace file");
+    connect(m_traceAction, &QAction::toggled, this, &ProcessorTab::recordTrace);
+    m_toolbar->addAction(m_traceAction);
+
+    if (HostProfiler::available()) {
+        const QIcon profilerIcon = QIcon(":/icons/analytics.svg");
+        m_hostProfilerAction = new QAction(profilerIcon, "Profile simulator", this);
+        m_hostProfilerAction->setCheckable(true);
+        m_hostProfilerAction->setChecked(false);
+        m_hostProfilerAction->setToolTip(
+            "Profile the host time spent within the simulator itself. When stopped, the profile may be saved as a "
+            "Chrome trace event file");
+        connect(m_hostProfilerAction, &QAction::toggled, this, &ProcessorTab::profileHost);
+        m_toolbar->addAction(m_hostProfilerAction);
+
+        m_hostProfilerOverlay = new QLabel(m_vsrtlWidget);
+        m_hostProfilerOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+        m_hostProfilerOverlay->setStyleSheet(
+            "QLabel { background-color: rgba(255, 255, 255, 220); font-family: monospace; padding: 4px; }");
+        m_hostProfilerOverlay->hide();
+        m_hostProfilerTimer = new QTimer(this);
+        m_hostProfilerTimer->setInterval(500);
+        connect(m_hostProfilerTimer, &QTimer::timeout, this, &ProcessorTab::updateHostProfilerOverlay);
+    }
+}
+
+void ProcessorTab::profileHost(bool state) {
+    HostProfiler::setEnabled(state);
+    if (state) {
+        updateHostProfilerOverlay();
+        m_hostProfilerOverlay->show();
+        m_hostProfilerTimer->start();
+        return;
+    }
+
+    m_hostProfilerTimer->stop();
+    m_hostProfilerOverlay->hide();
+    const QString path = QFileDialog::getSaveFileName(this, "Save host profile", "", "Chrome trace (*.json)");
+    if (!path.isEmpty() && !HostProfiler::writeChromeTrace(path)) {
+        QMessageBox::warning(this, "Error", "Could not write host profile " + path);
+    }
+}
+
+void ProcessorTab::updateHostProfilerOverlay() {
+    const unsigned long long cycles = HostProfiler::counter("cycles");
+    QString text = QString("%1 %2 %3 %4 %5\n")
+                       .arg("Scope", -40)
+                       .arg("ms", 10)
+                       .arg("calls", 10)
+                       .arg("ns/call", 10)
+                       .arg("ns/cycle", 10);
+    for (const auto& entry : HostProfiler::scopes()) {
+        text += QString("%1 %2 %3 %4 %5\n")
+                    .arg(entry.name, -40)
+                    .arg(entry.totalNs / 1e6, 10, 'f', 1)
+                    .arg(entry.count, 10)
+                    .arg(entry.count ? entry.totalNs / entry.count : 0, 10)
+                    .arg(cycles ? entry.totalNs / cycles : 0, 10);
+    }
+    text += QString("%1 simulated cycles").arg(cycles);
+    m_hostProfilerOverlay->setText(text);
+    m_hostProfilerOverlay->adjustSize();
+    m_hostProfilerOverlay->move(8, 8);
+    m_hostProfilerOverlay->raise();
+}
+
+void ProcessorTab::recordTrace(bool state) {
+    auto* handler = ProcessorHandler::get();
+    if (!state) {
+        handler->stopTrace();
+        return;
+    }
+
+    const QString path = QFileDialog::getSaveFileName(this, "Record execution trace", "", "Ripes trace (*.rtrace)");
+    if (path.isEmpty() || !handler->startTrace(path)) {
+        if (!path.isEmpty()) {
+            QMessageBox::warning(this, "Error", "Could not create trace file " + path);
+        }
+        QSignalBlocker blocker(m_traceAction);
+        m_traceAction->setChecked(false);
+    }
 }
 
 void ProcessorTab::updateStatistics() {
-    const auto cycles = ProcessorHandler::get()->getProcessor()->getCycleCount();
-    const auto instrsRetired = ProcessorHandler::get()->getProcessor()->getInstructionsRetired();
-    m_ui->cycleCount->setText(QString::number(cycles));
+    auto* handler = ProcessorHandler::get();
+    const auto* proc = handler->getProcessor();
+    showStatistics(handler->getCycleCount(), handler->getFastForwardedCycles(), handler->getInstructionsRetired(),
+                   proc->getMemoryStallCycles(), proc->getBranchPredictionStatistics(),
+                   proc->getFunctionalUnitStatistics(), proc->getHazardStatistics(), proc->getPcForStage(0));
+}
+
+void ProcessorTab::updateLiveStatistics() {
+    // The processor is being executed in another thread; read its progress from the published run statistics
+    const auto stats = ProcessorHandler::get()->getRunStatistics();
+    showStatistics(stats.cycles, stats.fastForwardedCycles, stats.instructionsRetired, stats.memoryStallCycles,
+                   stats.predictsBranches ? &stats.branchPrediction : nullptr,
+                   stats.modelsFunctionalUnits ? &stats.functionalUnits : nullptr,
+                   stats.modelsHazards ? &stats.hazards : nullptr, stats.pc);
+
+    const qint64 elapsedMs = m_liveStatisticsTimer.restart();
+    if (elapsedMs > 0) {
+        const double cyclesPerSecond = (stats.cycles - m_liveStatisticsCycles) * 1000.0 / elapsedMs;
+        m_ui->cyclesPerSecond->setText(QString::number(cyclesPerSecond, 'g', 3));
+    }
+    m_liveStatisticsCycles = stats.cycles;
+}
+
+void ProcessorTab::showStatistics(long long cycles, long long fastForwardedCycles, long long instrsRetired,
+                                  long long memoryStallCycles,
+                                  const vsrtl::core::BranchPredictionStatistics* branchPrediction,
+                                  const vsrtl::core::FunctionalUnitStatistics* functionalUnits,
+                                  const vsrtl::core::HazardStatistics* hazards, uint32_t pc) {
+    m_ui->pc->setText("0x" + QString::number(pc, 16).rightJustified(8, '0'));
+    QString cyclesText = QString::number(cycles);
+    if (fastForwardedCycles != 0) {
+        cyclesText += " (" + QString::number(fastForwardedCycles) + " fast-forwarded)";
+    }
+    m_ui->cycleCount->setText(cyclesText);
+    m_ui->cycleCount->setToolTip("Modelled: " + QString::number(cycles - fastForwardedCycles) +
+                                 "\nFast-forwarded: " + QString::number(fastForwardedCycles));
     m_ui->instructionsRetired->setText(QString::number(instrsRetired));
+    m_ui->memoryStallCycles->setText(QString::number(memoryStallCycles));
     QString cpiText, ipcText;
     if (cycles != 0 && instrsRetired != 0) {
         const double cpi = static_cast<double>(cycles) / static_cast<double>(instrsRetired);
@@ -199,12 +409,40 @@ void ProcessorTab::updateStatistics() {
     }
     m_ui->cpi->setText(cpiText);
     m_ui->ipc->setText(ipcText);
+
+    QString predictionsText, mispredictionsText, flushCyclesSavedText;
+    if (branchPrediction) {
+        predictionsText = QString::number(branchPrediction->predictions);
+        mispredictionsText = QString::number(branchPrediction->mispredictions);
+        if (branchPrediction->predictions != 0) {
+            const double rate = 100.0 * branchPrediction->mispredictions / branchPrediction->predictions;
+            mispredictionsText += " (" + QString::number(rate, 'f', 1) + "%)";
+        }
+        flushCyclesSavedText = QString::number(branchPrediction->flushCyclesSaved);
+    }
+    m_ui->branchPredictions->setText(predictionsText);
+    m_ui->mispredictions->setText(mispredictionsText);
+    m_ui->flushCyclesSaved->setText(flushCyclesSavedText);
+
+    m_ui->mulDivStallCycles->setText(functionalUnits ? QString::number(functionalUnits->dependencyStallCycles)
+                                                     : QString());
+    m_ui->structuralStallCycles->setText(functionalUnits ? QString::number(functionalUnits->structuralStallCycles)
+                                                         : QString());
+
+    const auto hazardText = [hazards](long long vsrtl::core::HazardStatistics::*counter) {
+        return hazards ? QString::number(hazards->*counter) : QString();
+    };
+    m_ui->loadUseStallCycles->setText(hazardText(&vsrtl::core::HazardStatistics::loadUseStallCycles));
+    m_ui->ecallStallCycles->setText(hazardText(&vsrtl::core::HazardStatistics::ecallStallCycles));
+    m_ui->controlFlowFlushes->setText(hazardText(&vsrtl::core::HazardStatistics::controlFlowFlushes));
+    m_ui->forwardedOperands->setText(hazardText(&vsrtl::core::HazardStatistics::forwardedOperands));
+    m_ui->emptyFetchCycles->setText(hazardText(&vsrtl::core::HazardStatistics::emptyFetchCycles));
 }
 
 void ProcessorTab::pause() {
     m_autoClockAction->setChecked(false);
     m_runAction->setChecked(false);
-    m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+    updateReverseActions();
 }
 
 void ProcessorTab::fitToView() {
@@ -224,6 +462,19 @@ void ProcessorTab::loadProcessorToWidget(const Layout& layout) {
         stagelabel->setPointSize(14);
         m_stageInstructionLabels[i] = stagelabel;
     }
+
+    // Labels skipped while unreadable are updated once the view is scrolled or zoomed; zooming alters the ranges of
+    // the scroll bars
+    if (const auto* scene = topLevelComponent->scene(); scene && !scene->views().isEmpty()) {
+        const QGraphicsView* view = scene->views().first();
+        for (const QScrollBar* scrollBar : {view->horizontalScrollBar(), view->verticalScrollBar()}) {
+            connect(scrollBar, &QScrollBar::valueChanged, this, &ProcessorTab::updateStaleInstructionLabels,
+                    Qt::UniqueConnection);
+            connect(scrollBar, &QScrollBar::rangeChanged, this, &ProcessorTab::updateStaleInstructionLabels,
+                    Qt::UniqueConnection);
+        }
+    }
+
     loadLayout(layout);
     updateInstructionLabels();
     fitToView();
@@ -236,6 +487,7 @@ void ProcessorTab::processorSelection() {
         // New processor model was selected
         m_vsrtlWidget->clearDesign();
         m_stageInstructionLabels.clear();
+        ProcessorHandler::get()->setFunctionalUnitLatencies(diag.getFunctionalUnitLatencies());
         ProcessorHandler::get()->selectProcessor(diag.getSelectedId(), diag.getRegisterInitialization());
         loadProcessorToWidget(diag.getSelectedLayout());
         m_vsrtlWidget->reset();
@@ -252,7 +504,7 @@ void ProcessorTab::processorSelection() {
 
 void ProcessorTab::updateInstructionModel() {
     auto* oldModel = m_instrModel;
-    m_instrModel = new InstructionModel(this);
+    m_instrModel = new InstructionModel(ProcessorHandler::get(), this);
 
     // Update the instruction view according to the newly created model
     m_ui->instructionView->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -269,8 +521,6 @@ void ProcessorTab::updateInstructionModel() {
     m_ui->instructionView->horizontalHeader()->setSectionResizeMode(InstructionModel::Instruction,
                                                                     QHeaderView::Stretch);
 
-    connect(this, &ProcessorTab::update, m_instrModel, &InstructionModel::processorWasClocked);
-
     // Make the instruction view follow the instruction which is currently present in the first stage of the processor
     connect(m_instrModel, &InstructionModel::firstStageInstrChanged, this, &ProcessorTab::setInstructionViewCenterAddr);
 
@@ -279,8 +529,23 @@ void ProcessorTab::updateInstructionModel() {
     }
 }
 
+void ProcessorTab::updateViews() {
+    if (deferViewUpdate(ProcessorHandler::get()->getCycleCount())) {
+        return;
+    }
+    refreshViews();
+}
+
+void ProcessorTab::refreshViews() {
+    m_instrModel->processorWasClocked();
+    m_ui->registerWidget->updateView();
+    updateStatistics();
+    updateInstructionLabels();
+}
+
 void ProcessorTab::restart() {
     // Invoked when changes to binary simulation file has been made
+    m_instrModel->reload();
     emit update();
     enableSimulatorControls();
 }
@@ -296,24 +561,53 @@ void ProcessorTab::processorFinished() {
     m_autoClockAction->setEnabled(false);
     m_runAction->setEnabled(false);
     m_runAction->setChecked(false);
+    m_runToAction->setEnabled(false);
 }
 
 void ProcessorTab::enableSimulatorControls() {
     m_clockAction->setEnabled(true);
     m_autoClockAction->setEnabled(true);
     m_runAction->setEnabled(true);
-    m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+    m_runToAction->setEnabled(true);
+    updateReverseActions();
     m_resetAction->setEnabled(true);
     m_stageTableAction->setEnabled(!m_hasRun);
 }
 
+QRectF ProcessorTab::readableSceneRect() const {
+    const auto* topLevelComponent = m_vsrtlWidget->getTopLevelComponent();
+    const auto* scene = topLevelComponent ? topLevelComponent->scene() : nullptr;
+    if (!scene || scene->views().isEmpty()) {
+        return QRectF();
+    }
+    const QGraphicsView* view = scene->views().first();
+    if (view->transform().m11() < s_minLabelScale) {
+        return QRectF();
+    }
+    return view->mapToScene(view->viewport()->rect()).boundingRect();
+}
+
+void ProcessorTab::updateStaleInstructionLabels() {
+    if (m_staleInstructionLabels) {
+        updateInstructionLabels();
+    }
+}
+
 void ProcessorTab::updateInstructionLabels() {
+    // Text layout dominates the cost of the labels; labels outside of the viewport, or which are too small to be read,
+    // are left unchanged until the view is scrolled or zoomed
+    const QRectF readableRect = readableSceneRect();
+    m_staleInstructionLabels = false;
     const auto& proc = ProcessorHandler::get()->getProcessor();
     for (unsigned i = 0; i < proc->stageCount(); i++) {
         if (!m_stageInstructionLabels.count(i))
             continue;
-        const auto stageInfo = proc->stageInfo(i);
         auto* instrLabel = m_stageInstructionLabels.at(i);
+        if (!instrLabel->sceneBoundingRect().intersects(readableRect)) {
+            m_staleInstructionLabels = true;
+            continue;
+        }
+        const auto stageInfo = proc->stageInfo(i);
         QString instrString;
         if (stageInfo.state != StageInfo::State::None) {
             instrString = stageInfo.state == StageInfo::State::Flushed ? "nop (flush)" : "nop (stall)";
@@ -329,14 +623,32 @@ void ProcessorTab::updateInstructionLabels() {
 void ProcessorTab::reset() {
     m_hasRun = false;
     m_autoClockAction->setChecked(false);
-    m_vsrtlWidget->reset();
+    // Resets are requested upon every cache configuration change. If the processor is untouched since its last reset,
+    // re-initializing its memory from the program is redundant.
+    if (!ProcessorHandler::get()->isInResetState()) {
+        m_vsrtlWidget->reset();
+    }
     m_stageModel->reset();
+    m_ui->cyclesPerSecond->clear();
+    m_instrModel->reload();
     emit update();
 
     enableSimulatorControls();
     emit appendToLog("\n");
 }
 
+void ProcessorTab::snapshotRestored() {
+    m_hasRun = false;
+    m_autoClockAction->setChecked(false);
+    m_stageModel->reset();
+    m_ui->cyclesPerSecond->clear();
+    emit update();
+
+    enableSimulatorControls();
+    ProcessorHandler::get()->checkProcessorFinished();
+    printToLog(QString("Restored snapshot of cycle %1\n").arg(ProcessorHandler::get()->getCycleCount()));
+}
+
 void ProcessorTab::setInstructionViewCenterAddr(uint32_t address) {
     const auto index = addressToIndex(address);
     const auto view = m_ui->instructionView;
@@ -354,8 +666,32 @@ void ProcessorTab::setInstructionViewCenterAddr(uint32_t address) {
     }
 }
 
+void ProcessorTab::reportWatchpoint() {
+    const auto& hit = ProcessorHandler::get()->getWatchpoints().lastHit();
+    QString access;
+    switch (hit.kind) {
+        case Watchpoints::Read:
+            access = "Read of";
+            break;
+        case Watchpoints::Write:
+            access = "Write to";
+            break;
+        case Watchpoints::Change:
+            access = "Value change of";
+            break;
+    }
+    printToLog(QString("Watchpoint: %1 %2 byte(s) at 0x%3 by the instruction at 0x%4\n")
+                   .arg(access)
+                   .arg(hit.bytes)
+                   .arg(hit.address, 8, 16, QChar('0'))
+                   .arg(hit.pc, 8, 16, QChar('0')));
+}
+
 void ProcessorTab::runFinished() {
     pause();
+    if (ProcessorHandler::get()->watchpointTriggered()) {
+        reportWatchpoint();
+    }
     ProcessorHandler::get()->checkProcessorFinished();
     m_statUpdateTimer->stop();
     emit update();
@@ -368,7 +704,14 @@ void ProcessorTab::run(bool state) {
         m_autoClockAction->setChecked(false);
     }
     if (state) {
-        ProcessorHandler::get()->run();
+        if (m_pendingRun) {
+            m_pendingRun();
+            m_pendingRun = nullptr;
+        } else {
+            ProcessorHandler::get()->run();
+        }
+        m_liveStatisticsCycles = ProcessorHandler::get()->getRunStatistics().cycles;
+        m_liveStatisticsTimer.start();
         m_statUpdateTimer->start();
     } else {
         ProcessorHandler::get()->stop();
@@ -379,35 +722,183 @@ void ProcessorTab::run(bool state) {
     m_selectProcessorAction->setEnabled(!state);
     m_clockAction->setEnabled(!state);
     m_autoClockAction->setEnabled(!state);
+    m_runToAction->setEnabled(!state);
     m_reverseAction->setEnabled(!state);
+    m_reverseContinueAction->setEnabled(!state);
+    m_reverseUntilChangedAction->setEnabled(!state);
     m_resetAction->setEnabled(!state);
     m_displayValuesAction->setEnabled(!state);
     m_stageTableAction->setEnabled(false);
+    m_hotSpotsAction->setEnabled(!state);
+    m_loopsAction->setEnabled(!state);
+    m_traceAction->setEnabled(!state);
+
+    // Disallow interactions with the processor and instruction views. Registers are presented from the live state of
+    // the processor, and may be browsed.
+    m_ui->vsrtlWidget->setEnabled(!state);
+    m_ui->instructionView->setEnabled(!state);
+}
+
+void ProcessorTab::runTo() {
+    RunToDialog dialog(this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    const auto condition = dialog.getCondition();
+    const auto value = dialog.isRelative() ? ProcessorHandler::get()->getCycleCount() + dialog.getValue()
+                                           : dialog.getValue();
+    m_pendingRun = [=] { ProcessorHandler::get()->runUntil(condition, value); };
+    // Running is started through the run action, such that the run may be stopped through the same action
+    m_runAction->setChecked(true);
+}
+
+void ProcessorTab::updateReverseActions() {
+    const auto cycle = ProcessorHandler::get()->getProcessor()->getCycleCount();
+    const bool canSearch = cycle > 0 && ProcessorHandler::get()->canGotoCycle(0);
+    m_reverseAction->setEnabled(isReversible());
+    m_reverseContinueAction->setEnabled(canSearch);
+    m_reverseUntilChangedAction->setEnabled(canSearch);
+}
+
+void ProcessorTab::reverseContinue() {
+    if (ProcessorHandler::get()->reverseContinue() < 0) {
+        printToLog("Reverse continue: no breakpoint was hit in any preceding cycle\n");
+    }
+    enableSimulatorControls();
+    emit update();
+}
+
+void ProcessorTab::reverseUntilChanged() {
+    bool ok = false;
+    const QString target =
+        QInputDialog::getText(this, "Reverse until changed",
+                              "Register (ie. a0 or x5), or memory range as <address>[:<bytes>] (ie. 0x10000000:4):",
+                              QLineEdit::Normal, m_reverseUntilChangedTarget, &ok)
+            .trimmed();
+    if (!ok || target.isEmpty()) {
+        return;
+    }
+    m_reverseUntilChangedTarget = target;
+
+    auto* handler = ProcessorHandler::get();
+    const auto* isa = handler->currentISA();
+    long long cycle = -2;
+    for (unsigned i = 0; i < isa->regCnt(); i++) {
+        if (target == isa->regName(i) || target == isa->regAlias(i)) {
+            cycle = handler->reverseUntilRegisterChanged(i);
+            break;
+        }
+    }
+    if (cycle == -2) {
+        const QStringList parts = target.split(':');
+        bool addressOk = false;
+        bool bytesOk = parts.size() == 1;
+        const uint32_t address = parts.at(0).toUInt(&addressOk, 0);
+        const unsigned bytes = parts.size() == 2 ? parts.at(1).toUInt(&bytesOk, 0) : isa->bytes();
+        if (!addressOk || !bytesOk || parts.size() > 2 || bytes == 0) {
+            QMessageBox::warning(this, "Reverse until changed", "Invalid register or memory range '" + target + "'");
+            return;
+        }
+        cycle = handler->reverseUntilMemoryChanged(address, bytes);
+    }
+    if (cycle < 0) {
+        printToLog("Reverse until changed: " + target + " held its current value in all preceding cycles\n");
+    }
+    enableSimulatorControls();
+    emit update();
+}
 
-    // Disable the entire processortab, disallowing interactions with widgets
-    setEnabled(!state);
+bool ProcessorTab::isReversible() const {
+    const auto cycle = ProcessorHandler::get()->getProcessor()->getCycleCount();
+    return m_vsrtlWidget->isReversible() || ProcessorHandler::get()->canGotoCycle(cycle - 1);
 }
 
 void ProcessorTab::reverse() {
-    m_vsrtlWidget->reverse();
+    if (m_vsrtlWidget->isReversible()) {
+        m_vsrtlWidget->reverse();
+    } else {
+        // The reverse stack has been exhausted; re-simulate the previous cycle from a checkpoint
+        ProcessorHandler::get()->gotoCycle(ProcessorHandler::get()->getProcessor()->getCycleCount() - 1);
+    }
     enableSimulatorControls();
     emit update();
 }
 
 void ProcessorTab::clock() {
-    m_vsrtlWidget->clock();
+    {
+        RIPES_PROFILE_SCOPE("VSRTLWidget::clock");
+        m_vsrtlWidget->clock();
+    }
+    RIPES_PROFILE_COUNT("cycles", 1);
     ProcessorHandler::get()->checkValidExecutionRange();
     if (ProcessorHandler::get()->checkBreakpoint()) {
         pause();
     }
+    if (ProcessorHandler::get()->checkWatchpoint()) {
+        pause();
+        reportWatchpoint();
+    }
     ProcessorHandler::get()->checkProcessorFinished();
-    m_reverseAction->setEnabled(m_vsrtlWidget->isReversible());
+    updateReverseActions();
 
+    RIPES_PROFILE_SCOPE("ProcessorTab view update");
     emit update();
 }
 
+void ProcessorTab::autoClock() {
+    for (int i = 0; i < m_autoClockCycles->value(); i++) {
+        {
+            RIPES_PROFILE_SCOPE("VSRTLWidget::clock");
+            m_vsrtlWidget->clock();
+        }
+        RIPES_PROFILE_COUNT("cycles", 1);
+        // The stage table records every cycle, whereas the remaining views are only refreshed once per frame
+        m_stageModel->processorWasClocked();
+        ProcessorHandler::get()->checkValidExecutionRange();
+        if (ProcessorHandler::get()->checkBreakpoint()) {
+            pause();
+        }
+        if (ProcessorHandler::get()->checkWatchpoint()) {
+            pause();
+            reportWatchpoint();
+        }
+        ProcessorHandler::get()->checkProcessorFinished();
+
+        // Auto clocking is stopped upon hitting a breakpoint or when the processor finishes
+        if (!m_autoClockAction->isChecked()) {
+            break;
+        }
+    }
+    updateReverseActions();
+
+    if (!m_viewRefreshTimer->isActive()) {
+        m_viewRefreshTimer->start();
+    }
+}
+
 void ProcessorTab::showStageTable() {
     auto w = StageTableWidget(m_stageModel);
     w.exec();
 }
+
+void ProcessorTab::showHotSpots() {
+    auto w = HotSpotsWidget(this);
+    w.exec();
+}
+
+void ProcessorTab::showLoops() {
+    auto w = LoopsWidget(this);
+    connect(&w, &LoopsWidget::showAddressRange, this, &ProcessorTab::showAddressRange);
+    w.exec();
+}
+
+void ProcessorTab::showDevices() {
+    // Parented to the main window, given that the processor tab is disabled while running
+    if (!m_devicesWidget) {
+        m_devicesWidget = new DevicesWidget(window());
+    }
+    m_devicesWidget->show();
+    m_devicesWidget->raise();
+}
 }  // namespace Ripes
@@ -1,17 +1,26 @@
 #pragma once
 
 #include <QAction>
+#include <QElapsedTimer>
+#include <QLabel>
 #include <QSpinBox>
 #include <QTimer>
 #include <QToolBar>
 #include <QWidget>
 
+#include <functional>
+
 #include "defines.h"
 #include "ripestab.h"
 
 namespace vsrtl {
 class VSRTLWidget;
 class Label;
+namespace core {
+struct BranchPredictionStatistics;
+struct FunctionalUnitStatistics;
+struct HazardStatistics;
+}  // namespace core
 }  // namespace vsrtl
 
 namespace Ripes {
@@ -20,6 +29,7 @@ namespace Ui {
 class ProcessorTab;
 }
 
+class DevicesWidget;
 class InstructionModel;
 class RegisterModel;
 class StageTableModel;
@@ -38,16 +48,27 @@ public:
 signals:
     void update();
     void appendToLog(QString string);
+    /// Requests the instructions from @p first to @p last to be shown in the program listing
+    void showAddressRange(uint32_t first, uint32_t last);
 
 public slots:
     void pause();
     void restart();
     void reset();
+    /// Updates all views after the processor has been restored from a simulation snapshot
+    void snapshotRestored();
     void reverse();
+    void reverseContinue();
+    void reverseUntilChanged();
     void printToLog(const QString&);
     void processorFinished();
     void runFinished();
     void updateStatistics();
+    /**
+     * @brief updateLiveStatistics
+     * Updates the statistics while the processor is running, including the number of simulated cycles per second.
+     */
+    void updateLiveStatistics();
     void updateInstructionLabels();
     void fitToView();
 
@@ -55,13 +76,53 @@ public slots:
 
 private slots:
     void run(bool state);
+    void runTo();
     void clock();
+    /**
+     * @brief autoClock
+     * Advances the processor by the number of cycles selected for each auto clock interval. Views are not refreshed
+     * per cycle, but through m_viewRefreshTimer.
+     */
+    void autoClock();
     void setInstructionViewCenterAddr(uint32_t address);
     void showStageTable();
+    void showHotSpots();
+    void showLoops();
+    /// Shows the front panel of the memory mapped devices, which remains usable while running
+    void showDevices();
+    void recordTrace(bool state);
+    void profileHost(bool state);
+    void updateHostProfilerOverlay();
+    /// Updates the views of the tab following a clock of the processor, unless the tab is hidden
+    void updateViews();
+    /// Updates the stage instruction labels which were skipped while unreadable, once the view is scrolled or zoomed
+    void updateStaleInstructionLabels();
+
+protected:
+    void refreshViews() override;
 
 private:
     void setupSimulatorActions();
     void enableSimulatorControls();
+    /**
+     * @brief isReversible
+     * @returns true if the processor can be reversed by a cycle; either through the reverse stacks of the design or by
+     * re-simulating from a checkpoint.
+     */
+    bool isReversible() const;
+    /// Enables the reverse actions according to whether the processor may be reversed
+    void updateReverseActions();
+    /// Prints the most recently triggered watchpoint to the log
+    void reportWatchpoint();
+    /**
+     * @brief showStatistics
+     * @p cycles includes the @p fastForwardedCycles executed through the functional interpreter, which are reported
+     * separately from the cycles modelled by the processor.
+     */
+    void showStatistics(long long cycles, long long fastForwardedCycles, long long instrsRetired,
+                        long long memoryStallCycles, const vsrtl::core::BranchPredictionStatistics* branchPrediction,
+                        const vsrtl::core::FunctionalUnitStatistics* functionalUnits,
+                        const vsrtl::core::HazardStatistics* hazards, uint32_t pc);
     void updateInstructionModel();
     void updateRegisterModel();
     void loadLayout(const Layout&);
@@ -74,25 +135,62 @@ private:
     vsrtl::VSRTLWidget* m_vsrtlWidget = nullptr;
 
     std::map<unsigned, vsrtl::Label*> m_stageInstructionLabels;
+    /// Set when stage instruction labels were left unchanged by updateInstructionLabels, as they were unreadable
+    bool m_staleInstructionLabels = false;
+    /**
+     * @brief readableSceneRect
+     * @returns the part of the processor scene which is visible in its view, or an empty rectangle if the view is
+     * zoomed out beyond s_minLabelScale, at which text is unreadable.
+     */
+    QRectF readableSceneRect() const;
+    static constexpr qreal s_minLabelScale = 0.4;
 
     QTimer* m_statUpdateTimer;
+    QElapsedTimer m_liveStatisticsTimer;
+    long long m_liveStatisticsCycles = 0;
 
     // Actions
     QAction* m_selectProcessorAction = nullptr;
     QAction* m_clockAction = nullptr;
     QAction* m_autoClockAction = nullptr;
     QAction* m_runAction = nullptr;
+    QAction* m_fastRunAction = nullptr;
+    QAction* m_runToAction = nullptr;
     QAction* m_displayValuesAction = nullptr;
     QAction* m_stageTableAction = nullptr;
+    QAction* m_hotSpotsAction = nullptr;
+    QAction* m_loopsAction = nullptr;
+    QAction* m_devicesAction = nullptr;
+    DevicesWidget* m_devicesWidget = nullptr;
+    QAction* m_traceAction = nullptr;
     QAction* m_reverseAction = nullptr;
     QAction* m_resetAction = nullptr;
+    QAction* m_hostProfilerAction = nullptr;
+    QAction* m_reverseContinueAction = nullptr;
+    QAction* m_reverseUntilChangedAction = nullptr;
 
     QSpinBox* m_autoClockInterval = nullptr;
+    QSpinBox* m_autoClockCycles = nullptr;
+    QTimer* m_viewRefreshTimer = nullptr;
+
+    // Overlay of the host profile upon the processor view, refreshed by m_hostProfilerTimer while profiling
+    QLabel* m_hostProfilerOverlay = nullptr;
+    QTimer* m_hostProfilerTimer = nullptr;
 
     /**
      * @brief m_hasRun
      * True whenever the processor has been executed through the "Run" action.
      */
     bool m_hasRun = false;
+
+    /**
+     * @brief m_pendingRun
+     * Set by the "Run to" action to start the subsequent run through ProcessorHandler::runUntil rather than through
+     * ProcessorHandler::run.
+     */
+    std::function<void()> m_pendingRun;
+
+    /// Most recent target of the "Reverse until changed" action
+    QString m_reverseUntilChangedTarget;
 };
 }  // namespace Ripes
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <QByteArray>
+#include <QFile>
 #include <QMap>
 #include <QString>
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace Ripes {
 
-enum class FileType { Assembly, FlatBinary, Executable };
+enum class FileType { Assembly, FlatBinary, Executable, IntelHex, SRecord };
 
 #define TEXT_SECTION_NAME ".text"
 
@@ -22,6 +26,15 @@ struct ProgramSection {
     QString name;
     unsigned long address;
     QByteArray data;
+    /**
+     * @brief zeroSize
+     * Number of zero-filled bytes following the data of the section, such as those of .bss sections and trailing .zero
+     * directives. These are not materialized; unwritten simulator memory reads as zero.
+     */
+    unsigned long zeroSize = 0;
+
+    /// @returns the number of bytes which the section occupies in memory
+    unsigned long size() const { return static_cast<unsigned long>(data.size()) + zeroSize; }
 };
 
 /**
@@ -34,7 +47,31 @@ struct Program {
     std::vector<ProgramSection> sections;
     std::map<unsigned long, QString> symbols;
 
+    /**
+     * @brief buildIndex
+     * Builds the lookup indices of getSection and getSectionAt. Must be called once all sections have been added, and
+     * again if the sections are modified. Lookups on a program without an index fall back to a linear search.
+     */
+    void buildIndex() {
+        m_sectionsByName.clear();
+        m_sectionsByAddress.clear();
+        for (unsigned i = 0; i < sections.size(); i++) {
+            // As with the linear search, the first section of a given name takes precedence
+            m_sectionsByName.insert({sections[i].name, i});
+            if (sections[i].size() != 0) {
+                m_sectionsByAddress.push_back(i);
+            }
+        }
+        std::sort(m_sectionsByAddress.begin(), m_sectionsByAddress.end(),
+                  [&](unsigned a, unsigned b) { return sections[a].address < sections[b].address; });
+    }
+
     const ProgramSection* getSection(const QString& name) const {
+        if (!m_sectionsByName.empty()) {
+            const auto it = m_sectionsByName.find(name);
+            return it == m_sectionsByName.end() ? nullptr : &sections[it->second];
+        }
+
         const auto secIter =
             std::find_if(sections.begin(), sections.end(), [=](const auto& section) { return section.name == name; });
 
@@ -44,5 +81,43 @@ struct Program {
 
         return &*secIter;
     }
+
+    /**
+     * @brief getSectionAt
+     * @returns the section whose data or zero-filled bytes contain @p address, or nullptr if no such section exists.
+     * Sections are assumed not to overlap.
+     */
+    const ProgramSection* getSectionAt(unsigned long address) const {
+        const auto contains = [=](const ProgramSection& section) {
+            return section.address <= address && address - section.address < section.size();
+        };
+        if (m_sectionsByAddress.empty()) {
+            const auto secIter = std::find_if(sections.begin(), sections.end(), contains);
+            return secIter == sections.end() ? nullptr : &*secIter;
+        }
+
+        // Locate the last section starting at or before the address
+        auto it = std::upper_bound(m_sectionsByAddress.begin(), m_sectionsByAddress.end(), address,
+                                   [&](unsigned long addr, unsigned idx) { return addr < sections[idx].address; });
+        if (it == m_sectionsByAddress.begin()) {
+            return nullptr;
+        }
+        const ProgramSection& section = sections[*std::prev(it)];
+        return contains(section) ? &section : nullptr;
+    }
+
+    /**
+     * @brief getSymbolAt
+     * @returns the symbol at or nearest preceding @p address, or nullptr if no symbol precedes the address.
+     */
+    const std::pair<const unsigned long, QString>* getSymbolAt(unsigned long address) const {
+        auto it = symbols.upper_bound(address);
+        return it == symbols.begin() ? nullptr : &*std::prev(it);
+    }
+
+private:
+    std::map<QString, unsigned> m_sectionsByName;
+    /// Indices of all non-empty sections, sorted by address
+    std::vector<unsigned> m_sectionsByAddress;
 };
 }  // namespace Ripes
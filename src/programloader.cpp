@@ -0,0 +1,513 @@
+#include "programloader.h"
+
+#include "elfio/elfio.hpp"
+
+#include <cctype>
+#include <optional>
+
+#include "assembler.h"
+#include "assemblycache.h"
+
+namespace Ripes {
+
+namespace {
+
+/**
+ * @brief The MappedElf32 class
+ * Reader of the section headers and symbol tables of a memory mapped, 32-bit little-endian ELF file. All accessors are
+ * bounds checked against the size of the mapping.
+ */
+class MappedElf32 {
+public:
+    MappedElf32(const uchar* data, qint64 size) : m_data(data), m_size(size) {}
+
+    bool isValid() const {
+        return m_size >= s_ehdrSize && m_data[0] == 0x7F && m_data[1] == 'E' && m_data[2] == 'L' && m_data[3] == 'F' &&
+               m_data[4] == ELFCLASS32 && m_data[5] == ELFDATA2LSB && sectionHeaderSize() >= s_shdrSize &&
+               inBounds(sectionHeaderOffset(), static_cast<qint64>(sectionCount()) * sectionHeaderSize());
+    }
+
+    uint32_t entry() const { return word(24); }
+    unsigned sectionCount() const { return half(48); }
+    unsigned sectionNameTable() const { return half(50); }
+
+    // Section header fields
+    uint32_t name(unsigned idx) const { return word(sectionHeader(idx) + 0); }
+    uint32_t type(unsigned idx) const { return word(sectionHeader(idx) + 4); }
+    uint32_t address(unsigned idx) const { return word(sectionHeader(idx) + 12); }
+    uint32_t offset(unsigned idx) const { return word(sectionHeader(idx) + 16); }
+    uint32_t size(unsigned idx) const { return word(sectionHeader(idx) + 20); }
+    uint32_t link(unsigned idx) const { return word(sectionHeader(idx) + 24); }
+
+    /**
+     * @brief contents
+     * @returns a pointer to the contents of section @p idx within the mapping, or nullptr if the section occupies no
+     * space in the file or exceeds the mapping.
+     */
+    const char* contents(unsigned idx) const {
+        if (type(idx) == SHT_NOBITS || !inBounds(offset(idx), size(idx))) {
+            return nullptr;
+        }
+        return reinterpret_cast<const char*>(m_data + offset(idx));
+    }
+
+    /**
+     * @brief string
+     * @returns the null-terminated string at @p strOffset within the string table section @p strTab.
+     */
+    QString string(unsigned strTab, uint32_t strOffset) const {
+        const char* table = strTab < sectionCount() ? contents(strTab) : nullptr;
+        if (!table || strOffset >= size(strTab)) {
+            return QString();
+        }
+        const char* str = table + strOffset;
+        return QString::fromUtf8(str, static_cast<int>(qstrnlen(str, size(strTab) - strOffset)));
+    }
+
+    static constexpr qint64 s_symSize = 16;
+
+private:
+    static constexpr qint64 s_ehdrSize = 52;
+    static constexpr qint64 s_shdrSize = 40;
+
+    bool inBounds(qint64 offset, qint64 size) const { return offset >= 0 && size >= 0 && offset + size <= m_size; }
+    uint32_t sectionHeaderOffset() const { return word(32); }
+    unsigned sectionHeaderSize() const { return half(46); }
+    qint64 sectionHeader(unsigned idx) const {
+        return sectionHeaderOffset() + static_cast<qint64>(idx) * sectionHeaderSize();
+    }
+
+    uint32_t half(qint64 offset) const { return m_data[offset] | (m_data[offset + 1] << 8); }
+    uint32_t word(qint64 offset) const { return half(offset) | (half(offset + 2) << 16); }
+
+    const uchar* m_data;
+    qint64 m_size;
+};
+
+/**
+ * @brief loadMappedElfFile
+ * Loads the ELF file @p file through a private memory mapping of the file, which the headers and symbol tables are
+ * read from directly. Section data is copied out of the mapping, such that the program does not observe changes to
+ * the file once loaded, nor references the mapping after it is released.
+ * @returns false if the file could not be mapped or is not a 32-bit little-endian ELF file.
+ */
+bool loadMappedElfFile(Program& program, const QFile& file) {
+    QFile mappedFile(file.fileName());
+    if (!mappedFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const uchar* data = mappedFile.map(0, mappedFile.size(), QFileDevice::MapPrivateOption);
+    if (!data) {
+        return false;
+    }
+    const MappedElf32 elf(data, mappedFile.size());
+    if (!elf.isValid()) {
+        return false;
+    }
+
+    std::vector<ProgramSection> sections;
+    std::map<unsigned long, QString> symbols;
+    for (unsigned idx = 0; idx < elf.sectionCount(); idx++) {
+        ProgramSection& section = sections.emplace_back();
+        section.name = elf.string(elf.sectionNameTable(), elf.name(idx));
+        section.address = elf.address(idx);
+        if (const char* contents = elf.contents(idx)) {
+            section.data = QByteArray(contents, static_cast<int>(elf.size(idx)));
+        } else if (elf.type(idx) == SHT_NOBITS) {
+            // .bss and similar sections are zero-filled in memory, without being materialized
+            section.zeroSize = elf.size(idx);
+        }
+
+        if (elf.type(idx) == SHT_SYMTAB && section.data.size() != 0) {
+            // Collect function symbols
+            const auto* symtab = reinterpret_cast<const uchar*>(section.data.constData());
+            for (qint64 sym = 0; sym + MappedElf32::s_symSize <= section.data.size(); sym += MappedElf32::s_symSize) {
+                const uchar* entry = symtab + sym;
+                if ((entry[12] & 0xF) != STT_FUNC)
+                    continue;
+                const uint32_t name = entry[0] | (entry[1] << 8) | (entry[2] << 16) | (uint32_t(entry[3]) << 24);
+                const uint32_t value = entry[4] | (entry[5] << 8) | (entry[6] << 16) | (uint32_t(entry[7]) << 24);
+                symbols[value] = elf.string(elf.link(idx), name);
+            }
+        }
+    }
+
+    program.sections.insert(program.sections.end(), sections.begin(), sections.end());
+    program.symbols.insert(symbols.begin(), symbols.end());
+    program.entryPoint = elf.entry();
+    program.buildIndex();
+    return true;
+}
+
+/**
+ * @brief The RecordSections class
+ * Gathers the data records of a hex file into sections of contiguous data. Records which continue a previous record
+ * extend its section; all other records start a section of their own, leaving the gaps between records unallocated.
+ */
+class RecordSections {
+public:
+    void append(unsigned long address, const uint8_t* data, unsigned size) {
+        if (size == 0) {
+            return;
+        }
+        auto it = m_sectionEnds.find(address);
+        unsigned index;
+        if (it != m_sectionEnds.end()) {
+            index = it->second;
+            m_sectionEnds.erase(it);
+        } else {
+            index = static_cast<unsigned>(m_sections.size());
+            m_sections.push_back({QString(), address, QByteArray()});
+        }
+        m_sections[index].data.append(reinterpret_cast<const char*>(data), static_cast<int>(size));
+        m_sectionEnds[address + size] = index;
+    }
+
+    /**
+     * @brief finish
+     * Moves the gathered sections into @p program, merging sections which were written out of order but are
+     * contiguous. The section holding @p entryPoint, or the first section if no section holds it, becomes the .text
+     * section of the program. The entry point defaults to the start of the first section.
+     */
+    void finish(Program& program, std::optional<unsigned long> entryPoint) {
+        std::sort(m_sections.begin(), m_sections.end(),
+                  [](const ProgramSection& a, const ProgramSection& b) { return a.address < b.address; });
+        std::vector<ProgramSection> merged;
+        for (auto& section : m_sections) {
+            if (!merged.empty() && merged.back().address + merged.back().size() == section.address) {
+                merged.back().data.append(section.data);
+            } else {
+                merged.push_back(std::move(section));
+            }
+        }
+        if (!entryPoint) {
+            entryPoint = merged.empty() ? 0 : merged.front().address;
+        }
+        const auto text = std::find_if(merged.begin(), merged.end(), [&](const ProgramSection& section) {
+            return section.address <= *entryPoint && *entryPoint - section.address < section.size();
+        });
+        unsigned loadIndex = 0;
+        for (auto it = merged.begin(); it != merged.end(); it++) {
+            const bool isText = it == text || (text == merged.end() && it == merged.begin());
+            it->name = isText ? QString(TEXT_SECTION_NAME) : ".load" + QString::number(loadIndex++);
+            program.sections.push_back(std::move(*it));
+        }
+        program.entryPoint = *entryPoint;
+        program.buildIndex();
+    }
+
+private:
+    std::vector<ProgramSection> m_sections;
+    /// Index of the section ending at each address
+    std::map<unsigned long, unsigned> m_sectionEnds;
+};
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/// Decodes the @p length hex digits of @p text into @p bytes. @returns the number of bytes, or -1 if malformed.
+int decodeHex(const char* text, int length, uint8_t* bytes) {
+    if (length % 2 != 0) {
+        return -1;
+    }
+    for (int i = 0; i < length; i += 2) {
+        const int high = hexDigit(text[i]);
+        const int low = hexDigit(text[i + 1]);
+        if (high < 0 || low < 0) {
+            return -1;
+        }
+        bytes[i / 2] = static_cast<uint8_t>(high << 4 | low);
+    }
+    return length / 2;
+}
+
+unsigned long bigEndian(const uint8_t* bytes, unsigned size) {
+    unsigned long value = 0;
+    for (unsigned i = 0; i < size; i++) {
+        value = value << 8 | bytes[i];
+    }
+    return value;
+}
+
+/// Longest record line which is accepted; records hold at most 255 bytes of data
+constexpr int s_maxRecordLine = 1024;
+
+/**
+ * @brief The RecordParser class
+ * Parses the records of Intel HEX and Motorola S-record files, one line at a time.
+ */
+class RecordParser {
+public:
+    explicit RecordParser(FileType type) : m_type(type) {}
+
+    /// Parses the record @p line of @p length characters. @returns false if the record is malformed.
+    bool parse(const char* line, int length, QString& error) {
+        return m_type == FileType::IntelHex ? parseIntelHex(line, length, error) : parseSRecord(line, length, error);
+    }
+
+    /// Set once the end of file record has been parsed
+    bool done() const { return m_done; }
+    void finish(Program& program) { m_sections.finish(program, m_entryPoint); }
+
+private:
+    bool parseIntelHex(const char* line, int length, QString& error) {
+        // :LLAAAATT<data>CC
+        const int count = line[0] == ':' ? decodeHex(line + 1, length - 1, m_bytes) : -1;
+        if (count < 5 || m_bytes[0] + 5 != count) {
+            error = "Malformed Intel HEX record";
+            return false;
+        }
+        if (checksum(count) != 0) {
+            error = "Invalid checksum";
+            return false;
+        }
+        const unsigned size = m_bytes[0];
+        const unsigned long offset = bigEndian(m_bytes + 1, 2);
+        const uint8_t* data = m_bytes + 4;
+        switch (m_bytes[3]) {
+            case 0x00:
+                m_sections.append(m_base + offset, data, size);
+                return true;
+            case 0x01:
+                m_done = true;
+                return true;
+            case 0x02:
+                // Extended segment address
+                if (!expectSize(size, 2, error)) {
+                    return false;
+                }
+                m_base = bigEndian(data, 2) << 4;
+                return true;
+            case 0x03:
+                // Start segment address, as CS:IP
+                if (!expectSize(size, 4, error)) {
+                    return false;
+                }
+                m_entryPoint = (bigEndian(data, 2) << 4) + bigEndian(data + 2, 2);
+                return true;
+            case 0x04:
+                // Extended linear address
+                if (!expectSize(size, 2, error)) {
+                    return false;
+                }
+                m_base = bigEndian(data, 2) << 16;
+                return true;
+            case 0x05:
+                // Start linear address
+                if (!expectSize(size, 4, error)) {
+                    return false;
+                }
+                m_entryPoint = bigEndian(data, 4);
+                return true;
+        }
+        error = "Unknown record type " + QString::number(m_bytes[3]);
+        return false;
+    }
+
+    bool parseSRecord(const char* line, int length, QString& error) {
+        // S<type><count><address><data><checksum>, the count covering address, data and checksum
+        const int count = length >= 2 && line[0] == 'S' ? decodeHex(line + 2, length - 2, m_bytes) : -1;
+        if (count < 1 || m_bytes[0] + 1 != count) {
+            error = "Malformed S-record";
+            return false;
+        }
+        if (checksum(count) != 0xFF) {
+            error = "Invalid checksum";
+            return false;
+        }
+        const char type = line[1];
+        if (type < '0' || type > '9' || type == '4') {
+            error = QString("Unknown record type S") + type;
+            return false;
+        }
+        // Size of the address field of S0 to S9 records
+        constexpr unsigned addressSizes[] = {2, 2, 3, 4, 0, 2, 3, 4, 3, 2};
+        const unsigned addressSize = addressSizes[type - '0'];
+        if (static_cast<unsigned>(count) < 1 + addressSize + 1) {
+            error = "Malformed S-record";
+            return false;
+        }
+        const unsigned long address = bigEndian(m_bytes + 1, addressSize);
+        switch (type) {
+            case '1':
+            case '2':
+            case '3':
+                m_sections.append(address, m_bytes + 1 + addressSize, count - 2 - addressSize);
+                break;
+            case '7':
+            case '8':
+            case '9':
+                // Start address, terminating the file
+                m_entryPoint = address;
+                m_done = true;
+                break;
+            default:
+                // Header (S0) and record count (S5, S6) records carry no data of the program
+                break;
+        }
+        return true;
+    }
+
+    /// @returns the sum of the first @p count decoded bytes, modulo 256
+    uint8_t checksum(int count) const {
+        uint8_t sum = 0;
+        for (int i = 0; i < count; i++) {
+            sum += m_bytes[i];
+        }
+        return sum;
+    }
+
+    static bool expectSize(unsigned size, unsigned expected, QString& error) {
+        if (size != expected) {
+            error = "Malformed Intel HEX record";
+            return false;
+        }
+        return true;
+    }
+
+    FileType m_type;
+    RecordSections m_sections;
+    uint8_t m_bytes[s_maxRecordLine / 2];
+    /// Base address of data records, as set by extended address records
+    unsigned long m_base = 0;
+    std::optional<unsigned long> m_entryPoint;
+    bool m_done = false;
+};
+
+}  // namespace
+
+bool loadFlatBinaryFile(Program& program, QFile& file, unsigned long entryPoint, unsigned long loadAt) {
+    ProgramSection section;
+    section.name = TEXT_SECTION_NAME;
+    section.address = loadAt;
+    section.data = file.readAll();
+
+    program.sections.push_back(section);
+    program.entryPoint = entryPoint;
+    program.buildIndex();
+    return true;
+}
+
+bool loadRecordFile(Program& program, QFile& file, FileType type, QString& error) {
+    RecordParser parser(type);
+    // Records are parsed as they are read through the buffering of the file, one line at a time
+    char line[s_maxRecordLine + 2];
+    int lineNumber = 0;
+    while (!parser.done() && !file.atEnd()) {
+        lineNumber++;
+        int length = static_cast<int>(file.readLine(line, sizeof(line)));
+        if (length < 0) {
+            error = "Could not read " + file.fileName();
+            return false;
+        }
+        if (length == static_cast<int>(sizeof(line)) - 1 && line[length - 1] != '\n') {
+            error = QString("Line %1: Record is too long").arg(lineNumber);
+            return false;
+        }
+        while (length > 0 && std::isspace(static_cast<unsigned char>(line[length - 1]))) {
+            length--;
+        }
+        if (length == 0) {
+            continue;
+        }
+        if (!parser.parse(line, length, error)) {
+            error = QString("Line %1: %2").arg(lineNumber).arg(error);
+            return false;
+        }
+    }
+    parser.finish(program);
+    return true;
+}
+
+bool loadElfFile(Program& program, QFile& file) {
+    if (loadMappedElfFile(program, file)) {
+        return true;
+    }
+
+    ELFIO::elfio reader;
+
+    if (!reader.load(file.fileName().toStdString())) {
+        return false;
+    }
+
+    for (const auto& elfSection : reader.sections) {
+        ProgramSection& section = program.sections.emplace_back();
+        section.name = QString::fromStdString(elfSection->get_name());
+        section.address = elfSection->get_address();
+        if (elfSection->get_type() == SHT_NOBITS) {
+            section.zeroSize = elfSection->get_size();
+        } else {
+            // QByteArray performs a deep copy of the data when the data array is initialized at construction
+            section.data = QByteArray(elfSection->get_data(), static_cast<int>(elfSection->get_size()));
+        }
+
+        if (elfSection->get_type() == SHT_SYMTAB) {
+            // Collect function symbols
+            const ELFIO::symbol_section_accessor symbols(reader, elfSection);
+            for (unsigned int j = 0; j < symbols.get_symbols_num(); ++j) {
+                std::string name;
+                ELFIO::Elf64_Addr value;
+                ELFIO::Elf_Xword size;
+                unsigned char bind;
+                unsigned char type;
+                ELFIO::Elf_Half section_index;
+                unsigned char other;
+                symbols.get_symbol(j, name, value, size, bind, type, section_index, other);
+
+                if (type != STT_FUNC)
+                    continue;
+                program.symbols[value] = QString::fromStdString(name);
+            }
+        }
+    }
+
+    program.entryPoint = reader.get_entry();
+    program.buildIndex();
+    return true;
+}
+
+bool assembleFile(Program& program, QFile& file) {
+    // The file is assembled from a memory mapping where possible, sparing a copy of its contents
+    const qint64 size = file.size();
+    if (uchar* data = size > 0 ? file.map(0, size) : nullptr) {
+        const bool assembled = assembleSource(program, std::string_view(reinterpret_cast<const char*>(data), size));
+        file.unmap(data);
+        return assembled;
+    }
+    const QByteArray contents = file.readAll();
+    return assembleSource(program, std::string_view(contents.constData(), contents.size()));
+}
+
+bool assembleSource(Program& program, const QString& source) {
+    const QByteArray utf8 = source.toUtf8();
+    return assembleSource(program, std::string_view(utf8.constData(), utf8.size()));
+}
+
+bool assembleSource(Program& program, std::string_view source) {
+    const QStringList lines = Assembler::sourceLines(source);
+    const QByteArray key = AssemblyCache::key(lines);
+    if (AssemblyCache::find(key, program)) {
+        return true;
+    }
+
+    Assembler assembler;
+    assembler.assemble(lines);
+    if (assembler.hasError()) {
+        return false;
+    }
+    program = assembler.getProgram();
+    AssemblyCache::insert(key, program);
+    return true;
+}
+
+}  // namespace Ripes
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QFile>
+
+#include <string_view>
+
+#include "program.h"
+
+namespace Ripes {
+
+/**
+ * Widget-independent loading of programs from files. These functions are shared between the editor tab and the headless
+ * simulation mode, ensuring that a program is loaded identically regardless of whether the GUI is present.
+ */
+
+/**
+ * @brief loadFlatBinaryFile
+ * Loads the entirety of @p file as the .text section of @p program, placed at @p loadAt.
+ */
+bool loadFlatBinaryFile(Program& program, QFile& file, unsigned long entryPoint, unsigned long loadAt);
+
+/**
+ * @brief loadElfFile
+ * Loads all sections and function symbols of the ELF file @p file into @p program. No validity checking of the
+ * ELF file is performed. 32-bit little-endian ELF files are memory mapped, and the sections of @p program reference
+ * the mapping rather than copies of the file data.
+ */
+bool loadElfFile(Program& program, QFile& file);
+
+/**
+ * @brief loadRecordFile
+ * Loads the Intel HEX (@p type = FileType::IntelHex) or Motorola S-record (FileType::SRecord) file @p file into
+ * @p program. Records are parsed as the file is read, directly into sections of contiguous data; gaps between records
+ * are left unallocated rather than padded. The section holding the start address of the file is named .text, and all
+ * others .load0, .load1, ... in order of address.
+ * @returns false if the file holds a malformed record, with a description of the error in @p error.
+ */
+bool loadRecordFile(Program& program, QFile& file, FileType type, QString& error);
+
+/**
+ * @brief assembleFile
+ * Assembles the contents of @p file into @p program. The file is read through a memory mapping if possible, and is
+ * split into lines without constructing a text document.
+ * @returns false if the assembler reported an error.
+ */
+bool assembleFile(Program& program, QFile& file);
+
+/// Assembles the assembly source text @p source into @p program, as per assembleFile.
+bool assembleSource(Program& program, const QString& source);
+/// Assembles the UTF-8 assembly source text @p source into @p program, as per assembleFile.
+bool assembleSource(Program& program, std::string_view source);
+
+}  // namespace Ripes
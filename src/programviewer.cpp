@@ -4,19 +4,28 @@
 
 #include <QAction>
 #include <QApplication>
+#include <QClipboard>
 #include <QEvent>
 #include <QFontMetricsF>
+#include <QInputDialog>
 #include <QMenu>
-#include <QTextBlock>
+#include <QMessageBox>
+#include <QPainter>
+#include <QTextOption>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
 
 namespace Ripes {
 
-ProgramViewer::ProgramViewer(QWidget* parent) : QPlainTextEdit(parent) {
+ProgramViewer::ProgramViewer(QWidget* parent) : QAbstractScrollArea(parent) {
     m_breakpointArea = new BreakpointArea(this);
 
-    connect(this, &QPlainTextEdit::blockCountChanged, this, &ProgramViewer::updateSidebarWidth);
-    connect(this, &QPlainTextEdit::updateRequest, this, &ProgramViewer::updateSidebar);
-    updateSidebarWidth(0);
+    // Set margins of the listing area
+    m_sidebarWidth = m_breakpointArea->width();
+    setViewportMargins(m_sidebarWidth, 0, 0, 0);
 
     // Set font for the entire widget. calls to fontMetrics() will get the
     // dimensions of the currently set font
@@ -24,9 +33,8 @@ ProgramViewer::ProgramViewer(QWidget* parent) : QPlainTextEdit(parent) {
     setFont(m_font);
     m_fontTimer.setSingleShot(true);
 
-    setTabStopDistance(QFontMetricsF(m_font).width(' ') * 4);
-
-    setLineWrapMode(QPlainTextEdit::NoWrap);
+    setFocusPolicy(Qt::StrongFocus);
+    updateScrollBars();
 }
 
 void ProgramViewer::clearBreakpoints() {
@@ -34,106 +42,245 @@ void ProgramViewer::clearBreakpoints() {
 }
 
 void ProgramViewer::resizeEvent(QResizeEvent* e) {
-    QPlainTextEdit::resizeEvent(e);
+    QAbstractScrollArea::resizeEvent(e);
 
     const QRect cr = contentsRect();
     m_breakpointArea->setGeometry(cr.left(), cr.top(), m_breakpointArea->width(), cr.height());
+    updateScrollBars();
+}
 
-    // we need to update the highlighted lines whenever resizing the window to recalculate the highlighting gradient,
-    // reflecting the new widget size
-    updateHighlightedAddresses();
+void ProgramViewer::scrollContentsBy(int, int) {
+    viewport()->update();
+    m_breakpointArea->update();
 }
 
-void ProgramViewer::updateProgram(const Program& program, bool binary) {
-    m_labelAddrOffsetMap.clear();
-    const QString text = binary ? Parser::getParser()->binarize(program, m_labelAddrOffsetMap)
-                                : Parser::getParser()->disassemble(program, m_labelAddrOffsetMap);
+void ProgramViewer::updateScrollBars() {
+    const int visibleRows = std::max(1, viewport()->height() / rowHeight());
+    verticalScrollBar()->setPageStep(visibleRows);
+    verticalScrollBar()->setRange(0, std::max(0, rowCount() - visibleRows));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(fontMetrics().width(' '));
+    horizontalScrollBar()->setRange(0, std::max(0, m_maxRowWidth - viewport()->width()));
+}
+
+void ProgramViewer::clear() {
+    updateProgram(Program());
+}
 
-    // A memory occurs within QPlainTextEdit::clear if extra selections has been set. This is most possibly a bug, but
-    // seems to be fixed if we manually clear the selections before we clear (and add new text) to the text edit.
-    setExtraSelections({});
+void ProgramViewer::updateProgram(const Program& program, bool binary) {
+    m_program = program;
+    m_binary = binary;
+    m_instructionRows.clear();
+    m_labelRows.clear();
+    m_maxRowWidth = 0;
+    m_selectionAnchor = -1;
+    m_selectionCursor = -1;
+
+    // Only the rows are laid out here; their text is generated once they are painted
+    const auto* textSection = m_program.getSection(TEXT_SECTION_NAME);
+    m_text = textSection ? textSection->data : QByteArray();
+    m_textAddress = textSection ? textSection->address : 0;
+    m_compressed = ProcessorHandler::get()->currentISA()->hasCompressedInstructions();
+    m_layout = InstructionLayout(m_text, m_compressed);
+    const unsigned instructions = m_layout.count();
+    m_instructionRows.resize(instructions);
+    auto symbol = m_program.symbols.lower_bound(m_textAddress);
+    for (unsigned i = 0; i < instructions; i++) {
+        const unsigned long address = m_textAddress + m_layout.offset(i);
+        while (symbol != m_program.symbols.end() && symbol->first < address) {
+            symbol++;
+        }
+        if (symbol != m_program.symbols.end() && symbol->first == address) {
+            m_labelRows.push_back(i + 2 * static_cast<uint32_t>(m_labelRows.size()));
+        }
+        m_instructionRows[i] = i + 2 * static_cast<uint32_t>(m_labelRows.size());
+    }
 
-    setPlainText(text);
+    updateScrollBars();
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
     updateHighlightedAddresses();
+    viewport()->update();
 }
 
-void ProgramViewer::updateSidebar(const QRect& rect, int dy) {
-    m_breakpointArea->update(0, rect.y(), m_breakpointArea->width(), rect.height());
+uint32_t ProgramViewer::instructionAt(unsigned index) const {
+    // Hardcoded for RV32 for now
+    const unsigned offset = m_layout.offset(index);
+    uint32_t instr = 0;
+    for (unsigned i = 0; i < 4 && offset + i < static_cast<unsigned>(m_text.size()); i++) {
+        instr |= static_cast<uint32_t>(static_cast<uint8_t>(m_text.at(offset + i))) << (CHAR_BIT * i);
+    }
+    return instr;
+}
 
-    if (rect.contains(viewport()->rect()))
-        updateSidebarWidth(0);
+ProgramViewer::RowKind ProgramViewer::rowKind(int row, unsigned& index) const {
+    // Rows preceding the first label of the listing are instructions. Otherwise, the row is the blank row, label row or
+    // an instruction following the last label at or before the row, each label adding two rows.
+    const auto next = std::upper_bound(m_labelRows.begin(), m_labelRows.end(), static_cast<uint32_t>(row));
+    const auto labels = static_cast<unsigned>(next - m_labelRows.begin());
+    if (labels == 0) {
+        index = static_cast<unsigned>(row);
+        return RowKind::Instruction;
+    }
+    const unsigned offset = static_cast<unsigned>(row) - *std::prev(next);
+    index = static_cast<unsigned>(row) - 2 * labels + (offset < 2 ? 2 - offset : 0);
+    return offset == 0 ? RowKind::Blank : offset == 1 ? RowKind::Label : RowKind::Instruction;
 }
 
-void ProgramViewer::updateSidebarWidth(int /* newBlockCount */) {
-    // Set margins of the text edit area
-    m_sidebarWidth = m_breakpointArea->width();
-    setViewportMargins(m_sidebarWidth, 0, 0, 0);
+QString ProgramViewer::rowText(int row) const {
+    unsigned index;
+    const RowKind kind = rowKind(row, index);
+    const unsigned long address = m_textAddress + m_layout.offset(index);
+    if (kind == RowKind::Blank) {
+        return QString();
+    } else if (kind == RowKind::Label) {
+        return Parser::getParser()->labelLine(address, m_program.symbols.at(address));
+    }
+    return Parser::getParser()->instructionLine(m_program, instructionAt(index), address, m_binary, m_compressed);
 }
 
 void ProgramViewer::updateHighlightedAddresses() {
+    if (!ProcessorHandler::get()->isRunning()) {
+        m_maxProfileCost = ProcessorHandler::get()->getProfiler().maxCost();
+        m_breakpointArea->update();
+        const auto generation = ProcessorHandler::get()->getAccessPatterns().generation();
+        if (generation != m_accessPatternsGeneration) {
+            m_accessPatternsGeneration = generation;
+            viewport()->update();
+        }
+    }
+
     const unsigned stages = ProcessorHandler::get()->getProcessor()->stageCount();
     QColor bg = QColor(Qt::red).lighter(120);
     const int decRatio = 100 + 80 / stages;
-    QList<QTextEdit::ExtraSelection> highlights;
-    std::set<unsigned long> highlightedPCs;
-    m_highlightedBlocksText.clear();
+    std::map<int, QStringList> highlightedRowsText;
+    std::map<int, QColor> highlightedRowsColor;
 
     for (unsigned sid = 0; sid < stages; sid++) {
         const auto stageInfo = ProcessorHandler::get()->getProcessor()->stageInfo(sid);
         if (stageInfo.stage_valid) {
-            auto block = blockForAddress(stageInfo.pc);
-            if (!block.isValid())
-                continue;
-
-            // Record the stage name for the highlighted block for later painting
-            m_highlightedBlocksText[block] << ProcessorHandler::get()->getProcessor()->stageName(sid);
-
-            // If a stage has already been highlighted (ie. an instruction exists in more than 1 stage at once), keep
-            // the already set highlighting.
-            if (highlightedPCs.count(stageInfo.pc)) {
-                continue;
+            const int row = rowForAddress(stageInfo.pc);
+            if (row >= 0) {
+                // Record the stage name for the highlighted row for later painting
+                highlightedRowsText[row] << ProcessorHandler::get()->getProcessor()->stageName(sid);
+
+                // If a stage has already been highlighted (ie. an instruction exists in more than 1 stage at once),
+                // keep the already set highlighting.
+                highlightedRowsColor.emplace(row, bg);
             }
+        }
+        bg = bg.lighter(decRatio);
+    }
 
-            QTextEdit::ExtraSelection es;
-            es.cursor = QTextCursor(block);
-            es.format.setProperty(QTextFormat::FullWidthSelection, true);
+    // Only the rows which were or become highlighted are repainted, and only if the highlighting changed
+    if (highlightedRowsText == m_highlightedRowsText && highlightedRowsColor == m_highlightedRowsColor) {
+        return;
+    }
+    updateRows(m_highlightedRowsColor);
+    m_highlightedRowsText.swap(highlightedRowsText);
+    m_highlightedRowsColor.swap(highlightedRowsColor);
+    updateRows(m_highlightedRowsColor);
+}
 
-            const auto bbr = blockBoundingRect(block);
-            QLinearGradient grad(bbr.topLeft(), bbr.bottomRight());
-            grad.setColorAt(0, palette().base().color());
-            grad.setColorAt(1, bg);
-            es.format.setBackground(grad);
+void ProgramViewer::updateRows(const std::map<int, QColor>& rows) {
+    const int first = firstVisibleRow();
+    const int last = first + viewport()->height() / rowHeight();
+    for (auto it = rows.lower_bound(first); it != rows.end() && it->first <= last; it++) {
+        viewport()->update(0, (it->first - first) * rowHeight(), viewport()->width(), rowHeight());
+    }
+}
 
-            highlights << es;
-            highlightedPCs.insert(stageInfo.pc);
-        }
-        bg = bg.lighter(decRatio);
+namespace {
+QString accessPatternText(const AccessPatternAnalyzer::Pattern& pattern) {
+    QString text = "# " + QString::number(pattern.accesses) + (pattern.store ? " stores" : " loads");
+    if (pattern.accesses > 1) {
+        text += ", stride " + QString(pattern.stride >= 0 ? "+" : "") + QString::number(pattern.stride) + " (" +
+                QString::number(100.0 * pattern.strideConfidence(), 'f', 0) + "%)";
     }
-    setExtraSelections(highlights);
+    text += pattern.reuses == 0 ? ", no reuse"
+                                : ", reuse distance " + QString::number(pattern.meanReuseDistance(), 'f', 1);
+    return text;
 }
+}  // namespace
 
 void ProgramViewer::paintEvent(QPaintEvent* event) {
-    QPlainTextEdit::paintEvent(event);
-
-    // Draw stage names for highlighted addresses
     QPainter painter(viewport());
+    painter.setFont(font());
+
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    option.setTabStopDistance(QFontMetricsF(m_font).width(' ') * 4);
+
+    const int height = rowHeight();
+    const int width = viewport()->width();
+    const int xOffset = -horizontalScrollBar()->value() + /* padding */ 4;
+    const int first = firstVisibleRow();
+    const int last = std::min(rowCount() - 1, first + viewport()->height() / height);
+    const int selectionFirst = std::min(m_selectionAnchor, m_selectionCursor);
+    const int selectionLast = std::max(m_selectionAnchor, m_selectionCursor);
+    const auto* accessPatterns =
+        ProcessorHandler::get()->isRunning() ? nullptr : &ProcessorHandler::get()->getAccessPatterns();
+    int maxRowWidth = m_maxRowWidth;
+
+    for (int row = first; row <= last; row++) {
+        const QRect rowRect(0, (row - first) * height, width, height);
+        if (!rowRect.intersects(event->rect())) {
+            continue;
+        }
+
+        const bool selected = selectionFirst >= 0 && selectionFirst <= row && row <= selectionLast;
+        if (selected) {
+            painter.fillRect(rowRect, palette().highlight());
+        } else {
+            const auto highlight = m_highlightedRowsColor.find(row);
+            if (highlight != m_highlightedRowsColor.end()) {
+                QLinearGradient grad(rowRect.topLeft(), rowRect.bottomRight());
+                grad.setColorAt(0, palette().base().color());
+                grad.setColorAt(1, highlight->second);
+                painter.fillRect(rowRect, grad);
+            }
+        }
 
-    for (const auto& hb : m_highlightedBlocksText) {
-        const QString stageString = hb.second.join('/');
-        const auto bbr = blockBoundingGeometry(hb.first);
-        painter.setFont(font());
-        painter.drawText(bbr.width() - painter.fontMetrics().boundingRect(stageString).width() - /*padding*/ 10,
-                         bbr.top() + bbr.height(), stageString);
+        const QString text = rowText(row);
+        const QRectF textRect(xOffset, rowRect.top(), std::numeric_limits<short>::max(), height);
+        painter.setPen(selected ? palette().highlightedText().color() : palette().text().color());
+        painter.drawText(textRect, text, option);
+        int rowWidth = static_cast<int>(painter.boundingRect(textRect, text, option).width());
+
+        // Memory instructions are annotated with the patterns of their accesses, following the instruction
+        const long address = addressForRow(row);
+        const auto* pattern = accessPatterns && address >= 0 ? accessPatterns->at(address) : nullptr;
+        if (pattern && pattern->accesses != 0) {
+            const QString annotation = accessPatternText(*pattern);
+            const QRectF annotationRect(xOffset + rowWidth + 4 * height, rowRect.top(),
+                                        std::numeric_limits<short>::max(), height);
+            painter.setPen(selected ? palette().highlightedText().color()
+                                    : palette().color(QPalette::Disabled, QPalette::Text));
+            painter.drawText(annotationRect, annotation, option);
+            rowWidth += 4 * height + static_cast<int>(painter.boundingRect(annotationRect, annotation, option).width());
+        }
+        maxRowWidth = std::max(maxRowWidth, rowWidth);
+
+        // Draw stage names for highlighted addresses
+        const auto stageNames = m_highlightedRowsText.find(row);
+        if (stageNames != m_highlightedRowsText.end()) {
+            const QString stageString = stageNames->second.join('/');
+            painter.drawText(width - painter.fontMetrics().boundingRect(stageString).width() - /*padding*/ 10,
+                             rowRect.top() + painter.fontMetrics().ascent(), stageString);
+        }
     }
     painter.end();
+
+    if (maxRowWidth > m_maxRowWidth) {
+        m_maxRowWidth = maxRowWidth;
+        updateScrollBars();
+    }
 }
 
 void ProgramViewer::breakpointAreaPaintEvent(QPaintEvent* event) {
     QPainter painter(m_breakpointArea);
 
-    // When caret flashes in QPlainTextEdit a paint event is sent to this widget,
-    // with a height of a line in the edit. We override this paint event by always
-    // redrawing the visible breakpoint area
+    // The visible breakpoint area is always redrawn in full
     auto area = m_breakpointArea->rect();
     QLinearGradient gradient = QLinearGradient(area.topLeft(), area.bottomRight());
     gradient.setColorAt(0, QColor(Colors::FoundersRock).lighter(120));
@@ -141,146 +288,192 @@ void ProgramViewer::breakpointAreaPaintEvent(QPaintEvent* event) {
 
     painter.fillRect(area, gradient);
 
-    QTextBlock block = firstVisibleBlock();
-    int top = static_cast<int>(blockBoundingGeometry(block).translated(contentOffset()).top());
-    int bottom = top + static_cast<int>(blockBoundingRect(block).height());
-
-    while (block.isValid() && top <= event->rect().bottom()) {
-        if (block.isVisible() && bottom >= event->rect().top()) {
-            const long address = addressForBlock(block);
-            if (address >= 0) {
-                if (ProcessorHandler::get()->hasBreakpoint(address)) {
-                    painter.drawPixmap(m_breakpointArea->padding, top, m_breakpointArea->imageWidth,
-                                       m_breakpointArea->imageHeight, m_breakpointArea->m_breakpoint);
+    // The profile is written to while running
+    const auto* profiler = ProcessorHandler::get()->isRunning() ? nullptr : &ProcessorHandler::get()->getProfiler();
+
+    const int height = rowHeight();
+    const int first = firstVisibleRow();
+    const int last = std::min(rowCount() - 1, first + m_breakpointArea->height() / height);
+    for (int row = first; row <= last; row++) {
+        const int top = (row - first) * height;
+        if (top > event->rect().bottom() || top + height < event->rect().top()) {
+            continue;
+        }
+        const long address = addressForRow(row);
+        if (address >= 0) {
+            // Instructions are heat coloured by their share of the cost of the hottest instruction
+            const auto* entry = profiler ? profiler->at(address) : nullptr;
+            if (entry && entry->cost() != 0 && m_maxProfileCost != 0) {
+                QColor heat = QColor(Qt::red);
+                const double share = static_cast<double>(entry->cost()) / m_maxProfileCost;
+                heat.setAlphaF(0.15 + 0.85 * std::min(share, 1.0));
+                painter.fillRect(0, top, m_breakpointArea->width(), height, heat);
+            }
+            if (ProcessorHandler::get()->hasBreakpoint(address)) {
+                painter.drawPixmap(m_breakpointArea->padding, top, m_breakpointArea->imageWidth,
+                                   m_breakpointArea->imageHeight, m_breakpointArea->m_breakpoint);
+                if (ProcessorHandler::get()->getBreakpointCondition(address)) {
+                    // Conditional breakpoints are marked by a question mark
+                    painter.setPen(Qt::white);
+                    painter.drawText(QRect(m_breakpointArea->padding, top, m_breakpointArea->imageWidth,
+                                           m_breakpointArea->imageHeight),
+                                     Qt::AlignCenter, "?");
                 }
             }
         }
-
-        block = block.next();
-        top = bottom;
-        bottom = top + static_cast<int>(blockBoundingRect(block).height());
     }
 }
 
-namespace {}
-
-QTextBlock ProgramViewer::blockForAddress(unsigned long addr) const {
-    const long adjustedLineNumber =
-        (addr - ProcessorHandler::get()->getTextStart()) / ProcessorHandler::get()->currentISA()->bytes();
-
-    if (m_labelAddrOffsetMap.empty()) {
-        return document()->findBlockByNumber(adjustedLineNumber);
-    }
-
-    long lineNumber = adjustedLineNumber;
-    auto low = m_labelAddrOffsetMap.lower_bound(lineNumber);
-
-    if (lineNumber < low->first && (low == m_labelAddrOffsetMap.begin())) {
-        // The line number is less that the position of the first offset block; block is directly inferred from
-        // linenumber.
-        return document()->findBlockByNumber(adjustedLineNumber);
+int ProgramViewer::rowForAddress(unsigned long address) const {
+    if (address < m_textAddress) {
+        return -1;
     }
-
-    auto high = low;
-    if (low != m_labelAddrOffsetMap.begin()) {
-        low = std::prev(m_labelAddrOffsetMap.lower_bound(lineNumber));
+    const int index = m_layout.index(static_cast<uint32_t>(address - m_textAddress));
+    if (index < 0 || m_textAddress + m_layout.offset(index) != address) {
+        return -1;
     }
-    high = std::next(low);
-
-    auto validBlockRange = [this, adjustedLineNumber](auto& low, auto& high, long lineNumber) {
-        if (m_labelAddrOffsetMap.count(lineNumber))
-            return false;
-
-        bool valid = true;
-        valid &= (low->first - low->second) <= adjustedLineNumber;
-        if (high != m_labelAddrOffsetMap.end()) {
-            valid &= adjustedLineNumber < (high->first - high->second);
-        }
-        return valid;
-    };
+    return static_cast<int>(m_instructionRows[index]);
+}
 
-    // Adjust low and high iterators to locate the range bounds of the address
-    while (!validBlockRange(low, high, lineNumber)) {
-        low = m_labelAddrOffsetMap.lower_bound(lineNumber);
-        high = std::next(low);
-        lineNumber = low->first + 1;
+void ProgramViewer::selectAddressRange(unsigned long first, unsigned long last) {
+    const int firstRow = rowForAddress(first);
+    const int lastRow = rowForAddress(last);
+    if (firstRow < 0 || lastRow < 0) {
+        return;
     }
-
-    const int offsetSum = high == m_labelAddrOffsetMap.end() ? low->second + 1 : high->second;
-    lineNumber = offsetSum + adjustedLineNumber;
-
-    return document()->findBlockByNumber(lineNumber);
+    m_selectionAnchor = firstRow;
+    m_selectionCursor = lastRow;
+    // The range is centered if it fits within the viewport, or else shown from its first row
+    const int visibleRows = viewport()->height() / rowHeight();
+    const int span = lastRow - firstRow + 1;
+    verticalScrollBar()->setValue(span < visibleRows ? firstRow - (visibleRows - span) / 2 : firstRow);
+    viewport()->update();
 }
 
-long ProgramViewer::addressForBlock(QTextBlock block) const {
-    const static auto calcAddressFunc = [](int lineNumber) {
-        return lineNumber * ProcessorHandler::get()->currentISA()->bytes() + ProcessorHandler::get()->getTextStart();
-    };
-
-    const int lineNumber = block.blockNumber();
-
-    // Clicking an invalid line? (non-instruction line)
-    if (m_labelAddrOffsetMap.count(lineNumber)) {
+long ProgramViewer::addressForRow(int row) const {
+    unsigned index;
+    if (row < 0 || row >= rowCount() || rowKind(row, index) != RowKind::Instruction) {
+        // Non-instruction line
         return -1;
     }
+    return static_cast<long>(m_textAddress + m_layout.offset(index));
+}
 
-    // To identify the program address corresponding to the selected line, we find the lower bound of the selected block
-    // in the m_labelAddrOffsetMap and subtract the invalid line count up to the given point.
-    int adjustedLineNumber = lineNumber;
-
-    if (m_labelAddrOffsetMap.empty())
-        return calcAddressFunc(adjustedLineNumber);
+long ProgramViewer::addressForPos(const QPoint& pos) const {
+    return addressForRow(rowAt(pos.y()));
+}
 
-    auto low = m_labelAddrOffsetMap.lower_bound(lineNumber);
+bool ProgramViewer::hasBreakpoint(const QPoint& pos) const {
+    return ProcessorHandler::get()->hasBreakpoint(static_cast<unsigned>(addressForPos(pos)));
+}
 
-    if (lineNumber < low->first && (low == m_labelAddrOffsetMap.begin())) {
-        // The line number is less that the position of the first offset block; address is directly inferred from
-        // linenumber.
-        return calcAddressFunc(adjustedLineNumber);
+void ProgramViewer::breakpointClick(const QPoint& pos) {
+    const auto address = addressForPos(pos);
+    if (!(address < 0)) {
+        ProcessorHandler::get()->toggleBreakpoint(static_cast<unsigned>(address));
+        m_breakpointArea->repaint();
     }
+}
 
-    if (low != m_labelAddrOffsetMap.begin()) {
-        low = std::prev(m_labelAddrOffsetMap.lower_bound(lineNumber));
+void ProgramViewer::editBreakpointCondition(const QPoint& pos) {
+    const auto address = addressForPos(pos);
+    if (address < 0) {
+        return;
     }
-
-    adjustedLineNumber -= (low->second + 1);
-    return calcAddressFunc(adjustedLineNumber);
+    auto* handler = ProcessorHandler::get();
+    const auto* condition = handler->getBreakpointCondition(static_cast<unsigned>(address));
+    QString expression = condition ? condition->expression() : QString();
+    while (true) {
+        bool ok = false;
+        expression = QInputDialog::getText(
+            this, "Breakpoint condition",
+            QString("Break at 0x%1 when (ie. 'a0 == 0 && x5 > 100' or 'hits == 10'; empty for always):")
+                .arg(static_cast<unsigned>(address), 8, 16, QChar('0')),
+            QLineEdit::Normal, expression, &ok);
+        if (!ok) {
+            return;
+        }
+        QString error;
+        if (handler->setBreakpointCondition(static_cast<unsigned>(address), expression, error)) {
+            break;
+        }
+        QMessageBox::warning(this, "Invalid breakpoint condition", error);
+    }
+    m_breakpointArea->repaint();
 }
 
-long ProgramViewer::addressForPos(const QPoint& pos) const {
-    // Get line height
-    QTextBlock block = firstVisibleBlock();
-
-    const auto height = blockBoundingRect(block).height();
-
-    // Find block index in the ProgramViewer
-    int index;
-    if (block == document()->findBlockByLineNumber(0)) {
-        index = static_cast<int>((pos.y() - contentOffset().y()) / height);
-    } else {
-        index = static_cast<int>((pos.y() + contentOffset().y()) / height);
+void ProgramViewer::mousePressEvent(QMouseEvent* event) {
+    const int row = rowAt(event->pos().y());
+    if (event->button() != Qt::LeftButton || row < 0 || row >= rowCount()) {
+        return;
     }
-    // Get actual block index
-    while (index > 0) {
-        block = block.next();
-        index--;
+    // Shift-clicking extends the current selection
+    m_selectionCursor = row;
+    if (!(event->modifiers() & Qt::ShiftModifier) || m_selectionAnchor < 0) {
+        m_selectionAnchor = row;
     }
-    if (!block.isValid())
-        return -1;
+    viewport()->update();
+}
 
-    return addressForBlock(block);
+void ProgramViewer::mouseMoveEvent(QMouseEvent* event) {
+    if (!(event->buttons() & Qt::LeftButton) || m_selectionAnchor < 0) {
+        return;
+    }
+    m_selectionCursor = std::max(0, std::min(rowCount() - 1, rowAt(std::max(0, event->pos().y()))));
+    if (event->pos().y() < 0 || event->pos().y() >= viewport()->height()) {
+        // Dragging past the edges of the listing scrolls it
+        verticalScrollBar()->setValue(verticalScrollBar()->value() + (event->pos().y() < 0 ? -1 : 1));
+    }
+    viewport()->update();
 }
 
-bool ProgramViewer::hasBreakpoint(const QPoint& pos) const {
-    return ProcessorHandler::get()->hasBreakpoint(static_cast<unsigned>(addressForPos(pos)));
+void ProgramViewer::keyPressEvent(QKeyEvent* event) {
+    if (event->matches(QKeySequence::Copy)) {
+        copySelection();
+    } else if (event->matches(QKeySequence::SelectAll) && rowCount() > 0) {
+        m_selectionAnchor = 0;
+        m_selectionCursor = rowCount() - 1;
+        viewport()->update();
+    } else {
+        QAbstractScrollArea::keyPressEvent(event);
+    }
 }
 
-void ProgramViewer::breakpointClick(const QPoint& pos) {
-    const auto address = addressForPos(pos);
-    if (!(address < 0)) {
-        ProcessorHandler::get()->toggleBreakpoint(static_cast<unsigned>(address));
-        repaint();
+void ProgramViewer::copySelection() const {
+    if (m_selectionAnchor < 0) {
+        return;
+    }
+
+    // Selections may span the entire listing. Rows are formatted in chunks on the global thread pool, each chunk into
+    // its own string, which are then joined in order.
+    constexpr int chunkRows = 4096;
+    const int first = std::min(m_selectionAnchor, m_selectionCursor);
+    const int last = std::max(m_selectionAnchor, m_selectionCursor);
+    std::vector<std::pair<int, int>> chunks;
+    for (int row = first; row <= last; row += chunkRows) {
+        chunks.emplace_back(row, std::min(last, row + chunkRows - 1));
+    }
+    const std::function<QString(const std::pair<int, int>&)> format = [this](const std::pair<int, int>& chunk) {
+        QString text;
+        text.reserve((chunk.second - chunk.first + 1) * 48);
+        for (int row = chunk.first; row <= chunk.second; row++) {
+            text += rowText(row);
+            text += '\n';
+        }
+        return text;
+    };
+    const auto parts = QtConcurrent::blockingMapped<QList<QString>>(chunks, format);
+
+    int size = 0;
+    for (const auto& part : parts) {
+        size += part.size();
+    }
+    QString text;
+    text.reserve(size);
+    for (const auto& part : parts) {
+        text += part;
     }
+    QApplication::clipboard()->setText(text);
 }
 
 // -------------- breakpoint area ----------------------------------
@@ -296,9 +489,11 @@ void BreakpointArea::contextMenuEvent(QContextMenuEvent* event) {
 
     // Create and connect actions for removing and setting breakpoints
     auto* toggleAction = contextMenu.addAction("Toggle breakpoint");
+    auto* conditionAction = contextMenu.addAction("Edit breakpoint condition...");
     auto* removeAllAction = contextMenu.addAction("Remove all breakpoints");
 
     connect(toggleAction, &QAction::triggered, [=] { m_programViewer->breakpointClick(event->pos()); });
+    connect(conditionAction, &QAction::triggered, [=] { m_programViewer->editBreakpointCondition(event->pos()); });
     connect(removeAllAction, &QAction::triggered, [=] {
         m_programViewer->clearBreakpoints();
         repaint();
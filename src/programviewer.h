@@ -1,10 +1,12 @@
 #pragma once
 
+#include <QAbstractScrollArea>
 #include <QFont>
+#include <QMouseEvent>
 #include <QObject>
-#include <QPlainTextEdit>
 #include <QScrollBar>
 #include <QTimer>
+#include <QWheelEvent>
 
 #include "parser.h"
 #include "processorhandler.h"
@@ -14,43 +16,73 @@ namespace Ripes {
 
 class BreakpointArea;
 
-class ProgramViewer : public QPlainTextEdit {
+/**
+ * @brief The ProgramViewer class
+ * Read-only listing of the text section of a program, with a row per instruction and two rows (a blank row and a
+ * label) preceding each symbol. The listing is virtualized; only the mapping between rows and addresses is built when a
+ * program is loaded, and the text of a row is generated from the program whenever the row is painted or copied.
+ */
+class ProgramViewer : public QAbstractScrollArea {
     Q_OBJECT
 public:
     ProgramViewer(QWidget* parent = nullptr);
-    void paintEvent(QPaintEvent* e) override;
 
     void breakpointAreaPaintEvent(QPaintEvent* event);
     void breakpointClick(const QPoint& pos);
+    /// Prompts for the condition of the breakpoint at the instruction at @p pos, setting the breakpoint if needed
+    void editBreakpointCondition(const QPoint& pos);
     bool hasBreakpoint(const QPoint& pos) const;
     void clearBreakpoints();
 
     long addressForPos(const QPoint& pos) const;
-    long addressForBlock(QTextBlock block) const;
-    QTextBlock blockForAddress(unsigned long) const;
+    /// @returns the address of the instruction shown in @p row, or -1 if the row does not show an instruction
+    long addressForRow(int row) const;
+    /// @returns the row showing the instruction at @p address, or -1 if the address is not within the listing
+    int rowForAddress(unsigned long address) const;
+    /// Selects the rows from the instruction at @p first to the instruction at @p last, and scrolls them into view
+    void selectAddressRange(unsigned long first, unsigned long last);
 
     ///
     /// \brief updateProgram
-    /// Refreshes the programViewer view with @p program, using the parser to either disassemble or (if @p binary is
-    /// true) show the raw binary version of the loaded program.
+    /// Refreshes the programViewer view with @p program, showing either the disassembled or (if @p binary is true) the
+    /// raw binary version of the loaded program.
     ///
     void updateProgram(const Program& program, bool binary = false);
+    void clear();
 
 public slots:
     void updateHighlightedAddresses();
 
 protected:
+    void paintEvent(QPaintEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
-
-private slots:
-    void updateSidebar(const QRect&, int);
-    void updateSidebarWidth(int newBlockCount);
+    void scrollContentsBy(int dx, int dy) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
 
 private:
+    enum class RowKind { Instruction, Blank, Label };
+
+    int rowCount() const { return static_cast<int>(m_instructionRows.size() + 2 * m_labelRows.size()); }
+    /**
+     * @brief rowKind
+     * @returns what @p row shows, and sets @p index to the index of the instruction which the row shows or precedes.
+     * A binary search over the label rows.
+     */
+    RowKind rowKind(int row, unsigned& index) const;
+    int rowHeight() const { return fontMetrics().height(); }
+    int firstVisibleRow() const { return verticalScrollBar()->value(); }
+    int rowAt(int y) const { return y < 0 ? -1 : firstVisibleRow() + y / rowHeight(); }
+    uint32_t instructionAt(unsigned index) const;
+    QString rowText(int row) const;
+    void updateScrollBars();
+    void copySelection() const;
+    void updateRows(const std::map<int, QColor>& rows);
+
     // A timer is needed for only catching one of the multiple wheel events that
     // occur on a regular mouse scroll
     QTimer m_fontTimer;
-    QTimer m_changeTimer;
 
     QFont m_font;
     int m_sidebarWidth;
@@ -58,14 +90,41 @@ private:
     BreakpointArea* m_breakpointArea;
 
     /**
-     * @brief m_labelAddrOffsetMap
-     * To correctly correlate a line index with program address location whilst accounting for additional output in the
-     * disassembled view of a program, we provide the AddrOffsetMap. Key in this map indicate line numbers (starting
-     * from 0) which does >not< correspond with an address. The value of the key corresponds to the total sum of
-     * non-address lines encountered up to and including the given label.
+     * @brief m_program
+     * Program of the listing. Copying a program shares the data of its sections, such that the text section is not
+     * duplicated.
+     */
+    Program m_program;
+    QByteArray m_text;
+    unsigned long m_textAddress = 0;
+    bool m_binary = false;
+    /// Whether the text section may contain compressed instructions, and the offsets of its instructions if so
+    bool m_compressed = false;
+    InstructionLayout m_layout;
+
+    /// Row of each instruction, indexed by the index of the instruction within m_layout
+    std::vector<uint32_t> m_instructionRows;
+    /// First row (the blank row) of each pair of rows labelling a symbol, in ascending order
+    std::vector<uint32_t> m_labelRows;
+    /// Widest row painted so far, bounding the horizontal scroll range
+    int m_maxRowWidth = 0;
+
+    /// Rows of the instructions in the pipeline, with the names of the stages holding them and their highlight colour
+    std::map<int, QStringList> m_highlightedRowsText;
+    std::map<int, QColor> m_highlightedRowsColor;
+
+    /// Selected rows, from anchor to cursor (inclusive); -1 if nothing is selected
+    int m_selectionAnchor = -1;
+    int m_selectionCursor = -1;
+
+    /**
+     * @brief m_maxProfileCost
+     * Largest cost of any instruction in the profile of the processor handler, relative to which instructions are
+     * heat coloured in the breakpoint area. Updated alongside the highlighted addresses.
      */
-    AddrOffsetMap m_labelAddrOffsetMap;
-    std::map<QTextBlock, QStringList> m_highlightedBlocksText;
+    long long m_maxProfileCost = 0;
+    /// Generation of the access patterns of the processor handler with which memory instructions were last annotated
+    unsigned long long m_accessPatternsGeneration = 0;
 };
 
 class BreakpointArea : public QWidget {
@@ -0,0 +1,134 @@
+#include "radix.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Ripes {
+
+namespace {
+
+/// Hexadecimal and binary digits of each byte value, most significant digit first
+struct DigitTables {
+    std::array<std::array<QChar, 2>, 256> hex;
+    std::array<std::array<QChar, 8>, 256> binary;
+
+    DigitTables() {
+        const char* digits = "0123456789abcdef";
+        for (unsigned byte = 0; byte < 256; byte++) {
+            hex[byte] = {QChar::fromLatin1(digits[byte >> 4]), QChar::fromLatin1(digits[byte & 0xF])};
+            for (unsigned bit = 0; bit < 8; bit++) {
+                binary[byte][7 - bit] = QChar::fromLatin1((byte >> bit) & 1 ? '1' : '0');
+            }
+        }
+    }
+};
+
+const DigitTables& digitTables() {
+    static const DigitTables tables;
+    return tables;
+}
+
+/// @returns the number of significant digits of @p value in a radix of 2^@p bitsPerDigit, being at least 1
+unsigned significantDigits(unsigned long value, unsigned bitsPerDigit) {
+    unsigned digits = 1;
+    while ((value >>= bitsPerDigit) != 0) {
+        digits++;
+    }
+    return digits;
+}
+
+/**
+ * @brief encodeDigits
+ * Formats @p value as @p prefix followed by its hex or binary digits, zero-padded to @p minDigits digits. The digits of
+ * each byte are copied from the lookup table @p table, from the least significant byte and onwards.
+ */
+template <size_t DigitsPerByte>
+QString encodeDigits(unsigned long value, const std::array<std::array<QChar, DigitsPerByte>, 256>& table,
+                     const char* prefix, unsigned minDigits) {
+    const unsigned digits = std::max(minDigits, significantDigits(value, 8 / DigitsPerByte));
+    QString str(2 + static_cast<int>(digits), Qt::Uninitialized);
+    QChar* out = str.data();
+    out[0] = QChar::fromLatin1(prefix[0]);
+    out[1] = QChar::fromLatin1(prefix[1]);
+    QChar* end = out + str.size();
+    for (unsigned remaining = digits; remaining > 0;) {
+        const auto& byteDigits = table[value & 0xFF];
+        const unsigned count = std::min<unsigned>(remaining, DigitsPerByte);
+        std::copy(byteDigits.end() - count, byteDigits.end(), end - count);
+        end -= count;
+        remaining -= count;
+        value = count == DigitsPerByte ? value >> 8 : 0;
+    }
+    return str;
+}
+
+QString encodeDecimal(unsigned long value, bool negative) {
+    // Digits are written from the end of the buffer
+    std::array<QChar, 21> buffer;
+    int first = static_cast<int>(buffer.size());
+    do {
+        buffer[--first] = QChar::fromLatin1('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    if (negative) {
+        buffer[--first] = QChar::fromLatin1('-');
+    }
+    return QString(buffer.data() + first, static_cast<int>(buffer.size()) - first);
+}
+
+QString formatRadixValue(unsigned long value, const Radix type, unsigned width) {
+    switch (type) {
+        case Radix::Hex: {
+            return encodeDigits(value, digitTables().hex, "0x", width / 4);
+        }
+        case Radix::Binary: {
+            return encodeDigits(value, digitTables().binary, "0b", width);
+        }
+        case Radix::Unsigned: {
+            return encodeDecimal(value, false);
+        }
+        case Radix::Signed: {
+            const int64_t signedValue = static_cast<int32_t>(value);
+            return encodeDecimal(static_cast<unsigned long>(signedValue < 0 ? -signedValue : signedValue),
+                                 signedValue < 0);
+        }
+        case Radix::ASCII: {
+            QString str;
+            for (unsigned i = 0; i < width / 8; i++) {
+                str.prepend(QChar::fromLatin1(value & 0xFF));
+                value >>= 8;
+            }
+            return str;
+        }
+    }
+    Q_UNREACHABLE();
+}
+
+/// Most recently formatted values of a radix, most recent first. Cached strings are shared with the callers.
+struct FormatCache {
+    static constexpr unsigned s_entries = 8;
+    struct Entry {
+        unsigned long value = 0;
+        unsigned width = 0;
+        QString text;
+    };
+    std::array<Entry, s_entries> entries;
+};
+
+}  // namespace
+
+QString encodeRadixValue(unsigned long value, const Radix type, unsigned width) {
+    thread_local std::array<FormatCache, static_cast<size_t>(Radix::ASCII) + 1> caches;
+    auto& entries = caches[static_cast<size_t>(type)].entries;
+    for (auto it = entries.begin(); it != entries.end() && !it->text.isNull(); ++it) {
+        if (it->value == value && it->width == width) {
+            std::rotate(entries.begin(), it, std::next(it));
+            return entries.front().text;
+        }
+    }
+    std::rotate(entries.begin(), std::prev(entries.end()), entries.end());
+    entries.front() = {value, width, formatRadixValue(value, type, width)};
+    return entries.front().text;
+}
+
+}  // namespace Ripes
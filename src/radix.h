@@ -20,31 +20,14 @@ static const auto binRegex = QRegExp("0[bB][0-1]+");
 static const auto unsignedRegex = QRegExp("[0-9]+");
 static const auto signedRegex = QRegExp("[-]*[0-9]+");
 
-static QString encodeRadixValue(unsigned long value, const Radix type, unsigned width = 32) {
-    switch (type) {
-        case Radix::Hex: {
-            return "0x" + QString::number(value, 16).rightJustified(width / 4, '0');
-        }
-        case Radix::Binary: {
-            return "0b" + QString::number(value, 2).rightJustified(width, '0');
-        }
-        case Radix::Unsigned: {
-            return QString::number(value, 10);
-        }
-        case Radix::Signed: {
-            return QString::number(static_cast<int32_t>(value), 10);
-        }
-        case Radix::ASCII: {
-            QString str;
-            for (unsigned i = 0; i < width / 8; i++) {
-                str.prepend(QChar::fromLatin1(value & 0xFF));
-                value >>= 8;
-            }
-            return str;
-        }
-    }
-    Q_UNREACHABLE();
-}
+/**
+ * @brief encodeRadixValue
+ * Formats @p value in radix @p type. Hex and binary values are zero-padded to @p width bits, and ASCII values consist
+ * of width / 8 characters. Hex and binary digits are written from lookup tables into a preallocated string, and the
+ * most recently formatted values of each radix are cached per thread, such that views formatting many cells are not
+ * bound by the formatting.
+ */
+QString encodeRadixValue(unsigned long value, const Radix type, unsigned width = 32);
 
 static uint32_t decodeRadixValue(QString value, const Radix type, bool* ok = nullptr) {
     switch (type) {
@@ -2,20 +2,17 @@
 
 #include <QHeaderView>
 
+#include "hostprofiler.h"
 #include "processorhandler.h"
 
 namespace Ripes {
 
 using namespace vsrtl;
 
-RegisterModel::RegisterModel(QObject* parent) : QAbstractTableModel(parent) {}
-
-std::vector<uint32_t> RegisterModel::gatherRegisterValues() {
-    std::vector<uint32_t> vals;
-    for (int i = 0; i < rowCount(); i++) {
-        vals.push_back(ProcessorHandler::get()->getRegisterValue(i));
-    }
-    return vals;
+RegisterModel::RegisterModel(QObject* parent) : QAbstractTableModel(parent) {
+    ProcessorHandler::get()->getRegisterValues(m_regValues);
+    m_changedRegs.assign(m_regValues.size(), false);
+    connect(ProcessorHandler::get(), &ProcessorHandler::liveStateChanged, this, &RegisterModel::liveStateChanged);
 }
 
 int RegisterModel::columnCount(const QModelIndex&) const {
@@ -27,20 +24,44 @@ int RegisterModel::rowCount(const QModelIndex&) const {
 }
 
 void RegisterModel::processorWasClocked() {
-    // Reload model
-    beginResetModel();
-    endResetModel();
-    const auto newRegValues = gatherRegisterValues();
-    if (m_regValues.size() != 0) {
-        for (unsigned i = 0; i < newRegValues.size(); i++) {
-            if (m_regValues[i] != newRegValues[i]) {
-                m_mostRecentlyModifiedReg = i;
-                emit registerChanged(i);
-                break;
-            }
+    RIPES_PROFILE_SCOPE("RegisterModel::processorWasClocked");
+    ProcessorHandler::get()->getRegisterValues(m_newRegValues);
+    updateValues(true);
+}
+
+void RegisterModel::liveStateChanged() {
+    if (const auto frame = ProcessorHandler::get()->liveState()) {
+        // The view is not scrolled to changed registers, which would prevent browsing the registers whilst running
+        m_newRegValues = frame->registers;
+        updateValues(false);
+    }
+}
+
+void RegisterModel::updateValues(bool follow) {
+    if (m_newRegValues.size() != m_regValues.size()) {
+        // The register file of the processor changed; nothing can be compared against the previous values
+        beginResetModel();
+        m_regValues.swap(m_newRegValues);
+        m_changedRegs.assign(m_regValues.size(), false);
+        endResetModel();
+        return;
+    }
+
+    // Only rows which change value, or which are no longer highlighted, are updated
+    bool scrolled = false;
+    for (unsigned i = 0; i < m_newRegValues.size(); i++) {
+        const bool changed = m_regValues[i] != m_newRegValues[i];
+        if (!changed && !m_changedRegs[i]) {
+            continue;
+        }
+        m_regValues[i] = m_newRegValues[i];
+        m_changedRegs[i] = changed;
+        emit dataChanged(index(i, 0), index(i, NColumns - 1));
+        if (follow && changed && !scrolled) {
+            scrolled = true;
+            emit registerChanged(i);
         }
     }
-    m_regValues = newRegValues;
 }
 
 bool RegisterModel::setData(const QModelIndex& index, const QVariant& value, int) {
@@ -50,6 +71,9 @@ bool RegisterModel::setData(const QModelIndex& index, const QVariant& value, int
         uint32_t v = decodeRadixValue(value.toString(), m_radix, &ok);
         if (ok) {
             ProcessorHandler::get()->setRegisterValue(i, v);
+            if (static_cast<unsigned>(i) < m_regValues.size()) {
+                m_regValues[i] = v;
+            }
             emit dataChanged(index, index);
             return true;
         }
@@ -81,7 +105,7 @@ QVariant RegisterModel::data(const QModelIndex& index, int role) const {
     const unsigned idx = index.row();
     if (role == Qt::ToolTipRole) {
         return tooltipData(idx);
-    } else if (role == Qt::BackgroundRole && index.row() == m_mostRecentlyModifiedReg) {
+    } else if (role == Qt::BackgroundRole && idx < m_changedRegs.size() && m_changedRegs[idx]) {
         return QBrush(QColor("#FDB515"));
     }
 
@@ -118,7 +142,9 @@ QVariant RegisterModel::data(const QModelIndex& index, int role) const {
 
 void RegisterModel::setRadix(Ripes::Radix r) {
     m_radix = r;
-    processorWasClocked();
+    if (rowCount() > 0) {
+        emit dataChanged(index(0, Column::Value), index(rowCount() - 1, Column::Value));
+    }
 }
 
 QVariant RegisterModel::nameData(unsigned idx) const {
@@ -134,13 +160,14 @@ QVariant RegisterModel::tooltipData(unsigned idx) const {
 }
 
 QVariant RegisterModel::valueData(unsigned idx) const {
-    return encodeRadixValue(ProcessorHandler::get()->getRegisterValue(idx), m_radix);
+    return idx < m_regValues.size() ? encodeRadixValue(m_regValues[idx], m_radix) : QVariant();
 }
 
 Qt::ItemFlags RegisterModel::flags(const QModelIndex& index) const {
     const auto def =
         ProcessorHandler::get()->currentISA()->regIsReadOnly(index.row()) ? Qt::NoItemFlags : Qt::ItemIsEnabled;
-    if (index.column() == Column::Value)
+    // Registers are browsed, but not edited, whilst running
+    if (index.column() == Column::Value && !ProcessorHandler::get()->isRunning())
         return Qt::ItemIsEditable | def;
     return def;
 }
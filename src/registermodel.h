@@ -31,6 +31,8 @@ public:
 
 public slots:
     void processorWasClocked();
+    /// Presents the registers of the live state published whilst running
+    void liveStateChanged();
 
 signals:
     /**
@@ -40,8 +42,8 @@ signals:
     void registerChanged(unsigned i) const;
 
 private:
-    std::vector<uint32_t> gatherRegisterValues();
-
+    /// Presents m_newRegValues, highlighting the registers which changed. Emits registerChanged if @p follow is set.
+    void updateValues(bool follow);
     QVariant nameData(unsigned idx) const;
     QVariant aliasData(unsigned idx) const;
     QVariant valueData(unsigned idx) const;
@@ -49,7 +51,10 @@ private:
 
     Radix m_radix = Radix::Hex;
 
-    int m_mostRecentlyModifiedReg = -1;
+    /// Register values as of the most recent update, which the model presents
     std::vector<uint32_t> m_regValues;
+    /// Registers whose value changed in the most recent update, which are highlighted
+    std::vector<bool> m_changedRegs;
+    std::vector<uint32_t> m_newRegValues;
 };
 }  // namespace Ripes
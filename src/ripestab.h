@@ -1,16 +1,51 @@
 #pragma once
 
+#include <QShowEvent>
 #include <QToolBar>
 #include <QWidget>
 
 namespace Ripes {
 
+/**
+ * @brief The RipesTab class
+ * Base of the tabs of the main window. Only one tab is visible at a time, and the views of a tab are only updated while
+ * it is visible; updates of a hidden tab are deferred until the tab is next shown (see deferViewUpdate).
+ */
 class RipesTab : public QWidget {
 public:
     RipesTab(QToolBar* toolbar, QWidget* parent = nullptr) : QWidget(parent), m_toolbar(toolbar) {}
     QToolBar* getToolbar() { return m_toolbar; }
 
 protected:
+    /**
+     * @brief deferViewUpdate
+     * To be called before updating the views of the tab following a clock of the processor in cycle @p cycle. If the
+     * tab is hidden, it is marked as dirty since that cycle and true is returned, in which case the views shall not be
+     * updated; they are instead refreshed once, through refreshViews, when the tab is next shown.
+     */
+    bool deferViewUpdate(long long cycle) {
+        if (isVisible()) {
+            return false;
+        }
+        if (m_dirtySinceCycle < 0) {
+            m_dirtySinceCycle = cycle;
+        }
+        return true;
+    }
+
+    /// Refreshes the views of the tab, following updates which were deferred while the tab was hidden
+    virtual void refreshViews() {}
+
+    void showEvent(QShowEvent* event) override {
+        QWidget::showEvent(event);
+        if (m_dirtySinceCycle >= 0) {
+            m_dirtySinceCycle = -1;
+            refreshViews();
+        }
+    }
+
     QToolBar* m_toolbar = nullptr;
+    /// Cycle of the first view update deferred since the tab was last refreshed, or -1 if its views are up to date
+    long long m_dirtySinceCycle = -1;
 };
 }  // namespace Ripes
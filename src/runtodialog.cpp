@@ -0,0 +1,55 @@
+#include "runtodialog.h"
+#include "ui_runtodialog.h"
+
+#include <QPushButton>
+
+namespace Ripes {
+
+namespace {
+enum Mode { RunFor, UntilCycle, UntilInstructionsRetired, UntilPC };
+}
+
+RunToDialog::RunToDialog(QWidget* parent) : QDialog(parent), m_ui(new Ui::RunToDialog) {
+    m_ui->setupUi(this);
+    setWindowTitle("Ripes");
+
+    m_ui->condition->addItem("Run for a number of cycles", RunFor);
+    m_ui->condition->addItem("Run until cycle", UntilCycle);
+    m_ui->condition->addItem("Run until instructions retired", UntilInstructionsRetired);
+    m_ui->condition->addItem("Run until PC", UntilPC);
+    m_ui->value->setText("1000000");
+
+    connect(m_ui->condition, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RunToDialog::validateValue);
+    connect(m_ui->value, &QLineEdit::textChanged, this, &RunToDialog::validateValue);
+    validateValue();
+}
+
+RunToDialog::~RunToDialog() {
+    delete m_ui;
+}
+
+void RunToDialog::validateValue() {
+    const auto mode = static_cast<Mode>(m_ui->condition->currentData().toInt());
+    m_relative = mode == RunFor;
+    switch (mode) {
+        case RunFor:
+        case UntilCycle:
+            m_condition = ProcessorHandler::RunCondition::Cycle;
+            break;
+        case UntilInstructionsRetired:
+            m_condition = ProcessorHandler::RunCondition::InstructionsRetired;
+            break;
+        case UntilPC:
+            m_condition = ProcessorHandler::RunCondition::PC;
+            break;
+    }
+
+    // Values are accepted in both decimal and hexadecimal (0x-prefixed) notation
+    bool ok;
+    const unsigned long long value = m_ui->value->text().toULongLong(&ok, 0);
+    if (ok) {
+        m_value = value;
+    }
+    m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(ok);
+}
+}  // namespace Ripes
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QDialog>
+
+#include "processorhandler.h"
+
+namespace Ripes {
+
+namespace Ui {
+class RunToDialog;
+}
+
+/**
+ * @brief The RunToDialog class
+ * Queries the user for the condition upon which a run of the processor should stop; either after running for a number
+ * of cycles, upon reaching a cycle or number of retired instructions, or upon reaching a PC.
+ */
+class RunToDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit RunToDialog(QWidget* parent = nullptr);
+    ~RunToDialog() override;
+
+    ProcessorHandler::RunCondition getCondition() const { return m_condition; }
+    unsigned long long getValue() const { return m_value; }
+
+    /**
+     * @brief isRelative
+     * @returns true if getValue() is a number of cycles relative to the current cycle count.
+     */
+    bool isRelative() const { return m_relative; }
+
+private:
+    void validateValue();
+
+    Ui::RunToDialog* m_ui = nullptr;
+    ProcessorHandler::RunCondition m_condition = ProcessorHandler::RunCondition::Cycle;
+    unsigned long long m_value = 0;
+    bool m_relative = true;
+};
+}  // namespace Ripes
@@ -2,6 +2,7 @@
 #include "ui_savedialog.h"
 
 #include <QCheckBox>
+#include <QComboBox>
 #include <QFileDialog>
 
 namespace Ripes {
@@ -9,6 +10,9 @@ namespace Ripes {
 QString SaveDialog::m_path = QString();
 bool SaveDialog::m_saveAssembly = true;
 bool SaveDialog::m_saveBinary = false;
+bool SaveDialog::m_saveMemory = false;
+MemoryDump::Format SaveDialog::m_memoryFormat = MemoryDump::Format::Binary;
+std::optional<MemoryDump::Range> SaveDialog::m_memoryRange;
 
 SaveDialog::SaveDialog(QWidget* parent) : QDialog(parent), m_ui(new Ui::SaveDialog) {
     m_ui->setupUi(this);
@@ -19,9 +23,23 @@ SaveDialog::SaveDialog(QWidget* parent) : QDialog(parent), m_ui(new Ui::SaveDial
     connect(m_ui->filePath, &QLineEdit::textChanged, this, &SaveDialog::pathChanged);
     connect(m_ui->saveBinary, &QCheckBox::toggled, this, &SaveDialog::pathChanged);
     connect(m_ui->saveAssembly, &QCheckBox::toggled, this, &SaveDialog::pathChanged);
+    connect(m_ui->saveMemory, &QCheckBox::toggled, this, &SaveDialog::pathChanged);
+    connect(m_ui->memoryFormat, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SaveDialog::pathChanged);
+    connect(m_ui->memoryRange, &QLineEdit::textChanged, this, &SaveDialog::pathChanged);
+
+    m_ui->memoryFormat->addItem("Raw binary", static_cast<int>(MemoryDump::Format::Binary));
+    m_ui->memoryFormat->addItem("Intel HEX", static_cast<int>(MemoryDump::Format::IntelHex));
+    m_ui->memoryFormat->addItem("Verilog $readmemh", static_cast<int>(MemoryDump::Format::Verilog));
+    m_ui->memoryFormat->setCurrentIndex(m_ui->memoryFormat->findData(static_cast<int>(m_memoryFormat)));
+    m_ui->memoryRange->setToolTip("Inclusive range of hex addresses to save, as <first>-<last>");
+    if (m_memoryRange) {
+        m_ui->memoryRange->setText("0x" + QString::number(m_memoryRange->first, 16) + "-0x" +
+                                   QString::number(m_memoryRange->last, 16));
+    }
 
     m_ui->saveAssembly->setChecked(m_saveAssembly);
     m_ui->saveBinary->setChecked(m_saveBinary);
+    m_ui->saveMemory->setChecked(m_saveMemory);
     m_ui->filePath->setText(m_path);
     pathChanged();
 }
@@ -29,6 +47,9 @@ SaveDialog::SaveDialog(QWidget* parent) : QDialog(parent), m_ui(new Ui::SaveDial
 void SaveDialog::accept() {
     m_saveAssembly = m_ui->saveAssembly->isChecked();
     m_saveBinary = m_ui->saveBinary->isChecked();
+    m_saveMemory = m_ui->saveMemory->isChecked();
+    m_memoryFormat = static_cast<MemoryDump::Format>(m_ui->memoryFormat->currentData().toInt());
+    readMemoryRange(m_memoryRange);
     m_path = m_ui->filePath->text();
 
     QDialog::accept();
@@ -36,7 +57,14 @@ void SaveDialog::accept() {
 
 void SaveDialog::pathChanged() {
     bool okEnabled = !m_ui->filePath->text().isEmpty();
-    okEnabled &= m_ui->saveAssembly->isChecked() | m_ui->saveBinary->isChecked();
+    okEnabled &= m_ui->saveAssembly->isChecked() | m_ui->saveBinary->isChecked() | m_ui->saveMemory->isChecked();
+
+    std::optional<MemoryDump::Range> range;
+    const bool rangeValid = readMemoryRange(range);
+    okEnabled &= !m_ui->saveMemory->isChecked() || rangeValid;
+    m_ui->memoryFormat->setEnabled(m_ui->saveMemory->isChecked());
+    m_ui->memoryRange->setEnabled(m_ui->saveMemory->isChecked());
+    m_ui->memoryRange->setStyleSheet(rangeValid ? QString() : "QLineEdit { color: red; }");
 
     m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(okEnabled);
 
@@ -46,10 +74,28 @@ void SaveDialog::pathChanged() {
         filesToSave << m_ui->filePath->text() + ".s";
     if (m_ui->saveBinary->isChecked() && !path.isEmpty())
         filesToSave << m_ui->filePath->text() + ".bin";
+    if (m_ui->saveMemory->isChecked() && !path.isEmpty()) {
+        const auto format = static_cast<MemoryDump::Format>(m_ui->memoryFormat->currentData().toInt());
+        filesToSave << m_ui->filePath->text() + MemoryDump::suffix(format);
+    }
 
     m_ui->filesToSave->setText(filesToSave.join("<br/>"));
 }
 
+bool SaveDialog::readMemoryRange(std::optional<MemoryDump::Range>& range) const {
+    const QString text = m_ui->memoryRange->text().trimmed();
+    if (text.isEmpty()) {
+        range.reset();
+        return true;
+    }
+    MemoryDump::Range parsed;
+    if (!MemoryDump::parseRange(text, parsed)) {
+        return false;
+    }
+    range = parsed;
+    return true;
+}
+
 void SaveDialog::openFileButtonTriggered() {
     QFileDialog dialog(this);
     dialog.setAcceptMode(QFileDialog::AcceptSave);
@@ -2,6 +2,10 @@
 
 #include <QDialog>
 
+#include <optional>
+
+#include "memorydump.h"
+
 namespace Ripes {
 
 namespace Ui {
@@ -18,18 +22,27 @@ public:
     static const QString& getPath() { return m_path; }
     static QString assemblyPath() { return m_saveAssembly ? m_path + ".s" : QString(); }
     static QString binaryPath() { return m_saveBinary ? m_path + ".bin" : QString(); }
+    static QString memoryPath() { return m_saveMemory ? m_path + MemoryDump::suffix(m_memoryFormat) : QString(); }
+    static MemoryDump::Format memoryFormat() { return m_memoryFormat; }
+    /// Range of the memory image, or nothing if all populated pages of memory are to be saved
+    static const std::optional<MemoryDump::Range>& memoryRange() { return m_memoryRange; }
 
     void accept() override;
 
 private:
     void openFileButtonTriggered();
     void pathChanged();
+    /// @returns false if the memory range is invalid; an empty range yields no range
+    bool readMemoryRange(std::optional<MemoryDump::Range>& range) const;
 
     Ui::SaveDialog* m_ui = nullptr;
 
     static QString m_path;
     static bool m_saveAssembly;
     static bool m_saveBinary;
+    static bool m_saveMemory;
+    static MemoryDump::Format m_memoryFormat;
+    static std::optional<MemoryDump::Range> m_memoryRange;
 };
 
 }  // namespace Ripes
@@ -0,0 +1,251 @@
+#include "simulationserver.h"
+
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include "batchrunner.h"
+#include "processorhandler.h"
+#include "programloader.h"
+
+namespace Ripes {
+
+namespace {
+// Error codes of JSON-RPC 2.0, and the code of requests which failed to execute
+constexpr int s_parseError = -32700;
+constexpr int s_invalidRequest = -32600;
+constexpr int s_methodNotFound = -32601;
+constexpr int s_invalidParams = -32602;
+constexpr int s_executionError = -32000;
+}  // namespace
+
+SimulationServer::SimulationServer(const HeadlessOptions& defaults, int threads, QObject* parent)
+    : QObject(parent), m_defaults(defaults) {
+    // Worker threads never expire, such that their simulation contexts are kept warm
+    m_pool.setExpiryTimeout(-1);
+    m_pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+    connect(&m_server, &QLocalServer::newConnection, this, &SimulationServer::newConnection);
+}
+
+SimulationServer::~SimulationServer() {
+    m_stopping = true;
+    m_server.close();
+    // Connections are closed as the server is destroyed, after the state which they refer to
+    for (const auto& it : m_connections) {
+        it.first->disconnect(this);
+    }
+    m_pool.waitForDone();
+}
+
+bool SimulationServer::listen(const QString& name, QString& error) {
+    // A socket left behind by a server which did not shut down cleanly would otherwise prevent listening
+    QLocalServer::removeServer(name);
+    if (!m_server.listen(name)) {
+        error = "Could not listen on " + name + ": " + m_server.errorString();
+        return false;
+    }
+    return true;
+}
+
+ProcessorHandler& SimulationServer::workerContext() {
+    if (!m_contexts.hasLocalData()) {
+        m_contexts.setLocalData(new ProcessorHandler);
+    }
+    return *m_contexts.localData();
+}
+
+void SimulationServer::newConnection() {
+    while (auto* socket = m_server.nextPendingConnection()) {
+        m_connections[socket].options = m_defaults;
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket] {
+            while (socket->canReadLine()) {
+                const QByteArray line = socket->readLine().trimmed();
+                if (!line.isEmpty()) {
+                    handleRequest(socket, line);
+                }
+            }
+        });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket] {
+            m_connections.at(socket).closed->store(true);
+            m_connections.erase(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void SimulationServer::handleRequest(QLocalSocket* socket, const QByteArray& line) {
+    QJsonParseError parseError;
+    const auto doc = QJsonDocument::fromJson(line, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        respondError(socket, QJsonValue::Null, s_parseError, parseError.errorString());
+        return;
+    }
+    const QJsonObject request = doc.object();
+    const QJsonValue id = request.value("id");
+    const QString method = request.value("method").toString();
+    if (!doc.isObject() || request.value("jsonrpc").toString() != "2.0" || method.isEmpty()) {
+        respondError(socket, id.isUndefined() ? QJsonValue::Null : id, s_invalidRequest, "Invalid request");
+        return;
+    }
+    const QJsonValue params = request.value("params");
+    if (!params.isUndefined() && !params.isObject()) {
+        respondError(socket, id, s_invalidParams, "Parameters must be given as an object");
+        return;
+    }
+
+    if (method == "load") {
+        load(socket, id, params.toObject());
+    } else if (method == "unload") {
+        if (m_programs.erase(params.toObject().value("program").toVariant().toLongLong()) == 0) {
+            respondError(socket, id, s_invalidParams, "Unknown program");
+            return;
+        }
+        respond(socket, id, true);
+    } else if (method == "configure") {
+        // Options are only applied once all of them are valid
+        HeadlessOptions options = m_connections.at(socket).options;
+        QString error;
+        if (!parseJobOptions(params.toObject(), QDir::current(), options, error)) {
+            respondError(socket, id, s_invalidParams, error);
+            return;
+        }
+        const QJsonValue proc = params.toObject().value("proc");
+        if (!proc.isUndefined() && !parseProcessorID(proc.toString(), options.processor)) {
+            respondError(socket, id, s_invalidParams, "Unknown processor '" + proc.toString() + "'");
+            return;
+        }
+        m_connections.at(socket).options = options;
+        respond(socket, id, true);
+    } else if (method == "run") {
+        run(socket, id, params.toObject());
+    } else {
+        respondError(socket, id, s_methodNotFound, "Unknown method '" + method + "'");
+    }
+}
+
+void SimulationServer::load(QLocalSocket* socket, const QJsonValue& id, const QJsonObject& params) {
+    HeadlessOptions options;
+    QString error;
+    if (params.contains("source")) {
+        options.type = FileType::Assembly;
+    } else if (!params.value("file").isString()) {
+        respondError(socket, id, s_invalidParams, "Either a 'source' or a 'file' must be given");
+        return;
+    } else {
+        options.filepath = QDir::cleanPath(QDir::current().absoluteFilePath(params.value("file").toString()));
+        if (!parseFileType(params.value("type").toString(), options.filepath, options.type)) {
+            respondError(socket, id, s_invalidParams, "Unknown file type '" + params.value("type").toString() + "'");
+            return;
+        }
+        if (!parseJobOptions(params, QDir::current(), options, error)) {
+            respondError(socket, id, s_invalidParams, error);
+            return;
+        }
+    }
+
+    // Programs are assembled or loaded by the workers
+    const QString source = params.value("source").toString();
+    QtConcurrent::run(&m_pool, [this, socket = QPointer<QLocalSocket>(socket), id, options, source] {
+        auto program = std::make_shared<Program>();
+        const bool loaded = options.filepath.isEmpty() ? assembleSource(*program, source)
+                                                       : loadProgram(options, *program);
+        QMetaObject::invokeMethod(
+            this,
+            [this, socket, id, options, program, loaded] {
+                if (!socket) {
+                    return;
+                }
+                if (!loaded) {
+                    respondError(socket, id, s_executionError,
+                                 options.filepath.isEmpty() ? "Could not assemble the source"
+                                                            : "Could not load file " + options.filepath);
+                    return;
+                }
+                if (!program->getSection(TEXT_SECTION_NAME)) {
+                    respondError(socket, id, s_executionError,
+                                 QString("Program does not contain a %1 section").arg(TEXT_SECTION_NAME));
+                    return;
+                }
+                const qint64 programId = m_nextProgramId++;
+                m_programs[programId] = program;
+                respond(socket, id, QJsonObject({{"program", programId}}));
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void SimulationServer::run(QLocalSocket* socket, const QJsonValue& id, const QJsonObject& params) {
+    const auto program = m_programs.find(params.value("program").toVariant().toLongLong());
+    if (program == m_programs.end()) {
+        respondError(socket, id, s_invalidParams, "Unknown program");
+        return;
+    }
+
+    const Connection& connection = m_connections.at(socket);
+    HeadlessOptions options = connection.options;
+    QString error;
+    if (!parseJobOptions(params, QDir::current(), options, error)) {
+        respondError(socket, id, s_invalidParams, error);
+        return;
+    }
+    const QJsonValue proc = params.value("proc");
+    if (!proc.isUndefined() && !parseProcessorID(proc.toString(), options.processor)) {
+        respondError(socket, id, s_invalidParams, "Unknown processor '" + proc.toString() + "'");
+        return;
+    }
+    options.program = program->second;
+
+    QtConcurrent::run(&m_pool, [this, socket = QPointer<QLocalSocket>(socket), id, options, programId = program->first,
+                                closed = connection.closed] {
+        const auto progress = [this, &closed](const HeadlessResult&) {
+            return !closed->load(std::memory_order_relaxed) && !m_stopping.load(std::memory_order_relaxed);
+        };
+        const HeadlessResult result = simulate(workerContext(), options, {}, progress);
+
+        QJsonObject report = jobReport(options, result);
+        report.remove("file");
+        report["program"] = programId;
+        QJsonArray registers;
+        for (const uint32_t value : result.registers) {
+            registers.append(static_cast<qint64>(value));
+        }
+        report["registers"] = registers;
+        QMetaObject::invokeMethod(
+            this,
+            [this, socket, id, report, error = result.error] {
+                if (!socket) {
+                    return;
+                }
+                if (!error.isEmpty()) {
+                    respondError(socket, id, s_executionError, error);
+                } else {
+                    respond(socket, id, report);
+                }
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void SimulationServer::respond(QLocalSocket* socket, const QJsonValue& id, const QJsonValue& result) {
+    // Requests without an id are notifications, which are not answered
+    if (id.isUndefined()) {
+        return;
+    }
+    const QJsonObject response({{"jsonrpc", "2.0"}, {"id", id}, {"result", result}});
+    socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void SimulationServer::respondError(QLocalSocket* socket, const QJsonValue& id, int code, const QString& message) {
+    if (id.isUndefined()) {
+        return;
+    }
+    const QJsonObject response(
+        {{"jsonrpc", "2.0"}, {"id", id}, {"error", QJsonObject({{"code", code}, {"message", message}})}});
+    socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n');
+}
+
+}  // namespace Ripes
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QThreadPool>
+#include <QThreadStorage>
+
+#include <atomic>
+#include <map>
+#include <memory>
+
+#include "headless.h"
+
+class QLocalSocket;
+
+namespace Ripes {
+
+class ProcessorHandler;
+
+/**
+ * @brief The SimulationServer class
+ * Long-lived simulation server, accepting JSON-RPC 2.0 requests over a local socket. Each line received on a connection
+ * is a request object, and each request is answered by a response object on a line of its own, in the order in which
+ * the requests complete. The following methods are served:
+ *  - "load": loads a program, given either as assembly source text {"source"} or as a file {"file", "type", "entry",
+ *    "load-at"}, and keeps it loaded until unloaded. Returns {"program": <id>}.
+ *  - "unload": unloads the program {"program": <id>}.
+ *  - "configure": sets the options of the subsequent runs of the connection, given as the keys of a batch job
+ *    (see parseJobOptions) and "proc".
+ *  - "run": simulates the program {"program": <id>}, with the options of the connection overridden by any other keys of
+ *    the request. Returns the batch report entry of the run (see jobReport), and the values of the registers once the
+ *    simulation stopped as {"registers"}.
+ * Requests are executed on a pool of worker threads. Each worker keeps a simulation context of its own for as long as
+ * the server runs, such that the processors which it has constructed are kept warm across runs. Runs of a connection
+ * are stopped once it is closed.
+ */
+class SimulationServer : public QObject {
+    Q_OBJECT
+
+public:
+    /// @p defaults are the initial run options of each connection; up to @p threads requests execute concurrently
+    SimulationServer(const HeadlessOptions& defaults, int threads, QObject* parent = nullptr);
+    ~SimulationServer() override;
+
+    /// Listens for connections on the local socket @p name. @returns false and sets @p error if listening failed.
+    bool listen(const QString& name, QString& error);
+    QString fullServerName() const { return m_server.fullServerName(); }
+
+private:
+    struct Connection {
+        HeadlessOptions options;
+        /// Set once the connection is closed, stopping its runs
+        std::shared_ptr<std::atomic<bool>> closed = std::make_shared<std::atomic<bool>>(false);
+    };
+
+    void newConnection();
+    void handleRequest(QLocalSocket* socket, const QByteArray& line);
+    void load(QLocalSocket* socket, const QJsonValue& id, const QJsonObject& params);
+    void run(QLocalSocket* socket, const QJsonValue& id, const QJsonObject& params);
+    void respond(QLocalSocket* socket, const QJsonValue& id, const QJsonValue& result);
+    void respondError(QLocalSocket* socket, const QJsonValue& id, int code, const QString& message);
+    /// @returns the simulation context of the calling worker thread, constructing it on first use
+    ProcessorHandler& workerContext();
+
+    QLocalServer m_server;
+    HeadlessOptions m_defaults;
+    std::map<QLocalSocket*, Connection> m_connections;
+    std::map<qint64, std::shared_ptr<const Program>> m_programs;
+    qint64 m_nextProgramId = 1;
+
+    /// Simulation contexts of the worker threads, destroyed as the threads of the pool exit
+    QThreadStorage<ProcessorHandler*> m_contexts;
+    QThreadPool m_pool;
+    std::atomic<bool> m_stopping = false;
+};
+
+}  // namespace Ripes
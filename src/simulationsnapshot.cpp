@@ -0,0 +1,146 @@
+#include "simulationsnapshot.h"
+
+#include <cstring>
+#include <map>
+
+namespace Ripes {
+
+namespace SimulationSnapshot {
+
+void writePages(const std::vector<Page>& pages, vsrtl::core::SparseArray& memory) {
+    for (const auto& page : pages) {
+        for (unsigned offset = 0; offset < s_pageSize; offset += 4) {
+            // Fully populated words are written at once
+            const uint8_t present = (page.present[offset / 8] >> (offset % 8)) & 0xF;
+            if (present == 0xF) {
+                uint32_t word = 0;
+                for (unsigned i = 0; i < 4; i++) {
+                    word |= static_cast<uint32_t>(page.data[offset + i]) << (i * 8);
+                }
+                memory.writeMem(page.address + offset, word, 4);
+                continue;
+            }
+            for (unsigned i = 0; i < 4; i++) {
+                if (present & (1 << i)) {
+                    memory.writeMem(page.address + offset + i, page.data[offset + i], 1);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace SimulationSnapshot
+
+void SnapshotWriter::putBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+void SnapshotWriter::putString(const QString& string) {
+    const QByteArray utf8 = string.toUtf8();
+    put(static_cast<uint32_t>(utf8.size()));
+    putBytes(utf8.constData(), static_cast<size_t>(utf8.size()));
+}
+
+void SnapshotWriter::putPages(const vsrtl::core::SparseArray& memory) {
+    using namespace SimulationSnapshot;
+    constexpr unsigned bitmapSize = s_pageSize / 8;
+
+    // Populated bytes are gathered into their page, in whatever order the address space stores them
+    std::map<uint32_t, std::vector<uint8_t>> pages;
+    for (const auto& entry : memory) {
+        const uint32_t address = static_cast<uint32_t>(entry.first);
+        auto& page = pages[address >> s_pageBits];
+        if (page.empty()) {
+            page.assign(bitmapSize + s_pageSize, 0);
+        }
+        const uint32_t offset = address & (s_pageSize - 1);
+        page[offset / 8] |= 1 << (offset % 8);
+        page[bitmapSize + offset] = static_cast<uint8_t>(entry.second);
+    }
+
+    put(static_cast<uint32_t>(pages.size()));
+    for (const auto& [index, page] : pages) {
+        put(index << s_pageBits);
+        putBytes(page.data(), page.size());
+    }
+}
+
+bool SnapshotWriter::write(const QString& path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    const char* header = SimulationSnapshot::s_magic;
+    const auto version = static_cast<char>(SimulationSnapshot::s_version);
+    return file.write(header, 8) == 8 && file.write(&version, 1) == 1 &&
+           file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<qint64>(m_buffer.size())) ==
+               static_cast<qint64>(m_buffer.size());
+}
+
+bool SnapshotReader::open(const QString& path, QString& error) {
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        error = "Could not open " + path;
+        return false;
+    }
+    m_size = static_cast<size_t>(m_file.size());
+    m_data = m_file.map(0, m_file.size());
+    if (!m_data) {
+        // Files which cannot be mapped (ie. bundled resources) are read into memory
+        m_contents = m_file.readAll();
+        m_data = reinterpret_cast<const uint8_t*>(m_contents.constData());
+        m_size = static_cast<size_t>(m_contents.size());
+    }
+    m_pos = 0;
+    m_ok = true;
+
+    const uint8_t* header = getBytes(9);
+    if (!header || std::memcmp(header, SimulationSnapshot::s_magic, 8) != 0) {
+        error = path + " is not a simulation snapshot";
+        return false;
+    }
+    if (header[8] != SimulationSnapshot::s_version) {
+        error = QString("Unsupported snapshot version %1").arg(header[8]);
+        return false;
+    }
+    return true;
+}
+
+const uint8_t* SnapshotReader::getBytes(size_t size) {
+    if (!m_ok || size > remaining()) {
+        m_ok = false;
+        return nullptr;
+    }
+    const uint8_t* bytes = m_data + m_pos;
+    m_pos += size;
+    return bytes;
+}
+
+QString SnapshotReader::getString() {
+    const uint32_t length = get<uint32_t>();
+    const uint8_t* bytes = getBytes(length);
+    return bytes ? QString::fromUtf8(reinterpret_cast<const char*>(bytes), static_cast<int>(length)) : QString();
+}
+
+void SnapshotReader::getPages(std::vector<SimulationSnapshot::Page>& pages) {
+    using namespace SimulationSnapshot;
+    constexpr size_t pageRecordSize = 4 + s_pageSize / 8 + s_pageSize;
+
+    const uint32_t count = get<uint32_t>();
+    if (count > remaining() / pageRecordSize) {
+        m_ok = false;
+        return;
+    }
+    pages.resize(count);
+    for (auto& page : pages) {
+        page.address = get<uint32_t>();
+        page.present = getBytes(s_pageSize / 8);
+        page.data = getBytes(s_pageSize);
+        if (page.address & (s_pageSize - 1)) {
+            m_ok = false;
+        }
+    }
+}
+
+}  // namespace Ripes
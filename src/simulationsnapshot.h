@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "VSRTL/core/vsrtl_memory.h"
+
+namespace Ripes {
+
+/**
+ * Simulation snapshot file format
+ * A snapshot holds the complete state of a simulation context at a given cycle (see ProcessorHandler::saveSnapshot).
+ * All integers are little endian and of fixed width. A snapshot starts with the 8-byte magic "RIPESSNP", a version
+ * byte, the processor ID (4 bytes) and a 64-bit fingerprint of the loaded program, followed by:
+ *  - The cycle, instructions retired and memory stall cycle counts of the processor, and the cycle and instructions
+ *    retired counts of the functional interpreter (8 bytes each).
+ *  - The branch prediction, functional unit and hazard statistics of the processor (8 bytes per counter).
+ *  - The values of all registers of the design and the additional processor state, each as a 4-byte count followed by
+ *    8 bytes per value (see ProcessorCheckpoint).
+ *  - The architectural registers and the memory, as pages (see below).
+ *  - A 4-byte cache count, followed by the name (string) and state of each cache (see CacheSim::writeSnapshot).
+ * Vectors are a 4-byte element count followed by the elements at their native width, and strings a 4-byte length
+ * followed by their UTF-8 characters. An address space is a 4-byte page count followed by each populated 4 KiB page, as
+ * its 4-byte address, a bitmap of the populated bytes of the page (bit i of byte i / 8 for the byte at offset i) and
+ * the 4096 bytes of the page. Pages are fixed size such that they may be read in place from a memory mapped file.
+ */
+namespace SimulationSnapshot {
+constexpr char s_magic[] = "RIPESSNP";
+constexpr uint8_t s_version = 1;
+constexpr unsigned s_pageBits = 12;
+constexpr unsigned s_pageSize = 1u << s_pageBits;
+
+/**
+ * @brief The Page struct
+ * A page of an address space within a snapshot which is being read. The bitmap and data reference the snapshot.
+ */
+struct Page {
+    uint32_t address = 0;
+    const uint8_t* present = nullptr;
+    const uint8_t* data = nullptr;
+};
+
+/// Writes the populated bytes of @p pages into @p memory
+void writePages(const std::vector<Page>& pages, vsrtl::core::SparseArray& memory);
+}  // namespace SimulationSnapshot
+
+/**
+ * @brief The SnapshotWriter class
+ * Encodes a snapshot into an in-memory buffer, which is written to a file once complete.
+ */
+class SnapshotWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_integral_v<T>, "Only integers are written to snapshots");
+        auto bits = static_cast<std::make_unsigned_t<T>>(value);
+        for (unsigned i = 0; i < sizeof(T); i++, bits >>= 8) {
+            m_buffer.push_back(static_cast<uint8_t>(bits & 0xFF));
+        }
+    }
+    template <typename T>
+    void putVector(const std::vector<T>& values) {
+        put(static_cast<uint32_t>(values.size()));
+        for (const auto& value : values) {
+            put(value);
+        }
+    }
+    void putBytes(const void* data, size_t size);
+    void putString(const QString& string);
+    /// Writes the populated bytes of @p memory as pages, in ascending order of address
+    void putPages(const vsrtl::core::SparseArray& memory);
+
+    /// Creates (or truncates) the file at @p path and writes the snapshot. @returns false if it could not be written.
+    bool write(const QString& path) const;
+
+private:
+    std::vector<uint8_t> m_buffer;
+};
+
+/**
+ * @brief The SnapshotReader class
+ * Decodes a snapshot file. The file is memory mapped if possible, and read into memory otherwise, such that pages are
+ * referenced in place rather than copied. Reads past the end of the snapshot yield zero and mark the reader as failed;
+ * callers check ok() once a section has been read.
+ */
+class SnapshotReader {
+public:
+    /**
+     * @brief open
+     * Opens the snapshot at @p path and checks its magic and version.
+     * @returns false, with a description of the error in @p error, if the file is not a snapshot of this version.
+     */
+    bool open(const QString& path, QString& error);
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_integral_v<T>, "Only integers are read from snapshots");
+        const uint8_t* bytes = getBytes(sizeof(T));
+        std::make_unsigned_t<T> bits = 0;
+        for (unsigned i = 0; bytes && i < sizeof(T); i++) {
+            bits |= static_cast<std::make_unsigned_t<T>>(bytes[i]) << (i * 8);
+        }
+        return static_cast<T>(bits);
+    }
+    template <typename T>
+    void getVector(std::vector<T>& values) {
+        const uint32_t count = get<uint32_t>();
+        if (count > remaining() / sizeof(T)) {
+            m_ok = false;
+            return;
+        }
+        values.resize(count);
+        for (auto& value : values) {
+            value = get<T>();
+        }
+    }
+    /// @returns a pointer to the next @p size bytes of the snapshot, or nullptr if the snapshot is truncated
+    const uint8_t* getBytes(size_t size);
+    QString getString();
+    void getPages(std::vector<SimulationSnapshot::Page>& pages);
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos == m_size; }
+
+private:
+    size_t remaining() const { return m_size - m_pos; }
+
+    QFile m_file;
+    // Contents of the snapshot if the file could not be mapped
+    QByteArray m_contents;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_pos = 0;
+    bool m_ok = true;
+};
+
+}  // namespace Ripes
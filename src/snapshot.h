@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Ripes {
+
+/**
+ * @brief The Snapshot class
+ * Lock-free (sequence locked) publication of a trivially copyable value from a single writer thread to any number of
+ * reader threads. The writer never waits; readers retry until they have read a value which was not concurrently
+ * modified, such that a read never observes a partially published value.
+ */
+template <typename T>
+class Snapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot values must be trivially copyable");
+
+public:
+    Snapshot() { publish(T()); }
+
+    /**
+     * @brief publish
+     * Publishes @param value. Must only be called from a single thread at a time.
+     */
+    void publish(const T& value) {
+        std::array<uint64_t, s_words> words = {};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const unsigned seq = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (unsigned i = 0; i < s_words; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief read
+     * @returns the most recently published value.
+     */
+    T read() const {
+        std::array<uint64_t, s_words> words;
+        unsigned seq;
+        do {
+            seq = m_sequence.load(std::memory_order_acquire);
+            for (unsigned i = 0; i < s_words; i++) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) || seq != m_sequence.load(std::memory_order_relaxed));
+
+        T value;
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr unsigned s_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    std::atomic<unsigned> m_sequence{0};
+    std::array<std::atomic<uint64_t>, s_words> m_words;
+};
+
+}  // namespace Ripes
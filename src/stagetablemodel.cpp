@@ -1,56 +1,311 @@
 #include "stagetablemodel.h"
+#include "hostprofiler.h"
 
 #include "parser.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace Ripes {
 
-static inline uint32_t indexToAddress(unsigned index) {
-    if (ProcessorHandler::get()->getProgram()) {
-        return (index * ProcessorHandler::get()->currentISA()->bytes()) +
-               ProcessorHandler::get()->getProgram()->getSection(TEXT_SECTION_NAME)->address;
+static inline uint32_t indexToAddress(const ProcessorHandler* context, unsigned index) {
+    if (context->getProgram()) {
+        return context->getInstructionLayout().offset(index) + context->getTextStart();
     }
     return 0;
 }
 
-StageTableModel::StageTableModel(QObject* parent) : QAbstractTableModel(parent) {}
+StageTableModel::StageTableModel(ProcessorHandler* context, QObject* parent)
+    : QAbstractTableModel(parent), m_context(context) {
+    clearHistory();
+}
 
 QVariant StageTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
     if (role != Qt::DisplayRole)
         return QVariant();
     if (orientation == Qt::Horizontal) {
         // Cycle number
-        return QString::number(section);
+        return QString::number(m_firstCycle + section);
+    } else if (m_rowMode == RowMode::Instances) {
+        if (section < 0 || section >= static_cast<int>(m_instances.size())) {
+            return QVariant();
+        }
+        return m_context->parseInstrAt(m_instances[section].pc);
     } else {
-        const auto addr = indexToAddress(section);
-        return ProcessorHandler::get()->parseInstrAt(addr);
+        const auto addr = indexToAddress(m_context, section);
+        return m_context->parseInstrAt(addr);
     }
 }
 
 int StageTableModel::rowCount(const QModelIndex&) const {
-    return ProcessorHandler::get()->getCurrentProgramSize() / ProcessorHandler::get()->currentISA()->bytes();
+    if (m_rowMode == RowMode::Instances) {
+        return static_cast<int>(m_instances.size());
+    }
+    return static_cast<int>(m_context->getInstructionLayout().count());
 }
 
 int StageTableModel::columnCount(const QModelIndex&) const {
-    return m_cycleStageInfos.size();
+    return m_columns;
 }
 
 void StageTableModel::processorWasClocked() {
+    RIPES_PROFILE_SCOPE("StageTableModel::processorWasClocked");
     gatherStageInfo();
 }
 
 void StageTableModel::reset() {
     beginResetModel();
-    m_cycleStageInfos.clear();
+    clearHistory();
+    endResetModel();
+}
+
+void StageTableModel::setRowMode(RowMode mode) {
+    if (mode == m_rowMode) {
+        return;
+    }
+    beginResetModel();
+    m_rowMode = mode;
+    endResetModel();
+}
+
+int StageTableModel::columnOfCycle(long long cycle) const {
+    if (m_columns == 0) {
+        return -1;
+    }
+    return static_cast<int>(std::max(0LL, std::min(cycle - m_firstCycle, static_cast<long long>(m_columns - 1))));
+}
+
+int StageTableModel::rowOfCycle(long long cycle) const {
+    if (m_rowMode != RowMode::Instances) {
+        return -1;
+    }
+    const int row = firstInstanceFrom(cycle);
+    return row < static_cast<int>(m_instances.size()) ? row : -1;
+}
+
+int StageTableModel::firstInstanceFrom(long long cycle) const {
+    // Instances are ordered by the cycle in which they entered the pipeline
+    const auto it = std::lower_bound(m_instances.begin(), m_instances.end(), cycle,
+                                     [](const Instance& instance, long long c) { return instance.firstCycle < c; });
+    return static_cast<int>(it - m_instances.begin());
+}
+
+void StageTableModel::setRetention(unsigned cycles) {
+    cycles = std::max(1u, std::min(cycles, s_maxRetention));
+    if (cycles == m_capacity) {
+        return;
+    }
+
+    // The most recent cycles are retained, and moved to the start of the resized buffers
+    const int retained = std::min(m_columns, static_cast<int>(cycles));
+    const int dropped = m_columns - retained;
+    std::vector<uint32_t> pcs(static_cast<size_t>(cycles) * m_stageCount, 0);
+    std::vector<uint8_t> flags(pcs.size(), 0);
+    std::vector<uint32_t> ids(pcs.size(), 0);
+    for (int column = 0; column < retained; column++) {
+        for (unsigned stage = 0; stage < m_stageCount; stage++) {
+            pcs[column * m_stageCount + stage] = m_pcs[offsetOf(column + dropped, stage)];
+            flags[column * m_stageCount + stage] = m_flags[offsetOf(column + dropped, stage)];
+            ids[column * m_stageCount + stage] = m_ids[offsetOf(column + dropped, stage)];
+        }
+    }
+
+    beginResetModel();
+    m_pcs.swap(pcs);
+    m_flags.swap(flags);
+    m_ids.swap(ids);
+    m_capacity = cycles;
+    m_head = 0;
+    m_firstCycle += dropped;
+    m_columns = retained;
+    dropExpiredInstances(false);
     endResetModel();
 }
 
+void StageTableModel::clearHistory() {
+    m_stageCount = m_context->getProcessor()->stageCount();
+    m_pcs.assign(static_cast<size_t>(m_capacity) * m_stageCount, 0);
+    m_flags.assign(m_pcs.size(), 0);
+    m_ids.assign(m_pcs.size(), 0);
+    m_instances.clear();
+    m_pendingInstances.clear();
+    m_firstId = 0;
+    m_head = 0;
+    m_columns = 0;
+    m_firstCycle = 0;
+}
+
+StageTableModel::Instance* StageTableModel::instanceOf(uint32_t id) {
+    const size_t index = id - m_firstId;
+    if (index < m_instances.size()) {
+        return &m_instances[index];
+    } else if (index - m_instances.size() < m_pendingInstances.size()) {
+        return &m_pendingInstances[index - m_instances.size()];
+    }
+    return nullptr;
+}
+
+void StageTableModel::writeColumn(int column) {
+    const auto* proc = m_context->getProcessor();
+    const long long cycle = m_firstCycle + column;
+    const bool hasPrevCycle = column > 0 && (m_flags[offsetOf(column - 1, 0)] & Recorded);
+    for (unsigned stage = 0; stage < m_stageCount; stage++) {
+        const StageInfo info = proc->stageInfo(stage);
+        const unsigned offset = offsetOf(column, stage);
+        m_pcs[offset] = info.pc;
+        m_flags[offset] =
+            Recorded | (info.stage_valid ? Valid : 0) | (static_cast<unsigned>(info.state) << StateShift);
+        if (!info.stage_valid) {
+            continue;
+        }
+
+        // An instruction either stalled in its stage, or advanced from an earlier stage
+        Instance* instance = nullptr;
+        for (int prev = static_cast<int>(stage); hasPrevCycle && prev >= 0 && !instance; prev--) {
+            const unsigned prevOffset = offsetOf(column - 1, prev);
+            if (!(m_flags[prevOffset] & Valid) || m_pcs[prevOffset] != info.pc) {
+                continue;
+            }
+            const uint32_t id = m_ids[prevOffset];
+            bool taken = false;
+            for (unsigned other = 0; other < stage; other++) {
+                const unsigned otherOffset = offsetOf(column, other);
+                taken |= (m_flags[otherOffset] & Valid) && m_ids[otherOffset] == id;
+            }
+            if (!taken && (instance = instanceOf(id))) {
+                m_ids[offset] = id;
+                instance->lastCycle = cycle;
+            }
+        }
+        if (!instance) {
+            m_ids[offset] = m_firstId + static_cast<uint32_t>(m_instances.size() + m_pendingInstances.size());
+            m_pendingInstances.push_back({info.pc, cycle, cycle});
+        }
+    }
+}
+
+void StageTableModel::appendPendingInstances(bool notify) {
+    if (m_pendingInstances.empty()) {
+        return;
+    }
+    const int first = static_cast<int>(m_instances.size());
+    notify &= m_rowMode == RowMode::Instances;
+    if (notify) {
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(m_pendingInstances.size()) - 1);
+    }
+    m_instances.insert(m_instances.end(), m_pendingInstances.begin(), m_pendingInstances.end());
+    m_pendingInstances.clear();
+    if (notify) {
+        endInsertRows();
+    }
+}
+
+void StageTableModel::truncateInstances(long long cycle) {
+    // Instances occupy contiguous cycles, so any instance occupying a cycle after @p cycle which entered the pipeline
+    // before it, occupies @p cycle
+    const int column = static_cast<int>(cycle - m_firstCycle);
+    for (unsigned stage = 0; stage < m_stageCount; stage++) {
+        const unsigned offset = offsetOf(column, stage);
+        Instance* instance = (m_flags[offset] & Valid) ? instanceOf(m_ids[offset]) : nullptr;
+        if (instance) {
+            instance->lastCycle = std::min(instance->lastCycle, cycle - 1);
+        }
+    }
+
+    const int first = firstInstanceFrom(cycle);
+    const int last = static_cast<int>(m_instances.size()) - 1;
+    if (first > last) {
+        return;
+    }
+    const bool notify = m_rowMode == RowMode::Instances;
+    if (notify) {
+        beginRemoveRows(QModelIndex(), first, last);
+    }
+    m_instances.erase(m_instances.begin() + first, m_instances.end());
+    if (notify) {
+        endRemoveRows();
+    }
+}
+
+void StageTableModel::dropExpiredInstances(bool notify) {
+    int expired = 0;
+    while (expired < static_cast<int>(m_instances.size()) && m_instances[expired].lastCycle < m_firstCycle) {
+        expired++;
+    }
+    if (expired == 0) {
+        return;
+    }
+    notify &= m_rowMode == RowMode::Instances;
+    if (notify) {
+        beginRemoveRows(QModelIndex(), 0, expired - 1);
+    }
+    m_instances.erase(m_instances.begin(), m_instances.begin() + expired);
+    m_firstId += static_cast<uint32_t>(expired);
+    if (notify) {
+        endRemoveRows();
+    }
+}
+
+void StageTableModel::clearColumn(int column) {
+    for (unsigned stage = 0; stage < m_stageCount; stage++) {
+        m_flags[offsetOf(column, stage)] = 0;
+    }
+}
+
 void StageTableModel::gatherStageInfo() {
-    for (unsigned i = 0; i < ProcessorHandler::get()->getProcessor()->stageCount(); i++) {
-        m_cycleStageInfos[ProcessorHandler::get()->getProcessor()->getCycleCount()][i] =
-            ProcessorHandler::get()->getProcessor()->stageInfo(i);
+    const auto* proc = m_context->getProcessor();
+    const long long cycle = proc->getCycleCount();
+    if (proc->stageCount() != m_stageCount || m_columns == 0 || cycle < m_firstCycle ||
+        cycle - (m_firstCycle + m_columns) >= m_capacity) {
+        // The processor was changed, reversed past all retained cycles, or run past the retention of the table
+        beginResetModel();
+        clearHistory();
+        m_firstCycle = cycle;
+        m_columns = 1;
+        writeColumn(0);
+        appendPendingInstances(false);
+        endResetModel();
+        return;
+    }
+
+    const int column = static_cast<int>(cycle - m_firstCycle);
+    if (column < m_columns) {
+        // The cycle has already been recorded; the processor was reversed, invalidating all later cycles
+        if (column + 1 < m_columns) {
+            beginRemoveColumns(QModelIndex(), column + 1, m_columns - 1);
+            m_columns = column + 1;
+            endRemoveColumns();
+        }
+        truncateInstances(cycle);
+        writeColumn(column);
+        appendPendingInstances();
+        if (rowCount() > 0) {
+            emit dataChanged(index(0, column), index(rowCount() - 1, column));
+        }
+        return;
     }
+
+    // Discard the oldest cycles exceeding the retention
+    const int overflow = std::max(0, column + 1 - static_cast<int>(m_capacity));
+    if (overflow > 0) {
+        beginRemoveColumns(QModelIndex(), 0, overflow - 1);
+        m_head = (m_head + overflow) % m_capacity;
+        m_firstCycle += overflow;
+        m_columns -= overflow;
+        endRemoveColumns();
+        dropExpiredInstances();
+    }
+
+    // Cycles which were skipped since the last recorded cycle (ie. whilst running) are left empty
+    const int last = column - overflow;
+    beginInsertColumns(QModelIndex(), m_columns, last);
+    for (int skipped = m_columns; skipped < last; skipped++) {
+        clearColumn(skipped);
+    }
+    writeColumn(last);
+    m_columns = last + 1;
+    endInsertColumns();
+    appendPendingInstances();
 }
 
 QVariant StageTableModel::data(const QModelIndex& index, int role) const {
@@ -64,24 +319,59 @@ QVariant StageTableModel::data(const QModelIndex& index, int role) const {
     if (role != Qt::DisplayRole)
         return QVariant();
 
-    if (!m_cycleStageInfos.count(index.column()))
+    const int column = index.column();
+    if (column >= m_columns)
         return QVariant();
 
-    const uint32_t addr = indexToAddress(index.row());
-    const auto& stageInfo = m_cycleStageInfos.at(index.column());
+    return m_rowMode == RowMode::Instances ? instanceData(index.row(), column) : instructionData(index.row(), column);
+}
+
+QVariant StageTableModel::instanceData(int row, int column) const {
+    if (row < 0 || row >= static_cast<int>(m_instances.size())) {
+        return QVariant();
+    }
+    const Instance& instance = m_instances[row];
+    const long long cycle = m_firstCycle + column;
+    if (cycle < instance.firstCycle || cycle > instance.lastCycle) {
+        return QVariant();
+    }
+
+    const uint32_t id = m_firstId + static_cast<uint32_t>(row);
+    const bool hasPrevCycle = column > 0 && cycle > instance.firstCycle;
+    for (unsigned stage = 0; stage < m_stageCount; stage++) {
+        const unsigned offset = offsetOf(column, stage);
+        if (!(m_flags[offset] & Valid) || m_ids[offset] != id) {
+            continue;
+        }
+        if (hasPrevCycle) {
+            const unsigned prevOffset = offsetOf(column - 1, stage);
+            if ((m_flags[prevOffset] & Valid) && m_ids[prevOffset] == id) {
+                return QString("-");
+            }
+        }
+        return m_context->getProcessor()->stageName(stage);
+    }
+    return QVariant();
+}
+
+QVariant StageTableModel::instructionData(int row, int column) const {
+    const uint32_t addr = indexToAddress(m_context, row);
+    const bool hasPrevCycle = column > 0 && (m_flags[offsetOf(column - 1, 0)] & Recorded);
 
     QStringList stagesForAddr;
-    for (const auto& si : stageInfo) {
-        if (si.second.pc == addr && si.second.stage_valid) {
-            if (m_cycleStageInfos.count(index.column() - 1)) {
-                const auto& prevCycleStageInfo = m_cycleStageInfos.at(index.column() - 1);
-                if (prevCycleStageInfo.at(si.first).stage_valid && prevCycleStageInfo.at(si.first).pc == si.second.pc) {
-                    stagesForAddr << "-";
-                    continue;
-                }
+    for (unsigned stage = 0; stage < m_stageCount; stage++) {
+        const unsigned offset = offsetOf(column, stage);
+        if (m_pcs[offset] != addr || !(m_flags[offset] & Valid)) {
+            continue;
+        }
+        if (hasPrevCycle) {
+            const unsigned prevOffset = offsetOf(column - 1, stage);
+            if ((m_flags[prevOffset] & Valid) && m_pcs[prevOffset] == addr) {
+                stagesForAddr << "-";
+                continue;
             }
-            stagesForAddr << ProcessorHandler::get()->getProcessor()->stageName(si.first);
         }
+        stagesForAddr << m_context->getProcessor()->stageName(stage);
     }
 
     if (stagesForAddr.size() == 0) {
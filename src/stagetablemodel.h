@@ -2,6 +2,9 @@
 
 #include <QAbstractTableModel>
 
+#include <deque>
+#include <vector>
+
 #include "processorhandler.h"
 
 namespace Ripes {
@@ -10,7 +13,13 @@ class StageTableModel : public QAbstractTableModel {
     Q_OBJECT
 public:
     enum Column { Breakpoint = 0, PC = 1, Stage = 2, Instruction = 3, NColumns };
-    StageTableModel(QObject* parent = nullptr);
+    /**
+     * @brief The RowMode enum
+     * Instructions: One row per instruction of the text section; each iteration of a loop shares the same row.
+     * Instances: One row per dynamic instance of an instruction, in the order in which instances entered the pipeline.
+     */
+    enum class RowMode { Instructions, Instances };
+    StageTableModel(ProcessorHandler* context, QObject* parent = nullptr);
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -18,17 +27,93 @@ public:
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
+    /**
+     * @brief setRetention
+     * Sets the number of most recent cycles which are retained in the table to @p cycles. Older cycles are discarded.
+     */
+    void setRetention(unsigned cycles);
+    unsigned getRetention() const { return m_capacity; }
+    void setRowMode(RowMode mode);
+    RowMode getRowMode() const { return m_rowMode; }
+
+    /// @returns the column of @p cycle, clamped to the retained cycles. Returns -1 if no cycles are retained.
+    int columnOfCycle(long long cycle) const;
+    /**
+     * @brief rowOfCycle
+     * @returns the row of the first instruction instance which entered the pipeline at or after @p cycle, or -1 if the
+     * table is not in the Instances row mode or no such instance is retained.
+     */
+    int rowOfCycle(long long cycle) const;
+    static constexpr unsigned s_defaultRetention = 10000;
+    static constexpr unsigned s_maxRetention = 1000000;
+
 public slots:
     void processorWasClocked();
     void reset();
 
 private:
+    enum Flags : uint8_t { Valid = 0b1, Recorded = 0b10, StateShift = 2 };
+
+    /**
+     * @brief The Instance struct
+     * A dynamic instance of the instruction at @p pc, which occupies a stage in the cycles [firstCycle; lastCycle].
+     */
+    struct Instance {
+        uint32_t pc;
+        long long firstCycle;
+        long long lastCycle;
+    };
+
     void gatherStageInfo();
+    /// @returns the index of the first instance which entered the pipeline at or after @p cycle
+    int firstInstanceFrom(long long cycle) const;
+    QVariant instructionData(int row, int column) const;
+    QVariant instanceData(int row, int column) const;
+
+    /// @returns the slot of the column @p column in the ring buffer
+    unsigned slotOf(int column) const { return (m_head + static_cast<unsigned>(column)) % m_capacity; }
+    unsigned offsetOf(int column, unsigned stage) const { return slotOf(column) * m_stageCount + stage; }
 
+    /// Discards all cycles, and sizes the buffers for the retention and stage count of the current processor
+    void clearHistory();
     /**
-     * @brief m_cycleStageInfos
-     * map<cycle, map<stageId, stageInfo>>
+     * @brief writeColumn
+     * Writes the current stage information of the processor to the slot of @p column. Each valid stage is assigned the
+     * instance which held the same instruction in the same or an earlier stage in the previous cycle, if any.
+     * Otherwise, a new instance is created in m_pendingInstances, which appendPendingInstances adds to the table.
      */
-    std::map<long long, std::map<unsigned, StageInfo>> m_cycleStageInfos;
+    void writeColumn(int column);
+    /// Moves m_pendingInstances to the table. Row insertion is signalled if @p notify is set.
+    void appendPendingInstances(bool notify = true);
+    /// Removes all instances which entered the pipeline at or after @p cycle, which is about to be rewritten
+    void truncateInstances(long long cycle);
+    /// Removes the leading instances which do not occupy any retained cycle. Signals row removal if @p notify is set
+    void dropExpiredInstances(bool notify = true);
+    /// @returns the instance of @p id, or nullptr if it is neither in the table nor pending
+    Instance* instanceOf(uint32_t id);
+    /// Marks the slot of @p column as not recorded, ie. for cycles which were skipped by running the processor
+    void clearColumn(int column);
+
+    /**
+     * @brief m_pcs/m_flags
+     * Ring buffer of the stage information of the retained cycles, stored columnwise with m_stageCount entries per
+     * cycle. Column 0 of the model is cycle m_firstCycle, stored in slot m_head. m_flags holds the Flags of each entry
+     * and the StageInfo::State in the bits above StateShift.
+     */
+    std::vector<uint32_t> m_pcs;
+    std::vector<uint8_t> m_flags;
+    /// Id of the instance held by each valid entry of the ring buffer. Row r in the Instances mode is id m_firstId + r
+    std::vector<uint32_t> m_ids;
+    std::deque<Instance> m_instances;
+    std::vector<Instance> m_pendingInstances;
+    uint32_t m_firstId = 0;
+    RowMode m_rowMode = RowMode::Instances;
+    unsigned m_stageCount = 0;
+    unsigned m_capacity = s_defaultRetention;
+    unsigned m_head = 0;
+    int m_columns = 0;
+    long long m_firstCycle = 0;
+
+    ProcessorHandler* m_context = nullptr;
 };
 }  // namespace Ripes
@@ -3,6 +3,9 @@
 
 #include <QClipboard>
 #include <QHeaderView>
+#include <QScrollBar>
+
+#include <limits>
 
 #include "stagetablemodel.h"
 
@@ -15,8 +18,52 @@ StageTableWidget::StageTableWidget(StageTableModel* model, QWidget* parent)
     m_stageModel = model;
     m_ui->stageTableView->setModel(m_stageModel);
 
-    m_ui->stageTableView->resizeColumnsToContents();
+    // Sections are sized uniformly rather than to their contents, such that the view only ever queries the visible
+    // cells of the table, which may span millions of cycles and instruction instances
+    auto* cycleHeader = m_ui->stageTableView->horizontalHeader();
+    cycleHeader->setSectionResizeMode(QHeaderView::Fixed);
+    cycleHeader->setDefaultSectionSize(fontMetrics().width("MEM0/MEM1") + 8);
+    m_ui->stageTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
+
+    m_ui->rowMode->addItem("Instances", QVariant::fromValue(static_cast<int>(StageTableModel::RowMode::Instances)));
+    m_ui->rowMode->addItem("Instructions",
+                           QVariant::fromValue(static_cast<int>(StageTableModel::RowMode::Instructions)));
+    m_ui->rowMode->setCurrentIndex(m_ui->rowMode->findData(static_cast<int>(m_stageModel->getRowMode())));
+    connect(m_ui->rowMode, QOverload<int>::of(&QComboBox::currentIndexChanged), [=](int index) {
+        m_stageModel->setRowMode(static_cast<StageTableModel::RowMode>(m_ui->rowMode->itemData(index).toInt()));
+    });
+
+    m_ui->jumpToCycle->setRange(0, std::numeric_limits<int>::max());
+    connect(m_ui->jumpToCycle, &QSpinBox::editingFinished, [=] { jumpToCycle(m_ui->jumpToCycle->value()); });
+
+    m_ui->retention->setRange(1, StageTableModel::s_maxRetention);
+    m_ui->retention->setValue(m_stageModel->getRetention());
+    m_ui->retention->setSingleStep(1000);
+    connect(m_ui->retention, &QSpinBox::editingFinished,
+            [=] { m_stageModel->setRetention(m_ui->retention->value()); });
+
+    // Start out at the most recent cycle
+    m_ui->stageTableView->scrollToBottom();
+    m_ui->stageTableView->horizontalScrollBar()->setValue(m_ui->stageTableView->horizontalScrollBar()->maximum());
+}
+
+void StageTableWidget::jumpToCycle(long long cycle) {
+    const int column = m_stageModel->columnOfCycle(cycle);
+    if (column < 0) {
+        return;
+    }
+    // In the Instances row mode, the instance which entered the pipeline in the cycle is moved to the top of the view.
+    // Otherwise, the rows currently in view are kept.
+    int row = m_stageModel->rowOfCycle(cycle);
+    if (row < 0) {
+        row = std::max(0, m_ui->stageTableView->rowAt(0));
+    }
+    if (row >= m_stageModel->rowCount()) {
+        m_ui->stageTableView->horizontalScrollBar()->setValue(column);
+        return;
+    }
+    m_ui->stageTableView->scrollTo(m_stageModel->index(row, column), QAbstractItemView::PositionAtTop);
 }
 
 StageTableWidget::~StageTableWidget() {
@@ -21,6 +21,9 @@ private slots:
     void on_copy_clicked();
 
 private:
+    /// Scrolls the view to @p cycle, or the nearest retained cycle
+    void jumpToCycle(long long cycle);
+
     Ui::StageTableWidget* m_ui = nullptr;
     StageTableModel* m_stageModel = nullptr;
 };
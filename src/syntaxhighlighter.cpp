@@ -1,7 +1,6 @@
 #include "syntaxhighlighter.h"
 
 #include <QList>
-#include <QRegularExpressionMatchIterator>
 #include <QTextDocument>
 
 #include "defines.h"
@@ -64,6 +63,16 @@ QString FieldType::validateField(const QString& field) const {
                 return QString("Register %1 is unrecognized").arg(field);
             }
         }
+        case Type::CompressedRegister: {
+            // Most compressed instructions may only address registers x8-x15
+            const int index = RegNames.indexOf(field);
+            const int reg = index != -1 ? index : static_cast<int>(ABInames.value(field, 0));
+            if (reg >= 8 && reg <= 15) {
+                return QString();
+            } else {
+                return QString("Register %1 is not one of x8-x15 (s0-s1, a0-a5)").arg(field);
+            }
+        }
         case Type::Offset: {
             // Check if label is defined in highlighter
             Q_ASSERT(m_highlighter != nullptr);
@@ -73,6 +82,14 @@ QString FieldType::validateField(const QString& field) const {
                 return QString("label \"%1\" is undefined").arg(field);
             }
         }
+        case Type::CSR: {
+            // CSRs may be given by name or by number
+            if (CSRNames.contains(field) || FieldType(Type::Immediate, 0, 4095).validateField(field).isEmpty()) {
+                return QString();
+            } else {
+                return QString("CSR %1 is unrecognized").arg(field);
+            }
+        }
         case Type::String: {
             if (field.length() > 1 && field[0] == "\"" && field[field.length() - 1] == "\"") {
                 return QString();
@@ -90,172 +107,137 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument* parent) : QSyntaxHighlighter
     errorFormat.setUnderlineStyle(QTextCharFormat::WaveUnderline);
     errorFormat.setUnderlineColor(Qt::red);
 
-    HighlightingRule rule;
-
-    // Create rules for name-specific registers
+    // Named registers and instructions are recognized through a single lookup in the keyword table. Numbered
+    // registers (saved, temporary, argument and x registers) are matched by isNumberedRegister.
     regFormat.setForeground(QColor(0x800000));
-    QStringList registerPatterns;
-    registerPatterns << "\\bzero\\b"
-                     << "\\bra\\b"
-                     << "\\bsp\\b"
-                     << "\\bgp\\b"
-                     << "\\btp\\b"
-                     << "\\bfp\\b";
-    for (const auto& pattern : registerPatterns) {
-        rule.pattern = QRegularExpression(pattern);
-        rule.format = regFormat;
-        m_highlightingRules.append(rule);
-    }
-
-    // Create rules for registers that can easily be regex matched
-    // (saved, temporary and argument registers)
-    rule.pattern = QRegularExpression("\\b[(a|s|t|x)][0-9]{1,2}");
-    rule.format = regFormat;
-    m_highlightingRules.append(rule);
-
-    // Create match cases for instructions
-    QStringList instructionPatterns;
-    instructionPatterns << "\\bla\\b"
-                        << "\\brd\\b"
-                        << "\\blw\\b"
-                        << "\\blh\\b"
-                        << "\\blui\\b"
-                        << "\\blb\\b"
-                        << "\\bsb\\b"
-                        << "\\bsh\\b"
-                        << "\\bsw\\b"
-                        << "\\bnop\\b"
-                        << "\\bli\\b"
-                        << "\\bmv\\b"
-                        << "\\bnot\\b"
-                        << "\\bneg\\b"
-                        << "\\bnegw\\b"
-                        << "\\bsext.w\\b"
-                        << "\\bseqz\\b"
-                        << "\\bsnez\\b"
-                        << "\\bsltz\\b"
-                        << "\\bsgtz\\b"
-                        << "\\bbeqz\\b"
-                        << "\\bbnez\\b"
-                        << "\\bblez\\b"
-                        << "\\bbgez\\b"
-                        << "\\bbltz\\b"
-                        << "\\bbgtz\\b"
-                        << "\\bbgt\\b"
-                        << "\\bble\\b"
-                        << "\\bbgtu\\b"
-                        << "\\bbleu\\b"
-                        << "\\bj\\b"
-                        << "\\bjal\\b"
-                        << "\\bjr\\b"
-                        << "\\bjalr\\b"
-                        << "\\bret\\b"
-                        << "\\bcall\\b"
-                        << "\\btail\\b"
-                        /*
-                        << "\\bfence\\b"
-                        << "\\brdinstret\\b"
-                        << "\\brdcycle\\b"
-                        << "\\brdtime\\b"
-                        << "\\bcsrr\\b"
-                        << "\\bcsrw\\b"
-                        << "\\bcsrs\\b"
-                        << "\\bcsrc\\b"
-                        << "\\bcsrwi\\b"
-                        << "\\bcsrsi\\b"
-                        << "\\bcsrci\\b"
-                                               */
-                        << "\\bauipc\\b"
-                        << "\\badd\\b"
-                        << "\\baddi\\b"
-                        << "\\bxor\\b"
-                        << "\\bxori\\b"
-                        << "\\bsub\\b"
-                        << "\\bsubw\\b"
-                        << "\\baddiw\\b"
-                        << "\\bsltiu\\b"
-                        << "\\bsltu\\b"
-                        << "\\bslt\\b"
-                        << "\\bbeq\\b"
-                        << "\\bbne\\b"
-                        << "\\bbge\\b"
-                        << "\\bblt\\b"
-                        << "\\bbltu\\b"
-                        << "\\bbgeu\\b"
-                        << "\\bsrl\\b"
-                        << "\\bsrli\\b"
-                        << "\\bsll\\b"
-                        << "\\bslli\\b"
-                        << "\\bsra\\b"
-                        << "\\bsrai\\b"
-                        << "\\bor\\b"
-                        << "\\bori\\b"
-                        << "\\band\\b"
-                        << "\\bandi\\b"
-                        << "\\becall\\b"
-
-                        << "\\bmul\\b"
-                        << "\\bmulh\\b"
-                        << "\\bmulhu\\b"
-                        << "\\bmulhsu\\b"
-
-                        << "\\bdiv\\b"
-                        << "\\bdivu\\b"
-                        << "\\brem\\b"
-                        << "\\bremu\\b";
+    for (const auto& name : {"zero", "ra", "sp", "gp", "tp", "fp"}) {
+        m_keywordFormats.insert(name, &regFormat);
+    }
 
     instrFormat.setForeground(QColor(Colors::BerkeleyBlue));
-    for (const auto& pattern : instructionPatterns) {
-        rule.pattern = QRegularExpression(pattern);
-        rule.format = instrFormat;
-        m_highlightingRules.append(rule);
+    const QStringList instructions = {"la", "rd", "lw", "lh", "lui", "lb", "sb", "sh", "sw", "nop", "li", "mv", "not",
+                                      "neg", "negw", "sext.w", "seqz", "snez", "sltz", "sgtz", "beqz", "bnez", "blez",
+                                      "bgez", "bltz", "bgtz", "bgt", "ble", "bgtu", "bleu", "j", "jal", "jr", "jalr",
+                                      "ret", "call", "tail", "rdinstret", "rdinstreth", "rdcycle", "rdcycleh", "rdtime",
+                                      "rdtimeh", "csrr", "csrrw", "csrrs", "csrrc", "csrrwi", "csrrsi", "csrrci",
+                                      "auipc", "add", "addi", "xor", "xori", "sub", "subw", "addiw", "sltiu", "sltu",
+                                      "slt", "beq", "bne", "bge", "blt", "bltu", "bgeu", "srl", "srli", "sll", "slli",
+                                      "sra", "srai", "or", "ori", "and", "andi", "ecall", "mul", "mulh", "mulhu",
+                                      "mulhsu", "div", "divu", "rem", "remu", "c.nop", "c.addi", "c.li", "c.lui",
+                                      "c.addi16sp", "c.addi4spn", "c.slli", "c.srli", "c.srai", "c.andi", "c.mv",
+                                      "c.add", "c.sub", "c.xor", "c.or", "c.and", "c.lw", "c.sw", "c.lwsp", "c.swsp",
+                                      "c.j", "c.jal", "c.jr", "c.jalr", "c.beqz", "c.bnez"};
+    for (const auto& name : instructions) {
+        m_keywordFormats.insert(name, &instrFormat);
     }
 
-    // Create immediate hightlighting rule
-    immFormat.setForeground(QColor(Qt::darkGreen));
-    rule.pattern = QRegularExpression("\\b(?<![A-Za-z])[-+]?\\d+");
-    rule.format = immFormat;
-    m_highlightingRules.append(rule);
-
-    // Create immediate highlighting rule for prefixed numbers (0x, 0b)
     immFormat.setForeground(QColor(Qt::darkGreen));
-    rule.pattern = QRegularExpression("([-+]?0[xX][0-9a-fA-F]+|[-+]?0[bB][0-1]+)");
-    rule.format = immFormat;
-    m_highlightingRules.append(rule);
-
-    // Create comment highlighting rule
     commentFormat.setForeground(QColor(Colors::Medalist));
-    rule.pattern = QRegularExpression("[#]+.*");
-    rule.format = commentFormat;
-    m_highlightingRules.append(rule);
+    stringFormat.setForeground(QColor(0x800000));
+}
 
-    // Create label highlighting rule
-    commentFormat.setForeground(QColor(Colors::Medalist));
-    rule.pattern = QRegularExpression("(.*?[:])");
-    rule.format = commentFormat;
-    m_highlightingRules.append(rule);
+namespace {
+/// @returns true if @p token is a numbered register name; a, s, t or x followed by one or two digits
+bool isNumberedRegister(const QStringRef& token) {
+    if (token.length() < 2 || token.length() > 3 || !QStringLiteral("astx").contains(token[0])) {
+        return false;
+    }
+    for (int i = 1; i < token.length(); i++) {
+        if (!token[i].isDigit()) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    // Create string highlighting rule
-    stringFormat.setForeground(QColor(0x800000));
-    rule.pattern = QRegularExpression(R"("(?:[^"]|\.)*")");
-    rule.format = stringFormat;
-    m_highlightingRules.append(rule);
+/// @returns true if @p token is a signed decimal, hexadecimal (0x) or binary (0b) number
+bool isImmediate(QStringRef token) {
+    if (token.startsWith('-') || token.startsWith('+')) {
+        token = token.mid(1);
+    }
+    if (token.isEmpty()) {
+        return false;
+    }
+    if (token.length() > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X')) {
+        for (int i = 2; i < token.length(); i++) {
+            const QChar c = token[i].toLower();
+            if (!c.isDigit() && (c < 'a' || c > 'f')) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (token.length() > 2 && token[0] == '0' && (token[1] == 'b' || token[1] == 'B')) {
+        for (int i = 2; i < token.length(); i++) {
+            if (token[i] != '0' && token[i] != '1') {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (const QChar c : token) {
+        if (!c.isDigit()) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+const QTextCharFormat* SyntaxHighlighter::tokenFormat(const QStringRef& token) const {
+    const auto keyword = m_keywordFormats.constFind(token.toString());
+    if (keyword != m_keywordFormats.constEnd()) {
+        return keyword.value();
+    }
+    if (isNumberedRegister(token)) {
+        return &regFormat;
+    }
+    if (isImmediate(token)) {
+        return &immFormat;
+    }
+    return nullptr;
 }
 
 void SyntaxHighlighter::highlightBlock(const QString& text) {
-    QString tooltip = checkSyntax(text);
+    if (m_suspended) {
+        return;
+    }
+
+    // The line is tokenized once; the tokens are used both for syntax checking and for highlighting
+    QVector<int> starts;
+    const QStringList fields = tokenize(text, &starts);
+    QString tooltip = checkSyntax(fields);
     int row = currentBlock().firstLineNumber();
     if (tooltip != QString()) {
         setFormat(0, text.length(), errorFormat);
         emit setTooltip(row, tooltip);
-    } else {
-        emit setTooltip(row, QString());
-        for (const HighlightingRule& rule : m_highlightingRules) {
-            QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-            while (matchIterator.hasNext()) {
-                QRegularExpressionMatch match = matchIterator.next();
-                setFormat(match.capturedStart(), match.capturedLength(), rule.format);
-            }
+        return;
+    }
+
+    emit setTooltip(row, QString());
+    for (int i = 0; i < fields.length(); i++) {
+        const QString& field = fields[i];
+        int start = starts[i];
+        if (field.startsWith('#')) {
+            // Comments extend to the end of the line
+            setFormat(start, text.length() - start, commentFormat);
+            return;
+        }
+        if (field.startsWith('"')) {
+            setFormat(start, field.length(), stringFormat);
+            continue;
+        }
+
+        QStringRef token(&field);
+        const int labelEnd = i == 0 ? field.indexOf(':') : -1;
+        if (labelEnd != -1) {
+            // Labels are highlighted up to and including the separator, followed by any operation on the same field
+            setFormat(start, labelEnd + 1, commentFormat);
+            token = field.midRef(labelEnd + 1);
+            start += labelEnd + 1;
+        }
+        if (const QTextCharFormat* format = tokenFormat(token)) {
+            setFormat(start, token.length(), *format);
         }
     }
 }
@@ -509,6 +491,59 @@ void SyntaxHighlighter::createSyntaxRules() {
         m_syntaxRules.insert(name, QList<SyntaxRule>() << rule);
     }
 
+    // CSR instructions
+    types.clear();
+    names.clear();
+    types << FieldType(Type::Register) << FieldType(Type::CSR) << FieldType(Type::Register);
+    names << "csrrw"
+          << "csrrs"
+          << "csrrc";
+    for (const auto& name : names) {
+        rule.instr = name;
+        rule.fields = 4;
+        rule.inputs = types;
+        m_syntaxRules.insert(name, QList<SyntaxRule>() << rule);
+    }
+
+    // CSR immediate instructions
+    types.clear();
+    names.clear();
+    types << FieldType(Type::Register) << FieldType(Type::CSR) << FieldType(Type::Immediate, 0, 31);
+    names << "csrrwi"
+          << "csrrsi"
+          << "csrrci";
+    for (const auto& name : names) {
+        rule.instr = name;
+        rule.fields = 4;
+        rule.inputs = types;
+        m_syntaxRules.insert(name, QList<SyntaxRule>() << rule);
+    }
+
+    // csrr
+    types.clear();
+    types << FieldType(Type::Register) << FieldType(Type::CSR);
+    rule.instr = "csrr";
+    rule.fields = 3;
+    rule.inputs = types;
+    m_syntaxRules.insert(rule.instr, QList<SyntaxRule>() << rule);
+
+    // Counter pseudo-instructions
+    types.clear();
+    names.clear();
+    types << FieldType(Type::Register);
+    names << "rdcycle"
+          << "rdcycleh"
+          << "rdtime"
+          << "rdtimeh"
+          << "rdinstret"
+          << "rdinstreth";
+    for (const auto& name : names) {
+        rule.instr = name;
+        rule.fields = 2;
+        rule.inputs = types;
+        m_syntaxRules.insert(name, QList<SyntaxRule>() << rule);
+    }
+
     // S type instructions
     QMap<QString, QList<SyntaxRule>> storeRules;
     types.clear();
@@ -539,6 +574,47 @@ void SyntaxHighlighter::createSyntaxRules() {
     }
     m_syntaxRules.unite(storeRules);
 
+    // Compressed (RV32C) instructions. Immediates are given in bytes, as for their 32-bit equivalents; scaled
+    // immediates which are not a multiple of their scale are rejected upon assembly.
+    const auto addRule = [&](const QString& name, const QList<FieldType>& inputs) {
+        rule.instr = name;
+        rule.fields = inputs.size() + 1;
+        rule.inputs = inputs;
+        m_syntaxRules.insert(name, QList<SyntaxRule>() << rule);
+    };
+    const FieldType reg(Type::Register);
+    const FieldType creg(Type::CompressedRegister);
+    const FieldType offset(Type::Offset, 0, 0, this);
+    addRule("c.nop", {});
+    addRule("c.addi", {reg, FieldType(Type::Immediate, -32, 31)});
+    addRule("c.li", {reg, FieldType(Type::Immediate, -32, 31)});
+    addRule("c.lui", {reg, FieldType(Type::Immediate, 1, 1048575)});
+    addRule("c.addi16sp", {reg, FieldType(Type::Immediate, -512, 496)});
+    addRule("c.addi4spn", {creg, reg, FieldType(Type::Immediate, 4, 1020)});
+    addRule("c.slli", {reg, FieldType(Type::Immediate, 1, 31)});
+    addRule("c.srli", {creg, FieldType(Type::Immediate, 1, 31)});
+    addRule("c.srai", {creg, FieldType(Type::Immediate, 1, 31)});
+    addRule("c.andi", {creg, FieldType(Type::Immediate, -32, 31)});
+    addRule("c.lw", {creg, FieldType(Type::Immediate, 0, 124), creg});
+    addRule("c.sw", {creg, FieldType(Type::Immediate, 0, 124), creg});
+    addRule("c.lwsp", {reg, FieldType(Type::Immediate, 0, 252), reg});
+    addRule("c.swsp", {reg, FieldType(Type::Immediate, 0, 252), reg});
+    for (const auto& name : {"c.mv", "c.add"}) {
+        addRule(name, {reg, reg});
+    }
+    for (const auto& name : {"c.sub", "c.xor", "c.or", "c.and"}) {
+        addRule(name, {creg, creg});
+    }
+    for (const auto& name : {"c.j", "c.jal"}) {
+        addRule(name, {offset});
+    }
+    for (const auto& name : {"c.jr", "c.jalr"}) {
+        addRule(name, {reg});
+    }
+    for (const auto& name : {"c.beqz", "c.bnez"}) {
+        addRule(name, {creg, offset});
+    }
+
     // .byte
     types.clear();
     types << FieldType(Type::Immediate, -128, 255);
@@ -575,13 +651,16 @@ void SyntaxHighlighter::createSyntaxRules() {
     m_syntaxRules.insert(rule.instr, QList<SyntaxRule>() << rule);
     rule.hasListField = false;
 
-    // Emit zero's (array allocation on static data segment)
+    // Emit zero's (array allocation on static data segment). The zeros are not materialized when trailing the data
+    // segment, allowing for large arrays
     types.clear();
-    types << FieldType(Type::Immediate, 1, 0xFFFF);
+    types << FieldType(Type::Immediate, 1, 0x1000000);
     rule.fields = 2;
     rule.inputs = types;
     rule.instr = ".zero";
     m_syntaxRules.insert(rule.instr, QList<SyntaxRule>() << rule);
+    rule.instr = ".space";
+    m_syntaxRules.insert(rule.instr, QList<SyntaxRule>() << rule);
 
     // .string & .asciz
     types.clear();
@@ -603,10 +682,10 @@ namespace {
 }  // namespace
 
 QString SyntaxHighlighter::checkSyntax(const QString& input) {
-    QStringList fields = input.split(splitter);
-    fields.removeAll("");
-    fields = splitQuotes(fields);
+    return checkSyntax(tokenize(input));
+}
 
+QString SyntaxHighlighter::checkSyntax(QStringList fields) {
     // Empty fields? return
     if (fields.isEmpty())
         return QString();
@@ -658,18 +737,15 @@ QString SyntaxHighlighter::checkSyntax(const QString& input) {
     }
 
     // Remove comments from syntax evaluation
-    const static auto commentRegEx = QRegularExpression("[#](.*)");
-    int commentIndex = fields.indexOf(commentRegEx);
-    if (commentIndex != -1) {
-        int index = fields.length();
-        while (index >= commentIndex) {
-            fields.removeAt(index);
-            index--;
+    for (int i = 0; i < fields.length(); i++) {
+        if (fields[i].startsWith('#')) {
+            fields.erase(fields.begin() + i, fields.end());
+            break;
         }
-        // Empty fields? return
-        if (fields.isEmpty())
-            return QString();
     }
+    // Empty fields? return
+    if (fields.isEmpty())
+        return QString();
 
     // -- Validate remaining fields --
     // For the corresponding rules to an instruction in m_syntaxRules, the SyntaxRule list will be iterated through
@@ -738,11 +814,9 @@ void SyntaxHighlighter::reset() {
     m_rowsUsingLabels.clear();
 }
 
-void SyntaxHighlighter::clearAndRehighlight() {
-    reset();
-    rehighlight();
-    for (const auto& row : m_rowsUsingLabels) {
-        // Rehighlight rows which use labels, now that all labels have been recorded
+void SyntaxHighlighter::rehighlightLabelUsers() {
+    const auto rows = m_rowsUsingLabels;
+    for (const auto& row : rows) {
         rehighlightBlock(document()->findBlockByLineNumber(row));
     }
 }
@@ -751,7 +825,7 @@ void SyntaxHighlighter::invalidateLabels(const QTextCursor& cursor) {
     if (m_posLabelMap.contains(cursor.block().firstLineNumber())) {
         // a current label exists at the cursor position - if current action was a newline event, we need to reset
         // resets label mapping and rehighlights required lines
-        clearAndRehighlight();
+        emit labelsInvalidated();
     }
 }
 }  // namespace Ripes
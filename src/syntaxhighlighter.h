@@ -1,6 +1,6 @@
 #pragma once
 
-#include <QRegularExpression>
+#include <QHash>
 #include <QSyntaxHighlighter>
 
 namespace Ripes {
@@ -8,9 +8,9 @@ namespace Ripes {
 /* Class for highlighting RISC-V assembly code Based on QT's rich text syntax highlighter example.
  http://doc.qt.io/qt-5/qtwidgets-richtext-syntaxhighlighter-example.html
 
- Matches instruction names directly, and register aliases/true name.
- Matches immediate values by regex*/
-enum class Type { Immediate, Register, Offset, String };
+ Lines are tokenized in a single pass. Instruction names and register aliases are matched through a keyword table,
+ numbered registers and immediate values are matched by their form*/
+enum class Type { Immediate, Register, CompressedRegister, Offset, String, CSR };
 
 class SyntaxHighlighter;
 class FieldType {
@@ -35,19 +35,25 @@ public:
 
     void highlightBlock(const QString& text) override;
     void reset();
+    /**
+     * @brief setSuspended
+     * While suspended, blocks are left unhighlighted and unchecked when the document changes. Used when inserting
+     * large amounts of text, which is subsequently highlighted incrementally by the editor.
+     */
+    void setSuspended(bool suspended) { m_suspended = suspended; }
+    bool isSuspended() const { return m_suspended; }
+    /// Rehighlights the rows using labels, once all labels in the document have been recorded
+    void rehighlightLabelUsers();
 
     QString checkSyntax(const QString& line);
+    QString checkSyntax(QStringList fields);
 
 signals:
     void setTooltip(int, QString);
     void rehighlightInvalidBlock(const QTextBlock&);
+    void labelsInvalidated();
 
 private:
-    struct HighlightingRule {
-        QRegularExpression pattern;
-        QTextCharFormat format;
-    };
-
     struct SyntaxRule {
         QString instr;
         int fields;                   // n instruction fields, including the instruction
@@ -59,10 +65,12 @@ private:
     };
 
     void createSyntaxRules();
+    /// @returns the format of an instruction, register or immediate token, or nullptr if the token is none of these
+    const QTextCharFormat* tokenFormat(const QStringRef& token) const;
 
     QMap<QString, QList<SyntaxRule>> m_syntaxRules;  // Maps instruction names to syntax rule(s)
 
-    QVector<HighlightingRule> m_highlightingRules;
+    QHash<QString, const QTextCharFormat*> m_keywordFormats;  // Formats of instruction names and register aliases
 
     // Format type for each matching case
     QTextCharFormat regFormat;
@@ -76,9 +84,9 @@ private:
     QMap<int, QString> m_posLabelMap;
     QSet<int> m_rowsUsingLabels;  // List of lines that are rehighlighted once the main syntax checking is done -
                                   // needed for supporting labels that are declared after usage
+    bool m_suspended = false;
 
 public slots:
     void invalidateLabels(const QTextCursor&);
-    void clearAndRehighlight();
 };
 }  // namespace Ripes
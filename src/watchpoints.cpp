@@ -0,0 +1,119 @@
+#include "watchpoints.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+std::vector<uint8_t> Watchpoints::readRange(uint32_t address, uint32_t size, const vsrtl::core::SparseArray& memory) {
+    std::vector<uint8_t> value(size, 0);
+    for (uint32_t i = 0; i < size; i++) {
+        // Dont read memory which is not present (this will create an entry in the memory if done so).
+        const uint32_t byteAddress = address + i;
+        if (memory.contains(byteAddress)) {
+            value[i] = static_cast<uint8_t>(memory.readMemConst(byteAddress));
+        }
+    }
+    return value;
+}
+
+void Watchpoints::add(uint32_t address, uint32_t size, unsigned kinds, const vsrtl::core::SparseArray& memory) {
+    remove(address);
+    Watchpoint watchpoint;
+    watchpoint.address = address;
+    // Ranges are clamped to the end of the address space
+    watchpoint.size = static_cast<uint32_t>(std::min<uint64_t>(std::max(size, 1u), (1ull << 32) - address));
+    watchpoint.kinds = kinds;
+    if (kinds & Change) {
+        watchpoint.value = readRange(address, watchpoint.size, memory);
+    }
+    m_watchpoints.push_back(std::move(watchpoint));
+    updatePages();
+}
+
+bool Watchpoints::remove(uint32_t address) {
+    const auto it = std::find_if(m_watchpoints.begin(), m_watchpoints.end(),
+                                 [address](const Watchpoint& watchpoint) { return watchpoint.address == address; });
+    if (it == m_watchpoints.end()) {
+        return false;
+    }
+    m_watchpoints.erase(it);
+    updatePages();
+    return true;
+}
+
+void Watchpoints::clear() {
+    m_watchpoints.clear();
+    updatePages();
+}
+
+void Watchpoints::resync(const vsrtl::core::SparseArray& memory) {
+    for (auto& watchpoint : m_watchpoints) {
+        if (watchpoint.kinds & Change) {
+            watchpoint.value = readRange(watchpoint.address, watchpoint.size, memory);
+        }
+    }
+}
+
+void Watchpoints::updatePages() {
+    m_pages.clear();
+    for (const auto& watchpoint : m_watchpoints) {
+        const uint32_t first = watchpoint.address >> s_pageBits;
+        const uint32_t last = (watchpoint.address + (watchpoint.size - 1)) >> s_pageBits;
+        if ((last >> 6) >= m_pages.size()) {
+            m_pages.resize((last >> 6) + 1, 0);
+        }
+        for (uint64_t page = first; page <= last; page++) {
+            m_pages[page >> 6] |= 1ull << (page & 63);
+        }
+    }
+}
+
+bool Watchpoints::isWatched(uint32_t address, unsigned bytes) const {
+    return find(address, bytes) != nullptr;
+}
+
+const Watchpoints::Watchpoint* Watchpoints::find(uint32_t address, unsigned bytes) const {
+    for (const auto& watchpoint : m_watchpoints) {
+        if (watchpoint.contains(address, bytes)) {
+            return &watchpoint;
+        }
+    }
+    return nullptr;
+}
+
+bool Watchpoints::checkAccess(uint32_t address, unsigned bytes, bool write, uint32_t pc) {
+    const Kind kind = write ? Write : Read;
+    for (const auto& watchpoint : m_watchpoints) {
+        if ((watchpoint.kinds & kind) && watchpoint.contains(address, bytes)) {
+            m_lastHit = {kind, address, bytes, pc};
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Watchpoints::watchesChange(uint32_t address, unsigned bytes) const {
+    return std::any_of(m_watchpoints.begin(), m_watchpoints.end(), [=](const Watchpoint& watchpoint) {
+        return (watchpoint.kinds & Change) && watchpoint.contains(address, bytes);
+    });
+}
+
+bool Watchpoints::checkChange(uint32_t address, unsigned bytes, uint32_t pc, const vsrtl::core::SparseArray& memory) {
+    bool changed = false;
+    for (auto& watchpoint : m_watchpoints) {
+        if (!(watchpoint.kinds & Change) || !watchpoint.contains(address, bytes)) {
+            continue;
+        }
+        auto value = readRange(watchpoint.address, watchpoint.size, memory);
+        if (value != watchpoint.value) {
+            watchpoint.value = std::move(value);
+            if (!changed) {
+                m_lastHit = {Change, watchpoint.address, watchpoint.size, pc};
+            }
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+}  // namespace Ripes
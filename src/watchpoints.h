@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VSRTL/core/vsrtl_memory.h"
+
+namespace Ripes {
+
+/**
+ * @brief The Watchpoints class
+ * Data watchpoints over address ranges of memory, which trigger upon reads of, writes to, or changes of the value
+ * within their range. Watchpoints are filtered at page granularity; the data memory access paths test a single bit of
+ * the page bitmap per access, and only accesses to watched pages are matched against the watchpoints. Value changes
+ * are detected by comparing the range against a snapshot of its value upon writes to it, such that memory is never
+ * scanned per cycle.
+ */
+class Watchpoints {
+public:
+    static constexpr unsigned s_pageBits = 12;
+
+    enum Kind : unsigned { Read = 0b001, Write = 0b010, Change = 0b100 };
+
+    struct Watchpoint {
+        uint32_t address = 0;
+        uint32_t size = 0;
+        /// Bitmask of Kind
+        unsigned kinds = 0;
+        /// Value of the watched range when last checked, for Change watchpoints
+        std::vector<uint8_t> value;
+        bool contains(uint32_t addr, unsigned bytes) const {
+            return static_cast<uint64_t>(addr) < static_cast<uint64_t>(address) + size &&
+                   static_cast<uint64_t>(address) < static_cast<uint64_t>(addr) + bytes;
+        }
+    };
+
+    struct Hit {
+        Kind kind = Read;
+        /// Address and size of the triggering access; the watched range for Change watchpoints
+        uint32_t address = 0;
+        unsigned bytes = 0;
+        /// PC of the instruction which performed the access
+        uint32_t pc = 0;
+    };
+
+    /**
+     * @brief add
+     * Watches [@p address; @p address + @p size[ for accesses of @p kinds, replacing any watchpoint with the same
+     * address. The current value of the range is read from @p memory for Change watchpoints.
+     */
+    void add(uint32_t address, uint32_t size, unsigned kinds, const vsrtl::core::SparseArray& memory);
+    /// Removes the watchpoint at @p address. @returns false if no such watchpoint exists.
+    bool remove(uint32_t address);
+    void clear();
+    /// Re-reads the value of all Change watchpoints from @p memory, ie. after the memory has been reset or reloaded.
+    void resync(const vsrtl::core::SparseArray& memory);
+
+    const std::vector<Watchpoint>& watchpoints() const { return m_watchpoints; }
+    bool empty() const { return m_watchpoints.empty(); }
+
+    /// @returns true if any watchpoint overlaps the bytes [@p address; @p address + @p bytes[.
+    bool isWatched(uint32_t address, unsigned bytes) const;
+    /// @returns the watchpoint overlapping the bytes [@p address; @p address + @p bytes[, if any.
+    const Watchpoint* find(uint32_t address, unsigned bytes) const;
+
+    /// @returns true if any watchpoint covers the page containing @p address.
+    bool isWatchedPage(uint32_t address) const {
+        const uint32_t page = address >> s_pageBits;
+        return (page >> 6) < m_pages.size() && (m_pages[page >> 6] >> (page & 63)) & 1;
+    }
+
+    /**
+     * @brief checkAccess
+     * Matches a read or write of @p bytes at @p address by the instruction at @p pc against the Read and Write
+     * watchpoints. Callers should only check accesses of watched pages (see isWatchedPage).
+     * @returns true, and records the hit, if a watchpoint triggered.
+     */
+    bool checkAccess(uint32_t address, unsigned bytes, bool write, uint32_t pc);
+
+    /// @returns true if a write of @p bytes at @p address overlaps any Change watchpoint.
+    bool watchesChange(uint32_t address, unsigned bytes) const;
+
+    /**
+     * @brief checkChange
+     * Compares the Change watchpoints overlapping the write of @p bytes at @p address against their value in
+     * @p memory, once the write has been performed by the instruction at @p pc.
+     * @returns true, and records the hit, if the value of a watched range changed.
+     */
+    bool checkChange(uint32_t address, unsigned bytes, uint32_t pc, const vsrtl::core::SparseArray& memory);
+
+    /// @returns the most recent hit
+    const Hit& lastHit() const { return m_lastHit; }
+
+private:
+    void updatePages();
+    static std::vector<uint8_t> readRange(uint32_t address, uint32_t size, const vsrtl::core::SparseArray& memory);
+
+    std::vector<Watchpoint> m_watchpoints;
+    // Bitmap over the 4 KiB pages of the address space, set for pages overlapped by any watchpoint
+    std::vector<uint64_t> m_pages;
+    Hit m_lastHit;
+};
+
+}  // namespace Ripes
@@ -0,0 +1,185 @@
+.text
+main:
+  #-------------------------------------------------------------
+  # Compressed (RV32C) integer register-immediate operations
+  #-------------------------------------------------------------
+
+test_2:
+ c.li x8, 5
+ c.addi x8, -3
+ li x29, 2
+ li gp, 2
+ bne x8, x29, fail
+
+test_3:
+ c.lui x9, 0xfffff
+ li x29, 0xfffff000
+ li gp, 3
+ bne x9, x29, fail
+
+test_4:
+ c.li x8, -16
+ c.srai x8, 2
+ li x29, -4
+ li gp, 4
+ bne x8, x29, fail
+
+test_5:
+ c.li x8, -16
+ c.srli x8, 28
+ li x29, 0xf
+ li gp, 5
+ bne x8, x29, fail
+
+test_6:
+ c.li x8, 3
+ c.slli x8, 4
+ li x29, 48
+ li gp, 6
+ bne x8, x29, fail
+
+test_7:
+ c.li x8, 27
+ c.andi x8, 10
+ li x29, 10
+ li gp, 7
+ bne x8, x29, fail
+
+test_8:
+ c.nop
+ c.li x8, 1
+ c.nop
+ li x29, 1
+ li gp, 8
+ bne x8, x29, fail
+
+  #-------------------------------------------------------------
+  # Compressed (RV32C) integer register-register operations
+  #-------------------------------------------------------------
+
+test_9:
+ c.li x10, 7
+ c.mv x11, x10
+ c.add x11, x10
+ li x29, 14
+ li gp, 9
+ bne x11, x29, fail
+
+test_10:
+ c.li x12, 12
+ c.li x13, 10
+ c.mv x14, x12
+ c.sub x14, x13
+ li x29, 2
+ li gp, 10
+ bne x14, x29, fail
+
+test_11:
+ c.mv x14, x12
+ c.xor x14, x13
+ li x29, 6
+ li gp, 11
+ bne x14, x29, fail
+
+test_12:
+ c.mv x14, x12
+ c.or x14, x13
+ li x29, 14
+ li gp, 12
+ bne x14, x29, fail
+
+test_13:
+ c.mv x14, x12
+ c.and x14, x13
+ li x29, 8
+ li gp, 13
+ bne x14, x29, fail
+
+  #-------------------------------------------------------------
+  # Compressed (RV32C) loads and stores
+  #-------------------------------------------------------------
+
+test_14:
+ li sp, 0x10000
+ c.addi16sp sp, -32
+ c.addi4spn x8, sp, 16
+ c.li x9, 21
+ c.sw x9, 4(x8)
+ c.lw x10, 4(x8)
+ li x29, 21
+ li gp, 14
+ bne x10, x29, fail
+
+test_15:
+ c.lwsp x11, 20(sp)
+ li x29, 21
+ li gp, 15
+ bne x11, x29, fail
+
+test_16:
+ c.li x12, -9
+ c.swsp x12, 8(sp)
+ lw x13, 8(sp)
+ li x29, -9
+ li gp, 16
+ bne x13, x29, fail
+
+  #-------------------------------------------------------------
+  # Compressed (RV32C) control transfers
+  #-------------------------------------------------------------
+
+test_17:
+ li gp, 17
+ c.li x8, 0
+ c.beqz x8, test_17_taken
+ j fail
+test_17_taken:
+ c.li x8, 1
+ c.bnez x8, test_17_done
+ j fail
+test_17_done:
+ c.j test_18
+ j fail
+
+test_18:
+ li gp, 18
+ c.li x15, 0
+ c.jal test_18_target
+ c.addi x15, 1
+ c.j test_18_check
+test_18_target:
+ c.addi x15, 2
+ c.jr ra
+test_18_check:
+ li x29, 3
+ bne x15, x29, fail
+
+test_19:
+ li gp, 19
+ c.li x15, 0
+ c.jal test_19_base
+test_19_return:
+ c.addi x15, 1
+ c.j test_19_check
+test_19_base:
+ c.addi x15, 2
+ c.mv x14, ra
+ c.li ra, 0
+ c.jalr x14
+test_19_link:
+ j fail
+test_19_check:
+ li x29, 3
+ bne x15, x29, fail
+ addi x29, x14, 12
+ bne ra, x29, fail
+
+pass:
+ li a0, 42
+ li a7, 93
+ ecall
+
+fail:
+ li a0, 0
+ li a7, 93
+ ecall
@@ -0,0 +1,511 @@
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/coherence.h"
+#include "cachesim/dram.h"
+#include "cachesim/tlbsim.h"
+#include "processorhandler.h"
+
+/** Cache simulator tests
+ *
+ * Known-answer tests of the replacement decisions, prefetchers and miss classification of the cache simulator, of the
+ * coherence model of the private caches of multi-hart systems, and of the TLB and DRAM models. Accesses are replayed
+ * through caches of a single line, such that the resident blocks following a sequence of accesses identify the
+ * evicted ways. Blocks are named by letters; block 'A' is the word at address 0x0, 'B' that at 0x4, and so forth.
+ */
+
+using namespace Ripes;
+
+Q_DECLARE_METATYPE(CacheSim::ReplPolicy)
+
+namespace {
+uint32_t blockAddress(QChar block) {
+    return static_cast<uint32_t>(block.unicode() - 'A') * 4;
+}
+
+std::vector<CacheTraceReader::Access> dataReads(const QString& blocks) {
+    std::vector<CacheTraceReader::Access> accesses;
+    for (const QChar block : blocks) {
+        CacheTraceReader::Access access;
+        access.address = blockAddress(block);
+        accesses.push_back(access);
+    }
+    return accesses;
+}
+
+bool isResident(const CacheSim& cache, uint32_t address) {
+    const auto line = cache.getLine(cache.getLineIdx(address));
+    for (int way = 0; way < cache.getWays(); way++) {
+        if (line.valid(way) && line.tag(way) == cache.getTag(address)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @returns the blocks of @p candidates which are resident in @p cache
+QString residentBlocks(const CacheSim& cache, const QString& candidates) {
+    QString resident;
+    for (const QChar block : candidates) {
+        if (!resident.contains(block) && isResident(cache, blockAddress(block))) {
+            resident += block;
+        }
+    }
+    std::sort(resident.begin(), resident.end());
+    return resident;
+}
+
+/// Preset of a single line of 2^@p ways ways of single word blocks
+CacheSim::CachePreset singleLine(CacheSim::ReplPolicy policy, int ways, uint32_t seed = 0) {
+    return {0, 0, ways, CacheSim::WritePolicy::WriteBack, CacheSim::WriteAllocPolicy::WriteAllocate, policy, seed};
+}
+}  // namespace
+
+class tst_CacheSim : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testReplacementPolicies_data();
+    void testReplacementPolicies();
+    void testRandomReplacementIsSeeded();
+    void testNextLinePrefetcher();
+    void testStridePrefetcher();
+    void testStreamPrefetcher();
+    void testPrefetcherUndo();
+    void testPrefetchStatistics();
+    void testMissClassifier();
+    void testMissClassification_data();
+    void testMissClassification();
+    void testCoherence();
+    void testTLB();
+    void testDRAM();
+    void testDRAMBackedCache();
+};
+
+void tst_CacheSim::testReplacementPolicies_data() {
+    QTest::addColumn<CacheSim::ReplPolicy>("policy");
+    QTest::addColumn<QString>("sequence");
+    QTest::addColumn<QString>("resident");
+    QTest::addColumn<int>("hits");
+
+    using Policy = CacheSim::ReplPolicy;
+    // After filling the four ways, A is re-referenced before E misses
+    QTest::newRow("LRU") << Policy::LRU << "ABCDAE" << "ACDE" << 1;
+    QTest::newRow("FIFO") << Policy::FIFO << "ABCDAE" << "BCDE" << 1;
+    QTest::newRow("PLRU") << Policy::PLRU << "ABCDAE" << "ABDE" << 1;
+    // The FIFO pointer wraps around once all ways have been replaced
+    QTest::newRow("FIFO wrap") << Policy::FIFO << "ABCDEFGHI" << "FGHI" << 0;
+    // A frequently used block is kept by LFU, but is the least recently used block to LRU
+    QTest::newRow("LFU frequent") << Policy::LFU << "AABCDE" << "ACDE" << 1;
+    QTest::newRow("LRU frequent") << Policy::LRU << "AABCDE" << "BCDE" << 1;
+    // SRRIP keeps the re-referenced block A whilst the scan of new blocks replaces one another
+    QTest::newRow("SRRIP scan") << Policy::SRRIP << "AABCDEF" << "ADEF" << 1;
+    QTest::newRow("LRU scan") << Policy::LRU << "AABCDEF" << "CDEF" << 1;
+}
+
+void tst_CacheSim::testReplacementPolicies() {
+    QFETCH(CacheSim::ReplPolicy, policy);
+    QFETCH(QString, sequence);
+    QFETCH(QString, resident);
+    QFETCH(int, hits);
+
+    ProcessorHandler handler;
+    CacheSim cache(&handler, nullptr);
+    cache.setPreset(singleLine(policy, 2));
+    QCOMPARE(cache.replay(dataReads(sequence)), static_cast<unsigned long long>(sequence.size()));
+
+    QCOMPARE(residentBlocks(cache, sequence), resident);
+    const auto stats = cache.getLiveStatistics();
+    QCOMPARE(stats.hits, static_cast<uint64_t>(hits));
+    QCOMPARE(stats.misses, static_cast<uint64_t>(sequence.size() - hits));
+}
+
+void tst_CacheSim::testRandomReplacementIsSeeded() {
+    // Caches of the same seed make the same replacement decisions
+    const QString sequence = "ABCDEFGHIJKLMNOPABCDEFGH";
+    ProcessorHandler handler;
+    CacheSim first(&handler, nullptr);
+    CacheSim second(&handler, nullptr);
+    first.setPreset(singleLine(CacheSim::ReplPolicy::Random, 2, 7));
+    second.setPreset(singleLine(CacheSim::ReplPolicy::Random, 2, 7));
+    first.replay(dataReads(sequence));
+    second.replay(dataReads(sequence));
+
+    const auto firstLine = first.getLine(0);
+    const auto secondLine = second.getLine(0);
+    for (int way = 0; way < first.getWays(); way++) {
+        QCOMPARE(firstLine.valid(way), secondLine.valid(way));
+        if (firstLine.valid(way)) {
+            QCOMPARE(firstLine.tag(way), secondLine.tag(way));
+        }
+    }
+    QCOMPARE(first.getLiveStatistics().hits, second.getLiveStatistics().hits);
+
+    // Replaying anew resets the cache, and reproduces the decisions of the first replay
+    const QString resident = residentBlocks(first, sequence);
+    first.replay(dataReads(sequence));
+    QCOMPARE(residentBlocks(first, sequence), resident);
+}
+
+void tst_CacheSim::testNextLinePrefetcher() {
+    Prefetcher prefetcher;
+    prefetcher.configure({Prefetcher::Type::NextLine, 2, 1}, 0);
+    std::vector<uint32_t> prefetches;
+
+    prefetcher.observe(0x0, 0x100, true, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x104, 0x108}));
+    // Only triggers prefetch
+    prefetcher.observe(0x0, 0x100, false, prefetches);
+    QVERIFY(prefetches.empty());
+    // Blocks beyond the address space are not prefetched
+    prefetcher.observe(0x0, 0xfffffffc, true, prefetches);
+    QVERIFY(prefetches.empty());
+
+    // The distance is counted in blocks
+    prefetcher.configure({Prefetcher::Type::NextLine, 1, 2}, 2);
+    prefetcher.observe(0x0, 0x104, true, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x120}));
+}
+
+void tst_CacheSim::testStridePrefetcher() {
+    Prefetcher prefetcher;
+    prefetcher.configure({Prefetcher::Type::Stride, 1, 1}, 0);
+    std::vector<uint32_t> prefetches;
+
+    // The first access allocates an entry, the second sets its stride, and the stride is confirmed twice before
+    // prefetching
+    for (const uint32_t address : {0x1000, 0x1010, 0x1020}) {
+        prefetcher.observe(0x40, address, false, prefetches);
+        QVERIFY(prefetches.empty());
+    }
+    prefetcher.observe(0x40, 0x1030, false, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x1040}));
+
+    // Other instructions are tracked by entries of their own
+    prefetcher.observe(0x44, 0x2000, false, prefetches);
+    QVERIFY(prefetches.empty());
+    prefetcher.observe(0x40, 0x1040, false, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x1050}));
+
+    // A differing stride lowers the confidence of the entry before replacing its stride
+    prefetcher.observe(0x40, 0x1044, false, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x1054}));
+    prefetcher.observe(0x40, 0x1048, false, prefetches);
+    QVERIFY(prefetches.empty());
+}
+
+void tst_CacheSim::testStreamPrefetcher() {
+    Prefetcher prefetcher;
+    prefetcher.configure({Prefetcher::Type::Stream, 2, 1}, 0);
+    std::vector<uint32_t> prefetches;
+
+    // An ascending stream is confirmed by its third trigger
+    for (const uint32_t address : {0x400, 0x404}) {
+        prefetcher.observe(0x0, address, true, prefetches);
+        QVERIFY(prefetches.empty());
+    }
+    prefetcher.observe(0x0, 0x408, true, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x40c, 0x410}));
+
+    // Accesses which are not triggers do not train the streams
+    prefetcher.observe(0x0, 0x40c, false, prefetches);
+    QVERIFY(prefetches.empty());
+
+    // A descending stream, outside of the window of the ascending stream, is tracked separately
+    for (const uint32_t address : {0x1000, 0xffc}) {
+        prefetcher.observe(0x0, address, true, prefetches);
+        QVERIFY(prefetches.empty());
+    }
+    prefetcher.observe(0x0, 0xff8, true, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0xff4, 0xff0}));
+
+    prefetcher.observe(0x0, 0x40c, true, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x410, 0x414}));
+}
+
+void tst_CacheSim::testPrefetcherUndo() {
+    Prefetcher prefetcher;
+    prefetcher.configure({Prefetcher::Type::Stride, 1, 1}, 0);
+    std::vector<uint32_t> prefetches;
+    for (const uint32_t address : {0x1000, 0x1010, 0x1020}) {
+        prefetcher.observe(0x40, address, false, prefetches);
+    }
+
+    // Undoing an access restores the entry it trained, such that observing the access anew predicts the same
+    const auto undo = prefetcher.observe(0x40, 0x1030, false, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x1040}));
+    prefetcher.undo(undo);
+    prefetcher.observe(0x40, 0x1030, false, prefetches);
+    QCOMPARE(prefetches, (std::vector<uint32_t>{0x1040}));
+}
+
+void tst_CacheSim::testPrefetchStatistics() {
+    // A direct mapped cache of four single word blocks, behind a next-line prefetcher
+    ProcessorHandler handler;
+    CacheSim cache(&handler, nullptr);
+    cache.setPreset({0, 2, 0, CacheSim::WritePolicy::WriteBack, CacheSim::WriteAllocPolicy::WriteAllocate,
+                     CacheSim::ReplPolicy::LRU});
+    cache.setPrefetcher({Prefetcher::Type::NextLine, 1, 1});
+
+    // The miss of A prefetches B, whose first demand hit triggers the prefetch of C. D is not prefetched.
+    cache.replay(dataReads("ABC"));
+    auto stats = cache.getLiveStatistics();
+    QCOMPARE(stats.misses, uint64_t(1));
+    QCOMPARE(stats.hits, uint64_t(2));
+    QCOMPARE(stats.prefetches, uint64_t(3));
+    QCOMPARE(stats.usefulPrefetches, uint64_t(2));
+    QVERIFY(isResident(cache, blockAddress('D')));
+
+    // The prefetch of D displaces H, which in turn evicts D before it is demanded
+    cache.replay(dataReads("HABCH"));
+    stats = cache.getLiveStatistics();
+    QCOMPARE(stats.misses, uint64_t(3));
+    QCOMPARE(stats.usefulPrefetches, uint64_t(2));
+    QCOMPARE(stats.pollutingPrefetches, uint64_t(1));
+}
+
+void tst_CacheSim::testMissClassifier() {
+    // Shadow cache of two single word blocks
+    MissClassifier classifier;
+    classifier.configure(0, 2);
+
+    using MissType = MissClassifier::MissType;
+    const QString sequence = "ABACBAB";
+    const std::vector<MissType> expected = {MissType::Compulsory, MissType::Compulsory, MissType::Conflict,
+                                            MissType::Compulsory, MissType::Capacity,   MissType::Capacity,
+                                            MissType::Conflict};
+    std::vector<MissClassifier::Undo> undos(sequence.size());
+    for (int i = 0; i < sequence.size(); i++) {
+        QCOMPARE(classifier.access(blockAddress(sequence.at(i)), undos[i]), expected[i]);
+    }
+
+    // Undoing "BAB" leaves C and A in the shadow cache, such that B is a capacity miss rather than a conflict miss
+    for (int i = sequence.size() - 1; i >= 4; i--) {
+        classifier.undo(undos[i]);
+    }
+    MissClassifier::Undo undo;
+    QCOMPARE(classifier.access(blockAddress('B'), undo), MissType::Capacity);
+    classifier.undo(undo);
+
+    // Undoing all accesses forgets that the blocks were ever touched
+    for (int i = 3; i >= 0; i--) {
+        classifier.undo(undos[i]);
+    }
+    QCOMPARE(classifier.access(blockAddress('A'), undo), MissType::Compulsory);
+}
+
+void tst_CacheSim::testMissClassification_data() {
+    QTest::addColumn<QString>("sequence");
+    QTest::addColumn<int>("compulsory");
+    QTest::addColumn<int>("capacity");
+    QTest::addColumn<int>("conflict");
+
+    // A and C map to the same line of a direct mapped cache of two lines, B to the other line
+    QTest::newRow("conflict") << "ACA" << 2 << 0 << 1;
+    QTest::newRow("capacity") << "ABCA" << 3 << 1 << 0;
+    QTest::newRow("hits") << "ABAB" << 2 << 0 << 0;
+}
+
+void tst_CacheSim::testMissClassification() {
+    QFETCH(QString, sequence);
+    QFETCH(int, compulsory);
+    QFETCH(int, capacity);
+    QFETCH(int, conflict);
+
+    ProcessorHandler handler;
+    CacheSim cache(&handler, nullptr);
+    cache.setPreset({0, 1, 0, CacheSim::WritePolicy::WriteBack, CacheSim::WriteAllocPolicy::WriteAllocate,
+                     CacheSim::ReplPolicy::LRU});
+    cache.replay(dataReads(sequence));
+
+    const auto stats = cache.getLiveStatistics();
+    QCOMPARE(stats.compulsoryMisses, static_cast<uint64_t>(compulsory));
+    QCOMPARE(stats.capacityMisses, static_cast<uint64_t>(capacity));
+    QCOMPARE(stats.conflictMisses, static_cast<uint64_t>(conflict));
+    // Every demand miss is classified
+    QCOMPARE(stats.misses, static_cast<uint64_t>(compulsory + capacity + conflict));
+}
+
+void tst_CacheSim::testCoherence() {
+    // Two harts with caches of four sets of two ways of four word blocks. 0x0, 0x40, 0x80 and 0x100 map to set 0.
+    CoherenceModel model(2, 2, 1, 2);
+    using State = CoherenceModel::State;
+
+    // The first reader holds the block exclusively, until the block is read by another hart
+    model.access(0, 0x0, false);
+    QCOMPARE(model.state(0, 0x0), State::Exclusive);
+    QCOMPARE(model.state(1, 0x0), State::Invalid);
+    model.access(1, 0x0, false);
+    QCOMPARE(model.state(0, 0x0), State::Shared);
+    QCOMPARE(model.state(1, 0x0), State::Shared);
+
+    // Writing a shared block upgrades it, invalidating the other copy
+    model.access(0, 0x0, true);
+    QCOMPARE(model.state(0, 0x0), State::Modified);
+    QCOMPARE(model.state(1, 0x0), State::Invalid);
+
+    // Reading another word of the block is a false sharing miss, which downgrades the modified copy
+    model.access(1, 0x4, false);
+    QCOMPARE(model.state(0, 0x0), State::Shared);
+    QCOMPARE(model.state(1, 0x4), State::Shared);
+
+    // Reading a word which was written by the other hart is a true sharing miss
+    model.access(1, 0x8, true);
+    QCOMPARE(model.state(0, 0x8), State::Invalid);
+    model.access(0, 0x8, false);
+    QCOMPARE(model.state(1, 0x8), State::Shared);
+
+    // Blocks which no other cache holds are written silently. Evicting the modified block writes it back.
+    model.access(0, 0x40, true);
+    QCOMPARE(model.state(0, 0x40), State::Modified);
+    model.access(0, 0x80, false);
+    QCOMPARE(model.state(0, 0x0), State::Invalid);
+    model.access(0, 0x100, false);
+    QCOMPARE(model.state(0, 0x40), State::Invalid);
+    QCOMPARE(model.state(0, 0x80), State::Exclusive);
+
+    const auto& hart0 = model.statistics(0);
+    QCOMPARE(hart0.reads, uint64_t(4));
+    QCOMPARE(hart0.writes, uint64_t(2));
+    QCOMPARE(hart0.misses, uint64_t(5));
+    QCOMPARE(hart0.coherenceMisses, uint64_t(1));
+    QCOMPARE(hart0.falseSharingMisses, uint64_t(0));
+    QCOMPARE(hart0.upgrades, uint64_t(1));
+    QCOMPARE(hart0.invalidations, uint64_t(1));
+    QCOMPARE(hart0.writebacks, uint64_t(2));
+    QCOMPARE(hart0.cacheToCacheTransfers, uint64_t(1));
+
+    const auto& hart1 = model.statistics(1);
+    QCOMPARE(hart1.reads, uint64_t(2));
+    QCOMPARE(hart1.writes, uint64_t(1));
+    QCOMPARE(hart1.misses, uint64_t(2));
+    QCOMPARE(hart1.coherenceMisses, uint64_t(1));
+    QCOMPARE(hart1.falseSharingMisses, uint64_t(1));
+    QCOMPARE(hart1.upgrades, uint64_t(1));
+    QCOMPARE(hart1.invalidations, uint64_t(1));
+    QCOMPARE(hart1.writebacks, uint64_t(1));
+    QCOMPARE(hart1.cacheToCacheTransfers, uint64_t(2));
+    QCOMPARE(hart1.missRate(), 2.0 / 3.0);
+
+    // All coherence traffic is that of the block at 0x0
+    const auto lines = model.lines();
+    QCOMPARE(lines.size(), size_t(1));
+    QCOMPARE(lines.front().address, 0x0u);
+    QCOMPARE(lines.front().invalidations, uint64_t(2));
+    QCOMPARE(lines.front().coherenceMisses, uint64_t(2));
+    QCOMPARE(lines.front().falseSharingMisses, uint64_t(1));
+}
+
+void tst_CacheSim::testTLB() {
+    ProcessorHandler handler;
+    TLBSim tlb(&handler, TLBSim::TLBType::DataTLB);
+    // A single set of two entries
+    tlb.setConfig({0, 1, CacheSim::ReplPolicy::LRU, 20});
+    QCOMPARE(tlb.getEntries(), 2u);
+    QCOMPARE(tlb.getReach(), uint64_t(0x2000));
+
+    // Pages 0 and 1 miss, whereupon the micro-TLB is flushed. Page 0 then hits in the TLB, and is refilled into the
+    // micro-TLB, whereas page 2 evicts page 1 from the TLB.
+    for (const uint32_t address : {0x0000, 0x0ffc, 0x1000, 0x0004, 0x1008, 0x2000}) {
+        tlb.translate(address);
+    }
+    QCOMPARE(tlb.getMicroHits(), uint64_t(2));
+    QCOMPARE(tlb.getHits(), uint64_t(3));
+    QCOMPARE(tlb.getMisses(), uint64_t(3));
+    QCOMPARE(tlb.getAccesses(), uint64_t(6));
+    QCOMPARE(tlb.getHitRate(), 0.5);
+    QCOMPARE(tlb.getWalkCycles(), uint64_t(60));
+
+    // Only misses stall for the page walk
+    QCOMPARE(tlb.getStallCycles(0x2000), 0u);
+    QCOMPARE(tlb.getStallCycles(0x0000), 0u);
+    QCOMPARE(tlb.getStallCycles(0x1000), 20u);
+
+    // Pages 0 and 8 share an entry of the micro-TLB, but not of a TLB of eight entries
+    tlb.setConfig({2, 1, CacheSim::ReplPolicy::LRU, 20});
+    for (const uint32_t address : {0x0000, 0x8000, 0x0000}) {
+        tlb.translate(address);
+    }
+    QCOMPARE(tlb.getMicroHits(), uint64_t(0));
+    QCOMPARE(tlb.getHits(), uint64_t(1));
+    QCOMPARE(tlb.getMisses(), uint64_t(2));
+
+    // Resetting the processor flushes the TLB and its micro-TLB
+    handler.getProcessorNonConst()->reset();
+    QCOMPARE(tlb.getAccesses(), uint64_t(0));
+    QCOMPARE(tlb.getStallCycles(0x0000), 20u);
+}
+
+void tst_CacheSim::testDRAM() {
+    // Two banks of rows of 16 bytes; 0x0-0xf is row 0 of bank 0, 0x10-0x1f row 0 of bank 1, 0x20-0x2f row 1 of bank 0
+    DRAMModel::Config config{1, 4, DRAMModel::PagePolicy::Open, 2, 3, 5};
+    DRAMModel dram(config);
+    QCOMPARE(dram.getAverageReadLatency(), 5.0);
+
+    QCOMPARE(dram.access(0x00, false), 5u);   // Empty bank
+    QCOMPARE(dram.access(0x04, false), 3u);   // Row hit
+    QCOMPARE(dram.access(0x10, true), 5u);    // Empty bank
+    QCOMPARE(dram.access(0x20, false), 10u);  // Row conflict
+    QCOMPARE(dram.access(0x08, false), 10u);  // Row conflict
+    QCOMPARE(dram.latency(0x0c), 3u);
+    QCOMPARE(dram.latency(0x30), 10u);
+
+    const auto& stats = dram.getStatistics();
+    QCOMPARE(stats.reads, uint64_t(4));
+    QCOMPARE(stats.writes, uint64_t(1));
+    QCOMPARE(stats.rowHits, uint64_t(1));
+    QCOMPARE(stats.rowEmpty, uint64_t(2));
+    QCOMPARE(stats.rowConflicts, uint64_t(2));
+    QCOMPARE(stats.readLatency, uint64_t(28));
+    QCOMPARE(dram.getAverageReadLatency(), 7.0);
+    QCOMPARE(stats.rowHitRate(), 0.2);
+
+    // Resetting closes all rows and clears the statistics
+    dram.reset();
+    QCOMPARE(dram.latency(0x08), 5u);
+    QCOMPARE(dram.getStatistics().accesses(), uint64_t(0));
+    QCOMPARE(dram.getAverageReadLatency(), 5.0);
+
+    // Warming up opens rows without counting accesses
+    dram.warmup(0x40);
+    QCOMPARE(dram.latency(0x44), 3u);
+    QCOMPARE(dram.getStatistics().accesses(), uint64_t(0));
+
+    // Under the closed-page policy, all accesses find their bank precharged
+    config.policy = DRAMModel::PagePolicy::Closed;
+    dram.setConfig(config);
+    for (const uint32_t address : {0x00, 0x04, 0x20}) {
+        QCOMPARE(dram.access(address, false), 5u);
+    }
+    QCOMPARE(dram.getStatistics().rowEmpty, uint64_t(3));
+}
+
+void tst_CacheSim::testDRAMBackedCache() {
+    ProcessorHandler handler;
+    DRAMModel dram({1, 4, DRAMModel::PagePolicy::Open, 2, 3, 5});
+    CacheSim cache(&handler, nullptr);
+    // Four lines of single word blocks, such that A and Q (0x40) share line 0
+    cache.setPreset({0, 2, 0, CacheSim::WritePolicy::WriteBack, CacheSim::WriteAllocPolicy::WriteAllocate,
+                     CacheSim::ReplPolicy::LRU});
+    cache.setDRAM(&dram);
+
+    // The fills of A, B and Q, and the fill of A followed by the writeback of the dirty Q which it evicts
+    auto accesses = dataReads("ABQA");
+    accesses.at(2).write = true;
+    cache.replay(accesses);
+
+    const auto& stats = dram.getStatistics();
+    QCOMPARE(stats.reads, uint64_t(4));
+    QCOMPARE(stats.writes, uint64_t(1));
+    QCOMPARE(stats.readLatency, uint64_t(5 + 3 + 10 + 10));
+    QCOMPARE(stats.rowConflicts, uint64_t(3));
+
+    // Misses cost the DRAM latency of the current state of its row buffers, in which the row of Q is open in bank 0
+    QCOMPARE(cache.getMissPenalty(blockAddress('C'), CacheSim::AccessType::Read), 10u);
+    QCOMPARE(cache.getMissPenalty(blockAddress('A'), CacheSim::AccessType::Read), 0u);
+}
+
+QTEST_APPLESS_MAIN(tst_CacheSim)
+#include "tst_cachesim.moc"
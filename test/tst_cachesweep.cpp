@@ -0,0 +1,167 @@
+#include <QtTest/QTest>
+
+#include <tuple>
+
+#include "cachesim/cachesweep.h"
+#include "processorhandler.h"
+
+/** Cache sweep tests
+ *
+ * Covers the parsing of sweep grids into cache configurations, and that sweeping a trace through several
+ * configurations concurrently yields the results of replaying the trace through each configuration on its own.
+ */
+
+using namespace Ripes;
+
+namespace {
+const CacheSim::CachePreset s_defaults{2, 4, 1, CacheSim::WritePolicy::WriteBack,
+                                       CacheSim::WriteAllocPolicy::WriteAllocate, CacheSim::ReplPolicy::LRU};
+
+/// @returns a data access trace of the accesses in @p accesses; "R" or "W" followed by the address, per access
+std::vector<CacheTraceReader::Access> dataTrace(const QStringList& accesses) {
+    std::vector<CacheTraceReader::Access> trace;
+    for (const auto& access : accesses) {
+        CacheTraceReader::Access traced;
+        traced.write = access.startsWith('W');
+        traced.address = access.mid(1).toUInt(nullptr, 16);
+        trace.push_back(traced);
+    }
+    return trace;
+}
+
+CacheSweepConfig sweepConfig(int lines, int ways) {
+    CacheSweepConfig config;
+    config.preset = s_defaults;
+    config.preset.blocks = 0;
+    config.preset.lines = lines;
+    config.preset.ways = ways;
+    return config;
+}
+}  // namespace
+
+class tst_CacheSweep : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testGrid();
+    void testGridLimits();
+    void testInvalidGrid_data();
+    void testInvalidGrid();
+    void testSweep();
+};
+
+void tst_CacheSweep::testGrid() {
+    std::vector<CacheSim::CachePreset> presets;
+    QString error;
+
+    // Parameters not given keep their default value
+    QVERIFY(parseCacheSweep("", s_defaults, presets, error));
+    QCOMPARE(presets.size(), size_t(1));
+    QCOMPARE(presets.at(0).lines, s_defaults.lines);
+    QCOMPARE(presets.at(0).wrPolicy, s_defaults.wrPolicy);
+
+    // The cartesian product of all parameters, varying the last parameter fastest
+    QVERIFY(parseCacheSweep(" lines=2-3 ; ways=0,1;repl=LRU, fifo;", s_defaults, presets, error));
+    QCOMPARE(presets.size(), size_t(8));
+    const std::vector<std::tuple<int, int, CacheSim::ReplPolicy>> expected = {
+        {2, 0, CacheSim::ReplPolicy::LRU}, {2, 0, CacheSim::ReplPolicy::FIFO}, {2, 1, CacheSim::ReplPolicy::LRU},
+        {2, 1, CacheSim::ReplPolicy::FIFO}, {3, 0, CacheSim::ReplPolicy::LRU}, {3, 0, CacheSim::ReplPolicy::FIFO},
+        {3, 1, CacheSim::ReplPolicy::LRU}, {3, 1, CacheSim::ReplPolicy::FIFO}};
+    for (size_t i = 0; i < expected.size(); i++) {
+        QCOMPARE(presets.at(i).lines, std::get<0>(expected.at(i)));
+        QCOMPARE(presets.at(i).ways, std::get<1>(expected.at(i)));
+        QCOMPARE(presets.at(i).replPolicy, std::get<2>(expected.at(i)));
+        QCOMPARE(presets.at(i).blocks, s_defaults.blocks);
+    }
+
+    QVERIFY(parseCacheSweep("write=wb,wt;alloc=nwa", s_defaults, presets, error));
+    QCOMPARE(presets.size(), size_t(2));
+    QCOMPARE(presets.at(0).wrPolicy, CacheSim::WritePolicy::WriteBack);
+    QCOMPARE(presets.at(1).wrPolicy, CacheSim::WritePolicy::WriteThrough);
+    QCOMPARE(presets.at(1).wrAllocPolicy, CacheSim::WriteAllocPolicy::NoWriteAllocate);
+}
+
+void tst_CacheSweep::testGridLimits() {
+    std::vector<CacheSim::CachePreset> presets;
+    QString error;
+
+    // Configurations whose line and block indices exceed the address are omitted
+    QVERIFY(parseCacheSweep("lines=20;blocks=8-12", s_defaults, presets, error));
+    QCOMPARE(presets.size(), size_t(3));
+    QCOMPARE(presets.back().blocks, 10);
+
+    // As are configurations of more than 2^24 ways in total
+    QVERIFY(parseCacheSweep("lines=20;ways=3-5", s_defaults, presets, error));
+    QCOMPARE(presets.size(), size_t(2));
+    QCOMPARE(presets.back().ways, 4);
+}
+
+void tst_CacheSweep::testInvalidGrid_data() {
+    QTest::addColumn<QString>("grid");
+
+    QTest::newRow("unknown parameter") << "size=4";
+    QTest::newRow("missing value") << "lines";
+    QTest::newRow("missing parameter") << "=4";
+    QTest::newRow("descending range") << "lines=4-2";
+    QTest::newRow("ternary range") << "lines=1-2-3";
+    QTest::newRow("negative") << "ways=-1";
+    QTest::newRow("out of range") << "blocks=32";
+    QTest::newRow("not a number") << "lines=two";
+    QTest::newRow("unknown policy") << "repl=lru,mru";
+    QTest::newRow("unknown write policy") << "write=wa";
+}
+
+void tst_CacheSweep::testInvalidGrid() {
+    QFETCH(QString, grid);
+
+    // The presets of a prior parse are untouched by an invalid grid
+    std::vector<CacheSim::CachePreset> presets;
+    QString error;
+    QVERIFY(parseCacheSweep("lines=2,3", s_defaults, presets, error));
+    QVERIFY(!parseCacheSweep("ways=1;" + grid, s_defaults, presets, error));
+    QCOMPARE(error, QString("Invalid sweep parameter '%1'").arg(grid));
+    QCOMPARE(presets.size(), size_t(2));
+}
+
+void tst_CacheSweep::testSweep() {
+    // 0x0 and 0x100 map to the same line of a direct mapped cache of four single word blocks, such that the dirty
+    // block of 0x100 is written back when evicted by 0x0. A two-way cache of the same size holds both.
+    const auto trace = dataTrace({"R0", "W100", "R0", "R100"});
+    std::vector<CacheSweepConfig> configs = {sweepConfig(2, 0), sweepConfig(1, 1), sweepConfig(0, 0)};
+    configs.back().type = CacheSim::CacheType::InstrCache;
+    configs.back().memoryLatency = 10;
+
+    const auto results = sweepCaches(trace, configs, 2);
+    QCOMPARE(results.size(), configs.size());
+
+    QCOMPARE(results.at(0).hits, uint64_t(0));
+    QCOMPARE(results.at(0).misses, uint64_t(4));
+    QCOMPARE(results.at(0).writebacks, uint64_t(1));
+    QCOMPARE(results.at(0).hitRate, 0.0);
+    QCOMPARE(results.at(1).hits, uint64_t(2));
+    QCOMPARE(results.at(1).misses, uint64_t(2));
+    QCOMPARE(results.at(1).writebacks, uint64_t(0));
+    QCOMPARE(results.at(1).hitRate, 0.5);
+    // Instruction caches do not observe data accesses
+    QCOMPARE(results.at(2).hits + results.at(2).misses, uint64_t(0));
+
+    // Each result is that of replaying the trace through its configuration alone
+    for (size_t i = 0; i < configs.size(); i++) {
+        ProcessorHandler handler;
+        CacheSim cache(&handler, nullptr);
+        cache.setType(configs.at(i).type);
+        cache.setPreset(configs.at(i).preset);
+        cache.setHitLatency(configs.at(i).hitLatency);
+        cache.setMemoryLatency(configs.at(i).memoryLatency);
+        cache.replay(trace);
+        QCOMPARE(results.at(i).config.preset.lines, configs.at(i).preset.lines);
+        QCOMPARE(results.at(i).sizeBits, cache.getCacheSize().bits);
+        QCOMPARE(results.at(i).hits, cache.getHits());
+        QCOMPARE(results.at(i).misses, cache.getMisses());
+        QCOMPARE(results.at(i).writebacks, cache.getWritebacks());
+        QCOMPARE(results.at(i).averageAccessTime, cache.getAverageAccessTime());
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_CacheSweep)
+#include "tst_cachesweep.moc"
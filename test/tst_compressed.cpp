@@ -0,0 +1,208 @@
+#include <QtTest/QTest>
+
+#include "assembler.h"
+#include "parser.h"
+#include "processors/RISC-V/rv_compressed.h"
+
+/** Compressed (RV32C) instruction tests
+ *
+ * Covers the assembly of compressed instructions, the rejection of operands which a compressed instruction cannot
+ * encode, their disassembly and the layout of text sections of mixed instruction sizes. Execution of compressed
+ * instructions is covered by the rvc test program of the RISC-V test suite.
+ */
+
+using namespace Ripes;
+
+namespace {
+/// @returns the text segment of assembling @p lines, or a null byte array if assembly failed
+QByteArray assemble(const QStringList& lines) {
+    Assembler assembler;
+    const QByteArray text = assembler.assemble(lines);
+    return assembler.hasError() ? QByteArray() : text;
+}
+
+/// @returns the halfwords of @p text
+std::vector<uint32_t> halfwords(const QByteArray& text) {
+    std::vector<uint32_t> values;
+    for (int i = 0; i + 1 < text.size(); i += 2) {
+        values.push_back(static_cast<uint8_t>(text.at(i)) | static_cast<uint8_t>(text.at(i + 1)) << 8);
+    }
+    return values;
+}
+
+QByteArray littleEndian(const std::vector<std::pair<uint32_t, unsigned>>& instructions) {
+    QByteArray text;
+    for (const auto& [instr, size] : instructions) {
+        for (unsigned i = 0; i < size; i++) {
+            text.append(static_cast<char>(instr >> (i * 8)));
+        }
+    }
+    return text;
+}
+}  // namespace
+
+class tst_Compressed : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testAssemble_data();
+    void testAssemble();
+    void testAssembleControlTransfers();
+    void testInvalidOperands_data();
+    void testInvalidOperands();
+    void testDisassemble_data();
+    void testDisassemble();
+    void testInstructionLayout();
+};
+
+void tst_Compressed::testAssemble_data() {
+    QTest::addColumn<QString>("source");
+    QTest::addColumn<uint32_t>("encoding");
+    QTest::addColumn<uint32_t>("expansion");
+
+    QTest::newRow("c.nop") << "c.nop" << 0x0001u << 0x00000013u;
+    QTest::newRow("c.addi") << "c.addi x2 -16" << 0x1141u << 0xff010113u;
+    QTest::newRow("c.addi4spn") << "c.addi4spn x10 x2 4" << 0x0048u << 0x00410513u;
+    QTest::newRow("c.lw") << "c.lw x10 0(x11)" << 0x4188u << 0x0005a503u;
+    QTest::newRow("c.sw") << "c.sw x10 0(x11)" << 0xc188u << 0x00a5a023u;
+    QTest::newRow("c.li") << "c.li x10 1" << 0x4505u << 0x00100513u;
+    QTest::newRow("c.lui") << "c.lui x10 1" << 0x6505u << 0x00001537u;
+    QTest::newRow("c.addi16sp") << "c.addi16sp x2 -48" << 0x7179u << 0xfd010113u;
+    QTest::newRow("c.sub") << "c.sub x10 x11" << 0x8d0du << 0x40b50533u;
+    QTest::newRow("c.srai") << "c.srai x10 1" << 0x8505u << 0x40155513u;
+    QTest::newRow("c.slli") << "c.slli x10 2" << 0x050au << 0x00251513u;
+    QTest::newRow("c.lwsp") << "c.lwsp x10 12(x2)" << 0x4532u << 0x00c12503u;
+    QTest::newRow("c.swsp") << "c.swsp x10 12(x2)" << 0xc62au << 0x00a12623u;
+    QTest::newRow("c.jr") << "c.jr x1" << 0x8082u << 0x00008067u;
+    QTest::newRow("c.jalr") << "c.jalr x1" << 0x9082u << 0x000080e7u;
+    QTest::newRow("c.mv") << "c.mv x10 x11" << 0x852eu << 0x00b00533u;
+    QTest::newRow("c.add") << "c.add x10 x11" << 0x952eu << 0x00b50533u;
+}
+
+void tst_Compressed::testAssemble() {
+    QFETCH(QString, source);
+    QFETCH(uint32_t, encoding);
+    QFETCH(uint32_t, expansion);
+
+    const QByteArray text = assemble({source});
+    QCOMPARE(text.size(), 2);
+    QCOMPARE(halfwords(text).front(), encoding);
+    QCOMPARE(expandCompressed(encoding), expansion);
+}
+
+void tst_Compressed::testAssembleControlTransfers() {
+    // Offsets are relative to the compressed instruction, and account for the sizes of the preceding instructions
+    const QByteArray text = assemble({"loop:", "c.nop", "addi x10 x10 1", "c.bnez x10 loop", "c.j loop"});
+    QCOMPARE(text.size(), 10);
+    const auto values = halfwords(text);
+    QCOMPARE(expandCompressed(values[3]), 0xfe051de3u);  // bne x10, x0, -6
+    QCOMPARE(expandCompressed(values[4]), 0xff9ff06fu);  // jal x0, -8
+}
+
+void tst_Compressed::testInvalidOperands_data() {
+    QTest::addColumn<QStringList>("source");
+
+    // Registers of the CIW, CL, CS, CA and CB formats are restricted to x8-x15
+    QTest::newRow("c.lw rd") << QStringList{"c.lw x7 0(x8)"};
+    QTest::newRow("c.lw rs1") << QStringList{"c.lw x8 0(x16)"};
+    QTest::newRow("c.sw rs2") << QStringList{"c.sw x16 0(x8)"};
+    QTest::newRow("c.sw rs1") << QStringList{"c.sw x8 0(x2)"};
+    QTest::newRow("c.addi4spn rd") << QStringList{"c.addi4spn x1 x2 4"};
+    QTest::newRow("c.srli") << QStringList{"c.srli x5 1"};
+    QTest::newRow("c.srai") << QStringList{"c.srai x16 1"};
+    QTest::newRow("c.andi") << QStringList{"c.andi x1 1"};
+    QTest::newRow("c.sub rd") << QStringList{"c.sub x1 x9"};
+    QTest::newRow("c.xor rs2") << QStringList{"c.xor x9 x17"};
+    QTest::newRow("c.or rd") << QStringList{"c.or x0 x9"};
+    QTest::newRow("c.and rs2") << QStringList{"c.and x9 x31"};
+    QTest::newRow("c.beqz") << QStringList{"loop:", "c.beqz x16 loop"};
+    QTest::newRow("c.bnez") << QStringList{"loop:", "c.bnez x7 loop"};
+
+    // Reserved and unimplemented encodings, and immediates which cannot be encoded
+    QTest::newRow("c.ebreak") << QStringList{"c.jalr x0"};
+    QTest::newRow("c.jr x0") << QStringList{"c.jr x0"};
+    QTest::newRow("c.addi4spn zero") << QStringList{"c.addi4spn x8 x2 0"};
+    QTest::newRow("c.lw misaligned") << QStringList{"c.lw x8 2(x9)"};
+    QTest::newRow("c.lwsp base") << QStringList{"c.lwsp x8 4(x3)"};
+    QTest::newRow("c.mv x0") << QStringList{"c.mv x8 x0"};
+}
+
+void tst_Compressed::testInvalidOperands() {
+    QFETCH(QStringList, source);
+
+    Assembler assembler;
+    assembler.assemble(source);
+    QVERIFY(assembler.hasError());
+}
+
+void tst_Compressed::testDisassemble_data() {
+    QTest::addColumn<uint32_t>("encoding");
+    QTest::addColumn<QString>("disassembly");
+
+    QTest::newRow("c.nop") << 0x0001u << "c.nop";
+    QTest::newRow("c.addi") << 0x1141u << "c.addi x2 -16";
+    QTest::newRow("c.addi4spn") << 0x0048u << "c.addi4spn x10 x2 4";
+    QTest::newRow("c.lw") << 0x4188u << "c.lw x10 0(x11)";
+    QTest::newRow("c.sw") << 0xc188u << "c.sw x10 0(x11)";
+    QTest::newRow("c.li") << 0x4505u << "c.li x10 1";
+    QTest::newRow("c.addi16sp") << 0x7179u << "c.addi16sp x2 -48";
+    QTest::newRow("c.sub") << 0x8d0du << "c.sub x10 x11";
+    QTest::newRow("c.srai") << 0x8505u << "c.srai x10 1";
+    QTest::newRow("c.slli") << 0x050au << "c.slli x10 2";
+    QTest::newRow("c.lwsp") << 0x4532u << "c.lwsp x10 12(x2)";
+    QTest::newRow("c.swsp") << 0xc62au << "c.swsp x10 12(x2)";
+    QTest::newRow("c.jr") << 0x8082u << "c.jr x1";
+    QTest::newRow("c.jalr") << 0x9082u << "c.jalr x1";
+    QTest::newRow("c.mv") << 0x852eu << "c.mv x10 x11";
+    QTest::newRow("c.add") << 0x952eu << "c.add x10 x11";
+}
+
+void tst_Compressed::testDisassemble() {
+    QFETCH(uint32_t, encoding);
+    QFETCH(QString, disassembly);
+
+    Program program;
+    QCOMPARE(Parser::getParser()->disassemble(program, encoding, 0, true), disassembly);
+
+    // The disassembly assembles back into the same instruction
+    const QByteArray text = assemble({disassembly});
+    QCOMPARE(text.size(), 2);
+    QCOMPARE(halfwords(text).front(), encoding);
+}
+
+void tst_Compressed::testInstructionLayout() {
+    Program program;
+    // c.ebreak is not implemented, and the all-zero halfword is illegal
+    QCOMPARE(Parser::getParser()->disassemble(program, 0x9002, 0, true), QString("Invalid instruction"));
+    QCOMPARE(Parser::getParser()->disassemble(program, 0x0000, 0, true), QString("Invalid instruction"));
+
+    // addi, c.nop, addi, c.nop
+    const QByteArray mixed = littleEndian({{0x00150513, 4}, {0x0001, 2}, {0x00150513, 4}, {0x0001, 2}});
+    const InstructionLayout layout(mixed, true);
+    QCOMPARE(layout.count(), 4u);
+    QCOMPARE(layout.offset(0), 0u);
+    QCOMPARE(layout.offset(1), 4u);
+    QCOMPARE(layout.offset(2), 6u);
+    QCOMPARE(layout.offset(3), 10u);
+    // Offsets within an instruction map to the instruction containing them
+    QCOMPARE(layout.index(0), 0);
+    QCOMPARE(layout.index(5), 1);
+    QCOMPARE(layout.index(8), 2);
+    QCOMPARE(layout.index(11), 3);
+    QCOMPARE(layout.index(12), -1);
+
+    // Without compressed instructions, the same text is a sequence of words
+    const InstructionLayout words(mixed, false);
+    QCOMPARE(words.count(), 3u);
+    QCOMPARE(words.offset(2), 8u);
+    QCOMPARE(words.index(5), 1);
+
+    // Instructions of a section which may be compressed, but only holds words, have the offsets implied by their indices
+    const InstructionLayout aligned(littleEndian({{0x00150513, 4}, {0x00150513, 4}}), true);
+    QCOMPARE(aligned.count(), 2u);
+    QCOMPARE(aligned.offset(1), 4u);
+    QCOMPARE(aligned.index(7), 1);
+}
+
+QTEST_APPLESS_MAIN(tst_Compressed)
+#include "tst_compressed.moc"
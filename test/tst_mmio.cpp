@@ -0,0 +1,282 @@
+#include <QtTest/QTest>
+
+#include "assembler.h"
+#include "peripherals.h"
+#include "processorhandler.h"
+
+/** Memory mapped I/O tests
+ *
+ * Covers the mapping of devices into the address space, the registers of each device, and programs accessing the
+ * devices of a simulation context through the data memory of a processor.
+ */
+
+using namespace Ripes;
+
+namespace {
+class CycleCounter : public vsrtl::core::PerformanceCounterSource {
+public:
+    long long performanceCounter(vsrtl::core::PerformanceCounter counter) const override {
+        return counter == vsrtl::core::PerformanceCounter::Cycles ? cycles : 0;
+    }
+    long long cycles = 0;
+};
+
+std::unique_ptr<MMIODevice> device(const QString& name, uint32_t base, uint32_t size) {
+    return std::make_unique<MMIODevice>(name, base, size);
+}
+
+/// Stores the @p bytes low bytes of @p value to @p address of @p memory, and notifies the devices of the store
+void store(MMIODevices& devices, vsrtl::core::SparseArray& memory, uint32_t address, uint32_t value, unsigned bytes) {
+    memory.writeMem(address, value, bytes);
+    if (devices.isDevicePage(address)) {
+        devices.write(address, value, bytes);
+    }
+}
+}  // namespace
+
+class tst_MMIO : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testDeviceTable();
+    void testUart();
+    void testTimer();
+    void testLedPanel();
+    void testFramebuffer();
+    void testProgramAccesses();
+};
+
+void tst_MMIO::testDeviceTable() {
+    MMIODevices devices;
+    QString error;
+    QVERIFY(devices.add(device("B", 0x2000, 0x10), error));
+    QVERIFY(devices.add(device("A", 0x1000, 0x1000), error));
+    QVERIFY(devices.add(device("C", 0xFFFFFFF0, 0x10), error));
+
+    // Ranges which are empty, exceed the address space or overlap another device are rejected
+    QVERIFY(!devices.add(device("Empty", 0x3000, 0), error));
+    QCOMPARE(error, QString("Invalid address range of device Empty"));
+    QVERIFY(!devices.add(device("Wrapping", 0xFFFFFFF0, 0x11), error));
+    QVERIFY(!devices.add(device("Next", 0x0, 0x1001), error));
+    QCOMPARE(error, QString("Device Next overlaps device A"));
+    QVERIFY(!devices.add(device("Previous", 0x200C, 0x4), error));
+    QCOMPARE(error, QString("Device Previous overlaps device B"));
+    QVERIFY(devices.add(device("Adjacent", 0x2010, 0x4), error));
+
+    QCOMPARE(devices.devices().size(), size_t(4));
+    QCOMPARE(devices.devices().front()->name(), QString("A"));
+    QCOMPARE(devices.devices().back()->name(), QString("C"));
+
+    QVERIFY(!devices.deviceAt(0xFFF));
+    QCOMPARE(devices.deviceAt(0x1000)->name(), QString("A"));
+    QCOMPARE(devices.deviceAt(0x1FFF)->name(), QString("A"));
+    QCOMPARE(devices.deviceAt(0x2000)->name(), QString("B"));
+    QCOMPARE(devices.deviceAt(0x2013)->name(), QString("Adjacent"));
+    QVERIFY(!devices.deviceAt(0x2014));
+    QCOMPARE(devices.deviceAt(0xFFFFFFFF)->name(), QString("C"));
+
+    // Pages are flagged if any device overlaps them
+    QVERIFY(!devices.isDevicePage(0x0));
+    QVERIFY(devices.isDevicePage(0x1000));
+    QVERIFY(devices.isDevicePage(0x2FFF));
+    QVERIFY(!devices.isDevicePage(0x3000));
+    QVERIFY(!devices.isDevicePage(0xFFFFEFFF));
+    QVERIFY(devices.isDevicePage(0xFFFFF000));
+
+    devices.clear();
+    QVERIFY(devices.empty());
+    QVERIFY(!devices.isDevicePage(0x1000));
+}
+
+void tst_MMIO::testUart() {
+    vsrtl::core::SparseArray memory;
+    MMIODevices devices;
+    devices.setMemory(&memory);
+    QString transmitted;
+    QString error;
+    const uint32_t base = UartDevice::s_defaultBase;
+    QVERIFY(devices.add(std::make_unique<UartDevice>(base, [&](const QString& data) { transmitted += data; }), error));
+    auto* uart = devices.find<UartDevice>();
+    QVERIFY(uart);
+
+    store(devices, memory, base + UartDevice::TxData, 'o', 1);
+    store(devices, memory, base + UartDevice::TxData, 'k', 4);
+    QCOMPARE(transmitted, QString("ok"));
+
+    uint32_t value = 0;
+    QVERIFY(devices.read(base + UartDevice::Status, value));
+    QCOMPARE(value, uint32_t(UartDevice::TxReady));
+    // Transmitted data is memory backed
+    QVERIFY(!devices.read(base + UartDevice::TxData, value));
+
+    // Received bytes are read in order, each being consumed by a store to the status register
+    uart->receive("xy");
+    QCOMPARE(uart->pending(), 2);
+    QVERIFY(devices.read(base + UartDevice::Status, value));
+    QCOMPARE(value, uint32_t(UartDevice::TxReady | UartDevice::RxValid));
+    QVERIFY(devices.read(base + UartDevice::RxData, value));
+    QCOMPARE(value, uint32_t('x'));
+    // Reads have no side effects
+    QVERIFY(devices.read(base + UartDevice::RxData, value));
+    QCOMPARE(value, uint32_t('x'));
+    store(devices, memory, base + UartDevice::Status, UartDevice::RxValid, 4);
+    QVERIFY(devices.read(base + UartDevice::RxData, value));
+    QCOMPARE(value, uint32_t('y'));
+    QCOMPARE(uart->pending(), 1);
+
+    devices.reset();
+    QCOMPARE(uart->pending(), 0);
+    QVERIFY(devices.read(base + UartDevice::RxData, value));
+    QCOMPARE(value, 0u);
+}
+
+void tst_MMIO::testTimer() {
+    vsrtl::core::SparseArray memory;
+    MMIODevices devices;
+    devices.setMemory(&memory);
+    CycleCounter counter;
+    QString error;
+    const uint32_t base = TimerDevice::s_defaultBase;
+    QVERIFY(devices.add(std::make_unique<TimerDevice>(base, &counter), error));
+
+    counter.cycles = 0x123456789ll;
+    uint32_t value = 0;
+    QVERIFY(devices.read(base + TimerDevice::TimeLow, value));
+    QCOMPARE(value, 0x23456789u);
+    QVERIFY(devices.read(base + TimerDevice::TimeHigh, value));
+    QCOMPARE(value, 0x1u);
+    // Narrow loads are served from the containing word
+    QVERIFY(devices.read(base + TimerDevice::TimeLow + 2, value));
+    QCOMPARE(value & 0xFFFF, 0x2345u);
+
+    // The compare value is memory backed
+    QVERIFY(!devices.read(base + TimerDevice::CompareLow, value));
+    store(devices, memory, base + TimerDevice::CompareLow, 0x2345678a, 4);
+    store(devices, memory, base + TimerDevice::CompareHigh, 0x1, 4);
+    QVERIFY(devices.read(base + TimerDevice::Status, value));
+    QCOMPARE(value, 0u);
+    counter.cycles++;
+    QVERIFY(devices.read(base + TimerDevice::Status, value));
+    QCOMPARE(value, uint32_t(TimerDevice::Due));
+}
+
+void tst_MMIO::testLedPanel() {
+    vsrtl::core::SparseArray memory;
+    MMIODevices devices;
+    devices.setMemory(&memory);
+    QString error;
+    const uint32_t base = LedPanelDevice::s_defaultBase;
+    QVERIFY(devices.add(std::make_unique<LedPanelDevice>(base), error));
+    auto* panel = devices.find<LedPanelDevice>();
+
+    // LEDs beyond the count of the panel are ignored
+    store(devices, memory, base + LedPanelDevice::Leds, 0x1a5, 4);
+    QCOMPARE(panel->leds(), 0xa5u);
+    store(devices, memory, base + LedPanelDevice::Leds, 0x0f, 1);
+    QCOMPARE(panel->leds(), 0x0fu);
+    const auto changes = devices.changes();
+    QVERIFY(devices.takeChanged());
+    QVERIFY(!devices.takeChanged());
+
+    panel->setSwitches(0x3c);
+    uint32_t value = 0;
+    QVERIFY(devices.read(base + LedPanelDevice::Switches, value));
+    QCOMPARE(value, 0x3cu);
+    QVERIFY(!devices.read(base + LedPanelDevice::Leds, value));
+
+    // LEDs follow their memory once it is modified outside of stores, ie. when reversing
+    memory.writeMem(base + LedPanelDevice::Leds, 0x81, 4);
+    devices.sync();
+    QCOMPARE(panel->leds(), 0x81u);
+    QVERIFY(devices.changes() > changes);
+    QVERIFY(devices.takeChanged());
+}
+
+void tst_MMIO::testFramebuffer() {
+    vsrtl::core::SparseArray memory;
+    MMIODevices devices;
+    devices.setMemory(&memory);
+    QString error;
+    const uint32_t base = FramebufferDevice::s_defaultBase;
+    // 2 x 2 tiles, the rightmost of which are 4 pixels wide
+    const unsigned width = FramebufferDevice::s_tileSize + 4;
+    const unsigned height = 2 * FramebufferDevice::s_tileSize;
+    QVERIFY(devices.add(std::make_unique<FramebufferDevice>(base, width, height), error));
+    auto* framebuffer = devices.find<FramebufferDevice>();
+    QCOMPARE(framebuffer->size(), width * height * 4);
+    QCOMPARE(framebuffer->tileColumns(), 2u);
+    QCOMPARE(framebuffer->tileRows(), 2u);
+
+    // All tiles are initially dirty
+    std::vector<uint32_t> pixels(width * height, 0);
+    std::vector<unsigned> tiles;
+    framebuffer->takeDirtyTiles(pixels.data(), tiles);
+    QCOMPARE(tiles, (std::vector<unsigned>{0, 1, 2, 3}));
+    QCOMPARE(pixels.front(), 0xFF000000u);
+    framebuffer->takeDirtyTiles(pixels.data(), tiles);
+    QVERIFY(tiles.empty());
+
+    // Pixel (19, 16) of the bottom right tile, and then (0, 0) of the top left tile
+    const unsigned pixel = 16 * width + 19;
+    store(devices, memory, base + pixel * 4, 0xAB123456, 4);
+    store(devices, memory, base, 0xFF, 1);
+    framebuffer->takeDirtyTiles(pixels.data(), tiles);
+    QCOMPARE(tiles, (std::vector<unsigned>{3, 0}));
+    QCOMPARE(pixels.at(pixel), 0xFF123456u);
+    QCOMPARE(pixels.at(0), 0xFF0000FFu);
+
+    // An unaligned store spanning two pixels of separate tiles dirties both
+    store(devices, memory, base + (FramebufferDevice::s_tileSize - 1) * 4 + 2, 0xFFFF, 4);
+    framebuffer->takeDirtyTiles(pixels.data(), tiles);
+    QCOMPARE(tiles, (std::vector<unsigned>{0, 1}));
+
+    // Synchronization only dirties the tiles whose pixels differ from memory
+    memory.writeMem(base + pixel * 4, 0, 4);
+    devices.sync();
+    framebuffer->takeDirtyTiles(pixels.data(), tiles);
+    QCOMPARE(tiles, (std::vector<unsigned>{3}));
+    QCOMPARE(pixels.at(pixel), 0xFF000000u);
+}
+
+void tst_MMIO::testProgramAccesses() {
+    // Transmits 'H', lights the LEDs and reads the switches and UART status
+    Assembler assembler;
+    const QByteArray text = assembler.assemble({"lui x5 983040", "addi x6 x0 72", "sw x6 0(x5)", "addi x6 x0 421",
+                                                "sw x6 512(x5)", "lw x7 516(x5)", "lw x8 8(x5)", "loop:",
+                                                "jal x0 loop"});
+    QVERIFY(!assembler.hasError());
+    Program program;
+    program.sections.push_back({TEXT_SECTION_NAME, 0, text});
+
+    ProcessorHandler handler;
+    QObject::connect(&handler, &ProcessorHandler::reqReloadProgram, [&] { handler.loadProgram(&program); });
+    QObject::connect(&handler, &ProcessorHandler::reqProcessorReset,
+                     [&] { handler.getProcessorNonConst()->reset(); });
+    QString output;
+    QObject::connect(&handler, &ProcessorHandler::print, [&](const QString& data) { output += data; });
+    handler.selectProcessor(ProcessorID::RV5S);
+
+    auto* uart = handler.getDevices().find<UartDevice>();
+    auto* panel = handler.getDevices().find<LedPanelDevice>();
+    QVERIFY(uart && panel);
+    uart->receive("a");
+    panel->setSwitches(0x3c);
+    for (unsigned i = 0; i < 20; i++) {
+        handler.getProcessorNonConst()->clock();
+    }
+
+    QCOMPARE(output, QString("H"));
+    QCOMPARE(panel->leds(), 0xa5u);
+    QCOMPARE(handler.getRegisterValue(7), 0x3cu);
+    QCOMPARE(handler.getRegisterValue(8), uint32_t(UartDevice::TxReady | UartDevice::RxValid));
+    // Stores are performed upon memory as any other store
+    QCOMPARE(handler.getMemory().readMemConst(LedPanelDevice::s_defaultBase), 0x1a5u);
+
+    // Resetting discards the received bytes, and returns memory backed device state to the reset memory
+    handler.getProcessorNonConst()->reset();
+    QCOMPARE(uart->pending(), 0);
+    QCOMPARE(panel->leds(), 0u);
+}
+
+QTEST_APPLESS_MAIN(tst_MMIO)
+#include "tst_mmio.moc"
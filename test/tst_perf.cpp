@@ -0,0 +1,288 @@
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtTest/QTest>
+
+#include "assembler.h"
+#include "headless.h"
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#ifndef RIPES_PERF_BASELINE
+static_assert(false, "RIPES_PERF_BASELINE must be defined");
+#endif
+
+/** Simulator performance regression test
+ *
+ * Executes a set of kernels on each processor for a fixed budget of cycles, and measures the host time per million
+ * simulated cycles. A test fails if this exceeds the stored baseline of the kernel and processor by more than the
+ * slowdown threshold. Baselines are machine specific, and are recorded on the machine which runs the test by setting
+ * RIPES_PERF_RECORD; kernels without a baseline are measured but never fail.
+ *
+ * The test is configured through the following environment variables:
+ * - RIPES_PERF_RECORD:     If set, the measurements are written to the baseline file rather than compared against it.
+ * - RIPES_PERF_BASELINE:   Baseline file, overriding the one given at build time.
+ * - RIPES_PERF_THRESHOLD:  Tolerated slowdown relative to the baseline (default 1.25, ie. 25% slower).
+ * - RIPES_PERF_CYCLES:     Cycle budget of each kernel (default 2000000).
+ */
+
+Q_DECLARE_METATYPE(Ripes::ProcessorID)
+
+using namespace Ripes;
+
+namespace {
+
+static constexpr double s_defaultThreshold = 1.25;
+static constexpr unsigned long long s_defaultCycles = 2000000;
+
+// Kernels repeat until the cycle budget is exhausted.
+// clang-format off
+const std::map<QString, QString> s_kernels = {
+    {"matmul",
+     ".data\n"
+     "a: .zero 1024\n"
+     "b: .zero 1024\n"
+     "c: .zero 1024\n"
+     ".text\n"
+     "main:\n"
+     "    la s0, a\n"
+     "    la s1, b\n"
+     "    li t0, 256\n"
+     "    li t1, 0\n"
+     "init:\n"
+     "    sw t1, 0(s0)\n"
+     "    sw t0, 0(s1)\n"
+     "    addi s0, s0, 4\n"
+     "    addi s1, s1, 4\n"
+     "    addi t1, t1, 1\n"
+     "    addi t0, t0, -1\n"
+     "    bnez t0, init\n"
+     "    li t5, 16\n"
+     "repeat:\n"
+     "    li s2, 0\n"
+     "row:\n"
+     "    li s3, 0\n"
+     "col:\n"
+     "    li s4, 0\n"
+     "    li t6, 0\n"
+     "dot:\n"
+     "    slli t0, s2, 4\n"
+     "    add t0, t0, s4\n"
+     "    slli t0, t0, 2\n"
+     "    la t1, a\n"
+     "    add t1, t1, t0\n"
+     "    lw t2, 0(t1)\n"
+     "    slli t0, s4, 4\n"
+     "    add t0, t0, s3\n"
+     "    slli t0, t0, 2\n"
+     "    la t1, b\n"
+     "    add t1, t1, t0\n"
+     "    lw t3, 0(t1)\n"
+     "    mul t4, t2, t3\n"
+     "    add t6, t6, t4\n"
+     "    addi s4, s4, 1\n"
+     "    blt s4, t5, dot\n"
+     "    slli t0, s2, 4\n"
+     "    add t0, t0, s3\n"
+     "    slli t0, t0, 2\n"
+     "    la t1, c\n"
+     "    add t1, t1, t0\n"
+     "    sw t6, 0(t1)\n"
+     "    addi s3, s3, 1\n"
+     "    blt s3, t5, col\n"
+     "    addi s2, s2, 1\n"
+     "    blt s2, t5, row\n"
+     "    j repeat\n"},
+    {"sort",
+     ".data\n"
+     "arr: .zero 512\n"
+     ".text\n"
+     "main:\n"
+     "    li s2, 128\n"
+     "repeat:\n"
+     "    la s0, arr\n"
+     "    li t0, 128\n"
+     "init:\n"
+     "    sw t0, 0(s0)\n"
+     "    addi s0, s0, 4\n"
+     "    addi t0, t0, -1\n"
+     "    bnez t0, init\n"
+     "    li s1, 1\n"
+     "outer:\n"
+     "    slli t0, s1, 2\n"
+     "    la t1, arr\n"
+     "    add t1, t1, t0\n"
+     "    lw t2, 0(t1)\n"
+     "    mv t3, t1\n"
+     "inner:\n"
+     "    la t4, arr\n"
+     "    beq t3, t4, place\n"
+     "    lw t5, -4(t3)\n"
+     "    bge t2, t5, place\n"
+     "    sw t5, 0(t3)\n"
+     "    addi t3, t3, -4\n"
+     "    j inner\n"
+     "place:\n"
+     "    sw t2, 0(t3)\n"
+     "    addi s1, s1, 1\n"
+     "    blt s1, s2, outer\n"
+     "    j repeat\n"},
+    {"crc32",
+     ".data\n"
+     "buf: .zero 256\n"
+     ".text\n"
+     "main:\n"
+     "    la s0, buf\n"
+     "    li t0, 256\n"
+     "    li t1, 7\n"
+     "fill:\n"
+     "    sb t1, 0(s0)\n"
+     "    addi t1, t1, 13\n"
+     "    addi s0, s0, 1\n"
+     "    addi t0, t0, -1\n"
+     "    bnez t0, fill\n"
+     "    lui s1, 973704\n"  // 0xEDB88320, the reflected CRC-32 polynomial
+     "    addi s1, s1, 800\n"
+     "repeat:\n"
+     "    la s0, buf\n"
+     "    li t0, 256\n"
+     "    li a0, -1\n"
+     "byte:\n"
+     "    lbu t1, 0(s0)\n"
+     "    xor a0, a0, t1\n"
+     "    li t2, 8\n"
+     "bit:\n"
+     "    andi t3, a0, 1\n"
+     "    srli a0, a0, 1\n"
+     "    beqz t3, nopoly\n"
+     "    xor a0, a0, s1\n"
+     "nopoly:\n"
+     "    addi t2, t2, -1\n"
+     "    bnez t2, bit\n"
+     "    addi s0, s0, 1\n"
+     "    addi t0, t0, -1\n"
+     "    bnez t0, byte\n"
+     "    j repeat\n"},
+};
+// clang-format on
+
+QString baselinePath() {
+    const QString path = qEnvironmentVariable("RIPES_PERF_BASELINE");
+    return path.isEmpty() ? QString(RIPES_PERF_BASELINE) : path;
+}
+
+}  // namespace
+
+class tst_Perf : public QObject {
+    Q_OBJECT
+
+private:
+    bool m_record = false;
+    double m_threshold = s_defaultThreshold;
+    unsigned long long m_cycles = s_defaultCycles;
+    QJsonObject m_baseline;
+    QJsonObject m_measurements;
+
+private slots:
+    void initTestCase();
+
+    void testThroughput_data();
+    void testThroughput();
+
+    void cleanupTestCase();
+};
+
+void tst_Perf::initTestCase() {
+    m_record = qEnvironmentVariableIsSet("RIPES_PERF_RECORD");
+    bool ok;
+    const double threshold = qEnvironmentVariable("RIPES_PERF_THRESHOLD").toDouble(&ok);
+    if (ok) {
+        QVERIFY2(threshold >= 1, "RIPES_PERF_THRESHOLD must be at least 1");
+        m_threshold = threshold;
+    }
+    const unsigned long long cycles = qEnvironmentVariable("RIPES_PERF_CYCLES").toULongLong(&ok);
+    if (ok) {
+        QVERIFY2(cycles != 0, "RIPES_PERF_CYCLES must be non-zero");
+        m_cycles = cycles;
+    }
+
+    QFile file(baselinePath());
+    if (!m_record && file.open(QIODevice::ReadOnly)) {
+        m_baseline = QJsonDocument::fromJson(file.readAll()).object();
+    }
+    if (!m_record && m_baseline.isEmpty()) {
+        qInfo() << "No baseline found at" << baselinePath() << "- measurements are reported but not checked";
+    }
+}
+
+void tst_Perf::testThroughput_data() {
+    QTest::addColumn<ProcessorID>("processor");
+    QTest::addColumn<QString>("kernel");
+
+    for (const auto& it : ProcessorRegistry::getAvailableProcessors()) {
+        for (const auto& kernel : s_kernels) {
+            const QString name = processorName(it.first) + "/" + kernel.first;
+            QTest::newRow(name.toUtf8().constData()) << it.first << kernel.first;
+        }
+    }
+}
+
+void tst_Perf::testThroughput() {
+    QFETCH(ProcessorID, processor);
+    QFETCH(QString, kernel);
+    const QString name = processorName(processor) + "/" + kernel;
+
+    Assembler assembler;
+    assembler.assemble(s_kernels.at(kernel).split('\n'));
+    QVERIFY2(!assembler.hasError(), "Kernel failed to assemble");
+    const Program program = assembler.getProgram();
+
+    // Without any widgets present, the reset and program reload requests of the handler are serviced directly
+    ProcessorHandler handler;
+    QObject::connect(&handler, &ProcessorHandler::reqReloadProgram, [&] { handler.loadProgram(&program); });
+    QObject::connect(&handler, &ProcessorHandler::reqProcessorReset,
+                     [&] { handler.getProcessorNonConst()->reset(); });
+    handler.selectProcessor(processor, ProcessorRegistry::getDescription(processor).defaultRegisterVals);
+
+    auto* proc = handler.getProcessorNonConst();
+    QElapsedTimer timer;
+    timer.start();
+    while (!proc->finished() && static_cast<unsigned long long>(proc->getCycleCount()) < m_cycles) {
+        proc->clock();
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    const long long cycles = proc->getCycleCount();
+    QVERIFY2(!proc->finished(), "Kernel finished before exhausting the cycle budget");
+
+    const double msPerMCycle = elapsedNs / 1e6 / (cycles / 1e6);
+    m_measurements[name] = msPerMCycle;
+    qInfo().noquote() << name << QString::number(msPerMCycle, 'f', 1) << "ms per million cycles ("
+                      << QString::number(1e3 / msPerMCycle, 'f', 2) << "MHz)";
+
+    if (m_record || !m_baseline.contains(name)) {
+        return;
+    }
+    const double baseline = m_baseline.value(name).toDouble();
+    const double slowdown = msPerMCycle / baseline;
+    if (slowdown > m_threshold) {
+        const QString err = name + " regressed: " + QString::number(msPerMCycle, 'f', 1) +
+                            " ms per million cycles against a baseline of " + QString::number(baseline, 'f', 1) +
+                            " (" + QString::number(slowdown, 'f', 2) + "x, threshold " +
+                            QString::number(m_threshold, 'f', 2) + "x)";
+        QFAIL(err.toStdString().c_str());
+    }
+}
+
+void tst_Perf::cleanupTestCase() {
+    if (!m_record) {
+        return;
+    }
+    QFile file(baselinePath());
+    QVERIFY2(file.open(QIODevice::WriteOnly), "Could not write the baseline file");
+    file.write(QJsonDocument(m_measurements).toJson());
+    qInfo() << "Recorded baseline to" << baselinePath();
+}
+
+QTEST_APPLESS_MAIN(tst_Perf)
+#include "tst_perf.moc"
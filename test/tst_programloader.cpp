@@ -0,0 +1,321 @@
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "programloader.h"
+
+/** Program loader tests
+ *
+ * Known-answer tests of loading Intel HEX, Motorola S-record and ELF files into the sections of a program, and of the
+ * handling of malformed files. ELF files are built by hand, such that no RISC-V toolchain is required.
+ */
+
+using namespace Ripes;
+
+Q_DECLARE_METATYPE(FileType)
+
+namespace {
+bool writeFile(const QString& path, const QByteArray& contents) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(contents) == contents.size();
+}
+
+void appendHalf(QByteArray& bytes, uint32_t value) {
+    bytes.append(static_cast<char>(value & 0xff));
+    bytes.append(static_cast<char>((value >> 8) & 0xff));
+}
+
+void appendWord(QByteArray& bytes, uint32_t value) {
+    appendHalf(bytes, value & 0xffff);
+    appendHalf(bytes, value >> 16);
+}
+
+// Section header types
+constexpr uint32_t s_progBits = 1;
+constexpr uint32_t s_symTab = 2;
+constexpr uint32_t s_strTab = 3;
+constexpr uint32_t s_noBits = 8;
+
+constexpr uint32_t s_bssSize = 0x100;
+
+/**
+ * @brief elfFile
+ * @returns a 32-bit little-endian RISC-V ELF file of a .text section of addi a0, x0, 1 and ret at 0x10000, a .bss
+ * section at 0x11000, and a symbol table of the function 'main' at 0x10004 and the object 'data' at 0x11000. The
+ * section headers directly follow the ELF header, and are followed by the contents of the sections.
+ */
+QByteArray elfFile() {
+    const QByteArray text = QByteArray::fromHex("1305100067800000");
+    const QByteArray strtab("\0main\0data\0", 11);
+    const QByteArray shstrtab("\0.text\0.bss\0.symtab\0.strtab\0.shstrtab\0", 38);
+    QByteArray symtab(16, '\0');
+    const auto appendSymbol = [&](uint32_t name, uint32_t value, char info, uint32_t section) {
+        appendWord(symtab, name);
+        appendWord(symtab, value);
+        appendWord(symtab, 4);
+        symtab.append(info);
+        symtab.append('\0');
+        appendHalf(symtab, section);
+    };
+    appendSymbol(1, 0x10004, 0x12, 1);  // Global function
+    appendSymbol(6, 0x11000, 0x11, 2);  // Global object
+
+    struct Section {
+        uint32_t name;
+        uint32_t type;
+        uint32_t address;
+        QByteArray contents;
+        uint32_t link;
+    };
+    const std::vector<Section> sections = {{0, 0, 0, QByteArray(), 0},
+                                           {1, s_progBits, 0x10000, text, 0},
+                                           {7, s_noBits, 0x11000, QByteArray(), 0},
+                                           {12, s_symTab, 0, symtab, 4},
+                                           {20, s_strTab, 0, strtab, 0},
+                                           {28, s_strTab, 0, shstrtab, 0}};
+
+    QByteArray elf = QByteArray::fromHex("7f454c46010101000000000000000000");
+    appendHalf(elf, 2);        // Executable
+    appendHalf(elf, 0xf3);     // RISC-V
+    appendWord(elf, 1);        // Version
+    appendWord(elf, 0x10004);  // Entry point
+    appendWord(elf, 0);        // Program header offset
+    appendWord(elf, 52);       // Section header offset
+    appendWord(elf, 0);        // Flags
+    appendHalf(elf, 52);       // ELF header size
+    appendHalf(elf, 0);        // Program header size
+    appendHalf(elf, 0);        // Program header count
+    appendHalf(elf, 40);       // Section header size
+    appendHalf(elf, static_cast<uint32_t>(sections.size()));
+    appendHalf(elf, 5);  // Section name table
+
+    uint32_t offset = static_cast<uint32_t>(elf.size() + sections.size() * 40);
+    QByteArray contents;
+    for (const auto& section : sections) {
+        appendWord(elf, section.name);
+        appendWord(elf, section.type);
+        appendWord(elf, 0);  // Flags
+        appendWord(elf, section.address);
+        appendWord(elf, section.contents.isEmpty() ? 0 : offset);
+        appendWord(elf, section.type == s_noBits ? s_bssSize : static_cast<uint32_t>(section.contents.size()));
+        appendWord(elf, section.link);
+        appendWord(elf, section.type == s_symTab ? 1 : 0);  // Index of the first global symbol
+        appendWord(elf, 4);  // Alignment
+        appendWord(elf, section.type == s_symTab ? 16 : 0);
+        offset += static_cast<uint32_t>(section.contents.size());
+        contents.append(section.contents);
+    }
+    return elf + contents;
+}
+
+void compareSection(const ProgramSection& section, const QString& name, unsigned long address, const QByteArray& hex) {
+    QCOMPARE(section.name, name);
+    QCOMPARE(section.address, address);
+    QCOMPARE(section.data.toHex(), hex);
+}
+}  // namespace
+
+class tst_ProgramLoader : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testIntelHex();
+    void testIntelHexSegments();
+    void testSRecord();
+    void testMalformedRecords_data();
+    void testMalformedRecords();
+
+    void testElf();
+    void testElfIsCopied();
+    void testMalformedElf();
+
+private:
+    /// Writes @p contents to the file @p name, and loads it as a file of @p type into @p program
+    bool loadRecords(const QString& name, const QByteArray& contents, FileType type, Program& program,
+                     QString& error);
+    /// Writes @p contents to the file @p name, and loads it as an ELF file into @p program
+    bool loadElf(const QString& name, const QByteArray& contents, Program& program);
+
+    QTemporaryDir m_dir;
+};
+
+bool tst_ProgramLoader::loadRecords(const QString& name, const QByteArray& contents, FileType type, Program& program,
+                                    QString& error) {
+    const QString path = m_dir.filePath(name);
+    if (!writeFile(path, contents)) {
+        return false;
+    }
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) && loadRecordFile(program, file, type, error);
+}
+
+bool tst_ProgramLoader::loadElf(const QString& name, const QByteArray& contents, Program& program) {
+    const QString path = m_dir.filePath(name);
+    if (!writeFile(path, contents)) {
+        return false;
+    }
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) && loadElfFile(program, file);
+}
+
+void tst_ProgramLoader::initTestCase() {
+    QVERIFY(m_dir.isValid());
+}
+
+void tst_ProgramLoader::testIntelHex() {
+    // Data at 0x10000, 0x10008 and 0x10004 (in that order, leaving a gap until the last record), and at 0x10100, which
+    // holds the start linear address. Lines following the end of file record are not parsed.
+    const QByteArray contents = ":020000040001F9\r\n"
+                                ":0400000013051000D4\r\n"
+                                ":02000800AABB91\r\n"
+                                "\r\n"
+                                ":040004009305200040\r\n"
+                                ":040100006F0000008C\r\n"
+                                ":0400000500010100F5\r\n"
+                                ":00000001FF\r\n"
+                                "not a record\r\n";
+    Program program;
+    QString error;
+    QVERIFY(loadRecords("program.hex", contents, FileType::IntelHex, program, error));
+
+    // The contiguous records are merged into a single section
+    QCOMPARE(program.sections.size(), size_t(2));
+    compareSection(program.sections.at(0), ".load0", 0x10000, "1305100093052000aabb");
+    compareSection(program.sections.at(1), ".text", 0x10100, "6f000000");
+    QCOMPARE(program.entryPoint, 0x10100ul);
+    QVERIFY(program.getSectionAt(0x10009) == &program.sections.at(0));
+    QVERIFY(!program.getSectionAt(0x1000a));
+}
+
+void tst_ProgramLoader::testIntelHexSegments() {
+    // Data relative to the extended segment address 0x1000 (0x10000), without a start address record
+    const QByteArray contents = ":020000021000EC\n"
+                                ":0400000013051000D4\n"
+                                ":040100006F0000008C\n"
+                                ":00000001FF\n";
+    Program program;
+    QString error;
+    QVERIFY(loadRecords("segments.hex", contents, FileType::IntelHex, program, error));
+
+    // The first section holds the entry point, which defaults to its start
+    QCOMPARE(program.sections.size(), size_t(2));
+    compareSection(program.sections.at(0), ".text", 0x10000, "13051000");
+    compareSection(program.sections.at(1), ".load0", 0x10100, "6f000000");
+    QCOMPARE(program.entryPoint, 0x10000ul);
+}
+
+void tst_ProgramLoader::testSRecord() {
+    // A header, data of 16, 24 and 32-bit addresses, a record count and the start address 0x100
+    const QByteArray contents = "S0060000686472BB\n"
+                                "S107010013051000CF\n"
+                                "S206010200AABB91\n"
+                                "S30980000000010203046C\n"
+                                "S5030003F9\n"
+                                "S9030100FB\n";
+    Program program;
+    QString error;
+    QVERIFY(loadRecords("program.srec", contents, FileType::SRecord, program, error));
+
+    QCOMPARE(program.sections.size(), size_t(3));
+    compareSection(program.sections.at(0), ".text", 0x100, "13051000");
+    compareSection(program.sections.at(1), ".load0", 0x10200, "aabb");
+    compareSection(program.sections.at(2), ".load1", 0x80000000, "01020304");
+    QCOMPARE(program.entryPoint, 0x100ul);
+}
+
+void tst_ProgramLoader::testMalformedRecords_data() {
+    QTest::addColumn<FileType>("type");
+    QTest::addColumn<QByteArray>("contents");
+    QTest::addColumn<QString>("error");
+
+    // Line numbers count blank lines
+    QTest::newRow("hex checksum") << FileType::IntelHex << QByteArray(":020000040001F9\n\n:0400000013051000D5\n")
+                                  << "Line 3: Invalid checksum";
+    QTest::newRow("hex length") << FileType::IntelHex << QByteArray(":0500000013051000D4\n")
+                                << "Line 1: Malformed Intel HEX record";
+    QTest::newRow("hex odd digits") << FileType::IntelHex << QByteArray(":0400000013051000D\n")
+                                    << "Line 1: Malformed Intel HEX record";
+    QTest::newRow("hex start code") << FileType::IntelHex << QByteArray("0400000013051000D4\n")
+                                    << "Line 1: Malformed Intel HEX record";
+    QTest::newRow("hex address size") << FileType::IntelHex << QByteArray(":0100000401FA\n")
+                                      << "Line 1: Malformed Intel HEX record";
+    QTest::newRow("hex record type") << FileType::IntelHex << QByteArray(":00000006FA\n")
+                                     << "Line 1: Unknown record type 6";
+    QTest::newRow("hex too long") << FileType::IntelHex << QByteArray(":") + QByteArray(1100, '0')
+                                  << "Line 1: Record is too long";
+    QTest::newRow("srec checksum") << FileType::SRecord << QByteArray("S0060000686472BB\nS107010013051000CE\n")
+                                   << "Line 2: Invalid checksum";
+    QTest::newRow("srec address") << FileType::SRecord << QByteArray("S10200FD\n") << "Line 1: Malformed S-record";
+    QTest::newRow("srec start code") << FileType::SRecord << QByteArray(":00000001FF\n")
+                                     << "Line 1: Malformed S-record";
+    QTest::newRow("srec record type") << FileType::SRecord << QByteArray("S4030000FC\n")
+                                      << "Line 1: Unknown record type S4";
+}
+
+void tst_ProgramLoader::testMalformedRecords() {
+    QFETCH(FileType, type);
+    QFETCH(QByteArray, contents);
+    QFETCH(QString, error);
+
+    // No sections are loaded from a malformed file, including those of the records preceding the malformed record
+    Program program;
+    QString loadError;
+    QVERIFY(!loadRecords("malformed", contents, type, program, loadError));
+    QCOMPARE(loadError, error);
+    QVERIFY(program.sections.empty());
+}
+
+void tst_ProgramLoader::testElf() {
+    Program program;
+    QVERIFY(loadElf("program.elf", elfFile(), program));
+
+    // All sections are loaded, including the null section
+    QCOMPARE(program.sections.size(), size_t(6));
+    const ProgramSection* text = program.getSection(".text");
+    QVERIFY(text);
+    compareSection(*text, ".text", 0x10000, "1305100067800000");
+    QCOMPARE(program.entryPoint, 0x10004ul);
+
+    // .bss is zero-filled rather than materialized
+    const ProgramSection* bss = program.getSection(".bss");
+    QVERIFY(bss);
+    QVERIFY(bss->data.isEmpty());
+    QCOMPARE(bss->zeroSize, static_cast<unsigned long>(s_bssSize));
+    QCOMPARE(program.getSectionAt(0x110ff), bss);
+    QVERIFY(!program.getSectionAt(0x11100));
+
+    // Only function symbols are collected
+    QCOMPARE(program.symbols.size(), size_t(1));
+    QCOMPARE(program.symbols.at(0x10004), QString("main"));
+}
+
+void tst_ProgramLoader::testElfIsCopied() {
+    // Section data is copied out of the mapping of the file, such that later changes to the file are not observed
+    const QByteArray elf = elfFile();
+    Program program;
+    QVERIFY(loadElf("rewritten.elf", elf, program));
+    QVERIFY(writeFile(m_dir.filePath("rewritten.elf"), QByteArray(elf.size(), '\xff')));
+    QVERIFY(writeFile(m_dir.filePath("rewritten.elf"), QByteArray()));
+    const ProgramSection* text = program.getSection(".text");
+    QVERIFY(text);
+    QCOMPARE(text->data.toHex(), QByteArray("1305100067800000"));
+}
+
+void tst_ProgramLoader::testMalformedElf() {
+    Program program;
+    QVERIFY(!loadElf("text.elf", "This is not an ELF file\n", program));
+
+    // Section contents beyond the end of a truncated file are not read, whereas its section headers are
+    const QByteArray elf = elfFile();
+    Program truncated;
+    QVERIFY(loadElf("truncated.elf", elf.left(52 + 6 * 40), truncated));
+    QCOMPARE(truncated.sections.size(), size_t(6));
+    for (const auto& section : truncated.sections) {
+        QVERIFY(section.data.isEmpty());
+    }
+    QVERIFY(truncated.symbols.empty());
+}
+
+QTEST_APPLESS_MAIN(tst_ProgramLoader)
+#include "tst_programloader.moc"
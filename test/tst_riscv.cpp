@@ -1,6 +1,9 @@
+#include <QCryptographicHash>
 #include <QDir>
 #include <QProcess>
 #include <QStringList>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
 #include <QtTest/QTest>
 
 #include "processorhandler.h"
@@ -42,109 +45,116 @@ static constexpr unsigned s_maxCycles = 10000;
 // Tests which contains instructions or assembler directives not yet supported
 const auto s_excludedTests = {"f", "ldst", "move", "recoding", /* fails on CI, unknown as of know */ "memory"};
 
-QString compileTestFile(const QString& testfile) {
-    QProcess exec;
+// Tests of the compressed instruction set extension, which are only executed on processors implementing it
+const QString s_compressedTestPrefix = "rvc";
 
-    const QString outElf = s_outdir + QDir::separator() + testfile + ".out";
-    const QString outBin = s_outdir + QDir::separator() + testfile + ".bin";
+bool isCompressedTest(const QString& testfile) {
+    return testfile.startsWith(s_compressedTestPrefix);
+}
 
-    if (!QDir(s_outdir).exists()) {
-        QDir().mkdir(s_outdir);
-    }
+QStringList assemblerFlags(const QString& testfile) {
+    return {isCompressedTest(testfile) ? "-march=rv32imc" : "-march=rv32im"};
+}
 
-    // Build
-    bool error = exec.execute(s_assembler, {"-march=rv32im", s_testdir + QDir::separator() + testfile, "-o", outElf});
+/**
+ * @brief compileTestFile
+ * Compiles @p testfile into a flat binary of its .text segment. Binaries are cached within the build directory, keyed
+ * by the contents of the test and the assembler flags, such that unchanged tests are only compiled once.
+ * @returns the path of the binary, or a null string if the test could not be compiled.
+ */
+QString compileTestFile(const QString& testfile) {
+    QFile source(s_testdir + QDir::separator() + testfile);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const QStringList flags = assemblerFlags(testfile);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(flags.join(' ').toUtf8());
+    hash.addData(source.readAll());
+    const QString stem = s_outdir + QDir::separator() + testfile + "." + hash.result().toHex().left(16);
+    const QString outBin = stem + ".bin";
+    if (QFileInfo::exists(outBin)) {
+        return outBin;
+    }
 
-    // Extract .text segment
-    error = exec.execute(s_objcopy, {"-O", "binary", "--only-section=.text", outElf, outBin});
+    QDir().mkpath(s_outdir);
+    const QString outElf = stem + ".out";
+    const QString partialBin = stem + ".part";
 
-    return error ? QString() : outBin;
+    // Build
+    bool error = QProcess::execute(s_assembler, flags + QStringList{source.fileName(), "-o", outElf});
+
+    // Extract .text segment. The binary is only moved into the cache once complete, such that an interrupted build
+    // never leaves a truncated binary behind.
+    error |= QProcess::execute(s_objcopy, {"-O", "binary", "--only-section=.text", outElf, partialBin});
+    QFile::remove(outElf);
+    if (error || !QFile::rename(partialBin, outBin)) {
+        QFile::remove(partialBin);
+        return QString();
+    }
+    return outBin;
 }
 
-class tst_RISCV : public QObject {
-    Q_OBJECT
-
-private:
-    void loadBinaryToSimulator(const QString& binFile);
-    bool skipTest(const QString& test);
-    QString executeSimulator();
-    QString dumpRegs();
+/**
+ * @brief The TestRun class
+ * Execution of a single test within a simulation context of its own, independent of the global processor handler,
+ * such that tests may be executed concurrently.
+ */
+class TestRun {
+public:
+    explicit TestRun(const QString& name) : m_name(name) {}
 
-    QString m_currentTest;
+    /**
+     * @brief run
+     * Executes the flat binary @p text on processor @p id, or through the functional interpreter if @p functional.
+     * @returns an error message, or a null string if the test succeeded.
+     */
+    QString run(ProcessorID id, const QByteArray& text, bool functional = false,
+                const FunctionalUnitLatencies& latencies = {});
 
-    void runTests(const ProcessorID& id);
+    ProcessorHandler& handler() { return m_handler; }
 
     void handleSysCall();
 
-    bool m_stop = false;
+private:
+    QString execute(RipesProcessor* proc);
+    QString dumpRegs();
+
+    QString m_name;
+    ProcessorHandler m_handler;
     Program m_program;
+    bool m_stop = false;
     QString m_err;
-
-private slots:
-
-    void testRVSingleCycle() { runTests(ProcessorID::RVSS); }
-    void testRV5StagePipeline() { runTests(ProcessorID::RV5S); }
-
-    void cleanupTestCase();
 };
 
-void tst_RISCV::cleanupTestCase() {
-    auto buildDir = QDir(s_outdir);
-    buildDir.removeRecursively();
-}
-
-bool tst_RISCV::skipTest(const QString& test) {
-    for (const auto& t : s_excludedTests) {
-        if (test.startsWith(t)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-QString tst_RISCV::dumpRegs() {
-    QString str = "\n" + m_currentTest + "\nRegister dump:";
-    str += "\t PC:" + QString::number(ProcessorHandler::get()->getProcessor()->getPcForStage(0), 16) + "\n";
-    for (unsigned i = 0; i < ProcessorHandler::get()->currentISA()->regCnt(); i++) {
-        str += "\t" + ProcessorHandler::get()->currentISA()->regName(i) + ":" +
-               ProcessorHandler::get()->currentISA()->regAlias(i) + ":\t" +
-               QString::number(ProcessorHandler::get()->getProcessor()->getRegister(i)) + "\n";
+QString TestRun::dumpRegs() {
+    QString str = "\n" + m_name + "\nRegister dump:";
+    str += "\t PC:" + QString::number(m_handler.getProcessor()->getPcForStage(0), 16) + "\n";
+    for (unsigned i = 0; i < m_handler.currentISA()->regCnt(); i++) {
+        str += "\t" + m_handler.currentISA()->regName(i) + ":" + m_handler.currentISA()->regAlias(i) + ":\t" +
+               QString::number(m_handler.getProcessor()->getRegister(i)) + "\n";
     }
     return str;
 }
 
-void tst_RISCV::loadBinaryToSimulator(const QString& binFile) {
-    // Read test file
-    QFile testFile(binFile);
-    if (!testFile.open(QIODevice::ReadOnly)) {
-        QString err = "Test: '" + m_currentTest + "' failed: Could not read compiled test file.";
-        QFAIL(err.toStdString().c_str());
-    }
-    QByteArray programByteArray = testFile.readAll();
-
-    m_program = Program();
-    m_program.sections.push_back({TEXT_SECTION_NAME, 0, programByteArray});
-    ProcessorHandler::get()->loadProgram(&m_program);
-}
-
-void tst_RISCV::handleSysCall() {
-    unsigned status = ProcessorHandler::get()->getProcessor()->getRegister(s_ecallreg);
+void TestRun::handleSysCall() {
+    unsigned status = m_handler.getProcessor()->getRegister(s_ecallreg);
     if (status == s_success) {
         m_stop |= true;
     } else if (status == s_fail) {
-        m_err = "Test: '" + m_currentTest + "' failed: Internal test error.\n\t test number: " +
-                QString::number(ProcessorHandler::get()->getProcessor()->getRegister(s_statusreg));
+        m_err = "Test: '" + m_name + "' failed: Internal test error.\n\t test number: " +
+                QString::number(m_handler.getProcessor()->getRegister(s_statusreg));
         m_err += dumpRegs();
     }
 }
 
-QString tst_RISCV::executeSimulator() {
+QString TestRun::execute(RipesProcessor* proc) {
     m_stop = false;
     m_err = QString();
     bool maxCyclesReached = false;
     unsigned cycles = 0;
     do {
-        ProcessorHandler::get()->getProcessorNonConst()->clock();
+        proc->clock();
 
         cycles++;
 
@@ -153,8 +163,8 @@ QString tst_RISCV::executeSimulator() {
     } while (!m_stop);
 
     if (maxCyclesReached) {
-        m_err = "Test: '" + m_currentTest + "' failed: Maximum cycle count reached\n\t test number: " +
-                QString::number(ProcessorHandler::get()->getProcessor()->getRegister(s_statusreg));
+        m_err = "Test: '" + m_name + "' failed: Maximum cycle count reached\n\t test number: " +
+                QString::number(m_handler.getProcessor()->getRegister(s_statusreg));
         m_err += dumpRegs();
     }
 
@@ -162,39 +172,200 @@ QString tst_RISCV::executeSimulator() {
     return m_err;
 }
 
-void tst_RISCV::runTests(const ProcessorID& id) {
-    const auto dir = QDir(s_testdir);
-    const auto testFiles = dir.entryList({"*.s"});
+QString TestRun::run(ProcessorID id, const QByteArray& text, bool functional,
+                     const FunctionalUnitLatencies& latencies) {
+    m_program = Program();
+    m_program.sections.push_back({TEXT_SECTION_NAME, 0, text});
+
+    // Without any widgets present, the reset and program reload requests of the handler are serviced directly
+    auto* handler = &m_handler;
+    QObject::connect(handler, &ProcessorHandler::reqReloadProgram, [=] { handler->loadProgram(&m_program); });
+    QObject::connect(handler, &ProcessorHandler::reqProcessorReset,
+                     [=] { handler->getProcessorNonConst()->reset(); });
+
+    m_handler.setFunctionalUnitLatencies(latencies);
+    m_handler.selectProcessor(id);
+    // Override the ProcessorHandler's ECALL handling
+    m_handler.getProcessorNonConst()->handleSysCall.Connect(this, &TestRun::handleSysCall);
+
+    if (functional) {
+        // Execute the test through the functional interpreter, bound to the address spaces of the selected processor.
+        auto* proc = m_handler.getProcessorNonConst();
+        RVISS iss(&proc->getMemory(), &proc->getArchRegisters());
+        iss.setCompressedInstructions(m_handler.currentISA()->hasCompressedInstructions());
+        iss.setExecutableRange(m_handler.getTextStart(), m_handler.getTextEnd());
+        iss.setPCInitialValue(m_program.entryPoint);
+        iss.reset();
+        iss.handleSysCall.Connect(this, &TestRun::handleSysCall);
+        return execute(&iss);
+    }
+
+    const QString err = execute(m_handler.getProcessorNonConst());
+    if (!err.isNull()) {
+        return err;
+    }
+    // All retired instructions are attributed to the profile of the program
+    long long profiled = 0;
+    for (const auto& entry : m_handler.getProfiler().entries()) {
+        profiled += entry.retired;
+    }
+    const long long retired = m_handler.getProcessor()->getInstructionsRetired();
+    if (profiled != retired) {
+        return "Test: '" + m_name + "' failed: " + QString::number(profiled) + " instructions were profiled, but " +
+               QString::number(retired) + " were retired.";
+    }
+    return QString();
+}
+
+class tst_RISCV : public QObject {
+    Q_OBJECT
 
-    for (const auto& test : testFiles) {
-        m_currentTest = test;
+private:
+    bool skipTest(const QString& test);
 
-        if (skipTest(m_currentTest))
-            continue;
+    void runTests(const ProcessorID& id, bool functional = false, const FunctionalUnitLatencies& latencies = {});
 
-        qInfo() << "Running test: " << m_currentTest;
+    // Compiled binary of each test which is not excluded, keyed by test file
+    QMap<QString, QString> m_binaries;
 
-        // Compile test file
-        const auto binFile = compileTestFile(test);
-        if (binFile.isNull()) {
-            QString err = "Test: '" + test + "' failed: Could not compile test file.";
+private slots:
+    void initTestCase();
+
+    void testRVSingleCycle() { runTests(ProcessorID::RVSS); }
+    void testRV5StagePipeline() { runTests(ProcessorID::RV5S); }
+    void testRV5StageBTFN() { runTests(ProcessorID::RV5S_BTFN); }
+    void testRV5StageBimodal() { runTests(ProcessorID::RV5S_BIMODAL); }
+    void testRV5StageGShare() { runTests(ProcessorID::RV5S_GSHARE); }
+    void testRV5StageBTB() { runTests(ProcessorID::RV5S_BTB); }
+    void testRV5StageMulDivLatencies() { runTests(ProcessorID::RV5S, false, {3, 8}); }
+    void testRV5StageDualIssue() { runTests(ProcessorID::RV5S_DUAL); }
+    void testRVFunctional() { runTests(ProcessorID::RVSS, true); }
+
+    void testPerformanceCounters();
+
+    void cleanupTestCase();
+};
+
+void tst_RISCV::initTestCase() {
+    QStringList tests;
+    for (const auto& test : QDir(s_testdir).entryList({"*.s"})) {
+        if (!skipTest(test)) {
+            tests << test;
+        }
+    }
+
+    // Tests are compiled concurrently, each by separate assembler processes
+    std::vector<QString> binaries(tests.size());
+    QThreadPool pool;
+    for (int i = 0; i < tests.size(); i++) {
+        QtConcurrent::run(&pool, [&tests, &binaries, i] { binaries[i] = compileTestFile(tests.at(i)); });
+    }
+    pool.waitForDone();
+
+    for (int i = 0; i < tests.size(); i++) {
+        if (binaries[i].isNull()) {
+            QString err = "Test: '" + tests.at(i) + "' failed: Could not compile test file.";
             QFAIL(err.toStdString().c_str());
         }
+        m_binaries[tests.at(i)] = binaries[i];
+    }
+}
 
-        connect(ProcessorHandler::get(), &ProcessorHandler::reqReloadProgram, [=] { loadBinaryToSimulator(binFile); });
-        connect(ProcessorHandler::get(), &ProcessorHandler::reqProcessorReset,
-                [=] { ProcessorHandler::get()->getProcessorNonConst()->reset(); });
+void tst_RISCV::cleanupTestCase() {
+    // Binaries of the current tests are kept for subsequent runs; stale binaries of modified tests are removed
+    QSet<QString> current;
+    for (const auto& binary : m_binaries) {
+        current.insert(QFileInfo(binary).fileName());
+    }
+    QDir buildDir(s_outdir);
+    for (const auto& file : buildDir.entryList(QDir::Files)) {
+        if (!current.contains(file)) {
+            buildDir.remove(file);
+        }
+    }
+}
 
-        ProcessorHandler::get()->selectProcessor(id);
-        // Override the ProcessorHandler's ECALL handling
-        ProcessorHandler::get()->getProcessorNonConst()->handleSysCall.Connect(this, &tst_RISCV::handleSysCall);
+bool tst_RISCV::skipTest(const QString& test) {
+    for (const auto& t : s_excludedTests) {
+        if (test.startsWith(t)) {
+            return true;
+        }
+    }
+    return false;
+}
 
-        const QString err = executeSimulator();
-        if (!err.isNull()) {
+void tst_RISCV::runTests(const ProcessorID& id, bool functional, const FunctionalUnitLatencies& latencies) {
+    const bool compressed = ProcessorRegistry::getDescription(id).isa->hasCompressedInstructions();
+    std::vector<std::pair<QString, QByteArray>> tests;
+    for (auto it = m_binaries.constBegin(); it != m_binaries.constEnd(); ++it) {
+        if (isCompressedTest(it.key()) && !compressed) {
+            continue;
+        }
+        // Read test file
+        QFile testFile(it.value());
+        if (!testFile.open(QIODevice::ReadOnly)) {
+            QString err = "Test: '" + it.key() + "' failed: Could not read compiled test file.";
             QFAIL(err.toStdString().c_str());
         }
+        tests.push_back({it.key(), testFile.readAll()});
+    }
+
+    // Each test is executed concurrently within a simulation context of its own
+    std::vector<QString> errors(tests.size());
+    QThreadPool pool;
+    for (unsigned i = 0; i < tests.size(); i++) {
+        QtConcurrent::run(&pool, [&, i] {
+            TestRun run(tests.at(i).first);
+            errors[i] = run.run(id, tests.at(i).second, functional, latencies);
+        });
+    }
+    pool.waitForDone();
+
+    QStringList failures;
+    for (unsigned i = 0; i < tests.size(); i++) {
+        if (errors[i].isNull()) {
+            qInfo() << "Test '" << tests.at(i).first << "' succeeded.";
+        } else {
+            failures << errors[i];
+        }
+    }
+    if (!failures.isEmpty()) {
+        QFAIL(failures.join("\n").toStdString().c_str());
+    }
+}
 
-        qInfo() << "Test '" << m_currentTest << "' succeeded.";
+void tst_RISCV::testPerformanceCounters() {
+    // csrrs rd, csr, x0; addi rd, rs1, imm
+    const auto csrr = [](uint32_t rd, uint32_t csr) { return csr << 20 | 0b010 << 12 | rd << 7 | 0b1110011; };
+    const auto addi = [](uint32_t rd, uint32_t rs1, int32_t imm) {
+        return static_cast<uint32_t>(imm) << 20 | rs1 << 15 | rd << 7 | 0b0010011;
+    };
+    // Reads instret before and after two instructions, and the cycle counter through both of its aliases
+    const std::vector<uint32_t> program = {csrr(5, 0xC02),  addi(6, 0, 1),  addi(6, 6, 1),   csrr(7, 0xC02),
+                                           csrr(28, 0xC00), csrr(29, 0xB00), addi(10, 0, 42), 0b1110011};
+    QByteArray text;
+    for (const uint32_t instr : program) {
+        for (unsigned i = 0; i < 4; i++) {
+            text.append(static_cast<char>(instr >> (i * 8)));
+        }
+    }
+
+    for (const auto& id : {ProcessorID::RVSS, ProcessorID::RV5S, ProcessorID::RV5S_DUAL}) {
+        TestRun run("performance counters");
+        const QString err = run.run(id, text);
+        if (!err.isNull()) {
+            QFAIL(err.toStdString().c_str());
+        }
+        const auto* proc = run.handler().getProcessor();
+        QCOMPARE(proc->getRegister(6), 2u);
+        // Instructions retire in order, such that the second read counts at most the instructions in between
+        QVERIFY(proc->getRegister(7) >= proc->getRegister(5));
+        QVERIFY(proc->getRegister(7) - proc->getRegister(5) <= 3);
+        QVERIFY(proc->getRegister(29) >= proc->getRegister(28));
+        if (id == ProcessorID::RVSS) {
+            // A single cycle processor retires an instruction in each cycle
+            QCOMPARE(proc->getRegister(7) - proc->getRegister(5), 3u);
+        }
     }
 }
 
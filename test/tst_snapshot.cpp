@@ -0,0 +1,316 @@
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <map>
+
+#include "assembler.h"
+#include "cachesim/cachesim.h"
+#include "processorhandler.h"
+#include "simulationsnapshot.h"
+
+/** Simulation snapshot tests
+ *
+ * Covers the encoding of snapshots, the rejection of malformed snapshots, and that restoring a snapshot of a running
+ * program returns the processor, memory and caches to the saved state, from which execution resumes as it would have
+ * without the snapshot having been taken.
+ */
+
+using namespace Ripes;
+
+namespace {
+using MemoryContents = std::map<uint32_t, uint8_t>;
+
+MemoryContents contents(const vsrtl::core::SparseArray& memory) {
+    MemoryContents bytes;
+    for (const auto& entry : memory) {
+        bytes[static_cast<uint32_t>(entry.first)] = static_cast<uint8_t>(entry.second);
+    }
+    return bytes;
+}
+
+bool writeFile(const QString& path, const QByteArray& contents) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(contents) == contents.size();
+}
+
+QByteArray readFile(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+/// @returns the data reads of the words at @p addresses
+std::vector<CacheTraceReader::Access> dataReads(const std::vector<uint32_t>& addresses) {
+    std::vector<CacheTraceReader::Access> accesses;
+    for (const auto address : addresses) {
+        CacheTraceReader::Access access;
+        access.address = address;
+        accesses.push_back(access);
+    }
+    return accesses;
+}
+
+bool isResident(const CacheSim& cache, uint32_t address) {
+    const auto line = cache.getLine(cache.getLineIdx(address));
+    for (int way = 0; way < cache.getWays(); way++) {
+        if (line.valid(way) && line.tag(way) == cache.getTag(address)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Two-way cache of four lines of single word blocks
+const CacheSim::CachePreset s_preset{0, 2, 1, CacheSim::WritePolicy::WriteBack,
+                                     CacheSim::WriteAllocPolicy::WriteAllocate, CacheSim::ReplPolicy::LRU};
+}  // namespace
+
+class tst_Snapshot : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testEncoding();
+    void testMalformedSnapshot();
+    void testCacheSnapshot();
+    void testProcessorSnapshot();
+
+private:
+    /// Loads a program into @p handler which counts upwards, storing each count to consecutive words from 0x1000
+    void loadCounter(ProcessorHandler& handler);
+    void clock(ProcessorHandler& handler, unsigned cycles);
+
+    QTemporaryDir m_dir;
+    QString path(const QString& name) const { return m_dir.filePath(name); }
+    Program m_program;
+};
+
+void tst_Snapshot::initTestCase() {
+    QVERIFY(m_dir.isValid());
+}
+
+void tst_Snapshot::loadCounter(ProcessorHandler& handler) {
+    Assembler assembler;
+    const QByteArray text = assembler.assemble(
+        {"addi x10 x0 0", "lui x11 1", "loop:", "addi x10 x10 1", "sw x10 0(x11)", "addi x11 x11 4", "jal x0 loop"});
+    QVERIFY(!assembler.hasError());
+    m_program = Program();
+    m_program.sections.push_back({TEXT_SECTION_NAME, 0, text});
+
+    // Without any widgets present, the reset and program reload requests of the handler are serviced directly
+    QObject::connect(&handler, &ProcessorHandler::reqReloadProgram, [&] { handler.loadProgram(&m_program); });
+    QObject::connect(&handler, &ProcessorHandler::reqProcessorReset,
+                     [&] { handler.getProcessorNonConst()->reset(); });
+    handler.selectProcessor(ProcessorID::RV5S);
+}
+
+void tst_Snapshot::clock(ProcessorHandler& handler, unsigned cycles) {
+    for (unsigned i = 0; i < cycles; i++) {
+        handler.getProcessorNonConst()->clock();
+    }
+}
+
+void tst_Snapshot::testEncoding() {
+    vsrtl::core::SparseArray memory;
+    memory.writeMem(0x1000, 0x44332211, 4);
+    memory.writeMem(0x1ffe, 0xaa, 1);
+    memory.writeMem(0x80000003, 0xbb, 1);
+
+    SnapshotWriter out;
+    out.put<uint8_t>(0x7f);
+    out.put<int64_t>(-2);
+    out.putVector(std::vector<uint16_t>{1, 0xfffe});
+    out.putString(QString::fromUtf8("L1\xc3\xa6"));
+    out.putPages(memory);
+    QVERIFY(out.write(path("encoding.snapshot")));
+
+    // Integers are little endian, and pages are given in ascending order of address. The header is followed by the
+    // uint8_t, the int64_t, the vector, the string, the page count and the address of the first page.
+    const QByteArray encoded = readFile(path("encoding.snapshot"));
+    const QByteArray header =
+        QByteArray("RIPESSNP\x01", 9) +
+        QByteArray::fromHex("7f" "feffffffffffffff" "02000000" "0100feff" "04000000" "4c31c3a6" "02000000" "00100000");
+    QCOMPARE(encoded.left(header.size()), header);
+    constexpr int pageRecordSize = 4 + SimulationSnapshot::s_pageSize / 8 + SimulationSnapshot::s_pageSize;
+    QCOMPARE(encoded.size(), header.size() - 4 + 2 * pageRecordSize);
+    // The bitmap marks the populated bytes of the page
+    QCOMPARE(encoded.mid(header.size(), 1), QByteArray::fromHex("0f"));
+    QCOMPARE(encoded.mid(header.size() + SimulationSnapshot::s_pageSize / 8 - 1, 1), QByteArray::fromHex("40"));
+
+    SnapshotReader in;
+    QString error;
+    QVERIFY(in.open(path("encoding.snapshot"), error));
+    QCOMPARE(in.get<uint8_t>(), uint8_t(0x7f));
+    QCOMPARE(in.get<int64_t>(), int64_t(-2));
+    std::vector<uint16_t> values;
+    in.getVector(values);
+    QCOMPARE(values, (std::vector<uint16_t>{1, 0xfffe}));
+    QCOMPARE(in.getString(), QString::fromUtf8("L1\xc3\xa6"));
+    std::vector<SimulationSnapshot::Page> pages;
+    in.getPages(pages);
+    QVERIFY(in.ok());
+    QVERIFY(in.atEnd());
+    QCOMPARE(pages.size(), size_t(2));
+    QCOMPARE(pages.at(1).address, 0x80000000u);
+
+    vsrtl::core::SparseArray restored;
+    SimulationSnapshot::writePages(pages, restored);
+    QVERIFY(contents(restored) == contents(memory));
+}
+
+void tst_Snapshot::testMalformedSnapshot() {
+    QString error;
+
+    QVERIFY(writeFile(path("magic.snapshot"), QByteArray("RIPESSNX\x01", 9)));
+    QVERIFY(!SnapshotReader().open(path("magic.snapshot"), error));
+    QCOMPARE(error, path("magic.snapshot") + " is not a simulation snapshot");
+    QVERIFY(writeFile(path("version.snapshot"), QByteArray("RIPESSNP\x02", 9)));
+    QVERIFY(!SnapshotReader().open(path("version.snapshot"), error));
+    QCOMPARE(error, QString("Unsupported snapshot version 2"));
+    QVERIFY(!SnapshotReader().open(path("missing.snapshot"), error));
+
+    // Reads past the end yield zero and fail the reader, as do counts exceeding the remainder of the snapshot
+    QVERIFY(writeFile(path("truncated.snapshot"), QByteArray("RIPESSNP\x01\x01\x02", 11)));
+    SnapshotReader truncated;
+    QVERIFY(truncated.open(path("truncated.snapshot"), error));
+    QCOMPARE(truncated.get<uint32_t>(), 0u);
+    QVERIFY(!truncated.ok());
+
+    QVERIFY(writeFile(path("count.snapshot"), QByteArray("RIPESSNP\x01\x03\x00\x00\x00\x01\x00", 15)));
+    SnapshotReader count;
+    QVERIFY(count.open(path("count.snapshot"), error));
+    std::vector<uint16_t> values;
+    count.getVector(values);
+    QVERIFY(!count.ok());
+
+    // Pages must be aligned
+    SnapshotWriter out;
+    out.put<uint32_t>(1);
+    out.put<uint32_t>(0x1004);
+    const std::vector<uint8_t> page(SimulationSnapshot::s_pageSize / 8 + SimulationSnapshot::s_pageSize, 0);
+    out.putBytes(page.data(), page.size());
+    QVERIFY(out.write(path("page.snapshot")));
+    SnapshotReader misaligned;
+    QVERIFY(misaligned.open(path("page.snapshot"), error));
+    std::vector<SimulationSnapshot::Page> pages;
+    misaligned.getPages(pages);
+    QVERIFY(!misaligned.ok());
+}
+
+void tst_Snapshot::testCacheSnapshot() {
+    ProcessorHandler handler;
+    CacheSim cache(&handler, nullptr);
+    cache.setPreset(s_preset);
+    cache.replay(dataReads({0x0, 0x10, 0x0, 0x4, 0x20}));
+    const auto hits = cache.getHits();
+    const auto misses = cache.getMisses();
+
+    SnapshotWriter out;
+    cache.writeSnapshot(out);
+    QVERIFY(out.write(path("cache.snapshot")));
+
+    // Replaying starts over from a reset cache
+    cache.replay(dataReads({0x30, 0x40}));
+    QVERIFY(!isResident(cache, 0x0));
+
+    SnapshotReader in;
+    QString error;
+    QVERIFY(in.open(path("cache.snapshot"), error));
+    CacheSim::SnapshotState state;
+    QVERIFY(cache.readSnapshot(in, state, error));
+    QVERIFY(in.atEnd());
+    cache.restoreSnapshot(std::move(state), 0);
+    // 0x10 is the least recently used block of its line, and was evicted by 0x20
+    QVERIFY(isResident(cache, 0x0));
+    QVERIFY(isResident(cache, 0x4));
+    QVERIFY(isResident(cache, 0x20));
+    QVERIFY(!isResident(cache, 0x10));
+    QCOMPARE(cache.getHits(), hits);
+    QCOMPARE(cache.getMisses(), misses);
+
+    // The state of a cache of another geometry is rejected
+    CacheSim other(&handler, nullptr);
+    auto preset = s_preset;
+    preset.ways = 2;
+    other.setPreset(preset);
+    SnapshotReader otherIn;
+    QVERIFY(otherIn.open(path("cache.snapshot"), error));
+    QVERIFY(!other.readSnapshot(otherIn, state, error));
+}
+
+void tst_Snapshot::testProcessorSnapshot() {
+    ProcessorHandler handler;
+    // Snapshots require a program
+    QString error;
+    QVERIFY(!handler.saveSnapshot(path("none.snapshot"), {}, error));
+
+    // The data cache observes the stores of the program
+    loadCounter(handler);
+    CacheSim cache(&handler, nullptr);
+    cache.setPreset(s_preset);
+    const std::vector<ProcessorHandler::SnapshotCache> caches = {{"L1D", &cache}};
+
+    clock(handler, 25);
+    QVERIFY2(handler.saveSnapshot(path("counter.snapshot"), caches, error), qPrintable(error));
+    const long long savedCycle = handler.getCycleCount();
+    const long long savedRetired = handler.getInstructionsRetired();
+    std::vector<uint32_t> savedRegisters;
+    handler.getRegisterValues(savedRegisters);
+    const MemoryContents savedMemory = contents(handler.getMemory());
+    const uint64_t savedMisses = cache.getMisses();
+    QVERIFY(savedMemory.count(0x1000) != 0);
+    QVERIFY(savedMisses != 0);
+
+    clock(handler, 30);
+    const long long finalCycle = handler.getCycleCount();
+    std::vector<uint32_t> finalRegisters;
+    handler.getRegisterValues(finalRegisters);
+    const MemoryContents finalMemory = contents(handler.getMemory());
+    const uint64_t finalMisses = cache.getMisses();
+    QVERIFY(finalRegisters != savedRegisters);
+    QVERIFY(finalMisses > savedMisses);
+
+    // Snapshots of another set of caches, or of other cache configurations, are rejected without touching the
+    // simulation
+    QVERIFY(!handler.restoreSnapshot(path("counter.snapshot"), {}, error));
+    QCOMPARE(error, QString("The snapshot holds the state of 1 caches, whereas 0 are simulated"));
+    CacheSim other(&handler, nullptr);
+    auto preset = s_preset;
+    preset.ways = 2;
+    other.setPreset(preset);
+    QVERIFY(!handler.restoreSnapshot(path("counter.snapshot"), {{"L1I", &cache}}, error));
+    QCOMPARE(error, QString("The snapshot holds the state of a cache 'L1D' which is not simulated"));
+    QVERIFY(!handler.restoreSnapshot(path("counter.snapshot"), {{"L1D", &other}}, error));
+    QVERIFY(error.startsWith("Cache 'L1D': "));
+    QVERIFY(writeFile(path("truncated.snapshot"), readFile(path("counter.snapshot")).left(64)));
+    QVERIFY(!handler.restoreSnapshot(path("truncated.snapshot"), caches, error));
+    QCOMPARE(error, QString("The snapshot is truncated or malformed"));
+    QCOMPARE(handler.getCycleCount(), finalCycle);
+    QCOMPARE(cache.getMisses(), finalMisses);
+
+    // Restoring returns to the saved state, from which execution resumes as before
+    QVERIFY2(handler.restoreSnapshot(path("counter.snapshot"), caches, error), qPrintable(error));
+    QCOMPARE(handler.getCycleCount(), savedCycle);
+    QCOMPARE(handler.getInstructionsRetired(), savedRetired);
+    std::vector<uint32_t> registers;
+    handler.getRegisterValues(registers);
+    QCOMPARE(registers, savedRegisters);
+    QVERIFY(contents(handler.getMemory()) == savedMemory);
+    QCOMPARE(cache.getMisses(), savedMisses);
+
+    clock(handler, 30);
+    QCOMPARE(handler.getCycleCount(), finalCycle);
+    handler.getRegisterValues(registers);
+    QCOMPARE(registers, finalRegisters);
+    QVERIFY(contents(handler.getMemory()) == finalMemory);
+    QCOMPARE(cache.getMisses(), finalMisses);
+
+    // Snapshots are bound to the program they were taken with
+    m_program.sections.front().data.append(QByteArray(4, '\0'));
+    handler.loadProgram(&m_program);
+    QVERIFY(!handler.restoreSnapshot(path("counter.snapshot"), caches, error));
+    QCOMPARE(error, QString("The snapshot was taken with another program"));
+}
+
+QTEST_APPLESS_MAIN(tst_Snapshot)
+#include "tst_snapshot.moc"
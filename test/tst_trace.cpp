@@ -0,0 +1,284 @@
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/cachetrace.h"
+#include "executiontrace.h"
+#include "processorhandler.h"
+
+/** Trace tests
+ *
+ * Known-answer and round trip tests of the execution trace file format, and of reading and replaying the memory
+ * accesses of traces through cache simulators.
+ */
+
+using namespace Ripes;
+
+namespace {
+// addi a0, x0, 1 at 0x0 and sw a0, 0(sp) at 0x4, followed by a jump back to the addi which writes 2 to a0
+std::vector<TraceRecord> loopRecords() {
+    TraceRecord addi;
+    addi.pc = 0x0;
+    addi.instr = 0x00100513;
+    addi.hasRegWrite = true;
+    addi.rd = 10;
+    addi.rdValue = 1;
+
+    TraceRecord sw;
+    sw.pc = 0x4;
+    sw.instr = 0x00a12023;
+    sw.hasMemAccess = true;
+    sw.memAddress = 0x1000;
+
+    TraceRecord again = addi;
+    again.rdValue = 2;
+    return {addi, sw, again};
+}
+
+// Encoding of loopRecords(); the second addi reuses the instruction word recorded for its PC
+const QByteArray s_loopTrace = QByteArray("RIPESTRC\x01", 9) +
+                               QByteArray::fromHex("06130510000a02"  // NewPc | RegWrite, a0 += 1
+                                                   "0a2320a1008040"  // NewPc | MemAccess, address += 0x1000
+                                                   "050f0a02");      // NonSequential (pc -= 8) | RegWrite
+
+bool writeFile(const QString& path, const QByteArray& contents) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(contents) == contents.size();
+}
+
+QByteArray readFile(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+/// @returns a compact notation of @p accesses; "<kind>:<address>@<pc>" per access, where kind is I, R or W
+QStringList describe(const std::vector<CacheTraceReader::Access>& accesses) {
+    QStringList described;
+    for (const auto& access : accesses) {
+        const QString kind = access.instruction ? "I" : access.write ? "W" : "R";
+        described << kind + ":" + QString::number(access.address, 16) + "@" + QString::number(access.pc, 16);
+    }
+    return described;
+}
+
+void compareRecords(const TraceRecord& actual, const TraceRecord& expected) {
+    QCOMPARE(actual.pc, expected.pc);
+    QCOMPARE(actual.instr, expected.instr);
+    QCOMPARE(actual.hasRegWrite, expected.hasRegWrite);
+    if (expected.hasRegWrite) {
+        QCOMPARE(actual.rd, expected.rd);
+        QCOMPARE(actual.rdValue, expected.rdValue);
+    }
+    QCOMPARE(actual.hasMemAccess, expected.hasMemAccess);
+    if (expected.hasMemAccess) {
+        QCOMPARE(actual.memAddress, expected.memAddress);
+    }
+}
+}  // namespace
+
+class tst_Trace : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testExecutionTraceEncoding();
+    void testExecutionTraceRoundTrip();
+    void testMalformedExecutionTrace();
+
+    void testCacheTraceFormats_data();
+    void testCacheTraceFormats();
+    void testMalformedCacheTrace();
+    void testReplay();
+
+private:
+    QTemporaryDir m_dir;
+    QString path(const QString& name) const { return m_dir.filePath(name); }
+};
+
+void tst_Trace::initTestCase() {
+    QVERIFY(m_dir.isValid());
+}
+
+void tst_Trace::testExecutionTraceEncoding() {
+    {
+        ExecutionTraceWriter writer;
+        QVERIFY(writer.open(path("loop.trace")));
+        for (const auto& record : loopRecords()) {
+            writer.write(record);
+        }
+    }
+    QCOMPARE(readFile(path("loop.trace")), s_loopTrace);
+
+    ExecutionTraceReader reader;
+    QVERIFY(reader.open(path("loop.trace")));
+    TraceRecord record;
+    for (const auto& expected : loopRecords()) {
+        QVERIFY(reader.next(record));
+        compareRecords(record, expected);
+    }
+    QVERIFY(!reader.next(record));
+    QVERIFY(!reader.hasError());
+}
+
+void tst_Trace::testExecutionTraceRoundTrip() {
+    // Records of large deltas in either direction, x0 writes (which are not recorded) and modified instructions
+    std::vector<TraceRecord> records;
+    uint32_t pc = 0x80000000;
+    for (unsigned i = 0; i < 5000; i++) {
+        TraceRecord record;
+        record.pc = pc;
+        record.instr = 0x00000013 | ((i % 7) << 20);
+        record.hasRegWrite = i % 3 != 0;
+        record.rd = i % 32;
+        record.rdValue = i * 0x9e3779b9u;
+        record.hasMemAccess = i % 5 == 0;
+        record.memAddress = i % 2 ? 0xfffffff0 - i : i * 4;
+        records.push_back(record);
+        pc = i % 11 == 0 ? pc - 0x7ffffff0 + i * 4 : pc + 4;
+    }
+
+    {
+        ExecutionTraceWriter writer;
+        QVERIFY(writer.open(path("roundtrip.trace")));
+        for (const auto& record : records) {
+            writer.write(record);
+        }
+    }
+
+    ExecutionTraceReader reader;
+    QVERIFY(reader.open(path("roundtrip.trace")));
+    TraceRecord record;
+    for (auto expected : records) {
+        expected.hasRegWrite &= expected.rd != 0;
+        QVERIFY(reader.next(record));
+        compareRecords(record, expected);
+    }
+    QVERIFY(!reader.next(record));
+    QVERIFY(!reader.hasError());
+}
+
+void tst_Trace::testMalformedExecutionTrace() {
+    TraceRecord record;
+
+    // Files of another magic or version are not traces
+    QVERIFY(writeFile(path("magic.trace"), QByteArray("RIPESTRX\x01", 9)));
+    QVERIFY(!ExecutionTraceReader().open(path("magic.trace")));
+    QVERIFY(writeFile(path("version.trace"), QByteArray("RIPESTRC\x02", 9)));
+    QVERIFY(!ExecutionTraceReader().open(path("version.trace")));
+
+    // A truncated record is an error, whereas the records preceding it are read
+    QVERIFY(writeFile(path("truncated.trace"), s_loopTrace.left(s_loopTrace.size() - 1)));
+    ExecutionTraceReader truncated;
+    QVERIFY(truncated.open(path("truncated.trace")));
+    QVERIFY(truncated.next(record));
+    QVERIFY(truncated.next(record));
+    QVERIFY(!truncated.next(record));
+    QVERIFY(truncated.hasError());
+
+    // A record of a PC whose instruction word was never recorded is an error
+    QVERIFY(writeFile(path("unknown.trace"), QByteArray("RIPESTRC\x01\x00", 10)));
+    ExecutionTraceReader unknown;
+    QVERIFY(unknown.open(path("unknown.trace")));
+    QVERIFY(!unknown.next(record));
+    QVERIFY(unknown.hasError());
+}
+
+void tst_Trace::testCacheTraceFormats_data() {
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<QByteArray>("contents");
+    QTest::addColumn<QStringList>("accesses");
+
+    // Each record yields the fetch of its instruction, followed by its data access; stores are writes
+    QTest::newRow("ripes") << "ripes" << s_loopTrace << QStringList{"I:0@0", "I:4@4", "W:1000@4", "I:0@0"};
+    // Labels other than reads, writes and fetches, and blank lines, are skipped
+    QTest::newRow("din") << "din" << QByteArray("0 1000\n1 2000\n2 400\n4 0\n\n0 1004\n")
+                         << QStringList{"R:1000@0", "W:2000@0", "I:400@400", "R:1004@400"};
+    // Modifies yield a read followed by a write; valgrind output is skipped
+    QTest::newRow("lackey") << "lackey"
+                            << QByteArray("==1== Lackey, an example Valgrind tool\nI  04000000,3\n L 7ff000,4\n"
+                                          " M 7ff010,8\n S 7ff020,4\n==1== \n")
+                            << QStringList{"I:4000000@4000000", "R:7ff000@4000000", "R:7ff010@4000000",
+                                           "W:7ff010@4000000", "W:7ff020@4000000"};
+}
+
+void tst_Trace::testCacheTraceFormats() {
+    QFETCH(QString, format);
+    QFETCH(QByteArray, contents);
+    QFETCH(QStringList, accesses);
+
+    CacheTraceReader::Format parsed;
+    QVERIFY(CacheTraceReader::parseFormat(format, parsed));
+    QVERIFY(writeFile(path(format + ".cachetrace"), contents));
+    CacheTraceReader reader;
+    QVERIFY(reader.open(path(format + ".cachetrace"), parsed));
+    std::vector<CacheTraceReader::Access> read;
+    QVERIFY(reader.readAll(read));
+    QCOMPARE(describe(read), accesses);
+}
+
+void tst_Trace::testMalformedCacheTrace() {
+    CacheTraceReader::Format format;
+    QVERIFY(!CacheTraceReader::parseFormat("pin", format));
+
+    // The accesses preceding a malformed address are read
+    QVERIFY(writeFile(path("malformed.din"), "0 1000\n1 zz\n0 1004\n"));
+    CacheTraceReader reader;
+    QVERIFY(reader.open(path("malformed.din"), CacheTraceReader::Format::Dinero));
+    std::vector<CacheTraceReader::Access> read;
+    QVERIFY(!reader.readAll(read));
+    QVERIFY(reader.hasError());
+    QCOMPARE(describe(read), QStringList{"R:1000@0"});
+
+    QVERIFY(!CacheTraceReader().open(path("missing.din"), CacheTraceReader::Format::Dinero));
+}
+
+void tst_Trace::testReplay() {
+    // Fetches of 0x0, 0x4 and 0x0, interleaved with a read, write and read of 0x100
+    QVERIFY(writeFile(path("replay.din"), "2 0\n0 100\n2 4\n1 100\n2 0\n0 100\n"));
+
+    // Direct mapped caches of four single word blocks
+    const CacheSim::CachePreset preset{0, 2, 0, CacheSim::WritePolicy::WriteBack,
+                                       CacheSim::WriteAllocPolicy::WriteAllocate, CacheSim::ReplPolicy::LRU};
+    ProcessorHandler handler;
+    CacheSim instrCache(&handler, nullptr);
+    instrCache.setType(CacheSim::CacheType::InstrCache);
+    instrCache.setPreset(preset);
+    CacheSim dataCache(&handler, nullptr);
+    dataCache.setPreset(preset);
+
+    CacheTraceReader reader;
+    QVERIFY(reader.open(path("replay.din"), CacheTraceReader::Format::Dinero));
+    QCOMPARE(CacheSim::replay(reader, &instrCache, &dataCache), 6ull);
+    QVERIFY(!reader.hasError());
+
+    // Each access is dispatched to the cache of its kind
+    auto stats = instrCache.getLiveStatistics();
+    QCOMPARE(stats.reads, uint64_t(3));
+    QCOMPARE(stats.hits, uint64_t(1));
+    QCOMPARE(stats.misses, uint64_t(2));
+    stats = dataCache.getLiveStatistics();
+    QCOMPARE(stats.reads, uint64_t(2));
+    QCOMPARE(stats.writes, uint64_t(1));
+    QCOMPARE(stats.hits, uint64_t(2));
+    QCOMPARE(stats.misses, uint64_t(1));
+
+    // A cache replaying a trace on its own only replays the accesses of its kind, starting over from a reset cache
+    std::vector<CacheTraceReader::Access> accesses;
+    CacheTraceReader allReader;
+    QVERIFY(allReader.open(path("replay.din"), CacheTraceReader::Format::Dinero));
+    QVERIFY(allReader.readAll(accesses));
+    QCOMPARE(dataCache.replay(accesses), 3ull);
+    QCOMPARE(dataCache.getLiveStatistics().misses, uint64_t(1));
+
+    // A unified cache observes all accesses, whereby 0x0 and 0x100 evict each other from their shared line
+    CacheSim unified(&handler, nullptr);
+    unified.setType(CacheSim::CacheType::UnifiedCache);
+    unified.setPreset(preset);
+    QCOMPARE(unified.replay(accesses), 6ull);
+    QCOMPARE(unified.getLiveStatistics().hits, uint64_t(1));
+    QCOMPARE(unified.getLiveStatistics().misses, uint64_t(5));
+}
+
+QTEST_APPLESS_MAIN(tst_Trace)
+#include "tst_trace.moc"